@@ -0,0 +1,168 @@
+#ifndef ABAP_KEYWORDS_H
+#define ABAP_KEYWORDS_H
+
+#include <stddef.h>
+#include "token.h"
+
+/**
+ * @file abap_keywords.h
+ * @brief Список ключевых слов ABAP и их типов токенов.
+ *
+ * Список — единственный источник истины для распознавания ключевых слов.
+ * По нему scripts/gen_keyword_hash.py строит совершенную хеш-таблицу
+ * (src/lexer/keyword_hash.h). Скрипт проверяет, что здесь перечислены все
+ * TOKEN_KEYWORD_* из token.h. После изменения списка таблицу нужно перегенерировать:
+ *
+ *     python3 scripts/gen_keyword_hash.py
+ *
+ * Написание — в верхнем регистре; сравнение при поиске регистронезависимое.
+ */
+
+// Ключевые слова, каждому из которых соответствует свой TOKEN_KEYWORD_*
+#define ABAP_KEYWORD_LIST(ABAP_KEYWORD) \
+    ABAP_KEYWORD("ABORT", TOKEN_KEYWORD_ABORT) \
+    ABAP_KEYWORD("ACCEPT", TOKEN_KEYWORD_ACCEPT) \
+    ABAP_KEYWORD("APPEND", TOKEN_KEYWORD_APPEND) \
+    ABAP_KEYWORD("BREAK", TOKEN_KEYWORD_BREAK) \
+    ABAP_KEYWORD("CALL", TOKEN_KEYWORD_CALL) \
+    ABAP_KEYWORD("CASE", TOKEN_KEYWORD_CASE) \
+    ABAP_KEYWORD("CHECK", TOKEN_KEYWORD_CHECK) \
+    ABAP_KEYWORD("CLASS", TOKEN_KEYWORD_CLASS) \
+    ABAP_KEYWORD("CLEAR", TOKEN_KEYWORD_CLEAR) \
+    ABAP_KEYWORD("CLOSE", TOKEN_KEYWORD_CLOSE) \
+    ABAP_KEYWORD("COMMIT", TOKEN_KEYWORD_COMMIT) \
+    ABAP_KEYWORD("CONSTANTS", TOKEN_KEYWORD_CONSTANTS) \
+    ABAP_KEYWORD("CONTINUE", TOKEN_KEYWORD_CONTINUE) \
+    ABAP_KEYWORD("DATA", TOKEN_KEYWORD_DATA) \
+    ABAP_KEYWORD("DELETE", TOKEN_KEYWORD_DELETE) \
+    ABAP_KEYWORD("DO", TOKEN_KEYWORD_DO) \
+    ABAP_KEYWORD("ELSE", TOKEN_KEYWORD_ELSE) \
+    ABAP_KEYWORD("ELSEIF", TOKEN_KEYWORD_ELSEIF) \
+    ABAP_KEYWORD("ENDCLASS", TOKEN_KEYWORD_ENDCLASS) \
+    ABAP_KEYWORD("ENDIF", TOKEN_KEYWORD_ENDIF) \
+    ABAP_KEYWORD("ENDLOOP", TOKEN_KEYWORD_ENDLOOP) \
+    ABAP_KEYWORD("ENDTRY", TOKEN_KEYWORD_ENDTRY) \
+    ABAP_KEYWORD("ENDWHILE", TOKEN_KEYWORD_ENDWHILE) \
+    ABAP_KEYWORD("EVENT", TOKEN_KEYWORD_EVENT) \
+    ABAP_KEYWORD("EXIT", TOKEN_KEYWORD_EXIT) \
+    ABAP_KEYWORD("EXPORT", TOKEN_KEYWORD_EXPORT) \
+    ABAP_KEYWORD("FORM", TOKEN_KEYWORD_FORM) \
+    ABAP_KEYWORD("FUNCTION", TOKEN_KEYWORD_FUNCTION) \
+    ABAP_KEYWORD("IF", TOKEN_KEYWORD_IF) \
+    ABAP_KEYWORD("IMPORT", TOKEN_KEYWORD_IMPORT) \
+    ABAP_KEYWORD("INTERFACE", TOKEN_KEYWORD_INTERFACE) \
+    ABAP_KEYWORD("LOOP", TOKEN_KEYWORD_LOOP) \
+    ABAP_KEYWORD("METHODS", TOKEN_KEYWORD_METHODS) \
+    ABAP_KEYWORD("MODIFY", TOKEN_KEYWORD_MODIFY) \
+    ABAP_KEYWORD("PERFORM", TOKEN_KEYWORD_PERFORM) \
+    ABAP_KEYWORD("PROCEDURE", TOKEN_KEYWORD_PROCEDURE) \
+    ABAP_KEYWORD("RAISE", TOKEN_KEYWORD_RAISE) \
+    ABAP_KEYWORD("READ", TOKEN_KEYWORD_READ) \
+    ABAP_KEYWORD("REFRESH", TOKEN_KEYWORD_REFRESH) \
+    ABAP_KEYWORD("RETURN", TOKEN_KEYWORD_RETURN) \
+    ABAP_KEYWORD("SELECT", TOKEN_KEYWORD_SELECT) \
+    ABAP_KEYWORD("SET", TOKEN_KEYWORD_SET) \
+    ABAP_KEYWORD("SORT", TOKEN_KEYWORD_SORT) \
+    ABAP_KEYWORD("START", TOKEN_KEYWORD_START) \
+    ABAP_KEYWORD("STOP", TOKEN_KEYWORD_STOP) \
+    ABAP_KEYWORD("STRUCTURES", TOKEN_KEYWORD_STRUCTURES) \
+    ABAP_KEYWORD("SUBMIT", TOKEN_KEYWORD_SUBMIT) \
+    ABAP_KEYWORD("SWITCH", TOKEN_KEYWORD_SWITCH) \
+    ABAP_KEYWORD("THEN", TOKEN_KEYWORD_THEN) \
+    ABAP_KEYWORD("THROW", TOKEN_KEYWORD_THROW) \
+    ABAP_KEYWORD("TRY", TOKEN_KEYWORD_TRY) \
+    ABAP_KEYWORD("WHILE", TOKEN_KEYWORD_WHILE) \
+    ABAP_KEYWORD("WITH", TOKEN_KEYWORD_WITH) \
+    ABAP_KEYWORD("ATTRIBUTES", TOKEN_KEYWORD_ATTRIBUTES) \
+    ABAP_KEYWORD("AUTHORITY-CHECK", TOKEN_KEYWORD_AUTHORITY_CHECK) \
+    ABAP_KEYWORD("BEGIN", TOKEN_KEYWORD_BEGIN) \
+    ABAP_KEYWORD("BETWEEN", TOKEN_KEYWORD_BETWEEN) \
+    ABAP_KEYWORD("BY", TOKEN_KEYWORD_BY) \
+    ABAP_KEYWORD("CATCH", TOKEN_KEYWORD_CATCH) \
+    ABAP_KEYWORD("CHANGING", TOKEN_KEYWORD_CHANGING) \
+    ABAP_KEYWORD("CLEANUP", TOKEN_KEYWORD_CLEANUP) \
+    ABAP_KEYWORD("CREATE", TOKEN_KEYWORD_CREATE) \
+    ABAP_KEYWORD("DEFAULT", TOKEN_KEYWORD_DEFAULT) \
+    ABAP_KEYWORD("DEFINITION", TOKEN_KEYWORD_DEFINITION) \
+    ABAP_KEYWORD("END", TOKEN_KEYWORD_END) \
+    ABAP_KEYWORD("ENDCASE", TOKEN_KEYWORD_ENDCASE) \
+    ABAP_KEYWORD("ENDDO", TOKEN_KEYWORD_ENDDO) \
+    ABAP_KEYWORD("ENDFORM", TOKEN_KEYWORD_ENDFORM) \
+    ABAP_KEYWORD("ENDFUNCTION", TOKEN_KEYWORD_ENDFUNCTION) \
+    ABAP_KEYWORD("ENDINTERFACE", TOKEN_KEYWORD_ENDINTERFACE) \
+    ABAP_KEYWORD("ENDMETHOD", TOKEN_KEYWORD_ENDMETHOD) \
+    ABAP_KEYWORD("ENDMODULE", TOKEN_KEYWORD_ENDMODULE) \
+    ABAP_KEYWORD("ENDSELECT", TOKEN_KEYWORD_ENDSELECT) \
+    ABAP_KEYWORD("EXCEPTIONS", TOKEN_KEYWORD_EXCEPTIONS) \
+    ABAP_KEYWORD("EXPORTING", TOKEN_KEYWORD_EXPORTING) \
+    ABAP_KEYWORD("FALSE", TOKEN_KEYWORD_FALSE) \
+    ABAP_KEYWORD("FIELD-SYMBOLS", TOKEN_KEYWORD_FIELD_SYMBOLS) \
+    ABAP_KEYWORD("FROM", TOKEN_KEYWORD_FROM) \
+    ABAP_KEYWORD("IMPLEMENTATION", TOKEN_KEYWORD_IMPLEMENTATION) \
+    ABAP_KEYWORD("IMPORTING", TOKEN_KEYWORD_IMPORTING) \
+    ABAP_KEYWORD("IN", TOKEN_KEYWORD_IN) \
+    ABAP_KEYWORD("INITIAL", TOKEN_KEYWORD_INITIAL) \
+    ABAP_KEYWORD("INSERT", TOKEN_KEYWORD_INSERT) \
+    ABAP_KEYWORD("INTERFACES", TOKEN_KEYWORD_INTERFACES) \
+    ABAP_KEYWORD("INTO", TOKEN_KEYWORD_INTO) \
+    ABAP_KEYWORD("IS", TOKEN_KEYWORD_IS) \
+    ABAP_KEYWORD("JOIN", TOKEN_KEYWORD_JOIN) \
+    ABAP_KEYWORD("KEY", TOKEN_KEYWORD_KEY) \
+    ABAP_KEYWORD("LIKE", TOKEN_KEYWORD_LIKE) \
+    ABAP_KEYWORD("MESSAGE", TOKEN_KEYWORD_MESSAGE) \
+    ABAP_KEYWORD("METHOD", TOKEN_KEYWORD_METHOD) \
+    ABAP_KEYWORD("MODULE", TOKEN_KEYWORD_MODULE) \
+    ABAP_KEYWORD("OF", TOKEN_KEYWORD_OF) \
+    ABAP_KEYWORD("ON", TOKEN_KEYWORD_ON) \
+    ABAP_KEYWORD("PARAMETERS", TOKEN_KEYWORD_PARAMETERS) \
+    ABAP_KEYWORD("PRIVATE", TOKEN_KEYWORD_PRIVATE) \
+    ABAP_KEYWORD("PROTECTED", TOKEN_KEYWORD_PROTECTED) \
+    ABAP_KEYWORD("PUBLIC", TOKEN_KEYWORD_PUBLIC) \
+    ABAP_KEYWORD("RAISING", TOKEN_KEYWORD_RAISING) \
+    ABAP_KEYWORD("RANGES", TOKEN_KEYWORD_RANGES) \
+    ABAP_KEYWORD("RETURNING", TOKEN_KEYWORD_RETURNING) \
+    ABAP_KEYWORD("SECTION", TOKEN_KEYWORD_SECTION) \
+    ABAP_KEYWORD("SELECT-OPTIONS", TOKEN_KEYWORD_SELECT_OPTIONS) \
+    ABAP_KEYWORD("TABLE", TOKEN_KEYWORD_TABLE) \
+    ABAP_KEYWORD("TABLES", TOKEN_KEYWORD_TABLES) \
+    ABAP_KEYWORD("TO", TOKEN_KEYWORD_TO) \
+    ABAP_KEYWORD("TRUE", TOKEN_KEYWORD_TRUE) \
+    ABAP_KEYWORD("TYPE", TOKEN_KEYWORD_TYPE) \
+    ABAP_KEYWORD("TYPES", TOKEN_KEYWORD_TYPES) \
+    ABAP_KEYWORD("USING", TOKEN_KEYWORD_USING) \
+    ABAP_KEYWORD("VALUE", TOKEN_KEYWORD_VALUE) \
+    ABAP_KEYWORD("WHEN", TOKEN_KEYWORD_WHEN) \
+    ABAP_KEYWORD("WHERE", TOKEN_KEYWORD_WHERE) \
+    ABAP_KEYWORD("WRITE", TOKEN_KEYWORD_WRITE)
+
+// Словесные операторы: лексер сразу выдаёт для них типы операторов
+#define ABAP_WORD_OPERATOR_LIST(ABAP_KEYWORD) \
+    ABAP_KEYWORD("AND", TOKEN_OPERATOR_AND) \
+    ABAP_KEYWORD("OR", TOKEN_OPERATOR_OR) \
+    ABAP_KEYWORD("NOT", TOKEN_OPERATOR_NOT) \
+    ABAP_KEYWORD("MOD", TOKEN_OPERATOR_MODULO) \
+    ABAP_KEYWORD("EQ", TOKEN_OPERATOR_EQ) \
+    ABAP_KEYWORD("NE", TOKEN_OPERATOR_NEQ) \
+    ABAP_KEYWORD("LT", TOKEN_OPERATOR_LT) \
+    ABAP_KEYWORD("GT", TOKEN_OPERATOR_GT) \
+    ABAP_KEYWORD("LE", TOKEN_OPERATOR_LE) \
+    ABAP_KEYWORD("GE", TOKEN_OPERATOR_GE)
+
+/**
+ * @brief Распознаёт ключевое слово ABAP за O(1) без выделения памяти.
+ *
+ * @param text Начало идентификатора (строка может не завершаться нулём).
+ * @param length Длина идентификатора.
+ * @return Тип ключевого слова (TOKEN_KEYWORD_* или словесный оператор) либо TOKEN_IDENTIFIER.
+ */
+TokenType abap_keyword_lookup(const char *text, size_t length);
+
+/**
+ * @brief Написание ключевого слова для диагностики.
+ *
+ * @param type Тип токена.
+ * @return Ключевое слово в верхнем регистре или NULL, если тип не является ключевым словом.
+ */
+const char *abap_keyword_spelling(TokenType type);
+
+#endif // ABAP_KEYWORDS_H
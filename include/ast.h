@@ -2,6 +2,7 @@
 #define AST_H
 
 #include <stdlib.h>
+#include "atom.h"
 
 // Типы узлов AST
 typedef enum {
@@ -14,21 +15,132 @@ typedef enum {
     AST_OPERATOR,
     AST_AUTHORITY_CHECK,    // Узел AUTHORITY-CHECK
     AST_AUTH_CHECK_PARAM,   // Параметр AUTHORITY-CHECK
+    AST_ERROR,              // Оператор, пропущенный восстановлением после ошибки разбора
+
+    // Процедуры: atom — имя, потомки — параметры и операторы тела
+    AST_FORM,               // FORM ... ENDFORM
+    AST_FORM_PARAMETER,     // Параметр FORM (USING, CHANGING, TABLES): atom — имя
+    AST_METHOD_IMPLEMENTATION, // METHOD ... ENDMETHOD (в CLASS ... IMPLEMENTATION)
+    AST_FUNCTION,           // FUNCTION ... ENDFUNCTION
+    AST_MODULE,             // MODULE ... ENDMODULE
+
+    // Объявления: atom — объявляемое имя, потомки — спецификации
+    AST_DATA_DECL,          // DATA
+    AST_CONSTANT_DECL,      // CONSTANTS
+    AST_TYPES_DECL,         // TYPES
+    AST_FIELD_SYMBOL_DECL,  // FIELD-SYMBOLS
+    AST_PARAMETERS_DECL,    // PARAMETERS
+    AST_TYPE_SPEC,          // TYPE <тип>: atom — имя типа
+    AST_LIKE_SPEC,          // LIKE <объект данных>: atom — имя объекта
+    AST_LINE_OF_SPEC,       // TYPE LINE OF <табличный тип>: atom — имя типа
+    AST_LENGTH_SPEC,        // LENGTH <n>: string_value — число
+    AST_DECIMALS_SPEC,      // DECIMALS <n>: как LENGTH
+    AST_VALUE_SPEC,         // VALUE <литерал>: string_value — текст литерала
+
+    // Классы: atom — имя; компоненты объявлены в DEFINITION, методы реализованы в IMPLEMENTATION
+    AST_CLASS_DEF,          // CLASS ... DEFINITION: atom — имя, потомки — INHERITING FROM
+                            // (AST_STATEMENT_CLAUSE) и секции AST_CLASS_SECTION
+    AST_CLASS_SECTION,      // PUBLIC/PROTECTED/PRIVATE SECTION: atom — видимость, потомки — компоненты
+    AST_METHOD_DECL,        // METHODS в DEFINITION: atom — имя метода, потомки — параметры
+    AST_METHOD_PARAM,       // Параметр METHODS: atom — имя, string_value — IMPORTING/EXPORTING/
+                            // CHANGING/RETURNING, потомки — TYPE/LIKE
+    AST_CLASS_IMPL,         // CLASS ... IMPLEMENTATION: потомки — AST_METHOD_IMPLEMENTATION
+    AST_INTERFACE_DEF,      // INTERFACE ... ENDINTERFACE
+
+    AST_ASSIGNMENT,         // Присваивание: потомки — цель (AST_VARIABLE) и выражение
+    AST_VARIABLE,           // Цель присваивания: atom — имя
+    AST_FUNCTION_CALL,      // Функциональный вызов name( ... ): atom — имя (meth, lcl=>meth), потомки — аргументы
+
+    // Управление: условие (выражение) — первый потомок, за ним операторы тела
+    AST_IF,                 // IF: условие, операторы, затем ветви AST_ELSEIF и AST_ELSE
+    AST_ELSEIF,             // ELSEIF: условие, операторы
+    AST_ELSE,               // ELSE: операторы
+    AST_WHILE,              // WHILE ... ENDWHILE: условие, операторы
+    AST_DO,                 // DO ... ENDDO: число повторов (выражение, если есть TIMES), операторы
+    AST_LOOP,               // LOOP AT ... ENDLOOP: atom — таблица, дополнения (AST_STATEMENT_CLAUSE), операторы
+    AST_TRY,                // TRY ... ENDTRY: операторы, затем ветви AST_CATCH и AST_CLEANUP
+    AST_CATCH,              // CATCH: классы исключений (AST_IDENTIFIER), дополнение INTO, операторы
+    AST_CLEANUP,            // CLEANUP: операторы
+    AST_EXIT,               // EXIT
+    AST_CONTINUE,           // CONTINUE
+    AST_CHECK,              // CHECK: условие
+    AST_RETURN,             // RETURN
+
+    // Вызовы и доступ к данным
+    AST_PERFORM,            // PERFORM: atom — имя FORM, потомки — дополнения USING/CHANGING/TABLES
+    AST_CALL_FUNCTION,      // CALL FUNCTION: string_value — имя (текст литерала), потомки — дополнения
+    AST_SELECT,             // SELECT: atom — первая таблица FROM, потомки — дополнения и AST_JOIN
+    AST_JOIN,               // [INNER|LEFT OUTER] JOIN: atom — таблица, string_value — вид, потомок — условие ON
+    AST_STATEMENT_CLAUSE,   // Дополнение оператора (TO, INTO, WHERE, USING, EXPORTING, ...):
+                            // string_value — ключевые слова, потомки — операнды
+    AST_PARAMETER_BINDING,  // name = value в списке параметров: atom — имя, потомок — значение
+    AST_KEYWORD_STATEMENT,  // Прочий оператор (APPEND, READ TABLE, CREATE OBJECT, MESSAGE, ...):
+                            // string_value — ключевые слова, atom — главный операнд, потомки —
+                            // операнды и дополнения
     // Другие типы узлов по мере необходимости
+
+    AST_NODE_TYPE_COUNT     // Количество типов узлов (размер таблиц, индексируемых типом)
 } ASTNodeType;
 
+// Арена единицы компиляции (см. ast_arena_create())
+typedef struct ast_arena ast_arena_t;
+
 // Структура узла AST
 typedef struct ASTNode {
     ASTNodeType type;           // Тип узла
-    char *string_value;         // Строковое значение (например, имя идентификатора или литерала)
+    atom_t atom;                // Имя (идентификатор, таблица, поле и т.п.) — атом из atom.h
+    ast_arena_t *arena;         // Арена узла (массив детей растёт в ней же) или NULL для узла из кучи
+    char *string_value;         // Собственная строка узла (текст литерала, операторы и прочие не-имена)
     struct ASTNode **children;  // Массив дочерних узлов
     int child_count;            // Количество дочерних узлов
 } ASTNode;
 
-// Создание нового узла AST заданного типа
+// Арена единицы компиляции: узлы, массивы детей и строки узлов выделяются сдвигом
+// указателя в крупных блоках и освобождаются все сразу ast_arena_destroy().
+// Модули парсера арену не получают: ast_node_create() и ast_strndup() берут память
+// из арены, активной в текущем потоке (ast_arena_activate()), а без неё — из кучи.
+
+// Создание пустой арены (NULL при нехватке памяти)
+ast_arena_t *ast_arena_create(void);
+
+// Освобождение арены и всех выделенных в ней узлов за один вызов.
+// Если арена активна в текущем потоке, она деактивируется.
+void ast_arena_destroy(ast_arena_t *arena);
+
+// Делает арену активной в текущем потоке (NULL — выделение из кучи). Возвращает
+// предыдущую активную арену, чтобы вызывающий мог её восстановить.
+ast_arena_t *ast_arena_activate(ast_arena_t *arena);
+
+// Арена, активная в текущем потоке, или NULL
+ast_arena_t *ast_arena_current(void);
+
+// Выделение size байт из арены (выравнивание как у malloc; NULL при нехватке памяти)
+void *ast_arena_alloc(ast_arena_t *arena, size_t size);
+
+// Сколько байт занято узлами и строками арены / выделено под её блоки
+size_t ast_arena_used(const ast_arena_t *arena);
+size_t ast_arena_reserved(const ast_arena_t *arena);
+
+// Создание нового узла AST заданного типа (в активной арене, если она есть)
 ASTNode *ast_node_create(ASTNodeType type);
 
-// Освобождение памяти узла AST и всех его потомков
+// Копия строки для string_value: в активной арене, если она есть, иначе malloc.
+// Освобождается вместе с узлом (ast_node_free() или ast_arena_destroy()).
+char *ast_strndup(const char *text, size_t length);
+
+// Текст токена для string_value (аналог token_strdup() с памятью из активной арены)
+struct Token;
+char *ast_token_strdup(const struct Token *token);
+
+// Добавление дочернего узла
+void ast_node_add_child(ASTNode *parent, ASTNode *child);
+
+// Имя узла: текст атома, если он задан, иначе string_value (может быть NULL)
+const char *ast_node_name(const ASTNode *node);
+
+// Освобождение памяти узла AST и всех его потомков (без рекурсии — глубина дерева не
+// ограничена стеком). Узлы из арены не освобождаются: их память вернёт ast_arena_destroy(),
+// поэтому вызов на ветке ошибки безопасен в обоих режимах.
 void ast_node_free(ASTNode *node);
 
 #endif // AST_H
@@ -0,0 +1,75 @@
+#ifndef AST_CACHE_H
+#define AST_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ast_flat.h"
+
+/**
+ * @file ast_cache.h
+ * @brief Кэш плоских AST на диске: повторный запуск не разбирает неизменённые исходники.
+ *
+ * Файл кэша — образ ast_flat_t: заголовок и секции (узлы, строки, позиции, имена),
+ * выровненные по 8 байт. Загрузка отображает файл в память и направляет массивы
+ * дерева прямо в отображение, без копирования и без прохода по узлам. Атомы процесса,
+ * записавшего файл, в другом процессе ничего не значат, поэтому узлы хранят индексы
+ * в таблице имён файла; при загрузке таблица интернируется (по одному вызову
+ * atom_intern() на разное имя) и становится tree.atom_map — читать имена узлов
+ * нужно через ast_flat_atom().
+ *
+ * Ключ файла — хеш текста исходника; длина текста сверяется при загрузке. Файл
+ * записывается во временный и переименовывается, поэтому читатель видит либо
+ * старый файл, либо новый целиком.
+ */
+
+/**
+ * @struct ast_cache_entry_t
+ * @brief Дерево, загруженное из кэша.
+ */
+typedef struct {
+    ast_flat_t tree;        ///< Дерево только для чтения; массивы — в отображении файла
+    void *mapping;          ///< Отображение файла кэша
+    size_t mapping_size;    ///< Размер отображения
+    atom_t *atoms;          ///< Имена файла в атомах процесса (tree.atom_map)
+} ast_cache_entry_t;
+
+/**
+ * @brief Хеш текста исходника (FNV-1a, 64 бита) — ключ файла кэша.
+ */
+uint64_t ast_cache_hash(const char *source, size_t length);
+
+/**
+ * @brief Путь файла кэша: "<dir>/<16 hex-цифр хеша>.ast".
+ *
+ * @return false, если путь не помещается в out.
+ */
+bool ast_cache_path(char *out, size_t size, const char *dir, uint64_t hash);
+
+/**
+ * @brief Записывает дерево в кэш.
+ *
+ * @param dir Каталог кэша (должен существовать).
+ * @param hash Хеш исходника (ast_cache_hash()).
+ * @param source_length Длина исходника в байтах.
+ * @param tree Закрытое дерево (все узлы закрыты), в том числе загруженное из кэша.
+ * @return true при успехе.
+ */
+bool ast_cache_store(const char *dir, uint64_t hash, size_t source_length, const ast_flat_t *tree);
+
+/**
+ * @brief Загружает дерево из кэша.
+ *
+ * Отсутствие файла — обычный промах, без сообщения. Файл другой версии формата,
+ * другого порядка байт или другой длины исходника тоже считается промахом.
+ *
+ * @return true, если дерево загружено; его нужно освободить ast_cache_close().
+ */
+bool ast_cache_load(ast_cache_entry_t *entry, const char *dir, uint64_t hash, size_t source_length);
+
+/**
+ * @brief Снимает отображение и освобождает таблицу имён загруженного дерева.
+ */
+void ast_cache_close(ast_cache_entry_t *entry);
+
+#endif // AST_CACHE_H
@@ -0,0 +1,170 @@
+#ifndef AST_FLAT_H
+#define AST_FLAT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ast.h"
+
+/**
+ * @file ast_flat.h
+ * @brief Плоское представление AST: все узлы в одном массиве в прямом порядке обхода.
+ *
+ * Узел занимает 16 байт и ссылается на соседей индексами, а не указателями:
+ * потомки узла i занимают отрезок [i + 1, i + subtree), следующий брат — i + subtree.
+ * Проходы по всему дереву (сбор символов, генерация IR) становятся последовательным
+ * чтением массива вместо цепочки промахов кэша по ASTNode** в куче; поддерево
+ * пропускается одним сложением.
+ *
+ * Дерево строится из ASTNode (ast_flat_build()) или напрямую парсером
+ * парами ast_flat_open()/ast_flat_close(), а также загружается из кэша (ast_cache.h):
+ * тогда массивы лежат в отображённом файле, и дерево доступно только для чтения.
+ */
+
+/// Отсутствующий индекс узла
+#define AST_FLAT_NONE UINT32_MAX
+
+/// Тип узла (ASTNodeType) — младшие 16 бит слова kind
+#define AST_FLAT_KIND_MASK   0xFFFFu
+
+/// Флаги узла — старшие 16 бит слова kind
+#define AST_FLAT_HAS_STRING  (1u << 16)   ///< У узла есть строка (string_value)
+#define AST_FLAT_HAS_ATOM    (1u << 17)   ///< У узла есть имя-атом
+
+/**
+ * @struct ast_flat_node_t
+ * @brief Узел плоского AST.
+ */
+typedef struct {
+    uint32_t kind;          ///< ASTNodeType | флаги AST_FLAT_*
+    uint32_t first_child;   ///< Индекс первого потомка (i + 1) или AST_FLAT_NONE у листа
+    uint32_t subtree;       ///< Число узлов поддерева, включая сам узел
+    atom_t atom;            ///< Имя узла или ATOM_NONE
+} ast_flat_node_t;
+
+/**
+ * @struct ast_flat_t
+ * @brief Плоское дерево. Строки узлов вынесены в отдельный пул: горячий массив
+ *        nodes содержит только то, что нужно для обхода.
+ */
+typedef struct {
+    ast_flat_node_t *nodes;     ///< Узлы в прямом порядке обхода; nodes[0] — корень
+    uint32_t count;             ///< Количество узлов
+    uint32_t capacity;          ///< Ёмкость nodes
+    uint32_t *strings;          ///< Смещение строки узла в string_pool (параллельно nodes)
+    char *string_pool;          ///< Строки узлов, каждая завершена нулём
+    size_t string_length;       ///< Занято байт в string_pool
+    size_t string_capacity;     ///< Ёмкость string_pool
+    uint32_t open;              ///< Последний открытый и ещё не закрытый узел (для ast_flat_open())
+    uint32_t *positions;        ///< Смещение узла в исходном тексте (параллельно nodes) или NULL
+    const atom_t *atom_map;     ///< У дерева из кэша: nodes[i].atom — индекс в этой таблице имён
+    bool readonly;              ///< Массивы принадлежат файлу кэша; дерево нельзя менять и освобождать
+} ast_flat_t;
+
+/**
+ * @brief Инициализирует пустое дерево.
+ */
+void ast_flat_init(ast_flat_t *tree);
+
+/**
+ * @brief Освобождает память дерева.
+ */
+void ast_flat_free(ast_flat_t *tree);
+
+/**
+ * @brief Строит плоское дерево по дереву ASTNode (без рекурсии).
+ *
+ * @param tree Дерево; прежнее содержимое заменяется.
+ * @param root Корень исходного дерева.
+ * @return true при успехе, false при нехватке памяти или более чем 2^32-1 узлах.
+ */
+bool ast_flat_build(ast_flat_t *tree, const ASTNode *root);
+
+/**
+ * @brief Восстанавливает дерево ASTNode по поддереву плоского (обратное ast_flat_build()).
+ *
+ * Нужно, когда дерево взято из кэша (ast_cache_load()), а следующему этапу, например
+ * semantic_analyze(), нужны ASTNode. Узлы выделяются в активной арене или в куче.
+ *
+ * @return Корень или NULL при нехватке памяти.
+ */
+ASTNode *ast_flat_expand(const ast_flat_t *tree, uint32_t root);
+
+/**
+ * @brief Открывает узел: добавляет его в конец массива потомком последнего открытого узла.
+ *
+ * Все узлы, добавленные до парного ast_flat_close(), становятся его потомками.
+ *
+ * @return Индекс узла или AST_FLAT_NONE при нехватке памяти.
+ */
+uint32_t ast_flat_open(ast_flat_t *tree, ASTNodeType kind, atom_t atom);
+
+/**
+ * @brief Закрывает узел index: фиксирует размер поддерева.
+ */
+void ast_flat_close(ast_flat_t *tree, uint32_t index);
+
+/**
+ * @brief Сохраняет строку узла (копия в пуле дерева).
+ *
+ * @return false при нехватке памяти.
+ */
+bool ast_flat_set_string(ast_flat_t *tree, uint32_t index, const char *text, size_t length);
+
+/**
+ * @brief Сохраняет позицию узла (смещение в исходном тексте).
+ *
+ * Массив позиций создаётся при первом вызове; узлы без позиции получают AST_FLAT_NONE.
+ *
+ * @return false при нехватке памяти.
+ */
+bool ast_flat_set_position(ast_flat_t *tree, uint32_t index, uint32_t offset);
+
+/**
+ * @brief Сохраняет позиции непосредственных потомков узла: offsets[i] — у i-го потомка.
+ *
+ * Так записываются смещения операторов верхнего уровня из parse_program_offsets()
+ * или parser_parallel_result_t::offsets после ast_flat_build().
+ *
+ * @return false при нехватке памяти.
+ */
+bool ast_flat_set_child_positions(ast_flat_t *tree, uint32_t index, const uint32_t *offsets);
+
+/**
+ * @brief Количество непосредственных потомков узла (проход по братьям).
+ */
+uint32_t ast_flat_child_count(const ast_flat_t *tree, uint32_t index);
+
+/**
+ * @brief n-й непосредственный потомок узла или AST_FLAT_NONE.
+ */
+uint32_t ast_flat_child(const ast_flat_t *tree, uint32_t index, uint32_t n);
+
+/// Тип узла
+static inline ASTNodeType ast_flat_kind(const ast_flat_t *tree, uint32_t index) {
+    return (ASTNodeType)(tree->nodes[index].kind & AST_FLAT_KIND_MASK);
+}
+
+/// Индекс за последним узлом поддерева (он же следующий брат, если он есть)
+static inline uint32_t ast_flat_end(const ast_flat_t *tree, uint32_t index) {
+    return index + tree->nodes[index].subtree;
+}
+
+/// Имя узла (атом процесса) или ATOM_NONE; у дерева из кэша индекс в atom_map
+/// проверен при загрузке (ast_cache_load())
+static inline atom_t ast_flat_atom(const ast_flat_t *tree, uint32_t index) {
+    atom_t atom = tree->nodes[index].atom;
+    return tree->atom_map ? tree->atom_map[atom] : atom;
+}
+
+/// Смещение узла в исходном тексте или AST_FLAT_NONE
+static inline uint32_t ast_flat_position(const ast_flat_t *tree, uint32_t index) {
+    return tree->positions ? tree->positions[index] : AST_FLAT_NONE;
+}
+
+/// Строка узла или NULL
+static inline const char *ast_flat_string(const ast_flat_t *tree, uint32_t index) {
+    return (tree->nodes[index].kind & AST_FLAT_HAS_STRING) ? tree->string_pool + tree->strings[index] : NULL;
+}
+
+#endif // AST_FLAT_H
@@ -0,0 +1,107 @@
+#ifndef AST_VISITOR_H
+#define AST_VISITOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ast_flat.h"
+
+/**
+ * @file ast_visitor.h
+ * @brief Обход AST: плоского (ast_flat.h) и дерева узлов ASTNode.
+ *
+ * Прямой порядок обхода плоского дерева совпадает с порядком узлов в массиве, поэтому
+ * обход — цикл по индексам без стека и рекурсии; пропуск поддерева — переход к
+ * ast_flat_end().
+ *
+ * Дерево ASTNode обходит ast_visit() по явному стеку. Визитор задаёт функции до и
+ * после потомков — общие и по типу узла; несколько независимых визиторов
+ * (семантические проверки, генерация IR, lint) проходят дерево за один обход
+ * ast_visit_fused(), каждый со своими пропусками поддеревьев и остановкой.
+ */
+
+/**
+ * @brief Функция посещения узла.
+ *
+ * @param tree Дерево.
+ * @param index Индекс узла.
+ * @param arg Аргумент, переданный в функцию обхода.
+ * @return true — обходить потомков узла, false — пропустить поддерево.
+ */
+typedef bool (*ast_flat_visit_fn)(const ast_flat_t *tree, uint32_t index, void *arg);
+
+/**
+ * @brief Обходит поддерево root в прямом порядке.
+ */
+void ast_flat_visit(const ast_flat_t *tree, uint32_t root, ast_flat_visit_fn visit, void *arg);
+
+/**
+ * @brief Вызывает visit для каждого узла типа kind во всём дереве (возвращаемое значение
+ *        visit не учитывается). Один последовательный проход без спуска по дереву.
+ *
+ * @return Количество найденных узлов.
+ */
+size_t ast_flat_visit_kind(const ast_flat_t *tree, ASTNodeType kind, ast_flat_visit_fn visit, void *arg);
+
+/**
+ * @brief Родитель узла или AST_FLAT_NONE для корня.
+ *
+ * Родитель — ближайший узел слева, чьё поддерево накрывает index; поиск идёт назад
+ * по массиву, поэтому стоит O(расстояние до родителя).
+ */
+uint32_t ast_flat_parent(const ast_flat_t *tree, uint32_t index);
+
+/// Решение функции посещения узла ASTNode
+typedef enum {
+    AST_VISIT_CONTINUE = 0,     ///< Обходить потомков узла
+    AST_VISIT_SKIP,             ///< Не обходить потомков (post для самого узла вызывается)
+    AST_VISIT_STOP,             ///< Больше не вызывать функции этого визитора
+} ast_visit_result_t;
+
+/**
+ * @brief Функция посещения узла дерева ASTNode.
+ *
+ * @param node Узел.
+ * @param parent Родитель узла (NULL для корня обхода).
+ * @param arg Аргумент визитора (ast_visitor_t::arg).
+ * @return Решение о потомках; в функции post AST_VISIT_SKIP равнозначен AST_VISIT_CONTINUE.
+ */
+typedef ast_visit_result_t (*ast_visit_fn)(ASTNode *node, ASTNode *parent, void *arg);
+
+/**
+ * @struct ast_visitor_t
+ * @brief Набор функций одного прохода. Незаданные (NULL) функции пропускаются.
+ *
+ * Пример: ast_visitor_t lint = { .pre[AST_OPERATOR] = check_operator, .arg = &report };
+ */
+typedef struct {
+    ast_visit_fn pre_any;                       ///< До потомков, для узла любого типа
+    ast_visit_fn pre[AST_NODE_TYPE_COUNT];      ///< До потомков, по типу узла (после pre_any)
+    ast_visit_fn post[AST_NODE_TYPE_COUNT];     ///< После потомков, по типу узла
+    ast_visit_fn post_any;                      ///< После потомков, для узла любого типа (после post)
+    void *arg;                                  ///< Аргумент функций визитора
+} ast_visitor_t;
+
+/**
+ * @brief Обходит дерево root в прямом порядке без рекурсии.
+ *
+ * Если pre_any вернула не AST_VISIT_CONTINUE, функция pre по типу для узла не вызывается.
+ * После AST_VISIT_STOP функции визитора больше не вызываются, в том числе post
+ * для ещё открытых узлов.
+ *
+ * @return false при нехватке памяти под стек обхода.
+ */
+bool ast_visit(ASTNode *root, const ast_visitor_t *visitor);
+
+/**
+ * @brief Один обход дерева для нескольких визиторов.
+ *
+ * Для каждого узла визиторы вызываются в порядке массива. Пропуск поддерева или
+ * остановка одного визитора не влияют на остальные; спуск в поддерево не выполняется,
+ * только если его пропустили все ещё работающие визиторы, а обход заканчивается,
+ * когда остановились все.
+ *
+ * @return false при нехватке памяти под стек обхода.
+ */
+bool ast_visit_fused(ASTNode *root, const ast_visitor_t *const *visitors, size_t count);
+
+#endif // AST_VISITOR_H
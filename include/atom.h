@@ -0,0 +1,71 @@
+#ifndef ATOM_H
+#define ATOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file atom.h
+ * @brief Глобальная таблица интернированных идентификаторов (атомов).
+ *
+ * Идентификаторы ABAP не зависят от регистра, поэтому каждое имя один раз
+ * приводится к верхнему регистру и получает 32-битный номер — атом.
+ * Лексер, парсер, таблица символов и IR хранят атомы вместо копий строк:
+ * сравнение имён сводится к сравнению чисел, а сам текст хранится в одном экземпляре.
+ *
+ * Таблица живёт до вызова atom_table_free(); строки, возвращаемые atom_text(),
+ * остаются действительными всё это время. atom_intern() можно вызывать из
+ * нескольких потоков одновременно.
+ */
+
+/// Номер интернированного идентификатора
+typedef uint32_t atom_t;
+
+/// Отсутствующий атом (например, у токенов, не являющихся идентификаторами)
+#define ATOM_NONE ((atom_t)0)
+
+/**
+ * @brief Интернирует идентификатор (регистронезависимо).
+ *
+ * @param text Начало имени (не обязано завершаться нулём).
+ * @param length Длина имени в байтах.
+ * @return Атом имени; одинаковые с точностью до регистра имена получают один атом.
+ *         ATOM_NONE для пустого имени.
+ */
+atom_t atom_intern(const char *text, size_t length);
+
+/**
+ * @brief Интернирует C-строку, завершённую нулём.
+ */
+atom_t atom_intern_cstr(const char *text);
+
+/**
+ * @brief Ищет уже интернированное имя, не добавляя его в таблицу.
+ *
+ * @return Атом или ATOM_NONE, если такого имени ещё не было.
+ */
+atom_t atom_find(const char *text, size_t length);
+
+/**
+ * @brief Каноническое написание атома (верхний регистр, завершено нулём).
+ *
+ * @return Текст имени; "" для ATOM_NONE и неизвестных атомов.
+ */
+const char *atom_text(atom_t atom);
+
+/**
+ * @brief Длина канонического написания атома в байтах.
+ */
+uint32_t atom_length(atom_t atom);
+
+/**
+ * @brief Количество интернированных имён.
+ */
+size_t atom_count(void);
+
+/**
+ * @brief Освобождает таблицу. Все ранее выданные атомы и строки становятся недействительными.
+ */
+void atom_table_free(void);
+
+#endif // ATOM_H
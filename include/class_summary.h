@@ -0,0 +1,189 @@
+#ifndef CLASS_SUMMARY_H
+#define CLASS_SUMMARY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ast.h"
+#include "atom.h"
+#include "semantic.h"
+#include "symbol_table.h"
+#include "type_layout.h"
+
+/**
+ * @file class_summary.h
+ * @brief Сводки сигнатур глобальных классов и интерфейсов на диске.
+ *
+ * Сводка — то, что программе нужно знать о классе, не разбирая его исходник:
+ * компоненты с видимостью, раскладки типов атрибутов, констант и параметров,
+ * направления параметров методов и значения констант. Записывается после анализа
+ * программы, объявившей класс (class_summary_store()), по одному файлу на класс
+ * или интерфейс. Потребитель отображает файл в память (class_summary_load()):
+ * компоненты и параметры читаются на месте, в памяти процесса строятся только
+ * таблица имён и раскладки.
+ *
+ * Как в ast_cache.h, атомы процесса-писателя в файл не попадают: записи хранят
+ * индексы в таблице имён файла, которая интернируется при загрузке. Индекс 0 во
+ * всех ссылках записей означает «нет».
+ */
+
+/// Вид сводки
+typedef enum {
+    CLASS_SUMMARY_CLASS,        ///< CLASS ... DEFINITION
+    CLASS_SUMMARY_INTERFACE     ///< INTERFACE
+} class_summary_kind_t;
+
+/// Видимость компонента
+typedef enum {
+    CLASS_VISIBILITY_PUBLIC,
+    CLASS_VISIBILITY_PROTECTED,
+    CLASS_VISIBILITY_PRIVATE
+} class_visibility_t;
+
+/// Вид компонента
+typedef enum {
+    CLASS_COMPONENT_ATTRIBUTE,  ///< DATA, CLASS-DATA
+    CLASS_COMPONENT_CONSTANT,   ///< CONSTANTS
+    CLASS_COMPONENT_TYPE,       ///< TYPES
+    CLASS_COMPONENT_METHOD      ///< METHODS
+} class_component_kind_t;
+
+/// Направление параметра метода
+typedef enum {
+    METHOD_PARAM_IMPORTING,
+    METHOD_PARAM_EXPORTING,
+    METHOD_PARAM_CHANGING,
+    METHOD_PARAM_RETURNING
+} method_param_direction_t;
+
+/// Компонент в файле сводки (читается на месте)
+typedef struct {
+    uint32_t name;              ///< Индекс имени
+    uint8_t kind;               ///< class_component_kind_t
+    uint8_t visibility;         ///< class_visibility_t
+    uint16_t reserved;
+    uint32_t type;              ///< Индекс раскладки (0 — у метода)
+    uint32_t value;             ///< Смещение значения константы или VALUE в пуле (0 — нет)
+    uint32_t first_param;       ///< Параметры метода: params[first_param, + param_count)
+    uint32_t param_count;
+} class_summary_component_t;
+
+/// Параметр метода в файле сводки (читается на месте)
+typedef struct {
+    uint32_t name;              ///< Индекс имени
+    uint32_t direction;         ///< method_param_direction_t
+    uint32_t type;              ///< Индекс раскладки
+} class_summary_param_t;
+
+/**
+ * @struct class_summary_t
+ * @brief Сводка, загруженная из файла.
+ */
+typedef struct {
+    atom_t name;                                    ///< Имя класса или интерфейса
+    class_summary_kind_t kind;
+    uint64_t source_hash;                           ///< Хеш исходника, переданный при записи
+    const class_summary_component_t *components;    ///< Компоненты в порядке объявления (в отображении)
+    int component_count;
+    const class_summary_param_t *params;            ///< Параметры всех методов (в отображении)
+    int param_count;
+    TypeInfo *types;                                ///< Раскладки; индекс i в записях — types[i - 1]
+    int type_count;
+    atom_t *atoms;                                  ///< Имена файла в атомах процесса
+    const char *values;                             ///< Пул значений (строки с завершающим нулём)
+    size_t values_length;
+    void *mapping;                                  ///< Отображение файла
+    size_t mapping_size;
+} class_summary_t;
+
+/**
+ * @brief Путь файла сводки: "<dir>/<имя>.sig"; '/' в имени (пространство имён)
+ *        заменяется на '#'.
+ *
+ * @return false, если путь не помещается в out.
+ */
+bool class_summary_path(char *out, size_t size, const char *dir, atom_t name);
+
+/**
+ * @brief Записывает сводку класса или интерфейса.
+ *
+ * Раскладки вычисляются type_resolve_decl() в области класса поверх глобальных
+ * символов программы и запоминаются в analysis->types, как при анализе.
+ *
+ * @param dir Каталог сводок (должен существовать).
+ * @param definition Узел AST_CLASS_DEF или AST_INTERFACE_DEF из проанализированного дерева.
+ * @param source_hash Хеш исходника класса (например, ast_cache_hash()); сохраняется как есть.
+ * @param analysis Результат semantic_analyze() для дерева, содержащего definition.
+ * @return true при успехе.
+ */
+bool class_summary_store(const char *dir, const ASTNode *definition, uint64_t source_hash,
+                         semantic_result_t *analysis);
+
+/**
+ * @brief Загружает сводку класса или интерфейса по имени.
+ *
+ * Отсутствие файла — обычный промах, без сообщения. Файл другой версии формата,
+ * другого порядка байт или с записями, выходящими за свои таблицы, тоже промах.
+ *
+ * @return true, если сводка загружена; её нужно освободить class_summary_close().
+ */
+bool class_summary_load(class_summary_t *summary, const char *dir, atom_t name);
+
+/**
+ * @brief Снимает отображение и освобождает имена и раскладки сводки.
+ */
+void class_summary_close(class_summary_t *summary);
+
+/**
+ * @brief Компонент по имени.
+ *
+ * @return Компонент или NULL.
+ */
+const class_summary_component_t *class_summary_find(const class_summary_t *summary, atom_t name);
+
+/**
+ * @brief Имя по индексу из записи сводки.
+ */
+atom_t class_summary_name(const class_summary_t *summary, uint32_t index);
+
+/**
+ * @brief Раскладка по индексу из записи сводки.
+ *
+ * @return Раскладка; type_unknown или type_cyclic, если при записи её нельзя было
+ *         вычислить; NULL для индекса 0.
+ */
+const TypeInfo *class_summary_type(const class_summary_t *summary, uint32_t index);
+
+/**
+ * @brief Значение константы или VALUE компонента в том виде, как оно записано в исходнике.
+ *
+ * @return Текст или NULL, если значения нет.
+ */
+const char *class_summary_value(const class_summary_t *summary, const class_summary_component_t *component);
+
+/**
+ * @brief Атом составного имени компонента: "<owner><separator><component>".
+ *
+ * @param separator "=>" или "~".
+ * @param intern false — только поиск уже интернированного имени (atom_find()).
+ * @return Атом или ATOM_NONE (имя слишком длинное или, без intern, ещё не встречалось).
+ */
+atom_t class_summary_member(atom_t owner, const char *separator, atom_t component, bool intern);
+
+/**
+ * @brief Объявляет класс или интерфейс в таблице, из которой замораживаются символы
+ *        DDIC и пулов классов (см. semantic_analyze()).
+ *
+ * Кроме имени класса объявляется каждый публичный компонент под составным именем
+ * "класс=>компонент" (у интерфейса — и "интерфейс~компонент") с видом и раскладкой
+ * из сводки, поэтому semantic_resolve() находит zcl=>comp одной пробой. У символа
+ * класса source_hash — хеш исходника из сводки, у компонента — хеш его записи
+ * (значение, параметры); по ним semantic_fingerprint() замечает изменённую сводку.
+ * Символы ссылаются на раскладки сводки: её нельзя закрывать, пока используется
+ * таблица.
+ *
+ * @return false при нехватке памяти.
+ */
+bool class_summary_declare(const class_summary_t *summary, symbol_table_t *builder);
+
+#endif // CLASS_SUMMARY_H
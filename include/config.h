@@ -0,0 +1,29 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+// Настройки компилятора: значения по умолчанию, файл конфигурации (ключ=значение)
+// и параметры командной строки (src/core/main.c)
+
+// Значения по умолчанию
+void config_init_defaults();
+
+// Загрузка из файла; 0 — файл не открылся
+int config_load_from_file(const char *filename);
+
+const char *config_get_output_dir();
+int config_get_optimization_level();
+void config_set_optimization_level(int level);
+int config_is_debug_enabled();
+void config_set_debug(int debug);
+int config_is_verbose();
+void config_set_verbose(int verbose);
+
+// Каталог кэша плоских AST (ast_cache.h) или NULL
+const char *config_get_cache_dir();
+void config_set_cache_dir(const char *dir);
+
+// Каталог сводок классов и интерфейсов (class_summary.h) или NULL
+const char *config_get_summary_dir();
+void config_set_summary_dir(const char *dir);
+
+#endif // CONFIG_H
@@ -0,0 +1,97 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * @file diagnostics.h
+ * @brief Накопление сообщений компилятора (ошибок, предупреждений) вместо немедленного вывода.
+ *
+ * Проходы компилятора записывают сообщения в список и продолжают работу; вызывающий
+ * решает, печатать ли их и считать ли единицу компиляции неудачной. Так один процесс
+ * обрабатывает весь пакет программ и сообщает обо всех ошибках сразу.
+ */
+
+/// Важность сообщения
+typedef enum {
+    DIAG_ERROR,
+    DIAG_WARNING,
+    DIAG_NOTE,
+} diag_severity_t;
+
+/**
+ * @struct diagnostic_t
+ * @brief Одно сообщение с позицией в исходном тексте.
+ */
+typedef struct {
+    diag_severity_t severity;   ///< Важность
+    int line;                   ///< Строка (с 1; 0 — позиция неизвестна)
+    int column;                 ///< Колонка (с 1)
+    char *message;              ///< Текст сообщения (принадлежит списку)
+} diagnostic_t;
+
+/**
+ * @struct diag_list_t
+ * @brief Список сообщений единицы компиляции.
+ */
+typedef struct {
+    diagnostic_t *items;        ///< Сообщения в порядке поступления
+    int count;                  ///< Количество сообщений
+    int capacity;               ///< Вместимость items
+    int error_count;            ///< Сколько из них ошибок
+    int max_errors;             ///< Предел числа ошибок (0 — без предела); лишние отбрасываются
+} diag_list_t;
+
+/**
+ * @brief Инициализация пустого списка без предела числа ошибок.
+ */
+void diag_list_init(diag_list_t *list);
+
+/**
+ * @brief Освобождение сообщений списка.
+ */
+void diag_list_free(diag_list_t *list);
+
+/**
+ * @brief Добавляет сообщение; текст форматируется как у printf.
+ *
+ * @return false, если сообщение отброшено (предел ошибок или нехватка памяти).
+ */
+bool diag_report(diag_list_t *list, diag_severity_t severity, int line, int column,
+                 const char *format, ...) __attribute__((format(printf, 5, 6)));
+
+/**
+ * @brief Переносит сообщения from в конец list (from становится пустым).
+ *
+ * Сообщения частей, обработанных параллельно, сливаются в порядке частей, поэтому
+ * итоговый список не зависит от того, какой поток какую часть обработал.
+ *
+ * @return false при нехватке памяти (from не изменяется).
+ */
+bool diag_list_append(diag_list_t *list, diag_list_t *from);
+
+/**
+ * @brief Заменяет сообщения [first, first + count) списка сообщениями from (from становится пустым).
+ *
+ * Нужна, когда часть текста обработана заново: её старые сообщения уходят, новые встают
+ * на их место, порядок остальных не меняется.
+ *
+ * @return false при нехватке памяти или неверном отрезке (списки не изменяются).
+ */
+bool diag_list_replace(diag_list_t *list, int first, int count, diag_list_t *from);
+
+/**
+ * @brief Предел ошибок достигнут: дальнейшие ошибки отбрасываются.
+ */
+bool diag_limit_reached(const diag_list_t *list);
+
+/**
+ * @brief Печать сообщений в формате "file:line:column: error: message"
+ *        ("file: error: message", если позиция неизвестна).
+ *
+ * @param path Имя файла для префикса или NULL.
+ */
+void diag_list_print(const diag_list_t *list, FILE *out, const char *path);
+
+#endif // DIAGNOSTICS_H
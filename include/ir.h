@@ -53,6 +53,7 @@ void ir_program_free(IRProgram *prog);
 #define IR_H
 
 #include <stdbool.h>
+#include "atom.h"
 
 // Типы операций IR (пример, можно расширять под свои нужды)
 typedef enum {
@@ -60,6 +61,24 @@ typedef enum {
     IR_OP_SUB,       // Вычитание
     IR_OP_MUL,       // Умножение
     IR_OP_DIV,       // Деление
+    IR_OP_MOD,       // Остаток (MOD)
+    IR_OP_POW,       // Степень (**)
+    IR_OP_NEG,       // Унарный минус: dst = -src1
+    IR_OP_CONCAT,    // Конкатенация строк (&&)
+    IR_OP_EQ,        // Сравнения: dst = src1 <op> src2 (истина — 1, ложь — 0)
+    IR_OP_NE,
+    IR_OP_LT,
+    IR_OP_GT,
+    IR_OP_LE,
+    IR_OP_GE,
+    IR_OP_AND,       // Логическое И
+    IR_OP_OR,        // Логическое ИЛИ
+    IR_OP_NOT,       // Логическое отрицание: dst = !src1
+    IR_OP_IN,        // Значение src1 входит в таблицу диапазонов src2
+    IR_OP_IS_INITIAL,   // Предикаты IS ...: dst = предикат от src1
+    IR_OP_IS_BOUND,
+    IR_OP_IS_ASSIGNED,
+    IR_OP_IS_SUPPLIED,
     IR_OP_LOAD,      // Загрузка значения
     IR_OP_STORE,     // Сохранение значения
     IR_OP_JMP,       // Безусловный переход
@@ -67,6 +86,7 @@ typedef enum {
     IR_OP_CALL,      // Вызов функции
     IR_OP_RET,       // Возврат из функции
     IR_OP_NOP,       // Пустая операция (no operation)
+    IR_OP_COUNT,     // Число операций (размер таблиц по ir_op_t)
     // Добавьте другие операции по необходимости
 } ir_op_t;
 
@@ -76,6 +96,7 @@ typedef enum {
     IR_OPERAND_CONSTANT,   // Константа (число)
     IR_OPERAND_LABEL,      // Метка (адрес для переходов)
     IR_OPERAND_VARIABLE,   // Переменная (символ)
+    IR_OPERAND_STRING,     // Текст литерала, не являющегося целым числом
 } ir_operand_type_t;
 
 // Операнд IR
@@ -85,7 +106,8 @@ typedef struct ir_operand {
         int reg;             // Номер регистра
         int constant;        // Константное значение
         char *label;         // Имя метки
-        char *var_name;      // Имя переменной
+        atom_t var;          // Имя переменной (атом, см. atom.h)
+        char *string;        // Текст литерала (копия)
     } value;
 } ir_operand_t;
 
@@ -122,9 +144,15 @@ ir_operand_t *ir_operand_new_label(const char *label);
 
 /**
  * @brief Создаёт новый операнд с типом переменная.
- * @param var_name Имя переменной (строка дублируется)
+ * @param var Атом имени переменной (строка не копируется)
  */
-ir_operand_t *ir_operand_new_variable(const char *var_name);
+ir_operand_t *ir_operand_new_variable(atom_t var);
+
+/**
+ * @brief Создаёт новый операнд с текстом литерала.
+ * @param text Текст литерала (строка дублируется)
+ */
+ir_operand_t *ir_operand_new_string(const char *text);
 
 /**
  * @brief Освобождает память, занятую операндом.
@@ -156,6 +184,11 @@ void ir_list_append(ir_list_t *list, ir_instruction_t *inst);
  */
 void ir_list_free(ir_list_t *list);
 
+/**
+ * @brief Мнемоника операции ("ADD", "IS_INITIAL", ...).
+ */
+const char *ir_op_name(ir_op_t op);
+
 /**
  * @brief Печатает список инструкций IR для отладки.
  */
@@ -0,0 +1,33 @@
+#ifndef IR_FLAT_H
+#define IR_FLAT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ast_flat.h"
+#include "ir.h"
+
+/**
+ * @file ir_flat.h
+ * @brief Перевод плоского AST (ast_flat.h) в список инструкций IR (ir.h).
+ *
+ * Операторы программы перебираются переходом к следующему брату, выражения
+ * переводятся одним проходом по массиву узлов без рекурсии. Поддерживаются
+ * присваивания и весь набор операторов разбора выражений (parser_expression.h):
+ * арифметика, сравнения, AND/OR/NOT, &&, IS [NOT] ..., [NOT] BETWEEN, [NOT] IN.
+ */
+
+/**
+ * @brief Генерация IR для плоского AST.
+ *
+ * Оператор AST_ASSIGNMENT (цель AST_VARIABLE и выражение) и AST_STATEMENT с атомом
+ * и выражением-потомком дают вычисление выражения в регистры и IR_OP_STORE. Прочие
+ * операторы (объявления, операторы без перевода) пропускаются.
+ *
+ * @param tree Плоское дерево.
+ * @param root Индекс корня (AST_PROGRAM — перебираются его потомки).
+ * @param out Список, в конец которого добавляются инструкции.
+ * @return true, если все операторы переведены.
+ */
+bool irgen_generate_flat(const ast_flat_t *tree, uint32_t root, ir_list_t *out);
+
+#endif // IR_FLAT_H
@@ -71,42 +71,65 @@ Token lexer_next_token(Lexer *lexer);
 #define LEXER_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "source_buffer.h"
+#include "token.h"
 
-// Типы токенов (пример, полный список в token.h)
-typedef enum {
-    TOKEN_EOF,
-    TOKEN_IDENTIFIER,
-    TOKEN_KEYWORD,
-    TOKEN_NUMBER,
-    TOKEN_STRING,
-    TOKEN_OPERATOR,
-    TOKEN_COMMENT,
-    TOKEN_UNKNOWN,
-} token_type_t;
+// Тип токена лексера — полный список типов в token.h.
+// Ключевые слова распознаются сразу в конкретные TOKEN_KEYWORD_* (см. abap_keywords.h).
+typedef TokenType token_type_t;
 
-// Структура токена
+// Структура токена.
+// Токен не владеет текстом: лексема — это срез (offset, length) исходного буфера,
+// поэтому токен действителен, пока жив буфер, из которого он получен.
 typedef struct {
     token_type_t type;
-    char *lexeme;       // Слово/текст токена (динамически выделяется)
+    uint32_t offset;    // Смещение лексемы от начала исходного текста
+    uint32_t length;    // Длина лексемы в байтах
     int line;           // Номер строки в исходнике
     int column;         // Колонка начала токена
+    atom_t atom;        // Атом имени для TOKEN_IDENTIFIER (см. atom.h), иначе ATOM_NONE
 } token_t;
 
-// Лексер - структура состояния лексического анализатора
+// Лексер - структура состояния лексического анализатора.
+// Строка и колонка не отслеживаются посимвольно: они вычисляются для начала
+// каждого токена по индексу переводов строк, построенному одним SIMD-проходом.
 typedef struct {
-    const char *source; // Указатель на исходный текст программы
-    int pos;            // Текущая позиция в source
-    int line;           // Текущая строка
-    int column;         // Текущая колонка
+    const char *source;     // Указатель на исходный текст программы (не обязательно с '\0' в конце)
+    size_t length;          // Длина исходного текста
+    size_t pos;             // Текущая позиция в source
+    uint32_t *newlines;     // Смещения всех '\n' в source по возрастанию
+    size_t newline_count;   // Количество переводов строк
+    size_t line_cursor;     // Число переводов строк до последнего выданного токена
 } lexer_t;
 
-// Инициализация лексера
-void lexer_init(lexer_t *lexer, const char *source);
+// Инициализация лексера над буфером исходного текста (без копирования)
+void lexer_init(lexer_t *lexer, const char *source, size_t length);
+
+// Лексер, продолжающий с позиции pos, без индекса строк: строка и колонка токенов
+// не вычисляются (только тип, срез и атом). Для перелексирования участка после правки,
+// где построение индекса по всему тексту стоило бы O(размер файла).
+void lexer_init_at(lexer_t *lexer, const char *source, size_t length, size_t pos);
+
+// Освобождение индекса строк лексера (исходный буфер не затрагивается)
+void lexer_free(lexer_t *lexer);
+
+// Строка и колонка (с 1) для произвольного смещения в исходном тексте — O(log N)
+void lexer_offset_to_position(const lexer_t *lexer, size_t offset, int *line, int *column);
+
+// Инициализация лексера над исходным файлом: файл отображается в память (mmap).
+// Буфер необходимо закрыть source_buffer_close() после того, как токены больше не нужны.
+bool lexer_init_file(lexer_t *lexer, source_buffer_t *buffer, const char *path);
 
 // Получить следующий токен из исходного текста
 token_t lexer_next_token(lexer_t *lexer);
 
-// Освободить память, выделенную под токен
-void token_free(token_t *token);
+// Указатель на начало лексемы в исходном буфере (строка НЕ завершена нулём, длина — token->length)
+const char *lexer_token_text(const lexer_t *lexer, const token_t *token);
+
+// Копия лексемы в виде C-строки — только для кода, которому действительно нужна своя строка.
+// Результат освобождается free().
+char *lexer_token_strdup(const lexer_t *lexer, const token_t *token);
 
 #endif // LEXER_H
@@ -0,0 +1,50 @@
+#ifndef LEXER_INCREMENTAL_H
+#define LEXER_INCREMENTAL_H
+
+#include "token_stream.h"
+#include "source_buffer.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file lexer_incremental.h
+ * @brief Инкрементальное перелексирование после правки текста (для редактора).
+ *
+ * Вместо лексики всего файла на каждое нажатие клавиши перелексируется только
+ * повреждённый участок: от последнего токена, на который правка не может повлиять,
+ * до первого токена после правки, с которого новая лексика совпадает со старой.
+ * Результат вклеивается в существующий TokenStream (см. token_stream_edit()).
+ */
+
+/**
+ * @struct lexer_relex_result_t
+ * @brief Какие токены заменила правка — для подсветки и инкрементального разбора.
+ */
+typedef struct {
+    int first;          ///< Индекс первого заменённого токена
+    int removed;        ///< Сколько токенов было в заменённом диапазоне
+    int inserted;       ///< Сколько токенов в нём стало
+    size_t relexed;     ///< Сколько байт текста перелексировано
+} lexer_relex_result_t;
+
+/**
+ * @brief Перелексирует участок текста, затронутый правкой, и обновляет поток.
+ *
+ * Время работы зависит от размера правки и повреждённого участка, а не от размера файла.
+ * Повреждённый участок выходит за правку, если она меняет лексему, продолжающуюся
+ * за границу правки: открывает или закрывает многострочный литерал, превращает
+ * остаток строки в комментарий и т.п.
+ *
+ * Старый текст сохранять не нужно: правку можно внести прямо в тот же буфер.
+ *
+ * @param stream Поток токенов текста до правки (построенный лексером или прошлыми правками).
+ * @param source Текст после правки.
+ * @param length Длина текста после правки.
+ * @param edit Правка в координатах текста до правки.
+ * @param result Описание замены (может быть NULL).
+ * @return true при успехе, false при некорректной правке или нехватке памяти (поток не изменяется).
+ */
+bool lexer_relex(TokenStream *stream, const char *source, size_t length,
+                 const source_edit_t *edit, lexer_relex_result_t *result);
+
+#endif // LEXER_INCREMENTAL_H
@@ -0,0 +1,43 @@
+#ifndef LEXER_PARALLEL_H
+#define LEXER_PARALLEL_H
+
+#include "token_stream.h"
+#include "thread_pool.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file lexer_parallel.h
+ * @brief Параллельная лексика больших исходных файлов.
+ *
+ * Текст режется на фрагменты по границам операторов (строка, заканчивающаяся точкой),
+ * фрагменты лексируются на пуле потоков в отдельные потоки токенов, после чего
+ * склеиваются в один TokenStream с пересчитанными смещениями и таблицей строк.
+ * Результат совпадает с token_stream_from_lexer() над тем же текстом.
+ */
+
+/// Файлы меньше этого размера лексируются в одном потоке: выигрыш не окупает склейку
+#define LEXER_PARALLEL_MIN_SIZE   (256 * 1024)
+
+/// Фрагментов на поток пула — чтобы неравные по стоимости фрагменты балансировались
+#define LEXER_PARALLEL_CHUNKS_PER_THREAD 4
+
+/// Насколько далеко от намеченной точки разреза искать конец оператора
+#define LEXER_PARALLEL_SPLIT_WINDOW (64 * 1024)
+
+/**
+ * @brief Лексирует source в stream, используя потоки pool.
+ *
+ * Строковый литерал, пересекающий границу фрагментов, обнаруживается при склейке:
+ * такие фрагменты перелексируются вместе, поэтому результат не зависит от разбиения.
+ *
+ * @param stream Поток для инициализации (смещения указывают в source).
+ * @param source Исходный текст (не обязательно с '\0' в конце).
+ * @param length Длина текста.
+ * @param pool Пул потоков; NULL или пул из одного потока — последовательная лексика.
+ * @return true при успехе, false при нехватке памяти.
+ */
+bool lexer_parallel_tokenize(TokenStream *stream, const char *source, size_t length,
+                             thread_pool_t *pool);
+
+#endif // LEXER_PARALLEL_H
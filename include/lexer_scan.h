@@ -0,0 +1,62 @@
+#ifndef LEXER_SCAN_H
+#define LEXER_SCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file lexer_scan.h
+ * @brief Ядра сканирования исходного текста для лексера (SSE2/AVX2 и скалярная версия).
+ *
+ * Каждое ядро возвращает длину начального отрезка, состоящего из символов
+ * одного класса, обрабатывая 16 (SSE2) или 32 (AVX2) байта за итерацию.
+ * Реализация выбирается один раз по возможностям процессора.
+ */
+
+/// Доступные реализации ядер
+typedef enum {
+    LEXER_SCAN_AUTO,    ///< Выбрать лучшую по возможностям процессора
+    LEXER_SCAN_SCALAR,  ///< Побайтовая версия (работает везде)
+    LEXER_SCAN_SSE2,    ///< 16 байт за итерацию
+    LEXER_SCAN_AVX2,    ///< 32 байта за итерацию
+} lexer_scan_impl_t;
+
+/**
+ * @struct lexer_scan_ops_t
+ * @brief Таблица ядер сканирования.
+ */
+typedef struct {
+    lexer_scan_impl_t impl;
+    /// Длина отрезка из пробельных символов (' ', '\t', '\r', '\n')
+    size_t (*whitespace)(const char *text, size_t length);
+    /// Длина отрезка из символов идентификатора ([A-Za-z0-9_])
+    size_t (*identifier)(const char *text, size_t length);
+    /// Длина отрезка из десятичных цифр
+    size_t (*digits)(const char *text, size_t length);
+    /// Позиция первого вхождения символа (или length, если его нет) — для литералов и комментариев
+    size_t (*find_char)(const char *text, size_t length, char c);
+    /// Записывает смещения всех '\n' в out (если out != NULL) и возвращает их количество
+    size_t (*newlines)(const char *text, size_t length, uint32_t *out);
+} lexer_scan_ops_t;
+
+/**
+ * @brief Текущая таблица ядер (при первом вызове выбирается автоматически).
+ */
+const lexer_scan_ops_t *lexer_scan_ops(void);
+
+/**
+ * @brief Принудительный выбор реализации (для бенчмарков и отладки).
+ *
+ * Если запрошенная реализация не поддерживается процессором, выбирается лучшая доступная.
+ *
+ * @param impl Желаемая реализация.
+ * @return Фактически выбранная реализация.
+ */
+lexer_scan_impl_t lexer_scan_select(lexer_scan_impl_t impl);
+
+/**
+ * @brief Имя реализации для вывода.
+ */
+const char *lexer_scan_impl_name(lexer_scan_impl_t impl);
+
+#endif // LEXER_SCAN_H
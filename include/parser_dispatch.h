@@ -0,0 +1,332 @@
+#ifndef PARSER_DISPATCH_H
+#define PARSER_DISPATCH_H
+
+#include <stdbool.h>
+#include "ast.h"
+#include "diagnostics.h"
+#include "token.h"
+#include "token_stream.h"
+
+/**
+ * @file parser_dispatch.h
+ * @brief Табличный выбор модуля разбора оператора по ведущему ключевому слову.
+ *
+ * Оператор ABAP определяется первым ключевым словом, а у части операторов — вторым
+ * (READ TABLE, CALL FUNCTION, CALL METHOD). parse_statement() находит модуль за O(1):
+ * таблица по типу первого токена, для уточняемых операторов — таблица по типу второго.
+ *
+ * Модули регистрируются сами макросом PARSER_STATEMENT() в своём файле; центральный
+ * список операторов не нужен. Регистрация выполняется до main() (конструкторы GCC/Clang),
+ * поэтому объектный файл модуля должен попасть в сборку целиком (при статической
+ * библиотеке — с --whole-archive).
+ *
+ * Ошибка не прерывает разбор (panic mode): оператор, который модуль не разобрал,
+ * заменяется узлом AST_ERROR, сообщение записывается в активный список диагностик
+ * потока, и разбор продолжается со следующего оператора.
+ */
+
+/// Функция разбора оператора; получает поток после поглощённых ключевых слов
+typedef ASTNode *(*parser_statement_fn)(TokenStream *ts);
+
+/**
+ * @struct parser_statement_rule_t
+ * @brief Правило выбора модуля.
+ */
+typedef struct {
+    TokenType first;            ///< Первое ключевое слово (или TOKEN_IDENTIFIER для присваиваний)
+    TokenType second;           ///< Второе ключевое слово; TOKEN_UNKNOWN — любое
+    int consumed;               ///< Сколько ведущих токенов поглощается до вызова (0, 1 или 2)
+    parser_statement_fn parse;  ///< Модуль разбора
+    const char *name;           ///< Имя функции модуля (для диагностики)
+} parser_statement_rule_t;
+
+/**
+ * @brief Регистрирует модуль разбора оператора.
+ *
+ * Правило с конкретным вторым словом имеет приоритет над правилом «любое второе слово»
+ * для того же первого слова.
+ *
+ * @return false, если такое правило уже зарегистрировано (остаётся первое) или аргументы неверны.
+ */
+bool parser_register_statement(TokenType first, TokenType second, int consumed,
+                               parser_statement_fn parse, const char *name);
+
+/**
+ * @brief Правило для пары ведущих токенов или NULL.
+ */
+const parser_statement_rule_t *parser_statement_lookup(TokenType first, TokenType second);
+
+/**
+ * @brief Разбирает оператор с текущей позиции потока, выбирая модуль по таблице.
+ *
+ * Если оператор неизвестен, модуль вернул NULL или сообщил об ошибке (report_error()),
+ * возвращается узел AST_ERROR (частично разобранный оператор — его потомок), а поток
+ * синхронизируется parser_stream_synchronize().
+ *
+ * @return AST оператора, узел AST_ERROR или NULL в конце потока (и при нехватке памяти).
+ */
+ASTNode *parse_statement(TokenStream *ts);
+
+/**
+ * @brief Смещение в исходном тексте первого токена оператора, который parse_statement()
+ *        разберёт с текущей позиции (пустые точки пропускаются, поток не сдвигается).
+ */
+uint32_t parser_statement_offset(const TokenStream *ts);
+
+/**
+ * @brief Добавляет смещение к массиву позиций операторов *offsets из count элементов.
+ *
+ * Массив растёт вдвое. При нехватке памяти он освобождается и *offsets становится NULL;
+ * следующие вызовы с count > 0 ничего не делают — позиции необязательны.
+ */
+void parser_offsets_push(uint32_t **offsets, int count, uint32_t offset);
+
+/**
+ * @brief Сообщение модуля разбора об ошибке в текущем операторе.
+ *
+ * Позиция — текущий токен потока, который разбирает parse_statement() в этом потоке.
+ * До синхронизации повторные сообщения не записываются: это почти всегда следствия
+ * первой ошибки.
+ */
+void report_error(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Синхронизация после ошибки: пропуск до точки (поглощается) или до ключевого
+ *        слова границы блока в начале строки (не поглощается, см. token_is_block_boundary()).
+ */
+void parser_stream_synchronize(TokenStream *ts);
+
+/**
+ * @brief Делает list списком диагностик разбора в текущем потоке.
+ *
+ * Без активного списка сообщения печатаются в stderr.
+ *
+ * @return Прежний активный список (для восстановления).
+ */
+diag_list_t *parser_diagnostics_activate(diag_list_t *list);
+
+/**
+ * @struct parser_statement_record_t
+ * @brief Оператор, разобранный parse_statement(): диапазон токенов, узел и сообщения.
+ */
+typedef struct {
+    int start;          ///< Первый токен оператора (после пропущенных пустых точек)
+    int end;            ///< Токен за последним токеном оператора
+    int depth;          ///< Вложенность: 0 — оператор, не вложенный в другие операторы журнала
+    ASTNode *node;      ///< Результат parse_statement() (NULL — нехватка памяти)
+    int diag_first;     ///< Первое сообщение оператора в активном списке диагностик
+    int diag_end;       ///< Индекс за последним сообщением оператора (вложенные операторы включены)
+    bool panic;         ///< Разбор начат после ошибки объемлющего оператора, ещё не снятой синхронизацией
+} parser_statement_record_t;
+
+/**
+ * @struct parser_statement_log_t
+ * @brief Журнал операторов для инкрементального разбора (parser_incremental.h).
+ *
+ * Запись создаётся при входе в parse_statement(), поэтому записи идут в прямом порядке
+ * обхода: вложенные операторы блока — сразу за оператором блока.
+ *
+ * Для каждого сообщения, записанного report_error() в активный список, журнал хранит
+ * индекс токена, на который оно указывает: после правки позицию сообщения можно
+ * пересчитать, не разбирая оператор заново. Если список был пуст при активации журнала,
+ * message_tokens[i] относится к его i-му сообщению.
+ */
+typedef struct {
+    parser_statement_record_t *records; ///< Записи в порядке начала разбора
+    int count;                          ///< Количество записей
+    int capacity;                       ///< Вместимость records
+    int depth;                          ///< Текущая вложенность parse_statement()
+    int *message_tokens;                ///< Токены сообщений в порядке записи
+    int message_count;                  ///< Количество сообщений
+    int message_capacity;               ///< Вместимость message_tokens
+    bool failed;                        ///< Не хватило памяти: журнал неполон
+} parser_statement_log_t;
+
+/**
+ * @brief Делает log журналом операторов в текущем потоке (NULL — не записывать).
+ *
+ * @return Прежний активный журнал (для восстановления).
+ */
+parser_statement_log_t *parser_statement_log_activate(parser_statement_log_t *log);
+
+/**
+ * @brief Освобождение записей журнала.
+ */
+void parser_statement_log_free(parser_statement_log_t *log);
+
+// ---------------------------------------------------------------------------
+// Общие шаги модулей разбора
+
+/**
+ * @brief Поглощает текущий токен, если он типа type.
+ */
+bool parser_accept(TokenStream *ts, TokenType type);
+
+/**
+ * @brief Поглощает токен типа type или сообщает "Expected <what>" (report_error()).
+ */
+bool parser_expect(TokenStream *ts, TokenType type, const char *what);
+
+/**
+ * @brief Поглощает идентификатор с текстом word (без учёта регистра).
+ *
+ * Для слов, которым лексер не заводит ключевых (REF, LENGTH, DECIMALS, TIMES, ...).
+ */
+bool parser_accept_word(TokenStream *ts, const char *word);
+
+/**
+ * @brief Текущий токен — идентификатор с текстом word (без учёта регистра); не поглощается.
+ */
+bool parser_peek_word(const TokenStream *ts, const char *word);
+
+/**
+ * @brief Токен типа type может быть именем: идентификатор или незарезервированное ключевое слово.
+ *
+ * Ключевые слова ABAP не зарезервированы: поле, параметр или компонент может называться
+ * KEY, VALUE, TABLE, END, TYPE, DATA, STOP. Именем не бывают слова выражений (IS, IN,
+ * BETWEEN, TRUE, FALSE) и разделов параметров (IMPORTING, EXPORTING, CHANGING, RETURNING,
+ * RAISING, EXCEPTIONS), по которым списки имён находят свой конец, а также слова границ
+ * блоков (token_is_block_boundary()), на которых восстанавливается разбор после ошибки.
+ */
+bool parser_is_name_token(TokenType type);
+
+/**
+ * @brief Атом текущего токена, если он имя (parser_is_name_token()), иначе ATOM_NONE;
+ *        токен не поглощается.
+ */
+atom_t parser_peek_name(const TokenStream *ts);
+
+/**
+ * @brief Поглощает имя (parser_is_name_token()) и возвращает его атом; иначе ATOM_NONE.
+ */
+atom_t parser_accept_name(TokenStream *ts);
+
+/**
+ * @brief Конец оператора: поглощает точку или сообщает об ошибке.
+ */
+bool parser_end_statement(TokenStream *ts);
+
+/**
+ * @brief Тело блока: операторы parse_statement() до слова из ends (не поглощается).
+ *
+ * Операторы добавляются потомками parent; ошибочные — узлами AST_ERROR.
+ *
+ * @return false, если поток кончился раньше, чем встретилось завершающее слово
+ *         (сообщение "Expected <what>").
+ */
+bool parser_parse_block(TokenStream *ts, ASTNode *parent, const TokenType *ends, int end_count,
+                        const char *what);
+
+/**
+ * @brief Дополнение оператора: узел AST_STATEMENT_CLAUSE со словами keywords
+ *        (string_value), добавленный потомком parent.
+ *
+ * @return Узел или NULL при нехватке памяти (сообщение — через report_error()).
+ */
+ASTNode *parser_add_clause(ASTNode *parent, const char *keywords);
+
+/**
+ * @brief Дополнение с одним операндом: parser_add_clause(), затем выражение
+ *        parse_expression() потомком дополнения ("INTO wa", "WHERE cond", "TO n").
+ *
+ * Слова дополнения к этому моменту уже поглощены.
+ *
+ * @return false при ошибке (сообщение — через report_error()).
+ */
+bool parser_parse_clause(TokenStream *ts, ASTNode *parent, const char *keywords);
+
+/// Что следует за словами дополнения
+typedef enum {
+    PARSER_CLAUSE_FLAG,         ///< Ничего (IN UPDATE TASK, TRANSPORTING NO FIELDS)
+    PARSER_CLAUSE_OPERAND,      ///< Одно выражение (TO itab, INTO wa, WHERE cond)
+    PARSER_CLAUSE_LIST,         ///< Операнды до следующего дополнения (TRANSPORTING f1 f2, BY f1 f2)
+    PARSER_CLAUSE_BINDINGS      ///< Привязки name = value (WITH KEY, EXPORTING, ID)
+} parser_clause_kind_t;
+
+/// Дополнение оператора в таблице parser_parse_clauses()
+typedef struct {
+    const char *words;          ///< Слова через пробел в верхнем регистре ("REFERENCE INTO")
+    parser_clause_kind_t kind;
+} parser_clause_t;
+
+/**
+ * @brief Дополнения оператора по таблице до конца оператора (точка не поглощается).
+ *
+ * Дополнения допускаются в любом порядке; каждое даёт узел parser_add_clause() со
+ * словами из таблицы и операндами по виду. Слова сравниваются с текстом токенов без
+ * учёта регистра, поэтому ключевые слова и идентификаторы (TRANSPORTING, SORTED)
+ * записываются одинаково. Более длинные сочетания ставятся в таблице раньше
+ * коротких ("WITH TABLE KEY" перед "WITH KEY").
+ *
+ * @return false при ошибке или незнакомом токене (сообщение — через report_error()).
+ */
+bool parser_parse_clauses(TokenStream *ts, ASTNode *node, const parser_clause_t *clauses, int count);
+
+/**
+ * @brief С текущего токена начинается одно из дополнений таблицы; ничего не поглощается.
+ */
+bool parser_peek_clause(const TokenStream *ts, const parser_clause_t *clauses, int count);
+
+/**
+ * @brief Оператор без собственного вида узла (APPEND, READ TABLE, MESSAGE, ...) целиком.
+ *
+ * Ключевые слова оператора к этому моменту поглощены. Даёт узел AST_KEYWORD_STATEMENT
+ * со словами keywords в string_value. Если оператор не начинается сразу с дополнения,
+ * первым потомком становится главный операнд (выражение), а его имя, если это имя, —
+ * atom узла. Затем дополнения parser_parse_clauses() и точка.
+ *
+ * @return Узел (при ошибке — частично разобранный, сообщение через report_error())
+ *         или NULL при нехватке памяти.
+ */
+ASTNode *parser_parse_keyword_statement(TokenStream *ts, const char *keywords,
+                                        const parser_clause_t *clauses, int count);
+
+/**
+ * @brief Спецификаторы объявления (DATA, CONSTANTS, TYPES, PARAMETERS, ...) потомками decl.
+ *
+ * TYPE [REF TO | LINE OF | RANGE OF | [STANDARD|SORTED|HASHED] TABLE OF] имя, LIKE ...,
+ * LENGTH n, DECIMALS n, VALUE литерал | имя | IS INITIAL, READ-ONLY. REF TO, RANGE OF и
+ * TABLE OF дают AST_TYPE_SPEC или AST_LIKE_SPEC с этими словами в string_value; ключ
+ * таблицы (WITH ... KEY ...) пропускается. Останавливается на первом другом токене.
+ *
+ * @return false при ошибке (сообщение — через report_error()).
+ */
+bool parser_parse_type_specs(TokenStream *ts, ASTNode *decl);
+
+/**
+ * @brief Имя формального параметра FORM или METHODS: name, VALUE(name) или REFERENCE(name).
+ *
+ * @return Атом имени или ATOM_NONE (сообщение — через report_error()).
+ */
+atom_t parser_parse_parameter_name(TokenStream *ts);
+
+/**
+ * @brief Структура BEGIN OF имя ... END OF имя в DATA или TYPES.
+ *
+ * Вызывается, когда keyword (TOKEN_KEYWORD_DATA или TOKEN_KEYWORD_TYPES) уже поглощён,
+ * а текущий токен — BEGIN. Цепочка через ':' к этому моменту раскрыта, поэтому каждый
+ * компонент — отдельный оператор keyword; он разбирается parse_statement() и становится
+ * потомком decl. Поглощается всё до имени после END OF включительно (без точки).
+ *
+ * @return false при ошибке (сообщение — через report_error()).
+ */
+bool parser_parse_structure(TokenStream *ts, ASTNode *decl, TokenType keyword);
+
+/**
+ * @brief Регистрация модуля при загрузке программы; указывается в конце файла модуля.
+ *
+ * Пример: PARSER_STATEMENT(TOKEN_KEYWORD_READ, TOKEN_KEYWORD_TABLE, 2, parse_table_ops_read)
+ */
+#define PARSER_STATEMENT(first, second, consumed, fn)                              \
+    PARSER_STATEMENT_AT(__LINE__, first, second, consumed, fn)
+
+// Имя функции регистрации включает номер строки: один модуль может регистрироваться
+// под несколькими ключевыми словами (EXPORT и IMPORT)
+#define PARSER_STATEMENT_AT(line, first, second, consumed, fn)                     \
+    PARSER_STATEMENT_DEFINE(line, first, second, consumed, fn)
+#define PARSER_STATEMENT_DEFINE(line, first, second, consumed, fn)                 \
+    __attribute__((constructor)) static void parser_register_##fn##_##line(void) { \
+        parser_register_statement((first), (second), (consumed), (fn), #fn);       \
+    }
+
+#endif // PARSER_DISPATCH_H
@@ -0,0 +1,88 @@
+#ifndef PARSER_EXPRESSION_H
+#define PARSER_EXPRESSION_H
+
+#include "ast.h"
+#include "token.h"
+#include "token_stream.h"
+
+/**
+ * @file parser_expression.h
+ * @brief Разбор выражений методом Пратта (precedence climbing) по таблице приоритетов.
+ *
+ * Все выражения — арифметика, сравнения, AND/OR/NOT, IS [NOT] INITIAL,
+ * [NOT] BETWEEN, [NOT] IN и конкатенация && — разбирает один цикл: операнд, затем,
+ * пока приоритет следующего оператора не ниже заданного, оператор и его правый
+ * операнд. Вызов функции приходится на оператор, а не на уровень приоритета, поэтому
+ * "a + b" стоит одного вызова вместо прохода через все уровни грамматики.
+ *
+ * Приоритеты операторов заданы одной таблицей в pratt.c, индексируемой типом токена.
+ *
+ * Результат — узлы AST_OPERATOR (string_value — текст оператора в верхнем регистре,
+ * потомки — операнды слева направо), AST_LITERAL (string_value — текст литерала)
+ * AST_IDENTIFIER (atom — имя) и AST_FUNCTION_CALL (atom — имя, потомки — позиционный
+ * аргумент или узлы AST_PARAMETER_BINDING). Скобки отдельного узла не дают.
+ */
+
+/// Уровни приоритета (больше — сильнее связывает)
+typedef enum {
+    PARSER_PREC_NONE = 0,       ///< Выражение целиком
+    PARSER_PREC_OR,             ///< OR
+    PARSER_PREC_AND,            ///< AND
+    PARSER_PREC_NOT,            ///< Префиксный NOT
+    PARSER_PREC_COMPARISON,     ///< = <> < > <= >=, IS, BETWEEN, IN
+    PARSER_PREC_CONCAT,         ///< &&
+    PARSER_PREC_ADDITIVE,       ///< + -
+    PARSER_PREC_MULTIPLICATIVE, ///< * / MOD
+    PARSER_PREC_UNARY,          ///< Префиксные + и -
+    PARSER_PREC_POWER,          ///< ** (правоассоциативный)
+} parser_precedence_t;
+
+/**
+ * @brief Разбирает выражение с текущей позиции потока.
+ *
+ * Останавливается перед первым токеном, который не продолжает выражение
+ * (точка, запятая, ключевое слово оператора и т.п.); этот токен не поглощается.
+ *
+ * @return Корень выражения или NULL при ошибке (сообщение — через report_error()).
+ */
+ASTNode *parse_expression(TokenStream *ts);
+
+/**
+ * @brief Разбирает выражение из операторов с приоритетом не ниже min_precedence.
+ *
+ * Например, PARSER_PREC_CONCAT даёт операнд сравнения без самих сравнений и
+ * логических связок — для контекстов, где AND или "=" заканчивают выражение
+ * (границы BETWEEN, правая часть присваивания в списке параметров).
+ */
+ASTNode *parse_expression_prec(TokenStream *ts, parser_precedence_t min_precedence);
+
+/**
+ * @brief Разбирает имя: идентификатор или <символ поля> вместе с компонентами,
+ *        записанными без пробелов (struct-comp, ref->attr, class=>const, intf~comp).
+ *
+ * @return Атом полного имени или ATOM_NONE (поток не сдвигается), если имени нет.
+ */
+atom_t parse_name(TokenStream *ts);
+
+/**
+ * @brief Разбирает список "name = value" (аргументы вызова, EXPORTING/IMPORTING/EXCEPTIONS
+ *        в CALL FUNCTION и т.п.) в узлы AST_PARAMETER_BINDING — потомки parent.
+ *
+ * Останавливается на первом токене, за которым не следует "="; значение — выражение
+ * без сравнений (PARSER_PREC_CONCAT), чтобы "a = b c = d" давало две привязки.
+ *
+ * @return false при ошибке (сообщение — через report_error()).
+ */
+bool parse_bindings(TokenStream *ts, ASTNode *parent);
+
+/**
+ * @brief Приоритет type как инфиксного оператора или PARSER_PREC_NONE.
+ */
+parser_precedence_t parser_infix_precedence(TokenType type);
+
+/**
+ * @brief Текст оператора для узла AST_OPERATOR ("+", "AND", "MOD" и т.п.) или NULL.
+ */
+const char *parser_operator_text(TokenType type);
+
+#endif // PARSER_EXPRESSION_H
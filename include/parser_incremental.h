@@ -0,0 +1,112 @@
+#ifndef PARSER_INCREMENTAL_H
+#define PARSER_INCREMENTAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ast.h"
+#include "diagnostics.h"
+#include "lexer_incremental.h"
+#include "token_stream.h"
+
+/**
+ * @file parser_incremental.h
+ * @brief Инкрементальный разбор после правки: переразбирается только наименьший
+ *        затронутый оператор или блок.
+ *
+ * Документ хранит дерево программы и таблицу единиц — всех операторов, разобранных
+ * parse_statement(), с диапазонами токенов. После lexer_relex() правка сводится к
+ * замене токенов [first, first + removed); документ ищет наименьшую единицу, целиком
+ * содержащую замену (оператор, IF ... ENDIF, METHOD, FORM), разбирает её заново с того
+ * же начала и подставляет новый узел на место старого. Соседние операторы и их
+ * поддеревья остаются прежними узлами.
+ *
+ * Переразбор единицы принимается, только если он закончился на прежнем (сдвинутом)
+ * конце и правка не изменила последовательность ключевых слов блоков в диапазоне —
+ * иначе граница могла сместиться, и берётся объемлющая единица. Если не подошла ни одна,
+ * заново разбираются операторы верхнего уровня от затронутого до первого, начало
+ * которого после правки совпало со старым. Результат совпадает с полным разбором
+ * нового потока.
+ */
+
+/**
+ * @struct parser_unit_t
+ * @brief Оператор документа: диапазон токенов и узел.
+ *
+ * Единицы лежат в прямом порядке обхода: вложенные операторы блока идут сразу
+ * за ним, subtree — размер поддерева единиц.
+ */
+typedef struct {
+    int start;              ///< Первый токен оператора
+    int end;                ///< Токен за последним токеном оператора
+    int subtree;            ///< Число единиц поддерева, включая эту
+    ASTNode *node;          ///< Узел оператора
+    int diag_first;         ///< Первое сообщение оператора в diagnostics документа
+    int diag_end;           ///< Индекс за последним сообщением оператора
+    uint32_t signature;     ///< Хеш ключевых слов блоков в диапазоне (IF, ENDIF, ELSE, FORM, ...)
+    bool panic;             ///< Начат в режиме panic объемлющего блока: отдельно не переразбирается
+} parser_unit_t;
+
+/**
+ * @struct parser_document_t
+ * @brief Разобранный поток, который обновляется правками.
+ */
+typedef struct {
+    TokenStream *ts;                ///< Поток токенов (принадлежит вызывающему)
+    ast_arena_t *arena;             ///< Арена всех узлов дерева
+    ASTNode *program;               ///< AST_PROGRAM: операторы верхнего уровня
+    parser_unit_t *units;           ///< Единицы в прямом порядке обхода
+    int unit_count;                 ///< Количество единиц
+    int unit_capacity;              ///< Вместимость units
+    diag_list_t diagnostics;        ///< Сообщения разбора в порядке текста
+    int *diag_tokens;               ///< Токен каждого сообщения (параллельно diagnostics.items)
+    int diag_token_capacity;        ///< Вместимость diag_tokens
+    size_t reparsed;                ///< Токенов, переразобранных с последнего полного разбора
+} parser_document_t;
+
+/**
+ * @struct parser_update_t
+ * @brief Что изменила правка: отрезок операторов верхнего уровня.
+ *
+ * Операторы верхнего уровня [first, first + removed) старого дерева заменены операторами
+ * [first, first + inserted) нового (program->children); остальные не менялись. Правка
+ * внутри блока даёт removed = inserted = 1 — блок тот же, изменилось его поддерево.
+ */
+typedef struct {
+    int first;              ///< Первый изменённый оператор верхнего уровня
+    int removed;            ///< Сколько операторов заменено
+    int inserted;           ///< Сколько операторов вставлено
+    int reparsed;           ///< Сколько токенов разобрано заново
+    bool full;              ///< Документ разобран заново целиком
+} parser_update_t;
+
+/**
+ * @brief Первичный (полный) разбор потока в документ.
+ *
+ * Поток не должен быть раскрыт token_stream_expand_chains(): правки отключают раскрытие,
+ * и индексы документа должны совпадать с индексами lexer_relex().
+ *
+ * @return true при успехе, false при нехватке памяти.
+ */
+bool parser_document_parse(parser_document_t *doc, TokenStream *ts);
+
+/**
+ * @brief Обновление документа после lexer_relex() над его потоком.
+ *
+ * Узлы заменённых операторов остаются в арене документа до следующего полного разбора;
+ * полный разбор выполняется сам, когда переразобрано больше токенов, чем их в потоке.
+ *
+ * @param doc Документ.
+ * @param relex Замена токенов, выполненная lexer_relex().
+ * @param update Изменённые операторы верхнего уровня (может быть NULL).
+ * @return true при успехе, false при нехватке памяти (документ нужно разобрать заново).
+ */
+bool parser_document_update(parser_document_t *doc, const lexer_relex_result_t *relex,
+                            parser_update_t *update);
+
+/**
+ * @brief Освобождение дерева, единиц и сообщений документа (поток не затрагивается).
+ */
+void parser_document_free(parser_document_t *doc);
+
+#endif // PARSER_INCREMENTAL_H
@@ -0,0 +1,93 @@
+#ifndef PARSER_PARALLEL_H
+#define PARSER_PARALLEL_H
+
+#include <stdbool.h>
+#include "ast.h"
+#include "diagnostics.h"
+#include "thread_pool.h"
+#include "token_stream.h"
+
+/**
+ * @file parser_parallel.h
+ * @brief Двухфазный разбор: поиск границ блоков и параллельный разбор их тел.
+ *
+ * Тела FORM ... ENDFORM, METHOD ... ENDMETHOD и MODULE ... ENDMODULE синтаксически
+ * независимы, как только известны их границы. Первая фаза (parser_skeleton_scan())
+ * проходит только по массиву типов токенов и делит поток на участки: блоки и код
+ * между ними. Вторая фаза разбирает участки на пуле потоков, каждый поток — в свою
+ * арену AST, и собирает операторы в узел программы в исходном порядке. Результат
+ * совпадает с последовательным разбором того же потока через parse_statement().
+ */
+
+/**
+ * @struct parser_segment_t
+ * @brief Участок потока токенов, разбираемый одной задачей.
+ */
+typedef struct {
+    int start;          ///< Первый токен участка
+    int end;            ///< Токен за последним токеном участка
+    TokenType kind;     ///< FORM, METHOD или MODULE для блока; TOKEN_UNKNOWN — код между блоками
+} parser_segment_t;
+
+/**
+ * @struct parser_skeleton_t
+ * @brief Разбиение потока на участки (результат первой фазы).
+ */
+typedef struct {
+    parser_segment_t *segments; ///< Участки в порядке следования в потоке
+    int count;                  ///< Количество участков
+    int capacity;               ///< Вместимость segments
+    int blocks;                 ///< Сколько из них блоков FORM/METHOD/MODULE
+} parser_skeleton_t;
+
+/**
+ * @struct parser_parallel_result_t
+ * @brief Результат параллельного разбора.
+ */
+typedef struct {
+    ASTNode *program;           ///< AST_PROGRAM: операторы всех участков в исходном порядке
+    uint32_t *offsets;          ///< Смещение первого токена каждого оператора program (NULL при нехватке памяти)
+    ast_arena_t **arenas;       ///< Арены потоков пула; в них лежат все узлы дерева
+    int arena_count;            ///< Количество арен
+    diag_list_t diagnostics;    ///< Ошибки разбора всех участков в исходном порядке
+} parser_parallel_result_t;
+
+/**
+ * @brief Делит поток на блоки FORM/METHOD/MODULE и код между ними.
+ *
+ * Блок начинается ключевым словом в начале оператора и заканчивается точкой после
+ * парного END-слова. Блок без конца не выделяется: остаток потока становится
+ * одним участком, и ошибку сообщит его разбор. Позиция чтения ts не меняется.
+ *
+ * @return true при успехе, false при нехватке памяти.
+ */
+bool parser_skeleton_scan(const TokenStream *ts, parser_skeleton_t *skeleton);
+
+/**
+ * @brief Освобождение разбиения.
+ */
+void parser_skeleton_free(parser_skeleton_t *skeleton);
+
+/**
+ * @brief Разбирает весь поток, распределяя участки по потокам pool.
+ *
+ * Поток ts не изменяется во время разбора: каждая задача читает его своим курсором
+ * (token_stream_cursor_init()) и пишет сообщения в свой список диагностик; списки
+ * сливаются по порядку участков, поэтому сообщения не зависят от распределения задач.
+ * Арены создаются по одной на поток пула и переходят к результату; дерево живёт
+ * до parser_parallel_result_free().
+ *
+ * @param ts Поток токенов (цепочки могут быть раскрыты).
+ * @param pool Пул потоков; NULL или пул из одного потока — разбор в вызывающем потоке.
+ * @param result Результат.
+ * @return true при успехе (даже если отдельные операторы не разобраны — они стали
+ *         узлами AST_ERROR, см. result->diagnostics), false при нехватке памяти.
+ */
+bool parser_parse_parallel(TokenStream *ts, thread_pool_t *pool, parser_parallel_result_t *result);
+
+/**
+ * @brief Освобождение дерева и арен результата.
+ */
+void parser_parallel_result_free(parser_parallel_result_t *result);
+
+#endif // PARSER_PARALLEL_H
@@ -0,0 +1,27 @@
+#ifndef PARSER_SELECT_H
+#define PARSER_SELECT_H
+
+#include <stdbool.h>
+#include "ast.h"
+#include "token_stream.h"
+
+/**
+ * @file parser_select.h
+ * @brief Части оператора SELECT, которые разбирают разные модули каталога select/.
+ *
+ * Оператор SELECT регистрирует один модуль (select/simple.c); соединения таблиц
+ * разбирает select/join.c по его вызову.
+ */
+
+/**
+ * @brief Соединение [INNER | LEFT [OUTER]] JOIN таблица [AS псевдоним] ON условие.
+ *
+ * Вызывается, когда текущий токен — INNER, LEFT или JOIN. Узел AST_JOIN (atom —
+ * таблица, string_value — вид соединения, потомок — условие ON) добавляется
+ * потомком select_node.
+ *
+ * @return false при ошибке (сообщение — через report_error()).
+ */
+bool parse_select_join(TokenStream *ts, ASTNode *select_node);
+
+#endif // PARSER_SELECT_H
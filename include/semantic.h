@@ -1,34 +1,175 @@
 #ifndef SEMANTIC_H
 #define SEMANTIC_H
 
+#include <stdbool.h>
 #include "ast.h"
-
-// Тип для описания типа данных
-typedef struct TypeInfo {
-    char *name;              // Имя типа (например, INT, STRING)
-    struct TypeInfo *base;   // Для пользовательских типов — базовый тип
-    // Дополнительные атрибуты типа
-} TypeInfo;
-
-// Структура таблицы символов для области видимости
-typedef struct SymbolTable {
-    char **names;           // Имена символов
-    TypeInfo **types;       // Типы символов
-    int count;              // Количество символов
-    struct SymbolTable *parent; // Родительская область видимости
-} SymbolTable;
+#include "atom.h"
+#include "diagnostics.h"
+#include "symbol_table.h"
+#include "thread_pool.h"
+#include "type_layout.h"
 
 // Инициализация глобальной таблицы символов
 void semantic_init();
 
-// Запуск семантического анализа AST
+// Запуск семантического анализа AST (последовательно; сообщения печатаются в stderr).
+// Возвращает 1, если ошибок нет.
 int semantic_check(ASTNode *root);
 
-// Добавление символа в текущую область видимости
-int symbol_table_add(SymbolTable *table, const char *name, TypeInfo *type);
+// Зависимость участка от глобального имени
+typedef struct {
+    atom_t name;                // Глобальное имя (в том числе не найденное)
+    atom_t component;           // Компонент класса или интерфейса (lcl=>meth, if~meth, ref->meth) или ATOM_NONE
+    uint64_t fingerprint;       // Отпечаток имени при анализе (semantic_fingerprint())
+} semantic_dep_t;
+
+// Зависимости одного участка
+typedef struct {
+    semantic_dep_t *items;
+    int count;
+    int capacity;
+    bool failed;                // Нехватка памяти при записи
+} semantic_deps_t;
+
+// Сведения об участке для повторного анализа
+typedef struct {
+    uint64_t identity;          // Процедура: вид, класс и имя; код вне процедур — хеш операторов
+    uint64_t body;              // Хеш поддерева участка
+    semantic_deps_t deps;       // Отсортированные зависимости с отпечатками
+    int diag_first;             // Сообщения участка: diagnostics.items[diag_first, + diag_count)
+    int diag_count;
+    bool reused;                // Взят из предыдущего анализа без проверки (semantic_reanalyze())
+} semantic_unit_summary_t;
+
+// Результат семантического анализа программы
+typedef struct {
+    symbol_frozen_t globals;    // Глобальные символы программы (внешняя таблица — builtins)
+    symbol_frozen_t builtins;   // Встроенные типы и предопределённые объекты (внешняя — DDIC)
+    type_cache_t types;         // Раскладки типов, понадобившиеся при анализе
+    diag_list_t diagnostics;    // Сообщения в порядке исходного текста
+    semantic_unit_summary_t *units; // Участки в порядке исходного текста
+    int unit_count;
+    int rechecked;              // Сколько участков проверено (остальные взяты из предыдущего анализа)
+} semantic_result_t;
+
+// Семантический анализ в две фазы. Первая (последовательная) собирает объявления
+// верхнего уровня и имена процедур и замораживает их в result->globals. Вторая
+// проверяет тела FORM, METHOD, FUNCTION и MODULE и код вне процедур на пуле потоков:
+// глобальные таблицы только читаются, локальные символы живут в таблице своего потока.
+// Сообщения каждой процедуры собираются отдельно и сливаются в исходном порядке,
+// поэтому результат не зависит от числа потоков.
+//
+// ddic — замороженные символы DDIC и пулов классов (может быть NULL), pool — пул
+// потоков (NULL — проверка в вызывающем потоке). Возвращает false при нехватке памяти.
+bool semantic_analyze(ASTNode *root, const symbol_frozen_t *ddic, thread_pool_t *pool,
+                      semantic_result_t *result);
+
+// Повторный анализ после правки. Первая фаза выполняется заново; участок второй фазы
+// проверяется, только если он новый, его поддерево изменилось или изменился отпечаток
+// одного из глобальных имён, которые он искал в previous. Остальные участки берут
+// сообщения из previous. previous не изменяется; его дерево может быть уже освобождено.
+bool semantic_reanalyze(ASTNode *root, const symbol_frozen_t *ddic, thread_pool_t *pool,
+                        const semantic_result_t *previous, semantic_result_t *result);
+
+// Освобождение результата semantic_analyze()
+void semantic_result_free(semantic_result_t *result);
+
+// Контекст проверки одной процедуры или участка кода вне процедур (один поток)
+typedef struct {
+    symbol_table_t *symbols;        // Таблица потока: локальные области поверх globals
+    diag_list_t *diagnostics;       // Сообщения участка
+    const ASTNode *procedure;       // Проверяемая процедура или NULL для кода вне процедур
+    bool resolve_names;             // Сообщать о необъявленных именах (не в METHOD: параметры
+                                    // и атрибуты объявлены в CLASS ... DEFINITION)
+    type_cache_t *types;            // Общий кэш раскладок
+    semantic_deps_t *deps;          // Зависимости участка (NULL — не записывать)
+    bool failed;                    // Нехватка памяти
+} semantic_context_t;
+
+// Поиск объявления имени; у составного имени (struct-comp, ref->attr, class=>attr)
+// ищется первая часть. NULL, если имя не объявлено. Глобальное или не найденное имя
+// записывается в зависимости участка.
+const symbol_t *semantic_resolve(const semantic_context_t *context, atom_t name);
+
+// Проверки типов (type_checker.c)
+
+// TYPE в объявлении ссылается на тип, LIKE — на объект данных
+void type_check_declaration(semantic_context_t *context, const ASTNode *declaration);
+
+// Цель присваивания — изменяемый объект данных, операнды — объекты данных
+void type_check_assignment(semantic_context_t *context, const ASTNode *assignment);
+
+// Операнд выражения (AST_IDENTIFIER) — объявленный объект данных
+void type_check_operand(semantic_context_t *context, const ASTNode *operand);
+
+// Раскладка типов (type_layout.c)
+
+// Раскладка объявления TYPES/DATA/CONSTANTS/PARAMETERS проверяемого участка. Вычисляется
+// при первом обращении вместе с типами, на которые оно ссылается, и запоминается в
+// context->types; цикл в определении даёт type_cyclic, неизвестное имя — type_unknown.
+const TypeInfo *type_resolve_decl(semantic_context_t *context, const ASTNode *decl);
+
+// Раскладка типа символа (TYPES, встроенный тип, DDIC) или объекта данных
+const TypeInfo *type_resolve_symbol(semantic_context_t *context, const symbol_t *symbol);
+
+// Зависимости (semantic_deps.c)
+
+// Начальное значение хешей semantic_tree_hash() и semantic_statements_hash()
+#define SEMANTIC_HASH_SEED      0xcbf29ce484222325ull
+
+// Хеш формы поддерева: виды узлов, атомы, строковые значения
+uint64_t semantic_tree_hash(const ASTNode *node);
+
+// Шаги хешей для проходов, которые хешируют поддеревья в общем обходе с другими
+// визиторами (ast_visit_fused()): узел поддерева в прямом порядке и хеш очередного
+// оператора последовательности. Свёртки шагов от SEMANTIC_HASH_SEED совпадают с
+// semantic_tree_hash() и semantic_statements_hash()
+uint64_t semantic_tree_hash_add(uint64_t hash, const ASTNode *node);
+uint64_t semantic_statements_hash_add(uint64_t hash, uint64_t statement);
+
+// Хеш содержимого раскладки (вид, размеры, компоненты со смещениями), не зависящий от адресов
+uint64_t semantic_type_hash(const TypeInfo *type);
+
+// Хеш последовательности операторов (код вне процедур)
+uint64_t semantic_statements_hash(ASTNode *const *statements, int count);
+
+// Тождество процедуры между анализами: вид, класс (для METHOD) и имя
+uint64_t semantic_procedure_identity(const ASTNode *procedure, atom_t class_name);
+
+// Запись зависимости участка от глобального имени или компонента класса
+void semantic_depend(const semantic_context_t *context, atom_t name, atom_t component);
+
+// Сортировка зависимостей и удаление повторов
+void semantic_deps_finish(semantic_deps_t *deps);
+
+void semantic_deps_free(semantic_deps_t *deps);
+
+// Вычисленный отпечаток
+typedef struct {
+    uint64_t key;                       // name << 32 | component; 0 — пустой слот
+    uint64_t fingerprint;
+} semantic_print_entry_t;
+
+// Отпечатки глобальных имён программы (с памятью уже вычисленных)
+typedef struct {
+    const symbol_frozen_t *globals;     // Глобальные символы программы
+    const atom_t *duplicates;           // Повторно объявленные глобальные имена (отсортированы)
+    int duplicate_count;
+    semantic_print_entry_t *entries;    // Хеш вычисленных отпечатков
+    size_t capacity;
+    size_t count;
+} semantic_fingerprints_t;
+
+// duplicates сортируется на месте и должен жить дольше prints
+void semantic_fingerprints_init(semantic_fingerprints_t *prints, const symbol_frozen_t *globals,
+                                atom_t *duplicates, int duplicate_count);
+void semantic_fingerprints_free(semantic_fingerprints_t *prints);
 
-// Поиск символа в области видимости и родительских областях
-TypeInfo *symbol_table_lookup(SymbolTable *table, const char *name);
+// Отпечаток имени (component — компонент класса или ATOM_NONE): вид символа, число
+// повторных объявлений, форма объявления и отпечатки типов, на которые оно ссылается.
+// Имена хешируются текстом, раскладки DDIC — содержимым: отпечаток не зависит от
+// номеров атомов и адресов процесса
+uint64_t semantic_fingerprint(semantic_fingerprints_t *prints, atom_t name, atom_t component);
 
 // Очистка и освобождение таблиц символов
 void semantic_cleanup();
@@ -0,0 +1,72 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file source_buffer.h
+ * @brief Буфер исходного текста, отображённый в память (mmap).
+ *
+ * Лексер не копирует лексемы: токены ссылаются на диапазоны (offset, length)
+ * внутри этого буфера. Поэтому буфер должен жить дольше всех токенов,
+ * полученных из него, и закрывается только после завершения разбора.
+ */
+
+/**
+ * @struct source_buffer_t
+ * @brief Исходный текст программы, доступный только для чтения.
+ *
+ * Данные НЕ завершаются нулевым символом — границу задаёт поле length.
+ */
+typedef struct {
+    const char *data;   // Начало исходного текста
+    size_t length;      // Длина текста в байтах
+    bool mapped;        // true — данные получены через mmap, false — из кучи/чужой памяти
+    bool owned;         // true — буфер должен быть освобождён в source_buffer_close()
+} source_buffer_t;
+
+/**
+ * @struct source_edit_t
+ * @brief Правка текста: removed байт с позиции offset заменены inserted байтами.
+ *
+ * Смещения заданы в координатах текста до правки; вставленный текст лежит
+ * в тексте после правки с той же позиции offset.
+ */
+typedef struct {
+    size_t offset;      // Начало правки
+    size_t removed;     // Сколько байт удалено
+    size_t inserted;    // Сколько байт вставлено
+} source_edit_t;
+
+/**
+ * @brief Открывает файл и отображает его содержимое в память.
+ *
+ * Для пустых и нерегулярных файлов (каналы, устройства) используется
+ * чтение в кучу, т.к. mmap для них невозможен.
+ *
+ * @param buffer Буфер для инициализации.
+ * @param path Путь к исходному файлу ABAP.
+ * @return true при успехе, false при ошибке (сообщение выводится в stderr).
+ */
+bool source_buffer_open(source_buffer_t *buffer, const char *path);
+
+/**
+ * @brief Оборачивает уже загруженный текст без копирования.
+ *
+ * Память остаётся во владении вызывающего кода.
+ *
+ * @param buffer Буфер для инициализации.
+ * @param data Исходный текст.
+ * @param length Длина текста в байтах.
+ */
+void source_buffer_from_memory(source_buffer_t *buffer, const char *data, size_t length);
+
+/**
+ * @brief Освобождает буфер (munmap или free). Все токены-срезы становятся недействительными.
+ *
+ * @param buffer Буфер исходного текста.
+ */
+void source_buffer_close(source_buffer_t *buffer);
+
+#endif // SOURCE_BUFFER_H
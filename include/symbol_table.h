@@ -0,0 +1,170 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ast.h"
+#include "atom.h"
+
+/**
+ * @file symbol_table.h
+ * @brief Таблица символов: хеш с открытой адресацией по атому имени и области
+ *        видимости в виде журнала отката.
+ *
+ * Таблица хранит для каждого имени только видимое сейчас объявление, поэтому поиск —
+ * одна проба хеша, а не проход по цепочке областей. Объявления лежат стеком; каждое
+ * помнит объявление, которое оно скрыло (shadowed). Выход из области (METHOD, FORM,
+ * LOOP, ...) проходит только по объявлениям этой области и восстанавливает скрытые —
+ * стоимость пропорциональна числу изменений, а не размеру таблицы.
+ *
+ * Глобальные символы (DDIC, пулы классов) собираются в обычной таблице и
+ * замораживаются в symbol_frozen_t — компактную таблицу только для чтения, которую
+ * могут одновременно читать несколько потоков без блокировок. Таблица с областями
+ * ссылается на замороженную и ищет в ней имена, не объявленные локально.
+ */
+
+struct TypeInfo;
+
+/// Вид символа
+typedef enum {
+    SYMBOL_VARIABLE,        ///< DATA, STATICS
+    SYMBOL_CONSTANT,        ///< CONSTANTS
+    SYMBOL_PARAMETER,       ///< Параметр METHOD/FORM, PARAMETERS
+    SYMBOL_FIELD_SYMBOL,    ///< FIELD-SYMBOLS
+    SYMBOL_TYPE,            ///< TYPES, тип DDIC
+    SYMBOL_TABLE,           ///< Таблица базы данных (TABLES, DDIC)
+    SYMBOL_FORM,            ///< FORM
+    SYMBOL_FUNCTION,        ///< FUNCTION (функциональный модуль)
+    SYMBOL_MODULE,          ///< MODULE (модуль диалога)
+    SYMBOL_METHOD,          ///< METHOD
+    SYMBOL_ATTRIBUTE,       ///< Атрибут класса
+    SYMBOL_CLASS,           ///< CLASS
+    SYMBOL_INTERFACE        ///< INTERFACE
+} symbol_kind_t;
+
+/**
+ * @struct symbol_t
+ * @brief Объявление имени.
+ */
+typedef struct {
+    atom_t name;            ///< Имя (атом)
+    symbol_kind_t kind;     ///< Вид символа
+    int scope;              ///< Глубина области объявления (0 — внешняя)
+    int shadowed;           ///< Объявление того же имени, скрытое этим (-1 — нет)
+    struct TypeInfo *type;  ///< Тип (может быть NULL)
+    const ASTNode *decl;    ///< Узел объявления (может быть NULL)
+    uint64_t source_hash;   ///< Хеш объявления вне программы (сводка класса, class_summary.h); 0 — нет
+} symbol_t;
+
+/// Слот хеша: имя и индекс его видимого объявления
+typedef struct {
+    atom_t name;            ///< ATOM_NONE — пустой слот
+    int symbol;             ///< Индекс в symbols
+} symbol_slot_t;
+
+/**
+ * @struct symbol_frozen_t
+ * @brief Замороженная таблица только для чтения (глобальные символы).
+ *
+ * После symbol_table_freeze() не изменяется, поэтому поиск безопасен из любого
+ * числа потоков одновременно. Таблицы образуют цепочку: имя, не найденное в
+ * таблице, ищется во внешней (глобальные символы программы -> DDIC).
+ */
+typedef struct symbol_frozen {
+    symbol_t *symbols;      ///< Символы в порядке объявления
+    int count;              ///< Количество символов
+    symbol_slot_t *slots;   ///< Хеш (заполнен не более чем наполовину)
+    uint32_t shift;         ///< 32 - log2(числа слотов)
+    const struct symbol_frozen *outer; ///< Внешняя таблица (globals исходной таблицы) или NULL
+} symbol_frozen_t;
+
+/**
+ * @struct symbol_table_t
+ * @brief Таблица с областями видимости (один поток анализа).
+ */
+typedef struct {
+    symbol_t *symbols;              ///< Стек объявлений всех открытых областей
+    int count;                      ///< Количество объявлений
+    int capacity;                   ///< Вместимость symbols
+    symbol_slot_t *slots;           ///< Хеш видимых имён
+    uint32_t shift;                 ///< 32 - log2(числа слотов)
+    int used;                       ///< Занятых слотов
+    int *scopes;                    ///< Начало каждой открытой области в symbols
+    int depth;                      ///< Число открытых областей сверх внешней
+    int scope_capacity;             ///< Вместимость scopes
+    const symbol_frozen_t *globals; ///< Глобальные символы (может быть NULL)
+} symbol_table_t;
+
+/**
+ * @brief Инициализация пустой таблицы с внешней областью (глубина 0).
+ *
+ * @param globals Замороженные глобальные символы или NULL; должны жить дольше таблицы.
+ */
+void symbol_table_init(symbol_table_t *table, const symbol_frozen_t *globals);
+
+/**
+ * @brief Освобождение таблицы (globals не затрагиваются).
+ */
+void symbol_table_free(symbol_table_t *table);
+
+/**
+ * @brief Открывает вложенную область.
+ *
+ * @return false при нехватке памяти.
+ */
+bool symbol_table_push(symbol_table_t *table);
+
+/**
+ * @brief Закрывает текущую область: её объявления удаляются, скрытые ими — снова видимы.
+ *
+ * Внешняя область не закрывается.
+ */
+void symbol_table_pop(symbol_table_t *table);
+
+/**
+ * @brief Объявляет имя в текущей области.
+ *
+ * Объявление во вложенной области скрывает внешнее (и глобальное) до закрытия области.
+ * Повторное объявление в той же области не добавляется: возвращается существующее.
+ * Указатель действителен до следующего объявления.
+ *
+ * @param added Устанавливается в true, если символ добавлен (может быть NULL).
+ * @return Символ текущей области с этим именем; NULL при нехватке памяти.
+ */
+symbol_t *symbol_table_declare(symbol_table_t *table, atom_t name, symbol_kind_t kind,
+                               struct TypeInfo *type, const ASTNode *decl, bool *added);
+
+/**
+ * @brief Поиск видимого объявления: сначала открытые области, затем globals.
+ *
+ * @return Символ или NULL, если имя не объявлено.
+ */
+const symbol_t *symbol_table_lookup(const symbol_table_t *table, atom_t name);
+
+/**
+ * @brief Поиск только в текущей области (проверка повторного объявления).
+ */
+const symbol_t *symbol_table_lookup_local(const symbol_table_t *table, atom_t name);
+
+/**
+ * @brief Заморозка видимых символов таблицы в компактную таблицу только для чтения.
+ *
+ * Копируются видимые объявления в порядке объявления; сама таблица не меняется.
+ * globals таблицы становится внешней таблицей результата и должна жить дольше него.
+ *
+ * @return false при нехватке памяти.
+ */
+bool symbol_table_freeze(const symbol_table_t *table, symbol_frozen_t *frozen);
+
+/**
+ * @brief Поиск в замороженной таблице и её внешних (без блокировок, из любого потока).
+ */
+const symbol_t *symbol_frozen_lookup(const symbol_frozen_t *frozen, atom_t name);
+
+/**
+ * @brief Освобождение замороженной таблицы.
+ */
+void symbol_frozen_free(symbol_frozen_t *frozen);
+
+#endif // SYMBOL_TABLE_H
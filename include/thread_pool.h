@@ -0,0 +1,59 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stddef.h>
+
+/**
+ * @file thread_pool.h
+ * @brief Пул рабочих потоков компилятора для параллельных проходов (лексер, парсер, семантика).
+ *
+ * Пул выполняет «параллельный цикл»: задачу с номерами 0..count-1 разбирают
+ * рабочие потоки и вызывающий поток. Потоки создаются один раз и ждут
+ * следующей задачи, поэтому запуск прохода не стоит создания потоков.
+ */
+
+typedef struct thread_pool thread_pool_t;
+
+/**
+ * @brief Тело параллельного цикла.
+ *
+ * @param arg Общий аргумент задачи.
+ * @param index Номер элемента (0..count-1).
+ * @param worker Номер потока, выполняющего элемент (0 — вызывающий поток),
+ *               для доступа к данным конкретного потока без блокировок.
+ */
+typedef void (*thread_pool_fn)(void *arg, size_t index, int worker);
+
+/**
+ * @brief Количество потоков по умолчанию — число доступных процессоров.
+ */
+int thread_pool_default_threads(void);
+
+/**
+ * @brief Создание пула.
+ *
+ * @param threads Общее число потоков, включая вызывающий; 0 — thread_pool_default_threads().
+ * @return Пул или NULL при ошибке.
+ */
+thread_pool_t *thread_pool_create(int threads);
+
+/**
+ * @brief Число потоков пула (включая вызывающий).
+ */
+int thread_pool_size(const thread_pool_t *pool);
+
+/**
+ * @brief Выполняет fn для всех index из [0, count) и возвращается, когда все элементы готовы.
+ *
+ * Элементы раздаются по одному через атомарный счётчик, поэтому неравные по
+ * стоимости элементы балансируются автоматически. Вызовы одного пула из разных
+ * потоков одновременно не допускаются.
+ */
+void thread_pool_run(thread_pool_t *pool, size_t count, thread_pool_fn fn, void *arg);
+
+/**
+ * @brief Остановка потоков и освобождение пула.
+ */
+void thread_pool_destroy(thread_pool_t *pool);
+
+#endif // THREAD_POOL_H
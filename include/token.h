@@ -2,6 +2,7 @@
 #define TOKEN_H
 
 #include <stdint.h>
+#include "atom.h"
 
 typedef enum {
     // Специальные и служебные токены
@@ -63,12 +64,76 @@ typedef enum {
     TOKEN_KEYWORD_WHILE,
     TOKEN_KEYWORD_WITH,
 
+    // Ключевые слова, которые используют модули парсера
+    TOKEN_KEYWORD_ATTRIBUTES,
+    TOKEN_KEYWORD_AUTHORITY_CHECK,
+    TOKEN_KEYWORD_BEGIN,
+    TOKEN_KEYWORD_BETWEEN,
+    TOKEN_KEYWORD_BY,
+    TOKEN_KEYWORD_CATCH,
+    TOKEN_KEYWORD_CHANGING,
+    TOKEN_KEYWORD_CLEANUP,
+    TOKEN_KEYWORD_CREATE,
+    TOKEN_KEYWORD_DEFAULT,
+    TOKEN_KEYWORD_DEFINITION,
+    TOKEN_KEYWORD_END,
+    TOKEN_KEYWORD_ENDCASE,
+    TOKEN_KEYWORD_ENDDO,
+    TOKEN_KEYWORD_ENDFORM,
+    TOKEN_KEYWORD_ENDFUNCTION,
+    TOKEN_KEYWORD_ENDINTERFACE,
+    TOKEN_KEYWORD_ENDMETHOD,
+    TOKEN_KEYWORD_ENDMODULE,
+    TOKEN_KEYWORD_ENDSELECT,
+    TOKEN_KEYWORD_EXCEPTIONS,
+    TOKEN_KEYWORD_EXPORTING,
+    TOKEN_KEYWORD_FALSE,
+    TOKEN_KEYWORD_FIELD_SYMBOLS,
+    TOKEN_KEYWORD_FROM,
+    TOKEN_KEYWORD_IMPLEMENTATION,
+    TOKEN_KEYWORD_IMPORTING,
+    TOKEN_KEYWORD_IN,
+    TOKEN_KEYWORD_INITIAL,
+    TOKEN_KEYWORD_INSERT,
+    TOKEN_KEYWORD_INTERFACES,
+    TOKEN_KEYWORD_INTO,
+    TOKEN_KEYWORD_IS,
+    TOKEN_KEYWORD_JOIN,
+    TOKEN_KEYWORD_KEY,
+    TOKEN_KEYWORD_LIKE,
+    TOKEN_KEYWORD_MESSAGE,
+    TOKEN_KEYWORD_METHOD,
+    TOKEN_KEYWORD_MODULE,
+    TOKEN_KEYWORD_OF,
+    TOKEN_KEYWORD_ON,
+    TOKEN_KEYWORD_PARAMETERS,
+    TOKEN_KEYWORD_PRIVATE,
+    TOKEN_KEYWORD_PROTECTED,
+    TOKEN_KEYWORD_PUBLIC,
+    TOKEN_KEYWORD_RAISING,
+    TOKEN_KEYWORD_RANGES,
+    TOKEN_KEYWORD_RETURNING,
+    TOKEN_KEYWORD_SECTION,
+    TOKEN_KEYWORD_SELECT_OPTIONS,
+    TOKEN_KEYWORD_TABLE,
+    TOKEN_KEYWORD_TABLES,
+    TOKEN_KEYWORD_TO,
+    TOKEN_KEYWORD_TRUE,
+    TOKEN_KEYWORD_TYPE,
+    TOKEN_KEYWORD_TYPES,
+    TOKEN_KEYWORD_USING,
+    TOKEN_KEYWORD_VALUE,
+    TOKEN_KEYWORD_WHEN,
+    TOKEN_KEYWORD_WHERE,
+    TOKEN_KEYWORD_WRITE,
+
     // Литералы
     TOKEN_LITERAL_STRING,      // Строковый литерал (например 'текст')
     TOKEN_LITERAL_NUM_INT,     // Целочисленный литерал
     TOKEN_LITERAL_NUM_FLOAT,   // Вещественный литерал
     TOKEN_LITERAL_NUM_HEX,     // Шестнадцатеричный литерал
     TOKEN_LITERAL_CHAR,        // Символьный литерал
+    TOKEN_LITERAL_TEMPLATE,    // Шаблон строки (например |Итого: { sum }|), срез — весь шаблон с чертами
 
     // Идентификаторы (имена переменных, функций, классов и т.п.)
     TOKEN_IDENTIFIER,
@@ -92,6 +157,7 @@ typedef enum {
     TOKEN_OPERATOR_AND,        // AND
     TOKEN_OPERATOR_OR,         // OR
     TOKEN_OPERATOR_NOT,        // NOT
+    TOKEN_OPERATOR_CONCAT,     // && (конкатенация строк)
 
     // Пунктуация и разделители
     TOKEN_PUNCTUATION_SEMICOLON,   // ;
@@ -113,26 +179,76 @@ typedef enum {
     TOKEN_NEWLINE,              // Перевод строки
     TOKEN_WHITESPACE,           // Пробелы, табуляции и т.п.
 
+    TOKEN_TYPE_COUNT            // Количество типов токенов (размер таблиц, индексируемых типом)
 } TokenType;
 
-// Структура токена — минимальной лексической единицы
+// Структура токена — минимальной лексической единицы.
+// Текст токена — срез исходного буфера: он НЕ завершается нулём и не принадлежит токену.
+// Для получения собственной C-строки используйте token_strdup().
 typedef struct Token {
     TokenType type;     // Тип токена
-    char *text;         // Текстовое содержимое токена (например, идентификатор или литерал)
+    const char *text;   // Начало лексемы в исходном буфере (например, идентификатор или литерал)
+    uint32_t length;    // Длина лексемы в байтах
     int line;           // Номер строки в исходном файле
     int column;         // Номер столбца (позиция в строке)
+    atom_t atom;        // Атом имени для TOKEN_IDENTIFIER (ATOM_NONE для остальных токенов)
 } Token;
 
 /**
- * Создает новый токен.
+ * Создает токен-срез без выделения памяти.
+ * @param type Тип токена.
+ * @param text Начало лексемы в исходном буфере.
+ * @param length Длина лексемы.
+ * @param line Номер строки исходного кода.
+ * @param column Номер столбца исходного кода.
+ * @return Токен по значению; действителен, пока жив исходный буфер.
+ */
+Token token_view(TokenType type, const char *text, uint32_t length, int line, int column);
+
+/**
+ * Создает новый токен в куче (для токенов, которых нет в исходном тексте).
  * @param type Тип токена.
- * @param text Текст токена (копируется внутри функции).
+ * @param text Текст токена, завершённый нулём (копируется внутри функции).
  * @param line Номер строки исходного кода.
  * @param column Номер столбца исходного кода.
  * @return Указатель на созданный токен. Необходимо освободить с помощью token_free().
  */
 Token *token_create(TokenType type, const char *text, int line, int column);
 
+/**
+ * Копирует лексему токена в новую C-строку.
+ * Используется только там, где модулю парсера нужна собственная строка.
+ * @param token Токен.
+ * @return Строка, которую нужно освободить free(), или NULL при нехватке памяти.
+ */
+char *token_strdup(const Token *token);
+
+/**
+ * Возвращает атом имени токена.
+ * Если лексер уже интернировал имя, атом берётся из токена, иначе имя интернируется сейчас.
+ * Модули парсера используют атом вместо token_strdup() для имён переменных, таблиц, полей и т.п.
+ * @param token Токен.
+ * @return Атом имени или ATOM_NONE для токена без текста.
+ */
+atom_t token_atom(const Token *token);
+
+/**
+ * Сравнивает лексему токена со строкой без учёта регистра (без выделения памяти).
+ * @param token Токен.
+ * @param text C-строка для сравнения.
+ * @return 1 если совпадает, иначе 0.
+ */
+int token_text_equals(const Token *token, const char *text);
+
+/**
+ * Проверяет, открывает или закрывает ли ключевое слово блок (FORM, ENDIF, CATCH, ...).
+ * Восстановление после ошибки разбора останавливается на таком слове в начале строки,
+ * даже если у ошибочного оператора нет точки.
+ * @param type Тип токена.
+ * @return 1 для слова границы блока, иначе 0.
+ */
+int token_is_block_boundary(TokenType type);
+
 /**
  * Создает копию переданного токена.
  * @param src Исходный токен для копирования.
@@ -143,7 +259,8 @@ Token *token_copy(const Token *src);
 void token_destroy(Token *token);
 
 /**
- * Освобождает память, выделенную под токен и его текст.
+ * Освобождает токен, созданный token_create()/token_copy().
+ * Токены-срезы, полученные от лексера, освобождать не нужно.
  * @param token Токен для освобождения.
  */
 void token_free(Token *token);
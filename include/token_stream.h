@@ -14,98 +14,270 @@
  * Он обеспечивает интерфейс для итерации, просмотра следующего токена и управления позицией в потоке.
  */
 
+#ifndef TOKEN_STREAM_H
+#define TOKEN_STREAM_H
+
+#include "token.h"
+#include "lexer.h"
+#include "source_buffer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
 /**
- * Структура потока токенов.
- * Хранит массив токенов, текущий индекс и количество токенов.
+ * @file token_stream.h
+ * @brief Интерфейс для работы с потоком токенов (Token Stream) на этапе синтаксического анализа.
+ *
+ * Модуль обеспечивает последовательный доступ к лексемам (токенам), а также поддерживает
+ * сохранение и восстановление позиции для реализации lookahead и откатов.
+ *
+ * Токены хранятся не массивом структур Token, а параллельными компактными массивами
+ * (struct-of-arrays): тип — 1 байт, смещение — 4 байта, длина — 2 байта.
+ * Просмотр вперёд (token_stream_peek_type(), token_stream_advance()) — это операции
+ * над индексом, читающие только массив типов; полный Token собирается только по запросу.
+ *
+ * Массивы токенов и таблица строк — буферы с разрывом (gap buffer): правка текста
+ * (token_stream_edit()) заменяет токены в месте разрыва, не сдвигая остальные.
+ */
+
+/// Ёмкость встроенного стека сохранённых позиций; глубже стек продолжается в куче
+#define TOKEN_STREAM_INLINE_MARKS 16
+
+/// Значение в массиве длин, означающее «длина не помещается в 16 бит» (см. long_lengths)
+#define TOKEN_STREAM_LONG_LENGTH UINT16_MAX
+
+/**
+ * @struct token_long_length_t
+ * @brief Длина лексемы, не помещающаяся в 16 бит (например, длинный строковый литерал).
+ */
+typedef struct {
+    int index;          ///< Индекс токена в потоке
+    uint32_t length;    ///< Полная длина лексемы
+} token_long_length_t;
+
+/**
+ * @struct token_chain_segment_t
+ * @brief Отрезок виртуальной последовательности токенов, ссылающийся на физические токены.
+ */
+typedef struct {
+    int virtual_start;  ///< Первый индекс отрезка, видимый парсеру
+    int physical_start; ///< Индекс первого токена отрезка в потоке лексера
+    int length;         ///< Число токенов
+    bool as_dot;        ///< Запятая цепочки, которую парсер видит как точку конца оператора
+} token_chain_segment_t;
+
+/**
+ * @struct token_chain_view_t
+ * @brief Раскрытые цепочечные операторы: таблица отрезков вместо копий токенов.
+ */
+typedef struct {
+    token_chain_segment_t *segments; ///< Отрезки по возрастанию virtual_start
+    int count;                       ///< Число отрезков
+    int capacity;                    ///< Вместимость segments
+    int virtual_count;               ///< Число токенов, видимых парсеру
+    int cursor;                      ///< Последний найденный отрезок (подсказка для поиска)
+} token_chain_view_t;
+
+/**
+ * @struct TokenStream
+ * @brief Поток токенов, полученных от лексера.
+ *
+ * Лексемы не копируются: offsets указывают в исходный буфер source, который
+ * должен жить дольше потока. Строка и колонка токена вычисляются по таблице
+ * переводов строк только при сборке полного Token.
+ *
+ * Свободная ёмкость массивов образует разрыв перед логическим индексом gap_start;
+ * элементы после него лежат в конце массивов, а их смещения хранятся от конца
+ * текста (source_length - offset). У потока, построенного лексером, разрыв в конце.
+ * Поэтому к массивам обращаются только через функции token_stream_*_at().
  */
 typedef struct TokenStream {
-    Token *tokens;       ///< Указатель на массив токенов
-    int token_count;     ///< Общее количество токенов в массиве
-    int current_index;   ///< Индекс текущего токена (для чтения)
+    const char *source;                    ///< Исходный текст, в который указывают смещения
+    size_t source_length;                  ///< Длина source
+    uint8_t *types;                        ///< Тип каждого токена (TokenType)
+    uint32_t *offsets;                     ///< Смещение лексемы в source
+    uint16_t *lengths;                     ///< Длина лексемы или TOKEN_STREAM_LONG_LENGTH
+    atom_t *atoms;                         ///< Атом имени для идентификаторов, иначе ATOM_NONE
+    token_long_length_t *long_lengths;     ///< Длины больше 16 бит, по возрастанию индекса
+    int long_count;                        ///< Количество элементов long_lengths
+    uint32_t *newlines;                    ///< Таблица строк: смещения всех '\n' в source
+    size_t newline_count;                  ///< Количество переводов строк
+    size_t newline_capacity;               ///< Вместимость таблицы строк
+    size_t newline_gap_start;              ///< Индекс разрыва таблицы строк
+    int token_count;                       ///< Общее количество токенов
+    int capacity;                          ///< Вместимость параллельных массивов
+    int gap_start;                         ///< Логический индекс разрыва массивов токенов
+    int current_index;                     ///< Индекс текущего токена
+    int inline_marks[TOKEN_STREAM_INLINE_MARKS]; ///< Встроенная часть стека сохранённых позиций
+    int *heap_marks;                       ///< Стек в куче после переполнения встроенного (или NULL)
+    int mark_capacity;                     ///< Ёмкость heap_marks
+    int saved_count;                       ///< Текущее количество сохранённых позиций
+    token_chain_view_t *chains;            ///< Раскрытие цепочечных операторов или NULL
 } TokenStream;
 
 /**
- * Инициализация потока токенов.
- * 
- * @param stream Указатель на TokenStream для инициализации.
- * @param tokens Массив токенов.
- * @param count Количество токенов в массиве.
+ * @brief Инициализация пустого потока над исходным текстом.
+ *
+ * @param stream Указатель на поток.
+ * @param source Исходный текст, в который будут указывать смещения токенов.
+ * @param length Длина исходного текста.
  */
-void token_stream_init(TokenStream *stream, Token *tokens, int count);
+void token_stream_init(TokenStream *stream, const char *source, size_t length);
 
 /**
- * Получить текущий токен без смещения индекса.
- * 
- * @param stream Указатель на поток токенов.
- * @return Текущий токен или токен типа TOKEN_EOF, если поток закончился.
+ * @brief Лексирует весь исходный текст лексера в поток.
+ *
+ * Таблица строк переходит от лексера к потоку (после вызова лексер её не содержит).
+ *
+ * @param stream Поток для инициализации.
+ * @param lexer Лексер, инициализированный lexer_init()/lexer_init_file().
+ * @return true при успехе, false при нехватке памяти.
  */
-Token token_stream_peek(TokenStream *stream);
+bool token_stream_from_lexer(TokenStream *stream, lexer_t *lexer);
 
 /**
- * Получить текущий токен и сдвинуть указатель на следующий.
- * 
- * @param stream Указатель на поток токенов.
- * @return Текущий токен перед сдвигом, или TOKEN_EOF если конец потока.
+ * @brief Добавление токена лексера в конец потока (TOKEN_EOF не сохраняется).
+ *
+ * @return true при успехе, false при нехватке памяти.
  */
-Token token_stream_next(TokenStream *stream);
+bool token_stream_push(TokenStream *stream, const token_t *token);
 
 /**
- * Проверить, достигнут ли конец потока токенов.
- * 
- * @param stream Указатель на поток токенов.
- * @return true если достигнут конец, иначе false.
+ * @brief Дописывает в конец потока токены chunk, лексированного отдельно.
+ *
+ * Смещения токенов и таблица строк chunk отсчитываются от начала его фрагмента;
+ * при копировании к ним прибавляется base — смещение фрагмента в source потока.
+ * chunk — поток, построенный лексером и не правленый token_stream_edit(); он не
+ * изменяется и освобождается вызывающим.
+ *
+ * @return true при успехе, false при нехватке памяти.
  */
-bool token_stream_is_end(TokenStream *stream);
+bool token_stream_append(TokenStream *stream, const TokenStream *chunk, uint32_t base);
 
 /**
- * Сбросить указатель потока токенов на начало.
- * 
- * @param stream Указатель на поток токенов.
+ * @brief Отбрасывает токены начиная с индекса count и переводы строк начиная со смещения source_end.
  */
-void token_stream_reset(TokenStream *stream);
+void token_stream_truncate(TokenStream *stream, int count, size_t source_end);
 
-#endif // TOKEN_STREAM_H
-*/
+/**
+ * @brief Замена токенов после правки исходного текста.
+ *
+ * Токены [first, first + removed) заменяются токенами replacement, таблица строк
+ * исправляется по правке edit, поток переходит на новый текст source. Токены до first
+ * должны лежать целиком до edit->offset, а токены после заменяемого диапазона — после
+ * удалённого текста: их смещения сдвигаются на разницу длин без перебора.
+ * Стоимость пропорциональна размеру замены и расстоянию от предыдущей правки.
+ * Позиция чтения и сохранённые позиции сбрасываются.
+ *
+ * @param stream Поток над текстом до правки.
+ * @param source Текст после правки.
+ * @param length Длина текста после правки.
+ * @param edit Правка в координатах текста до правки.
+ * @param first Индекс первого заменяемого токена.
+ * @param removed Количество заменяемых токенов.
+ * @param replacement Новые токены (поток, построенный push над source; смещения — в source).
+ * @return true при успехе, false при ошибке (поток не изменяется).
+ */
+bool token_stream_edit(TokenStream *stream, const char *source, size_t length,
+                       const source_edit_t *edit, int first, int removed,
+                       const TokenStream *replacement);
 
-#ifndef TOKEN_STREAM_H
-#define TOKEN_STREAM_H
+/**
+ * @brief Раскрытие цепочечных операторов ABAP в виртуальные операторы.
+ *
+ * После вызова парсер видит `DATA: a TYPE i, b TYPE c.` как `DATA a TYPE i. DATA b TYPE c.`,
+ * а `WRITE: / x, y.` — как `WRITE / x. WRITE y.`: все функции чтения по индексу работают
+ * с виртуальной последовательностью. Префикс цепочки не копируется — виртуальные
+ * операторы ссылаются на отрезки физических токенов; двоеточие пропускается, запятая
+ * верхнего уровня (вне скобок) видна как TOKEN_PUNCTUATION_DOT. Память — O(число
+ * элементов цепочек), а не O(длина префикса × число элементов).
+ *
+ * Позиция чтения сбрасывается. Добавление токенов и правки отключают раскрытие.
+ *
+ * @return true при успехе, false при нехватке памяти (поток остаётся без раскрытия).
+ */
+bool token_stream_expand_chains(TokenStream *stream);
 
-#include "token.h"
-#include <stdbool.h>
+/**
+ * @brief Отключение раскрытия цепочек; индексы снова совпадают с индексами лексера.
+ */
+void token_stream_clear_chains(TokenStream *stream);
 
 /**
- * @file token_stream.h
- * @brief Интерфейс для работы с потоком токенов (Token Stream) на этапе синтаксического анализа.
+ * @brief Индекс токена в последовательности лексера для индекса, видимого парсеру (-1 вне потока).
  *
- * Модуль обеспечивает последовательный доступ к лексемам (токенам), а также поддерживает
- * сохранение и восстановление позиции для реализации lookahead и откатов.
+ * Несколько виртуальных токенов (префикс цепочки) могут ссылаться на один физический.
  */
+int token_stream_physical_index(const TokenStream *stream, int index);
 
-/// Максимальное количество сохраняемых позиций (для lookahead и бэктрекинга)
-#define MAX_SAVED_POSITIONS 16
+/**
+ * @brief Освобождение массивов потока (исходный текст не затрагивается).
+ */
+void token_stream_free(TokenStream *stream);
 
 /**
- * @struct TokenStream
- * @brief Поток токенов, полученных от лексера.
+ * @brief Независимый курсор чтения над токенами stream (для параллельного разбора).
+ *
+ * Массивы токенов, таблица строк и отрезки цепочек общие и только читаются; позиция
+ * и стек сохранённых позиций у курсора свои. stream не должен изменяться,
+ * пока курсор используется.
  *
- * Структура содержит массив токенов, текущую позицию чтения, а также стек сохранённых позиций.
+ * @param cursor Курсор для инициализации.
+ * @param stream Исходный поток.
+ * @param index Начальная позиция курсора.
+ * @return true при успехе, false при нехватке памяти.
  */
-typedef struct TokenStream {
-    Token *tokens;                         ///< Указатель на массив токенов
-    int token_count;                       ///< Общее количество токенов в массиве
-    int current_index;                     ///< Индекс текущего токена
-    int saved_positions[MAX_SAVED_POSITIONS]; ///< Стек сохранённых позиций
-    int saved_count;                       ///< Текущее количество сохранённых позиций
-} TokenStream;
+bool token_stream_cursor_init(TokenStream *cursor, const TokenStream *stream, int index);
 
 /**
- * @brief Инициализация потока токенов.
+ * @brief Освобождение собственных данных курсора (общие массивы не затрагиваются).
+ */
+void token_stream_cursor_free(TokenStream *cursor);
+
+/**
+ * @brief Тип текущего токена — читает только массив типов.
  *
- * @param stream Указатель на поток.
- * @param tokens Указатель на массив токенов.
- * @param count Количество токенов в массиве.
+ * @return Тип токена или TOKEN_EOF, если достигнут конец потока.
+ */
+TokenType token_stream_peek_type(const TokenStream *stream);
+
+/**
+ * @brief Тип токена на offset позиций впереди текущего (0 — текущий).
  */
-void token_stream_init(TokenStream *stream, Token *tokens, int count);
+TokenType token_stream_peek_type_at(const TokenStream *stream, int offset);
+
+/**
+ * @brief Сдвиг на следующий токен.
+ *
+ * @return Индекс токена, который был текущим, или -1, если поток закончился.
+ */
+int token_stream_advance(TokenStream *stream);
+
+/**
+ * @brief Тип токена по индексу (TOKEN_EOF вне диапазона).
+ */
+TokenType token_stream_type_at(const TokenStream *stream, int index);
+
+/**
+ * @brief Длина лексемы токена по индексу.
+ */
+uint32_t token_stream_length_at(const TokenStream *stream, int index);
+
+/**
+ * @brief Смещение лексемы токена по индексу в исходном тексте (0 для индекса вне потока).
+ */
+uint32_t token_stream_offset_at(const TokenStream *stream, int index);
+
+/**
+ * @brief Атом имени токена по индексу (ATOM_NONE, если токен не идентификатор).
+ */
+atom_t token_stream_atom_at(const TokenStream *stream, int index);
+
+/**
+ * @brief Сборка полного токена-среза по индексу (со строкой и колонкой).
+ *
+ * @return Токен или TOKEN_EOF вне диапазона.
+ */
+Token token_stream_token_at(const TokenStream *stream, int index);
 
 /**
  * @brief Просмотр текущего токена без смещения позиции.
@@ -142,6 +314,8 @@ void token_stream_reset(TokenStream *stream);
  * @brief Сохранение текущей позиции в стек.
  *
  * Используется для реализации lookahead и альтернативного парсинга.
+ * Глубина не ограничена: первые TOKEN_STREAM_INLINE_MARKS позиций хранятся
+ * в самой структуре, дальше стек растёт в куче.
  *
  * @param stream Поток токенов.
  */
@@ -161,4 +335,14 @@ void token_stream_restore(TokenStream *stream);
  */
 void token_stream_discard(TokenStream *stream);
 
+/**
+ * @brief Текущая позиция как метка для отката без стека (метка хранится у вызывающего).
+ */
+int token_stream_mark(const TokenStream *stream);
+
+/**
+ * @brief Возврат к метке, полученной token_stream_mark().
+ */
+void token_stream_rewind(TokenStream *stream, int mark);
+
 #endif // TOKEN_STREAM_H
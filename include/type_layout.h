@@ -0,0 +1,168 @@
+#ifndef TYPE_LAYOUT_H
+#define TYPE_LAYOUT_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ast.h"
+#include "atom.h"
+
+/**
+ * @file type_layout.h
+ * @brief Раскладка типов данных (размер, выравнивание, смещения компонентов) и её
+ *        общий кэш.
+ *
+ * Раскладка объявления TYPES/DATA вычисляется при первом обращении к нему
+ * (type_resolve_symbol() в semantic.h) и запоминается в type_cache_t по узлу
+ * объявления: тип, на который никто не ссылается, не разбирается вовсе, а
+ * используемый — один раз, сколько бы объявлений на него ни ссылалось. Кэш общий
+ * для потоков фазы проверки; готовая раскладка не изменяется.
+ */
+
+/// Вид типа
+typedef enum {
+    TYPE_KIND_ELEMENTARY,   ///< Встроенный тип (C, I, STRING, ...)
+    TYPE_KIND_STRUCTURE,    ///< TYPES BEGIN OF ... END OF
+    TYPE_KIND_TABLE,        ///< Табличный тип (TABLE OF, RANGE OF, DDIC)
+    TYPE_KIND_REFERENCE,    ///< Ссылка (REF TO, DDIC)
+    TYPE_KIND_INVALID       ///< Раскладку вычислить нельзя
+} type_kind_t;
+
+/// Встроенный элементарный тип
+typedef enum {
+    TYPE_C, TYPE_N, TYPE_D, TYPE_T, TYPE_X, TYPE_P,
+    TYPE_I, TYPE_INT1, TYPE_INT2, TYPE_INT8, TYPE_F,
+    TYPE_DECFLOAT16, TYPE_DECFLOAT34, TYPE_UTCLONG,
+    TYPE_STRING, TYPE_XSTRING
+} type_elementary_t;
+
+struct TypeInfo;
+
+/// Компонент структуры
+typedef struct {
+    atom_t name;                    ///< Имя компонента
+    size_t offset;                  ///< Смещение от начала структуры
+    const struct TypeInfo *type;    ///< Тип компонента
+} type_component_t;
+
+/**
+ * @struct TypeInfo
+ * @brief Тип данных с вычисленной раскладкой.
+ */
+typedef struct TypeInfo {
+    atom_t name;                        ///< Имя объявления (ATOM_NONE — встроенный или безымянный)
+    type_kind_t kind;                   ///< Вид типа
+    type_elementary_t elementary;       ///< Встроенный тип (TYPE_KIND_ELEMENTARY)
+    unsigned length;                    ///< Длина: символы для C/N/D/T, байты для X/P
+    unsigned decimals;                  ///< Знаков после запятой (P)
+    size_t size;                        ///< Размер в байтах (у глубоких — размер ссылки)
+    size_t align;                       ///< Выравнивание в байтах
+    bool deep;                          ///< Содержит строки, таблицы или ссылки
+    bool cyclic;                        ///< TYPE_KIND_INVALID: определение зависит от самого себя
+    const type_component_t *components; ///< Компоненты структуры
+    int component_count;                ///< Количество компонентов
+    const struct TypeInfo *line;        ///< Тип строки таблицы или тип по ссылке
+} TypeInfo;
+
+/// Раскладка, которую нельзя вычислить: неизвестное имя или не тип
+extern const TypeInfo type_unknown;
+
+/// Раскладка определения, зависящего от самого себя
+extern const TypeInfo type_cyclic;
+
+/// Запись кэша
+typedef struct {
+    const ASTNode *decl;    ///< Узел объявления (NULL — пустой слот)
+    const TypeInfo *type;   ///< Раскладка
+    TypeInfo *owned;        ///< Раскладка, принадлежащая кэшу (NULL — встроенная или чужая)
+} type_cache_entry_t;
+
+/**
+ * @struct type_cache_t
+ * @brief Раскладки объявлений, вычисленные по требованию.
+ */
+typedef struct {
+    type_cache_entry_t *entries;    ///< Хеш по адресу узла объявления
+    size_t capacity;                ///< Число слотов (степень двойки)
+    size_t count;                   ///< Занятых слотов
+    pthread_mutex_t lock;
+} type_cache_t;
+
+/**
+ * @brief Инициализация пустого кэша.
+ *
+ * @return false, если не удалось создать мьютекс.
+ */
+bool type_cache_init(type_cache_t *cache);
+
+/**
+ * @brief Освобождение кэша и принадлежащих ему раскладок.
+ */
+void type_cache_free(type_cache_t *cache);
+
+/**
+ * @brief Раскладка объявления, если она уже вычислена.
+ *
+ * @return Раскладка или NULL.
+ */
+const TypeInfo *type_cache_find(type_cache_t *cache, const ASTNode *decl);
+
+/**
+ * @brief Запоминает раскладку объявления.
+ *
+ * Если другой поток успел запомнить раскладку того же объявления, остаётся она, а owned
+ * освобождается: результат вычисления зависит только от объявления, поэтому обе равны.
+ *
+ * @param owned Раскладка type, выделенная вызывающим (NULL — type не принадлежит кэшу).
+ * @return Запомненная раскладка; NULL при нехватке памяти (owned освобождается).
+ */
+const TypeInfo *type_cache_insert(type_cache_t *cache, const ASTNode *decl, const TypeInfo *type,
+                                  TypeInfo *owned);
+
+/**
+ * @brief Количество вычисленных раскладок.
+ */
+size_t type_cache_count(type_cache_t *cache);
+
+/**
+ * @brief Раскладка встроенного типа по имени (C, I, STRING, ABAP_BOOL, ...).
+ *
+ * @return Раскладка или NULL, если имя не встроенный тип.
+ */
+const TypeInfo *type_builtin(atom_t name);
+
+/**
+ * @brief Встроенный тип с заданными LENGTH и DECIMALS.
+ *
+ * @param length 0 — длина базового типа.
+ * @return Новая раскладка (освобождается free()); NULL при нехватке памяти.
+ */
+TypeInfo *type_elementary_sized(const TypeInfo *base, unsigned length, unsigned decimals);
+
+/**
+ * @brief Структура из компонентов: смещения выравниваются по типу компонента, размер —
+ *        по наибольшему выравниванию.
+ *
+ * Компоненты копируются в тот же блок памяти, что и раскладка (освобождается одним free()).
+ *
+ * @return Новая раскладка; NULL при нехватке памяти.
+ */
+TypeInfo *type_structure_create(atom_t name, const type_component_t *components, int count);
+
+/**
+ * @brief Таблица или ссылка: в объекте данных — только ссылка на содержимое (глубокий тип).
+ *
+ * @param kind TYPE_KIND_TABLE или TYPE_KIND_REFERENCE.
+ * @param line Тип строки таблицы или тип по ссылке (NULL — неизвестен).
+ * @return Новая раскладка (освобождается free()); NULL при нехватке памяти.
+ */
+TypeInfo *type_indirect_create(type_kind_t kind, const TypeInfo *line);
+
+/**
+ * @brief Компонент структуры по имени.
+ *
+ * @return Компонент или NULL.
+ */
+const type_component_t *type_component_find(const TypeInfo *type, atom_t name);
+
+#endif // TYPE_LAYOUT_H
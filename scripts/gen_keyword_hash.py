@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""
+Генератор совершенной хеш-таблицы ключевых слов ABAP.
+
+Читает include/abap_keywords.h (списки ABAP_KEYWORD_LIST и ABAP_WORD_OPERATOR_LIST),
+проверяет, что в них присутствуют все TOKEN_KEYWORD_* из include/token.h,
+и записывает src/lexer/keyword_hash.h.
+
+Схема хеширования (двухуровневая, "hash and displace"):
+    h    = FNV-1a(seed, upper(text))
+    b    = h & (BUCKETS - 1)
+    slot = ((h >> BUCKET_BITS) ^ displacement[b]) & (SLOTS - 1)
+
+Параметры seed и displacement подбираются так, чтобы у каждого ключевого
+слова был свой слот. Функция хеширования должна совпадать с keywords.c.
+
+Запуск из корня репозитория:
+    python3 scripts/gen_keyword_hash.py
+"""
+
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+TOKEN_H = os.path.join(ROOT, "include", "token.h")
+KEYWORDS_H = os.path.join(ROOT, "include", "abap_keywords.h")
+OUTPUT = os.path.join(ROOT, "src", "lexer", "keyword_hash.h")
+
+FNV_PRIME = 16777619
+MASK32 = 0xFFFFFFFF
+
+
+def fnv1a(seed, text):
+    h = seed
+    for ch in text.encode("ascii"):
+        h = ((h ^ ch) * FNV_PRIME) & MASK32
+    return h
+
+
+def read_keywords():
+    with open(KEYWORDS_H, encoding="utf-8") as f:
+        source = f.read()
+    entries = re.findall(r'ABAP_KEYWORD\("([A-Z0-9_-]+)",\s*(TOKEN_[A-Z0-9_]+)\)', source)
+    if not entries:
+        sys.exit("gen_keyword_hash: no ABAP_KEYWORD entries found in abap_keywords.h")
+
+    seen = {}
+    for spelling, token in entries:
+        if spelling in seen:
+            sys.exit("gen_keyword_hash: duplicate keyword %s" % spelling)
+        seen[spelling] = token
+
+    with open(TOKEN_H, encoding="utf-8") as f:
+        declared = set(re.findall(r"\b(TOKEN_KEYWORD_[A-Z0-9_]+)\s*,", f.read()))
+    missing = sorted(declared - set(seen.values()))
+    if missing:
+        sys.exit("gen_keyword_hash: keywords missing from abap_keywords.h: " + ", ".join(missing))
+    unknown = sorted(t for t in seen.values() if t.startswith("TOKEN_KEYWORD_") and t not in declared)
+    if unknown:
+        sys.exit("gen_keyword_hash: token types not declared in token.h: " + ", ".join(unknown))
+    return entries
+
+
+def next_pow2(n):
+    p = 1
+    while p < n:
+        p <<= 1
+    return p
+
+
+def build(entries):
+    count = len(entries)
+    buckets = next_pow2(max(1, count // 2))
+    bucket_bits = buckets.bit_length() - 1
+    slots = next_pow2(count * 2)
+
+    for seed in range(0x811C9DC5, 0x811C9DC5 + 100000):
+        grouped = [[] for _ in range(buckets)]
+        for index, (spelling, _) in enumerate(entries):
+            h = fnv1a(seed, spelling)
+            grouped[h & (buckets - 1)].append((index, h >> bucket_bits))
+
+        order = sorted(range(buckets), key=lambda b: -len(grouped[b]))
+        table = [None] * slots
+        displacement = [0] * buckets
+        ok = True
+        for b in order:
+            keys = grouped[b]
+            if not keys:
+                continue
+            for d in range(slots):
+                positions = [(h2 ^ d) & (slots - 1) for _, h2 in keys]
+                if len(set(positions)) == len(positions) and all(table[p] is None for p in positions):
+                    for (index, _), p in zip(keys, positions):
+                        table[p] = index
+                    displacement[b] = d
+                    break
+            else:
+                ok = False
+                break
+        if ok:
+            return seed, buckets, bucket_bits, slots, displacement, table
+    sys.exit("gen_keyword_hash: failed to find a perfect hash")
+
+
+def emit(entries, seed, buckets, bucket_bits, slots, displacement, table):
+    min_len = min(len(s) for s, _ in entries)
+    max_len = max(len(s) for s, _ in entries)
+    out = []
+    out.append("// Сгенерировано scripts/gen_keyword_hash.py из include/abap_keywords.h — не редактировать вручную.")
+    out.append("// Подключается только из src/lexer/keywords.c.")
+    out.append("")
+    out.append("#ifndef KEYWORD_HASH_H")
+    out.append("#define KEYWORD_HASH_H")
+    out.append("")
+    out.append("#define KEYWORD_HASH_SEED    0x%08Xu" % seed)
+    out.append("#define KEYWORD_BUCKETS      %du" % buckets)
+    out.append("#define KEYWORD_BUCKET_BITS  %d" % bucket_bits)
+    out.append("#define KEYWORD_SLOTS        %du" % slots)
+    out.append("#define KEYWORD_MIN_LENGTH   %d" % min_len)
+    out.append("#define KEYWORD_MAX_LENGTH   %d" % max_len)
+    out.append("")
+    out.append("static const uint8_t keyword_displacement[KEYWORD_BUCKETS] = {")
+    for i in range(0, buckets, 16):
+        out.append("    " + ", ".join("%3d" % d for d in displacement[i:i + 16]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("static const keyword_entry_t keyword_table[KEYWORD_SLOTS] = {")
+    for slot, index in enumerate(table):
+        if index is None:
+            out.append("    { NULL, 0, TOKEN_IDENTIFIER },")
+        else:
+            spelling, token = entries[index]
+            out.append('    { "%s", %d, %s },' % (spelling, len(spelling), token))
+    out.append("};")
+    out.append("")
+    out.append("#endif // KEYWORD_HASH_H")
+    with open(OUTPUT, "w", encoding="utf-8", newline="\r\n") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def main():
+    entries = read_keywords()
+    seed, buckets, bucket_bits, slots, displacement, table = build(entries)
+    if max(displacement) > 255:
+        sys.exit("gen_keyword_hash: displacement does not fit into uint8_t")
+    emit(entries, seed, buckets, bucket_bits, slots, displacement, table)
+    print("gen_keyword_hash: %d keywords, %d slots, seed 0x%08X" % (len(entries), slots, seed))
+
+
+if __name__ == "__main__":
+    main()
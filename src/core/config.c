@@ -15,6 +15,8 @@
 // Структура хранения конфигурации
 typedef struct {
     char output_dir[MAX_PATH_LENGTH];
+    char cache_dir[MAX_PATH_LENGTH];    // Кэш плоских AST (ast_cache.h); пусто — без кэша
+    char summary_dir[MAX_PATH_LENGTH];  // Сводки классов (class_summary.h); пусто — без сводок
     int optimization_level;
     int debug_enabled;
     int verbose;
@@ -25,6 +27,8 @@ static CompilerConfig g_config;
 // Инициализация конфигурации значениями по умолчанию
 void config_init_defaults() {
     strncpy(g_config.output_dir, "./build", MAX_PATH_LENGTH);
+    g_config.cache_dir[0] = '\0';
+    g_config.summary_dir[0] = '\0';
     g_config.optimization_level = 1;  // 0 - без оптимизации, 1 - базовая, 2 - агрессивная
     g_config.debug_enabled = 0;       // Отладочная информация отключена
     g_config.verbose = 0;             // Подробный вывод отключен
@@ -35,6 +39,8 @@ void config_init_defaults() {
 // Пример:
 // output_dir=./out
 // optimization_level=2
+// cache_dir=./cache
+// summary_dir=./sig
 // debug_enabled=1
 // verbose=1
 int config_load_from_file(const char *filename) {
@@ -63,6 +69,10 @@ int config_load_from_file(const char *filename) {
         if (strcmp(key, "output_dir") == 0) {
             strncpy(g_config.output_dir, value, MAX_PATH_LENGTH - 1);
             g_config.output_dir[MAX_PATH_LENGTH - 1] = '\0';
+        } else if (strcmp(key, "cache_dir") == 0) {
+            config_set_cache_dir(value);
+        } else if (strcmp(key, "summary_dir") == 0) {
+            config_set_summary_dir(value);
         } else if (strcmp(key, "optimization_level") == 0) {
             g_config.optimization_level = atoi(value);
             if (g_config.optimization_level < 0) g_config.optimization_level = 0;
@@ -104,3 +114,32 @@ void config_set_verbose(int verbose) {
     g_config.verbose = verbose ? 1 : 0;
 }
 
+// Установка уровня оптимизации (0-2)
+void config_set_optimization_level(int level) {
+    g_config.optimization_level = level < 0 ? 0 : level > 2 ? 2 : level;
+}
+
+// Включение режима отладки
+void config_set_debug(int debug) {
+    g_config.debug_enabled = debug ? 1 : 0;
+}
+
+// Каталог кэша плоских AST или NULL, если кэш не задан
+const char *config_get_cache_dir() {
+    return g_config.cache_dir[0] ? g_config.cache_dir : NULL;
+}
+
+void config_set_cache_dir(const char *dir) {
+    strncpy(g_config.cache_dir, dir ? dir : "", MAX_PATH_LENGTH - 1);
+    g_config.cache_dir[MAX_PATH_LENGTH - 1] = '\0';
+}
+
+// Каталог сводок классов или NULL, если сводки не используются
+const char *config_get_summary_dir() {
+    return g_config.summary_dir[0] ? g_config.summary_dir : NULL;
+}
+
+void config_set_summary_dir(const char *dir) {
+    strncpy(g_config.summary_dir, dir ? dir : "", MAX_PATH_LENGTH - 1);
+    g_config.summary_dir[MAX_PATH_LENGTH - 1] = '\0';
+}
@@ -0,0 +1,146 @@
+#include "diagnostics.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file diagnostics.c
+ * @brief Список сообщений компилятора.
+ */
+
+#define DIAG_INITIAL_CAPACITY 16
+
+void diag_list_init(diag_list_t *list) {
+    memset(list, 0, sizeof(diag_list_t));
+}
+
+void diag_list_free(diag_list_t *list) {
+    for (int i = 0; i < list->count; i++) {
+        free(list->items[i].message);
+    }
+    free(list->items);
+    int max_errors = list->max_errors;
+    diag_list_init(list);
+    list->max_errors = max_errors;
+}
+
+bool diag_limit_reached(const diag_list_t *list) {
+    return list->max_errors > 0 && list->error_count >= list->max_errors;
+}
+
+/**
+ * @brief Добавление сообщения.
+ */
+bool diag_report(diag_list_t *list, diag_severity_t severity, int line, int column,
+                 const char *format, ...) {
+    if (severity == DIAG_ERROR && diag_limit_reached(list)) return false;
+
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : DIAG_INITIAL_CAPACITY;
+        diagnostic_t *items = realloc(list->items, (size_t)capacity * sizeof(diagnostic_t));
+        if (!items) return false;
+        list->items = items;
+        list->capacity = capacity;
+    }
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if (length < 0) return false;
+
+    char *message = malloc((size_t)length + 1);
+    if (!message) return false;
+    va_start(args, format);
+    vsnprintf(message, (size_t)length + 1, format, args);
+    va_end(args);
+
+    list->items[list->count++] = (diagnostic_t){ severity, line, column, message };
+    if (severity == DIAG_ERROR) list->error_count++;
+    return true;
+}
+
+/**
+ * @brief Перенос сообщений другого списка в конец.
+ */
+bool diag_list_append(diag_list_t *list, diag_list_t *from) {
+    if (from->count == 0) return true;
+    if (list->count + from->count > list->capacity) {
+        int capacity = list->capacity ? list->capacity : DIAG_INITIAL_CAPACITY;
+        while (capacity < list->count + from->count) capacity *= 2;
+        diagnostic_t *items = realloc(list->items, (size_t)capacity * sizeof(diagnostic_t));
+        if (!items) return false;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    memcpy(list->items + list->count, from->items, (size_t)from->count * sizeof(diagnostic_t));
+    list->count += from->count;
+    list->error_count += from->error_count;
+    free(from->items);
+    int max_errors = from->max_errors;
+    diag_list_init(from);
+    from->max_errors = max_errors;
+    return true;
+}
+
+/**
+ * @brief Замена отрезка сообщений сообщениями другого списка.
+ */
+bool diag_list_replace(diag_list_t *list, int first, int count, diag_list_t *from) {
+    if (first < 0 || count < 0 || first + count > list->count) return false;
+    int total = list->count - count + from->count;
+    if (total > list->capacity) {
+        int capacity = list->capacity ? list->capacity : DIAG_INITIAL_CAPACITY;
+        while (capacity < total) capacity *= 2;
+        diagnostic_t *items = realloc(list->items, (size_t)capacity * sizeof(diagnostic_t));
+        if (!items) return false;
+        list->items = items;
+        list->capacity = capacity;
+    }
+
+    for (int i = first; i < first + count; i++) {
+        if (list->items[i].severity == DIAG_ERROR) list->error_count--;
+        free(list->items[i].message);
+    }
+    int tail = list->count - first - count;
+    if (tail > 0) {
+        memmove(list->items + first + from->count, list->items + first + count,
+                (size_t)tail * sizeof(diagnostic_t));
+    }
+    if (from->count) {
+        memcpy(list->items + first, from->items, (size_t)from->count * sizeof(diagnostic_t));
+    }
+    list->count = total;
+    list->error_count += from->error_count;
+    free(from->items);
+    int max_errors = from->max_errors;
+    diag_list_init(from);
+    from->max_errors = max_errors;
+    return true;
+}
+
+static const char *diag_severity_name(diag_severity_t severity) {
+    switch (severity) {
+        case DIAG_ERROR:   return "error";
+        case DIAG_WARNING: return "warning";
+        default:           return "note";
+    }
+}
+
+/**
+ * @brief Печать всех сообщений списка.
+ */
+void diag_list_print(const diag_list_t *list, FILE *out, const char *path) {
+    for (int i = 0; i < list->count; i++) {
+        const diagnostic_t *diag = &list->items[i];
+        if (diag->line > 0) {
+            fprintf(out, "%s:%d:%d: %s: %s\n", path ? path : "<input>", diag->line, diag->column,
+                    diag_severity_name(diag->severity), diag->message);
+        } else {
+            fprintf(out, "%s: %s: %s\n", path ? path : "<input>", diag_severity_name(diag->severity), diag->message);
+        }
+    }
+    if (diag_limit_reached(list)) {
+        fprintf(out, "%s: too many errors, stopped after %d\n", path ? path : "<input>", list->max_errors);
+    }
+}
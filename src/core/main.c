@@ -1,3 +1,4 @@
+/*
 // Compiler/src/core/main.c
 // Основной файл запуска компилятора ABAP.
 // Обрабатывает аргументы командной строки, инициализирует компоненты,
@@ -162,3 +163,361 @@ int main(int argc, char **argv) {
 
     return EXIT_SUCCESS;
 }
+*/
+
+// Compiler/src/core/main.c
+// Точка входа компилятора ABAP: разбор аргументов и этапы
+// исходник -> AST (или кэш AST) -> семантический анализ -> IR.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ast_cache.h"
+#include "ast_flat.h"
+#include "ast_visitor.h"
+#include "class_summary.h"
+#include "config.h"
+#include "ir_flat.h"
+#include "lexer.h"
+#include "parser.h"
+#include "parser_parallel.h"
+#include "semantic.h"
+#include "source_buffer.h"
+#include "token_stream.h"
+
+// Показать справку по использованию
+static void print_usage(const char *progname) {
+    printf("Использование: %s [опции] <файл.abap>\n", progname);
+    printf("Опции:\n");
+    printf("  -h, --help           показать это сообщение\n");
+    printf("  -c <config_file>     использовать файл конфигурации\n");
+    printf("  -v                   включить подробный вывод (verbose)\n");
+    printf("  -d                   включить режим отладки\n");
+    printf("  -O <level>           уровень оптимизации (0, 1, 2)\n");
+    printf("  --cache <dir>        кэш AST: неизменённый исходник не разбирается повторно\n");
+    printf("  --sig <dir>          сводки классов: читать для внешних классов, записывать для своих\n");
+    printf("\n");
+}
+
+// Обработка аргументов командной строки и настройка конфигурации
+static int process_args(int argc, char **argv, char **input_file) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    config_init_defaults();
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            exit(0);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            if (!config_load_from_file(argv[++i])) {
+                fprintf(stderr, "Ошибка загрузки конфигурации из файла %s\n", argv[i]);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "-v") == 0) {
+            config_set_verbose(1);
+        } else if (strcmp(argv[i], "-d") == 0) {
+            config_set_debug(1);
+        } else if (strcmp(argv[i], "-O") == 0 && i + 1 < argc) {
+            int level = atoi(argv[++i]);
+            if (level < 0 || level > 2) {
+                fprintf(stderr, "Некорректный уровень оптимизации: %d\n", level);
+                return 0;
+            }
+            config_set_optimization_level(level);
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            config_set_cache_dir(argv[++i]);
+        } else if (strcmp(argv[i], "--sig") == 0 && i + 1 < argc) {
+            config_set_summary_dir(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            *input_file = argv[i];
+        } else {
+            fprintf(stderr, "Неизвестная опция: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return 0;
+        }
+    }
+
+    if (!*input_file) {
+        fprintf(stderr, "Не указан входной файл ABAP\n");
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    return 1;
+}
+
+// Плоское дерево единицы компиляции: своё или отображённое из кэша
+typedef struct {
+    ast_flat_t built;           // Построено из разобранного дерева
+    ast_cache_entry_t cached;   // Загружено из кэша
+    parser_parallel_result_t parsed;    // Разбор на пуле: арены с узлами дерева
+    uint32_t *offsets;          // Последовательный разбор: смещения операторов верхнего уровня
+    bool from_cache;
+} compile_tree_t;
+
+static const ast_flat_t *compile_flat(const compile_tree_t *tree) {
+    return tree->from_cache ? &tree->cached.tree : &tree->built;
+}
+
+// Лексер и парсер. На пуле из нескольких потоков тела FORM/METHOD/MODULE разбираются
+// параллельно (parser_parse_parallel()), и узлы дерева лежат в аренах tree->parsed.
+// Смещения операторов верхнего уровня — в tree->offsets или tree->parsed.offsets.
+// Сообщения разбора печатаются; при ошибках возвращается NULL
+static ASTNode *compile_parse(const char *path, const source_buffer_t *source, thread_pool_t *pool,
+                              compile_tree_t *tree) {
+    lexer_t lexer;
+    lexer_init(&lexer, source->data, source->length);
+    TokenStream ts;
+    bool ok = token_stream_from_lexer(&ts, &lexer);
+    lexer_free(&lexer);
+    if (!ok || !token_stream_expand_chains(&ts)) {
+        fprintf(stderr, "Ошибка лексического анализа\n");
+        if (ok) token_stream_free(&ts);
+        return NULL;
+    }
+
+    diag_list_t sequential;
+    diag_list_t *diagnostics = &sequential;
+    diag_list_init(&sequential);
+    ASTNode *root;
+    if (pool && thread_pool_size(pool) > 1) {
+        root = parser_parse_parallel(&ts, pool, &tree->parsed) ? tree->parsed.program : NULL;
+        diagnostics = &tree->parsed.diagnostics;
+    } else {
+        root = parse_program_offsets(&ts, &sequential, &tree->offsets);
+    }
+    diag_list_print(diagnostics, stderr, path);
+    if (diagnostics->error_count > 0) root = NULL;  // Узлы освобождает арена единицы компиляции или parsed
+    diag_list_free(&sequential);
+    token_stream_free(&ts);
+    return root;
+}
+
+// Дерево программы. Если исходник не менялся с прошлой успешной компиляции, плоское
+// дерево берётся из кэша, и лексер с парсером не запускаются; иначе разобранное без
+// ошибок дерево записывается в кэш
+static ASTNode *compile_front_end(const char *path, const source_buffer_t *source, thread_pool_t *pool,
+                                  compile_tree_t *tree) {
+    const char *cache_dir = config_get_cache_dir();
+    uint64_t hash = ast_cache_hash(source->data, source->length);
+    ast_flat_init(&tree->built);
+    tree->parsed = (parser_parallel_result_t){ 0 };
+    tree->offsets = NULL;
+    tree->from_cache = cache_dir && ast_cache_load(&tree->cached, cache_dir, hash, source->length);
+    if (tree->from_cache) {
+        if (config_is_verbose()) printf("AST взято из кэша\n");
+        // Временный шаг: IR строится по плоскому дереву, но семантический анализ и сводки
+        // классов пока читают только ASTNode, поэтому отображённое дерево разворачивается
+        // целиком. Шаг уйдёт, когда анализ научится читать ast_flat_t
+        // (src/semantic/semantic_analyzer.md, «Сбор»)
+        return ast_flat_expand(&tree->cached.tree, 0);
+    }
+
+    ASTNode *root = compile_parse(path, source, pool, tree);
+    if (!root) return NULL;
+    if (!ast_flat_build(&tree->built, root)) return NULL;
+    // Позиции операторов верхнего уровня попадают в файл кэша вместе с деревом
+    const uint32_t *offsets = tree->offsets ? tree->offsets : tree->parsed.offsets;
+    if (offsets && !ast_flat_set_child_positions(&tree->built, 0, offsets)) return NULL;
+    if (cache_dir && !ast_cache_store(cache_dir, hash, source->length, &tree->built)) {
+        fprintf(stderr, "Предупреждение: не удалось записать кэш AST в %s\n", cache_dir);
+    }
+    return root;
+}
+
+static void compile_tree_free(compile_tree_t *tree) {
+    if (tree->from_cache) ast_cache_close(&tree->cached);
+    else ast_flat_free(&tree->built);
+    free(tree->offsets);
+    parser_parallel_result_free(&tree->parsed);
+}
+
+// Сводки внешних классов и таблица, в которой они объявлены (ddic анализа)
+typedef struct {
+    atom_t *names;              // Кандидаты: имена типов и головы составных имён class=>comp, intf~comp
+    int name_count;
+    int name_capacity;
+    atom_t *own;                // Классы и интерфейсы, объявленные в самой программе
+    int own_count;
+    int own_capacity;
+    class_summary_t *items;     // Загруженные сводки
+    int count;
+    symbol_frozen_t ddic;
+    bool frozen;
+} compile_summaries_t;
+
+static bool compile_add_name(atom_t **names, int *count, int *capacity, atom_t name) {
+    for (int i = 0; i < *count; i++) {
+        if ((*names)[i] == name) return true;
+    }
+    if (*count == *capacity) {
+        int grown = *capacity ? *capacity * 2 : 16;
+        atom_t *items = realloc(*names, (size_t)grown * sizeof(atom_t));
+        if (!items) return false;
+        *names = items;
+        *capacity = grown;
+    }
+    (*names)[(*count)++] = name;
+    return true;
+}
+
+static ast_visit_result_t compile_summary_names_node(ASTNode *node, ASTNode *parent, void *arg) {
+    (void)parent;
+    compile_summaries_t *summaries = arg;
+    if (node->atom == ATOM_NONE) return AST_VISIT_CONTINUE;
+    bool ok = true;
+    if (node->type == AST_CLASS_DEF || node->type == AST_INTERFACE_DEF) {
+        ok = compile_add_name(&summaries->own, &summaries->own_count, &summaries->own_capacity, node->atom);
+    }
+    const char *text = atom_text(node->atom);
+    size_t head = strcspn(text, "=~");
+    if (head > 0 && (text[head] == '~' || (text[head] == '=' && text[head + 1] == '>'))) {
+        ok = ok && compile_add_name(&summaries->names, &summaries->name_count, &summaries->name_capacity,
+                                    atom_intern(text, head));
+    } else if (node->type == AST_TYPE_SPEC) {
+        ok = ok && compile_add_name(&summaries->names, &summaries->name_count, &summaries->name_capacity, node->atom);
+    }
+    return ok ? AST_VISIT_CONTINUE : AST_VISIT_STOP;
+}
+
+static bool compile_is_own(const compile_summaries_t *summaries, atom_t name) {
+    for (int i = 0; i < summaries->own_count; i++) {
+        if (summaries->own[i] == name) return true;
+    }
+    return false;
+}
+
+// Загружает сводки классов, на которые ссылается программа и которые она не объявляет
+// сама, и замораживает их символы для semantic_analyze(). Отсутствующая сводка — не
+// ошибка: имя останется необъявленным, и об этом сообщит анализ
+static bool compile_load_summaries(const char *dir, ASTNode *root, compile_summaries_t *summaries) {
+    memset(summaries, 0, sizeof(*summaries));
+    ast_visitor_t visitor = { .pre_any = compile_summary_names_node, .arg = summaries };
+    ast_visit(root, &visitor);
+    summaries->items = calloc((size_t)summaries->name_count + 1, sizeof(class_summary_t));
+    if (!summaries->items) return false;
+
+    symbol_table_t builder;
+    symbol_table_init(&builder, NULL);
+    bool ok = true;
+    for (int i = 0; ok && i < summaries->name_count; i++) {
+        if (compile_is_own(summaries, summaries->names[i])) continue;
+        class_summary_t *summary = &summaries->items[summaries->count];
+        if (!class_summary_load(summary, dir, summaries->names[i])) continue;
+        summaries->count++;
+        ok = class_summary_declare(summary, &builder);
+        if (config_is_verbose()) printf("Сводка класса %s загружена\n", atom_text(summary->name));
+    }
+    ok = ok && symbol_table_freeze(&builder, &summaries->ddic);
+    summaries->frozen = ok;
+    symbol_table_free(&builder);
+    return ok;
+}
+
+// Записывает сводки классов и интерфейсов программы. Хеш исходника — хеш дерева
+// определения: правка реализации методов сводку не меняет
+static void compile_store_summaries(const char *dir, const ASTNode *root, semantic_result_t *analysis) {
+    for (int i = 0; i < root->child_count; i++) {
+        const ASTNode *node = root->children[i];
+        if (!node || (node->type != AST_CLASS_DEF && node->type != AST_INTERFACE_DEF)) continue;
+        if (!class_summary_store(dir, node, semantic_tree_hash(node), analysis)) {
+            fprintf(stderr, "Предупреждение: не удалось записать сводку %s в %s\n", atom_text(node->atom), dir);
+        }
+    }
+}
+
+static void compile_summaries_free(compile_summaries_t *summaries) {
+    if (summaries->frozen) symbol_frozen_free(&summaries->ddic);
+    for (int i = 0; i < summaries->count; i++) class_summary_close(&summaries->items[i]);
+    free(summaries->items);
+    free(summaries->names);
+    free(summaries->own);
+}
+
+int main(int argc, char **argv) {
+    char *input_file = NULL;
+
+    if (!process_args(argc, argv, &input_file)) {
+        return EXIT_FAILURE;
+    }
+
+    if (config_is_verbose()) {
+        printf("Компиляция файла: %s\n", input_file);
+        printf("Каталог вывода: %s\n", config_get_output_dir());
+        printf("Уровень оптимизации: %d\n", config_get_optimization_level());
+    }
+
+    source_buffer_t source;
+    if (!source_buffer_open(&source, input_file)) {
+        return EXIT_FAILURE;
+    }
+    ast_arena_t *arena = ast_arena_create();
+    if (!arena) {
+        fprintf(stderr, "Недостаточно памяти\n");
+        source_buffer_close(&source);
+        return EXIT_FAILURE;
+    }
+    ast_arena_activate(arena);
+
+    // Запуск компиляции: лексинг -> парсинг (или кэш AST) -> семантика -> IR
+    int status = EXIT_FAILURE;
+    compile_tree_t tree;
+    semantic_result_t analysis;
+    bool analyzed = false;
+    compile_summaries_t summaries = { 0 };
+    const char *summary_dir = config_get_summary_dir();
+    thread_pool_t *pool = NULL;
+    ir_list_t ir;
+    ir_list_init(&ir);
+
+    pool = thread_pool_create(thread_pool_default_threads());
+    ASTNode *root = compile_front_end(input_file, &source, pool, &tree);
+    if (!root) {
+        fprintf(stderr, "Ошибка синтаксического анализа\n");
+        goto done;
+    }
+
+    if (summary_dir && !compile_load_summaries(summary_dir, root, &summaries)) {
+        fprintf(stderr, "Недостаточно памяти для сводок классов\n");
+        goto done;
+    }
+
+    analyzed = true;
+    if (!semantic_analyze(root, summaries.frozen ? &summaries.ddic : NULL, pool, &analysis)) {
+        fprintf(stderr, "Недостаточно памяти для семантического анализа\n");
+        goto done;
+    }
+    diag_list_print(&analysis.diagnostics, stderr, input_file);
+    if (analysis.diagnostics.error_count > 0) {
+        fprintf(stderr, "Ошибка семантического анализа\n");
+        goto done;
+    }
+    if (summary_dir) compile_store_summaries(summary_dir, root, &analysis);
+
+    // IR пока нужен только для отладочного вывода: кодогенерация (codegen.h) построена
+    // на прежнем IRProgram и сюда не подключена, поэтому непереведённый код не ошибка
+    if (!irgen_generate_flat(compile_flat(&tree), 0, &ir)) {
+        fprintf(stderr, "Предупреждение: часть программы не переведена в IR\n");
+    }
+    if (config_is_debug_enabled()) ir_list_print(&ir);
+
+    if (config_is_verbose()) {
+        printf("Компиляция завершена успешно.\n");
+    }
+    status = EXIT_SUCCESS;
+
+done:
+    ir_list_free(&ir);
+    if (analyzed) semantic_result_free(&analysis);
+    compile_summaries_free(&summaries);     // После анализа: его глобальные ссылаются на ddic
+    if (pool) thread_pool_destroy(pool);
+    compile_tree_free(&tree);
+    ast_arena_destroy(arena);
+    source_buffer_close(&source);
+    return status;
+}
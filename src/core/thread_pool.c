@@ -0,0 +1,160 @@
+#include "thread_pool.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * @file thread_pool.c
+ * @brief Пул рабочих потоков с раздачей элементов через атомарный счётчик.
+ */
+
+struct thread_pool {
+    pthread_t *threads;         // Рабочие потоки (size - 1 штук)
+    int size;                   // Число потоков, включая вызывающий
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;  // Появилась новая задача или пул останавливается
+    pthread_cond_t work_done;   // Все рабочие потоки закончили текущую задачу
+    unsigned long generation;   // Номер текущей задачи
+    int busy;                   // Рабочих потоков, ещё не закончивших задачу
+    bool stopping;
+
+    // Текущая задача
+    thread_pool_fn fn;
+    void *arg;
+    size_t count;
+    size_t next;                // Следующий свободный элемент (атомарно)
+};
+
+typedef struct {
+    thread_pool_t *pool;
+    int worker;
+} thread_pool_worker_t;
+
+// Разбор элементов текущей задачи до исчерпания
+static void thread_pool_drain(thread_pool_t *pool, int worker) {
+    for (;;) {
+        size_t index = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED);
+        if (index >= pool->count) break;
+        pool->fn(pool->arg, index, worker);
+    }
+}
+
+static void *thread_pool_main(void *param) {
+    thread_pool_worker_t *self = (thread_pool_worker_t *)param;
+    thread_pool_t *pool = self->pool;
+    int worker = self->worker;
+    free(self);
+
+    unsigned long seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stopping && pool->generation == seen) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        if (pool->stopping) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        thread_pool_drain(pool, worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) {
+            pthread_cond_signal(&pool->work_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+int thread_pool_default_threads(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+thread_pool_t *thread_pool_create(int threads) {
+    if (threads <= 0) threads = thread_pool_default_threads();
+
+    thread_pool_t *pool = calloc(1, sizeof(thread_pool_t));
+    if (!pool) return NULL;
+    pool->size = threads;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    if (threads > 1) {
+        pool->threads = calloc((size_t)threads - 1, sizeof(pthread_t));
+        if (!pool->threads) {
+            thread_pool_destroy(pool);
+            return NULL;
+        }
+    }
+    for (int i = 1; i < threads; i++) {
+        thread_pool_worker_t *param = malloc(sizeof(thread_pool_worker_t));
+        if (param) {
+            param->pool = pool;
+            param->worker = i;
+        }
+        if (!param || pthread_create(&pool->threads[i - 1], NULL, thread_pool_main, param) != 0) {
+            free(param);
+            fprintf(stderr, "Failed to start worker thread %d, continuing with %d threads\n", i, i);
+            pool->size = i;
+            break;
+        }
+    }
+    return pool;
+}
+
+int thread_pool_size(const thread_pool_t *pool) {
+    return pool ? pool->size : 1;
+}
+
+void thread_pool_run(thread_pool_t *pool, size_t count, thread_pool_fn fn, void *arg) {
+    if (count == 0) return;
+
+    // Без пула или для одного элемента — прямо в вызывающем потоке
+    if (!pool || pool->size == 1 || count == 1) {
+        for (size_t i = 0; i < count; i++) fn(arg, i, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->count = count;
+    pool->next = 0;
+    pool->busy = pool->size - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    thread_pool_drain(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pool->fn = NULL;
+    pool->arg = NULL;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_destroy(thread_pool_t *pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 1; i < pool->size && pool->threads; i++) {
+        pthread_join(pool->threads[i - 1], NULL);
+    }
+    free(pool->threads);
+    pthread_cond_destroy(&pool->work_done);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
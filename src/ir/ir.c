@@ -1,3 +1,4 @@
+/*
 #include "ir.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -21,7 +22,7 @@ typedef struct {
         int reg;                // Регистровый номер
         int constant;           // Константа
         char label[MAX_LABEL_LEN]; // Метка для перехода
-        char *var_name;         // Имя переменной (динамически выделяется)
+        atom_t var;             // Имя переменной (атом из общей таблицы)
     };
 } IROperand;
 
@@ -58,20 +59,18 @@ static IROperand ir_operand_label(const char *label) {
     return op;
 }
 
-// Создать операнд типа variable
-static IROperand ir_operand_variable(const char *name) {
+// Создать операнд типа variable (имя не копируется — операнд хранит атом)
+static IROperand ir_operand_variable(atom_t var) {
     IROperand op;
     op.type = IR_OPERAND_VARIABLE;
-    op.var_name = strdup(name);
+    op.var = var;
     return op;
 }
 
-// Освободить память операнда (если нужно)
+// Освободить память операнда (если нужно).
+// Операнды не владеют памятью: имена переменных — атомы, метки хранятся внутри операнда.
 static void ir_operand_free(IROperand *op) {
-    if (op->type == IR_OPERAND_VARIABLE) {
-        free(op->var_name);
-        op->var_name = NULL;
-    }
+    (void)op;
 }
 
 // Создать новую инструкцию IR с заданным кодом операции и операндами
@@ -157,7 +156,7 @@ static void ir_print_operand(IROperand *op) {
             printf("%s", op->label);
             break;
         case IR_OPERAND_VARIABLE:
-            printf("%s", op->var_name);
+            printf("%s", atom_text(op->var));
             break;
     }
 }
@@ -253,4 +252,169 @@ void ir_print(IRInstruction *head) {
         cur = cur->next;
     }
 }
+*/
+
+#include "../../include/ir.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file ir.c
+ * @brief Список инструкций IR из include/ir.h.
+ *
+ * Инструкция владеет своими операндами, метка и строковый операнд — копией текста.
+ * Имена переменных — атомы и не копируются.
+ */
+
+// Мнемоники по ir_op_t
+static const char *const ir_op_names[IR_OP_COUNT] = {
+    [IR_OP_ADD] = "ADD",             [IR_OP_SUB] = "SUB",
+    [IR_OP_MUL] = "MUL",             [IR_OP_DIV] = "DIV",
+    [IR_OP_MOD] = "MOD",             [IR_OP_POW] = "POW",
+    [IR_OP_NEG] = "NEG",             [IR_OP_CONCAT] = "CONCAT",
+    [IR_OP_EQ] = "EQ",               [IR_OP_NE] = "NE",
+    [IR_OP_LT] = "LT",               [IR_OP_GT] = "GT",
+    [IR_OP_LE] = "LE",               [IR_OP_GE] = "GE",
+    [IR_OP_AND] = "AND",             [IR_OP_OR] = "OR",
+    [IR_OP_NOT] = "NOT",             [IR_OP_IN] = "IN",
+    [IR_OP_IS_INITIAL] = "IS_INITIAL", [IR_OP_IS_BOUND] = "IS_BOUND",
+    [IR_OP_IS_ASSIGNED] = "IS_ASSIGNED", [IR_OP_IS_SUPPLIED] = "IS_SUPPLIED",
+    [IR_OP_LOAD] = "LOAD",           [IR_OP_STORE] = "STORE",
+    [IR_OP_JMP] = "JMP",             [IR_OP_JMP_IF] = "JMP_IF",
+    [IR_OP_CALL] = "CALL",           [IR_OP_RET] = "RET",
+    [IR_OP_NOP] = "NOP",
+};
+
+const char *ir_op_name(ir_op_t op) {
+    return (unsigned)op < IR_OP_COUNT && ir_op_names[op] ? ir_op_names[op] : "UNKNOWN";
+}
+
+static ir_operand_t *ir_operand_new(ir_operand_type_t type) {
+    ir_operand_t *operand = calloc(1, sizeof(*operand));
+    if (operand) operand->type = type;
+    return operand;
+}
+
+ir_operand_t *ir_operand_new_register(int reg_num) {
+    ir_operand_t *operand = ir_operand_new(IR_OPERAND_REGISTER);
+    if (operand) operand->value.reg = reg_num;
+    return operand;
+}
+
+ir_operand_t *ir_operand_new_constant(int constant) {
+    ir_operand_t *operand = ir_operand_new(IR_OPERAND_CONSTANT);
+    if (operand) operand->value.constant = constant;
+    return operand;
+}
+
+// Операнд-метка и строковый операнд владеют копией текста
+static ir_operand_t *ir_operand_new_text(ir_operand_type_t type, const char *text) {
+    ir_operand_t *operand = ir_operand_new(type);
+    if (!operand) return NULL;
+    char *copy = strdup(text ? text : "");
+    if (!copy) {
+        free(operand);
+        return NULL;
+    }
+    if (type == IR_OPERAND_LABEL) operand->value.label = copy;
+    else operand->value.string = copy;
+    return operand;
+}
+
+ir_operand_t *ir_operand_new_label(const char *label) {
+    return ir_operand_new_text(IR_OPERAND_LABEL, label);
+}
+
+ir_operand_t *ir_operand_new_string(const char *text) {
+    return ir_operand_new_text(IR_OPERAND_STRING, text);
+}
+
+ir_operand_t *ir_operand_new_variable(atom_t var) {
+    ir_operand_t *operand = ir_operand_new(IR_OPERAND_VARIABLE);
+    if (operand) operand->value.var = var;
+    return operand;
+}
+
+void ir_operand_free(ir_operand_t *operand) {
+    if (!operand) return;
+    if (operand->type == IR_OPERAND_LABEL) free(operand->value.label);
+    else if (operand->type == IR_OPERAND_STRING) free(operand->value.string);
+    free(operand);
+}
+
+// Операнды переходят инструкции и при ошибке освобождаются, чтобы вызов можно было вкладывать
+ir_instruction_t *ir_instruction_new(ir_op_t op, ir_operand_t *dst, ir_operand_t *src1, ir_operand_t *src2) {
+    ir_instruction_t *inst = malloc(sizeof(*inst));
+    if (!inst) {
+        ir_operand_free(dst);
+        ir_operand_free(src1);
+        ir_operand_free(src2);
+        return NULL;
+    }
+    inst->op = op;
+    inst->dst = dst;
+    inst->src1 = src1;
+    inst->src2 = src2;
+    inst->next = NULL;
+    return inst;
+}
+
+void ir_instruction_free(ir_instruction_t *inst) {
+    if (!inst) return;
+    ir_operand_free(inst->dst);
+    ir_operand_free(inst->src1);
+    ir_operand_free(inst->src2);
+    free(inst);
+}
+
+void ir_list_init(ir_list_t *list) {
+    if (!list) return;
+    list->head = NULL;
+    list->tail = NULL;
+}
+
+void ir_list_append(ir_list_t *list, ir_instruction_t *inst) {
+    if (!list || !inst) return;
+    inst->next = NULL;
+    if (list->tail) list->tail->next = inst;
+    else list->head = inst;
+    list->tail = inst;
+}
+
+void ir_list_free(ir_list_t *list) {
+    if (!list) return;
+    ir_instruction_t *inst = list->head;
+    while (inst) {
+        ir_instruction_t *next = inst->next;
+        ir_instruction_free(inst);
+        inst = next;
+    }
+    ir_list_init(list);
+}
+
+static void ir_operand_print(const ir_operand_t *operand) {
+    switch (operand->type) {
+        case IR_OPERAND_REGISTER: printf("r%d", operand->value.reg); break;
+        case IR_OPERAND_CONSTANT: printf("#%d", operand->value.constant); break;
+        case IR_OPERAND_LABEL:    printf("%s", operand->value.label); break;
+        case IR_OPERAND_VARIABLE: printf("%s", atom_text(operand->value.var)); break;
+        case IR_OPERAND_STRING:   printf("%s", operand->value.string); break;
+    }
+}
 
+void ir_list_print(const ir_list_t *list) {
+    if (!list) return;
+    for (const ir_instruction_t *inst = list->head; inst; inst = inst->next) {
+        printf("%s", ir_op_name(inst->op));
+        const ir_operand_t *operands[3] = { inst->dst, inst->src1, inst->src2 };
+        const char *separator = " ";
+        for (int i = 0; i < 3; i++) {
+            if (!operands[i]) continue;
+            printf("%s", separator);
+            ir_operand_print(operands[i]);
+            separator = ", ";
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,224 @@
+#include "../../include/ir_flat.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file ir_flat.c
+ * @brief Генерация IR из плоского AST (ast_flat.h).
+ *
+ * Узлы лежат в массиве в прямом порядке обхода, поэтому выражение переводится одним
+ * проходом слева направо: операторы ждут в стеке кадров, пока не пройдены все узлы
+ * их поддерева (индекс дошёл до ast_flat_end()), после чего инструкция выдаётся над
+ * значениями операндов со стека значений. Рекурсии и переходов по указателям нет.
+ */
+
+/// Перевод узла AST_OPERATOR: текст и число операндов дают операцию IR
+typedef struct {
+    const char *text;
+    uint32_t operands;
+    ir_op_t op;         ///< IR_OP_NOP — значение операнда без инструкции (унарный плюс)
+    bool negated;       ///< Результат инвертируется IR_OP_NOT (NOT IN, IS NOT ..., NOT BETWEEN)
+} irgen_flat_rule_t;
+
+// Тексты узлов — те, что выдаёт parse_expression() (expression/pratt.c).
+// BETWEEN раскладывается на GE, LE и AND, поэтому его операция — AND над тремя операндами.
+static const irgen_flat_rule_t irgen_flat_rules[] = {
+    { "+",   2, IR_OP_ADD, false },     { "-",   2, IR_OP_SUB, false },
+    { "*",   2, IR_OP_MUL, false },     { "/",   2, IR_OP_DIV, false },
+    { "MOD", 2, IR_OP_MOD, false },     { "**",  2, IR_OP_POW, false },
+    { "&&",  2, IR_OP_CONCAT, false },
+    { "+",   1, IR_OP_NOP, false },     { "-",   1, IR_OP_NEG, false },
+    { "=",   2, IR_OP_EQ, false },      { "<>",  2, IR_OP_NE, false },
+    { "<",   2, IR_OP_LT, false },      { ">",   2, IR_OP_GT, false },
+    { "<=",  2, IR_OP_LE, false },      { ">=",  2, IR_OP_GE, false },
+    { "AND", 2, IR_OP_AND, false },     { "OR",  2, IR_OP_OR, false },
+    { "NOT", 1, IR_OP_NOT, false },
+    { "IN",     2, IR_OP_IN, false },   { "NOT IN",     2, IR_OP_IN,  true },
+    { "BETWEEN", 3, IR_OP_AND, false }, { "NOT BETWEEN", 3, IR_OP_AND, true },
+    { "IS INITIAL",  1, IR_OP_IS_INITIAL, false },  { "IS NOT INITIAL",  1, IR_OP_IS_INITIAL,  true },
+    { "IS BOUND",    1, IR_OP_IS_BOUND, false },    { "IS NOT BOUND",    1, IR_OP_IS_BOUND,    true },
+    { "IS ASSIGNED", 1, IR_OP_IS_ASSIGNED, false }, { "IS NOT ASSIGNED", 1, IR_OP_IS_ASSIGNED, true },
+    { "IS SUPPLIED", 1, IR_OP_IS_SUPPLIED, false }, { "IS NOT SUPPLIED", 1, IR_OP_IS_SUPPLIED, true },
+};
+
+static const irgen_flat_rule_t *irgen_flat_rule(const char *text, uint32_t operands) {
+    if (!text) return NULL;
+    for (size_t i = 0; i < sizeof(irgen_flat_rules) / sizeof(irgen_flat_rules[0]); i++) {
+        if (irgen_flat_rules[i].operands == operands && strcmp(irgen_flat_rules[i].text, text) == 0) {
+            return &irgen_flat_rules[i];
+        }
+    }
+    return NULL;
+}
+
+// Добавляет инструкцию; NULL среди первых required операндов — нехватка памяти
+static bool irgen_flat_emit(ir_list_t *out, ir_op_t op, int required,
+                            ir_operand_t *dst, ir_operand_t *src1, ir_operand_t *src2) {
+    ir_instruction_t *inst = ir_instruction_new(op, dst, src1, src2);
+    if (!inst || !dst || (required > 1 && !src1) || (required > 2 && !src2)) {
+        if (inst) ir_instruction_free(inst);
+        fprintf(stderr, "IR: Failed to allocate memory for instruction\n");
+        return false;
+    }
+    ir_list_append(out, inst);
+    return true;
+}
+
+// Регистр с результатом операции над регистрами a и b (b < 0 — унарная операция)
+static bool irgen_flat_compute(ir_list_t *out, ir_op_t op, int a, int b, int *next_reg, int *result) {
+    int reg = (*next_reg)++;
+    bool ok = b < 0 ? irgen_flat_emit(out, op, 2, ir_operand_new_register(reg), ir_operand_new_register(a), NULL)
+                    : irgen_flat_emit(out, op, 3, ir_operand_new_register(reg), ir_operand_new_register(a),
+                                      ir_operand_new_register(b));
+    *result = reg;
+    return ok;
+}
+
+// Выдаёт оператор над операндами values[0 .. rule->operands); *result — регистр значения
+static bool irgen_flat_apply(const irgen_flat_rule_t *rule, const int *values, int *next_reg,
+                             ir_list_t *out, int *result) {
+    bool ok;
+    if (rule->op == IR_OP_NOP) {
+        *result = values[0];
+        return true;
+    }
+    if (rule->operands == 3) {
+        // x BETWEEN lo AND hi => (x >= lo) AND (x <= hi)
+        int low, high;
+        ok = irgen_flat_compute(out, IR_OP_GE, values[0], values[1], next_reg, &low) &&
+             irgen_flat_compute(out, IR_OP_LE, values[0], values[2], next_reg, &high) &&
+             irgen_flat_compute(out, IR_OP_AND, low, high, next_reg, result);
+    } else {
+        ok = irgen_flat_compute(out, rule->op, values[0], rule->operands == 2 ? values[1] : -1, next_reg, result);
+    }
+    if (ok && rule->negated) ok = irgen_flat_compute(out, IR_OP_NOT, *result, -1, next_reg, result);
+    return ok;
+}
+
+// Целое число без знака или со знаком — константа; остальные литералы переносятся текстом
+static ir_operand_t *irgen_flat_literal(const char *text) {
+    if (!text) return ir_operand_new_constant(0);
+    const char *digits = text + (text[0] == '-' || text[0] == '+');
+    bool integer = *digits != '\0';
+    for (const char *c = digits; *c && integer; c++) integer = isdigit((unsigned char)*c);
+    return integer ? ir_operand_new_constant((int)strtol(text, NULL, 10)) : ir_operand_new_string(text);
+}
+
+// Переводит выражение root в инструкции; *result — регистр со значением
+static bool irgen_flat_expression(const ast_flat_t *tree, uint32_t root, int *next_reg,
+                                  ir_list_t *out, int *result) {
+    uint32_t end = ast_flat_end(tree, root);
+    uint32_t size = end - root;
+    uint32_t *frames = malloc((size_t)size * sizeof(uint32_t));   // Ожидающие операторы
+    int *values = malloc((size_t)size * sizeof(int));             // Регистры готовых операндов
+    size_t frame_count = 0, value_count = 0;
+    bool ok = frames && values;
+
+    for (uint32_t index = root; ok && index <= end; index++) {
+        // Операторы, чьё поддерево пройдено, выдаются в порядке закрытия (обратный вход)
+        while (ok && frame_count > 0 && (index == end || ast_flat_end(tree, frames[frame_count - 1]) <= index)) {
+            uint32_t op_index = frames[--frame_count];
+            uint32_t operands = ast_flat_child_count(tree, op_index);
+            const irgen_flat_rule_t *rule = irgen_flat_rule(ast_flat_string(tree, op_index), operands);
+            if (!rule || value_count < operands) {
+                fprintf(stderr, "IR: Unsupported operator '%s' at node %u\n",
+                        ast_flat_string(tree, op_index) ? ast_flat_string(tree, op_index) : "", op_index);
+                ok = false;
+                break;
+            }
+            value_count -= operands;
+            int reg;
+            ok = irgen_flat_apply(rule, values + value_count, next_reg, out, &reg);
+            values[value_count++] = reg;
+        }
+        if (!ok || index == end) break;
+
+        switch (ast_flat_kind(tree, index)) {
+            case AST_LITERAL: {
+                int reg = (*next_reg)++;
+                ok = irgen_flat_emit(out, IR_OP_LOAD, 2, ir_operand_new_register(reg),
+                                     irgen_flat_literal(ast_flat_string(tree, index)), NULL);
+                values[value_count++] = reg;
+                break;
+            }
+            case AST_IDENTIFIER: {
+                int reg = (*next_reg)++;
+                ok = irgen_flat_emit(out, IR_OP_LOAD, 2, ir_operand_new_register(reg),
+                                     ir_operand_new_variable(ast_flat_atom(tree, index)), NULL);
+                values[value_count++] = reg;
+                break;
+            }
+            case AST_OPERATOR:
+                frames[frame_count++] = index;
+                break;
+            case AST_EXPRESSION:
+                // Обёртка без собственной операции: значение даёт её поддерево
+                break;
+            default:
+                fprintf(stderr, "IR: Unsupported expression node type %d at node %u\n",
+                        ast_flat_kind(tree, index), index);
+                ok = false;
+                break;
+        }
+    }
+
+    if (ok && value_count != 1) {
+        fprintf(stderr, "IR: Malformed expression at node %u\n", root);
+        ok = false;
+    }
+    if (ok) *result = values[0];
+    free(frames);
+    free(values);
+    return ok;
+}
+
+// Цель и выражение оператора: присваивание или AST_STATEMENT с атомом
+static bool irgen_flat_assignment(const ast_flat_t *tree, uint32_t stmt, atom_t *target, uint32_t *expression) {
+    switch (ast_flat_kind(tree, stmt)) {
+        case AST_ASSIGNMENT: {
+            if (ast_flat_child_count(tree, stmt) != 2) return false;
+            uint32_t variable = ast_flat_child(tree, stmt, 0);
+            if (ast_flat_kind(tree, variable) != AST_VARIABLE) return false;
+            *target = ast_flat_atom(tree, variable);
+            *expression = ast_flat_child(tree, stmt, 1);
+            return true;
+        }
+        case AST_STATEMENT:
+            if (tree->nodes[stmt].first_child == AST_FLAT_NONE) return false;
+            *target = ast_flat_atom(tree, stmt);
+            *expression = tree->nodes[stmt].first_child;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool irgen_generate_flat(const ast_flat_t *tree, uint32_t root, ir_list_t *out) {
+    if (!tree || !out || root >= tree->count) return false;
+
+    int next_reg = 0;
+    bool ok = true;
+    uint32_t end = ast_flat_end(tree, root);
+    uint32_t first = ast_flat_kind(tree, root) == AST_PROGRAM ? root + 1 : root;
+
+    for (uint32_t stmt = first; stmt < end; stmt = ast_flat_end(tree, stmt)) {
+        atom_t target;
+        uint32_t expression;
+        // Объявления и операторы без перевода кода не дают
+        if (!irgen_flat_assignment(tree, stmt, &target, &expression)) continue;
+
+        int value;
+        if (!irgen_flat_expression(tree, expression, &next_reg, out, &value)) {
+            ok = false;
+            continue;
+        }
+        if (target != ATOM_NONE &&
+            !irgen_flat_emit(out, IR_OP_STORE, 2, ir_operand_new_variable(target),
+                             ir_operand_new_register(value), NULL)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
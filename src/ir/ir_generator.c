@@ -28,7 +28,7 @@ static char *generate_label(IRGenContext *ctx, const char *prefix) {
 static IROperand ir_operand_from_ast_var(ASTNode *node) {
     IROperand op;
     op.type = IR_OPERAND_VAR;
-    strncpy(op.name, node->var_name, sizeof(op.name));
+    op.var = node->atom;  // имя переменной передаётся атомом, без копирования строки
     return op;
 }
 
@@ -0,0 +1,268 @@
+#include "atom.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file atom.c
+ * @brief Таблица интернированных идентификаторов.
+ *
+ * Устройство:
+ *  - описатели атомов лежат в страницах фиксированного размера, поэтому
+ *    адрес описателя не меняется и atom_text() работает без блокировки;
+ *  - тексты имён размещаются подряд в крупных блоках (без отдельного malloc на имя);
+ *  - индекс — хеш-таблица с открытой адресацией, хранящая номера атомов.
+ *
+ * Поиск уже интернированного имени идёт без блокировки: индекс публикуется
+ * указателем, слот заполняется только после того, как описатель атома записан,
+ * а при росте индекса старая таблица не освобождается до atom_table_free(), так
+ * что читатель, взявший её, дочитывает корректные данные. Блокировка нужна только
+ * вставке: промах на опубликованном индексе повторяется под ней.
+ */
+
+#define ATOM_PAGE_BITS      12
+#define ATOM_PAGE_SIZE      (1u << ATOM_PAGE_BITS)
+#define ATOM_MAX_PAGES      16384
+#define ATOM_CHUNK_SIZE     (64 * 1024)
+#define ATOM_INITIAL_SLOTS  1024
+
+// Описатель атома
+typedef struct {
+    const char *text;   // Написание в верхнем регистре, завершено нулём
+    uint32_t length;    // Длина написания
+    uint32_t hash;      // Хеш написания (чтобы не пересчитывать при росте индекса)
+} atom_entry_t;
+
+// Индекс: номера атомов, 0 — пустой слот. Заменённые при росте таблицы
+// остаются в цепочке retired до atom_table_free()
+typedef struct atom_index {
+    struct atom_index *retired;
+    uint32_t mask;
+    uint32_t slots[];
+} atom_index_t;
+
+// Блок памяти для текстов имён
+typedef struct atom_chunk {
+    struct atom_chunk *next;
+    size_t used;
+    size_t capacity;
+    char data[];
+} atom_chunk_t;
+
+static pthread_mutex_t atom_lock = PTHREAD_MUTEX_INITIALIZER;
+static atom_entry_t *atom_pages[ATOM_MAX_PAGES];
+static uint32_t atom_next = 1;          // Атом 0 зарезервирован под ATOM_NONE
+static atom_index_t *atom_index = NULL; // Опубликованный индекс (меняется под блокировкой)
+static atom_chunk_t *atom_chunks = NULL;
+
+// Приведение ASCII-буквы к верхнему регистру (как в keywords.c)
+static inline unsigned char atom_fold(unsigned char c) {
+    return (unsigned char)(c - (((unsigned)(c - 'a') < 26u) << 5));
+}
+
+// FNV-1a по символам, приведённым к верхнему регистру
+static uint32_t atom_hash(const char *text, size_t length) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ atom_fold((unsigned char)text[i])) * 16777619u;
+    }
+    return h;
+}
+
+static inline atom_entry_t *atom_entry(atom_t atom) {
+    return &atom_pages[atom >> ATOM_PAGE_BITS][atom & (ATOM_PAGE_SIZE - 1)];
+}
+
+// Сравнивает имя с каноническим написанием атома без учёта регистра
+static int atom_matches(const atom_entry_t *entry, const char *text, size_t length) {
+    if (entry->length != length) return 0;
+    for (size_t i = 0; i < length; i++) {
+        if (atom_fold((unsigned char)text[i]) != (unsigned char)entry->text[i]) return 0;
+    }
+    return 1;
+}
+
+// Поиск слота индекса: либо слот с совпадающим атомом, либо первый пустой.
+// Читает без блокировки: непустой слот указывает на уже записанный описатель
+static uint32_t *atom_probe(atom_index_t *index, const char *text, size_t length, uint32_t hash) {
+    uint32_t position = hash & index->mask;
+    for (;;) {
+        uint32_t *slot = &index->slots[position];
+        atom_t atom = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+        if (atom == ATOM_NONE) return slot;
+        const atom_entry_t *entry = atom_entry(atom);
+        if (entry->hash == hash && atom_matches(entry, text, length)) return slot;
+        position = (position + 1) & index->mask;
+    }
+}
+
+// Поиск по опубликованному индексу без блокировки; ATOM_NONE — промах
+static atom_t atom_lookup(const char *text, size_t length, uint32_t hash) {
+    atom_index_t *index = __atomic_load_n(&atom_index, __ATOMIC_ACQUIRE);
+    return index ? __atomic_load_n(atom_probe(index, text, length, hash), __ATOMIC_ACQUIRE) : ATOM_NONE;
+}
+
+// Увеличивает индекс вдвое (вызывается под блокировкой). Новая таблица заполняется
+// целиком до публикации; старая остаётся читателям, которые её уже взяли
+static int atom_grow_index(void) {
+    uint32_t capacity = atom_index ? (atom_index->mask + 1) * 2 : ATOM_INITIAL_SLOTS;
+    atom_index_t *index = calloc(1, sizeof(atom_index_t) + (size_t)capacity * sizeof(uint32_t));
+    if (!index) return 0;
+
+    index->mask = capacity - 1;
+    for (uint32_t atom = 1; atom < atom_next; atom++) {
+        uint32_t position = atom_entry(atom)->hash & index->mask;
+        while (index->slots[position] != ATOM_NONE) position = (position + 1) & index->mask;
+        index->slots[position] = atom;
+    }
+    index->retired = atom_index;
+    __atomic_store_n(&atom_index, index, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// Копирует имя в верхнем регистре в блок текстов (вызывается под блокировкой)
+static const char *atom_store_text(const char *text, size_t length) {
+    if (!atom_chunks || atom_chunks->capacity - atom_chunks->used < length + 1) {
+        size_t capacity = length + 1 > ATOM_CHUNK_SIZE ? length + 1 : ATOM_CHUNK_SIZE;
+        atom_chunk_t *chunk = malloc(sizeof(atom_chunk_t) + capacity);
+        if (!chunk) return NULL;
+        chunk->next = atom_chunks;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        atom_chunks = chunk;
+    }
+    char *copy = atom_chunks->data + atom_chunks->used;
+    for (size_t i = 0; i < length; i++) {
+        copy[i] = (char)atom_fold((unsigned char)text[i]);
+    }
+    copy[length] = '\0';
+    atom_chunks->used += length + 1;
+    return copy;
+}
+
+/**
+ * @brief Интернирует идентификатор (регистронезависимо).
+ */
+atom_t atom_intern(const char *text, size_t length) {
+    if (!text || length == 0 || length > UINT32_MAX) return ATOM_NONE;
+
+    uint32_t hash = atom_hash(text, length);
+    atom_t existing = atom_lookup(text, length, hash);
+    if (existing != ATOM_NONE) return existing;
+
+    // Промах: имя могли вставить после того, как был взят индекс, — повтор под блокировкой
+    pthread_mutex_lock(&atom_lock);
+
+    // Индекс заполняется не более чем наполовину
+    if ((!atom_index || (atom_next + 1) * 2 > atom_index->mask + 1) && !atom_grow_index()) {
+        pthread_mutex_unlock(&atom_lock);
+        fprintf(stderr, "Out of memory while interning identifier\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint32_t *slot = atom_probe(atom_index, text, length, hash);
+    if (*slot != ATOM_NONE) {
+        atom_t found = *slot;
+        pthread_mutex_unlock(&atom_lock);
+        return found;
+    }
+
+    atom_t atom = atom_next;
+    uint32_t page = atom >> ATOM_PAGE_BITS;
+    if (page >= ATOM_MAX_PAGES) {
+        pthread_mutex_unlock(&atom_lock);
+        fprintf(stderr, "Too many distinct identifiers\n");
+        exit(EXIT_FAILURE);
+    }
+    if (!atom_pages[page]) {
+        atom_pages[page] = malloc(ATOM_PAGE_SIZE * sizeof(atom_entry_t));
+    }
+    const char *copy = atom_pages[page] ? atom_store_text(text, length) : NULL;
+    if (!copy) {
+        pthread_mutex_unlock(&atom_lock);
+        fprintf(stderr, "Out of memory while interning identifier\n");
+        exit(EXIT_FAILURE);
+    }
+
+    atom_entry_t *entry = atom_entry(atom);
+    entry->text = copy;
+    entry->length = (uint32_t)length;
+    entry->hash = hash;
+    // Публикуем новый атом: сначала для atom_text(), затем в индексе, чтобы найденный
+    // без блокировки атом уже был меньше atom_next
+    __atomic_store_n(&atom_next, atom + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(slot, atom, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&atom_lock);
+    return atom;
+}
+
+/**
+ * @brief Интернирует C-строку, завершённую нулём.
+ */
+atom_t atom_intern_cstr(const char *text) {
+    return text ? atom_intern(text, strlen(text)) : ATOM_NONE;
+}
+
+/**
+ * @brief Ищет уже интернированное имя, не добавляя его в таблицу.
+ */
+atom_t atom_find(const char *text, size_t length) {
+    if (!text || length == 0) return ATOM_NONE;
+
+    uint32_t hash = atom_hash(text, length);
+    atom_t atom = atom_lookup(text, length, hash);
+    if (atom != ATOM_NONE) return atom;
+
+    pthread_mutex_lock(&atom_lock);
+    atom = atom_index ? *atom_probe(atom_index, text, length, hash) : ATOM_NONE;
+    pthread_mutex_unlock(&atom_lock);
+    return atom;
+}
+
+/**
+ * @brief Каноническое написание атома.
+ */
+const char *atom_text(atom_t atom) {
+    if (atom == ATOM_NONE || atom >= __atomic_load_n(&atom_next, __ATOMIC_ACQUIRE)) return "";
+    return atom_entry(atom)->text;
+}
+
+/**
+ * @brief Длина канонического написания атома.
+ */
+uint32_t atom_length(atom_t atom) {
+    if (atom == ATOM_NONE || atom >= __atomic_load_n(&atom_next, __ATOMIC_ACQUIRE)) return 0;
+    return atom_entry(atom)->length;
+}
+
+/**
+ * @brief Количество интернированных имён.
+ */
+size_t atom_count(void) {
+    return __atomic_load_n(&atom_next, __ATOMIC_ACQUIRE) - 1;
+}
+
+/**
+ * @brief Освобождает таблицу целиком.
+ */
+void atom_table_free(void) {
+    pthread_mutex_lock(&atom_lock);
+    for (uint32_t page = 0; page < ATOM_MAX_PAGES && atom_pages[page]; page++) {
+        free(atom_pages[page]);
+        atom_pages[page] = NULL;
+    }
+    while (atom_chunks) {
+        atom_chunk_t *next = atom_chunks->next;
+        free(atom_chunks);
+        atom_chunks = next;
+    }
+    while (atom_index) {
+        atom_index_t *retired = atom_index->retired;
+        free(atom_index);
+        atom_index = retired;
+    }
+    atom_next = 1;
+    pthread_mutex_unlock(&atom_lock);
+}
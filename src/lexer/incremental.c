@@ -0,0 +1,117 @@
+#include "lexer_incremental.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @file incremental.c
+ * @brief Перелексирование повреждённого правкой участка и вклейка результата в поток.
+ *
+ * Лексер ABAP между токенами не хранит состояния: следующий токен определяется
+ * только текстом с текущей позиции. Поэтому
+ *  - лексику можно продолжить с конца любого токена, чьё распознавание не заглядывало
+ *    в правку (включая просмотр вперёд для FIELD-SYMBOLS, 1.5, <=);
+ *  - как только новый токен начинается за правкой ровно там, где начинался старый,
+ *    все дальнейшие токены совпадают со старыми, сдвинутыми на разницу длин.
+ * Шаблон строки |...{ выражение }...| — один токен, даже многострочный, поэтому правка
+ * внутри шаблона или его встроенного выражения перелексирует шаблон целиком, начиная
+ * с токена перед открывающей чертой, а позиции внутри старого шаблона точками
+ * синхронизации не служат.
+ */
+
+// Начало области токена в тексте: у строкового литерала — открывающая кавычка
+static size_t relex_region_start(const TokenStream *stream, int index) {
+    uint32_t offset = token_stream_offset_at(stream, index);
+    return token_stream_type_at(stream, index) == TOKEN_LITERAL_STRING ? offset - 1 : offset;
+}
+
+// Конец области токена: у строкового литерала — после закрывающей кавычки
+static size_t relex_region_end(const TokenStream *stream, int index) {
+    size_t end = token_stream_offset_at(stream, index) + (size_t)token_stream_length_at(stream, index);
+    return token_stream_type_at(stream, index) == TOKEN_LITERAL_STRING ? end + 1 : end;
+}
+
+static bool relex_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Первый токен, область которого заканчивается не раньше from (бинарный поиск)
+static int relex_first_ending_at(const TokenStream *stream, size_t from) {
+    int lo = 0, hi = stream->token_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (relex_region_end(stream, mid) < from) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Перелексирует участок текста, затронутый правкой, и обновляет поток.
+ */
+bool lexer_relex(TokenStream *stream, const char *source, size_t length,
+                 const source_edit_t *edit, lexer_relex_result_t *result) {
+    if (!stream || !source || !edit) return false;
+    if (edit->offset + edit->removed > stream->source_length ||
+        length != stream->source_length - edit->removed + edit->inserted) {
+        fprintf(stderr, "Edit does not match the token stream source\n");
+        return false;
+    }
+
+    // Правка работает с физическими индексами; раскрытие цепочек строится заново после неё
+    token_stream_clear_chains(stream);
+
+    // Начало слова, в которое попала правка. Текст до правки не изменился, поэтому
+    // читается из нового буфера. Токен, закончившийся до пробела перед этим словом,
+    // распознан без просмотра правки.
+    size_t word_start = edit->offset;
+    while (word_start > 0 && !relex_is_space(source[word_start - 1])) word_start--;
+
+    int first = relex_first_ending_at(stream, word_start);
+    size_t restart = first > 0 ? relex_region_end(stream, first - 1) : 0;
+
+    TokenStream fresh;
+    token_stream_init(&fresh, source, length);
+    lexer_t lexer;
+    lexer_init_at(&lexer, source, length, restart);
+
+    // Старые токены, начинающиеся до точки синхронизации, заменяются
+    size_t edit_end = edit->offset + edit->inserted;
+    int old_index = first;
+    for (;;) {
+        token_t token = lexer_next_token(&lexer);
+        if (token.type == TOKEN_EOF) {
+            old_index = stream->token_count;
+            break;
+        }
+
+        size_t start = token.type == TOKEN_LITERAL_STRING ? (size_t)token.offset - 1 : token.offset;
+        if (start >= edit_end) {
+            // Та же позиция в координатах старого текста
+            size_t old_start = start - edit->inserted + edit->removed;
+            while (old_index < stream->token_count && relex_region_start(stream, old_index) < old_start) {
+                old_index++;
+            }
+            if (old_index < stream->token_count && relex_region_start(stream, old_index) == old_start) {
+                break;
+            }
+        }
+
+        if (!token_stream_push(&fresh, &token)) {
+            fprintf(stderr, "Out of memory while relexing edited source\n");
+            token_stream_free(&fresh);
+            return false;
+        }
+    }
+
+    size_t relexed = lexer.pos - restart;
+    bool ok = token_stream_edit(stream, source, length, edit, first, old_index - first, &fresh);
+    if (ok && result) {
+        result->first = first;
+        result->removed = old_index - first;
+        result->inserted = fresh.token_count;
+        result->relexed = relexed;
+    }
+    token_stream_free(&fresh);
+    lexer_free(&lexer);
+    return ok;
+}
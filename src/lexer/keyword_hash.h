@@ -0,0 +1,280 @@
+// Сгенерировано scripts/gen_keyword_hash.py из include/abap_keywords.h — не редактировать вручную.
+// Подключается только из src/lexer/keywords.c.
+
+#ifndef KEYWORD_HASH_H
+#define KEYWORD_HASH_H
+
+#define KEYWORD_HASH_SEED    0x811C9DC6u
+#define KEYWORD_BUCKETS      64u
+#define KEYWORD_BUCKET_BITS  6
+#define KEYWORD_SLOTS        256u
+#define KEYWORD_MIN_LENGTH   2
+#define KEYWORD_MAX_LENGTH   15
+
+static const uint8_t keyword_displacement[KEYWORD_BUCKETS] = {
+      1,   0,   0,   2,   0,   0,   1,   1,   0,   0,   3,   0,   0,   3,   0,   1,
+      0,   0,   1,   0,   0,   0,   0,   0,   2,   1,   0,   0,   0,   3,   0,   3,
+      0,   1,   0,   0,   0,   0,   4,   1,   0,   6,   0,   0,   2,   1,   1,   2,
+      0,   2,   2,   4,   1,   4,   0,   0,   1,   0,   0,   0,   5,   2,   1,  10,
+};
+
+static const keyword_entry_t keyword_table[KEYWORD_SLOTS] = {
+    { "INTO", 4, TOKEN_KEYWORD_INTO },
+    { "ATTRIBUTES", 10, TOKEN_KEYWORD_ATTRIBUTES },
+    { "METHODS", 7, TOKEN_KEYWORD_METHODS },
+    { "ON", 2, TOKEN_KEYWORD_ON },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "AUTHORITY-CHECK", 15, TOKEN_KEYWORD_AUTHORITY_CHECK },
+    { "LE", 2, TOKEN_OPERATOR_LE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "DELETE", 6, TOKEN_KEYWORD_DELETE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "ENDFUNCTION", 11, TOKEN_KEYWORD_ENDFUNCTION },
+    { "FALSE", 5, TOKEN_KEYWORD_FALSE },
+    { "ENDCASE", 7, TOKEN_KEYWORD_ENDCASE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "ENDMETHOD", 9, TOKEN_KEYWORD_ENDMETHOD },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "CASE", 4, TOKEN_KEYWORD_CASE },
+    { "PROTECTED", 9, TOKEN_KEYWORD_PROTECTED },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "METHOD", 6, TOKEN_KEYWORD_METHOD },
+    { "INTERFACES", 10, TOKEN_KEYWORD_INTERFACES },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "APPEND", 6, TOKEN_KEYWORD_APPEND },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "RANGES", 6, TOKEN_KEYWORD_RANGES },
+    { "START", 5, TOKEN_KEYWORD_START },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "DEFINITION", 10, TOKEN_KEYWORD_DEFINITION },
+    { "CALL", 4, TOKEN_KEYWORD_CALL },
+    { "JOIN", 4, TOKEN_KEYWORD_JOIN },
+    { "FROM", 4, TOKEN_KEYWORD_FROM },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "LOOP", 4, TOKEN_KEYWORD_LOOP },
+    { "EXPORT", 6, TOKEN_KEYWORD_EXPORT },
+    { "MESSAGE", 7, TOKEN_KEYWORD_MESSAGE },
+    { "VALUE", 5, TOKEN_KEYWORD_VALUE },
+    { "SET", 3, TOKEN_KEYWORD_SET },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "THROW", 5, TOKEN_KEYWORD_THROW },
+    { "CLEAR", 5, TOKEN_KEYWORD_CLEAR },
+    { "MODIFY", 6, TOKEN_KEYWORD_MODIFY },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "MODULE", 6, TOKEN_KEYWORD_MODULE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "WHEN", 4, TOKEN_KEYWORD_WHEN },
+    { "FORM", 4, TOKEN_KEYWORD_FORM },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "WHERE", 5, TOKEN_KEYWORD_WHERE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "OF", 2, TOKEN_KEYWORD_OF },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "ENDIF", 5, TOKEN_KEYWORD_ENDIF },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "ENDCLASS", 8, TOKEN_KEYWORD_ENDCLASS },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "PERFORM", 7, TOKEN_KEYWORD_PERFORM },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "IS", 2, TOKEN_KEYWORD_IS },
+    { "CREATE", 6, TOKEN_KEYWORD_CREATE },
+    { "WITH", 4, TOKEN_KEYWORD_WITH },
+    { "EQ", 2, TOKEN_OPERATOR_EQ },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "CHANGING", 8, TOKEN_KEYWORD_CHANGING },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "TABLES", 6, TOKEN_KEYWORD_TABLES },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "SECTION", 7, TOKEN_KEYWORD_SECTION },
+    { "TO", 2, TOKEN_KEYWORD_TO },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "ABORT", 5, TOKEN_KEYWORD_ABORT },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "SWITCH", 6, TOKEN_KEYWORD_SWITCH },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "WHILE", 5, TOKEN_KEYWORD_WHILE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "EXCEPTIONS", 10, TOKEN_KEYWORD_EXCEPTIONS },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "NE", 2, TOKEN_OPERATOR_NEQ },
+    { "CLEANUP", 7, TOKEN_KEYWORD_CLEANUP },
+    { "TYPES", 5, TOKEN_KEYWORD_TYPES },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "KEY", 3, TOKEN_KEYWORD_KEY },
+    { "CHECK", 5, TOKEN_KEYWORD_CHECK },
+    { "PARAMETERS", 10, TOKEN_KEYWORD_PARAMETERS },
+    { "ENDTRY", 6, TOKEN_KEYWORD_ENDTRY },
+    { "IN", 2, TOKEN_KEYWORD_IN },
+    { "NOT", 3, TOKEN_OPERATOR_NOT },
+    { "CLASS", 5, TOKEN_KEYWORD_CLASS },
+    { "DEFAULT", 7, TOKEN_KEYWORD_DEFAULT },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "PRIVATE", 7, TOKEN_KEYWORD_PRIVATE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "IMPLEMENTATION", 14, TOKEN_KEYWORD_IMPLEMENTATION },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "FUNCTION", 8, TOKEN_KEYWORD_FUNCTION },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "RAISING", 7, TOKEN_KEYWORD_RAISING },
+    { "WRITE", 5, TOKEN_KEYWORD_WRITE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "COMMIT", 6, TOKEN_KEYWORD_COMMIT },
+    { "MOD", 3, TOKEN_OPERATOR_MODULO },
+    { "PROCEDURE", 9, TOKEN_KEYWORD_PROCEDURE },
+    { "EXIT", 4, TOKEN_KEYWORD_EXIT },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "OR", 2, TOKEN_OPERATOR_OR },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "SELECT", 6, TOKEN_KEYWORD_SELECT },
+    { "USING", 5, TOKEN_KEYWORD_USING },
+    { "RETURN", 6, TOKEN_KEYWORD_RETURN },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "EXPORTING", 9, TOKEN_KEYWORD_EXPORTING },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "GT", 2, TOKEN_OPERATOR_GT },
+    { "ENDLOOP", 7, TOKEN_KEYWORD_ENDLOOP },
+    { "ENDSELECT", 9, TOKEN_KEYWORD_ENDSELECT },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "LT", 2, TOKEN_OPERATOR_LT },
+    { "ENDMODULE", 9, TOKEN_KEYWORD_ENDMODULE },
+    { "IF", 2, TOKEN_KEYWORD_IF },
+    { "TABLE", 5, TOKEN_KEYWORD_TABLE },
+    { "CLOSE", 5, TOKEN_KEYWORD_CLOSE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "EVENT", 5, TOKEN_KEYWORD_EVENT },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "PUBLIC", 6, TOKEN_KEYWORD_PUBLIC },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "BETWEEN", 7, TOKEN_KEYWORD_BETWEEN },
+    { "ELSE", 4, TOKEN_KEYWORD_ELSE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "DATA", 4, TOKEN_KEYWORD_DATA },
+    { "ENDWHILE", 8, TOKEN_KEYWORD_ENDWHILE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "BEGIN", 5, TOKEN_KEYWORD_BEGIN },
+    { "SELECT-OPTIONS", 14, TOKEN_KEYWORD_SELECT_OPTIONS },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "STRUCTURES", 10, TOKEN_KEYWORD_STRUCTURES },
+    { "BY", 2, TOKEN_KEYWORD_BY },
+    { "FIELD-SYMBOLS", 13, TOKEN_KEYWORD_FIELD_SYMBOLS },
+    { "BREAK", 5, TOKEN_KEYWORD_BREAK },
+    { "INTERFACE", 9, TOKEN_KEYWORD_INTERFACE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "IMPORT", 6, TOKEN_KEYWORD_IMPORT },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "AND", 3, TOKEN_OPERATOR_AND },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "SORT", 4, TOKEN_KEYWORD_SORT },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "ENDDO", 5, TOKEN_KEYWORD_ENDDO },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "ENDFORM", 7, TOKEN_KEYWORD_ENDFORM },
+    { "TRUE", 4, TOKEN_KEYWORD_TRUE },
+    { "TRY", 3, TOKEN_KEYWORD_TRY },
+    { "READ", 4, TOKEN_KEYWORD_READ },
+    { "IMPORTING", 9, TOKEN_KEYWORD_IMPORTING },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "ACCEPT", 6, TOKEN_KEYWORD_ACCEPT },
+    { "ENDINTERFACE", 12, TOKEN_KEYWORD_ENDINTERFACE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "CATCH", 5, TOKEN_KEYWORD_CATCH },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "ELSEIF", 6, TOKEN_KEYWORD_ELSEIF },
+    { "THEN", 4, TOKEN_KEYWORD_THEN },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "REFRESH", 7, TOKEN_KEYWORD_REFRESH },
+    { "STOP", 4, TOKEN_KEYWORD_STOP },
+    { "LIKE", 4, TOKEN_KEYWORD_LIKE },
+    { "DO", 2, TOKEN_KEYWORD_DO },
+    { "SUBMIT", 6, TOKEN_KEYWORD_SUBMIT },
+    { "END", 3, TOKEN_KEYWORD_END },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "RAISE", 5, TOKEN_KEYWORD_RAISE },
+    { "INSERT", 6, TOKEN_KEYWORD_INSERT },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "CONTINUE", 8, TOKEN_KEYWORD_CONTINUE },
+    { "TYPE", 4, TOKEN_KEYWORD_TYPE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "RETURNING", 9, TOKEN_KEYWORD_RETURNING },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "CONSTANTS", 9, TOKEN_KEYWORD_CONSTANTS },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "GE", 2, TOKEN_OPERATOR_GE },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { "INITIAL", 7, TOKEN_KEYWORD_INITIAL },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+    { NULL, 0, TOKEN_IDENTIFIER },
+};
+
+#endif // KEYWORD_HASH_H
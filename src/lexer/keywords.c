@@ -0,0 +1,68 @@
+#include "abap_keywords.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file keywords.c
+ * @brief Распознавание ключевых слов ABAP по совершенной хеш-таблице.
+ *
+ * Таблица строится скриптом scripts/gen_keyword_hash.py по include/abap_keywords.h.
+ * Поиск: один проход по символам с приведением к верхнему регистру (хеш FNV-1a),
+ * одно обращение к таблице и одно сравнение с найденным кандидатом.
+ */
+
+// Элемент таблицы ключевых слов
+typedef struct {
+    const char *text;   // Написание в верхнем регистре (NULL — пустой слот)
+    uint8_t length;     // Длина написания
+    TokenType type;     // Тип токена
+} keyword_entry_t;
+
+#include "keyword_hash.h"
+
+// Приведение ASCII-буквы к верхнему регистру без ветвлений и таблиц локали
+static inline unsigned char keyword_fold(unsigned char c) {
+    return (unsigned char)(c - (((unsigned)(c - 'a') < 26u) << 5));
+}
+
+/**
+ * @brief Распознаёт ключевое слово ABAP (регистронезависимо).
+ */
+TokenType abap_keyword_lookup(const char *text, size_t length) {
+    if (length < KEYWORD_MIN_LENGTH || length > KEYWORD_MAX_LENGTH) {
+        return TOKEN_IDENTIFIER;
+    }
+
+    uint32_t h = KEYWORD_HASH_SEED;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ keyword_fold((unsigned char)text[i])) * 16777619u;
+    }
+
+    uint32_t bucket = h & (KEYWORD_BUCKETS - 1);
+    uint32_t slot = ((h >> KEYWORD_BUCKET_BITS) ^ keyword_displacement[bucket]) & (KEYWORD_SLOTS - 1);
+    const keyword_entry_t *entry = &keyword_table[slot];
+
+    if (entry->length != length) {
+        return TOKEN_IDENTIFIER;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (keyword_fold((unsigned char)text[i]) != (unsigned char)entry->text[i]) {
+            return TOKEN_IDENTIFIER;
+        }
+    }
+    return entry->type;
+}
+
+/**
+ * @brief Написание ключевого слова по типу токена (для диагностики, не для горячего пути).
+ */
+const char *abap_keyword_spelling(TokenType type) {
+    switch (type) {
+#define ABAP_KEYWORD_CASE(text, token) case token: return text;
+        ABAP_KEYWORD_LIST(ABAP_KEYWORD_CASE)
+        ABAP_WORD_OPERATOR_LIST(ABAP_KEYWORD_CASE)
+#undef ABAP_KEYWORD_CASE
+        default:
+            return NULL;
+    }
+}
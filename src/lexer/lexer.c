@@ -341,171 +341,324 @@ static void lexer_skip_comment(Lexer *lexer) {
 */
 
 #include "lexer.h"
+#include "lexer_scan.h"
+#include "abap_keywords.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
-#define MAX_LEXEME_LEN 256
-
 // Вспомогательные функции
 
-static bool is_keyword(const char *str) {
-    // Простейший пример ключевых слов ABAP
-    static const char *keywords[] = {
-        "IF", "ELSE", "ENDIF", "LOOP", "WHILE", "DO",
-        "PERFORM", "DATA", "TYPES", "CONSTANTS",
-        "CLASS", "INTERFACE", "FUNCTION", "CALL",
-        NULL
-    };
-    for (int i = 0; keywords[i]; i++) {
-        if (strcmp(str, keywords[i]) == 0) {
-            return true;
-        }
+// Найти число переводов строк, предшествующих offset (бинарный поиск по индексу)
+static size_t lexer_lines_before(const lexer_t *lexer, size_t offset) {
+    size_t lo = 0, hi = lexer->newline_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (lexer->newlines[mid] < offset) lo = mid + 1;
+        else hi = mid;
     }
-    return false;
+    return lo;
 }
 
-// Создать токен с копией лексемы
-static token_t create_token(token_type_t type, const char *lexeme, int line, int column) {
+// Создать токен-срез исходного буфера: лексема не копируется.
+// Токены выдаются по возрастанию смещений, поэтому курсор по индексу строк
+// только продвигается вперёд — в сумме O(1) на токен.
+static token_t make_token(lexer_t *lexer, token_type_t type, size_t start, size_t end) {
+    while (lexer->line_cursor < lexer->newline_count &&
+           lexer->newlines[lexer->line_cursor] < start) {
+        lexer->line_cursor++;
+    }
+    size_t line_start = lexer->line_cursor ? lexer->newlines[lexer->line_cursor - 1] + 1 : 0;
+
     token_t token;
     token.type = type;
-    token.line = line;
-    token.column = column;
-    token.lexeme = malloc(strlen(lexeme) + 1);
-    if (token.lexeme)
-        strcpy(token.lexeme, lexeme);
-    else
-        token.lexeme = NULL;
+    token.offset = (uint32_t)start;
+    token.length = (uint32_t)(end - start);
+    token.line = (int)lexer->line_cursor + 1;
+    token.column = (int)(start - line_start) + 1;
+    token.atom = ATOM_NONE;
     return token;
 }
 
-void lexer_init(lexer_t *lexer, const char *source) {
+void lexer_init(lexer_t *lexer, const char *source, size_t length) {
+    const lexer_scan_ops_t *scan = lexer_scan_ops();
+
     lexer->source = source;
+    lexer->length = length;
     lexer->pos = 0;
-    lexer->line = 1;
-    lexer->column = 1;
+    lexer->line_cursor = 0;
+
+    // Индекс строк: первый проход считает переводы строк, второй — записывает смещения
+    lexer->newline_count = scan->newlines(source, length, NULL);
+    lexer->newlines = NULL;
+    if (lexer->newline_count) {
+        lexer->newlines = malloc(lexer->newline_count * sizeof(uint32_t));
+        if (!lexer->newlines) {
+            fprintf(stderr, "Out of memory while indexing source lines\n");
+            exit(EXIT_FAILURE);
+        }
+        scan->newlines(source, length, lexer->newlines);
+    }
+}
+
+void lexer_init_at(lexer_t *lexer, const char *source, size_t length, size_t pos) {
+    lexer->source = source;
+    lexer->length = length;
+    lexer->pos = pos < length ? pos : length;
+    lexer->newlines = NULL;
+    lexer->newline_count = 0;
+    lexer->line_cursor = 0;
+}
+
+void lexer_free(lexer_t *lexer) {
+    if (!lexer) return;
+    free(lexer->newlines);
+    lexer->newlines = NULL;
+    lexer->newline_count = 0;
+    lexer->line_cursor = 0;
 }
 
-void token_free(token_t *token) {
-    if (token->lexeme) {
-        free(token->lexeme);
-        token->lexeme = NULL;
+bool lexer_init_file(lexer_t *lexer, source_buffer_t *buffer, const char *path) {
+    if (!source_buffer_open(buffer, path)) {
+        return false;
     }
+    lexer_init(lexer, buffer->data, buffer->length);
+    return true;
+}
+
+void lexer_offset_to_position(const lexer_t *lexer, size_t offset, int *line, int *column) {
+    size_t before = lexer_lines_before(lexer, offset);
+    size_t line_start = before ? lexer->newlines[before - 1] + 1 : 0;
+    if (line) *line = (int)before + 1;
+    if (column) *column = (int)(offset - line_start) + 1;
+}
+
+const char *lexer_token_text(const lexer_t *lexer, const token_t *token) {
+    return lexer->source + token->offset;
+}
+
+char *lexer_token_strdup(const lexer_t *lexer, const token_t *token) {
+    char *copy = malloc((size_t)token->length + 1);
+    if (!copy)
+        return NULL;
+    memcpy(copy, lexer->source + token->offset, token->length);
+    copy[token->length] = '\0';
+    return copy;
 }
 
-// Получаем текущий символ
+// Получаем текущий символ.
+// Отображённый файл не завершается нулём, поэтому конец текста определяется по длине.
 static char lexer_peek(lexer_t *lexer) {
-    return lexer->source[lexer->pos];
+    return lexer->pos < lexer->length ? lexer->source[lexer->pos] : '\0';
+}
+
+// Просмотр символа со смещением от текущей позиции
+static char lexer_peek_at(lexer_t *lexer, size_t offset) {
+    return lexer->pos + offset < lexer->length ? lexer->source[lexer->pos + offset] : '\0';
 }
 
 // Сдвигаем позицию вперед и возвращаем символ
 static char lexer_advance(lexer_t *lexer) {
-    char c = lexer->source[lexer->pos];
-    if (c == '\n') {
-        lexer->line++;
-        lexer->column = 1;
-    } else {
-        lexer->column++;
-    }
-    lexer->pos++;
-    return c;
+    return lexer->source[lexer->pos++];
+}
+
+// Оставшийся текст от текущей позиции
+static const char *lexer_rest(lexer_t *lexer, size_t *remaining) {
+    *remaining = lexer->length - lexer->pos;
+    return lexer->source + lexer->pos;
 }
 
 // Пропускаем пробелы и комментарии
-static void lexer_skip_whitespace_and_comments(lexer_t *lexer) {
-    while (true) {
+static void lexer_skip_whitespace_and_comments(lexer_t *lexer, const lexer_scan_ops_t *scan) {
+    while (lexer->pos < lexer->length) {
+        size_t remaining;
+        const char *rest = lexer_rest(lexer, &remaining);
+
+        // Пробельные символы — целыми отрезками по 16/32 байта
+        lexer->pos += scan->whitespace(rest, remaining);
+
         char c = lexer_peek(lexer);
-        // Пробельные символы
-        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
-            lexer_advance(lexer);
-            continue;
-        }
-        // Комментарии в ABAP начинаются с "*"
-        if (c == '*') {
+        // Комментарии в ABAP: "*" в первой колонке или '"' в любом месте строки
+        bool line_start = lexer->pos == 0 || lexer->source[lexer->pos - 1] == '\n';
+        if ((c == '*' && line_start) || c == '"') {
             // Пропускаем до конца строки
-            while (lexer_peek(lexer) != '\0' && lexer_peek(lexer) != '\n') {
-                lexer_advance(lexer);
-            }
+            rest = lexer_rest(lexer, &remaining);
+            lexer->pos += scan->find_char(rest, remaining, '\n');
             continue;
         }
         break;
     }
 }
 
+// Конец шаблона строки |...|, начинающегося в pos: позиция после закрывающей черты
+// (*closed = true) или length, если шаблон не закрыт. Шаблон может занимать несколько строк.
+// Текст шаблона и встроенные выражения { ... } строго чередуются, поэтому вложенность
+// описывается одним счётчиком: нечётный уровень — текст, чётный — выражение.
+// В тексте '\' экранирует следующий символ; в выражении пропускаются литералы в
+// кавычках, комментарии '"' и вложенные шаблоны.
+static size_t lexer_template_end(const char *source, size_t length, size_t pos, bool *closed) {
+    const lexer_scan_ops_t *scan = lexer_scan_ops();
+    size_t level = 1;
+    *closed = false;
+    pos++; // открывающая черта
+    while (pos < length) {
+        char c = source[pos++];
+        if (level % 2 == 1) {
+            if (c == '\\') {
+                if (pos < length) pos++;
+            } else if (c == '|') {
+                if (--level == 0) {
+                    *closed = true;
+                    return pos;
+                }
+            } else if (c == '{') {
+                level++;
+            }
+        } else if (c == '}') {
+            level--;
+        } else if (c == '|') {
+            level++;
+        } else if (c == '\'' || c == '`') {
+            pos += scan->find_char(source + pos, length - pos, c);
+            if (pos < length) pos++;
+        } else if (c == '"') {
+            pos += scan->find_char(source + pos, length - pos, '\n');
+        }
+    }
+    return length;
+}
+
+// Операторы и спецсимволы: однобайтовые и двухбайтовые (**, <=, >=, <>, &&)
+static token_type_t lexer_scan_operator(lexer_t *lexer) {
+    char c = lexer_advance(lexer);
+    char next = lexer_peek(lexer);
+    switch (c) {
+        case '+': return TOKEN_OPERATOR_PLUS;
+        case '-': return TOKEN_OPERATOR_MINUS;
+        case '/': return TOKEN_OPERATOR_DIVIDE;
+        case '*':
+            if (next == '*') { lexer_advance(lexer); return TOKEN_OPERATOR_POWER; }
+            return TOKEN_OPERATOR_MULTIPLY;
+        // "=" — и присваивание, и сравнение; различает парсер по контексту
+        case '=': return TOKEN_OPERATOR_EQ;
+        case '<':
+            if (next == '=') { lexer_advance(lexer); return TOKEN_OPERATOR_LE; }
+            if (next == '>') { lexer_advance(lexer); return TOKEN_OPERATOR_NEQ; }
+            return TOKEN_OPERATOR_LT;
+        case '>':
+            if (next == '=') { lexer_advance(lexer); return TOKEN_OPERATOR_GE; }
+            return TOKEN_OPERATOR_GT;
+        case '&':
+            if (next == '&') { lexer_advance(lexer); return TOKEN_OPERATOR_CONCAT; }
+            return TOKEN_UNKNOWN;
+        case ';': return TOKEN_PUNCTUATION_SEMICOLON;
+        case ',': return TOKEN_PUNCTUATION_COMMA;
+        case '.': return TOKEN_PUNCTUATION_DOT;
+        case ':': return TOKEN_PUNCTUATION_COLON;
+        case '(': return TOKEN_PUNCTUATION_LPAREN;
+        case ')': return TOKEN_PUNCTUATION_RPAREN;
+        case '[': return TOKEN_PUNCTUATION_LBRACKET;
+        case ']': return TOKEN_PUNCTUATION_RBRACKET;
+        case '{': return TOKEN_PUNCTUATION_LBRACE;
+        case '}': return TOKEN_PUNCTUATION_RBRACE;
+        default:  return TOKEN_UNKNOWN;
+    }
+}
+
 token_t lexer_next_token(lexer_t *lexer) {
-    lexer_skip_whitespace_and_comments(lexer);
+    const lexer_scan_ops_t *scan = lexer_scan_ops();
+    size_t remaining;
 
-    int start_pos = lexer->pos;
-    int start_line = lexer->line;
-    int start_col = lexer->column;
+    lexer_skip_whitespace_and_comments(lexer, scan);
 
+    size_t start_pos = lexer->pos;
     char c = lexer_peek(lexer);
 
-    if (c == '\0') {
-        return create_token(TOKEN_EOF, "EOF", start_line, start_col);
+    if (lexer->pos >= lexer->length) {
+        return make_token(lexer, TOKEN_EOF, start_pos, start_pos);
     }
 
     // Идентификаторы и ключевые слова (начинаются с буквы или _)
-    if (isalpha(c) || c == '_') {
-        char buffer[MAX_LEXEME_LEN];
-        int len = 0;
-        while (isalnum(c) || c == '_') {
-            if (len < MAX_LEXEME_LEN - 1)
-                buffer[len++] = c;
-            lexer_advance(lexer);
-            c = lexer_peek(lexer);
+    if (isalpha((unsigned char)c) || c == '_') {
+        const char *rest = lexer_rest(lexer, &remaining);
+        lexer->pos += scan->identifier(rest, remaining);
+
+        token_type_t type = abap_keyword_lookup(lexer->source + start_pos, lexer->pos - start_pos);
+
+        // Составные ключевые слова через дефис (FIELD-SYMBOLS, SELECT-OPTIONS, AUTHORITY-CHECK).
+        // Дефис в ABAP также отделяет компонент структуры (struct-field), поэтому
+        // продолжение принимается, только если всё слово целиком — ключевое.
+        if (lexer_peek(lexer) == '-' && isalpha((unsigned char)lexer_peek_at(lexer, 1))) {
+            size_t end = lexer->pos;
+            while (end + 1 < lexer->length && lexer->source[end] == '-' &&
+                   isalpha((unsigned char)lexer->source[end + 1])) {
+                end += 1 + scan->identifier(lexer->source + end + 1, lexer->length - end - 1);
+            }
+            token_type_t compound = abap_keyword_lookup(lexer->source + start_pos, end - start_pos);
+            if (compound != TOKEN_IDENTIFIER) {
+                lexer->pos = end;
+                type = compound;
+            }
         }
-        buffer[len] = '\0';
 
-        if (is_keyword(buffer)) {
-            return create_token(TOKEN_KEYWORD, buffer, start_line, start_col);
+        token_t token = make_token(lexer, type, start_pos, lexer->pos);
+        // Имя интернируется один раз здесь; дальше все фазы сравнивают атомы
+        if (type == TOKEN_IDENTIFIER) {
+            token.atom = atom_intern(lexer->source + start_pos, lexer->pos - start_pos);
         }
-        return create_token(TOKEN_IDENTIFIER, buffer, start_line, start_col);
+        return token;
     }
 
-    // Числа (целые и десятичные)
-    if (isdigit(c)) {
-        char buffer[MAX_LEXEME_LEN];
-        int len = 0;
+    // Числа (целые и десятичные).
+    // Точка входит в число, только если за ней следует цифра: "x = 5." — это 5 и конец оператора.
+    if (isdigit((unsigned char)c)) {
+        const char *rest = lexer_rest(lexer, &remaining);
+        lexer->pos += scan->digits(rest, remaining);
+
         bool has_dot = false;
-        while (isdigit(c) || (!has_dot && c == '.')) {
-            if (c == '.')
-                has_dot = true;
-            if (len < MAX_LEXEME_LEN - 1)
-                buffer[len++] = c;
+        if (lexer_peek(lexer) == '.' && isdigit((unsigned char)lexer_peek_at(lexer, 1))) {
+            has_dot = true;
             lexer_advance(lexer);
-            c = lexer_peek(lexer);
+            rest = lexer_rest(lexer, &remaining);
+            lexer->pos += scan->digits(rest, remaining);
         }
-        buffer[len] = '\0';
-        return create_token(TOKEN_NUMBER, buffer, start_line, start_col);
+        return make_token(lexer, has_dot ? TOKEN_LITERAL_NUM_FLOAT : TOKEN_LITERAL_NUM_INT,
+                          start_pos, lexer->pos);
     }
 
-    // Строковые литералы в ABAP обрамлены одинарными кавычками
+    // Строковые литералы в ABAP обрамлены одинарными кавычками.
+    // Срез указывает на содержимое литерала без кавычек.
     if (c == '\'') {
         lexer_advance(lexer); // пропускаем открывающую кавычку
-        char buffer[MAX_LEXEME_LEN];
-        int len = 0;
-        c = lexer_peek(lexer);
-        while (c != '\'' && c != '\0' && len < MAX_LEXEME_LEN - 1) {
-            buffer[len++] = c;
-            lexer_advance(lexer);
-            c = lexer_peek(lexer);
-        }
-        buffer[len] = '\0';
+        size_t text_start = lexer->pos;
+        const char *rest = lexer_rest(lexer, &remaining);
+        lexer->pos += scan->find_char(rest, remaining, '\'');
+        size_t text_end = lexer->pos;
 
-        if (c == '\'') {
+        if (lexer->pos < lexer->length) {
             lexer_advance(lexer); // пропускаем закрывающую кавычку
-            return create_token(TOKEN_STRING, buffer, start_line, start_col);
+            // Позиция токена — открывающая кавычка, срез — содержимое литерала
+            token_t token = make_token(lexer, TOKEN_LITERAL_STRING, start_pos, text_end);
+            token.offset = (uint32_t)text_start;
+            token.length = (uint32_t)(text_end - text_start);
+            return token;
         } else {
-            // Ошибка: не закрытая строка
-            return create_token(TOKEN_UNKNOWN, "Unterminated string literal", start_line, start_col);
+            // Ошибка: не закрытая строка — срез охватывает литерал с открывающей кавычкой
+            return make_token(lexer, TOKEN_UNKNOWN, start_pos, text_end);
         }
     }
 
+    // Шаблон строки |...{ выражение }...| — один токен вместе с встроенными выражениями:
+    // так лексер остаётся без состояния между токенами, а выражения разбираются из среза.
+    // Не закрытый шаблон — TOKEN_UNKNOWN до конца текста, как не закрытая строка.
+    if (c == '|') {
+        bool closed;
+        lexer->pos = lexer_template_end(lexer->source, lexer->length, start_pos, &closed);
+        return make_token(lexer, closed ? TOKEN_LITERAL_TEMPLATE : TOKEN_UNKNOWN, start_pos, lexer->pos);
+    }
+
     // Операторы и спецсимволы
-    // Для простоты рассматриваем однобайтовые символы: + - * / = < > ( ) , ; .
-    // В ABAP есть и более сложные, но для начала этого достаточно
-    char op_str[2] = { c, '\0' };
-    lexer_advance(lexer);
-    return create_token(TOKEN_OPERATOR, op_str, start_line, start_col);
+    token_type_t type = lexer_scan_operator(lexer);
+    return make_token(lexer, type, start_pos, lexer->pos);
 }
@@ -0,0 +1,189 @@
+#include "lexer_parallel.h"
+#include "lexer_scan.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file parallel.c
+ * @brief Параллельная лексика: разбиение по операторам, лексика фрагментов на пуле, склейка.
+ *
+ * Фрагменты всегда начинаются с начала строки, поэтому лексер фрагмента стартует
+ * в том же состоянии, что и последовательный: комментарии и пробелы не переходят
+ * через перевод строки. Пересечь границу могут только строковый литерал и
+ * многострочный шаблон строки |...|; такая лексема видна как незакрытый
+ * TOKEN_UNKNOWN в конце фрагмента и перелексируется при склейке.
+ */
+
+// Фрагмент исходного текста и его токены (смещения относительно start)
+typedef struct {
+    size_t start;
+    size_t end;
+    TokenStream tokens;
+    bool ok;
+} lexer_chunk_t;
+
+typedef struct {
+    const char *source;
+    lexer_chunk_t *chunks;
+} lexer_parallel_job_t;
+
+// Лексирует source[start, end) в отдельный поток токенов
+static bool lexer_lex_range(TokenStream *tokens, const char *source, size_t start, size_t end) {
+    lexer_t lexer;
+    lexer_init(&lexer, source + start, end - start);
+    bool ok = token_stream_from_lexer(tokens, &lexer);
+    lexer_free(&lexer);
+    return ok;
+}
+
+static void lexer_lex_chunk(void *arg, size_t index, int worker) {
+    (void)worker;
+    lexer_parallel_job_t *job = (lexer_parallel_job_t *)arg;
+    lexer_chunk_t *chunk = &job->chunks[index];
+    chunk->ok = lexer_lex_range(&chunk->tokens, job->source, chunk->start, chunk->end);
+}
+
+// Последний символ строки, заканчивающейся переводом строки в позиции newline,
+// без завершающих пробелов и '\r'
+static char lexer_line_last_char(const char *source, size_t line_start, size_t newline) {
+    while (newline > line_start) {
+        char c = source[--newline];
+        if (c != ' ' && c != '\t' && c != '\r') return c;
+    }
+    return '\0';
+}
+
+// Точка разреза не раньше from: начало строки после оператора, завершённого точкой.
+// Если такой строки нет в пределах окна, подходит начало любой строки.
+// Возвращает length, если разрезать негде.
+static size_t lexer_split_point(const char *source, size_t length, size_t from) {
+    const lexer_scan_ops_t *scan = lexer_scan_ops();
+    size_t window_end = from + LEXER_PARALLEL_SPLIT_WINDOW < length ?
+                        from + LEXER_PARALLEL_SPLIT_WINDOW : length;
+    size_t line_start = from;
+    size_t first_newline = length;
+
+    for (size_t pos = from; pos < window_end; ) {
+        size_t newline = pos + scan->find_char(source + pos, window_end - pos, '\n');
+        if (newline >= window_end) break;
+        if (first_newline == length) first_newline = newline;
+        if (lexer_line_last_char(source, line_start, newline) == '.') return newline + 1;
+        line_start = pos = newline + 1;
+    }
+
+    if (first_newline == length && window_end < length) {
+        first_newline = window_end + scan->find_char(source + window_end, length - window_end, '\n');
+    }
+    return first_newline < length ? first_newline + 1 : length;
+}
+
+// Последний токен фрагмента — строковый литерал или шаблон, не закрытый до конца фрагмента
+static bool lexer_chunk_open_literal(const TokenStream *tokens, size_t size) {
+    int last = tokens->token_count - 1;
+    if (token_stream_type_at(tokens, last) != TOKEN_UNKNOWN) return false;
+    uint32_t offset = token_stream_offset_at(tokens, last);
+    return (tokens->source[offset] == '\'' || tokens->source[offset] == '|') &&
+           offset + (size_t)token_stream_length_at(tokens, last) == size;
+}
+
+static void lexer_free_chunks(lexer_chunk_t *chunks, size_t from, size_t count) {
+    for (size_t i = from; i < count; i++) {
+        token_stream_free(&chunks[i].tokens);
+    }
+    free(chunks);
+}
+
+/**
+ * @brief Лексирует source в stream, используя потоки pool.
+ */
+bool lexer_parallel_tokenize(TokenStream *stream, const char *source, size_t length,
+                             thread_pool_t *pool) {
+    int threads = thread_pool_size(pool);
+    if (threads <= 1 || length < LEXER_PARALLEL_MIN_SIZE || length > UINT32_MAX) {
+        lexer_t lexer;
+        lexer_init(&lexer, source, length);
+        bool ok = token_stream_from_lexer(stream, &lexer);
+        lexer_free(&lexer);
+        return ok;
+    }
+
+    // Разбиение на фрагменты примерно равного размера по концам операторов
+    size_t wanted = (size_t)threads * LEXER_PARALLEL_CHUNKS_PER_THREAD;
+    if (wanted > length / (LEXER_PARALLEL_MIN_SIZE / 4)) wanted = length / (LEXER_PARALLEL_MIN_SIZE / 4);
+    lexer_chunk_t *chunks = calloc(wanted, sizeof(lexer_chunk_t));
+    if (!chunks) return false;
+
+    size_t count = 0, start = 0;
+    for (size_t i = 1; i <= wanted && start < length; i++) {
+        size_t target = i < wanted ? length / wanted * i : length;
+        size_t end = target <= start ? start + 1 : target;
+        end = end < length ? lexer_split_point(source, length, end) : length;
+        chunks[count].start = start;
+        chunks[count].end = end;
+        count++;
+        start = end;
+    }
+
+    lexer_parallel_job_t job = { source, chunks };
+    thread_pool_run(pool, count, lexer_lex_chunk, &job);
+
+    for (size_t i = 0; i < count; i++) {
+        if (!chunks[i].ok) {
+            fprintf(stderr, "Out of memory while lexing source chunk\n");
+            lexer_free_chunks(chunks, 0, count);
+            return false;
+        }
+    }
+
+    // Склейка по порядку. Если фрагмент заканчивается незакрытым литералом, литерал
+    // на самом деле продолжается в следующих фрагментах: он отбрасывается, а текст от
+    // его кавычки до конца фрагмента, где литерал закрывается, лексируется заново.
+    token_stream_init(stream, source, length);
+    size_t i = 0;
+    TokenStream segment = chunks[0].tokens;
+    size_t segment_start = chunks[0].start;
+    memset(&chunks[0].tokens, 0, sizeof(TokenStream));
+
+    for (;;) {
+        size_t segment_size = chunks[i].end - segment_start;
+        bool open = i + 1 < count && lexer_chunk_open_literal(&segment, segment_size);
+        uint32_t quote = open ? token_stream_offset_at(&segment, segment.token_count - 1) : 0;
+        if (open) token_stream_truncate(&segment, segment.token_count - 1, quote);
+
+        bool ok = token_stream_append(stream, &segment, (uint32_t)segment_start);
+        token_stream_free(&segment);
+        if (!ok) break;
+
+        if (open) {
+            // Последний символ литерала в полном тексте (закрывающая кавычка или черта)
+            // определяет, сколько фрагментов он поглощает
+            size_t literal = segment_start + quote;
+            lexer_t lexer;
+            lexer_init_at(&lexer, source, length, literal);
+            lexer_next_token(&lexer);
+            size_t close = lexer.pos - 1;
+            lexer_free(&lexer);
+            while (i + 1 < count && chunks[i].end <= close) {
+                token_stream_free(&chunks[++i].tokens);
+            }
+            segment_start = literal;
+            if (!lexer_lex_range(&segment, source, segment_start, chunks[i].end)) break;
+            continue;
+        }
+
+        if (++i == count) {
+            free(chunks);
+            return true;
+        }
+        segment = chunks[i].tokens;
+        segment_start = chunks[i].start;
+        memset(&chunks[i].tokens, 0, sizeof(TokenStream));
+    }
+
+    fprintf(stderr, "Out of memory while merging source chunks\n");
+    token_stream_free(&segment);
+    lexer_free_chunks(chunks, i, count);
+    token_stream_free(stream);
+    return false;
+}
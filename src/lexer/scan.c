@@ -0,0 +1,304 @@
+#include "lexer_scan.h"
+#include <string.h>
+
+#if defined(__x86_64__)
+#define LEXER_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @file scan.c
+ * @brief Ядра сканирования для лексера: скалярные, SSE2 и AVX2.
+ *
+ * Проверка принадлежности байта диапазону [lo, hi] выполняется без ветвлений:
+ * (x - lo) <= (hi - lo) в беззнаковой арифметике. В SIMD беззнаковое сравнение
+ * выражается через min_epu8: y <= limit  <=>  min(y, limit) == y.
+ * Байты >= 0x80 (UTF-8) не считаются символами идентификатора — как и isalnum() в локали "C".
+ */
+
+// ---------------------------------------------------------------------------
+// Скалярная реализация
+// ---------------------------------------------------------------------------
+
+static inline int scan_is_space(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline int scan_is_digit(unsigned char c) {
+    return (unsigned)(c - '0') <= 9u;
+}
+
+static inline int scan_is_identifier(unsigned char c) {
+    return (unsigned)((c | 0x20) - 'a') <= 25u || scan_is_digit(c) || c == '_';
+}
+
+static size_t scalar_whitespace(const char *text, size_t length) {
+    size_t i = 0;
+    while (i < length && scan_is_space((unsigned char)text[i])) i++;
+    return i;
+}
+
+static size_t scalar_identifier(const char *text, size_t length) {
+    size_t i = 0;
+    while (i < length && scan_is_identifier((unsigned char)text[i])) i++;
+    return i;
+}
+
+static size_t scalar_digits(const char *text, size_t length) {
+    size_t i = 0;
+    while (i < length && scan_is_digit((unsigned char)text[i])) i++;
+    return i;
+}
+
+static size_t scalar_find_char(const char *text, size_t length, char c) {
+    const char *hit = memchr(text, c, length);
+    return hit ? (size_t)(hit - text) : length;
+}
+
+static size_t scalar_newlines(const char *text, size_t length, uint32_t *out) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '\n') {
+            if (out) out[count] = (uint32_t)i;
+            count++;
+        }
+    }
+    return count;
+}
+
+static const lexer_scan_ops_t scan_ops_scalar = {
+    LEXER_SCAN_SCALAR,
+    scalar_whitespace,
+    scalar_identifier,
+    scalar_digits,
+    scalar_find_char,
+    scalar_newlines,
+};
+
+#ifdef LEXER_SCAN_X86
+
+// ---------------------------------------------------------------------------
+// SSE2: 16 байт за итерацию
+// ---------------------------------------------------------------------------
+
+// Маска байтов, попадающих в [lo, lo + span]
+static inline __m128i sse2_in_range(__m128i x, char lo, char span) {
+    __m128i y = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(y, _mm_set1_epi8(span)), y);
+}
+
+static inline __m128i sse2_space_mask(__m128i x) {
+    __m128i m = _mm_cmpeq_epi8(x, _mm_set1_epi8(' '));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('\t')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('\r')));
+    return _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('\n')));
+}
+
+static inline __m128i sse2_identifier_mask(__m128i x) {
+    __m128i letter = sse2_in_range(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 25);
+    __m128i digit = sse2_in_range(x, '0', 9);
+    __m128i under = _mm_cmpeq_epi8(x, _mm_set1_epi8('_'));
+    return _mm_or_si128(_mm_or_si128(letter, digit), under);
+}
+
+// Общий цикл: ищет первый байт, НЕ входящий в класс
+#define SSE2_SCAN_RUN(name, mask_fn, scalar_fn)                                  \
+    static size_t name(const char *text, size_t length) {                        \
+        size_t i = 0;                                                            \
+        for (; i + 16 <= length; i += 16) {                                      \
+            __m128i x = _mm_loadu_si128((const __m128i *)(text + i));            \
+            unsigned miss = ~(unsigned)_mm_movemask_epi8(mask_fn(x)) & 0xFFFFu;  \
+            if (miss) return i + (size_t)__builtin_ctz(miss);                    \
+        }                                                                        \
+        return i + scalar_fn(text + i, length - i);                              \
+    }
+
+static inline __m128i sse2_digit_mask(__m128i x) {
+    return sse2_in_range(x, '0', 9);
+}
+
+SSE2_SCAN_RUN(sse2_whitespace, sse2_space_mask, scalar_whitespace)
+SSE2_SCAN_RUN(sse2_identifier, sse2_identifier_mask, scalar_identifier)
+SSE2_SCAN_RUN(sse2_digits, sse2_digit_mask, scalar_digits)
+
+static size_t sse2_find_char(const char *text, size_t length, char c) {
+    __m128i needle = _mm_set1_epi8(c);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(text + i));
+        unsigned hit = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, needle));
+        if (hit) return i + (size_t)__builtin_ctz(hit);
+    }
+    return i + scalar_find_char(text + i, length - i, c);
+}
+
+static size_t sse2_newlines(const char *text, size_t length, uint32_t *out) {
+    __m128i nl = _mm_set1_epi8('\n');
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(text + i));
+        unsigned hit = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, nl));
+        if (!out) {
+            count += (size_t)__builtin_popcount(hit);
+            continue;
+        }
+        while (hit) {
+            out[count++] = (uint32_t)(i + (size_t)__builtin_ctz(hit));
+            hit &= hit - 1;
+        }
+    }
+    for (; i < length; i++) {
+        if (text[i] == '\n') {
+            if (out) out[count] = (uint32_t)i;
+            count++;
+        }
+    }
+    return count;
+}
+
+static const lexer_scan_ops_t scan_ops_sse2 = {
+    LEXER_SCAN_SSE2,
+    sse2_whitespace,
+    sse2_identifier,
+    sse2_digits,
+    sse2_find_char,
+    sse2_newlines,
+};
+
+// ---------------------------------------------------------------------------
+// AVX2: 32 байта за итерацию. Функции компилируются с target("avx2"),
+// поэтому весь проект не требует -mavx2 и работает на процессорах без AVX2.
+// ---------------------------------------------------------------------------
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+AVX2_TARGET static inline __m256i avx2_in_range(__m256i x, char lo, char span) {
+    __m256i y = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(y, _mm256_set1_epi8(span)), y);
+}
+
+AVX2_TARGET static inline __m256i avx2_space_mask(__m256i x) {
+    __m256i m = _mm256_cmpeq_epi8(x, _mm256_set1_epi8(' '));
+    m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\t')));
+    m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\r')));
+    return _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n')));
+}
+
+AVX2_TARGET static inline __m256i avx2_identifier_mask(__m256i x) {
+    __m256i letter = avx2_in_range(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 25);
+    __m256i digit = avx2_in_range(x, '0', 9);
+    __m256i under = _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'));
+    return _mm256_or_si256(_mm256_or_si256(letter, digit), under);
+}
+
+AVX2_TARGET static inline __m256i avx2_digit_mask(__m256i x) {
+    return avx2_in_range(x, '0', 9);
+}
+
+// Хвост короче 32 байт дорабатывается SSE2-версией
+#define AVX2_SCAN_RUN(name, mask_fn, tail_fn)                                    \
+    AVX2_TARGET static size_t name(const char *text, size_t length) {            \
+        size_t i = 0;                                                            \
+        for (; i + 32 <= length; i += 32) {                                      \
+            __m256i x = _mm256_loadu_si256((const __m256i *)(text + i));         \
+            uint32_t miss = ~(uint32_t)_mm256_movemask_epi8(mask_fn(x));         \
+            if (miss) return i + (size_t)__builtin_ctz(miss);                    \
+        }                                                                        \
+        return i + tail_fn(text + i, length - i);                                \
+    }
+
+AVX2_SCAN_RUN(avx2_whitespace, avx2_space_mask, sse2_whitespace)
+AVX2_SCAN_RUN(avx2_identifier, avx2_identifier_mask, sse2_identifier)
+AVX2_SCAN_RUN(avx2_digits, avx2_digit_mask, sse2_digits)
+
+AVX2_TARGET static size_t avx2_find_char(const char *text, size_t length, char c) {
+    __m256i needle = _mm256_set1_epi8(c);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(text + i));
+        uint32_t hit = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, needle));
+        if (hit) return i + (size_t)__builtin_ctz(hit);
+    }
+    return i + sse2_find_char(text + i, length - i, c);
+}
+
+AVX2_TARGET static size_t avx2_newlines(const char *text, size_t length, uint32_t *out) {
+    __m256i nl = _mm256_set1_epi8('\n');
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(text + i));
+        uint32_t hit = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, nl));
+        if (!out) {
+            count += (size_t)__builtin_popcount(hit);
+            continue;
+        }
+        while (hit) {
+            out[count++] = (uint32_t)(i + (size_t)__builtin_ctz(hit));
+            hit &= hit - 1;
+        }
+    }
+    size_t tail = sse2_newlines(text + i, length - i, out ? out + count : NULL);
+    if (out) {
+        for (size_t k = 0; k < tail; k++) out[count + k] += (uint32_t)i;
+    }
+    return count + tail;
+}
+
+static const lexer_scan_ops_t scan_ops_avx2 = {
+    LEXER_SCAN_AVX2,
+    avx2_whitespace,
+    avx2_identifier,
+    avx2_digits,
+    avx2_find_char,
+    avx2_newlines,
+};
+
+#endif // LEXER_SCAN_X86
+
+// ---------------------------------------------------------------------------
+// Диспетчеризация
+// ---------------------------------------------------------------------------
+
+static const lexer_scan_ops_t *scan_current = NULL;
+
+static const lexer_scan_ops_t *scan_pick(lexer_scan_impl_t impl) {
+#ifdef LEXER_SCAN_X86
+    __builtin_cpu_init();
+    int has_avx2 = __builtin_cpu_supports("avx2");
+    int has_sse2 = __builtin_cpu_supports("sse2");
+    if ((impl == LEXER_SCAN_AUTO || impl == LEXER_SCAN_AVX2) && has_avx2) return &scan_ops_avx2;
+    if (impl != LEXER_SCAN_SCALAR && has_sse2) return &scan_ops_sse2;
+#else
+    (void)impl;
+#endif
+    return &scan_ops_scalar;
+}
+
+const lexer_scan_ops_t *lexer_scan_ops(void) {
+    // Все варианты — статические константы, поэтому гонка при первом вызове
+    // из нескольких потоков безопасна: каждый запишет один и тот же указатель.
+    const lexer_scan_ops_t *ops = __atomic_load_n(&scan_current, __ATOMIC_ACQUIRE);
+    if (!ops) {
+        ops = scan_pick(LEXER_SCAN_AUTO);
+        __atomic_store_n(&scan_current, ops, __ATOMIC_RELEASE);
+    }
+    return ops;
+}
+
+lexer_scan_impl_t lexer_scan_select(lexer_scan_impl_t impl) {
+    const lexer_scan_ops_t *ops = scan_pick(impl);
+    __atomic_store_n(&scan_current, ops, __ATOMIC_RELEASE);
+    return ops->impl;
+}
+
+const char *lexer_scan_impl_name(lexer_scan_impl_t impl) {
+    switch (impl) {
+        case LEXER_SCAN_AUTO:   return "auto";
+        case LEXER_SCAN_SCALAR: return "scalar";
+        case LEXER_SCAN_SSE2:   return "sse2";
+        case LEXER_SCAN_AVX2:   return "avx2";
+    }
+    return "unknown";
+}
@@ -0,0 +1,121 @@
+#include "source_buffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Чтение потока целиком в кучу (для файлов, которые нельзя отобразить).
+ */
+static bool source_buffer_read_all(source_buffer_t *buffer, int fd) {
+    size_t capacity = 4096;
+    size_t length = 0;
+    char *data = malloc(capacity);
+    if (!data) {
+        fprintf(stderr, "Out of memory while reading source\n");
+        return false;
+    }
+
+    for (;;) {
+        if (length == capacity) {
+            capacity *= 2;
+            char *grown = realloc(data, capacity);
+            if (!grown) {
+                fprintf(stderr, "Out of memory while reading source\n");
+                free(data);
+                return false;
+            }
+            data = grown;
+        }
+        ssize_t n = read(fd, data + length, capacity - length);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Failed to read source: %s\n", strerror(errno));
+            free(data);
+            return false;
+        }
+        if (n == 0) break;
+        length += (size_t)n;
+    }
+
+    buffer->data = data;
+    buffer->length = length;
+    buffer->mapped = false;
+    buffer->owned = true;
+    return true;
+}
+
+/**
+ * @brief Открытие файла и отображение его в память.
+ */
+bool source_buffer_open(source_buffer_t *buffer, const char *path) {
+    memset(buffer, 0, sizeof(*buffer));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot open source file %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        fprintf(stderr, "Cannot stat source file %s: %s\n", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    bool ok;
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            // mmap может быть недоступен (например, на некоторых ФС) — читаем обычным способом
+            ok = source_buffer_read_all(buffer, fd);
+        } else {
+            // Лексер читает файл строго последовательно
+            madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+            buffer->data = data;
+            buffer->length = (size_t)st.st_size;
+            buffer->mapped = true;
+            buffer->owned = true;
+            ok = true;
+        }
+    } else {
+        ok = source_buffer_read_all(buffer, fd);
+    }
+
+    // Отображение остаётся действительным и после закрытия дескриптора
+    close(fd);
+    return ok;
+}
+
+/**
+ * @brief Обёртка над чужим буфером без копирования.
+ */
+void source_buffer_from_memory(source_buffer_t *buffer, const char *data, size_t length) {
+    buffer->data = data;
+    buffer->length = length;
+    buffer->mapped = false;
+    buffer->owned = false;
+}
+
+/**
+ * @brief Освобождение буфера исходного текста.
+ */
+void source_buffer_close(source_buffer_t *buffer) {
+    if (!buffer || !buffer->data) return;
+    if (buffer->owned) {
+        if (buffer->mapped) {
+            munmap((void *)buffer->data, buffer->length);
+        } else {
+            free((void *)buffer->data);
+        }
+    }
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->mapped = false;
+    buffer->owned = false;
+}
@@ -1,11 +1,26 @@
 #include "token.h"
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <stdio.h>
 
-// Создание нового токена с указанным типом и текстом
+// Создание токена-среза исходного буфера (без выделения памяти)
+Token token_view(TokenType type, const char *text, uint32_t length, int line, int column) {
+    Token token;
+    token.type = type;
+    token.text = text;
+    token.length = length;
+    token.line = line;
+    token.column = column;
+    token.atom = ATOM_NONE;
+    return token;
+}
+
+// Создание нового токена с указанным типом и текстом.
+// Токен и копия текста размещаются одним блоком, поэтому освобождаются одним free().
 Token *token_create(TokenType type, const char *text, int line, int column) {
-    Token *token = (Token *)malloc(sizeof(Token));
+    size_t length = text ? strlen(text) : 0;
+    Token *token = (Token *)malloc(sizeof(Token) + (text ? length + 1 : 0));
     if (!token) {
         fprintf(stderr, "Out of memory while creating token\n");
         exit(EXIT_FAILURE);
@@ -13,14 +28,13 @@ Token *token_create(TokenType type, const char *text, int line, int column) {
     token->type = type;
     token->line = line;
     token->column = column;
+    token->length = (uint32_t)length;
+    token->atom = type == TOKEN_IDENTIFIER ? atom_intern(text, length) : ATOM_NONE;
 
     if (text) {
-        token->text = strdup(text);
-        if (!token->text) {
-            fprintf(stderr, "Out of memory while copying token text\n");
-            free(token);
-            exit(EXIT_FAILURE);
-        }
+        char *copy = (char *)(token + 1);
+        memcpy(copy, text, length + 1);
+        token->text = copy;
     } else {
         token->text = NULL;
     }
@@ -31,16 +45,81 @@ Token *token_create(TokenType type, const char *text, int line, int column) {
 // Копирование токена (создает новый токен с такими же данными)
 Token *token_copy(const Token *src) {
     if (!src) return NULL;
-    return token_create(src->type, src->text, src->line, src->column);
+    Token *token = (Token *)malloc(sizeof(Token) + (src->text ? src->length + 1 : 0));
+    if (!token) {
+        fprintf(stderr, "Out of memory while copying token\n");
+        exit(EXIT_FAILURE);
+    }
+    *token = *src;
+    if (src->text) {
+        char *copy = (char *)(token + 1);
+        memcpy(copy, src->text, src->length);
+        copy[src->length] = '\0';
+        token->text = copy;
+    }
+    return token;
+}
+
+// Копия лексемы в виде C-строки
+char *token_strdup(const Token *token) {
+    if (!token || !token->text) return NULL;
+    char *copy = malloc((size_t)token->length + 1);
+    if (!copy) return NULL;
+    memcpy(copy, token->text, token->length);
+    copy[token->length] = '\0';
+    return copy;
+}
+
+// Атом имени токена (интернируется при первом обращении, если лексер его не заполнил)
+atom_t token_atom(const Token *token) {
+    if (!token) return ATOM_NONE;
+    if (token->atom != ATOM_NONE) return token->atom;
+    return atom_intern(token->text, token->length);
 }
 
-// Освобождение памяти, занятой токеном
+// Сравнение лексемы со строкой без учёта регистра
+int token_text_equals(const Token *token, const char *text) {
+    if (!token || !token->text || !text) return 0;
+    size_t length = strlen(text);
+    return length == token->length && strncasecmp(token->text, text, length) == 0;
+}
+
+// Слова, открывающие или закрывающие блок операторов
+int token_is_block_boundary(TokenType type) {
+    switch (type) {
+        case TOKEN_KEYWORD_FORM:
+        case TOKEN_KEYWORD_ENDFORM:
+        case TOKEN_KEYWORD_METHOD:
+        case TOKEN_KEYWORD_ENDMETHOD:
+        case TOKEN_KEYWORD_MODULE:
+        case TOKEN_KEYWORD_ENDMODULE:
+        case TOKEN_KEYWORD_FUNCTION:
+        case TOKEN_KEYWORD_ENDFUNCTION:
+        case TOKEN_KEYWORD_CLASS:
+        case TOKEN_KEYWORD_ENDCLASS:
+        case TOKEN_KEYWORD_INTERFACE:
+        case TOKEN_KEYWORD_ENDINTERFACE:
+        case TOKEN_KEYWORD_ELSEIF:
+        case TOKEN_KEYWORD_ELSE:
+        case TOKEN_KEYWORD_ENDIF:
+        case TOKEN_KEYWORD_WHEN:
+        case TOKEN_KEYWORD_ENDCASE:
+        case TOKEN_KEYWORD_ENDLOOP:
+        case TOKEN_KEYWORD_ENDWHILE:
+        case TOKEN_KEYWORD_ENDDO:
+        case TOKEN_KEYWORD_ENDSELECT:
+        case TOKEN_KEYWORD_CATCH:
+        case TOKEN_KEYWORD_CLEANUP:
+        case TOKEN_KEYWORD_ENDTRY:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// Освобождение памяти, занятой токеном (текст размещён в том же блоке)
 void token_free(Token *token) {
     if (!token) return;
-    if (token->text) {
-        free(token->text);
-        token->text = NULL;
-    }
     free(token);
 }
 
@@ -50,9 +129,16 @@ void token_print(const Token *token) {
         printf("Token: NULL\n");
         return;
     }
-    printf("Token(type=%d, text=\"%s\", line=%d, column=%d)\n",
-           token->type,
-           token->text ? token->text : "(null)",
-           token->line,
-           token->column);
+    if (token->text) {
+        printf("Token(type=%d, text=\"%.*s\", line=%d, column=%d)\n",
+               token->type,
+               (int)token->length, token->text,
+               token->line,
+               token->column);
+    } else {
+        printf("Token(type=%d, text=\"(null)\", line=%d, column=%d)\n",
+               token->type,
+               token->line,
+               token->column);
+    }
 }
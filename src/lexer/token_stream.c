@@ -33,44 +33,600 @@ void token_stream_reset(TokenStream *stream) {
 */
 
 #include "token_stream.h"
+#include "lexer_scan.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(TOKEN_TYPE_COUNT <= UINT8_MAX + 1, "TokenType must fit into one byte of TokenStream.types");
+
+#define TOKEN_STREAM_INITIAL_CAPACITY 1024
+#define TOKEN_CHAIN_INITIAL_SEGMENTS  64
+
+// Физический индекс токена: элементы за разрывом сдвинуты на его длину.
+// Разрыв всегда занимает всю свободную ёмкость, поэтому его длина — capacity - token_count.
+static inline int token_stream_slot(const TokenStream *stream, int index) {
+    return index < stream->gap_start ? index : index + (stream->capacity - stream->token_count);
+}
+
+// Смещение лексемы в source. За разрывом смещения хранятся от конца текста:
+// правка перед ними меняет длину текста и их позицию одинаково, и хранимое значение не меняется.
+static inline uint32_t token_stream_offset(const TokenStream *stream, int index) {
+    uint32_t stored = stream->offsets[token_stream_slot(stream, index)];
+    return index < stream->gap_start ? stored : (uint32_t)(stream->source_length - stored);
+}
+
+// Перевод строки номер index в таблице строк (та же схема разрыва, что и у токенов)
+static inline uint32_t token_stream_newline(const TokenStream *stream, size_t index) {
+    if (index < stream->newline_gap_start) return stream->newlines[index];
+    size_t gap = stream->newline_capacity - stream->newline_count;
+    return (uint32_t)(stream->source_length - stream->newlines[index + gap]);
+}
+
+// Поиск сегмента цепочек, содержащего виртуальный индекс. Чтение идёт почти всегда
+// подряд, поэтому сначала проверяются последний найденный сегмент и следующий за ним.
+static int token_chain_find(const token_chain_view_t *view, int index) {
+    int k = __atomic_load_n(&view->cursor, __ATOMIC_RELAXED);
+    const token_chain_segment_t *seg = &view->segments[k];
+    if (index >= seg->virtual_start && index < seg->virtual_start + seg->length) return k;
+    if (k + 1 < view->count && index >= seg[1].virtual_start &&
+        index < seg[1].virtual_start + seg[1].length) {
+        k++;
+    } else {
+        int lo = 0, hi = view->count - 1;
+        while (lo < hi) {
+            int mid = lo + (hi - lo + 1) / 2;
+            if (view->segments[mid].virtual_start <= index) lo = mid;
+            else hi = mid - 1;
+        }
+        k = lo;
+    }
+    // Курсор — только подсказка для следующего поиска, поэтому меняется и у const-потока
+    __atomic_store_n(&((token_chain_view_t *)view)->cursor, k, __ATOMIC_RELAXED);
+    return k;
+}
+
+// Число токенов, видимых парсеру (с раскрытыми цепочками — виртуальных)
+static inline int token_stream_count(const TokenStream *stream) {
+    return stream->chains ? stream->chains->virtual_count : stream->token_count;
+}
+
+// Физический индекс токена по индексу, видимому парсеру. as_dot — токен является
+// запятой цепочки, которую парсер видит как точку конца оператора.
+static inline int token_stream_resolve(const TokenStream *stream, int index, bool *as_dot) {
+    *as_dot = false;
+    if (!stream->chains) return index;
+    const token_chain_segment_t *seg = &stream->chains->segments[token_chain_find(stream->chains, index)];
+    *as_dot = seg->as_dot;
+    return seg->physical_start + (index - seg->virtual_start);
+}
+
+// Тип токена по физическому индексу с учётом подмены
+static inline TokenType token_stream_physical_type(const TokenStream *stream, int physical, bool as_dot) {
+    return as_dot ? TOKEN_PUNCTUATION_DOT : (TokenType)stream->types[token_stream_slot(stream, physical)];
+}
+
+// Длина лексемы по физическому индексу
+static uint32_t token_stream_physical_length(const TokenStream *stream, int physical) {
+    uint16_t length = stream->lengths[token_stream_slot(stream, physical)];
+    if (length != TOKEN_STREAM_LONG_LENGTH) return length;
+
+    // Длинные лексемы редки и записаны по возрастанию индекса
+    int lo = 0, hi = stream->long_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (stream->long_lengths[mid].index < physical) lo = mid + 1;
+        else hi = mid;
+    }
+    return stream->long_lengths[lo].length;
+}
+
+// Перенос count токенов между физическими позициями во всех параллельных массивах
+static void token_stream_move_slots(TokenStream *stream, int to, int from, int count) {
+    if (count <= 0 || to == from) return;
+    memmove(stream->types + to, stream->types + from, (size_t)count * sizeof(uint8_t));
+    memmove(stream->offsets + to, stream->offsets + from, (size_t)count * sizeof(uint32_t));
+    memmove(stream->lengths + to, stream->lengths + from, (size_t)count * sizeof(uint16_t));
+    memmove(stream->atoms + to, stream->atoms + from, (size_t)count * sizeof(atom_t));
+}
+
+// Перенос разрыва к логическому индексу index. Стоимость пропорциональна расстоянию
+// от прежнего положения разрыва, а не размеру потока.
+static void token_stream_move_gap(TokenStream *stream, int index) {
+    int gap = stream->capacity - stream->token_count;
+    if (index < stream->gap_start) {
+        // Токены [index, gap_start) уходят за разрыв: смещения отсчитываются от конца текста
+        int count = stream->gap_start - index;
+        token_stream_move_slots(stream, index + gap, index, count);
+        for (int slot = index + gap; slot < index + gap + count; slot++) {
+            stream->offsets[slot] = (uint32_t)(stream->source_length - stream->offsets[slot]);
+        }
+    } else if (index > stream->gap_start) {
+        // Токены [gap_start, index) возвращаются перед разрывом: смещения снова от начала
+        int count = index - stream->gap_start;
+        token_stream_move_slots(stream, stream->gap_start, stream->gap_start + gap, count);
+        for (int slot = stream->gap_start; slot < index; slot++) {
+            stream->offsets[slot] = (uint32_t)(stream->source_length - stream->offsets[slot]);
+        }
+    }
+    stream->gap_start = index;
+}
+
+// Перенос разрыва таблицы строк к индексу index
+static void token_stream_move_newline_gap(TokenStream *stream, size_t index) {
+    size_t gap = stream->newline_capacity - stream->newline_count;
+    uint32_t *lines = stream->newlines;
+    if (index < stream->newline_gap_start) {
+        size_t count = stream->newline_gap_start - index;
+        if (gap) memmove(lines + index + gap, lines + index, count * sizeof(uint32_t));
+        for (size_t i = index + gap; i < index + gap + count; i++) {
+            lines[i] = (uint32_t)(stream->source_length - lines[i]);
+        }
+    } else if (index > stream->newline_gap_start) {
+        size_t count = index - stream->newline_gap_start;
+        if (gap) memmove(lines + stream->newline_gap_start, lines + stream->newline_gap_start + gap,
+                         count * sizeof(uint32_t));
+        for (size_t i = stream->newline_gap_start; i < index; i++) {
+            lines[i] = (uint32_t)(stream->source_length - lines[i]);
+        }
+    }
+    stream->newline_gap_start = index;
+}
+
+// Увеличение параллельных массивов до new_capacity элементов
+static bool token_stream_reserve(TokenStream *stream, int new_capacity) {
+    if (new_capacity <= stream->capacity) return true;
+    int old_gap = stream->capacity - stream->token_count;
+
+    uint8_t *types = realloc(stream->types, (size_t)new_capacity * sizeof(uint8_t));
+    if (!types) return false;
+    stream->types = types;
+
+    uint32_t *offsets = realloc(stream->offsets, (size_t)new_capacity * sizeof(uint32_t));
+    if (!offsets) return false;
+    stream->offsets = offsets;
+
+    uint16_t *lengths = realloc(stream->lengths, (size_t)new_capacity * sizeof(uint16_t));
+    if (!lengths) return false;
+    stream->lengths = lengths;
+
+    atom_t *atoms = realloc(stream->atoms, (size_t)new_capacity * sizeof(atom_t));
+    if (!atoms) return false;
+    stream->atoms = atoms;
+
+    // Разрыв растёт вместе с ёмкостью: токены за ним переезжают в конец массивов
+    int tail = stream->token_count - stream->gap_start;
+    stream->capacity = new_capacity;
+    token_stream_move_slots(stream, stream->gap_start + (new_capacity - stream->token_count),
+                            stream->gap_start + old_gap, tail);
+    return true;
+}
+
+// Увеличение таблицы строк до capacity элементов
+static bool token_stream_reserve_newlines(TokenStream *stream, size_t capacity) {
+    if (capacity <= stream->newline_capacity) return true;
+    size_t old_gap = stream->newline_capacity - stream->newline_count;
+    uint32_t *newlines = realloc(stream->newlines, capacity * sizeof(uint32_t));
+    if (!newlines) return false;
+    stream->newlines = newlines;
+
+    size_t tail = stream->newline_count - stream->newline_gap_start;
+    stream->newline_capacity = capacity;
+    if (tail) {
+        memmove(newlines + stream->newline_gap_start + (capacity - stream->newline_count),
+                newlines + stream->newline_gap_start + old_gap, tail * sizeof(uint32_t));
+    }
+    return true;
+}
+
+// Разрывы в конец: дописывание токенов и строк идёт в хвост массивов
+static void token_stream_close_gaps(TokenStream *stream) {
+    token_stream_move_gap(stream, stream->token_count);
+    token_stream_move_newline_gap(stream, stream->newline_count);
+}
+
+// Число переводов строк перед offset (бинарный поиск по таблице строк)
+static size_t token_stream_lines_before(const TokenStream *stream, uint32_t offset) {
+    size_t lo = 0, hi = stream->newline_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (token_stream_newline(stream, mid) < offset) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static Token token_stream_eof(void) {
+    Token eof_token = { TOKEN_EOF, NULL, 0, 0, 0, ATOM_NONE };
+    return eof_token;
+}
 
 /**
- * @brief Инициализация потока токенов.
+ * @brief Инициализация пустого потока над исходным текстом.
  */
-void token_stream_init(TokenStream *stream, Token *tokens, int count) {
-    stream->tokens = tokens;
+void token_stream_init(TokenStream *stream, const char *source, size_t length) {
+    memset(stream, 0, sizeof(*stream));
+    stream->source = source;
+    stream->source_length = length;
+}
+
+/**
+ * @brief Добавление токена лексера в конец потока.
+ */
+bool token_stream_push(TokenStream *stream, const token_t *token) {
+    if (token->type == TOKEN_EOF) return true;
+
+    token_stream_clear_chains(stream);
+    token_stream_close_gaps(stream);
+    if (stream->token_count == stream->capacity) {
+        int capacity = stream->capacity ? stream->capacity * 2 : TOKEN_STREAM_INITIAL_CAPACITY;
+        if (!token_stream_reserve(stream, capacity)) return false;
+    }
+
+    int index = stream->token_count;
+    if (token->length >= TOKEN_STREAM_LONG_LENGTH) {
+        token_long_length_t *long_lengths = realloc(stream->long_lengths,
+            (size_t)(stream->long_count + 1) * sizeof(token_long_length_t));
+        if (!long_lengths) return false;
+        stream->long_lengths = long_lengths;
+        stream->long_lengths[stream->long_count].index = index;
+        stream->long_lengths[stream->long_count].length = token->length;
+        stream->long_count++;
+        stream->lengths[index] = TOKEN_STREAM_LONG_LENGTH;
+    } else {
+        stream->lengths[index] = (uint16_t)token->length;
+    }
+    stream->types[index] = (uint8_t)token->type;
+    stream->offsets[index] = token->offset;
+    stream->atoms[index] = token->atom;
+    stream->gap_start = ++stream->token_count;
+    return true;
+}
+
+/**
+ * @brief Лексирует весь исходный текст лексера в поток.
+ */
+bool token_stream_from_lexer(TokenStream *stream, lexer_t *lexer) {
+    token_stream_init(stream, lexer->source, lexer->length);
+
+    // Грубая оценка: в ABAP-коде в среднем не меньше 4 байт на токен
+    if (!token_stream_reserve(stream, (int)(lexer->length / 4) + TOKEN_STREAM_INITIAL_CAPACITY)) {
+        token_stream_free(stream);
+        return false;
+    }
+
+    for (;;) {
+        token_t token = lexer_next_token(lexer);
+        if (token.type == TOKEN_EOF) break;
+        if (!token_stream_push(stream, &token)) {
+            fprintf(stderr, "Out of memory while buffering tokens\n");
+            token_stream_free(stream);
+            return false;
+        }
+    }
+
+    // Таблица строк переходит к потоку: она нужна для строки/колонки в диагностике
+    stream->newlines = lexer->newlines;
+    stream->newline_count = lexer->newline_count;
+    stream->newline_capacity = lexer->newline_count;
+    stream->newline_gap_start = lexer->newline_count;
+    lexer->newlines = NULL;
+    lexer->newline_count = 0;
+    return true;
+}
+
+/**
+ * @brief Дописывает токены другого потока, сдвигая их смещения на base.
+ */
+bool token_stream_append(TokenStream *stream, const TokenStream *chunk, uint32_t base) {
+    int count = chunk->token_count;
+    if ((size_t)stream->token_count + (size_t)count > INT_MAX) return false;
+    token_stream_clear_chains(stream);
+    token_stream_close_gaps(stream);
+    if (!token_stream_reserve(stream, stream->token_count + count)) return false;
+
+    int first = stream->token_count;
+    memcpy(stream->types + first, chunk->types, (size_t)count * sizeof(uint8_t));
+    memcpy(stream->lengths + first, chunk->lengths, (size_t)count * sizeof(uint16_t));
+    memcpy(stream->atoms + first, chunk->atoms, (size_t)count * sizeof(atom_t));
+    for (int i = 0; i < count; i++) {
+        stream->offsets[first + i] = chunk->offsets[i] + base;
+    }
+
+    if (chunk->long_count > 0) {
+        token_long_length_t *long_lengths = realloc(stream->long_lengths,
+            (size_t)(stream->long_count + chunk->long_count) * sizeof(token_long_length_t));
+        if (!long_lengths) return false;
+        stream->long_lengths = long_lengths;
+        for (int i = 0; i < chunk->long_count; i++) {
+            stream->long_lengths[stream->long_count].index = chunk->long_lengths[i].index + first;
+            stream->long_lengths[stream->long_count].length = chunk->long_lengths[i].length;
+            stream->long_count++;
+        }
+    }
+
+    if (chunk->newline_count > 0) {
+        size_t capacity = stream->newline_count + chunk->newline_count;
+        if (capacity > stream->newline_capacity && capacity < stream->newline_capacity * 2) {
+            capacity = stream->newline_capacity * 2;
+        }
+        if (!token_stream_reserve_newlines(stream, capacity)) return false;
+        for (size_t i = 0; i < chunk->newline_count; i++) {
+            stream->newlines[stream->newline_count++] = chunk->newlines[i] + base;
+        }
+        stream->newline_gap_start = stream->newline_count;
+    }
+
+    stream->token_count += count;
+    stream->gap_start = stream->token_count;
+    return true;
+}
+
+/**
+ * @brief Отбрасывает токены начиная с count и переводы строк начиная со смещения source_end.
+ */
+void token_stream_truncate(TokenStream *stream, int count, size_t source_end) {
+    if (count < 0 || count > stream->token_count) return;
+    token_stream_clear_chains(stream);
+    token_stream_close_gaps(stream);
     stream->token_count = count;
-    stream->current_index = 0;
-    stream->saved_count = 0;
+    stream->gap_start = count;
+    while (stream->long_count > 0 && stream->long_lengths[stream->long_count - 1].index >= count) {
+        stream->long_count--;
+    }
+    while (stream->newline_count > 0 && stream->newlines[stream->newline_count - 1] >= source_end) {
+        stream->newline_count--;
+    }
+    stream->newline_gap_start = stream->newline_count;
+    if (stream->current_index > count) stream->current_index = count;
+}
+
+/**
+ * @brief Замена токенов [first, first + removed) токенами replacement после правки текста.
+ */
+bool token_stream_edit(TokenStream *stream, const char *source, size_t length,
+                       const source_edit_t *edit, int first, int removed,
+                       const TokenStream *replacement) {
+    int inserted = replacement->token_count;
+    if (first < 0 || removed < 0 || first + removed > stream->token_count) return false;
+    if (edit->offset + edit->removed > stream->source_length || length > UINT32_MAX ||
+        length != stream->source_length - edit->removed + edit->inserted) {
+        return false;
+    }
+
+    // Вся память выделяется до изменений, чтобы при ошибке поток остался прежним
+    token_stream_clear_chains(stream);
+    int token_need = stream->token_count - removed + inserted;
+    if (token_need > stream->capacity &&
+        !token_stream_reserve(stream, token_need > stream->capacity * 2 ? token_need : stream->capacity * 2)) {
+        return false;
+    }
+
+    const lexer_scan_ops_t *scan = lexer_scan_ops();
+    size_t lines_from = token_stream_lines_before(stream, (uint32_t)edit->offset);
+    size_t lines_to = token_stream_lines_before(stream, (uint32_t)(edit->offset + edit->removed));
+    size_t lines_added = scan->newlines(source + edit->offset, edit->inserted, NULL);
+    size_t line_need = stream->newline_count - (lines_to - lines_from) + lines_added;
+    if (line_need > stream->newline_capacity &&
+        !token_stream_reserve_newlines(stream, line_need > stream->newline_capacity * 2
+                                               ? line_need : stream->newline_capacity * 2)) {
+        return false;
+    }
+
+    // Длинные лексемы редки: список перестраивается целиком
+    int long_count = 0;
+    for (int i = 0; i < stream->long_count; i++) {
+        int index = stream->long_lengths[i].index;
+        long_count += index < first || index >= first + removed;
+    }
+    long_count += replacement->long_count;
+    token_long_length_t *long_lengths = NULL;
+    if (long_count > 0) {
+        long_lengths = malloc((size_t)long_count * sizeof(token_long_length_t));
+        if (!long_lengths) return false;
+        int out = 0, i = 0;
+        for (; i < stream->long_count && stream->long_lengths[i].index < first; i++) {
+            long_lengths[out++] = stream->long_lengths[i];
+        }
+        for (int k = 0; k < replacement->long_count; k++) {
+            long_lengths[out].index = replacement->long_lengths[k].index + first;
+            long_lengths[out++].length = replacement->long_lengths[k].length;
+        }
+        for (; i < stream->long_count; i++) {
+            if (stream->long_lengths[i].index < first + removed) continue;
+            long_lengths[out].index = stream->long_lengths[i].index - removed + inserted;
+            long_lengths[out++].length = stream->long_lengths[i].length;
+        }
+    }
+    free(stream->long_lengths);
+    stream->long_lengths = long_lengths;
+    stream->long_count = long_count;
+
+    // Токены: разрыв переносится к концу заменяемого диапазона, диапазон уходит в разрыв,
+    // новые токены пишутся в его начало. Токены за разрывом хранят смещения от конца
+    // текста и остаются верными без пересчёта.
+    token_stream_move_gap(stream, first + removed);
+    stream->gap_start = first;
+    stream->token_count -= removed;
+    for (int i = 0; i < inserted; i++) {
+        int slot = first + i;
+        stream->types[slot] = replacement->types[i];
+        stream->offsets[slot] = replacement->offsets[i];
+        stream->lengths[slot] = replacement->lengths[i];
+        stream->atoms[slot] = replacement->atoms[i];
+    }
+    stream->gap_start += inserted;
+    stream->token_count += inserted;
+
+    // Таблица строк: те же действия для переводов строк удалённого и вставленного текста
+    token_stream_move_newline_gap(stream, lines_to);
+    stream->newline_gap_start = lines_from;
+    stream->newline_count -= lines_to - lines_from;
+    if (lines_added > 0) {
+        uint32_t *out = stream->newlines + lines_from;
+        scan->newlines(source + edit->offset, edit->inserted, out);
+        for (size_t i = 0; i < lines_added; i++) out[i] += (uint32_t)edit->offset;
+        stream->newline_gap_start += lines_added;
+        stream->newline_count += lines_added;
+    }
+
+    stream->source = source;
+    stream->source_length = length;
+    token_stream_reset(stream);
+    return true;
+}
+
+/**
+ * @brief Освобождение массивов потока.
+ */
+void token_stream_free(TokenStream *stream) {
+    if (!stream) return;
+    token_stream_clear_chains(stream);
+    free(stream->types);
+    free(stream->offsets);
+    free(stream->lengths);
+    free(stream->atoms);
+    free(stream->long_lengths);
+    free(stream->newlines);
+    free(stream->heap_marks);
+    token_stream_init(stream, NULL, 0);
+}
+
+/**
+ * @brief Курсор над общими массивами потока.
+ */
+bool token_stream_cursor_init(TokenStream *cursor, const TokenStream *stream, int index) {
+    *cursor = *stream;
+    cursor->current_index = index;
+    cursor->heap_marks = NULL;
+    cursor->mark_capacity = 0;
+    cursor->saved_count = 0;
+    if (stream->chains) {
+        // Своя копия описания цепочек: подсказка cursor не делится между потоками
+        cursor->chains = malloc(sizeof(token_chain_view_t));
+        if (!cursor->chains) return false;
+        *cursor->chains = *stream->chains;
+    }
+    return true;
+}
+
+/**
+ * @brief Освобождение стека позиций и копии описания цепочек курсора.
+ */
+void token_stream_cursor_free(TokenStream *cursor) {
+    if (!cursor) return;
+    free(cursor->heap_marks);
+    free(cursor->chains);
+    cursor->heap_marks = NULL;
+    cursor->chains = NULL;
+}
+
+/**
+ * @brief Тип текущего токена.
+ */
+TokenType token_stream_peek_type(const TokenStream *stream) {
+    if (stream->current_index >= token_stream_count(stream)) return TOKEN_EOF;
+    bool as_dot;
+    int physical = token_stream_resolve(stream, stream->current_index, &as_dot);
+    return token_stream_physical_type(stream, physical, as_dot);
+}
+
+/**
+ * @brief Тип токена на offset позиций впереди текущего.
+ */
+TokenType token_stream_peek_type_at(const TokenStream *stream, int offset) {
+    return token_stream_type_at(stream, stream->current_index + offset);
+}
+
+/**
+ * @brief Сдвиг на следующий токен.
+ */
+int token_stream_advance(TokenStream *stream) {
+    if (stream->current_index >= token_stream_count(stream)) return -1;
+    return stream->current_index++;
+}
+
+/**
+ * @brief Тип токена по индексу.
+ */
+TokenType token_stream_type_at(const TokenStream *stream, int index) {
+    if (index < 0 || index >= token_stream_count(stream)) return TOKEN_EOF;
+    bool as_dot;
+    int physical = token_stream_resolve(stream, index, &as_dot);
+    return token_stream_physical_type(stream, physical, as_dot);
+}
+
+/**
+ * @brief Смещение лексемы токена в исходном тексте.
+ */
+uint32_t token_stream_offset_at(const TokenStream *stream, int index) {
+    if (index < 0 || index >= token_stream_count(stream)) return 0;
+    bool as_dot;
+    return token_stream_offset(stream, token_stream_resolve(stream, index, &as_dot));
+}
+
+/**
+ * @brief Длина лексемы токена по индексу.
+ */
+uint32_t token_stream_length_at(const TokenStream *stream, int index) {
+    if (index < 0 || index >= token_stream_count(stream)) return 0;
+    bool as_dot;
+    return token_stream_physical_length(stream, token_stream_resolve(stream, index, &as_dot));
+}
+
+/**
+ * @brief Атом имени токена по индексу.
+ */
+atom_t token_stream_atom_at(const TokenStream *stream, int index) {
+    if (index < 0 || index >= token_stream_count(stream)) return ATOM_NONE;
+    bool as_dot;
+    return stream->atoms[token_stream_slot(stream, token_stream_resolve(stream, index, &as_dot))];
+}
+
+/**
+ * @brief Сборка полного токена-среза по индексу.
+ */
+Token token_stream_token_at(const TokenStream *stream, int index) {
+    if (index < 0 || index >= token_stream_count(stream)) return token_stream_eof();
+
+    bool as_dot;
+    index = token_stream_resolve(stream, index, &as_dot);
+    int slot = token_stream_slot(stream, index);
+    TokenType type = token_stream_physical_type(stream, index, as_dot);
+    uint32_t offset = token_stream_offset(stream, index);
+    // У строкового литерала срез — содержимое, а позиция — открывающая кавычка (как у лексера)
+    uint32_t position = type == TOKEN_LITERAL_STRING ? offset - 1 : offset;
+    size_t before = token_stream_lines_before(stream, position);
+    size_t line_start = before ? token_stream_newline(stream, before - 1) + 1 : 0;
+
+    Token token = token_view(type, stream->source + offset,
+                             token_stream_physical_length(stream, index),
+                             (int)before + 1, (int)(position - line_start) + 1);
+    token.atom = stream->atoms[slot];
+    return token;
 }
 
 /**
  * @brief Получение текущего токена без продвижения позиции.
  */
 Token token_stream_peek(TokenStream *stream) {
-    if (stream->current_index >= stream->token_count) {
-        Token eof_token = { TOKEN_EOF, NULL, 0, 0 };
-        return eof_token;
-    }
-    return stream->tokens[stream->current_index];
+    return token_stream_token_at(stream, stream->current_index);
 }
 
 /**
  * @brief Получение текущего токена и продвижение позиции.
  */
 Token token_stream_next(TokenStream *stream) {
-    if (stream->current_index >= stream->token_count) {
-        Token eof_token = { TOKEN_EOF, NULL, 0, 0 };
-        return eof_token;
-    }
-    return stream->tokens[stream->current_index++];
+    int index = token_stream_advance(stream);
+    return index < 0 ? token_stream_eof() : token_stream_token_at(stream, index);
 }
 
 /**
  * @brief Проверка, достигнут ли конец потока токенов.
  */
 bool token_stream_is_end(TokenStream *stream) {
-    return stream->current_index >= stream->token_count;
+    return stream->current_index >= token_stream_count(stream);
 }
 
 /**
@@ -85,9 +641,35 @@ void token_stream_reset(TokenStream *stream) {
  * @brief Сохранение текущей позиции в стек.
  */
 void token_stream_save(TokenStream *stream) {
-    if (stream->saved_count < MAX_SAVED_POSITIONS) {
-        stream->saved_positions[stream->saved_count++] = stream->current_index;
+    int count = stream->saved_count;
+    if (count < TOKEN_STREAM_INLINE_MARKS) {
+        stream->inline_marks[count] = stream->current_index;
+        stream->saved_count++;
+        return;
     }
+
+    // Переполнение встроенного стека: продолжаем в куче, ёмкость растёт вдвое
+    int heap_index = count - TOKEN_STREAM_INLINE_MARKS;
+    if (heap_index == stream->mark_capacity) {
+        int capacity = stream->mark_capacity ? stream->mark_capacity * 2 : TOKEN_STREAM_INLINE_MARKS;
+        int *marks = realloc(stream->heap_marks, (size_t)capacity * sizeof(int));
+        if (!marks) {
+            fprintf(stderr, "Out of memory while saving token stream position\n");
+            exit(EXIT_FAILURE);
+        }
+        stream->heap_marks = marks;
+        stream->mark_capacity = capacity;
+    }
+    stream->heap_marks[heap_index] = stream->current_index;
+    stream->saved_count++;
+}
+
+// Верхняя сохранённая позиция (стек не пуст)
+static int token_stream_top_mark(const TokenStream *stream) {
+    int top = stream->saved_count - 1;
+    return top < TOKEN_STREAM_INLINE_MARKS
+        ? stream->inline_marks[top]
+        : stream->heap_marks[top - TOKEN_STREAM_INLINE_MARKS];
 }
 
 /**
@@ -95,7 +677,8 @@ void token_stream_save(TokenStream *stream) {
  */
 void token_stream_restore(TokenStream *stream) {
     if (stream->saved_count > 0) {
-        stream->current_index = stream->saved_positions[--stream->saved_count];
+        stream->current_index = token_stream_top_mark(stream);
+        stream->saved_count--;
     }
 }
 
@@ -107,3 +690,133 @@ void token_stream_discard(TokenStream *stream) {
         --stream->saved_count;
     }
 }
+
+/**
+ * @brief Текущая позиция как метка для отката.
+ */
+int token_stream_mark(const TokenStream *stream) {
+    return stream->current_index;
+}
+
+/**
+ * @brief Возврат к метке.
+ */
+void token_stream_rewind(TokenStream *stream, int mark) {
+    if (mark < 0) mark = 0;
+    if (mark > token_stream_count(stream)) mark = token_stream_count(stream);
+    stream->current_index = mark;
+}
+
+// Добавление сегмента в представление цепочек (пустые сегменты не добавляются)
+static bool token_chain_emit(token_chain_view_t *view, int physical_start, int length, bool as_dot) {
+    if (length <= 0) return true;
+    if (view->count == view->capacity) {
+        int capacity = view->capacity ? view->capacity * 2 : TOKEN_CHAIN_INITIAL_SEGMENTS;
+        token_chain_segment_t *segments = realloc(view->segments, (size_t)capacity * sizeof(token_chain_segment_t));
+        if (!segments) return false;
+        view->segments = segments;
+        view->capacity = capacity;
+    }
+    token_chain_segment_t *seg = &view->segments[view->count++];
+    seg->virtual_start = view->virtual_count;
+    seg->physical_start = physical_start;
+    seg->length = length;
+    seg->as_dot = as_dot;
+    view->virtual_count += length;
+    return true;
+}
+
+// Раскрытие одного цепочечного оператора [start, end) с двоеточием в позиции colon.
+// end — индекс завершающей точки или token_count, если точки нет.
+static bool token_chain_expand_statement(const TokenStream *stream, token_chain_view_t *view,
+                                         int start, int colon, int end) {
+    int prefix = colon - start;
+    int depth = 0;
+    int piece = colon + 1;
+
+    if (!token_chain_emit(view, start, prefix, false)) return false;
+    for (int i = colon + 1; i < end; i++) {
+        TokenType type = (TokenType)stream->types[token_stream_slot(stream, i)];
+        if (type == TOKEN_PUNCTUATION_LPAREN || type == TOKEN_PUNCTUATION_LBRACKET) {
+            depth++;
+        } else if ((type == TOKEN_PUNCTUATION_RPAREN || type == TOKEN_PUNCTUATION_RBRACKET) && depth > 0) {
+            depth--;
+        } else if (type == TOKEN_PUNCTUATION_COLON) {
+            // Повторные двоеточия в ABAP ничего не значат и пропускаются
+            if (!token_chain_emit(view, piece, i - piece, false)) return false;
+            piece = i + 1;
+        } else if (type == TOKEN_PUNCTUATION_COMMA && depth == 0) {
+            // Запятая завершает очередной оператор цепочки и видна парсеру как точка;
+            // следующий оператор снова начинается с префикса
+            if (!token_chain_emit(view, piece, i - piece, false) ||
+                !token_chain_emit(view, i, 1, true) ||
+                !token_chain_emit(view, start, prefix, false)) {
+                return false;
+            }
+            piece = i + 1;
+        }
+    }
+    if (!token_chain_emit(view, piece, end - piece, false)) return false;
+    return end < stream->token_count ? token_chain_emit(view, end, 1, false) : true;
+}
+
+/**
+ * @brief Раскрытие цепочечных операторов (DATA: a TYPE i, b TYPE c.) в виртуальные.
+ */
+bool token_stream_expand_chains(TokenStream *stream) {
+    token_stream_clear_chains(stream);
+
+    token_chain_view_t *view = calloc(1, sizeof(token_chain_view_t));
+    if (!view) return false;
+
+    bool ok = true;
+    bool chained = false;
+    int plain_start = 0;        // Начало ещё не добавленного отрезка без цепочек
+    int count = stream->token_count;
+    for (int start = 0; ok && start < count; ) {
+        int colon = -1, end = start;
+        for (; end < count; end++) {
+            TokenType type = (TokenType)stream->types[token_stream_slot(stream, end)];
+            if (type == TOKEN_PUNCTUATION_DOT) break;
+            if (type == TOKEN_PUNCTUATION_COLON && colon < 0) colon = end;
+        }
+        if (colon >= 0) {
+            ok = token_chain_emit(view, plain_start, start - plain_start, false) &&
+                 token_chain_expand_statement(stream, view, start, colon, end);
+            plain_start = end + 1;
+            chained = true;
+        }
+        start = end + 1;
+    }
+    if (ok && plain_start < count) ok = token_chain_emit(view, plain_start, count - plain_start, false);
+
+    if (!ok || !chained || view->count == 0) {
+        // Цепочек нет — представление не нужно, индексы совпадают с физическими
+        free(view->segments);
+        free(view);
+        return ok;
+    }
+    stream->chains = view;
+    token_stream_reset(stream);
+    return true;
+}
+
+/**
+ * @brief Отключение раскрытия цепочек: индексы снова физические.
+ */
+void token_stream_clear_chains(TokenStream *stream) {
+    if (!stream->chains) return;
+    free(stream->chains->segments);
+    free(stream->chains);
+    stream->chains = NULL;
+    token_stream_reset(stream);
+}
+
+/**
+ * @brief Физический индекс токена (индекс в последовательности лексера).
+ */
+int token_stream_physical_index(const TokenStream *stream, int index) {
+    if (index < 0 || index >= token_stream_count(stream)) return -1;
+    bool as_dot;
+    return token_stream_resolve(stream, index, &as_dot);
+}
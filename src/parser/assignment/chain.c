@@ -12,6 +12,9 @@
  * Реализует правостороннюю ассоциативность:
  * выражение справа присваивается var2, затем var2 присваивается var1.
  *
+ * Цепочки с двоеточием (DATA: a TYPE i, b TYPE c.) сюда не попадают: поток токенов
+ * раскрывает их в отдельные операторы (token_stream_expand_chains()).
+ *
  * Возвращает AST узел присваивания или NULL при ошибке.
  */
 
@@ -68,14 +71,7 @@ ASTNode *parse_chain_assignment(TokenStream *ts) {
         ast_node_free(assign_node);
         return NULL;
     }
-    var_node->string_value = strdup(var_token->text);
-    if (!var_node->string_value) {
-        report_error("Failed to allocate memory for variable name");
-        ast_node_free(right_node);
-        ast_node_free(assign_node);
-        ast_node_free(var_node);
-        return NULL;
-    }
+    var_node->atom = token_atom(var_token);
 
     ast_node_add_child(assign_node, var_node);
     ast_node_add_child(assign_node, right_node);
@@ -2,6 +2,8 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -9,7 +11,10 @@
  * parse_simple_assignment - Парсит простое присваивание вида:
  * variable = expression.
  *
- * Проверяет, что левый операнд — идентификатор, правый — корректное выражение.
+ * Цель — имя с компонентами (struct-comp, ref->attr, <fs>). Составное присваивание
+ * "a += b" (также -=, *=, /=) разворачивается в a = a + b. Оператор, который начинается
+ * с функционального вызова ("lo->run( )."), возвращается узлом AST_FUNCTION_CALL.
+ *
  * Возвращает AST узел присваивания или NULL при ошибке.
  */
 
@@ -19,24 +24,57 @@ ASTNode *parse_simple_assignment(TokenStream *ts) {
         return NULL;
     }
 
-    Token *var_token = token_stream_next(ts);
-    if (!var_token || var_token->type != TOKEN_IDENTIFIER) {
+    int start = token_stream_mark(ts);
+    atom_t target = parse_name(ts);
+    if (target == ATOM_NONE) {
         report_error("Expected identifier on left side of assignment");
         return NULL;
     }
 
-    Token *assign_token = token_stream_next(ts);
-    if (!assign_token || assign_token->type != TOKEN_ASSIGN) { // обычно '='
-        report_error("Expected '=' in assignment");
-        return NULL;
+    // Вызов метода как оператор
+    if (token_stream_peek_type(ts) == TOKEN_PUNCTUATION_LPAREN) {
+        token_stream_rewind(ts, start);
+        ASTNode *call = parse_expression(ts);
+        if (call && call->type != AST_FUNCTION_CALL) report_error("Expected method call statement");
+        if (call) parser_end_statement(ts);
+        return call;
+    }
+
+    // Составное присваивание: знак операции вплотную перед '='
+    TokenType compound = token_stream_peek_type(ts);
+    if (compound == TOKEN_OPERATOR_PLUS || compound == TOKEN_OPERATOR_MINUS ||
+        compound == TOKEN_OPERATOR_MULTIPLY || compound == TOKEN_OPERATOR_DIVIDE) {
+        token_stream_advance(ts);
+    } else {
+        compound = TOKEN_UNKNOWN;
     }
 
+    if (!parser_expect(ts, TOKEN_OPERATOR_EQ, "'=' in assignment")) return NULL;
+
     ASTNode *expr = parse_expression(ts);
     if (!expr) {
         report_error("Failed to parse expression on right side of assignment");
         return NULL;
     }
 
+    if (compound != TOKEN_UNKNOWN) {
+        ASTNode *operation = ast_node_create(AST_OPERATOR);
+        ASTNode *operand = ast_node_create(AST_IDENTIFIER);
+        const char *text = parser_operator_text(compound);
+        if (operation) operation->string_value = ast_strndup(text, strlen(text));
+        if (!operation || !operand || !operation->string_value) {
+            report_error("Failed to allocate AST node for compound assignment");
+            ast_node_free(operation);
+            ast_node_free(operand);
+            ast_node_free(expr);
+            return NULL;
+        }
+        operand->atom = target;
+        ast_node_add_child(operation, operand);
+        ast_node_add_child(operation, expr);
+        expr = operation;
+    }
+
     ASTNode *assign_node = ast_node_create(AST_ASSIGNMENT);
     if (!assign_node) {
         report_error("Failed to allocate AST node for assignment");
@@ -51,25 +89,15 @@ ASTNode *parse_simple_assignment(TokenStream *ts) {
         ast_node_free(assign_node);
         return NULL;
     }
-    var_node->string_value = strdup(var_token->text);
-    if (!var_node->string_value) {
-        report_error("Failed to allocate memory for variable name");
-        ast_node_free(expr);
-        ast_node_free(assign_node);
-        ast_node_free(var_node);
-        return NULL;
-    }
+    var_node->atom = target;
 
     ast_node_add_child(assign_node, var_node);
     ast_node_add_child(assign_node, expr);
 
-    // Проверка точки с запятой или точки (конец оператора)
-    Token *end_token = token_stream_next(ts);
-    if (!end_token || (end_token->type != TOKEN_DOT && end_token->type != TOKEN_SEMICOLON)) {
-        report_error("Expected '.' or ';' at end of assignment statement");
-        ast_node_free(assign_node);
-        return NULL;
-    }
-
+    // Конец оператора
+    parser_end_statement(ts);
     return assign_node;
 }
+
+PARSER_STATEMENT(TOKEN_IDENTIFIER, TOKEN_UNKNOWN, 0, parse_simple_assignment)
+PARSER_STATEMENT(TOKEN_OPERATOR_LT, TOKEN_UNKNOWN, 0, parse_simple_assignment)
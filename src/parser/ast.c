@@ -0,0 +1,251 @@
+#include "../../include/ast.h"
+#include "../../include/token.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file ast.c
+ * @brief Создание, наполнение и освобождение узлов AST.
+ *
+ * Имена в узлах хранятся атомами (см. atom.h) и не освобождаются вместе с деревом;
+ * string_value принадлежит узлу.
+ *
+ * Узлы выделяются из арены, активной в текущем потоке, или из кучи. Арена — список
+ * блоков, в которых память выдаётся сдвигом указателя; отдельные узлы не освобождаются,
+ * всё дерево возвращается одним ast_arena_destroy().
+ */
+
+#define AST_ARENA_FIRST_BLOCK   (64 * 1024)
+#define AST_ARENA_MAX_BLOCK     (1024 * 1024)
+#define AST_ARENA_ALIGN         (sizeof(max_align_t))
+
+// Блок арены; данные выровнены как у malloc
+typedef struct ast_arena_block {
+    struct ast_arena_block *next;
+    size_t size;                // Ёмкость data в байтах
+    size_t used;                // Занято байт от начала data
+    max_align_t data[];
+} ast_arena_block_t;
+
+struct ast_arena {
+    ast_arena_block_t *head;    // Текущий блок (из него идёт выделение)
+    size_t next_block;          // Размер следующего обычного блока
+    size_t used;
+    size_t reserved;
+};
+
+// Арена, в которую ast_node_create() и ast_strndup() выделяют память в этом потоке
+static _Thread_local ast_arena_t *ast_current_arena;
+
+static size_t ast_arena_round(size_t size) {
+    return (size + AST_ARENA_ALIGN - 1) & ~(AST_ARENA_ALIGN - 1);
+}
+
+static ast_arena_block_t *ast_arena_new_block(ast_arena_t *arena, size_t size) {
+    ast_arena_block_t *block = malloc(sizeof(ast_arena_block_t) + size);
+    if (!block) return NULL;
+    block->size = size;
+    block->used = 0;
+    arena->reserved += size;
+    return block;
+}
+
+// Создание пустой арены; первый блок выделяется при первом обращении
+ast_arena_t *ast_arena_create(void) {
+    ast_arena_t *arena = calloc(1, sizeof(ast_arena_t));
+    if (!arena) return NULL;
+    arena->next_block = AST_ARENA_FIRST_BLOCK;
+    return arena;
+}
+
+// Освобождение всех блоков арены
+void ast_arena_destroy(ast_arena_t *arena) {
+    if (!arena) return;
+    if (ast_current_arena == arena) ast_current_arena = NULL;
+    ast_arena_block_t *block = arena->head;
+    while (block) {
+        ast_arena_block_t *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+ast_arena_t *ast_arena_activate(ast_arena_t *arena) {
+    ast_arena_t *previous = ast_current_arena;
+    ast_current_arena = arena;
+    return previous;
+}
+
+ast_arena_t *ast_arena_current(void) {
+    return ast_current_arena;
+}
+
+// Выделение сдвигом указателя. Крупный запрос получает отдельный блок за текущим,
+// чтобы не выбрасывать остаток текущего блока.
+void *ast_arena_alloc(ast_arena_t *arena, size_t size) {
+    if (!arena) return NULL;
+    size = ast_arena_round(size ? size : 1);
+
+    ast_arena_block_t *head = arena->head;
+    if (head && head->size - head->used >= size) {
+        void *ptr = (char *)head->data + head->used;
+        head->used += size;
+        arena->used += size;
+        return ptr;
+    }
+
+    if (head && size > arena->next_block / 4) {
+        ast_arena_block_t *block = ast_arena_new_block(arena, size);
+        if (!block) return NULL;
+        block->used = size;
+        block->next = head->next;
+        head->next = block;
+        arena->used += size;
+        return block->data;
+    }
+
+    size_t block_size = arena->next_block > size ? arena->next_block : size;
+    ast_arena_block_t *block = ast_arena_new_block(arena, block_size);
+    if (!block) return NULL;
+    if (arena->next_block < AST_ARENA_MAX_BLOCK) arena->next_block *= 2;
+    block->next = head;
+    block->used = size;
+    arena->head = block;
+    arena->used += size;
+    return block->data;
+}
+
+// Увеличение последнего выделения на месте, если за ним в текущем блоке есть место;
+// иначе новое выделение с копированием (старое остаётся в арене до её освобождения)
+static void *ast_arena_grow(ast_arena_t *arena, void *ptr, size_t old_size, size_t new_size) {
+    ast_arena_block_t *head = arena->head;
+    if (ptr && head) {
+        size_t old_rounded = ast_arena_round(old_size);
+        size_t new_rounded = ast_arena_round(new_size);
+        char *end = (char *)head->data + head->used;
+        if ((char *)ptr + old_rounded == end && head->size - head->used >= new_rounded - old_rounded) {
+            head->used += new_rounded - old_rounded;
+            arena->used += new_rounded - old_rounded;
+            return ptr;
+        }
+    }
+    void *grown = ast_arena_alloc(arena, new_size);
+    if (grown && ptr) memcpy(grown, ptr, old_size);
+    return grown;
+}
+
+size_t ast_arena_used(const ast_arena_t *arena) {
+    return arena ? arena->used : 0;
+}
+
+size_t ast_arena_reserved(const ast_arena_t *arena) {
+    return arena ? arena->reserved : 0;
+}
+
+// Создание нового узла AST заданного типа
+ASTNode *ast_node_create(ASTNodeType type) {
+    ast_arena_t *arena = ast_current_arena;
+    ASTNode *node;
+    if (arena) {
+        node = (ASTNode *)ast_arena_alloc(arena, sizeof(ASTNode));
+        if (!node) return NULL;
+        memset(node, 0, sizeof(ASTNode));
+        node->arena = arena;
+    } else {
+        node = (ASTNode *)calloc(1, sizeof(ASTNode));
+        if (!node) return NULL;
+    }
+    node->type = type;
+    node->atom = ATOM_NONE;
+    return node;
+}
+
+// Копия строки узла в активной арене или в куче
+char *ast_strndup(const char *text, size_t length) {
+    if (!text) return NULL;
+    ast_arena_t *arena = ast_current_arena;
+    char *copy = arena ? (char *)ast_arena_alloc(arena, length + 1) : (char *)malloc(length + 1);
+    if (!copy) return NULL;
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+char *ast_token_strdup(const Token *token) {
+    if (!token) return NULL;
+    return ast_strndup(token->text, token->length);
+}
+
+// Добавление дочернего узла.
+// Ёмкость массива не хранится: он растёт вдвое, когда число детей достигает степени двойки.
+void ast_node_add_child(ASTNode *parent, ASTNode *child) {
+    if (!parent || !child) return;
+
+    int count = parent->child_count;
+    if (count == 0 || (count & (count - 1)) == 0) {
+        int capacity = count ? count * 2 : 1;
+        ASTNode **children;
+        if (parent->arena) {
+            // Массив детей живёт в арене узла, даже если сейчас активна другая
+            children = (ASTNode **)ast_arena_grow(parent->arena, parent->children,
+                                                  (size_t)count * sizeof(ASTNode *),
+                                                  (size_t)capacity * sizeof(ASTNode *));
+        } else {
+            children = (ASTNode **)realloc(parent->children, (size_t)capacity * sizeof(ASTNode *));
+        }
+        if (!children) {
+            fprintf(stderr, "Out of memory while adding AST child\n");
+            exit(EXIT_FAILURE);
+        }
+        parent->children = children;
+    }
+    parent->children[parent->child_count++] = child;
+}
+
+// Имя узла для вывода и диагностики
+const char *ast_node_name(const ASTNode *node) {
+    if (!node) return NULL;
+    if (node->atom != ATOM_NONE) return atom_text(node->atom);
+    return node->string_value;
+}
+
+// Освобождение памяти узла AST и всех его потомков.
+// Обход идёт по явному стеку: глубокие цепочки IF/ELSEIF не переполняют стек вызовов.
+void ast_node_free(ASTNode *node) {
+    if (!node || node->arena) return;
+
+    ASTNode *local[64];
+    ASTNode **stack = local;
+    size_t capacity = sizeof(local) / sizeof(local[0]);
+    size_t depth = 0;
+    stack[depth++] = node;
+
+    while (depth > 0) {
+        ASTNode *current = stack[--depth];
+        for (int i = 0; i < current->child_count; i++) {
+            ASTNode *child = current->children[i];
+            if (!child || child->arena) continue;
+            if (depth == capacity) {
+                size_t grown_capacity = capacity * 2;
+                ASTNode **grown = stack == local ? malloc(grown_capacity * sizeof(ASTNode *))
+                                                 : realloc(stack, grown_capacity * sizeof(ASTNode *));
+                if (!grown) {
+                    // Без памяти под стек поддерево освобождается рекурсивно
+                    ast_node_free(child);
+                    continue;
+                }
+                if (stack == local) memcpy(grown, local, sizeof(local));
+                stack = grown;
+                capacity = grown_capacity;
+            }
+            stack[depth++] = child;
+        }
+        free(current->children);
+        free(current->string_value);
+        free(current);
+    }
+    if (stack != local) free(stack);
+}
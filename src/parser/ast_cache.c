@@ -0,0 +1,342 @@
+#include "../../include/ast_cache.h"
+#include "../../include/atom.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @file ast_cache.c
+ * @brief Запись плоского AST в файл кэша и загрузка через mmap.
+ *
+ * Секции файла идут за заголовком в порядке: узлы, смещения строк, пул строк,
+ * позиции, таблица имён. Каждая начинается с границы 8 байт, поэтому массивы
+ * узлов и смещений в отображении выровнены и читаются на месте.
+ */
+
+#define AST_CACHE_MAGIC      "ABAPAST"      // 7 символов и завершающий ноль — 8 байт
+#define AST_CACHE_VERSION    1u
+#define AST_CACHE_BYTE_ORDER 0x01020304u    // Файл с другим порядком байт читается как промах
+#define AST_CACHE_ALIGN      8u
+
+#define AST_CACHE_FNV_OFFSET 0xcbf29ce484222325ull
+#define AST_CACHE_FNV_PRIME  0x100000001b3ull
+
+// Заголовок файла; смещения секций — от начала файла, 0 — секции нет
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t kind_count;        // AST_NODE_TYPE_COUNT при записи: другой набор типов — промах
+    uint32_t node_count;
+    uint64_t source_hash;
+    uint64_t source_length;
+    uint32_t name_count;        // Имена 1..name_count; индекс 0 — ATOM_NONE
+    uint32_t reserved;
+    uint64_t string_length;     // Байт в пуле строк
+    uint64_t names_length;      // Байт текста имён
+    uint64_t nodes_offset;      // ast_flat_node_t[node_count]
+    uint64_t strings_offset;    // uint32_t[node_count]
+    uint64_t pool_offset;       // char[string_length]
+    uint64_t positions_offset;  // uint32_t[node_count]
+    uint64_t names_offset;      // uint32_t[name_count + 1] — границы имён, затем текст
+} ast_cache_header_t;
+
+uint64_t ast_cache_hash(const char *source, size_t length) {
+    uint64_t hash = AST_CACHE_FNV_OFFSET;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)source[i];
+        hash *= AST_CACHE_FNV_PRIME;
+    }
+    return hash;
+}
+
+bool ast_cache_path(char *out, size_t size, const char *dir, uint64_t hash) {
+    int written = snprintf(out, size, "%s/%016llx.ast", dir, (unsigned long long)hash);
+    return written > 0 && (size_t)written < size;
+}
+
+static uint64_t ast_cache_align(uint64_t offset) {
+    return (offset + AST_CACHE_ALIGN - 1) & ~(uint64_t)(AST_CACHE_ALIGN - 1);
+}
+
+// Запись секции с дополнением до границы выравнивания
+static bool ast_cache_write(FILE *file, const void *data, size_t bytes, uint64_t *offset) {
+    static const char padding[AST_CACHE_ALIGN] = { 0 };
+    if (bytes && fwrite(data, 1, bytes, file) != bytes) return false;
+    uint64_t end = *offset + bytes;
+    size_t pad = (size_t)(ast_cache_align(end) - end);
+    if (pad && fwrite(padding, 1, pad, file) != pad) return false;
+    *offset = end + pad;
+    return true;
+}
+
+/**
+ * @brief Запись дерева: атомы узлов заменяются индексами в таблице имён файла.
+ */
+bool ast_cache_store(const char *dir, uint64_t hash, size_t source_length, const ast_flat_t *tree) {
+    if (tree->open != AST_FLAT_NONE) return false;
+
+    char path[4096], temp[4096 + 32];
+    if (!ast_cache_path(path, sizeof(path), dir, hash)) return false;
+    snprintf(temp, sizeof(temp), "%s.%ld.tmp", path, (long)getpid());
+
+    uint32_t count = tree->count;
+    size_t atoms = atom_count();
+    uint32_t *local = calloc(atoms + 1, sizeof(uint32_t));      // Атом процесса → индекс имени
+    atom_t *names = malloc(((size_t)count + 1) * sizeof(atom_t));
+    ast_flat_node_t *nodes = malloc(((size_t)count + 1) * sizeof(ast_flat_node_t));
+    uint32_t *bounds = NULL;
+    bool ok = local && names && nodes;
+
+    uint32_t name_count = 0;
+    uint64_t names_length = 0;
+    for (uint32_t i = 0; ok && i < count; i++) {
+        nodes[i] = tree->nodes[i];
+        atom_t atom = ast_flat_atom(tree, i);
+        if (atom == ATOM_NONE) continue;
+        if (atom > atoms) {
+            ok = false;     // Атом не из этой таблицы
+            break;
+        }
+        if (!local[atom]) {
+            local[atom] = ++name_count;
+            names[name_count - 1] = atom;
+            names_length += atom_length(atom);
+        }
+        nodes[i].atom = local[atom];
+    }
+
+    if (ok) {
+        bounds = malloc(((size_t)name_count + 1) * sizeof(uint32_t));
+        ok = bounds != NULL && names_length < UINT32_MAX;
+    }
+    if (ok) {
+        bounds[0] = 0;
+        for (uint32_t k = 0; k < name_count; k++) bounds[k + 1] = bounds[k] + atom_length(names[k]);
+    }
+
+    ast_cache_header_t header = { 0 };
+    if (ok) {
+        memcpy(header.magic, AST_CACHE_MAGIC, sizeof(header.magic));
+        header.version = AST_CACHE_VERSION;
+        header.byte_order = AST_CACHE_BYTE_ORDER;
+        header.kind_count = AST_NODE_TYPE_COUNT;
+        header.node_count = count;
+        header.source_hash = hash;
+        header.source_length = source_length;
+        header.name_count = name_count;
+        header.string_length = tree->strings ? tree->string_length : 0;
+        header.names_length = names_length;
+
+        // Раскладка секций
+        uint64_t offset = ast_cache_align(sizeof(header));
+        header.nodes_offset = offset;
+        offset = ast_cache_align(offset + (uint64_t)count * sizeof(ast_flat_node_t));
+        if (tree->strings) {
+            header.strings_offset = offset;
+            offset = ast_cache_align(offset + (uint64_t)count * sizeof(uint32_t));
+            header.pool_offset = offset;
+            offset = ast_cache_align(offset + header.string_length);
+        }
+        if (tree->positions) {
+            header.positions_offset = offset;
+            offset = ast_cache_align(offset + (uint64_t)count * sizeof(uint32_t));
+        }
+        header.names_offset = offset;
+    }
+
+    FILE *file = ok ? fopen(temp, "wb") : NULL;
+    if (ok && !file) {
+        fprintf(stderr, "Cannot create AST cache file %s: %s\n", temp, strerror(errno));
+        ok = false;
+    }
+    if (file) {
+        uint64_t offset = 0;
+        ok = ast_cache_write(file, &header, sizeof(header), &offset) &&
+             ast_cache_write(file, nodes, (size_t)count * sizeof(ast_flat_node_t), &offset);
+        if (ok && tree->strings) {
+            ok = ast_cache_write(file, tree->strings, (size_t)count * sizeof(uint32_t), &offset) &&
+                 ast_cache_write(file, tree->string_pool, (size_t)header.string_length, &offset);
+        }
+        if (ok && tree->positions) {
+            ok = ast_cache_write(file, tree->positions, (size_t)count * sizeof(uint32_t), &offset);
+        }
+        // Текст имён идёт сразу за границами, без выравнивания
+        size_t bounds_size = ((size_t)name_count + 1) * sizeof(uint32_t);
+        if (ok) ok = fwrite(bounds, 1, bounds_size, file) == bounds_size;
+        for (uint32_t k = 0; ok && k < name_count; k++) {
+            size_t length = atom_length(names[k]);
+            ok = fwrite(atom_text(names[k]), 1, length, file) == length;
+        }
+        if (fclose(file) != 0) ok = false;
+        // Переименование атомарно: читатель не увидит недописанный файл
+        if (ok && rename(temp, path) != 0) {
+            fprintf(stderr, "Cannot write AST cache file %s: %s\n", path, strerror(errno));
+            ok = false;
+        }
+        if (!ok) remove(temp);
+    }
+
+    free(local);
+    free(names);
+    free(nodes);
+    free(bounds);
+    return ok;
+}
+
+// Секция [offset, offset + bytes) целиком в файле и выровнена на AST_CACHE_ALIGN,
+// как её пишет ast_cache_write()
+static bool ast_cache_section_fits(uint64_t offset, uint64_t bytes, size_t size) {
+    return offset % AST_CACHE_ALIGN == 0 && offset <= size && bytes <= size - offset;
+}
+
+// Проверка заголовка и границ секций
+static bool ast_cache_validate(const ast_cache_header_t *header, size_t size, uint64_t hash, size_t source_length) {
+    if (memcmp(header->magic, AST_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != AST_CACHE_VERSION ||
+        header->byte_order != AST_CACHE_BYTE_ORDER ||
+        header->kind_count != AST_NODE_TYPE_COUNT ||
+        header->source_hash != hash ||
+        header->source_length != source_length) {
+        return false;
+    }
+
+    uint64_t count = header->node_count;
+    if (header->name_count >= size / sizeof(uint32_t)) return false;
+    if (!ast_cache_section_fits(header->nodes_offset, count * sizeof(ast_flat_node_t), size)) return false;
+    if (header->strings_offset &&
+        (!ast_cache_section_fits(header->strings_offset, count * sizeof(uint32_t), size) ||
+         !ast_cache_section_fits(header->pool_offset, header->string_length, size))) {
+        return false;
+    }
+    if (header->positions_offset &&
+        !ast_cache_section_fits(header->positions_offset, count * sizeof(uint32_t), size)) {
+        return false;
+    }
+    // Границы имён, затем текст; names_length из файла не складывается с границами,
+    // чтобы сумма не переполнилась
+    uint64_t bounds = ((uint64_t)header->name_count + 1) * sizeof(uint32_t);
+    return ast_cache_section_fits(header->names_offset, bounds, size) &&
+           header->names_length <= size - header->names_offset - bounds;
+}
+
+/**
+ * @brief Проверка узлов: дерево из файла читается без проверок (ast_flat_atom(),
+ *        ast_flat_end(), ast_flat_string()), поэтому каждая ссылка узла должна
+ *        указывать внутрь своей таблицы, а поддеревья — вкладываться друг в друга.
+ */
+static bool ast_cache_validate_nodes(const ast_cache_header_t *header, const char *base) {
+    uint32_t count = header->node_count;
+    const ast_flat_node_t *nodes = (const ast_flat_node_t *)(base + header->nodes_offset);
+    const uint32_t *strings = header->strings_offset ? (const uint32_t *)(base + header->strings_offset) : NULL;
+    const char *pool = base + header->pool_offset;
+
+    // Строка узла читается до нуля: пул обязан им заканчиваться
+    if (strings && header->string_length && pool[header->string_length - 1] != '\0') return false;
+    if (count == 0) return true;
+    if (nodes[0].subtree != count) return false;
+
+    // Концы открытых поддеревьев: поддерево потомка не выходит за поддерево предка
+    uint32_t *ends = malloc((size_t)count * sizeof(uint32_t));
+    if (!ends) return false;
+    uint32_t depth = 0;
+    bool ok = true;
+    for (uint32_t i = 0; ok && i < count; i++) {
+        const ast_flat_node_t *node = &nodes[i];
+        uint32_t flags = node->kind & ~AST_FLAT_KIND_MASK;
+        uint32_t subtree = node->subtree;
+        while (depth > 0 && ends[depth - 1] <= i) depth--;
+        ok = (node->kind & AST_FLAT_KIND_MASK) < AST_NODE_TYPE_COUNT &&
+             (flags & ~(AST_FLAT_HAS_STRING | AST_FLAT_HAS_ATOM)) == 0 &&
+             node->atom <= header->name_count &&
+             subtree >= 1 && subtree <= count - i &&
+             (depth == 0 ? i == 0 : i + subtree <= ends[depth - 1]) &&
+             node->first_child == (subtree == 1 ? AST_FLAT_NONE : i + 1);
+        if (ok && (flags & AST_FLAT_HAS_STRING)) {
+            ok = strings != NULL && strings[i] < header->string_length;
+        }
+        if (ok) ends[depth++] = i + subtree;
+    }
+    free(ends);
+    return ok;
+}
+
+/**
+ * @brief Загрузка: отображение файла и интернирование его таблицы имён.
+ */
+bool ast_cache_load(ast_cache_entry_t *entry, const char *dir, uint64_t hash, size_t source_length) {
+    memset(entry, 0, sizeof(*entry));
+    ast_flat_init(&entry->tree);
+
+    char path[4096];
+    if (!ast_cache_path(path, sizeof(path), dir, hash)) return false;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        if (errno != ENOENT) fprintf(stderr, "Cannot open AST cache file %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || (size_t)st.st_size < sizeof(ast_cache_header_t)) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    const char *base = mapping;
+    const ast_cache_header_t *header = mapping;
+    if (!ast_cache_validate(header, size, hash, source_length) || !ast_cache_validate_nodes(header, base)) {
+        munmap(mapping, size);
+        return false;
+    }
+
+    // Таблица имён: границы, затем текст; индекс 0 остаётся ATOM_NONE
+    uint32_t name_count = header->name_count;
+    const uint32_t *bounds = (const uint32_t *)(base + header->names_offset);
+    const char *text = (const char *)(bounds + name_count + 1);
+    atom_t *atoms = malloc(((size_t)name_count + 1) * sizeof(atom_t));
+    bool ok = atoms != NULL && bounds[0] == 0 && bounds[name_count] == header->names_length;
+    if (ok) atoms[0] = ATOM_NONE;
+    for (uint32_t k = 0; ok && k < name_count; k++) {
+        ok = bounds[k] < bounds[k + 1] && bounds[k + 1] <= header->names_length;
+        if (ok) atoms[k + 1] = atom_intern(text + bounds[k], bounds[k + 1] - bounds[k]);
+    }
+    if (!ok) {
+        free(atoms);
+        munmap(mapping, size);
+        return false;
+    }
+
+    ast_flat_t *tree = &entry->tree;
+    tree->nodes = (ast_flat_node_t *)(base + header->nodes_offset);
+    tree->count = tree->capacity = header->node_count;
+    if (header->strings_offset) {
+        tree->strings = (uint32_t *)(base + header->strings_offset);
+        tree->string_pool = (char *)(base + header->pool_offset);
+        tree->string_length = tree->string_capacity = (size_t)header->string_length;
+    }
+    if (header->positions_offset) tree->positions = (uint32_t *)(base + header->positions_offset);
+    tree->atom_map = atoms;
+    tree->readonly = true;
+
+    entry->mapping = mapping;
+    entry->mapping_size = size;
+    entry->atoms = atoms;
+    return true;
+}
+
+void ast_cache_close(ast_cache_entry_t *entry) {
+    if (entry->mapping) munmap(entry->mapping, entry->mapping_size);
+    free(entry->atoms);
+    memset(entry, 0, sizeof(*entry));
+    ast_flat_init(&entry->tree);
+}
@@ -0,0 +1,283 @@
+#include "../../include/ast_flat.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file ast_flat.c
+ * @brief Построение плоского AST (массив узлов в прямом порядке обхода).
+ *
+ * Открытые узлы образуют цепочку через поле subtree: пока узел открыт, в нём
+ * хранится индекс его родителя, и ast_flat_close() возвращает open к родителю.
+ * Отдельный стек для построения не нужен.
+ */
+
+#define AST_FLAT_INITIAL_CAPACITY 256
+#define AST_FLAT_INITIAL_STRINGS  1024
+
+void ast_flat_init(ast_flat_t *tree) {
+    memset(tree, 0, sizeof(ast_flat_t));
+    tree->open = AST_FLAT_NONE;
+}
+
+void ast_flat_free(ast_flat_t *tree) {
+    // Массивы дерева из кэша освобождает ast_cache_close()
+    if (tree->readonly) return;
+    free(tree->nodes);
+    free(tree->strings);
+    free(tree->string_pool);
+    free(tree->positions);
+    ast_flat_init(tree);
+}
+
+static bool ast_flat_reserve(ast_flat_t *tree, uint32_t need) {
+    if (need <= tree->capacity) return true;
+    if (need == AST_FLAT_NONE || tree->readonly) return false;
+    uint32_t capacity = tree->capacity ? tree->capacity : AST_FLAT_INITIAL_CAPACITY;
+    while (capacity < need) {
+        capacity = capacity > UINT32_MAX / 2 ? UINT32_MAX - 1 : capacity * 2;
+    }
+    ast_flat_node_t *nodes = realloc(tree->nodes, (size_t)capacity * sizeof(ast_flat_node_t));
+    if (!nodes) return false;
+    tree->nodes = nodes;
+    if (tree->strings) {
+        uint32_t *strings = realloc(tree->strings, (size_t)capacity * sizeof(uint32_t));
+        if (!strings) return false;
+        tree->strings = strings;
+    }
+    if (tree->positions) {
+        uint32_t *positions = realloc(tree->positions, (size_t)capacity * sizeof(uint32_t));
+        if (!positions) return false;
+        tree->positions = positions;
+    }
+    tree->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Открывает узел потомком последнего открытого узла.
+ */
+uint32_t ast_flat_open(ast_flat_t *tree, ASTNodeType kind, atom_t atom) {
+    if (!ast_flat_reserve(tree, tree->count + 1)) return AST_FLAT_NONE;
+
+    uint32_t index = tree->count++;
+    ast_flat_node_t *node = &tree->nodes[index];
+    node->kind = ((uint32_t)kind & AST_FLAT_KIND_MASK) | (atom != ATOM_NONE ? AST_FLAT_HAS_ATOM : 0);
+    node->first_child = AST_FLAT_NONE;
+    node->subtree = tree->open;     // Родитель, пока узел открыт
+    node->atom = atom;
+    if (tree->positions) tree->positions[index] = AST_FLAT_NONE;
+
+    if (tree->open != AST_FLAT_NONE && tree->nodes[tree->open].first_child == AST_FLAT_NONE) {
+        tree->nodes[tree->open].first_child = index;
+    }
+    tree->open = index;
+    return index;
+}
+
+/**
+ * @brief Закрывает узел: все узлы после него становятся его поддеревом.
+ */
+void ast_flat_close(ast_flat_t *tree, uint32_t index) {
+    if (index >= tree->count) return;
+    tree->open = tree->nodes[index].subtree;
+    tree->nodes[index].subtree = tree->count - index;
+}
+
+/**
+ * @brief Копирует строку узла в пул дерева.
+ */
+bool ast_flat_set_string(ast_flat_t *tree, uint32_t index, const char *text, size_t length) {
+    if (index >= tree->count || !text || tree->readonly) return false;
+    if (!tree->strings) {
+        // Массив смещений создаётся только у деревьев, где есть строки
+        tree->strings = calloc(tree->capacity, sizeof(uint32_t));
+        if (!tree->strings) return false;
+    }
+    if (tree->string_length + length + 1 > UINT32_MAX) return false;
+    if (tree->string_length + length + 1 > tree->string_capacity) {
+        size_t capacity = tree->string_capacity ? tree->string_capacity : AST_FLAT_INITIAL_STRINGS;
+        while (capacity < tree->string_length + length + 1) capacity *= 2;
+        char *pool = realloc(tree->string_pool, capacity);
+        if (!pool) return false;
+        tree->string_pool = pool;
+        tree->string_capacity = capacity;
+    }
+    memcpy(tree->string_pool + tree->string_length, text, length);
+    tree->string_pool[tree->string_length + length] = '\0';
+    tree->strings[index] = (uint32_t)tree->string_length;
+    tree->string_length += length + 1;
+    tree->nodes[index].kind |= AST_FLAT_HAS_STRING;
+    return true;
+}
+
+/**
+ * @brief Записывает смещение узла в исходном тексте.
+ */
+bool ast_flat_set_position(ast_flat_t *tree, uint32_t index, uint32_t offset) {
+    if (index >= tree->count || tree->readonly) return false;
+    if (!tree->positions) {
+        tree->positions = malloc((size_t)tree->capacity * sizeof(uint32_t));
+        if (!tree->positions) return false;
+        memset(tree->positions, 0xFF, (size_t)tree->capacity * sizeof(uint32_t));
+    }
+    tree->positions[index] = offset;
+    return true;
+}
+
+/**
+ * @brief Записывает смещения непосредственных потомков узла проходом по братьям.
+ */
+bool ast_flat_set_child_positions(ast_flat_t *tree, uint32_t index, const uint32_t *offsets) {
+    if (index >= tree->count || tree->readonly) return false;
+    uint32_t end = ast_flat_end(tree, index);
+    uint32_t n = 0;
+    for (uint32_t child = tree->nodes[index].first_child; child != AST_FLAT_NONE && child < end;
+         child = ast_flat_end(tree, child)) {
+        if (!ast_flat_set_position(tree, child, offsets[n++])) return false;
+    }
+    return true;
+}
+
+// Кадр обхода исходного дерева: узел, его индекс в плоском дереве и следующий потомок
+typedef struct {
+    const ASTNode *node;
+    uint32_t index;
+    int next_child;
+} ast_flat_frame_t;
+
+/**
+ * @brief Строит плоское дерево по ASTNode обходом с явным стеком.
+ */
+bool ast_flat_build(ast_flat_t *tree, const ASTNode *root) {
+    if (tree->readonly) return false;
+    tree->count = 0;
+    tree->string_length = 0;
+    tree->open = AST_FLAT_NONE;
+    if (!root) return true;
+
+    size_t capacity = 64, depth = 0;
+    ast_flat_frame_t *stack = malloc(capacity * sizeof(ast_flat_frame_t));
+    if (!stack) return false;
+
+    bool ok = true;
+    const ASTNode *pending = root;
+    while (ok) {
+        if (pending) {
+            uint32_t index = ast_flat_open(tree, pending->type, pending->atom);
+            ok = index != AST_FLAT_NONE;
+            if (ok && pending->string_value) {
+                ok = ast_flat_set_string(tree, index, pending->string_value, strlen(pending->string_value));
+            }
+            if (ok && depth == capacity) {
+                ast_flat_frame_t *grown = realloc(stack, capacity * 2 * sizeof(ast_flat_frame_t));
+                ok = grown != NULL;
+                if (grown) {
+                    stack = grown;
+                    capacity *= 2;
+                }
+            }
+            if (!ok) break;
+            stack[depth++] = (ast_flat_frame_t){ pending, index, 0 };
+            pending = NULL;
+        }
+        if (depth == 0) break;
+
+        ast_flat_frame_t *top = &stack[depth - 1];
+        while (top->next_child < top->node->child_count && !top->node->children[top->next_child]) {
+            top->next_child++;
+        }
+        if (top->next_child < top->node->child_count) {
+            pending = top->node->children[top->next_child++];
+        } else {
+            ast_flat_close(tree, top->index);
+            depth--;
+        }
+    }
+
+    free(stack);
+    if (!ok) {
+        fprintf(stderr, "Out of memory while flattening AST\n");
+        tree->count = 0;
+        tree->open = AST_FLAT_NONE;
+    }
+    return ok;
+}
+
+// Открытый предок при восстановлении ASTNode: узел и конец его поддерева
+typedef struct {
+    ASTNode *node;
+    uint32_t end;
+} ast_flat_ancestor_t;
+
+/**
+ * @brief Восстанавливает ASTNode одним проходом по массиву: предки, чьё поддерево
+ *        закончилось, снимаются со стека, новый узел становится потомком вершины.
+ */
+ASTNode *ast_flat_expand(const ast_flat_t *tree, uint32_t root) {
+    if (!tree || root >= tree->count) return NULL;
+
+    size_t capacity = 64, depth = 0;
+    ast_flat_ancestor_t *stack = malloc(capacity * sizeof(ast_flat_ancestor_t));
+    if (!stack) return NULL;
+
+    ASTNode *result = NULL;
+    bool ok = true;
+    uint32_t end = ast_flat_end(tree, root);
+    for (uint32_t index = root; ok && index < end; index++) {
+        ASTNode *node = ast_node_create(ast_flat_kind(tree, index));
+        ok = node != NULL;
+        if (!ok) break;
+        node->atom = ast_flat_atom(tree, index);
+        const char *text = ast_flat_string(tree, index);
+        if (text) {
+            node->string_value = ast_strndup(text, strlen(text));
+            ok = node->string_value != NULL;
+        }
+
+        while (depth > 0 && stack[depth - 1].end <= index) depth--;
+        if (depth > 0) ast_node_add_child(stack[depth - 1].node, node);
+        else result = node;
+        if (!ok) break;
+
+        if (depth == capacity) {
+            ast_flat_ancestor_t *grown = realloc(stack, capacity * 2 * sizeof(ast_flat_ancestor_t));
+            ok = grown != NULL;
+            if (!ok) break;
+            stack = grown;
+            capacity *= 2;
+        }
+        stack[depth++] = (ast_flat_ancestor_t){ node, ast_flat_end(tree, index) };
+    }
+
+    free(stack);
+    if (!ok) {
+        fprintf(stderr, "Out of memory while expanding flat AST\n");
+        ast_node_free(result);
+        return NULL;
+    }
+    return result;
+}
+
+/**
+ * @brief Количество непосредственных потомков узла.
+ */
+uint32_t ast_flat_child_count(const ast_flat_t *tree, uint32_t index) {
+    uint32_t count = 0;
+    uint32_t end = ast_flat_end(tree, index);
+    for (uint32_t child = index + 1; child < end; child += tree->nodes[child].subtree) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief n-й непосредственный потомок узла.
+ */
+uint32_t ast_flat_child(const ast_flat_t *tree, uint32_t index, uint32_t n) {
+    uint32_t end = ast_flat_end(tree, index);
+    for (uint32_t child = index + 1; child < end; child += tree->nodes[child].subtree) {
+        if (n-- == 0) return child;
+    }
+    return AST_FLAT_NONE;
+}
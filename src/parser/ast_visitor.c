@@ -0,0 +1,193 @@
+#include "../../include/ast_visitor.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file ast_visitor.c
+ * @brief Линейный обход плоского AST и обход дерева ASTNode по явному стеку.
+ */
+
+#define AST_VISIT_LOCAL_FRAMES   64
+#define AST_VISIT_LOCAL_VISITORS 8
+#define AST_VISIT_ACTIVE         UINT32_MAX
+
+/**
+ * @brief Обход поддерева root в прямом порядке с возможностью пропуска поддеревьев.
+ */
+void ast_flat_visit(const ast_flat_t *tree, uint32_t root, ast_flat_visit_fn visit, void *arg) {
+    if (!tree || !visit || root >= tree->count) return;
+
+    uint32_t end = ast_flat_end(tree, root);
+    uint32_t index = root;
+    while (index < end) {
+        index = visit(tree, index, arg) ? index + 1 : ast_flat_end(tree, index);
+    }
+}
+
+/**
+ * @brief Посещение всех узлов заданного типа одним проходом по массиву.
+ */
+size_t ast_flat_visit_kind(const ast_flat_t *tree, ASTNodeType kind, ast_flat_visit_fn visit, void *arg) {
+    if (!tree) return 0;
+
+    size_t found = 0;
+    const ast_flat_node_t *nodes = tree->nodes;
+    for (uint32_t index = 0; index < tree->count; index++) {
+        if ((nodes[index].kind & AST_FLAT_KIND_MASK) != (uint32_t)kind) continue;
+        found++;
+        if (visit) visit(tree, index, arg);
+    }
+    return found;
+}
+
+/**
+ * @brief Родитель узла: ближайший предшественник, чьё поддерево содержит index.
+ */
+uint32_t ast_flat_parent(const ast_flat_t *tree, uint32_t index) {
+    if (!tree || index == 0 || index >= tree->count) return AST_FLAT_NONE;
+    for (uint32_t candidate = index; candidate-- > 0; ) {
+        if (ast_flat_end(tree, candidate) > index) return candidate;
+    }
+    return AST_FLAT_NONE;
+}
+
+// Кадр обхода: открытый узел и следующий непросмотренный потомок
+typedef struct {
+    ASTNode *node;
+    int next_child;
+} ast_visit_frame_t;
+
+// Состояние визитора в обходе: глубина узла, чьё поддерево он пропускает, и остановка
+typedef struct {
+    uint32_t skip_depth;    // AST_VISIT_ACTIVE — визитор видит текущее поддерево
+    bool stopped;
+} ast_visit_state_t;
+
+typedef struct {
+    const ast_visitor_t *const *visitors;
+    ast_visit_state_t *states;
+    size_t count;
+    size_t running;         // Сколько визиторов не остановлено
+} ast_visit_walk_t;
+
+// Вызов функций до потомков. Возвращает true, если хотя бы один визитор спускается в поддерево.
+static bool ast_visit_enter(ast_visit_walk_t *walk, ASTNode *node, ASTNode *parent, uint32_t depth) {
+    bool descend = false;
+    for (size_t i = 0; i < walk->count; i++) {
+        ast_visit_state_t *state = &walk->states[i];
+        if (state->stopped || state->skip_depth != AST_VISIT_ACTIVE) continue;
+
+        const ast_visitor_t *visitor = walk->visitors[i];
+        ast_visit_result_t result = AST_VISIT_CONTINUE;
+        if (visitor->pre_any) result = visitor->pre_any(node, parent, visitor->arg);
+        if (result == AST_VISIT_CONTINUE && (unsigned)node->type < AST_NODE_TYPE_COUNT &&
+            visitor->pre[node->type]) {
+            result = visitor->pre[node->type](node, parent, visitor->arg);
+        }
+
+        if (result == AST_VISIT_STOP) {
+            state->stopped = true;
+            walk->running--;
+        } else if (result == AST_VISIT_SKIP) {
+            state->skip_depth = depth;
+        } else {
+            descend = true;
+        }
+    }
+    return descend;
+}
+
+// Вызов функций после потомков для визиторов, которые видели узел
+static void ast_visit_leave(ast_visit_walk_t *walk, ASTNode *node, ASTNode *parent, uint32_t depth) {
+    for (size_t i = 0; i < walk->count; i++) {
+        ast_visit_state_t *state = &walk->states[i];
+        if (state->stopped) continue;
+        if (state->skip_depth != AST_VISIT_ACTIVE) {
+            if (state->skip_depth != depth) continue;   // Узел внутри пропущенного поддерева
+            state->skip_depth = AST_VISIT_ACTIVE;       // Закрывается сам пропущенный узел
+        }
+
+        const ast_visitor_t *visitor = walk->visitors[i];
+        ast_visit_result_t result = AST_VISIT_CONTINUE;
+        if ((unsigned)node->type < AST_NODE_TYPE_COUNT && visitor->post[node->type]) {
+            result = visitor->post[node->type](node, parent, visitor->arg);
+        }
+        if (result != AST_VISIT_STOP && visitor->post_any) {
+            result = visitor->post_any(node, parent, visitor->arg);
+        }
+        if (result == AST_VISIT_STOP) {
+            state->stopped = true;
+            walk->running--;
+        }
+    }
+}
+
+/**
+ * @brief Обход дерева для нескольких визиторов по явному стеку кадров.
+ */
+bool ast_visit_fused(ASTNode *root, const ast_visitor_t *const *visitors, size_t count) {
+    if (!root || !visitors || count == 0) return true;
+
+    ast_visit_state_t local_states[AST_VISIT_LOCAL_VISITORS];
+    ast_visit_state_t *states = count <= AST_VISIT_LOCAL_VISITORS ? local_states
+                                                                  : malloc(count * sizeof(ast_visit_state_t));
+    if (!states) return false;
+    for (size_t i = 0; i < count; i++) {
+        states[i] = (ast_visit_state_t){ AST_VISIT_ACTIVE, visitors[i] == NULL };
+    }
+
+    ast_visit_walk_t walk = { visitors, states, count, 0 };
+    for (size_t i = 0; i < count; i++) {
+        if (!states[i].stopped) walk.running++;
+    }
+
+    ast_visit_frame_t local_frames[AST_VISIT_LOCAL_FRAMES];
+    ast_visit_frame_t *frames = local_frames;
+    size_t capacity = AST_VISIT_LOCAL_FRAMES;
+    size_t depth = 0;
+    bool ok = true;
+
+    // Узел без спускающихся визиторов открывается с исчерпанным списком потомков
+    bool descend = walk.running > 0 && ast_visit_enter(&walk, root, NULL, 0);
+    frames[depth++] = (ast_visit_frame_t){ root, descend ? 0 : root->child_count };
+
+    while (depth > 0 && walk.running > 0) {
+        ast_visit_frame_t *top = &frames[depth - 1];
+        while (top->next_child < top->node->child_count && !top->node->children[top->next_child]) {
+            top->next_child++;
+        }
+
+        if (top->next_child == top->node->child_count) {
+            ASTNode *parent = depth > 1 ? frames[depth - 2].node : NULL;
+            ast_visit_leave(&walk, top->node, parent, (uint32_t)(depth - 1));
+            depth--;
+            continue;
+        }
+
+        ASTNode *child = top->node->children[top->next_child++];
+        if (depth == capacity) {
+            size_t grown_capacity = capacity * 2;
+            ast_visit_frame_t *grown = frames == local_frames
+                ? malloc(grown_capacity * sizeof(ast_visit_frame_t))
+                : realloc(frames, grown_capacity * sizeof(ast_visit_frame_t));
+            if (!grown) {
+                ok = false;
+                break;
+            }
+            if (frames == local_frames) memcpy(grown, local_frames, sizeof(local_frames));
+            frames = grown;
+            capacity = grown_capacity;
+            top = &frames[depth - 1];
+        }
+        descend = ast_visit_enter(&walk, child, top->node, (uint32_t)depth);
+        frames[depth++] = (ast_visit_frame_t){ child, descend ? 0 : child->child_count };
+    }
+
+    if (frames != local_frames) free(frames);
+    if (states != local_states) free(states);
+    return ok;
+}
+
+bool ast_visit(ASTNode *root, const ast_visitor_t *visitor) {
+    return ast_visit_fused(root, &visitor, 1);
+}
@@ -2,19 +2,37 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 
+// Дополнение со списком привязок name = value; пустой список — ошибка
+static bool parse_call_function_bindings(TokenStream *ts, ASTNode *call_node, const char *keyword) {
+    ASTNode *clause = parser_add_clause(call_node, keyword);
+    if (!clause || !parse_bindings(ts, clause)) return false;
+    if (clause->child_count == 0) {
+        report_error("Expected 'name = value' after %s", keyword);
+        return false;
+    }
+    return true;
+}
+
 /**
  * parse_call_function_complex - Полноценный парсер конструкции CALL FUNCTION.
  *
  * Синтаксис:
- * CALL FUNCTION <name | (expression)>
+ * CALL FUNCTION <'name' | name | (expression)>
+ *   [DESTINATION dest | IN UPDATE TASK | IN BACKGROUND TASK | STARTING NEW TASK task]
  *   [EXPORTING ...]
  *   [IMPORTING ...]
  *   [CHANGING ...]
  *   [TABLES ...]
  *   [EXCEPTIONS ...].
  *
+ * string_value узла AST_CALL_FUNCTION — текст литерала с именем; при динамическом имени
+ * (переменная или выражение в скобках) оно первый потомок, а string_value пуст. Списки
+ * параметров — дополнения AST_STATEMENT_CLAUSE с узлами AST_PARAMETER_BINDING.
+ *
  * Возвращает AST узел вызова функции или NULL при ошибке.
  */
 ASTNode *parse_call_function_complex(TokenStream *ts) {
@@ -23,82 +41,65 @@ ASTNode *parse_call_function_complex(TokenStream *ts) {
         return NULL;
     }
 
-    Token *token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_CALL) {
-        report_error("Expected CALL keyword");
+    if (!parser_expect(ts, TOKEN_KEYWORD_CALL, "CALL keyword") ||
+        !parser_expect(ts, TOKEN_KEYWORD_FUNCTION, "FUNCTION keyword")) {
         return NULL;
     }
 
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_FUNCTION) {
-        report_error("Expected FUNCTION keyword");
+    ASTNode *call_node = ast_node_create(AST_CALL_FUNCTION);
+    if (!call_node) {
+        report_error("Failed to create AST node for CALL FUNCTION");
         return NULL;
     }
 
     // Статический или динамический вызов
-    ASTNode *call_node = NULL;
-    token = token_stream_peek(ts);
-    if (!token) {
-        report_error("Unexpected end of input after CALL FUNCTION");
-        return NULL;
-    }
-
-    if (token->type == TOKEN_LPAREN) {
-        call_node = ast_node_create(AST_CALL_FUNCTION_DYNAMIC);
-        token_stream_next(ts);  // '('
-        call_node->dynamic_function_expr = parse_expression(ts);
-        if (!call_node->dynamic_function_expr) {
-            report_error("Failed to parse dynamic function name expression");
-            ast_node_free(call_node);
-            return NULL;
-        }
-        token = token_stream_next(ts);
-        if (!token || token->type != TOKEN_RPAREN) {
-            report_error("Expected ')' after dynamic function name");
-            ast_node_free(call_node);
-            return NULL;
+    Token token = token_stream_peek(ts);
+    if (token.type == TOKEN_LITERAL_STRING || token.type == TOKEN_LITERAL_CHAR) {
+        token_stream_advance(ts);
+        if (!(call_node->string_value = ast_token_strdup(&token))) {
+            report_error("Memory allocation failed for function name");
+            return call_node;
         }
-    } else if (token->type == TOKEN_IDENTIFIER) {
-        call_node = ast_node_create(AST_CALL_FUNCTION);
-        token = token_stream_next(ts);
-        call_node->function_name = strdup(token->text);
+    } else if (token.type == TOKEN_IDENTIFIER || token.type == TOKEN_PUNCTUATION_LPAREN) {
+        ASTNode *name = parse_expression_prec(ts, PARSER_PREC_CONCAT);
+        if (!name) return call_node;
+        ast_node_add_child(call_node, name);
     } else {
         report_error("Expected function name or dynamic expression");
-        return NULL;
-    }
-
-    if (!call_node) {
-        report_error("Failed to create AST node for CALL FUNCTION");
-        return NULL;
+        return call_node;
     }
 
-    // Чтение параметров
-    while ((token = token_stream_peek(ts)) != NULL) {
-        if (token->type == TOKEN_KEYWORD_EXPORTING) {
-            token_stream_next(ts);
-            call_node->exporting_params = parse_parameter_list(ts);
-        } else if (token->type == TOKEN_KEYWORD_IMPORTING) {
-            token_stream_next(ts);
-            call_node->importing_params = parse_parameter_list(ts);
-        } else if (token->type == TOKEN_KEYWORD_CHANGING) {
-            token_stream_next(ts);
-            call_node->changing_params = parse_parameter_list(ts);
-        } else if (token->type == TOKEN_KEYWORD_TABLES) {
-            token_stream_next(ts);
-            call_node->tables_params = parse_parameter_list(ts);
-        } else if (token->type == TOKEN_KEYWORD_EXCEPTIONS) {
-            call_node->exceptions = parse_call_function_exceptions(ts);
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF; ) {
+        bool parsed;
+        if (parser_accept(ts, TOKEN_KEYWORD_EXPORTING)) {
+            parsed = parse_call_function_bindings(ts, call_node, "EXPORTING");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_IMPORTING)) {
+            parsed = parse_call_function_bindings(ts, call_node, "IMPORTING");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_CHANGING)) {
+            parsed = parse_call_function_bindings(ts, call_node, "CHANGING");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_TABLES)) {
+            parsed = parse_call_function_bindings(ts, call_node, "TABLES");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_EXCEPTIONS)) {
+            parsed = parse_call_function_bindings(ts, call_node, "EXCEPTIONS");
+        } else if (parser_accept_word(ts, "DESTINATION")) {
+            parsed = parser_parse_clause(ts, call_node, "DESTINATION");
+        } else if (parser_accept_word(ts, "STARTING")) {
+            parsed = parser_accept_word(ts, "NEW") && parser_accept_word(ts, "TASK") &&
+                     parser_parse_clause(ts, call_node, "STARTING NEW TASK");
+            if (!parsed) report_error("Expected task name after STARTING NEW TASK");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_IN)) {
+            // IN UPDATE TASK, IN BACKGROUND TASK
+            parsed = (parser_accept_word(ts, "UPDATE") || parser_accept_word(ts, "BACKGROUND")) &&
+                     parser_accept_word(ts, "TASK");
+            if (!parsed) report_error("Expected UPDATE TASK or BACKGROUND TASK after IN");
         } else {
-            break;
-        }
-
-        if (!call_node->exporting_params && !call_node->importing_params &&
-            !call_node->changing_params && !call_node->tables_params && !call_node->exceptions) {
-            report_error("Failed to parse parameters or EXCEPTIONS in CALL FUNCTION");
-            ast_node_free(call_node);
-            return NULL;
+            report_error("Unexpected token in CALL FUNCTION statement");
+            parsed = false;
         }
+        if (!parsed) return call_node;
     }
-
+    parser_end_statement(ts);
     return call_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_CALL, TOKEN_KEYWORD_FUNCTION, 0, parse_call_function_complex)
@@ -40,7 +40,7 @@ ASTNodeList *parse_call_function_exceptions(TokenStream *ts) {
 
         // exc_name
         token = token_stream_next(ts);
-        char *exc_name = strdup(token->text);
+        char *exc_name = token_strdup(token);
 
         token = token_stream_next(ts);
         if (!token || token->type != TOKEN_OPERATOR_EQUALS) {
@@ -68,7 +68,7 @@ ASTNodeList *parse_call_function_exceptions(TokenStream *ts) {
         }
 
         exc_node->exception_name = exc_name;
-        exc_node->exception_value = strdup(token->text);
+        exc_node->exception_value = token_strdup(token);
         ast_node_list_append(exceptions, exc_node);
     }
 
@@ -43,7 +43,7 @@ ASTNode *parse_call_function_simple(TokenStream *ts) {
         return NULL;
     }
 
-    call_node->function_name = strdup(token->text);
+    call_node->function_name = token_strdup(token);
     if (!call_node->function_name) {
         report_error("Memory allocation failed for function_name");
         ast_node_free(call_node);
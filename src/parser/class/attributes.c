@@ -159,8 +159,8 @@ ASTNodeList *parse_class_attributes(TokenStream *ts) {
                 return NULL;
             }
 
-            attr_node->attribute_name = strdup(name_token->text);
-            attr_node->attribute_type = strdup(type_name->text);
+            attr_node->attribute_name = token_strdup(name_token);
+            attr_node->attribute_type = token_strdup(type_name);
             attr_node->visibility = VISIBILITY_DEFAULT; // Можно позже расширить
 
             ast_node_list_append(attributes, attr_node);
@@ -216,9 +216,9 @@ ASTNodeList *parse_class_attributes(TokenStream *ts) {
                 return NULL;
             }
 
-            const_node->constant_name = strdup(const_name->text);
-            const_node->constant_type = strdup(type_name->text);
-            const_node->constant_value = strdup(value->text);
+            const_node->constant_name = token_strdup(const_name);
+            const_node->constant_type = token_strdup(type_name);
+            const_node->constant_value = token_strdup(value);
             const_node->visibility = VISIBILITY_DEFAULT; // Можно расширить
 
             ast_node_list_append(attributes, const_node);
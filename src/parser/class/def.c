@@ -2,15 +2,51 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 #include <stdlib.h>
 #include <string.h>
 
+// Слова, которыми кончается секция видимости
+static const TokenType class_section_ends[] = {
+    TOKEN_KEYWORD_PUBLIC, TOKEN_KEYWORD_PROTECTED, TOKEN_KEYWORD_PRIVATE, TOKEN_KEYWORD_ENDCLASS
+};
+
 /**
- * parse_class_definition - Парсит начало объявления класса.
+ * parse_class_implementation - Парсит CLASS <name> IMPLEMENTATION ... ENDCLASS.
+ *
+ * Вызывается из parse_class_definition() после слова IMPLEMENTATION.
+ * Потомки узла — реализации методов (METHOD ... ENDMETHOD).
+ */
+static ASTNode *parse_class_implementation(TokenStream *ts, atom_t name) {
+    ASTNode *impl_node = ast_node_create(AST_CLASS_IMPL);
+    if (!impl_node) {
+        report_error("Failed to allocate AST node for CLASS IMPLEMENTATION");
+        return NULL;
+    }
+    impl_node->atom = name;
+    if (!parser_end_statement(ts)) return impl_node;
+
+    static const TokenType ends[] = { TOKEN_KEYWORD_ENDCLASS };
+    if (!parser_parse_block(ts, impl_node, ends, 1, "ENDCLASS")) return impl_node;
+    token_stream_advance(ts); // ENDCLASS
+    parser_end_statement(ts);
+    return impl_node;
+}
+
+/**
+ * parse_class_definition - Парсит объявление класса.
  *
  * Синтаксис:
- * CLASS <name> DEFINITION [PUBLIC | PRIVATE | PROTECTED].
- * 
+ * CLASS <name> DEFINITION [PUBLIC] [INHERITING FROM <super>] [ABSTRACT] [FINAL] [CREATE ...].
+ *   PUBLIC SECTION. ... PROTECTED SECTION. ... PRIVATE SECTION. ...
+ * ENDCLASS.
+ *
+ * Каждая секция — узел AST_CLASS_SECTION (atom — PUBLIC, PROTECTED или PRIVATE), её
+ * компоненты (DATA, CONSTANTS, TYPES, METHODS, ...) — потомки секции. Суперкласс —
+ * дополнение AST_STATEMENT_CLAUSE "INHERITING FROM". CLASS <name> DEFINITION DEFERRED
+ * (и LOAD) даёт узел без тела; CLASS <name> IMPLEMENTATION разбирает
+ * parse_class_implementation().
+ *
  * Возвращает AST узел класса или NULL при ошибке.
  */
 ASTNode *parse_class_definition(TokenStream *ts) {
@@ -19,15 +55,18 @@ ASTNode *parse_class_definition(TokenStream *ts) {
         return NULL;
     }
 
-    Token *token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_CLASS) {
-        report_error("Expected 'CLASS' keyword");
+    if (!parser_expect(ts, TOKEN_KEYWORD_CLASS, "'CLASS' keyword")) return NULL;
+
+    Token token = token_stream_next(ts);
+    if (token.type != TOKEN_IDENTIFIER) {
+        report_error("Expected class name after 'CLASS'");
         return NULL;
     }
+    atom_t name = token_atom(&token);
 
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_IDENTIFIER) {
-        report_error("Expected class name after 'CLASS'");
+    if (parser_accept(ts, TOKEN_KEYWORD_IMPLEMENTATION)) return parse_class_implementation(ts, name);
+
+    if (!parser_expect(ts, TOKEN_KEYWORD_DEFINITION, "'DEFINITION' or 'IMPLEMENTATION' after class name")) {
         return NULL;
     }
 
@@ -36,26 +75,65 @@ ASTNode *parse_class_definition(TokenStream *ts) {
         report_error("Failed to allocate AST node for CLASS");
         return NULL;
     }
+    class_node->atom = name;
 
-    class_node->class_name = strdup(token->text);
-
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_DEFINITION) {
-        report_error("Expected 'DEFINITION' after class name");
-        ast_node_free(class_node);
-        return NULL;
+    // Дополнения заголовка; на компоненты влияет только суперкласс
+    bool has_body = true;
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF; ) {
+        if (parser_accept_word(ts, "DEFERRED") || parser_accept_word(ts, "LOAD")) {
+            has_body = false;
+        } else if (parser_accept_word(ts, "INHERITING")) {
+            if (!parser_expect(ts, TOKEN_KEYWORD_FROM, "FROM after INHERITING") ||
+                !parser_parse_clause(ts, class_node, "INHERITING FROM")) {
+                return class_node;
+            }
+        } else {
+            token_stream_advance(ts);
+        }
     }
+    if (!parser_end_statement(ts) || !has_body) return class_node;
 
-    // Обработка опциональной области видимости
-    token = token_stream_peek(ts);
-    if (token) {
-        if (token->type == TOKEN_KEYWORD_PUBLIC ||
-            token->type == TOKEN_KEYWORD_PRIVATE ||
-            token->type == TOKEN_KEYWORD_PROTECTED) {
-            token = token_stream_next(ts);
-            class_node->visibility = strdup(token->text);
+    // Секции видимости до ENDCLASS
+    for (;;) {
+        while (parser_accept(ts, TOKEN_PUNCTUATION_DOT)) {}
+        token = token_stream_peek(ts);
+        if (token.type == TOKEN_KEYWORD_ENDCLASS) break;
+        if (token.type != TOKEN_KEYWORD_PUBLIC && token.type != TOKEN_KEYWORD_PROTECTED &&
+            token.type != TOKEN_KEYWORD_PRIVATE) {
+            report_error(token.type == TOKEN_EOF ? "Expected ENDCLASS" : "Expected PUBLIC, PROTECTED or PRIVATE SECTION");
+            return class_node;
         }
-    }
+        token_stream_advance(ts);
 
+        ASTNode *section = ast_node_create(AST_CLASS_SECTION);
+        if (!section) {
+            report_error("Failed to allocate AST node for class section");
+            return class_node;
+        }
+        section->atom = token_atom(&token);
+        ast_node_add_child(class_node, section);
+        if (!parser_expect(ts, TOKEN_KEYWORD_SECTION, "SECTION") || !parser_end_statement(ts)) return class_node;
+        if (!parser_parse_block(ts, section, class_section_ends, 4, "ENDCLASS")) return class_node;
+    }
+    token_stream_advance(ts); // ENDCLASS
+    parser_end_statement(ts);
     return class_node;
 }
+
+/**
+ * parse_class_static_component - CLASS-DATA и CLASS-METHODS.
+ *
+ * Лексер разбивает слово на CLASS, '-' и DATA/METHODS; правило поглощает
+ * CLASS и '-', а компонент разбирается как обычный DATA или METHODS.
+ */
+ASTNode *parse_class_static_component(TokenStream *ts) {
+    TokenType type = token_stream_peek_type(ts);
+    if (type != TOKEN_KEYWORD_DATA && type != TOKEN_KEYWORD_METHODS) {
+        report_error("Expected DATA or METHODS after CLASS-");
+        return NULL;
+    }
+    return parse_statement(ts);
+}
+
+PARSER_STATEMENT(TOKEN_KEYWORD_CLASS, TOKEN_UNKNOWN, 0, parse_class_definition)
+PARSER_STATEMENT(TOKEN_KEYWORD_CLASS, TOKEN_OPERATOR_MINUS, 2, parse_class_static_component)
@@ -10,8 +10,8 @@
  */
 void report_class_error(const char *message, const Token *token) {
     if (token) {
-        fprintf(stderr, "Class parser error at line %d, column %d: %s (token: '%s')\n",
-                token->line, token->column, message, token->text);
+        fprintf(stderr, "Class parser error at line %d, column %d: %s (token: '%.*s')\n",
+                token->line, token->column, message, (int)token->length, token->text);
     } else {
         fprintf(stderr, "Class parser error: %s\n", message);
     }
@@ -118,7 +118,7 @@ static int parse_attributes(TokenStream *ts, ASTNode *class_node, VisibilityType
             return 0;
         }
 
-        attr_node->attribute_name = strdup(token->text);
+        attr_node->attribute_name = token_strdup(token);
         attr_node->visibility = visibility;
 
         // Опционально, парсим тип и начальное значение (если есть)
@@ -131,7 +131,7 @@ static int parse_attributes(TokenStream *ts, ASTNode *class_node, VisibilityType
                 ast_node_free(attr_node);
                 return 0;
             }
-            attr_node->attribute_type = strdup(type_token->text);
+            attr_node->attribute_type = token_strdup(type_token);
         }
 
         // TODO: парсинг начального значения и других спецификаторов
@@ -165,7 +165,7 @@ static int parse_interfaces(TokenStream *ts, ASTNode *class_node) {
             return 0;
         }
 
-        iface_node->interface_name = strdup(token->text);
+        iface_node->interface_name = token_strdup(token);
         ast_node_list_append(class_node->interfaces, iface_node);
 
         Token *next = token_stream_peek(ts);
@@ -2,6 +2,8 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -9,11 +11,14 @@
  * parse_interface_definition - Парсит объявление интерфейса.
  *
  * Синтаксис:
- * INTERFACE <interface_name>.
+ * INTERFACE <interface_name> [PUBLIC].
  *   METHODS ...
  *   DATA ...
  * ENDINTERFACE.
  *
+ * Компоненты (METHODS, DATA, CONSTANTS, TYPES, ...) — потомки узла. INTERFACE <name>
+ * DEFERRED (и LOAD) даёт узел без тела.
+ *
  * Возвращает AST узел интерфейса или NULL при ошибке.
  */
 ASTNode *parse_interface_definition(TokenStream *ts) {
@@ -22,14 +27,10 @@ ASTNode *parse_interface_definition(TokenStream *ts) {
         return NULL;
     }
 
-    Token *token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_INTERFACE) {
-        report_error("Expected 'INTERFACE' keyword");
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_INTERFACE, "'INTERFACE' keyword")) return NULL;
 
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_IDENTIFIER) {
+    Token token = token_stream_next(ts);
+    if (token.type != TOKEN_IDENTIFIER) {
         report_error("Expected interface name after 'INTERFACE'");
         return NULL;
     }
@@ -40,129 +41,47 @@ ASTNode *parse_interface_definition(TokenStream *ts) {
         return NULL;
     }
 
-    interface_node->interface_name = strdup(token->text);
-    interface_node->interface_members = ast_node_list_create();
+    interface_node->atom = token_atom(&token);
 
-    if (!interface_node->interface_members) {
-        report_error("Failed to create member list for interface");
-        ast_node_free(interface_node);
-        return NULL;
-    }
-
-    // Парсинг содержимого интерфейса
-    while ((token = token_stream_peek(ts)) != NULL) {
-        if (token->type == TOKEN_KEYWORD_ENDINTERFACE) {
-            token_stream_next(ts);  // consume ENDINTERFACE
-            break;
-        }
-
-        if (token->type == TOKEN_KEYWORD_METHODS) {
-            ASTNode *method_decl = parse_method_declaration(ts);
-            if (!method_decl) {
-                report_error("Failed to parse METHOD declaration in INTERFACE");
-                ast_node_free(interface_node);
-                return NULL;
-            }
-            ast_node_list_append(interface_node->interface_members, method_decl);
-        } else if (token->type == TOKEN_KEYWORD_DATA) {
-            ASTNode *data_decl = parse_data_declaration(ts);
-            if (!data_decl) {
-                report_error("Failed to parse DATA declaration in INTERFACE");
-                ast_node_free(interface_node);
-                return NULL;
-            }
-            ast_node_list_append(interface_node->interface_members, data_decl);
-        } else {
-            report_error_token("Unexpected token in INTERFACE block", token);
-            ast_node_free(interface_node);
-            return NULL;
-        }
+    bool has_body = true;
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF; ) {
+        if (parser_accept_word(ts, "DEFERRED") || parser_accept_word(ts, "LOAD")) has_body = false;
+        else token_stream_advance(ts); // PUBLIC
     }
+    if (!parser_end_statement(ts) || !has_body) return interface_node;
 
+    // Содержимое интерфейса до ENDINTERFACE
+    static const TokenType ends[] = { TOKEN_KEYWORD_ENDINTERFACE };
+    if (!parser_parse_block(ts, interface_node, ends, 1, "ENDINTERFACE")) return interface_node;
+    token_stream_advance(ts); // ENDINTERFACE
+    parser_end_statement(ts);
     return interface_node;
 }
 
-
-/////////////////////////
-
-#include "../../include/parser.h"
-#include "../../include/token.h"
-#include "../../include/ast.h"
-#include "../../include/error.h"
-#include <stdlib.h>
-#include <string.h>
-
 /**
- * parse_interface - Парсит объявление интерфейса ABAP.
+ * parse_interfaces_statement - INTERFACES <name> в определении класса или интерфейса.
  *
- * Синтаксис:
- * INTERFACE <interface_name>.
- *   <содержимое интерфейса: методы, константы, типы>
- * ENDINTERFACE.
- *
- * Возвращает AST узел интерфейса.
+ * Возвращает AST_KEYWORD_STATEMENT "INTERFACES" (atom — имя интерфейса). Дополнения
+ * (ABSTRACT METHODS, ALL METHODS ..., DATA VALUES ...) пропускаются.
  */
-ASTNode *parse_interface(TokenStream *ts) {
-    if (!ts) {
-        report_error("TokenStream is NULL in parse_interface");
+ASTNode *parse_interfaces_statement(TokenStream *ts) {
+    ASTNode *node = ast_node_create(AST_KEYWORD_STATEMENT);
+    if (node) node->string_value = ast_strndup("INTERFACES", 10);
+    if (!node || !node->string_value) {
+        report_error("Failed to allocate AST node for INTERFACES");
+        ast_node_free(node);
         return NULL;
     }
-
-    Token *token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_INTERFACE) {
-        report_error("Expected 'INTERFACE' keyword");
-        return NULL;
+    if ((node->atom = parse_name(ts)) == ATOM_NONE) {
+        report_error("Expected interface name after INTERFACES");
+        return node;
     }
-
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_IDENTIFIER) {
-        report_error("Expected interface name after 'INTERFACE'");
-        return NULL;
-    }
-
-    ASTNode *interface_node = ast_node_create(AST_INTERFACE_DEF);
-    if (!interface_node) {
-        report_error("Failed to allocate AST node for interface");
-        return NULL;
-    }
-
-    interface_node->interface_name = strdup(token->text);
-    interface_node->members = ast_node_list_create();
-    if (!interface_node->members) {
-        report_error("Failed to create members list for interface");
-        ast_node_free(interface_node);
-        return NULL;
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF; ) {
+        token_stream_advance(ts);
     }
-
-    // Ожидаем точку после имени интерфейса
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_DOT) {
-        report_error("Expected '.' after interface name");
-        ast_node_free(interface_node);
-        return NULL;
-    }
-
-    // Парсим содержимое интерфейса до ENDINTERFACE
-    while ((token = token_stream_peek(ts)) != NULL) {
-        if (token->type == TOKEN_KEYWORD_ENDINTERFACE) {
-            token_stream_next(ts); // consume ENDINTERFACE
-            token = token_stream_next(ts);
-            if (!token || token->type != TOKEN_DOT) {
-                report_error("Expected '.' after ENDINTERFACE");
-                ast_node_free(interface_node);
-                return NULL;
-            }
-            break; // интерфейс завершён
-        }
-
-        // Парсим члены интерфейса: методы, константы, типы и др.
-        // Для упрощения пока пропустим содержимое
-        // TODO: Реализовать полноценный парсинг членов интерфейса
-        // Для этого можно вызвать parse_method_definition(), parse_class_attributes() и т.п.
-
-        // Чтобы избежать бесконечного цикла, пропустим текущий токен
-        token_stream_next(ts);
-    }
-
-    return interface_node;
+    parser_end_statement(ts);
+    return node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_INTERFACE, TOKEN_UNKNOWN, 0, parse_interface_definition)
+PARSER_STATEMENT(TOKEN_KEYWORD_INTERFACES, TOKEN_UNKNOWN, 1, parse_interfaces_statement)
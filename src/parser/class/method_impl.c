@@ -39,7 +39,7 @@ ASTNode *parse_method_implementation(TokenStream *ts) {
         return NULL;
     }
 
-    method_impl_node->method_name = strdup(token->text);
+    method_impl_node->method_name = token_strdup(token);
 
     // Ожидается точка после METHOD <name>
     token = token_stream_next(ts);
@@ -120,7 +120,7 @@ ASTNode *parse_method_implementation(TokenStream *ts) {
         return NULL;
     }
 
-    method_impl_node->method_name = strdup(token->text);
+    method_impl_node->method_name = token_strdup(token);
     method_impl_node->body = ast_node_list_create();
     if (!method_impl_node->body) {
         report_error("Failed to create method body list");
@@ -39,7 +39,7 @@ ASTNode *parse_simple_class(TokenStream *ts) {
         return NULL;
     }
 
-    class_node->class_name = strdup(token->text);
+    class_node->class_name = token_strdup(token);
     class_node->sections = ast_node_list_create();
     if (!class_node->sections) {
         report_error("Failed to create sections list for class");
@@ -45,7 +45,7 @@ ASTNode *parse_control_auth_check(TokenStream *ts) {
                 return NULL;
             }
             ASTNode *obj_node = ast_node_create(AST_AUTH_CHECK_OBJECT);
-            obj_node->string_value = strdup(obj_val->text);
+            obj_node->atom = token_atom(obj_val);
             ast_node_add_child(auth_node, obj_node);
         }
         else if (param_tok->type == TOKEN_ID) {
@@ -57,7 +57,7 @@ ASTNode *parse_control_auth_check(TokenStream *ts) {
                 return NULL;
             }
             ASTNode *id_node = ast_node_create(AST_AUTH_CHECK_ID);
-            id_node->string_value = strdup(id_val->text);
+            id_node->atom = token_atom(id_val);
             ast_node_add_child(auth_node, id_node);
         }
         else if (param_tok->type == TOKEN_FIELD) {
@@ -69,7 +69,7 @@ ASTNode *parse_control_auth_check(TokenStream *ts) {
                 return NULL;
             }
             ASTNode *field_node = ast_node_create(AST_AUTH_CHECK_FIELD);
-            field_node->string_value = strdup(field_val->text);
+            field_node->atom = token_atom(field_val);
             ast_node_add_child(auth_node, field_node);
         }
         else {
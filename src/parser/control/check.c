@@ -2,6 +2,8 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 
 /**
  * parse_control_check - Парсит оператор CHECK.
@@ -18,11 +20,7 @@ ASTNode *parse_control_check(TokenStream *ts) {
         return NULL;
     }
 
-    Token *tok = token_stream_next(ts);
-    if (!tok || tok->type != TOKEN_CHECK) {
-        report_error("Expected CHECK token");
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_CHECK, "CHECK")) return NULL;
 
     // Парсим выражение условия после CHECK
     ASTNode *condition = parse_expression(ts);
@@ -31,7 +29,7 @@ ASTNode *parse_control_check(TokenStream *ts) {
         return NULL;
     }
 
-    ASTNode *check_node = ast_node_create(AST_CONTROL_CHECK);
+    ASTNode *check_node = ast_node_create(AST_CHECK);
     if (!check_node) {
         report_error("Failed to create AST node for CHECK");
         ast_node_free(condition);
@@ -39,5 +37,8 @@ ASTNode *parse_control_check(TokenStream *ts) {
     }
 
     ast_node_add_child(check_node, condition);
+    parser_end_statement(ts);
     return check_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_CHECK, TOKEN_UNKNOWN, 0, parse_control_check)
@@ -2,6 +2,7 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 
 /**
  * parse_control_continue - Парсит оператор CONTINUE.
@@ -18,17 +19,16 @@ ASTNode *parse_control_continue(TokenStream *ts) {
         return NULL;
     }
 
-    Token *tok = token_stream_next(ts);
-    if (!tok || tok->type != TOKEN_CONTINUE) {
-        report_error("Expected CONTINUE token");
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_CONTINUE, "CONTINUE")) return NULL;
 
-    ASTNode *continue_node = ast_node_create(AST_CONTROL_CONTINUE);
+    ASTNode *continue_node = ast_node_create(AST_CONTINUE);
     if (!continue_node) {
         report_error("Failed to create AST node for CONTINUE");
         return NULL;
     }
 
+    parser_end_statement(ts);
     return continue_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_CONTINUE, TOKEN_UNKNOWN, 0, parse_control_continue)
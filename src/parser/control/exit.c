@@ -2,6 +2,7 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 
 /**
  * parse_control_exit - Парсит оператор EXIT.
@@ -17,17 +18,16 @@ ASTNode *parse_control_exit(TokenStream *ts) {
         return NULL;
     }
 
-    Token *tok = token_stream_next(ts);
-    if (!tok || tok->type != TOKEN_EXIT) {
-        report_error("Expected EXIT token");
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_EXIT, "EXIT")) return NULL;
 
-    ASTNode *exit_node = ast_node_create(AST_CONTROL_EXIT);
+    ASTNode *exit_node = ast_node_create(AST_EXIT);
     if (!exit_node) {
         report_error("Failed to create AST node for EXIT");
         return NULL;
     }
 
+    parser_end_statement(ts);
     return exit_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_EXIT, TOKEN_UNKNOWN, 0, parse_control_exit)
@@ -2,6 +2,7 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 
 /**
  * parse_control_return - Парсит оператор RETURN.
@@ -18,17 +19,16 @@ ASTNode *parse_control_return(TokenStream *ts) {
         return NULL;
     }
 
-    Token *tok = token_stream_next(ts);
-    if (!tok || tok->type != TOKEN_RETURN) {
-        report_error("Expected RETURN token");
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_RETURN, "RETURN")) return NULL;
 
-    ASTNode *return_node = ast_node_create(AST_CONTROL_RETURN);
+    ASTNode *return_node = ast_node_create(AST_RETURN);
     if (!return_node) {
         report_error("Failed to create AST node for RETURN");
         return NULL;
     }
 
+    parser_end_statement(ts);
     return return_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_RETURN, TOKEN_UNKNOWN, 0, parse_control_return)
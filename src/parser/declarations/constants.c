@@ -2,12 +2,16 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
  * parse_declaration_constants - Парсит объявление CONSTANTS в ABAP.
  *
+ * CONSTANTS name TYPE type VALUE literal. Спецификаторы разбираются как в DATA;
+ * VALUE обязателен.
+ *
  * Ожидается, что ключевое слово CONSTANTS уже прочитано.
  * Возвращает AST узел CONSTANTS или NULL при ошибке.
  */
@@ -24,84 +28,28 @@ ASTNode *parse_declaration_constants(TokenStream *ts) {
     }
 
     // Ожидается идентификатор (имя константы)
-    Token *id_tok = token_stream_next(ts);
-    if (!id_tok || id_tok->type != TOKEN_IDENTIFIER) {
+    Token id_tok = token_stream_next(ts);
+    if (!parser_is_name_token(id_tok.type)) {
         report_error("Expected identifier after CONSTANTS");
         ast_node_free(const_node);
         return NULL;
     }
 
-    const_node->string_value = strdup(id_tok->text);
-    if (!const_node->string_value) {
-        report_error("Failed to allocate memory for constant name");
-        ast_node_free(const_node);
-        return NULL;
-    }
+    const_node->atom = token_atom(&id_tok);
 
-    // Ожидается ключевое слово TYPE
-    Token *type_tok = token_stream_next(ts);
-    if (!type_tok || type_tok->type != TOKEN_TYPE) {
-        report_error("Expected TYPE after constant name");
-        ast_node_free(const_node);
-        return NULL;
-    }
-
-    // Тип значения
-    Token *type_val = token_stream_next(ts);
-    if (!type_val || type_val->type != TOKEN_IDENTIFIER) {
-        report_error("Expected type name after TYPE in CONSTANTS");
-        ast_node_free(const_node);
-        return NULL;
-    }
+    if (!parser_parse_type_specs(ts, const_node)) return const_node;
 
-    ASTNode *type_node = ast_node_create(AST_TYPE_SPEC);
-    if (!type_node) {
-        report_error("Failed to allocate AST node for CONSTANTS type");
-        ast_node_free(const_node);
-        return NULL;
+    bool has_value = false;
+    for (int i = 0; i < const_node->child_count; i++) {
+        if (const_node->children[i]->type == AST_VALUE_SPEC) has_value = true;
     }
-
-    type_node->string_value = strdup(type_val->text);
-    if (!type_node->string_value) {
-        report_error("Failed to allocate memory for type in CONSTANTS");
-        ast_node_free(const_node);
-        ast_node_free(type_node);
-        return NULL;
+    if (!has_value) {
+        report_error("Expected VALUE in CONSTANTS");
+        return const_node;
     }
 
-    ast_node_add_child(const_node, type_node);
-
-    // Ожидается ключевое слово VALUE
-    Token *value_kw = token_stream_next(ts);
-    if (!value_kw || value_kw->type != TOKEN_VALUE) {
-        report_error("Expected VALUE after TYPE in CONSTANTS");
-        ast_node_free(const_node);
-        return NULL;
-    }
-
-    Token *value_tok = token_stream_next(ts);
-    if (!value_tok || (value_tok->type != TOKEN_STRING && value_tok->type != TOKEN_NUMBER)) {
-        report_error("Expected literal value after VALUE in CONSTANTS");
-        ast_node_free(const_node);
-        return NULL;
-    }
-
-    ASTNode *value_node = ast_node_create(AST_VALUE_SPEC);
-    if (!value_node) {
-        report_error("Failed to allocate AST node for constant value");
-        ast_node_free(const_node);
-        return NULL;
-    }
-
-    value_node->string_value = strdup(value_tok->text);
-    if (!value_node->string_value) {
-        report_error("Failed to allocate memory for constant value");
-        ast_node_free(const_node);
-        ast_node_free(value_node);
-        return NULL;
-    }
-
-    ast_node_add_child(const_node, value_node);
-
+    parser_end_statement(ts);
     return const_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_CONSTANTS, TOKEN_UNKNOWN, 1, parse_declaration_constants)
@@ -2,12 +2,20 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
  * parse_declaration_data - Парсит объявление DATA для переменных.
  *
+ * Поддерживает:
+ * - DATA name TYPE i [VALUE 1].
+ * - DATA name TYPE c LENGTH 10.
+ * - DATA name TYPE REF TO zcl_class.
+ * - DATA name TYPE STANDARD TABLE OF line WITH DEFAULT KEY.
+ * - DATA BEGIN OF name ... DATA END OF name.
+ *
  * Ожидается, что ключевое слово DATA уже прочитано.
  * Возвращает AST узел DATA или NULL при ошибке.
  */
@@ -23,66 +31,29 @@ ASTNode *parse_declaration_data(TokenStream *ts) {
         return NULL;
     }
 
-    // Ожидаем имя переменной
-    Token *id_tok = token_stream_next(ts);
-    if (!id_tok || id_tok->type != TOKEN_IDENTIFIER) {
-        report_error("Expected identifier after DATA");
-        ast_node_free(data_node);
-        return NULL;
+    if (token_stream_peek_type(ts) == TOKEN_KEYWORD_BEGIN) {
+        if (!parser_parse_structure(ts, data_node, TOKEN_KEYWORD_DATA)) return data_node;
+        // Компоненты структуры описываются как в TYPES BEGIN OF: это не отдельные переменные
+        for (int i = 0; i < data_node->child_count; i++) {
+            if (data_node->children[i]->type == AST_DATA_DECL) data_node->children[i]->type = AST_TYPES_DECL;
+        }
+        parser_end_statement(ts);
+        return data_node;
     }
 
-    data_node->string_value = strdup(id_tok->text);
-    if (!data_node->string_value) {
-        report_error("Failed to allocate memory for variable name in DATA");
+    // Ожидаем имя переменной
+    Token id_tok = token_stream_next(ts);
+    if (!parser_is_name_token(id_tok.type)) {
+        report_error("Expected identifier after DATA");
         ast_node_free(data_node);
         return NULL;
     }
 
-    // Опциональные спецификаторы: TYPE, LIKE, VALUE
-    Token *next_tok = token_stream_peek(ts);
-    while (next_tok &&
-          (next_tok->type == TOKEN_TYPE ||
-           next_tok->type == TOKEN_LIKE ||
-           next_tok->type == TOKEN_VALUE ||
-           next_tok->type == TOKEN_DECIMALS ||
-           next_tok->type == TOKEN_LENGTH)) {
-        token_stream_next(ts); // consume keyword
-
-        ASTNodeType spec_type;
-        switch (next_tok->type) {
-            case TOKEN_TYPE:     spec_type = AST_TYPE_SPEC;     break;
-            case TOKEN_LIKE:     spec_type = AST_LIKE_SPEC;     break;
-            case TOKEN_VALUE:    spec_type = AST_VALUE_SPEC;    break;
-            case TOKEN_DECIMALS: spec_type = AST_DECIMALS_SPEC; break;
-            case TOKEN_LENGTH:   spec_type = AST_LENGTH_SPEC;   break;
-            default:             spec_type = AST_UNKNOWN;        break;
-        }
-
-        Token *val_tok = token_stream_next(ts);
-        if (!val_tok || val_tok->type != TOKEN_IDENTIFIER) {
-            report_error("Expected identifier after type/value specifier in DATA");
-            ast_node_free(data_node);
-            return NULL;
-        }
-
-        ASTNode *spec_node = ast_node_create(spec_type);
-        if (!spec_node) {
-            report_error("Failed to allocate AST node for DATA specifier");
-            ast_node_free(data_node);
-            return NULL;
-        }
-
-        spec_node->string_value = strdup(val_tok->text);
-        if (!spec_node->string_value) {
-            report_error("Failed to allocate memory for DATA specifier value");
-            ast_node_free(data_node);
-            ast_node_free(spec_node);
-            return NULL;
-        }
-
-        ast_node_add_child(data_node, spec_node);
-        next_tok = token_stream_peek(ts);
-    }
+    data_node->atom = token_atom(&id_tok);
 
+    // Опциональные спецификаторы: TYPE, LIKE, VALUE, LENGTH, DECIMALS
+    if (parser_parse_type_specs(ts, data_node)) parser_end_statement(ts);
     return data_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_DATA, TOKEN_UNKNOWN, 1, parse_declaration_data)
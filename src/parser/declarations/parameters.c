@@ -2,12 +2,17 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
  * parse_declaration_parameters - Парсит инструкцию PARAMETERS.
  *
+ * PARAMETERS name TYPE type [DEFAULT value] [OBLIGATORY] [LOWER CASE] [AS CHECKBOX].
+ * TYPE и LIKE разбираются как в DATA, DEFAULT даёт AST_VALUE_SPEC; дополнения экрана
+ * выбора на раскладку не влияют и в AST не попадают.
+ *
  * Ожидается, что ключевое слово PARAMETERS уже прочитано.
  * Возвращает AST узел PARAMETERS или NULL при ошибке.
  */
@@ -24,78 +29,48 @@ ASTNode *parse_declaration_parameters(TokenStream *ts) {
     }
 
     // Имя параметра
-    Token *id_tok = token_stream_next(ts);
-    if (!id_tok || id_tok->type != TOKEN_IDENTIFIER) {
+    Token id_tok = token_stream_next(ts);
+    if (!parser_is_name_token(id_tok.type)) {
         report_error("Expected identifier after PARAMETERS");
         ast_node_free(param_node);
         return NULL;
     }
 
-    param_node->string_value = strdup(id_tok->text);
-    if (!param_node->string_value) {
-        report_error("Failed to allocate memory for parameter name");
-        ast_node_free(param_node);
-        return NULL;
-    }
-
-    // Опциональные: TYPE, LIKE, DEFAULT, OBLIGATORY, LOWER CASE, etc.
-    Token *tok;
-    while ((tok = token_stream_peek(ts)) != NULL &&
-           (tok->type == TOKEN_TYPE || tok->type == TOKEN_LIKE ||
-            tok->type == TOKEN_DEFAULT || tok->type == TOKEN_OBLIGATORY ||
-            tok->type == TOKEN_LOWER || tok->type == TOKEN_CASE)) {
-
-        tok = token_stream_next(ts); // consume keyword
-
-        ASTNodeType subtype;
-        switch (tok->type) {
-            case TOKEN_TYPE:       subtype = AST_TYPE_SPEC;       break;
-            case TOKEN_LIKE:       subtype = AST_LIKE_SPEC;       break;
-            case TOKEN_DEFAULT:    subtype = AST_DEFAULT_SPEC;    break;
-            case TOKEN_OBLIGATORY: subtype = AST_OBLIGATORY_SPEC; break;
-            case TOKEN_LOWER:      // Check for "LOWER CASE"
-                if (token_stream_peek(ts) && token_stream_peek(ts)->type == TOKEN_CASE) {
-                    token_stream_next(ts); // consume CASE
-                    subtype = AST_LOWER_CASE_SPEC;
-                    break;
-                } else {
-                    report_error("Expected CASE after LOWER in PARAMETERS");
-                    ast_node_free(param_node);
-                    return NULL;
-                }
-            default:
-                report_error("Unexpected keyword in PARAMETERS");
-                ast_node_free(param_node);
-                return NULL;
-        }
+    param_node->atom = token_atom(&id_tok);
 
-        ASTNode *spec_node = ast_node_create(subtype);
-        if (!spec_node) {
-            report_error("Failed to allocate AST node for PARAMETERS specifier");
-            ast_node_free(param_node);
-            return NULL;
-        }
-
-        if (subtype == AST_TYPE_SPEC || subtype == AST_LIKE_SPEC || subtype == AST_DEFAULT_SPEC) {
-            Token *val_tok = token_stream_next(ts);
-            if (!val_tok || val_tok->type != TOKEN_IDENTIFIER) {
-                report_error("Expected identifier or literal after specifier in PARAMETERS");
-                ast_node_free(param_node);
-                ast_node_free(spec_node);
-                return NULL;
+    // Опциональные: TYPE, LIKE, DEFAULT, OBLIGATORY, LOWER CASE, AS CHECKBOX
+    for (;;) {
+        if (!parser_parse_type_specs(ts, param_node)) return param_node;
+        if (parser_accept(ts, TOKEN_KEYWORD_DEFAULT)) {
+            Token value = token_stream_next(ts);
+            if (value.type == TOKEN_EOF || value.type == TOKEN_PUNCTUATION_DOT) {
+                report_error("Expected value after DEFAULT in PARAMETERS");
+                return param_node;
             }
-
-            spec_node->string_value = strdup(val_tok->text);
-            if (!spec_node->string_value) {
-                report_error("Failed to allocate memory for specifier value");
-                ast_node_free(param_node);
+            ASTNode *spec_node = ast_node_create(AST_VALUE_SPEC);
+            if (spec_node) spec_node->string_value = ast_token_strdup(&value);
+            if (!spec_node || !spec_node->string_value) {
+                report_error("Failed to allocate AST node for PARAMETERS specifier");
                 ast_node_free(spec_node);
-                return NULL;
+                return param_node;
             }
+            ast_node_add_child(param_node, spec_node);
+        } else if (parser_accept_word(ts, "OBLIGATORY")) {
+            continue;
+        } else if (parser_accept_word(ts, "LOWER")) {
+            if (!parser_expect(ts, TOKEN_KEYWORD_CASE, "CASE after LOWER in PARAMETERS")) return param_node;
+        } else if (parser_accept_word(ts, "AS")) {
+            if (!parser_accept_word(ts, "CHECKBOX")) {
+                report_error("Expected CHECKBOX after AS in PARAMETERS");
+                return param_node;
+            }
+        } else {
+            break;
         }
-
-        ast_node_add_child(param_node, spec_node);
     }
 
+    parser_end_statement(ts);
     return param_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_PARAMETERS, TOKEN_UNKNOWN, 1, parse_declaration_parameters)
@@ -2,6 +2,8 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -11,7 +13,10 @@
  * Пример:
  *   RANGES: r_matnr FOR mara-matnr.
  *
- * Возвращает AST узел RANGES_DECL или NULL при ошибке.
+ * RANGES name FOR field равносильно DATA name LIKE RANGE OF field: узел AST_DATA_DECL
+ * со спецификатором AST_LIKE_SPEC ("RANGE OF", atom — поле).
+ *
+ * Возвращает AST узел DATA или NULL при ошибке.
  */
 ASTNode *parse_declaration_ranges(TokenStream *ts) {
     if (!ts) {
@@ -19,52 +24,48 @@ ASTNode *parse_declaration_ranges(TokenStream *ts) {
         return NULL;
     }
 
-    ASTNode *ranges_node = ast_node_create(AST_RANGES_DECL);
+    ASTNode *ranges_node = ast_node_create(AST_DATA_DECL);
     if (!ranges_node) {
         report_error("Failed to create AST node for RANGES");
         return NULL;
     }
 
     // Имя таблицы диапазонов
-    Token *id_tok = token_stream_next(ts);
-    if (!id_tok || id_tok->type != TOKEN_IDENTIFIER) {
+    Token id_tok = token_stream_next(ts);
+    if (!parser_is_name_token(id_tok.type)) {
         report_error("Expected identifier after RANGES");
         ast_node_free(ranges_node);
         return NULL;
     }
 
-    ranges_node->string_value = strdup(id_tok->text);
-    if (!ranges_node->string_value) {
-        report_error("Failed to store RANGES name");
-        ast_node_free(ranges_node);
-        return NULL;
-    }
+    ranges_node->atom = token_atom(&id_tok);
 
     // Ожидаем FOR
-    Token *for_tok = token_stream_next(ts);
-    if (!for_tok || for_tok->type != TOKEN_FOR) {
+    if (!parser_accept_word(ts, "FOR")) {
         report_error("Expected FOR keyword in RANGES declaration");
-        ast_node_free(ranges_node);
-        return NULL;
+        return ranges_node;
     }
 
     // Целевое поле
-    Token *target_tok = token_stream_next(ts);
-    if (!target_tok || target_tok->type != TOKEN_IDENTIFIER) {
+    atom_t target = parse_name(ts);
+    if (target == ATOM_NONE) {
         report_error("Expected field name after FOR in RANGES");
-        ast_node_free(ranges_node);
-        return NULL;
+        return ranges_node;
     }
 
-    ASTNode *target_node = ast_node_create(AST_FOR_TARGET);
-    if (!target_node) {
+    ASTNode *target_node = ast_node_create(AST_LIKE_SPEC);
+    if (target_node) target_node->string_value = ast_strndup("RANGE OF", 8);
+    if (!target_node || !target_node->string_value) {
         report_error("Failed to create AST node for FOR target");
-        ast_node_free(ranges_node);
-        return NULL;
+        ast_node_free(target_node);
+        return ranges_node;
     }
 
-    target_node->string_value = strdup(target_tok->text);
+    target_node->atom = target;
     ast_node_add_child(ranges_node, target_node);
 
+    parser_end_statement(ts);
     return ranges_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_RANGES, TOKEN_UNKNOWN, 1, parse_declaration_ranges)
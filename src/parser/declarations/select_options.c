@@ -2,6 +2,8 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -13,6 +15,10 @@
  *   SELECT-OPTIONS: s_matnr FOR mara-matnr OBLIGATORY.
  *   SELECT-OPTIONS: s_name FOR zemployee-name NO INTERVALS.
  *
+ * Как и у RANGES, тип задаёт спецификатор AST_LIKE_SPEC ("RANGE OF", atom — поле);
+ * узел — AST_PARAMETERS_DECL, поскольку это поле экрана выбора. Дополнения экрана
+ * (OBLIGATORY, NO INTERVALS, NO-EXTENSION, DEFAULT ...) в AST не попадают.
+ *
  * Возвращает AST узел SELECT_OPTIONS.
  */
 ASTNode *parse_declaration_select_options(TokenStream *ts) {
@@ -21,73 +27,53 @@ ASTNode *parse_declaration_select_options(TokenStream *ts) {
         return NULL;
     }
 
-    ASTNode *selopt_node = ast_node_create(AST_SELECT_OPTIONS_DECL);
+    ASTNode *selopt_node = ast_node_create(AST_PARAMETERS_DECL);
     if (!selopt_node) {
         report_error("Failed to create AST node for SELECT-OPTIONS");
         return NULL;
     }
 
     // Имя диапазона (обычно начинается с "s_")
-    Token *id_tok = token_stream_next(ts);
-    if (!id_tok || id_tok->type != TOKEN_IDENTIFIER) {
+    Token id_tok = token_stream_next(ts);
+    if (!parser_is_name_token(id_tok.type)) {
         report_error("Expected identifier after SELECT-OPTIONS");
         ast_node_free(selopt_node);
         return NULL;
     }
 
-    selopt_node->string_value = strdup(id_tok->text);
-    if (!selopt_node->string_value) {
-        report_error("Failed to store SELECT-OPTIONS name");
-        ast_node_free(selopt_node);
-        return NULL;
-    }
+    selopt_node->atom = token_atom(&id_tok);
 
     // Ожидаем "FOR"
-    Token *for_tok = token_stream_next(ts);
-    if (!for_tok || for_tok->type != TOKEN_FOR) {
+    if (!parser_accept_word(ts, "FOR")) {
         report_error("Expected FOR keyword in SELECT-OPTIONS");
-        ast_node_free(selopt_node);
-        return NULL;
+        return selopt_node;
     }
 
     // Поле, к которому относится select-option
-    Token *target_tok = token_stream_next(ts);
-    if (!target_tok || target_tok->type != TOKEN_IDENTIFIER) {
+    atom_t target = parse_name(ts);
+    if (target == ATOM_NONE) {
         report_error("Expected field name after FOR in SELECT-OPTIONS");
-        ast_node_free(selopt_node);
-        return NULL;
+        return selopt_node;
     }
 
-    ASTNode *target_node = ast_node_create(AST_FOR_TARGET);
-    if (!target_node) {
+    ASTNode *target_node = ast_node_create(AST_LIKE_SPEC);
+    if (target_node) target_node->string_value = ast_strndup("RANGE OF", 8);
+    if (!target_node || !target_node->string_value) {
         report_error("Failed to allocate AST node for FOR target");
-        ast_node_free(selopt_node);
-        return NULL;
+        ast_node_free(target_node);
+        return selopt_node;
     }
 
-    target_node->string_value = strdup(target_tok->text);
+    target_node->atom = target;
     ast_node_add_child(selopt_node, target_node);
 
-    // Обработка дополнительных модификаторов: OBLIGATORY, NO INTERVALS, etc.
-    Token *tok;
-    while ((tok = token_stream_peek(ts)) != NULL &&
-           (tok->type == TOKEN_OBLIGATORY || tok->type == TOKEN_NO)) {
-        tok = token_stream_next(ts); // consume
-
-        if (tok->type == TOKEN_OBLIGATORY) {
-            ASTNode *obl = ast_node_create(AST_OBLIGATORY_SPEC);
-            ast_node_add_child(selopt_node, obl);
-        } else if (tok->type == TOKEN_NO) {
-            Token *next = token_stream_next(ts);
-            if (!next || next->type != TOKEN_INTERVALS) {
-                report_error("Expected 'INTERVALS' after 'NO' in SELECT-OPTIONS");
-                ast_node_free(selopt_node);
-                return NULL;
-            }
-            ASTNode *no_int = ast_node_create(AST_NO_INTERVALS_SPEC);
-            ast_node_add_child(selopt_node, no_int);
-        }
+    // Дополнительные модификаторы: OBLIGATORY, NO INTERVALS, NO-EXTENSION, DEFAULT
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF; ) {
+        token_stream_advance(ts);
     }
 
+    parser_end_statement(ts);
     return selopt_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_SELECT_OPTIONS, TOKEN_UNKNOWN, 1, parse_declaration_select_options)
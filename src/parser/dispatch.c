@@ -0,0 +1,645 @@
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/**
+ * @file dispatch.c
+ * @brief Таблицы выбора модуля разбора по первому и второму ключевому слову.
+ *
+ * parser_statement_table[first] — правило для оператора без уточнения и, если
+ * у первого слова есть уточняемые формы, таблица по второму слову. Таблицы
+ * заполняются конструкторами модулей до main() и дальше только читаются,
+ * поэтому поиск не требует блокировок и безопасен из нескольких потоков.
+ *
+ * Состояние восстановления после ошибок (разбираемый поток, режим panic, список
+ * диагностик) хранится в переменных потока: параллельные задачи разбора не мешают
+ * друг другу, а модулям не нужно передавать его явно.
+ */
+
+typedef struct {
+    parser_statement_rule_t any;                // Правило без уточнения (parse == NULL — нет)
+    parser_statement_rule_t *second;            // [TOKEN_TYPE_COUNT] или NULL
+} parser_statement_slot_t;
+
+static parser_statement_slot_t parser_statement_table[TOKEN_TYPE_COUNT];
+
+static _Thread_local TokenStream *parser_current_stream;     // Поток внутреннего parse_statement()
+static _Thread_local diag_list_t *parser_current_diagnostics;
+static _Thread_local bool parser_panic;                     // Ошибка сообщена, синхронизации ещё не было
+static _Thread_local parser_statement_log_t *parser_current_log;
+
+/**
+ * @brief Регистрация правила в таблицах выбора.
+ */
+bool parser_register_statement(TokenType first, TokenType second, int consumed,
+                               parser_statement_fn parse, const char *name) {
+    if ((unsigned)first >= TOKEN_TYPE_COUNT || (unsigned)second >= TOKEN_TYPE_COUNT ||
+        !parse || consumed < 0 || consumed > 2 || (consumed == 2 && second == TOKEN_UNKNOWN)) {
+        fprintf(stderr, "Invalid statement rule for %s\n", name ? name : "?");
+        return false;
+    }
+
+    parser_statement_slot_t *slot = &parser_statement_table[first];
+    parser_statement_rule_t *rule = &slot->any;
+    if (second != TOKEN_UNKNOWN) {
+        if (!slot->second) {
+            slot->second = calloc(TOKEN_TYPE_COUNT, sizeof(parser_statement_rule_t));
+            if (!slot->second) {
+                fprintf(stderr, "Out of memory while registering %s\n", name ? name : "?");
+                return false;
+            }
+        }
+        rule = &slot->second[second];
+    }
+
+    if (rule->parse) {
+        fprintf(stderr, "Statement rule for %s is already registered by %s\n",
+                name ? name : "?", rule->name ? rule->name : "?");
+        return false;
+    }
+    *rule = (parser_statement_rule_t){ first, second, consumed, parse, name };
+    return true;
+}
+
+/**
+ * @brief Поиск правила: сначала по паре слов, затем по первому слову.
+ */
+const parser_statement_rule_t *parser_statement_lookup(TokenType first, TokenType second) {
+    if ((unsigned)first >= TOKEN_TYPE_COUNT) return NULL;
+    const parser_statement_slot_t *slot = &parser_statement_table[first];
+    if (slot->second && (unsigned)second < TOKEN_TYPE_COUNT && slot->second[second].parse) {
+        return &slot->second[second];
+    }
+    return slot->any.parse ? &slot->any : NULL;
+}
+
+diag_list_t *parser_diagnostics_activate(diag_list_t *list) {
+    diag_list_t *previous = parser_current_diagnostics;
+    parser_current_diagnostics = list;
+    return previous;
+}
+
+parser_statement_log_t *parser_statement_log_activate(parser_statement_log_t *log) {
+    parser_statement_log_t *previous = parser_current_log;
+    parser_current_log = log;
+    return previous;
+}
+
+void parser_statement_log_free(parser_statement_log_t *log) {
+    free(log->records);
+    free(log->message_tokens);
+    *log = (parser_statement_log_t){ 0 };
+}
+
+// Токен сообщения, только что записанного в активный список
+static void parser_statement_log_message(int token) {
+    parser_statement_log_t *log = parser_current_log;
+    if (!log) return;
+    if (log->message_count == log->message_capacity) {
+        int capacity = log->message_capacity ? log->message_capacity * 2 : 16;
+        int *tokens = realloc(log->message_tokens, (size_t)capacity * sizeof(int));
+        if (!tokens) {
+            log->failed = true;
+            return;
+        }
+        log->message_tokens = tokens;
+        log->message_capacity = capacity;
+    }
+    log->message_tokens[log->message_count++] = token;
+}
+
+// Запись оператора при входе в parse_statement(); -1 — журнала нет или не хватило памяти
+static int parser_statement_log_open(int start) {
+    parser_statement_log_t *log = parser_current_log;
+    if (!log) return -1;
+    int depth = log->depth++;
+    if (log->count == log->capacity) {
+        int capacity = log->capacity ? log->capacity * 2 : 64;
+        parser_statement_record_t *records = realloc(log->records, (size_t)capacity * sizeof(*records));
+        if (!records) {
+            log->failed = true;
+            return -1;
+        }
+        log->records = records;
+        log->capacity = capacity;
+    }
+    int diag_first = parser_current_diagnostics ? parser_current_diagnostics->count : 0;
+    log->records[log->count] = (parser_statement_record_t){ start, start, depth, NULL, diag_first, diag_first,
+                                                            parser_panic };
+    return log->count++;
+}
+
+static void parser_statement_log_close(int record, int end, ASTNode *statement) {
+    parser_statement_log_t *log = parser_current_log;
+    if (!log) return;
+    log->depth--;
+    if (record < 0) return;
+    parser_statement_record_t *entry = &log->records[record];
+    entry->end = end;
+    entry->node = statement;
+    entry->diag_end = parser_current_diagnostics ? parser_current_diagnostics->count : 0;
+}
+
+/**
+ * @brief Запись сообщения об ошибке с позицией текущего токена.
+ */
+void report_error(const char *format, ...) {
+    if (parser_panic) return;
+    parser_panic = true;
+
+    char message[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    Token token = parser_current_stream ? token_stream_peek(parser_current_stream)
+                                        : token_view(TOKEN_EOF, NULL, 0, 0, 0);
+    if (parser_current_diagnostics) {
+        if (diag_report(parser_current_diagnostics, DIAG_ERROR, token.line, token.column, "%s", message)) {
+            parser_statement_log_message(parser_current_stream ? parser_current_stream->current_index : -1);
+        }
+    } else {
+        fprintf(stderr, "Parser error at line %d, col %d: %s\n", token.line, token.column, message);
+    }
+}
+
+/**
+ * @brief Пропуск до конца оператора или до границы блока на новой строке.
+ */
+void parser_stream_synchronize(TokenStream *ts) {
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_EOF; token_stream_advance(ts)) {
+        if (type == TOKEN_PUNCTUATION_DOT) {
+            token_stream_advance(ts);
+            break;
+        }
+        // Строки сравниваются только у редких слов границы блока
+        int index = ts->current_index;
+        if (token_is_block_boundary(type) && index > 0 &&
+            token_stream_token_at(ts, index).line != token_stream_token_at(ts, index - 1).line) {
+            break;
+        }
+    }
+    parser_panic = false;
+}
+
+/**
+ * @brief Разбор оператора модулем, выбранным по ведущим токенам, с восстановлением.
+ */
+uint32_t parser_statement_offset(const TokenStream *ts) {
+    int index = ts->current_index;
+    while (index < ts->token_count && token_stream_type_at(ts, index) == TOKEN_PUNCTUATION_DOT) index++;
+    return token_stream_offset_at(ts, index);
+}
+
+void parser_offsets_push(uint32_t **offsets, int count, uint32_t offset) {
+    if (!*offsets && count > 0) return;
+    // Ёмкость — степень двойки не меньше 16: массив растёт, когда count её достигает
+    if (count == 0 || (count >= 16 && (count & (count - 1)) == 0)) {
+        size_t capacity = count ? (size_t)count * 2 : 16;
+        uint32_t *grown = realloc(*offsets, capacity * sizeof(uint32_t));
+        if (!grown) {
+            free(*offsets);
+            *offsets = NULL;
+            return;
+        }
+        *offsets = grown;
+    }
+    (*offsets)[count] = offset;
+}
+
+ASTNode *parse_statement(TokenStream *ts) {
+    if (!ts) return NULL;
+
+    // Пустые операторы (лишние точки)
+    while (token_stream_peek_type(ts) == TOKEN_PUNCTUATION_DOT) {
+        token_stream_advance(ts);
+    }
+    TokenType first = token_stream_peek_type(ts);
+    if (first == TOKEN_EOF) return NULL;
+
+    TokenStream *outer = parser_current_stream;
+    parser_current_stream = ts;
+    int start = ts->current_index;
+    atom_t start_atom = token_stream_atom_at(ts, start);
+    int record = parser_statement_log_open(start);
+
+    TokenType second = token_stream_peek_type_at(ts, 1);
+    const parser_statement_rule_t *rule = parser_statement_lookup(first, second);
+    ASTNode *statement = NULL;
+    if (rule) {
+        for (int i = 0; i < rule->consumed; i++) {
+            token_stream_advance(ts);
+        }
+        statement = rule->parse(ts);
+        if (!statement) report_error("Invalid statement");
+    } else {
+        Token token = token_stream_peek(ts);
+        report_error("Unknown statement '%.*s'", (int)token.length, token.text ? token.text : "");
+    }
+
+    if (parser_panic) {
+        ASTNode *error = ast_node_create(AST_ERROR);
+        if (error) {
+            error->atom = start_atom;
+            if (statement) ast_node_add_child(error, statement);
+        }
+        statement = error;
+        // Оператор, на котором не продвинулись, пропускается хотя бы на один токен
+        if (ts->current_index == start) token_stream_advance(ts);
+        parser_stream_synchronize(ts);
+    }
+
+    parser_statement_log_close(record, ts->current_index, statement);
+    parser_current_stream = outer;
+    return statement;
+}
+
+// ---------------------------------------------------------------------------
+// Общие шаги модулей разбора
+
+bool parser_accept(TokenStream *ts, TokenType type) {
+    if (token_stream_peek_type(ts) != type) return false;
+    token_stream_advance(ts);
+    return true;
+}
+
+bool parser_expect(TokenStream *ts, TokenType type, const char *what) {
+    if (parser_accept(ts, type)) return true;
+    report_error("Expected %s", what);
+    return false;
+}
+
+bool parser_peek_word(const TokenStream *ts, const char *word) {
+    if (!parser_is_name_token(token_stream_peek_type(ts))) return false;
+    Token token = token_stream_token_at(ts, ts->current_index);
+    return token_text_equals(&token, word);
+}
+
+bool parser_is_name_token(TokenType type) {
+    if (type == TOKEN_IDENTIFIER) return true;
+    if (type < TOKEN_KEYWORD_ABORT || type > TOKEN_KEYWORD_WRITE || token_is_block_boundary(type)) return false;
+    switch (type) {
+        case TOKEN_KEYWORD_IS:
+        case TOKEN_KEYWORD_IN:
+        case TOKEN_KEYWORD_BETWEEN:
+        case TOKEN_KEYWORD_TRUE:
+        case TOKEN_KEYWORD_FALSE:
+        case TOKEN_KEYWORD_IMPORTING:
+        case TOKEN_KEYWORD_EXPORTING:
+        case TOKEN_KEYWORD_CHANGING:
+        case TOKEN_KEYWORD_RETURNING:
+        case TOKEN_KEYWORD_RAISING:
+        case TOKEN_KEYWORD_EXCEPTIONS:
+            return false;
+        default:
+            return true;
+    }
+}
+
+atom_t parser_peek_name(const TokenStream *ts) {
+    if (!parser_is_name_token(token_stream_peek_type(ts))) return ATOM_NONE;
+    // Атом лексер заводит только идентификаторам; имя-ключевое слово интернируется здесь
+    Token token = token_stream_token_at(ts, ts->current_index);
+    return token_atom(&token);
+}
+
+atom_t parser_accept_name(TokenStream *ts) {
+    atom_t name = parser_peek_name(ts);
+    if (name != ATOM_NONE) token_stream_advance(ts);
+    return name;
+}
+
+bool parser_accept_word(TokenStream *ts, const char *word) {
+    if (!parser_peek_word(ts, word)) return false;
+    token_stream_advance(ts);
+    return true;
+}
+
+bool parser_end_statement(TokenStream *ts) {
+    return parser_expect(ts, TOKEN_PUNCTUATION_DOT, "'.' at end of statement");
+}
+
+bool parser_parse_block(TokenStream *ts, ASTNode *parent, const TokenType *ends, int end_count,
+                        const char *what) {
+    for (;;) {
+        // Лишние точки пропускаются здесь, чтобы завершающее слово за ними было видно
+        while (parser_accept(ts, TOKEN_PUNCTUATION_DOT)) {}
+        TokenType type = token_stream_peek_type(ts);
+        if (type == TOKEN_EOF) {
+            report_error("Expected %s", what);
+            return false;
+        }
+        for (int i = 0; i < end_count; i++) {
+            if (type == ends[i]) return true;
+        }
+        ASTNode *statement = parse_statement(ts);
+        if (!statement) return false;
+        ast_node_add_child(parent, statement);
+    }
+}
+
+ASTNode *parser_add_clause(ASTNode *parent, const char *keywords) {
+    ASTNode *clause = ast_node_create(AST_STATEMENT_CLAUSE);
+    if (clause) clause->string_value = ast_strndup(keywords, strlen(keywords));
+    if (!clause || !clause->string_value) {
+        report_error("Failed to allocate AST node for %s", keywords);
+        ast_node_free(clause);
+        return NULL;
+    }
+    ast_node_add_child(parent, clause);
+    return clause;
+}
+
+bool parser_parse_clause(TokenStream *ts, ASTNode *parent, const char *keywords) {
+    ASTNode *clause = parser_add_clause(parent, keywords);
+    if (!clause) return false;
+    ASTNode *operand = parse_expression(ts);
+    if (!operand) return false;
+    ast_node_add_child(clause, operand);
+    return true;
+}
+
+// Число токенов, совпавших со словами words с текущей позиции, или 0
+static int parser_match_words(const TokenStream *ts, const char *words) {
+    int count = 0;
+    for (const char *word = words; *word; count++) {
+        size_t length = strcspn(word, " ");
+        int index = ts->current_index + count;
+        if (token_stream_peek_type_at(ts, count) == TOKEN_EOF ||
+            token_stream_length_at(ts, index) != length ||
+            strncasecmp(ts->source + token_stream_offset_at(ts, index), word, length) != 0) {
+            return 0;
+        }
+        word += length;
+        while (*word == ' ') word++;
+    }
+    return count;
+}
+
+// Дополнение таблицы, с которого начинается текущая позиция, или NULL
+static const parser_clause_t *parser_match_clause(const TokenStream *ts, const parser_clause_t *clauses,
+                                                  int count, int *matched) {
+    for (int i = 0; i < count; i++) {
+        if ((*matched = parser_match_words(ts, clauses[i].words)) > 0) return &clauses[i];
+    }
+    return NULL;
+}
+
+bool parser_peek_clause(const TokenStream *ts, const parser_clause_t *clauses, int count) {
+    int matched;
+    return parser_match_clause(ts, clauses, count, &matched) != NULL;
+}
+
+bool parser_parse_clauses(TokenStream *ts, ASTNode *node, const parser_clause_t *clauses, int count) {
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF; ) {
+        int matched;
+        const parser_clause_t *entry = parser_match_clause(ts, clauses, count, &matched);
+        if (!entry) {
+            report_error("Unexpected token in statement");
+            return false;
+        }
+        for (int i = 0; i < matched; i++) token_stream_advance(ts);
+
+        ASTNode *clause = parser_add_clause(node, entry->words);
+        if (!clause) return false;
+        switch (entry->kind) {
+            case PARSER_CLAUSE_FLAG:
+                break;
+            case PARSER_CLAUSE_OPERAND: {
+                ASTNode *operand = parse_expression(ts);
+                if (!operand) return false;
+                ast_node_add_child(clause, operand);
+                break;
+            }
+            case PARSER_CLAUSE_LIST:
+                while ((type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF &&
+                       !parser_peek_clause(ts, clauses, count)) {
+                    parser_accept(ts, TOKEN_PUNCTUATION_COMMA);
+                    ASTNode *operand = parse_expression_prec(ts, PARSER_PREC_CONCAT);
+                    if (!operand) return false;
+                    ast_node_add_child(clause, operand);
+                }
+                break;
+            case PARSER_CLAUSE_BINDINGS:
+                if (!parse_bindings(ts, clause)) return false;
+                break;
+        }
+        if (entry->kind != PARSER_CLAUSE_FLAG && clause->child_count == 0) {
+            report_error("Expected operand after %s", entry->words);
+            return false;
+        }
+    }
+    return true;
+}
+
+ASTNode *parser_parse_keyword_statement(TokenStream *ts, const char *keywords,
+                                        const parser_clause_t *clauses, int count) {
+    ASTNode *node = ast_node_create(AST_KEYWORD_STATEMENT);
+    if (node) node->string_value = ast_strndup(keywords, strlen(keywords));
+    if (!node || !node->string_value) {
+        report_error("Failed to allocate AST node for %s", keywords);
+        ast_node_free(node);
+        return NULL;
+    }
+
+    if (token_stream_peek_type(ts) != TOKEN_PUNCTUATION_DOT && !parser_peek_clause(ts, clauses, count)) {
+        ASTNode *operand = parse_expression_prec(ts, PARSER_PREC_CONCAT);
+        if (!operand) return node;
+        if (operand->type == AST_IDENTIFIER) node->atom = operand->atom;
+        ast_node_add_child(node, operand);
+    }
+    if (parser_parse_clauses(ts, node, clauses, count)) parser_end_statement(ts);
+    return node;
+}
+
+// Текст токенов [first, last] вместе с промежутками между ними
+static char *parser_span_strdup(const TokenStream *ts, int first, int last) {
+    uint32_t start = token_stream_offset_at(ts, first);
+    uint32_t end = token_stream_offset_at(ts, last) + token_stream_length_at(ts, last);
+    return ast_strndup(ts->source + start, end - start);
+}
+
+static ASTNode *parser_spec_node(ASTNodeType type, atom_t atom, const char *text, size_t length) {
+    ASTNode *spec = ast_node_create(type);
+    if (spec) {
+        spec->atom = atom;
+        if (text) spec->string_value = ast_strndup(text, length);
+    }
+    if (!spec || (text && !spec->string_value)) {
+        report_error("Failed to allocate AST node for declaration specifier");
+        ast_node_free(spec);
+        return NULL;
+    }
+    return spec;
+}
+
+// TYPE/LIKE с уточнением: REF TO, LINE OF, RANGE OF, [вид] TABLE OF
+static ASTNode *parser_parse_type_reference(TokenStream *ts, ASTNodeType kind) {
+    const char *prefix = NULL;
+    if (parser_accept_word(ts, "REF")) {
+        if (!parser_expect(ts, TOKEN_KEYWORD_TO, "TO after REF")) return NULL;
+        prefix = "REF TO";
+    } else if (parser_peek_word(ts, "LINE") && token_stream_peek_type_at(ts, 1) == TOKEN_KEYWORD_OF) {
+        token_stream_advance(ts);
+        token_stream_advance(ts);
+        kind = AST_LINE_OF_SPEC;
+    } else if (parser_accept_word(ts, "RANGE")) {
+        if (!parser_expect(ts, TOKEN_KEYWORD_OF, "OF after RANGE")) return NULL;
+        prefix = "RANGE OF";
+    } else {
+        static const char *const table_kinds[] = { "STANDARD", "SORTED", "HASHED", "ANY", "INDEX" };
+        for (size_t i = 0; i < sizeof(table_kinds) / sizeof(table_kinds[0]); i++) {
+            if (parser_peek_word(ts, table_kinds[i]) && token_stream_peek_type_at(ts, 1) == TOKEN_KEYWORD_TABLE) {
+                token_stream_advance(ts);
+                break;
+            }
+        }
+        if (parser_accept(ts, TOKEN_KEYWORD_TABLE)) {
+            // Обобщённый табличный тип (TYPE ANY TABLE, TYPE STANDARD TABLE) — без строки
+            if (!parser_accept(ts, TOKEN_KEYWORD_OF)) return parser_spec_node(kind, ATOM_NONE, "TABLE", 5);
+            prefix = "TABLE OF";
+        }
+    }
+
+    atom_t name = parse_name(ts);
+    if (name == ATOM_NONE) {
+        report_error("Expected type name");
+        return NULL;
+    }
+    ASTNode *spec = parser_spec_node(kind, name, prefix, prefix ? strlen(prefix) : 0);
+    // Ключ таблицы на раскладку строки не влияет
+    if (spec && prefix && prefix[0] == 'T' && parser_accept(ts, TOKEN_KEYWORD_WITH)) {
+        for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT &&
+                             type != TOKEN_KEYWORD_VALUE && type != TOKEN_EOF; ) {
+            token_stream_advance(ts);
+        }
+    }
+    return spec;
+}
+
+// Значение VALUE: литерал (со знаком), имя константы или IS INITIAL — текст как в исходнике
+static ASTNode *parser_parse_value(TokenStream *ts) {
+    int first = ts->current_index;
+    TokenType type = token_stream_peek_type(ts);
+    if (type == TOKEN_KEYWORD_IS) {
+        token_stream_advance(ts);
+        if (!parser_expect(ts, TOKEN_KEYWORD_INITIAL, "INITIAL after VALUE IS")) return NULL;
+    } else if (type == TOKEN_IDENTIFIER) {
+        atom_t name = parse_name(ts);
+        return parser_spec_node(AST_VALUE_SPEC, ATOM_NONE, atom_text(name), atom_length(name));
+    } else {
+        if (type == TOKEN_OPERATOR_MINUS || type == TOKEN_OPERATOR_PLUS) {
+            token_stream_advance(ts);
+            type = token_stream_peek_type(ts);
+        }
+        if (type != TOKEN_LITERAL_STRING && type != TOKEN_LITERAL_CHAR && type != TOKEN_LITERAL_NUM_INT &&
+            type != TOKEN_LITERAL_NUM_FLOAT && type != TOKEN_LITERAL_NUM_HEX) {
+            report_error("Expected literal after VALUE");
+            return NULL;
+        }
+        token_stream_advance(ts);
+    }
+
+    ASTNode *spec = parser_spec_node(AST_VALUE_SPEC, ATOM_NONE, NULL, 0);
+    if (spec && !(spec->string_value = parser_span_strdup(ts, first, ts->current_index - 1))) {
+        report_error("Failed to allocate declaration value");
+        ast_node_free(spec);
+        return NULL;
+    }
+    return spec;
+}
+
+bool parser_parse_type_specs(TokenStream *ts, ASTNode *decl) {
+    for (;;) {
+        TokenType type = token_stream_peek_type(ts);
+        ASTNode *spec;
+        if (type == TOKEN_KEYWORD_TYPE || type == TOKEN_KEYWORD_LIKE) {
+            token_stream_advance(ts);
+            spec = parser_parse_type_reference(ts, type == TOKEN_KEYWORD_TYPE ? AST_TYPE_SPEC : AST_LIKE_SPEC);
+        } else if (parser_peek_word(ts, "LENGTH") || parser_peek_word(ts, "DECIMALS")) {
+            ASTNodeType kind = parser_peek_word(ts, "LENGTH") ? AST_LENGTH_SPEC : AST_DECIMALS_SPEC;
+            token_stream_advance(ts);
+            Token number = token_stream_peek(ts);
+            if (number.type != TOKEN_LITERAL_NUM_INT && number.type != TOKEN_IDENTIFIER) {
+                report_error("Expected number after %s", kind == AST_LENGTH_SPEC ? "LENGTH" : "DECIMALS");
+                return false;
+            }
+            token_stream_advance(ts);
+            spec = parser_spec_node(kind, ATOM_NONE, number.text, number.length);
+        } else if (type == TOKEN_KEYWORD_VALUE && token_stream_peek_type_at(ts, 1) != TOKEN_PUNCTUATION_LPAREN &&
+                   token_stream_peek_type_at(ts, 1) != TOKEN_KEYWORD_TYPE &&
+                   token_stream_peek_type_at(ts, 1) != TOKEN_KEYWORD_LIKE) {
+            // VALUE(name), VALUE TYPE и VALUE LIKE начинают следующий параметр METHODS или FORM
+            token_stream_advance(ts);
+            spec = parser_parse_value(ts);
+        } else if (type == TOKEN_KEYWORD_READ && token_stream_peek_type_at(ts, 1) == TOKEN_OPERATOR_MINUS) {
+            // READ-ONLY: видимость записи, на раскладку не влияет
+            token_stream_advance(ts);
+            token_stream_advance(ts);
+            if (!parser_accept_word(ts, "ONLY")) {
+                report_error("Expected READ-ONLY");
+                return false;
+            }
+            continue;
+        } else {
+            return true;
+        }
+        if (!spec) return false;
+        ast_node_add_child(decl, spec);
+    }
+}
+
+bool parser_parse_structure(TokenStream *ts, ASTNode *decl, TokenType keyword) {
+    token_stream_advance(ts); // BEGIN
+    if (!parser_expect(ts, TOKEN_KEYWORD_OF, "OF after BEGIN")) return false;
+    if ((decl->atom = parser_accept_name(ts)) == ATOM_NONE) {
+        report_error("Expected structure name after BEGIN OF");
+        return false;
+    }
+    if (!parser_end_statement(ts)) return false;
+
+    for (;;) {
+        while (parser_accept(ts, TOKEN_PUNCTUATION_DOT)) {}
+        TokenType type = token_stream_peek_type(ts);
+        if (type == TOKEN_EOF) {
+            report_error("Expected END OF %s", atom_text(decl->atom));
+            return false;
+        }
+        if (type == keyword && token_stream_peek_type_at(ts, 1) == TOKEN_KEYWORD_END) break;
+        ASTNode *component = parse_statement(ts);
+        if (!component) return false;
+        ast_node_add_child(decl, component);
+    }
+
+    token_stream_advance(ts); // DATA / TYPES
+    token_stream_advance(ts); // END
+    if (!parser_expect(ts, TOKEN_KEYWORD_OF, "OF after END")) return false;
+    if (parser_peek_name(ts) != decl->atom) {
+        report_error("Structure name mismatch in END OF %s", atom_text(decl->atom));
+        return false;
+    }
+    token_stream_advance(ts);
+    return true;
+}
+
+atom_t parser_parse_parameter_name(TokenStream *ts) {
+    // VALUE и REFERENCE без скобки — само имя параметра
+    bool wrapped = (token_stream_peek_type(ts) == TOKEN_KEYWORD_VALUE || parser_peek_word(ts, "REFERENCE")) &&
+                   token_stream_peek_type_at(ts, 1) == TOKEN_PUNCTUATION_LPAREN;
+    if (wrapped) {
+        token_stream_advance(ts);
+        token_stream_advance(ts);
+    }
+    atom_t name = parser_accept_name(ts);
+    if (name == ATOM_NONE) {
+        report_error("Expected parameter name");
+        return ATOM_NONE;
+    }
+    if (wrapped && !parser_expect(ts, TOKEN_PUNCTUATION_RPAREN, "')' after parameter name")) return ATOM_NONE;
+    return name;
+}
@@ -67,14 +67,7 @@ ASTNode *parse_array_access(TokenStream *ts) {
         ast_node_free(array_access_node);
         return NULL;
     }
-    array_var_node->string_value = strdup(token->text);
-    if (!array_var_node->string_value) {
-        report_error("Failed to allocate memory for array variable name");
-        ast_node_free(index_expr);
-        ast_node_free(array_access_node);
-        ast_node_free(array_var_node);
-        return NULL;
-    }
+    array_var_node->atom = token_atom(token);
 
     // Добавляем в узел доступа переменную и индекс
     ast_node_add_child(array_access_node, array_var_node);
@@ -58,14 +58,7 @@ ASTNode *parse_assignment_expression(TokenStream *ts) {
         ast_node_free(assign_node);
         return NULL;
     }
-    var_node->string_value = strdup(token->text);
-    if (!var_node->string_value) {
-        report_error("Failed to allocate memory for variable name");
-        ast_node_free(expr_right);
-        ast_node_free(assign_node);
-        ast_node_free(var_node);
-        return NULL;
-    }
+    var_node->atom = token_atom(token);
 
     ast_node_add_child(assign_node, var_node);
     ast_node_add_child(assign_node, expr_right);
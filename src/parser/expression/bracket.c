@@ -2,15 +2,18 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 
 /**
  * parse_bracket_expression - Парсит выражение в круглых скобках.
  *
- * Ожидается, что текущий токен — открывающая скобка '('.
- * После неё парсится вложенное выражение, затем должна быть закрывающая скобка ')'.
+ * Ожидается, что текущий токен — открывающая скобка '('. Скобки разбирает
+ * разборщик выражений как операнд, поэтому за закрывающей скобкой выражение
+ * продолжается: "( a + b ) * c".
  *
- * Возвращает AST узел вложенного выражения или NULL при ошибке.
+ * Возвращает AST узел выражения (без отдельного узла для скобок) или NULL при ошибке.
  */
 ASTNode *parse_bracket_expression(TokenStream *ts) {
     if (!ts) {
@@ -18,36 +21,10 @@ ASTNode *parse_bracket_expression(TokenStream *ts) {
         return NULL;
     }
 
-    Token *token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_LPAREN) {
+    if (token_stream_peek_type(ts) != TOKEN_PUNCTUATION_LPAREN) {
         report_error("Expected '(' at start of bracket expression");
         return NULL;
     }
 
-    // Здесь вызываем функцию парсинга общего выражения (parse_expression)
-    // Предположим, она существует и возвращает ASTNode*
-    ASTNode *expr_node = parse_expression(ts);
-    if (!expr_node) {
-        report_error("Failed to parse expression inside brackets");
-        return NULL;
-    }
-
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_RPAREN) {
-        report_error("Expected ')' after bracketed expression");
-        ast_node_free(expr_node);
-        return NULL;
-    }
-
-    // Для удобства можно обернуть выражение в специальный AST узел BRACKETED_EXPR,
-    // либо возвращать expr_node напрямую, если нет такой необходимости.
-    ASTNode *bracket_node = ast_node_create(AST_BRACKETED_EXPR);
-    if (!bracket_node) {
-        report_error("Failed to allocate AST node for bracketed expression");
-        ast_node_free(expr_node);
-        return NULL;
-    }
-
-    ast_node_add_child(bracket_node, expr_node);
-    return bracket_node;
+    return parse_expression(ts);
 }
@@ -30,12 +30,7 @@ ASTNode *parse_function_call(TokenStream *ts) {
         return NULL;
     }
 
-    func_call_node->string_value = strdup(token->text);
-    if (!func_call_node->string_value) {
-        report_error("Failed to allocate memory for function name");
-        ast_node_free(func_call_node);
-        return NULL;
-    }
+    func_call_node->atom = token_atom(token);
 
     token = token_stream_next(ts);
     if (!token || token->type != TOKEN_LPAREN) {
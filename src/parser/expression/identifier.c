@@ -36,12 +36,7 @@ ASTNode *parse_identifier(TokenStream *ts) {
         return NULL;
     }
 
-    identifier_node->string_value = strdup(token->text);
-    if (!identifier_node->string_value) {
-        report_error("Failed to allocate memory for identifier string");
-        ast_node_free(identifier_node);
-        return NULL;
-    }
+    identifier_node->atom = token_atom(token);
 
     return identifier_node;
 }
@@ -13,6 +13,19 @@
  *
  * Возвращает AST узел литерала или NULL при ошибке.
  */
+/**
+ * literal_number_text - Копирует числовую лексему в локальный буфер.
+ *
+ * Лексема — срез исходного буфера без завершающего нуля, поэтому
+ * atoi/atof нельзя вызывать прямо на token->text.
+ */
+static const char *literal_number_text(const Token *token, char *buffer, size_t size) {
+    size_t length = token->length < size - 1 ? token->length : size - 1;
+    memcpy(buffer, token->text, length);
+    buffer[length] = '\0';
+    return buffer;
+}
+
 ASTNode *parse_literal(TokenStream *ts) {
     if (!ts) {
         report_error("TokenStream is NULL in parse_literal");
@@ -31,18 +44,19 @@ ASTNode *parse_literal(TokenStream *ts) {
         return NULL;
     }
 
+    char number[64];
     switch (token->type) {
         case TOKEN_INTEGER_LITERAL:
             literal_node->literal_type = LITERAL_INT;
-            literal_node->int_value = atoi(token->text);
+            literal_node->int_value = atoi(literal_number_text(token, number, sizeof(number)));
             break;
         case TOKEN_FLOAT_LITERAL:
             literal_node->literal_type = LITERAL_FLOAT;
-            literal_node->float_value = atof(token->text);
+            literal_node->float_value = atof(literal_number_text(token, number, sizeof(number)));
             break;
         case TOKEN_STRING_LITERAL:
             literal_node->literal_type = LITERAL_STRING;
-            literal_node->string_value = strdup(token->text);
+            literal_node->string_value = ast_token_strdup(token);
             if (!literal_node->string_value) {
                 report_error("Failed to allocate memory for string literal");
                 ast_node_free(literal_node);
@@ -2,14 +2,18 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
+#include <string.h>
 
 /**
  * parse_operator - Парсит оператор из токенов.
  *
- * Поддерживаются операторы: +, -, *, /, AND, OR, =, <>, >, <, >=, <= и другие.
+ * Поддерживаются операторы таблицы приоритетов (parser_expression.h): +, -, *, /, MOD, **,
+ * &&, AND, OR, NOT, =, <>, >, <, >=, <=, а также IS, BETWEEN и IN.
  *
- * Возвращает AST узел оператора или NULL при ошибке.
+ * Возвращает узел AST_OPERATOR с текстом оператора в string_value или NULL при ошибке.
  */
 ASTNode *parse_operator(TokenStream *ts) {
     if (!ts) {
@@ -17,58 +21,24 @@ ASTNode *parse_operator(TokenStream *ts) {
         return NULL;
     }
 
-    Token *token = token_stream_next(ts);
-    if (!token) {
+    TokenType type = token_stream_peek_type(ts);
+    if (type == TOKEN_EOF) {
         report_error("Unexpected end of tokens while parsing operator");
         return NULL;
     }
 
-    ASTNodeType node_type;
-    switch (token->type) {
-        case TOKEN_PLUS:
-            node_type = AST_OPERATOR_PLUS;
-            break;
-        case TOKEN_MINUS:
-            node_type = AST_OPERATOR_MINUS;
-            break;
-        case TOKEN_ASTERISK:
-            node_type = AST_OPERATOR_MULTIPLY;
-            break;
-        case TOKEN_SLASH:
-            node_type = AST_OPERATOR_DIVIDE;
-            break;
-        case TOKEN_KEYWORD_AND:
-            node_type = AST_OPERATOR_AND;
-            break;
-        case TOKEN_KEYWORD_OR:
-            node_type = AST_OPERATOR_OR;
-            break;
-        case TOKEN_EQUAL:
-            node_type = AST_OPERATOR_EQUAL;
-            break;
-        case TOKEN_NOT_EQUAL:
-            node_type = AST_OPERATOR_NOT_EQUAL;
-            break;
-        case TOKEN_GREATER:
-            node_type = AST_OPERATOR_GREATER;
-            break;
-        case TOKEN_LESS:
-            node_type = AST_OPERATOR_LESS;
-            break;
-        case TOKEN_GREATER_EQUAL:
-            node_type = AST_OPERATOR_GREATER_EQUAL;
-            break;
-        case TOKEN_LESS_EQUAL:
-            node_type = AST_OPERATOR_LESS_EQUAL;
-            break;
-        default:
-            report_error("Unexpected token type for operator");
-            return NULL;
+    const char *text = parser_operator_text(type);
+    if (!text) {
+        report_error("Unexpected token type for operator");
+        return NULL;
     }
+    token_stream_advance(ts);
 
-    ASTNode *operator_node = ast_node_create(node_type);
-    if (!operator_node) {
+    ASTNode *operator_node = ast_node_create(AST_OPERATOR);
+    if (operator_node) operator_node->string_value = ast_strndup(text, strlen(text));
+    if (!operator_node || !operator_node->string_value) {
         report_error("Failed to allocate AST node for operator");
+        ast_node_free(operator_node);
         return NULL;
     }
 
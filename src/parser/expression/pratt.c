@@ -0,0 +1,346 @@
+#include "../../include/parser_expression.h"
+#include "../../include/parser_dispatch.h"
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @file pratt.c
+ * @brief Разбор выражений методом Пратта.
+ *
+ * Левый операнд разбирается parser_parse_operand(), затем цикл в parse_expression_prec()
+ * присоединяет инфиксные операторы, пока их приоритет не ниже минимального. Правый
+ * операнд разбирается тем же циклом с минимальным приоритетом из таблицы: для
+ * левоассоциативных операторов он на единицу выше собственного, для ** — ниже.
+ * Цепочка "a + b - c + d" собирается одним циклом без рекурсии по уровням грамматики.
+ *
+ * Имя, за которым вплотную идёт "(", — функциональный вызов (AST_FUNCTION_CALL).
+ */
+
+// Инфиксный оператор: приоритет слева, минимальный приоритет правого операнда, текст узла
+typedef struct {
+    uint8_t precedence;
+    uint8_t right;
+    const char *text;
+} parser_infix_rule_t;
+
+// Таблица приоритетов, индексируемая типом токена; нулевой приоритет — не инфиксный оператор
+static const parser_infix_rule_t parser_infix_rules[TOKEN_TYPE_COUNT] = {
+    [TOKEN_OPERATOR_OR]       = { PARSER_PREC_OR,             PARSER_PREC_AND,            "OR" },
+    [TOKEN_OPERATOR_AND]      = { PARSER_PREC_AND,            PARSER_PREC_NOT,            "AND" },
+    [TOKEN_OPERATOR_EQ]       = { PARSER_PREC_COMPARISON,     PARSER_PREC_CONCAT,         "=" },
+    [TOKEN_OPERATOR_NEQ]      = { PARSER_PREC_COMPARISON,     PARSER_PREC_CONCAT,         "<>" },
+    [TOKEN_OPERATOR_LT]       = { PARSER_PREC_COMPARISON,     PARSER_PREC_CONCAT,         "<" },
+    [TOKEN_OPERATOR_GT]       = { PARSER_PREC_COMPARISON,     PARSER_PREC_CONCAT,         ">" },
+    [TOKEN_OPERATOR_LE]       = { PARSER_PREC_COMPARISON,     PARSER_PREC_CONCAT,         "<=" },
+    [TOKEN_OPERATOR_GE]       = { PARSER_PREC_COMPARISON,     PARSER_PREC_CONCAT,         ">=" },
+    [TOKEN_KEYWORD_IS]        = { PARSER_PREC_COMPARISON,     PARSER_PREC_NONE,           "IS" },
+    [TOKEN_KEYWORD_BETWEEN]   = { PARSER_PREC_COMPARISON,     PARSER_PREC_CONCAT,         "BETWEEN" },
+    [TOKEN_KEYWORD_IN]        = { PARSER_PREC_COMPARISON,     PARSER_PREC_CONCAT,         "IN" },
+    [TOKEN_OPERATOR_CONCAT]   = { PARSER_PREC_CONCAT,         PARSER_PREC_ADDITIVE,       "&&" },
+    [TOKEN_OPERATOR_PLUS]     = { PARSER_PREC_ADDITIVE,       PARSER_PREC_MULTIPLICATIVE, "+" },
+    [TOKEN_OPERATOR_MINUS]    = { PARSER_PREC_ADDITIVE,       PARSER_PREC_MULTIPLICATIVE, "-" },
+    [TOKEN_OPERATOR_MULTIPLY] = { PARSER_PREC_MULTIPLICATIVE, PARSER_PREC_UNARY,          "*" },
+    [TOKEN_OPERATOR_DIVIDE]   = { PARSER_PREC_MULTIPLICATIVE, PARSER_PREC_UNARY,          "/" },
+    [TOKEN_OPERATOR_MODULO]   = { PARSER_PREC_MULTIPLICATIVE, PARSER_PREC_UNARY,          "MOD" },
+    // Правый операнд ** разбирается с приоритетом ниже ** — отсюда правая ассоциативность
+    [TOKEN_OPERATOR_POWER]    = { PARSER_PREC_POWER,          PARSER_PREC_UNARY,          "**" },
+};
+
+parser_precedence_t parser_infix_precedence(TokenType type) {
+    if ((unsigned)type >= TOKEN_TYPE_COUNT) return PARSER_PREC_NONE;
+    return (parser_precedence_t)parser_infix_rules[type].precedence;
+}
+
+const char *parser_operator_text(TokenType type) {
+    if (type == TOKEN_OPERATOR_NOT) return "NOT";
+    if ((unsigned)type >= TOKEN_TYPE_COUNT) return NULL;
+    return parser_infix_rules[type].text;
+}
+
+// Узел оператора с операндами left и right (любой может отсутствовать)
+static ASTNode *parser_operator_node(const char *text, size_t length, ASTNode *left, ASTNode *right) {
+    ASTNode *node = ast_node_create(AST_OPERATOR);
+    if (node) node->string_value = ast_strndup(text, length);
+    if (!node || !node->string_value) {
+        report_error("Failed to allocate AST node for operator '%.*s'", (int)length, text);
+        ast_node_free(node);
+        ast_node_free(left);
+        ast_node_free(right);
+        return NULL;
+    }
+    ast_node_add_child(node, left);
+    ast_node_add_child(node, right);
+    return node;
+}
+
+// Лексема токена index вплотную (без пробела) за лексемой предыдущего
+static bool parser_token_adjacent(const TokenStream *ts, int index) {
+    return token_stream_offset_at(ts, index - 1) + token_stream_length_at(ts, index - 1) ==
+           token_stream_offset_at(ts, index);
+}
+
+// Имя: идентификатор или ключевое слово (parser_is_name_token()). Компоненты, записанные
+// без пробелов (struct-field, ref->attr, class=>const, intf~meth), входят в имя: в ABAP
+// операторы всегда отделяются пробелами.
+atom_t parse_name(TokenStream *ts) {
+    int first = ts->current_index;
+    int last = first;
+    if (token_stream_peek_type(ts) == TOKEN_OPERATOR_LT) {
+        // <fs>: три токена вплотную
+        if (!parser_is_name_token(token_stream_peek_type_at(ts, 1)) ||
+            token_stream_peek_type_at(ts, 2) != TOKEN_OPERATOR_GT ||
+            !parser_token_adjacent(ts, first + 1) || !parser_token_adjacent(ts, first + 2)) {
+            return ATOM_NONE;
+        }
+        for (int k = 0; k < 3; k++) token_stream_advance(ts);
+        last = first + 2;
+    } else if (parser_is_name_token(token_stream_peek_type(ts))) {
+        token_stream_advance(ts);
+    } else {
+        return ATOM_NONE;
+    }
+    for (;;) {
+        int offset = 1;
+        TokenType separator = token_stream_peek_type(ts);
+        if (separator == TOKEN_OPERATOR_MINUS || separator == TOKEN_OPERATOR_EQ) {
+            if (token_stream_peek_type_at(ts, 1) == TOKEN_OPERATOR_GT) offset = 2;
+            else if (separator == TOKEN_OPERATOR_EQ) break;
+        } else if (separator != TOKEN_UNKNOWN || token_stream_length_at(ts, last + 1) != 1 ||
+                   ts->source[token_stream_offset_at(ts, last + 1)] != '~') {
+            break;      // intf~comp: '~' лексер отдаёт неизвестным токеном
+        }
+        int index = last + 1;
+        if (!parser_is_name_token(token_stream_peek_type_at(ts, offset))) break;
+        bool adjacent = true;
+        for (int k = 0; adjacent && k <= offset; k++) adjacent = parser_token_adjacent(ts, index + k);
+        if (!adjacent) break;
+        for (int k = 0; k <= offset; k++) token_stream_advance(ts);
+        last = index + offset;
+    }
+
+    if (last == first) {
+        // Атом лексер заводит только идентификаторам; у имени-ключевого слова его нет
+        Token token = token_stream_token_at(ts, first);
+        return token_atom(&token);
+    }
+    uint32_t start = token_stream_offset_at(ts, first);
+    uint32_t end = token_stream_offset_at(ts, last) + token_stream_length_at(ts, last);
+    return atom_intern(ts->source + start, end - start);
+}
+
+// Список name = value; "=" после имени отличает привязку от операнда
+bool parse_bindings(TokenStream *ts, ASTNode *parent) {
+    while (parser_is_name_token(token_stream_peek_type(ts)) &&
+           token_stream_peek_type_at(ts, 1) == TOKEN_OPERATOR_EQ) {
+        ASTNode *binding = ast_node_create(AST_PARAMETER_BINDING);
+        if (!binding) {
+            report_error("Failed to allocate AST node for parameter binding");
+            return false;
+        }
+        binding->atom = parser_accept_name(ts);
+        ast_node_add_child(parent, binding);
+        token_stream_advance(ts); // =
+        ASTNode *value = parse_expression_prec(ts, PARSER_PREC_CONCAT);
+        if (!value) return false;
+        ast_node_add_child(binding, value);
+    }
+    return true;
+}
+
+// Аргументы функционального вызова после "(": пусто, одно выражение или список
+// name = value (перед списком допускается EXPORTING)
+static bool parser_parse_arguments(TokenStream *ts, ASTNode *call) {
+    parser_accept(ts, TOKEN_KEYWORD_EXPORTING);
+    bool named = parser_is_name_token(token_stream_peek_type(ts)) &&
+                 token_stream_peek_type_at(ts, 1) == TOKEN_OPERATOR_EQ;
+    if (!named && token_stream_peek_type(ts) != TOKEN_PUNCTUATION_RPAREN) {
+        ASTNode *argument = parse_expression_prec(ts, PARSER_PREC_NONE);
+        if (!argument) return false;
+        ast_node_add_child(call, argument);
+    }
+    if (named && !parse_bindings(ts, call)) return false;
+    return parser_expect(ts, TOKEN_PUNCTUATION_RPAREN, "')' after arguments");
+}
+
+// Имя операнда; "(" вплотную за именем — функциональный вызов
+static ASTNode *parser_parse_name(TokenStream *ts) {
+    atom_t name = parse_name(ts);
+    if (name == ATOM_NONE) {
+        report_error("Expected name in expression");
+        return NULL;
+    }
+    bool call = token_stream_peek_type(ts) == TOKEN_PUNCTUATION_LPAREN &&
+                parser_token_adjacent(ts, ts->current_index);
+    ASTNode *node = ast_node_create(call ? AST_FUNCTION_CALL : AST_IDENTIFIER);
+    if (!node) {
+        report_error("Failed to allocate AST node for identifier");
+        return NULL;
+    }
+    node->atom = name;
+    if (call) {
+        token_stream_advance(ts);
+        if (!parser_parse_arguments(ts, node)) {
+            ast_node_free(node);
+            return NULL;
+        }
+    }
+    return node;
+}
+
+// Операнд: литерал, имя, выражение в скобках или префиксный оператор с операндом
+static ASTNode *parser_parse_operand(TokenStream *ts) {
+    Token token = token_stream_peek(ts);
+    switch (token.type) {
+        case TOKEN_LITERAL_STRING:
+        case TOKEN_LITERAL_NUM_INT:
+        case TOKEN_LITERAL_NUM_FLOAT:
+        case TOKEN_LITERAL_NUM_HEX:
+        case TOKEN_LITERAL_CHAR:
+        case TOKEN_LITERAL_TEMPLATE:
+        case TOKEN_KEYWORD_TRUE:
+        case TOKEN_KEYWORD_FALSE: {
+            token_stream_advance(ts);
+            ASTNode *node = ast_node_create(AST_LITERAL);
+            if (node) node->string_value = ast_token_strdup(&token);
+            if (!node || !node->string_value) {
+                report_error("Failed to allocate AST node for literal");
+                ast_node_free(node);
+                return NULL;
+            }
+            return node;
+        }
+        case TOKEN_IDENTIFIER:
+        case TOKEN_OPERATOR_LT:
+            return parser_parse_name(ts);
+        case TOKEN_PUNCTUATION_LPAREN: {
+            token_stream_advance(ts);
+            ASTNode *inner = parse_expression_prec(ts, PARSER_PREC_NONE);
+            if (!inner) return NULL;
+            if (token_stream_peek_type(ts) != TOKEN_PUNCTUATION_RPAREN) {
+                report_error("Expected ')' after expression");
+                ast_node_free(inner);
+                return NULL;
+            }
+            token_stream_advance(ts);
+            return inner;
+        }
+        case TOKEN_OPERATOR_PLUS:
+        case TOKEN_OPERATOR_MINUS:
+        case TOKEN_OPERATOR_NOT: {
+            token_stream_advance(ts);
+            parser_precedence_t precedence = token.type == TOKEN_OPERATOR_NOT ? PARSER_PREC_NOT : PARSER_PREC_UNARY;
+            ASTNode *operand = parse_expression_prec(ts, precedence);
+            if (!operand) return NULL;
+            const char *text = parser_operator_text(token.type);
+            return parser_operator_node(text, strlen(text), operand, NULL);
+        }
+        case TOKEN_EOF:
+            report_error("Unexpected end of input in expression");
+            return NULL;
+        default:
+            // Ключевое слово на месте операнда — имя (x = value + 1)
+            if (parser_is_name_token(token.type)) return parser_parse_name(ts);
+            report_error("Unexpected '%.*s' in expression", (int)token.length, token.text ? token.text : "");
+            return NULL;
+    }
+}
+
+// IS [NOT] INITIAL / BOUND / ASSIGNED / SUPPLIED: текст узла — весь предикат
+static ASTNode *parser_parse_predicate(TokenStream *ts, ASTNode *left) {
+    token_stream_advance(ts); // IS
+    bool negated = token_stream_peek_type(ts) == TOKEN_OPERATOR_NOT;
+    if (negated) token_stream_advance(ts);
+
+    Token word = token_stream_peek(ts);
+    if (word.type != TOKEN_KEYWORD_INITIAL && word.type != TOKEN_IDENTIFIER) {
+        report_error("Expected INITIAL, BOUND, ASSIGNED or SUPPLIED after IS");
+        ast_node_free(left);
+        return NULL;
+    }
+    token_stream_advance(ts);
+
+    char text[64];
+    int length = snprintf(text, sizeof(text), "IS %s%.*s", negated ? "NOT " : "",
+                          (int)word.length, word.text);
+    if (length < 0 || (size_t)length >= sizeof(text)) length = (int)sizeof(text) - 1;
+    for (int i = 3; i < length; i++) text[i] = (char)toupper((unsigned char)text[i]);
+    return parser_operator_node(text, (size_t)length, left, NULL);
+}
+
+// [NOT] BETWEEN low AND high, [NOT] IN range: AND внутри BETWEEN не логическая связка
+static ASTNode *parser_parse_range(TokenStream *ts, ASTNode *left, TokenType type, bool negated) {
+    token_stream_advance(ts); // BETWEEN / IN
+    const char *text = type == TOKEN_KEYWORD_BETWEEN ? (negated ? "NOT BETWEEN" : "BETWEEN")
+                                                     : (negated ? "NOT IN" : "IN");
+    ASTNode *node = parser_operator_node(text, strlen(text), left, NULL);
+    if (!node) return NULL;
+
+    ASTNode *operand = parse_expression_prec(ts, PARSER_PREC_CONCAT);
+    if (!operand) {
+        ast_node_free(node);
+        return NULL;
+    }
+    ast_node_add_child(node, operand);
+    if (type != TOKEN_KEYWORD_BETWEEN) return node;
+
+    if (token_stream_peek_type(ts) != TOKEN_OPERATOR_AND) {
+        report_error("Expected AND in BETWEEN");
+        ast_node_free(node);
+        return NULL;
+    }
+    token_stream_advance(ts);
+    operand = parse_expression_prec(ts, PARSER_PREC_CONCAT);
+    if (!operand) {
+        ast_node_free(node);
+        return NULL;
+    }
+    ast_node_add_child(node, operand);
+    return node;
+}
+
+ASTNode *parse_expression_prec(TokenStream *ts, parser_precedence_t min_precedence) {
+    ASTNode *left = parser_parse_operand(ts);
+
+    while (left) {
+        TokenType type = token_stream_peek_type(ts);
+        bool negated = false;
+        if (type == TOKEN_OPERATOR_NOT) {
+            // NOT после операнда — только NOT BETWEEN и NOT IN
+            TokenType next = token_stream_peek_type_at(ts, 1);
+            if (next != TOKEN_KEYWORD_BETWEEN && next != TOKEN_KEYWORD_IN) break;
+            if (PARSER_PREC_COMPARISON < min_precedence) break;
+            token_stream_advance(ts);
+            type = next;
+            negated = true;
+        }
+
+        const parser_infix_rule_t *rule = &parser_infix_rules[type];
+        if (rule->precedence == PARSER_PREC_NONE || rule->precedence < min_precedence) break;
+
+        if (type == TOKEN_KEYWORD_IS) {
+            left = parser_parse_predicate(ts, left);
+        } else if (type == TOKEN_KEYWORD_BETWEEN || type == TOKEN_KEYWORD_IN) {
+            left = parser_parse_range(ts, left, type, negated);
+        } else {
+            token_stream_advance(ts);
+            ASTNode *right = parse_expression_prec(ts, (parser_precedence_t)rule->right);
+            if (!right) {
+                ast_node_free(left);
+                return NULL;
+            }
+            left = parser_operator_node(rule->text, strlen(rule->text), left, right);
+        }
+    }
+    return left;
+}
+
+ASTNode *parse_expression(TokenStream *ts) {
+    if (!ts) {
+        report_error("TokenStream is NULL in parse_expression");
+        return NULL;
+    }
+    return parse_expression_prec(ts, PARSER_PREC_NONE);
+}
@@ -33,7 +33,7 @@ ASTNode *parse_variable(TokenStream *ts) {
         return NULL;
     }
 
-    var_node->string_value = strdup(ident_token->text);
+    var_node->string_value = ast_token_strdup(ident_token);
     if (!var_node->string_value) {
         report_error("Failed to allocate memory for variable name");
         ast_node_free(var_node);
@@ -61,13 +61,7 @@ ASTNode *parse_variable(TokenStream *ts) {
             return NULL;
         }
 
-        field_node->string_value = strdup(token->text);
-        if (!field_node->string_value) {
-            report_error("Failed to allocate memory for field name");
-            ast_node_free(field_node);
-            ast_node_free(var_node);
-            return NULL;
-        }
+        field_node->atom = token_atom(token);
 
         // Добавляем поле как дочерний узел
         ast_node_add_child(var_node, field_node);
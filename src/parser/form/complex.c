@@ -2,14 +2,17 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
  * parse_complex_form - Парсит сложную форму (FORM ... ENDFORM) с параметрами.
  *
- * Обрабатывает объявление процедуры FORM с именем и параметрами,
- * тело которой парсится как последовательность операторов.
+ * FORM name [TABLES p ...] [USING [VALUE(]p[)] [TYPE|LIKE ...] ...] [CHANGING ...] [RAISING exc ...].
+ * Каждый параметр — узел AST_FORM_PARAMETER (atom — имя, string_value — TABLES, USING
+ * или CHANGING, потомки — спецификаторы типа), за параметрами идут операторы тела.
  *
  * Возвращает AST узел формы или NULL при ошибке.
  */
@@ -21,8 +24,8 @@ ASTNode *parse_complex_form(TokenStream *ts) {
     }
 
     // Ожидаем ключевое слово FORM уже прочитано, теперь имя процедуры
-    Token *name_token = token_stream_next(ts);
-    if (!name_token || name_token->type != TOKEN_IDENTIFIER) {
+    Token name_token = token_stream_next(ts);
+    if (name_token.type != TOKEN_IDENTIFIER) {
         report_error("Expected identifier as FORM name");
         return NULL;
     }
@@ -33,92 +36,63 @@ ASTNode *parse_complex_form(TokenStream *ts) {
         return NULL;
     }
 
-    form_node->string_value = strdup(name_token->text);
-    if (!form_node->string_value) {
-        report_error("Failed to allocate memory for FORM name");
-        ast_node_free(form_node);
-        return NULL;
-    }
-
-    // Парсим параметры после имени до точки
-    while (1) {
-        Token *next_token = token_stream_peek(ts);
-        if (!next_token) {
-            report_error("Unexpected end of tokens while parsing FORM parameters");
-            ast_node_free(form_node);
-            return NULL;
+    form_node->atom = token_atom(&name_token);
+
+    // Параметры после имени до точки
+    const char *kind = NULL;
+    for (;;) {
+        TokenType type = token_stream_peek_type(ts);
+        if (type == TOKEN_PUNCTUATION_DOT) break;
+        if (type == TOKEN_KEYWORD_TABLES || type == TOKEN_KEYWORD_USING || type == TOKEN_KEYWORD_CHANGING) {
+            kind = type == TOKEN_KEYWORD_TABLES ? "TABLES" : type == TOKEN_KEYWORD_USING ? "USING" : "CHANGING";
+            token_stream_advance(ts);
+            continue;
         }
-
-        if (next_token->type == TOKEN_DOT) {
-            token_stream_next(ts); // consume '.'
-            break;
+        if (type == TOKEN_KEYWORD_RAISING) {
+            // Классы исключений на раскладку параметров не влияют
+            token_stream_advance(ts);
+            while (token_stream_peek_type(ts) == TOKEN_IDENTIFIER) token_stream_advance(ts);
+            continue;
         }
-
-        // Парсим параметр (используем упрощенно: идентификатор TYPE идентификатор)
-        Token *param_name = token_stream_next(ts);
-        if (!param_name || param_name->type != TOKEN_IDENTIFIER) {
-            report_error("Expected parameter name in FORM");
-            ast_node_free(form_node);
-            return NULL;
+        if (!kind) {
+            report_error("Expected USING, CHANGING or TABLES in FORM");
+            return form_node;
         }
 
-        Token *using_token = token_stream_next(ts);
-        if (!using_token || (strcasecmp(using_token->text, "TYPE") != 0 && strcasecmp(using_token->text, "LIKE") != 0)) {
-            report_error("Expected TYPE or LIKE keyword in FORM parameter declaration");
-            ast_node_free(form_node);
-            return NULL;
-        }
-
-        Token *param_type = token_stream_next(ts);
-        if (!param_type || param_type->type != TOKEN_IDENTIFIER) {
-            report_error("Expected parameter type identifier in FORM");
-            ast_node_free(form_node);
-            return NULL;
-        }
+        atom_t name = parser_parse_parameter_name(ts);
+        if (name == ATOM_NONE) return form_node;
 
         // Создаем узел параметра
         ASTNode *param_node = ast_node_create(AST_FORM_PARAMETER);
-        if (!param_node) {
+        if (param_node) param_node->string_value = ast_strndup(kind, strlen(kind));
+        if (!param_node || !param_node->string_value) {
             report_error("Failed to allocate AST node for FORM parameter");
-            ast_node_free(form_node);
-            return NULL;
+            ast_node_free(param_node);
+            return form_node;
         }
-
-        param_node->string_value = strdup(param_name->text);
-        param_node->type_value = strdup(param_type->text); // type_value — дополнительное поле для типа, добавьте в структуру ASTNode
-
+        param_node->atom = name;
         ast_node_add_child(form_node, param_node);
-    }
-
-    // Парсим тело формы до ENDFORM
-    while (1) {
-        Token *next_token = token_stream_peek(ts);
-        if (!next_token) {
-            report_error("Unexpected end of tokens inside FORM");
-            ast_node_free(form_node);
-            return NULL;
-        }
 
-        if (next_token->type == TOKEN_ENDFORM) {
-            token_stream_next(ts); // consume ENDFORM
-            Token *end_dot = token_stream_next(ts);
-            if (!end_dot || end_dot->type != TOKEN_DOT) {
-                report_error("Expected '.' after ENDFORM");
-                ast_node_free(form_node);
-                return NULL;
+        if (!parser_parse_type_specs(ts, param_node)) return form_node;
+        // Устаревшее STRUCTURE s — типизация как LIKE s
+        if (parser_accept_word(ts, "STRUCTURE")) {
+            ASTNode *like = ast_node_create(AST_LIKE_SPEC);
+            if (!like || (like->atom = parse_name(ts)) == ATOM_NONE) {
+                report_error("Expected structure name after STRUCTURE");
+                ast_node_free(like);
+                return form_node;
             }
-            break;
+            ast_node_add_child(param_node, like);
         }
-
-        ASTNode *stmt = parse_statement(ts);
-        if (!stmt) {
-            report_error("Failed to parse statement inside FORM");
-            ast_node_free(form_node);
-            return NULL;
-        }
-
-        ast_node_add_child(form_node, stmt);
     }
+    token_stream_advance(ts); // '.'
 
+    // Тело формы до ENDFORM
+    static const TokenType ends[] = { TOKEN_KEYWORD_ENDFORM };
+    if (!parser_parse_block(ts, form_node, ends, 1, "ENDFORM")) return form_node;
+    token_stream_advance(ts); // ENDFORM
+    parser_end_statement(ts);
     return form_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_FORM, TOKEN_UNKNOWN, 1, parse_complex_form)
@@ -34,12 +34,7 @@ ASTNode *parse_simple_form(TokenStream *ts) {
         return NULL;
     }
 
-    form_node->string_value = strdup(name_token->text);
-    if (!form_node->string_value) {
-        report_error("Failed to allocate memory for FORM name");
-        ast_node_free(form_node);
-        return NULL;
-    }
+    form_node->atom = token_atom(name_token);
 
     // Ожидаем точку (конец объявления FORM)
     Token *dot_token = token_stream_next(ts);
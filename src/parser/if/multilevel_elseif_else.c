@@ -2,12 +2,17 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdio.h>
 #include <stdlib.h>
 
 /**
  * parse_if_multilevel - Парсит конструкцию IF с несколькими ELSEIF и ELSE.
  *
+ * Узел AST_IF: условие, операторы ветви IF, затем ветви AST_ELSEIF (условие и операторы)
+ * и не более одной AST_ELSE (операторы) в порядке записи.
+ *
  * Возвращает AST узел или NULL при ошибке.
  */
 ASTNode *parse_if_multilevel(TokenStream *ts) {
@@ -16,12 +21,7 @@ ASTNode *parse_if_multilevel(TokenStream *ts) {
         return NULL;
     }
 
-    Token *token = token_stream_peek(ts);
-    if (!token || token->type != TOKEN_KEYWORD_IF) {
-        report_error("Expected IF keyword");
-        return NULL;
-    }
-    token_stream_next(ts); // съесть IF
+    if (!parser_expect(ts, TOKEN_KEYWORD_IF, "IF keyword")) return NULL;
 
     ASTNode *if_node = ast_node_create(AST_IF);
     if (!if_node) {
@@ -32,162 +32,44 @@ ASTNode *parse_if_multilevel(TokenStream *ts) {
     ASTNode *condition = parse_expression(ts);
     if (!condition) {
         report_error("Failed to parse IF condition");
-        ast_node_free(if_node);
-        return NULL;
-    }
-
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_DOT) {
-        report_error("Expected '.' after IF condition");
-        ast_node_free(condition);
-        ast_node_free(if_node);
-        return NULL;
-    }
-
-    if_node->if_condition = condition;
-    if_node->if_body = ast_node_list_create();
-    if (!if_node->if_body) {
-        report_error("Failed to create ASTNodeList for IF body");
-        ast_node_free(if_node);
-        return NULL;
+        return if_node;
     }
-
-    while (1) {
-        token = token_stream_peek(ts);
-        if (!token) {
-            report_error("Unexpected end of input inside IF body");
-            ast_node_free(if_node);
-            return NULL;
+    ast_node_add_child(if_node, condition);
+    if (!parser_end_statement(ts)) return if_node;
+
+    static const TokenType ends[] = { TOKEN_KEYWORD_ELSEIF, TOKEN_KEYWORD_ELSE, TOKEN_KEYWORD_ENDIF };
+    ASTNode *branch = if_node;
+    for (;;) {
+        if (!parser_parse_block(ts, branch, ends, 3, "ENDIF")) return if_node;
+        TokenType type = token_stream_peek_type(ts);
+        if (type == TOKEN_KEYWORD_ENDIF) break;
+        if (branch->type == AST_ELSE) {
+            report_error("Expected ENDIF after ELSE branch");
+            return if_node;
         }
+        token_stream_advance(ts); // ELSEIF / ELSE
 
-        if (token->type == TOKEN_KEYWORD_ELSEIF) {
-            // Парсим ELSEIF
-            token_stream_next(ts); // съесть ELSEIF
-
-            ASTNode *elseif_node = ast_node_create(AST_ELSEIF);
-            if (!elseif_node) {
-                report_error("Failed to create AST ELSEIF node");
-                ast_node_free(if_node);
-                return NULL;
-            }
+        branch = ast_node_create(type == TOKEN_KEYWORD_ELSEIF ? AST_ELSEIF : AST_ELSE);
+        if (!branch) {
+            report_error("Failed to create AST node for IF branch");
+            return if_node;
+        }
+        ast_node_add_child(if_node, branch);
 
+        if (type == TOKEN_KEYWORD_ELSEIF) {
             ASTNode *elseif_cond = parse_expression(ts);
             if (!elseif_cond) {
                 report_error("Failed to parse ELSEIF condition");
-                ast_node_free(elseif_node);
-                ast_node_free(if_node);
-                return NULL;
-            }
-
-            token = token_stream_next(ts);
-            if (!token || token->type != TOKEN_DOT) {
-                report_error("Expected '.' after ELSEIF condition");
-                ast_node_free(elseif_node);
-                ast_node_free(if_node);
-                return NULL;
-            }
-
-            elseif_node->if_condition = elseif_cond;
-            elseif_node->if_body = ast_node_list_create();
-            if (!elseif_node->if_body) {
-                report_error("Failed to create ASTNodeList for ELSEIF body");
-                ast_node_free(elseif_node);
-                ast_node_free(if_node);
-                return NULL;
+                return if_node;
             }
-
-            // Парсим тело ELSEIF
-            while (1) {
-                token = token_stream_peek(ts);
-                if (!token) {
-                    report_error("Unexpected end of input inside ELSEIF body");
-                    ast_node_free(elseif_node);
-                    ast_node_free(if_node);
-                    return NULL;
-                }
-                if (token->type == TOKEN_KEYWORD_ELSEIF ||
-                    token->type == TOKEN_KEYWORD_ELSE ||
-                    token->type == TOKEN_KEYWORD_ENDIF) {
-                    break;
-                }
-
-                ASTNode *stmt = parse_statement(ts);
-                if (!stmt) {
-                    report_error("Failed to parse statement inside ELSEIF body");
-                    ast_node_free(elseif_node);
-                    ast_node_free(if_node);
-                    return NULL;
-                }
-                ast_node_list_append(elseif_node->if_body, stmt);
-            }
-
-            ast_node_list_append(if_node->elseif_list, elseif_node);
-
-        } else if (token->type == TOKEN_KEYWORD_ELSE) {
-            // Парсим ELSE
-            token_stream_next(ts); // съесть ELSE
-
-            token = token_stream_next(ts);
-            if (!token || token->type != TOKEN_DOT) {
-                report_error("Expected '.' after ELSE");
-                ast_node_free(if_node);
-                return NULL;
-            }
-
-            if_node->else_body = ast_node_list_create();
-            if (!if_node->else_body) {
-                report_error("Failed to create ASTNodeList for ELSE body");
-                ast_node_free(if_node);
-                return NULL;
-            }
-
-            // Парсим тело ELSE
-            while (1) {
-                token = token_stream_peek(ts);
-                if (!token) {
-                    report_error("Unexpected end of input inside ELSE body");
-                    ast_node_free(if_node);
-                    return NULL;
-                }
-                if (token->type == TOKEN_KEYWORD_ENDIF) {
-                    break;
-                }
-
-                ASTNode *stmt = parse_statement(ts);
-                if (!stmt) {
-                    report_error("Failed to parse statement inside ELSE body");
-                    ast_node_free(if_node);
-                    return NULL;
-                }
-                ast_node_list_append(if_node->else_body, stmt);
-            }
-
-        } else if (token->type == TOKEN_KEYWORD_ENDIF) {
-            break;
-        } else {
-            ASTNode *stmt = parse_statement(ts);
-            if (!stmt) {
-                report_error("Failed to parse statement inside IF body");
-                ast_node_free(if_node);
-                return NULL;
-            }
-            ast_node_list_append(if_node->if_body, stmt);
+            ast_node_add_child(branch, elseif_cond);
         }
+        if (!parser_end_statement(ts)) return if_node;
     }
 
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_ENDIF) {
-        report_error("Expected ENDIF keyword");
-        ast_node_free(if_node);
-        return NULL;
-    }
-
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_DOT) {
-        report_error("Expected '.' after ENDIF");
-        ast_node_free(if_node);
-        return NULL;
-    }
-
+    token_stream_advance(ts); // ENDIF
+    parser_end_statement(ts);
     return if_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_IF, TOKEN_UNKNOWN, 0, parse_if_multilevel)
@@ -0,0 +1,485 @@
+#include "../../include/parser_incremental.h"
+#include "../../include/parser_dispatch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file incremental.c
+ * @brief Переразбор наименьшего оператора или блока, содержащего правку.
+ *
+ * Таблица единиц строится по журналу parse_statement() (parser_statement_log_t),
+ * поэтому диапазоны вложенных операторов известны без участия модулей блоков.
+ * Узел единицы ищется в поддереве узла родительской единицы: модуль блока может
+ * складывать операторы тела не прямо в свой узел (ветви IF, обёртка AST_ERROR).
+ */
+
+#define PARSER_SIGNATURE_OFFSET 2166136261u
+#define PARSER_SIGNATURE_PRIME  16777619u
+
+// Переразбор после правки: курсор, журнал и сообщения нового разбора
+typedef struct {
+    TokenStream cursor;
+    parser_statement_log_t log;
+    diag_list_t diagnostics;
+    ast_arena_t *previous_arena;
+    diag_list_t *previous_diagnostics;
+    parser_statement_log_t *previous_log;
+} parser_reparse_t;
+
+// Слово, от которого зависит граница блока: открывает блок или закрывает/делит его
+static bool parser_is_block_keyword(TokenType type) {
+    switch (type) {
+        case TOKEN_KEYWORD_IF:
+        case TOKEN_KEYWORD_CASE:
+        case TOKEN_KEYWORD_DO:
+        case TOKEN_KEYWORD_WHILE:
+        case TOKEN_KEYWORD_LOOP:
+        case TOKEN_KEYWORD_TRY:
+        case TOKEN_KEYWORD_SELECT:
+            return true;
+        default:
+            return token_is_block_boundary(type);
+    }
+}
+
+// Хеш последовательности ключевых слов блоков в [start, end) — читается только массив типов
+static uint32_t parser_signature(const TokenStream *ts, int start, int end) {
+    uint32_t hash = PARSER_SIGNATURE_OFFSET;
+    for (int i = start; i < end; i++) {
+        TokenType type = token_stream_type_at(ts, i);
+        if (parser_is_block_keyword(type)) {
+            hash ^= (uint32_t)type;
+            hash *= PARSER_SIGNATURE_PRIME;
+        }
+    }
+    return hash;
+}
+
+static bool parser_reparse_begin(parser_document_t *doc, parser_reparse_t *reparse, int start) {
+    memset(reparse, 0, sizeof(*reparse));
+    if (!token_stream_cursor_init(&reparse->cursor, doc->ts, start)) return false;
+    reparse->previous_arena = ast_arena_activate(doc->arena);
+    reparse->previous_diagnostics = parser_diagnostics_activate(&reparse->diagnostics);
+    reparse->previous_log = parser_statement_log_activate(&reparse->log);
+    return true;
+}
+
+static void parser_reparse_end(parser_reparse_t *reparse) {
+    parser_statement_log_activate(reparse->previous_log);
+    parser_diagnostics_activate(reparse->previous_diagnostics);
+    ast_arena_activate(reparse->previous_arena);
+    token_stream_cursor_free(&reparse->cursor);
+    parser_statement_log_free(&reparse->log);
+    diag_list_free(&reparse->diagnostics);
+}
+
+/**
+ * @brief Единицы по записям журнала: размеры поддеревьев по вложенности, сигнатуры по токенам.
+ */
+static parser_unit_t *parser_units_from_log(const TokenStream *ts, const parser_statement_log_t *log, int diag_base) {
+    if (log->failed) return NULL;
+    size_t count = log->count ? (size_t)log->count : 1;
+    parser_unit_t *units = malloc(count * sizeof(parser_unit_t));
+    int *open = malloc(count * sizeof(int));
+    bool ok = units && open;
+
+    int depth = 0;
+    for (int i = 0; ok && i < log->count; i++) {
+        const parser_statement_record_t *record = &log->records[i];
+        while (depth > 0 && log->records[open[depth - 1]].depth >= record->depth) {
+            int k = open[--depth];
+            units[k].subtree = i - k;
+        }
+        units[i] = (parser_unit_t){
+            record->start, record->end, 1, record->node,
+            record->diag_first + diag_base, record->diag_end + diag_base,
+            parser_signature(ts, record->start, record->end), record->panic,
+        };
+        ok = record->node != NULL;
+        open[depth++] = i;
+    }
+    while (ok && depth > 0) {
+        int k = open[--depth];
+        units[k].subtree = log->count - k;
+    }
+
+    free(open);
+    if (!ok) {
+        free(units);
+        return NULL;
+    }
+    return units;
+}
+
+/**
+ * @brief Замена единиц [from, to) новыми; единицы за ними сдвигаются на delta токенов
+ *        и diag_delta сообщений.
+ */
+static bool parser_units_replace(parser_document_t *doc, int from, int to, const parser_unit_t *fresh,
+                                 int count, int delta, int diag_delta) {
+    int total = doc->unit_count - (to - from) + count;
+    if (total > doc->unit_capacity) {
+        int capacity = doc->unit_capacity ? doc->unit_capacity : 64;
+        while (capacity < total) capacity *= 2;
+        parser_unit_t *units = realloc(doc->units, (size_t)capacity * sizeof(parser_unit_t));
+        if (!units) return false;
+        doc->units = units;
+        doc->unit_capacity = capacity;
+    }
+    int tail = doc->unit_count - to;
+    if (tail > 0) memmove(doc->units + from + count, doc->units + to, (size_t)tail * sizeof(parser_unit_t));
+    if (count) memcpy(doc->units + from, fresh, (size_t)count * sizeof(parser_unit_t));
+    doc->unit_count = total;
+
+    for (int i = from + count; i < total; i++) {
+        parser_unit_t *unit = &doc->units[i];
+        unit->start += delta;
+        unit->end += delta;
+        unit->diag_first += diag_delta;
+        unit->diag_end += diag_delta;
+    }
+    return true;
+}
+
+/**
+ * @brief Замена токенов сообщений [from, to) токенами нового разбора (место резервируется заранее).
+ */
+static bool parser_diag_tokens_replace(parser_document_t *doc, int from, int to, const int *tokens, int count) {
+    int total = doc->diagnostics.count - (to - from) + count;
+    if (total > doc->diag_token_capacity) {
+        int capacity = doc->diag_token_capacity ? doc->diag_token_capacity : 16;
+        while (capacity < total) capacity *= 2;
+        int *grown = realloc(doc->diag_tokens, (size_t)capacity * sizeof(int));
+        if (!grown) return false;
+        doc->diag_tokens = grown;
+        doc->diag_token_capacity = capacity;
+    }
+    int tail = doc->diagnostics.count - to;
+    if (tail > 0) {
+        memmove(doc->diag_tokens + from + count, doc->diag_tokens + to, (size_t)tail * sizeof(int));
+    }
+    if (count) memcpy(doc->diag_tokens + from, tokens, (size_t)count * sizeof(int));
+    return true;
+}
+
+/**
+ * @brief Подстановка результата переразбора: единицы [from, to) и сообщения
+ *        [diag_from, diag_to) заменяются записанными в reparse.
+ */
+static bool parser_document_apply(parser_document_t *doc, parser_reparse_t *reparse, int from, int to,
+                                  int diag_from, int diag_to, int delta) {
+    int count = reparse->log.count;
+    int diag_count = reparse->diagnostics.count;
+    int diag_delta = diag_count - (diag_to - diag_from);
+    if (reparse->log.message_count != diag_count) return false;
+
+    parser_unit_t *fresh = parser_units_from_log(doc->ts, &reparse->log, diag_from);
+    bool ok = fresh &&
+              parser_diag_tokens_replace(doc, diag_from, diag_to, reparse->log.message_tokens, diag_count) &&
+              diag_list_replace(&doc->diagnostics, diag_from, diag_to - diag_from, &reparse->diagnostics);
+    if (ok) {
+        // Сообщения за правкой указывают на сдвинутые токены: строка и колонка пересчитываются
+        for (int i = diag_from + diag_count; i < doc->diagnostics.count; i++) {
+            if (doc->diag_tokens[i] < 0) continue;
+            doc->diag_tokens[i] += delta;
+            Token token = token_stream_token_at(doc->ts, doc->diag_tokens[i]);
+            doc->diagnostics.items[i].line = token.line;
+            doc->diagnostics.items[i].column = token.column;
+        }
+        ok = parser_units_replace(doc, from, to, fresh, count, delta, diag_delta);
+    }
+    free(fresh);
+    return ok;
+}
+
+/**
+ * @brief Поиск узла node в поддереве root: узел-владелец и номер потомка.
+ */
+static bool parser_find_slot(ASTNode *root, const ASTNode *node, ASTNode **container, int *slot) {
+    ASTNode *local[64];
+    ASTNode **stack = local;
+    size_t capacity = sizeof(local) / sizeof(local[0]);
+    size_t depth = 0;
+    bool found = false;
+
+    stack[depth++] = root;
+    while (depth > 0 && !found) {
+        ASTNode *current = stack[--depth];
+        for (int i = 0; i < current->child_count; i++) {
+            ASTNode *child = current->children[i];
+            if (child == node) {
+                *container = current;
+                *slot = i;
+                found = true;
+                break;
+            }
+            if (!child || !child->child_count) continue;
+            if (depth == capacity) {
+                ASTNode **grown = stack == local ? malloc(capacity * 2 * sizeof(ASTNode *))
+                                                 : realloc(stack, capacity * 2 * sizeof(ASTNode *));
+                if (!grown) break;
+                if (stack == local) memcpy(grown, local, sizeof(local));
+                stack = grown;
+                capacity *= 2;
+            }
+            stack[depth++] = child;
+        }
+    }
+
+    if (stack != local) free(stack);
+    return found;
+}
+
+/**
+ * @brief Полный разбор потока документа в новую арену.
+ */
+static bool parser_document_parse_all(parser_document_t *doc) {
+    doc->arena = ast_arena_create();
+    if (!doc->arena) return false;
+
+    parser_reparse_t reparse;
+    if (!parser_reparse_begin(doc, &reparse, 0)) return false;
+    parser_diagnostics_activate(&doc->diagnostics);
+
+    doc->program = ast_node_create(AST_PROGRAM);
+    bool ok = doc->program != NULL;
+    for (ASTNode *statement; ok && (statement = parse_statement(&reparse.cursor)); ) {
+        ast_node_add_child(doc->program, statement);
+    }
+    ok = ok && token_stream_peek_type(&reparse.cursor) == TOKEN_EOF;
+
+    if (ok) {
+        doc->units = parser_units_from_log(doc->ts, &reparse.log, 0);
+        ok = doc->units != NULL && reparse.log.message_count == doc->diagnostics.count;
+        doc->unit_count = doc->unit_capacity = reparse.log.count;
+        // Токены сообщений переходят документу
+        doc->diag_tokens = reparse.log.message_tokens;
+        doc->diag_token_capacity = reparse.log.message_capacity;
+        reparse.log.message_tokens = NULL;
+    }
+    doc->reparsed = 0;
+    parser_reparse_end(&reparse);
+    return ok;
+}
+
+bool parser_document_parse(parser_document_t *doc, TokenStream *ts) {
+    memset(doc, 0, sizeof(*doc));
+    doc->ts = ts;
+    if (!parser_document_parse_all(doc)) {
+        fprintf(stderr, "Out of memory while parsing document\n");
+        parser_document_free(doc);
+        return false;
+    }
+    return true;
+}
+
+void parser_document_free(parser_document_t *doc) {
+    if (doc->arena) ast_arena_destroy(doc->arena);
+    free(doc->units);
+    free(doc->diag_tokens);
+    diag_list_free(&doc->diagnostics);
+    memset(doc, 0, sizeof(*doc));
+}
+
+/**
+ * @brief Переразбор единицы path[level] на прежнем месте (top — номер оператора верхнего уровня path[0]).
+ *
+ * @return 1 — единица заменена, 0 — не подходит (нужна объемлющая), -1 — нехватка памяти.
+ */
+static int parser_reparse_unit(parser_document_t *doc, const int *path, int level, int top, int delta) {
+    parser_unit_t *unit = &doc->units[path[level]];
+    int start = unit->start;
+    int end = unit->end + delta;
+
+    // Оператор, начатый после ошибки блока, разбирается с подавленными сообщениями —
+    // отдельный разбор дал бы другой результат
+    if (unit->panic) return 0;
+
+    ASTNode *container = doc->program;
+    int slot = top;
+    if (level > 0 && !parser_find_slot(doc->units[path[level - 1]].node, unit->node, &container, &slot)) return 0;
+    // Новое или пропавшее слово блока меняет границы — решает объемлющая единица
+    if (parser_signature(doc->ts, start, end) != unit->signature) return 0;
+
+    parser_reparse_t reparse;
+    if (!parser_reparse_begin(doc, &reparse, start)) return -1;
+    ASTNode *statement = parse_statement(&reparse.cursor);
+    doc->reparsed += (size_t)(reparse.cursor.current_index - start);
+    if (!statement || reparse.log.failed || reparse.log.records[0].start != start ||
+        reparse.cursor.current_index != end) {
+        int result = !statement && token_stream_peek_type(&reparse.cursor) != TOKEN_EOF ? -1 : 0;
+        parser_reparse_end(&reparse);
+        return result;
+    }
+
+    int from = path[level];
+    int to = from + unit->subtree;
+    int diag_to = unit->diag_end;
+    int old_count = unit->subtree;
+    int new_count = reparse.log.count;
+    int diag_delta = reparse.diagnostics.count - (unit->diag_end - unit->diag_first);
+    bool ok = parser_document_apply(doc, &reparse, from, to, unit->diag_first, diag_to, delta);
+    parser_reparse_end(&reparse);
+    if (!ok) return -1;
+
+    container->children[slot] = statement;
+    for (int k = 0; k < level; k++) {
+        parser_unit_t *ancestor = &doc->units[path[k]];
+        ancestor->end += delta;
+        ancestor->subtree += new_count - old_count;
+        ancestor->diag_end += diag_delta;
+    }
+    return 1;
+}
+
+/**
+ * @brief Переразбор операторов верхнего уровня от последнего, начатого до правки,
+ *        до первого, чьё начало совпало со старым.
+ */
+static bool parser_reparse_run(parser_document_t *doc, int first, int last, int delta, parser_update_t *update) {
+    int from = 0, top_from = 0, start = 0;
+    for (int i = 0, top = 0; i < doc->unit_count && doc->units[i].start < first; i += doc->units[i].subtree, top++) {
+        from = i;
+        top_from = top;
+        start = doc->units[i].start;
+    }
+
+    parser_reparse_t reparse;
+    if (!parser_reparse_begin(doc, &reparse, start)) return false;
+    TokenStream *cursor = &reparse.cursor;
+
+    int to = from, top_to = top_from;
+    bool ok = true;
+    for (;;) {
+        while (token_stream_peek_type(cursor) == TOKEN_PUNCTUATION_DOT) token_stream_advance(cursor);
+        int position = cursor->current_index;
+        // Старые операторы внутри правки и уже пройденные не могут совпасть
+        while (to < doc->unit_count && (doc->units[to].start < last || doc->units[to].start + delta < position)) {
+            to += doc->units[to].subtree;
+            top_to++;
+        }
+        if (to < doc->unit_count && doc->units[to].start + delta == position) break;
+
+        ASTNode *statement = parse_statement(cursor);
+        if (!statement) {
+            ok = token_stream_peek_type(cursor) == TOKEN_EOF;
+            to = doc->unit_count;
+            top_to = doc->program->child_count;
+            break;
+        }
+    }
+    doc->reparsed += (size_t)(cursor->current_index - start);
+    ok = ok && !reparse.log.failed;
+
+    // Операторы верхнего уровня нового отрезка
+    int inserted = 0;
+    for (int i = 0; ok && i < reparse.log.count; i++) {
+        if (reparse.log.records[i].depth == 0) inserted++;
+    }
+    int diag_from = from < doc->unit_count ? doc->units[from].diag_first : doc->diagnostics.count;
+    int diag_to = to < doc->unit_count ? doc->units[to].diag_first : doc->diagnostics.count;
+
+    ASTNode **statements = NULL;
+    if (ok) {
+        statements = malloc((size_t)(inserted ? inserted : 1) * sizeof(ASTNode *));
+        ok = statements != NULL;
+        for (int i = 0, k = 0; ok && i < reparse.log.count; i++) {
+            if (reparse.log.records[i].depth == 0) statements[k++] = reparse.log.records[i].node;
+        }
+    }
+    ok = ok && parser_document_apply(doc, &reparse, from, to, diag_from, diag_to, delta);
+    parser_reparse_end(&reparse);
+
+    if (ok) {
+        int removed = top_to - top_from;
+        ASTNode *program = doc->program;
+        if (inserted == removed) {
+            if (inserted) memcpy(program->children + top_from, statements, (size_t)inserted * sizeof(ASTNode *));
+        } else {
+            // Число потомков изменилось: новый узел программы с тем же порядком операторов
+            ast_arena_t *previous = ast_arena_activate(doc->arena);
+            ASTNode *rebuilt = ast_node_create(AST_PROGRAM);
+            ast_arena_activate(previous);
+            ok = rebuilt != NULL;
+            for (int i = 0; ok && i < top_from; i++) ast_node_add_child(rebuilt, program->children[i]);
+            for (int i = 0; ok && i < inserted; i++) ast_node_add_child(rebuilt, statements[i]);
+            for (int i = top_to; ok && i < program->child_count; i++) ast_node_add_child(rebuilt, program->children[i]);
+            if (ok) doc->program = rebuilt;
+        }
+        *update = (parser_update_t){ top_from, removed, inserted, 0, false };
+    }
+    free(statements);
+    return ok;
+}
+
+/**
+ * @brief Обновление после замены токенов: наименьшая подходящая единица, затем отрезок
+ *        верхнего уровня, при накоплении мусора — полный разбор.
+ */
+bool parser_document_update(parser_document_t *doc, const lexer_relex_result_t *relex, parser_update_t *update) {
+    parser_update_t local;
+    if (!update) update = &local;
+    *update = (parser_update_t){ 0 };
+
+    int first = relex->first;
+    int last = relex->first + relex->removed;
+    int delta = relex->inserted - relex->removed;
+    size_t reparsed = doc->reparsed;
+    // Токен за заменой тоже считается изменённым: правка могла перенести его на другую
+    // строку, а синхронизация после ошибки сравнивает строки соседних токенов
+    int touched = last + 1;
+
+    // Старые узлы остаются в арене: когда их набралось на целое дерево, арена заменяется
+    if (doc->reparsed <= (size_t)doc->ts->token_count) {
+        // Путь от оператора верхнего уровня к наименьшей единице, содержащей замену
+        int *path = NULL;
+        int depth = 0, capacity = 0, top = 0;
+        bool ok = true;
+        for (int i = 0, end = doc->unit_count; ok && i < end; ) {
+            const parser_unit_t *unit = &doc->units[i];
+            if (unit->start < first && touched <= unit->end) {
+                if (depth == capacity) {
+                    capacity = capacity ? capacity * 2 : 16;
+                    int *grown = realloc(path, (size_t)capacity * sizeof(int));
+                    ok = grown != NULL;
+                    if (!grown) break;
+                    path = grown;
+                }
+                if (depth == 0) update->first = top;
+                path[depth++] = i;
+                end = i + unit->subtree;
+                i++;
+            } else {
+                if (depth == 0) top++;
+                i += unit->subtree;
+            }
+        }
+
+        int result = 0;
+        for (int level = depth - 1; ok && level >= 0 && result == 0; level--) {
+            result = parser_reparse_unit(doc, path, level, update->first, delta);
+        }
+        free(path);
+        if (!ok || result < 0) return false;
+
+        if (result > 0) {
+            update->removed = update->inserted = 1;
+        } else if (!parser_reparse_run(doc, first, last, delta, update)) {
+            return false;
+        }
+        update->reparsed = (int)(doc->reparsed - reparsed);
+        return true;
+    }
+
+    parser_document_t fresh = { .ts = doc->ts };
+    fresh.diagnostics.max_errors = doc->diagnostics.max_errors;
+    if (!parser_document_parse_all(&fresh)) {
+        parser_document_free(&fresh);
+        return false;
+    }
+    *update = (parser_update_t){ 0, doc->program->child_count, fresh.program->child_count, doc->ts->token_count, true };
+    parser_document_free(doc);
+    *doc = fresh;
+    return true;
+}
@@ -2,16 +2,20 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 
 /**
  * parse_do_loop - Парсит цикл DO ... ENDDO.
  *
  * Ожидается конструкция:
- * DO.
+ * DO [n TIMES].
  *   ... тело цикла ...
  * ENDDO.
  *
+ * Первый потомок узла AST_DO — число повторов, если есть TIMES, затем операторы тела.
+ *
  * Возвращает AST узел цикла или NULL при ошибке.
  */
 ASTNode *parse_do_loop(TokenStream *ts) {
@@ -20,50 +24,30 @@ ASTNode *parse_do_loop(TokenStream *ts) {
         return NULL;
     }
 
-    Token *token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_DO) {
-        report_error("Expected 'DO' keyword");
-        return NULL;
-    }
-
-    Token *dot_token = token_stream_next(ts);
-    if (!dot_token || dot_token->type != TOKEN_DOT) {
-        report_error("Expected '.' after 'DO'");
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_DO, "'DO' keyword")) return NULL;
 
-    ASTNode *do_node = ast_node_create(AST_DO_LOOP);
+    ASTNode *do_node = ast_node_create(AST_DO);
     if (!do_node) {
         report_error("Failed to allocate AST node for DO loop");
         return NULL;
     }
 
-    ASTNodeList *body_statements = ast_node_list_create();
-    if (!body_statements) {
-        report_error("Failed to allocate AST node list for DO loop body");
-        ast_node_free(do_node);
-        return NULL;
-    }
-
-    Token *next_token;
-    while ((next_token = token_stream_peek(ts)) != NULL) {
-        if (next_token->type == TOKEN_KEYWORD_ENDDO) {
-            token_stream_next(ts); // consume ENDDO
-            Token *end_dot = token_stream_next(ts);
-            if (!end_dot || end_dot->type != TOKEN_DOT) {
-                report_error("Expected '.' after 'ENDDO'");
-                ast_node_list_free(body_statements);
-                ast_node_free(do_node);
-                return NULL;
-            }
-            break;
+    if (token_stream_peek_type(ts) != TOKEN_PUNCTUATION_DOT) {
+        ASTNode *times = parse_expression(ts);
+        if (!times) return do_node;
+        ast_node_add_child(do_node, times);
+        if (!parser_accept_word(ts, "TIMES")) {
+            report_error("Expected TIMES after DO count");
+            return do_node;
         }
-
-        // Пропускаем тело, можно добавить парсинг инструкций
-        token_stream_next(ts);
     }
+    if (!parser_end_statement(ts)) return do_node;
 
-    do_node->body = body_statements;
-
+    static const TokenType ends[] = { TOKEN_KEYWORD_ENDDO };
+    if (!parser_parse_block(ts, do_node, ends, 1, "ENDDO")) return do_node;
+    token_stream_advance(ts); // ENDDO
+    parser_end_statement(ts);
     return do_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_DO, TOKEN_UNKNOWN, 0, parse_do_loop)
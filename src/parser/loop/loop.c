@@ -2,16 +2,22 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 
 /**
  * parse_loop - Парсит цикл LOOP ... ENDLOOP.
  *
  * Ожидается конструкция:
- * LOOP.
+ * LOOP AT itab [INTO wa | ASSIGNING <fs> | REFERENCE INTO dref | TRANSPORTING NO FIELDS]
+ *              [FROM n] [TO n] [WHERE условие].
  *   ... тело цикла ...
  * ENDLOOP.
  *
+ * atom узла AST_LOOP — таблица; дополнения — узлы AST_STATEMENT_CLAUSE, за ними
+ * операторы тела. LOOP без AT (цикл по экрану) даёт узел без таблицы.
+ *
  * Возвращает AST узел цикла или NULL при ошибке.
  */
 ASTNode *parse_loop(TokenStream *ts) {
@@ -20,17 +26,7 @@ ASTNode *parse_loop(TokenStream *ts) {
         return NULL;
     }
 
-    Token *token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_LOOP) {
-        report_error("Expected 'LOOP' keyword");
-        return NULL;
-    }
-
-    Token *dot_token = token_stream_next(ts);
-    if (!dot_token || dot_token->type != TOKEN_DOT) {
-        report_error("Expected '.' after 'LOOP'");
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_LOOP, "'LOOP' keyword")) return NULL;
 
     ASTNode *loop_node = ast_node_create(AST_LOOP);
     if (!loop_node) {
@@ -38,33 +34,45 @@ ASTNode *parse_loop(TokenStream *ts) {
         return NULL;
     }
 
-    // Создаем список операторов тела цикла
-    ASTNodeList *body_statements = ast_node_list_create();
-    if (!body_statements) {
-        report_error("Failed to allocate AST node list for loop body");
-        ast_node_free(loop_node);
-        return NULL;
+    if (parser_accept_word(ts, "AT")) {
+        if ((loop_node->atom = parse_name(ts)) == ATOM_NONE) {
+            report_error("Expected internal table after LOOP AT");
+            return loop_node;
+        }
     }
 
-    Token *next_token;
-    while ((next_token = token_stream_peek(ts)) != NULL) {
-        if (next_token->type == TOKEN_KEYWORD_ENDLOOP) {
-            token_stream_next(ts); // consume ENDLOOP
-            Token *end_dot = token_stream_next(ts);
-            if (!end_dot || end_dot->type != TOKEN_DOT) {
-                report_error("Expected '.' after 'ENDLOOP'");
-                ast_node_list_free(body_statements);
-                ast_node_free(loop_node);
-                return NULL;
-            }
-            break;
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF; ) {
+        bool parsed;
+        if (parser_accept(ts, TOKEN_KEYWORD_INTO)) {
+            parsed = parser_parse_clause(ts, loop_node, "INTO");
+        } else if (parser_accept_word(ts, "ASSIGNING")) {
+            parsed = parser_parse_clause(ts, loop_node, "ASSIGNING");
+        } else if (parser_accept_word(ts, "REFERENCE")) {
+            parsed = parser_expect(ts, TOKEN_KEYWORD_INTO, "INTO after REFERENCE") &&
+                     parser_parse_clause(ts, loop_node, "REFERENCE INTO");
+        } else if (parser_accept_word(ts, "TRANSPORTING")) {
+            // TRANSPORTING NO FIELDS: рабочей области нет
+            while (parser_accept_word(ts, "NO") || parser_accept_word(ts, "FIELDS")) {}
+            parsed = parser_add_clause(loop_node, "TRANSPORTING NO FIELDS") != NULL;
+        } else if (parser_accept(ts, TOKEN_KEYWORD_FROM)) {
+            parsed = parser_parse_clause(ts, loop_node, "FROM");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_TO)) {
+            parsed = parser_parse_clause(ts, loop_node, "TO");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_WHERE)) {
+            parsed = parser_parse_clause(ts, loop_node, "WHERE");
+        } else {
+            report_error("Unexpected token in LOOP statement");
+            parsed = false;
         }
-
-        // Для упрощения - пропускаем тело, можно добавить реальный парсинг
-        token_stream_next(ts);
+        if (!parsed) return loop_node;
     }
+    if (!parser_end_statement(ts)) return loop_node;
 
-    loop_node->body = body_statements;
-
+    static const TokenType ends[] = { TOKEN_KEYWORD_ENDLOOP };
+    if (!parser_parse_block(ts, loop_node, ends, 1, "ENDLOOP")) return loop_node;
+    token_stream_advance(ts); // ENDLOOP
+    parser_end_statement(ts);
     return loop_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_LOOP, TOKEN_UNKNOWN, 0, parse_loop)
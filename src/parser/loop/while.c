@@ -2,6 +2,8 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 
 /**
@@ -12,6 +14,8 @@
  *   ... тело цикла ...
  * ENDWHILE.
  *
+ * Первый потомок узла AST_WHILE — условие, затем операторы тела.
+ *
  * Возвращает AST узел цикла или NULL при ошибке.
  */
 ASTNode *parse_while_loop(TokenStream *ts) {
@@ -20,61 +24,27 @@ ASTNode *parse_while_loop(TokenStream *ts) {
         return NULL;
     }
 
-    Token *token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_WHILE) {
-        report_error("Expected 'WHILE' keyword");
-        return NULL;
-    }
-
-    // Парсим условие (упрощенно — считаем, что условие — один токен или выражение)
-    ASTNode *condition = parse_expression(ts);
-    if (!condition) {
-        report_error("Failed to parse condition in WHILE loop");
-        return NULL;
-    }
-
-    Token *dot_token = token_stream_next(ts);
-    if (!dot_token || dot_token->type != TOKEN_DOT) {
-        report_error("Expected '.' after WHILE condition");
-        ast_node_free(condition);
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_WHILE, "'WHILE' keyword")) return NULL;
 
-    ASTNode *while_node = ast_node_create(AST_WHILE_LOOP);
+    ASTNode *while_node = ast_node_create(AST_WHILE);
     if (!while_node) {
         report_error("Failed to allocate AST node for WHILE loop");
-        ast_node_free(condition);
-        return NULL;
-    }
-
-    while_node->condition = condition;
-
-    ASTNodeList *body_statements = ast_node_list_create();
-    if (!body_statements) {
-        report_error("Failed to allocate AST node list for WHILE loop body");
-        ast_node_free(while_node);
         return NULL;
     }
 
-    Token *next_token;
-    while ((next_token = token_stream_peek(ts)) != NULL) {
-        if (next_token->type == TOKEN_KEYWORD_ENDWHILE) {
-            token_stream_next(ts); // consume ENDWHILE
-            Token *end_dot = token_stream_next(ts);
-            if (!end_dot || end_dot->type != TOKEN_DOT) {
-                report_error("Expected '.' after 'ENDWHILE'");
-                ast_node_list_free(body_statements);
-                ast_node_free(while_node);
-                return NULL;
-            }
-            break;
-        }
-
-        // Пропускаем тело, можно добавить парсинг инструкций
-        token_stream_next(ts);
+    ASTNode *condition = parse_expression(ts);
+    if (!condition) {
+        report_error("Failed to parse condition in WHILE loop");
+        return while_node;
     }
+    ast_node_add_child(while_node, condition);
+    if (!parser_end_statement(ts)) return while_node;
 
-    while_node->body = body_statements;
-
+    static const TokenType ends[] = { TOKEN_KEYWORD_ENDWHILE };
+    if (!parser_parse_block(ts, while_node, ends, 1, "ENDWHILE")) return while_node;
+    token_stream_advance(ts); // ENDWHILE
+    parser_end_statement(ts);
     return while_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_WHILE, TOKEN_UNKNOWN, 0, parse_while_loop)
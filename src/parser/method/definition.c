@@ -39,7 +39,7 @@ ASTNode *parse_method_definition(TokenStream *ts) {
         return NULL;
     }
 
-    method_node->method_name = strdup(token->text);
+    method_node->method_name = token_strdup(token);
     if (!method_node->method_name) {
         report_error("Failed to allocate memory for method name");
         ast_node_free(method_node);
@@ -2,6 +2,8 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -13,6 +15,8 @@
  *   ... тело метода ...
  * ENDMETHOD.
  *
+ * Имя может быть составным (intf~meth). Операторы тела — потомки узла.
+ *
  * Возвращает AST узел с телом метода или NULL при ошибке.
  */
 ASTNode *parse_method_implementation(TokenStream *ts) {
@@ -21,14 +25,10 @@ ASTNode *parse_method_implementation(TokenStream *ts) {
         return NULL;
     }
 
-    Token *token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_METHOD) {
-        report_error("Expected 'METHOD' keyword to start method implementation");
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_METHOD, "'METHOD' keyword to start method implementation")) return NULL;
 
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_IDENTIFIER) {
+    atom_t name = parse_name(ts);
+    if (name == ATOM_NONE) {
         report_error("Expected method name after 'METHOD'");
         return NULL;
     }
@@ -39,41 +39,15 @@ ASTNode *parse_method_implementation(TokenStream *ts) {
         return NULL;
     }
 
-    method_impl_node->method_name = strdup(token->text);
-    if (!method_impl_node->method_name) {
-        report_error("Failed to allocate memory for method name");
-        ast_node_free(method_impl_node);
-        return NULL;
-    }
-
-    // Парсим тело метода до ENDMETHOD.
-    ASTNodeList *body_statements = ast_node_list_create();
-    if (!body_statements) {
-        report_error("Failed to allocate AST node list for method body");
-        ast_node_free(method_impl_node);
-        return NULL;
-    }
-
-    Token *next_token;
-    while ((next_token = token_stream_peek(ts)) != NULL) {
-        if (next_token->type == TOKEN_KEYWORD_ENDMETHOD) {
-            token_stream_next(ts); // consume ENDMETHOD
-            Token *dot_token = token_stream_next(ts);
-            if (!dot_token || dot_token->type != TOKEN_DOT) {
-                report_error("Expected '.' after ENDMETHOD");
-                ast_node_list_free(body_statements);
-                ast_node_free(method_impl_node);
-                return NULL;
-            }
-            break;
-        }
-
-        // Здесь можно вызвать функции парсинга инструкций тела
-        // Для упрощения просто пропускаем токены тела
-        token_stream_next(ts);
-    }
-
-    method_impl_node->body = body_statements;
+    method_impl_node->atom = name;
+    if (!parser_end_statement(ts)) return method_impl_node;
 
+    // Тело метода до ENDMETHOD
+    static const TokenType ends[] = { TOKEN_KEYWORD_ENDMETHOD };
+    if (!parser_parse_block(ts, method_impl_node, ends, 1, "ENDMETHOD")) return method_impl_node;
+    token_stream_advance(ts); // ENDMETHOD
+    parser_end_statement(ts);
     return method_impl_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_METHOD, TOKEN_UNKNOWN, 0, parse_method_implementation)
@@ -44,13 +44,7 @@ ASTNode *parse_chain_and_field_access(TokenStream *ts) {
         return NULL;
     }
 
-    current->string_value = strdup(token->text);
-    if (!current->string_value) {
-        report_error("Failed to allocate memory for identifier string");
-        ast_node_free(root);
-        ast_node_free(current);
-        return NULL;
-    }
+    current->atom = token_atom(token);
 
     ast_node_add_child(root, current);
 
@@ -76,13 +70,7 @@ ASTNode *parse_chain_and_field_access(TokenStream *ts) {
                 return NULL;
             }
 
-            method_node->string_value = strdup(method_token->text);
-            if (!method_node->string_value) {
-                report_error("Failed to allocate memory for method name");
-                ast_node_free(root);
-                ast_node_free(method_node);
-                return NULL;
-            }
+            method_node->atom = token_atom(method_token);
 
             // Ожидается '(' для вызова метода
             Token *open_paren = token_stream_next(ts);
@@ -126,13 +114,7 @@ ASTNode *parse_chain_and_field_access(TokenStream *ts) {
                 return NULL;
             }
 
-            field_node->string_value = strdup(field_token->text);
-            if (!field_node->string_value) {
-                report_error("Failed to allocate memory for field name");
-                ast_node_free(root);
-                ast_node_free(field_node);
-                return NULL;
-            }
+            field_node->atom = token_atom(field_token);
 
             ast_node_add_child(root, field_node);
             continue;
@@ -2,14 +2,15 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
- * parse_complex_module - Парсит сложный модуль с параметрами и локальными объявлениями.
+ * parse_complex_module - Парсит модуль диалога MODULE ... ENDMODULE.
  *
- * Обрабатывает модуль с возможными параметрами, локальными переменными,
- * событиями и завершается ключевым словом ENDMODULE с точкой.
+ * MODULE name [OUTPUT | INPUT]. Слово OUTPUT/INPUT сохраняется в string_value,
+ * операторы тела — потомки узла.
  *
  * Возвращает AST узел модуля или NULL при ошибке.
  */
@@ -21,8 +22,8 @@ ASTNode *parse_complex_module(TokenStream *ts) {
     }
 
     // Ожидается ключевое слово MODULE уже прочитано, теперь имя модуля
-    Token *name_token = token_stream_next(ts);
-    if (!name_token || name_token->type != TOKEN_IDENTIFIER) {
+    Token name_token = token_stream_next(ts);
+    if (name_token.type != TOKEN_IDENTIFIER) {
         report_error("Expected identifier as MODULE name");
         return NULL;
     }
@@ -33,64 +34,22 @@ ASTNode *parse_complex_module(TokenStream *ts) {
         return NULL;
     }
 
-    module_node->string_value = strdup(name_token->text);
-    if (!module_node->string_value) {
-        report_error("Failed to allocate memory for MODULE name");
-        ast_node_free(module_node);
-        return NULL;
-    }
-
-    // Опционально: парсим параметры и локальные объявления до точки
-    while (1) {
-        Token *peek = token_stream_peek(ts);
-        if (!peek) {
-            report_error("Unexpected end of tokens while parsing MODULE header");
-            ast_node_free(module_node);
-            return NULL;
-        }
+    module_node->atom = token_atom(&name_token);
 
-        if (peek->type == TOKEN_DOT) {
-            token_stream_next(ts); // consume '.'
-            break;
-        }
-
-        // Здесь можно добавить логику парсинга параметров или объявлений
-        // Пока пропустим этот функционал или добавим как TODO
-        // Для простоты — выдаем ошибку, если что-то кроме точки встречается
-        report_error("Unexpected token in MODULE header, expected '.'");
-        ast_node_free(module_node);
-        return NULL;
-    }
-
-    // Парсим тело модуля до ENDMODULE
-    while (1) {
-        Token *next_token = token_stream_peek(ts);
-        if (!next_token) {
-            report_error("Unexpected end of tokens inside MODULE");
-            ast_node_free(module_node);
-            return NULL;
-        }
-
-        if (next_token->type == TOKEN_ENDMODULE) {
-            token_stream_next(ts); // consume ENDMODULE
-            Token *end_dot = token_stream_next(ts);
-            if (!end_dot || end_dot->type != TOKEN_DOT) {
-                report_error("Expected '.' after ENDMODULE");
-                ast_node_free(module_node);
-                return NULL;
-            }
-            break;
-        }
-
-        ASTNode *stmt = parse_statement(ts);
-        if (!stmt) {
-            report_error("Failed to parse statement inside MODULE");
-            ast_node_free(module_node);
-            return NULL;
-        }
-
-        ast_node_add_child(module_node, stmt);
+    const char *event = parser_accept_word(ts, "OUTPUT") ? "OUTPUT"
+                      : parser_accept_word(ts, "INPUT") ? "INPUT" : NULL;
+    if (event && !(module_node->string_value = ast_strndup(event, strlen(event)))) {
+        report_error("Failed to allocate MODULE event");
+        return module_node;
     }
+    if (!parser_end_statement(ts)) return module_node;
 
+    // Тело модуля до ENDMODULE
+    static const TokenType ends[] = { TOKEN_KEYWORD_ENDMODULE };
+    if (!parser_parse_block(ts, module_node, ends, 1, "ENDMODULE")) return module_node;
+    token_stream_advance(ts); // ENDMODULE
+    parser_end_statement(ts);
     return module_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_MODULE, TOKEN_UNKNOWN, 1, parse_complex_module)
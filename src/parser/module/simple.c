@@ -34,12 +34,7 @@ ASTNode *parse_simple_module(TokenStream *ts) {
         return NULL;
     }
 
-    module_node->string_value = strdup(name_token->text);
-    if (!module_node->string_value) {
-        report_error("Failed to allocate memory for MODULE name");
-        ast_node_free(module_node);
-        return NULL;
-    }
+    module_node->atom = token_atom(name_token);
 
     // Ожидаем точку (конец объявления MODULE)
     Token *dot_token = token_stream_next(ts);
@@ -0,0 +1,270 @@
+#include "../../include/parser_parallel.h"
+#include "../../include/parser_dispatch.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @file parallel.c
+ * @brief Поиск границ блоков по массиву типов и разбор участков на пуле потоков.
+ *
+ * Задача разбирает свой участок курсором над общим потоком и складывает операторы
+ * в узел-контейнер в арене своего потока. После того как все задачи готовы,
+ * вызывающий поток переносит операторы контейнеров в узел программы по порядку
+ * участков — поэтому дерево не зависит от того, какой поток какой участок разобрал.
+ *
+ * Границы участков найдены по началам операторов, а не разбором, поэтому оператор
+ * участка может их не заметить: незакрытый IF в коде между блоками дочитывает
+ * операторы до ENDIF в следующих участках. Такой участок заканчивается за своей
+ * границей; тогда его разбор и всё, что после него, повторяются последовательно
+ * одним участком до конца потока — дерево совпадает с разбором без пула.
+ */
+
+#define PARSER_SKELETON_INITIAL_CAPACITY 64
+
+// Состояние участка во второй фазе
+typedef struct {
+    ASTNode *statements;    // Контейнер операторов участка (в арене потока)
+    uint32_t *offsets;      // Смещения операторов участка (parser_offsets_push())
+    diag_list_t diagnostics;
+    int stop;               // Индекс токена, на котором закончился разбор
+    bool ok;
+} parser_segment_state_t;
+
+// Задача второй фазы; задачи раздаются по убыванию размера участка, чтобы самый
+// длинный блок не достался потоку последним
+typedef struct {
+    int size;
+    int segment;
+} parser_task_t;
+
+typedef struct {
+    TokenStream *ts;
+    const parser_skeleton_t *skeleton;
+    const parser_task_t *tasks;
+    parser_segment_state_t *states;
+    ast_arena_t **arenas;
+} parser_parallel_job_t;
+
+// Слово, закрывающее блок, или TOKEN_UNKNOWN, если kind не открывает блок
+static TokenType parser_block_end(TokenType kind) {
+    switch (kind) {
+        case TOKEN_KEYWORD_FORM:   return TOKEN_KEYWORD_ENDFORM;
+        case TOKEN_KEYWORD_METHOD: return TOKEN_KEYWORD_ENDMETHOD;
+        case TOKEN_KEYWORD_MODULE: return TOKEN_KEYWORD_ENDMODULE;
+        default:                   return TOKEN_UNKNOWN;
+    }
+}
+
+static bool parser_skeleton_push(parser_skeleton_t *skeleton, int start, int end, TokenType kind) {
+    if (start >= end) return true;
+    if (skeleton->count == skeleton->capacity) {
+        int capacity = skeleton->capacity ? skeleton->capacity * 2 : PARSER_SKELETON_INITIAL_CAPACITY;
+        parser_segment_t *segments = realloc(skeleton->segments, (size_t)capacity * sizeof(parser_segment_t));
+        if (!segments) return false;
+        skeleton->segments = segments;
+        skeleton->capacity = capacity;
+    }
+    skeleton->segments[skeleton->count++] = (parser_segment_t){ start, end, kind };
+    if (kind != TOKEN_UNKNOWN) skeleton->blocks++;
+    return true;
+}
+
+/**
+ * @brief Первая фаза: блоки ищутся по началам операторов, читается только массив типов.
+ */
+bool parser_skeleton_scan(const TokenStream *ts, parser_skeleton_t *skeleton) {
+    skeleton->count = 0;
+    skeleton->blocks = 0;
+
+    int gap_start = 0;
+    int block_start = -1;
+    TokenType open = TOKEN_UNKNOWN;     // Тип открытого блока
+    TokenType close = TOKEN_UNKNOWN;    // Ожидаемое END-слово
+    bool statement_start = true;
+    bool closing = false;               // Прочитано END-слово, ждём точку
+
+    int i = 0;
+    for (TokenType type; (type = token_stream_type_at(ts, i)) != TOKEN_EOF; i++) {
+        if (type == TOKEN_PUNCTUATION_DOT) {
+            if (closing) {
+                if (!parser_skeleton_push(skeleton, gap_start, block_start, TOKEN_UNKNOWN) ||
+                    !parser_skeleton_push(skeleton, block_start, i + 1, open)) {
+                    return false;
+                }
+                gap_start = i + 1;
+                open = close = TOKEN_UNKNOWN;
+                closing = false;
+            }
+            statement_start = true;
+            continue;
+        }
+
+        if (statement_start) {
+            if (open == TOKEN_UNKNOWN) {
+                close = parser_block_end(type);
+                if (close != TOKEN_UNKNOWN) {
+                    open = type;
+                    block_start = i;
+                }
+            } else if (type == close) {
+                closing = true;
+            }
+        }
+        statement_start = false;
+    }
+
+    // Незакрытый блок остаётся в коде за последним блоком
+    return parser_skeleton_push(skeleton, gap_start, i, TOKEN_UNKNOWN);
+}
+
+void parser_skeleton_free(parser_skeleton_t *skeleton) {
+    free(skeleton->segments);
+    skeleton->segments = NULL;
+    skeleton->count = skeleton->capacity = skeleton->blocks = 0;
+}
+
+// Разбор одного участка: операторы подряд до его конца
+static void parser_parse_segment(void *arg, size_t index, int worker) {
+    parser_parallel_job_t *job = (parser_parallel_job_t *)arg;
+    int segment_index = job->tasks[index].segment;
+    const parser_segment_t *segment = &job->skeleton->segments[segment_index];
+    parser_segment_state_t *state = &job->states[segment_index];
+
+    TokenStream cursor;
+    if (!token_stream_cursor_init(&cursor, job->ts, segment->start)) return;
+
+    ast_arena_t *previous = ast_arena_activate(job->arenas[worker]);
+    diag_list_t *previous_diagnostics = parser_diagnostics_activate(&state->diagnostics);
+    state->statements = ast_node_create(AST_PROGRAM);
+    state->ok = state->statements != NULL;
+
+    // Ошибочные операторы приходят узлами AST_ERROR: parse_statement() восстанавливается сам
+    while (state->ok && cursor.current_index < segment->end) {
+        uint32_t offset = parser_statement_offset(&cursor);
+        ASTNode *statement = parse_statement(&cursor);
+        if (!statement) {
+            state->ok = token_stream_peek_type(&cursor) == TOKEN_EOF;
+            break;
+        }
+        parser_offsets_push(&state->offsets, state->statements->child_count, offset);
+        ast_node_add_child(state->statements, statement);
+    }
+    state->stop = cursor.current_index;
+
+    parser_diagnostics_activate(previous_diagnostics);
+    ast_arena_activate(previous);
+    token_stream_cursor_free(&cursor);
+}
+
+// Крупные участки первыми, при равенстве — в исходном порядке
+static int parser_compare_tasks(const void *a, const void *b) {
+    const parser_task_t *x = a, *y = b;
+    if (x->size != y->size) return x->size < y->size ? 1 : -1;
+    return x->segment - y->segment;
+}
+
+/**
+ * @brief Вторая фаза: участки на пуле, сборка операторов в узел программы.
+ */
+bool parser_parse_parallel(TokenStream *ts, thread_pool_t *pool, parser_parallel_result_t *result) {
+    *result = (parser_parallel_result_t){ 0 };
+
+    parser_skeleton_t skeleton = { 0 };
+    if (!parser_skeleton_scan(ts, &skeleton)) {
+        parser_skeleton_free(&skeleton);
+        fprintf(stderr, "Out of memory while scanning program blocks\n");
+        return false;
+    }
+
+    // Без пула или без хотя бы двух блоков параллелить нечего
+    bool parallel = pool && thread_pool_size(pool) > 1 && skeleton.blocks > 1;
+    int threads = parallel ? thread_pool_size(pool) : 1;
+
+    result->arenas = calloc((size_t)threads, sizeof(ast_arena_t *));
+    parser_task_t *tasks = malloc((size_t)(skeleton.count ? skeleton.count : 1) * sizeof(parser_task_t));
+    parser_segment_state_t *states = calloc((size_t)(skeleton.count ? skeleton.count : 1),
+                                            sizeof(parser_segment_state_t));
+    bool ok = result->arenas && tasks && states;
+    for (int i = 0; ok && i < threads; i++) {
+        result->arenas[i] = ast_arena_create();
+        ok = result->arenas[i] != NULL;
+        if (ok) result->arena_count++;
+    }
+
+    if (ok) {
+        for (int i = 0; i < skeleton.count; i++) {
+            tasks[i] = (parser_task_t){ skeleton.segments[i].end - skeleton.segments[i].start, i };
+        }
+        if (parallel) qsort(tasks, (size_t)skeleton.count, sizeof(parser_task_t), parser_compare_tasks);
+
+        parser_parallel_job_t job = { ts, &skeleton, tasks, states, result->arenas };
+        if (parallel) {
+            thread_pool_run(pool, (size_t)skeleton.count, parser_parse_segment, &job);
+        } else {
+            for (int i = 0; i < skeleton.count; i++) parser_parse_segment(&job, (size_t)i, 0);
+        }
+
+        // Оператор вышел за границу участка: остаток программы разбирается заново
+        // последовательно, одним участком от начала нарушителя до конца потока
+        for (int i = 0; i < skeleton.count; i++) {
+            if (!states[i].ok || states[i].stop <= skeleton.segments[i].end) continue;
+            for (int k = i; k < skeleton.count; k++) {
+                diag_list_free(&states[k].diagnostics);
+                free(states[k].offsets);
+                states[k] = (parser_segment_state_t){ 0 };
+            }
+            skeleton.segments[i].end = skeleton.segments[skeleton.count - 1].end;
+            skeleton.count = i + 1;
+            tasks[0] = (parser_task_t){ skeleton.segments[i].end - skeleton.segments[i].start, i };
+            parser_parse_segment(&job, 0, 0);
+            break;
+        }
+
+        // Сборка в исходном порядке участков
+        ast_arena_t *previous = ast_arena_activate(result->arenas[0]);
+        result->program = ast_node_create(AST_PROGRAM);
+        ast_arena_activate(previous);
+        ok = result->program != NULL;
+        bool positions = true;      // У всех участков хватило памяти под смещения
+        for (int i = 0; ok && i < skeleton.count; i++) {
+            ok = states[i].ok;
+            if (!ok) break;
+            ASTNode *statements = states[i].statements;
+            for (int k = 0; k < statements->child_count; k++) {
+                uint32_t offset = states[i].offsets ? states[i].offsets[k] : 0;
+                parser_offsets_push(&result->offsets, result->program->child_count, offset);
+                ast_node_add_child(result->program, statements->children[k]);
+            }
+            positions = positions && (states[i].offsets || statements->child_count == 0);
+            ok = diag_list_append(&result->diagnostics, &states[i].diagnostics);
+        }
+        // Позиции необязательны: без смещений одного участка их нет у всей программы
+        if (!positions) {
+            free(result->offsets);
+            result->offsets = NULL;
+        }
+    }
+
+    for (int i = 0; states && i < skeleton.count; i++) {
+        diag_list_free(&states[i].diagnostics);
+        free(states[i].offsets);
+    }
+    free(tasks);
+    free(states);
+    parser_skeleton_free(&skeleton);
+    if (!ok) {
+        fprintf(stderr, "Out of memory while parsing program blocks\n");
+        parser_parallel_result_free(result);
+    }
+    return ok;
+}
+
+void parser_parallel_result_free(parser_parallel_result_t *result) {
+    for (int i = 0; i < result->arena_count; i++) {
+        ast_arena_destroy(result->arenas[i]);
+    }
+    free(result->arenas);
+    free(result->offsets);
+    diag_list_free(&result->diagnostics);
+    *result = (parser_parallel_result_t){ 0 };
+}
@@ -2,14 +2,37 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 
+// Фактические параметры дополнения USING/CHANGING/TABLES: операнды до следующего
+// дополнения или конца оператора
+static bool parse_perform_operands(TokenStream *ts, ASTNode *perform_node, const char *keyword) {
+    ASTNode *clause = parser_add_clause(perform_node, keyword);
+    if (!clause) return false;
+    for (;;) {
+        TokenType type = token_stream_peek_type(ts);
+        if (type == TOKEN_PUNCTUATION_DOT || type == TOKEN_EOF || type == TOKEN_KEYWORD_USING ||
+            type == TOKEN_KEYWORD_CHANGING || type == TOKEN_KEYWORD_TABLES) {
+            return true;
+        }
+        ASTNode *operand = parse_expression_prec(ts, PARSER_PREC_CONCAT);
+        if (!operand) return false;
+        ast_node_add_child(clause, operand);
+    }
+}
+
 /**
  * parse_perform_complex - Парсит сложные конструкции PERFORM,
  * включая параметры и опциональные условия.
  *
- * Синтаксис примера:
- * PERFORM <form_name> [USING <params>] [CHANGING <params>] [ON EXCEPTIONS] [TABLES <tables>] [WHERE <condition>].
+ * Синтаксис:
+ * PERFORM <form_name> [IN PROGRAM <prog>] [IF FOUND] [TABLES <tables>] [USING <params>]
+ *                     [CHANGING <params>] [ON COMMIT | ON ROLLBACK].
+ *
+ * atom узла AST_PERFORM — имя FORM; TABLES, USING, CHANGING и IN PROGRAM —
+ * дополнения AST_STATEMENT_CLAUSE с операндами в порядке записи.
  *
  * Возвращает AST узел PERFORM или NULL при ошибке.
  */
@@ -19,15 +42,10 @@ ASTNode *parse_perform_complex(TokenStream *ts) {
         return NULL;
     }
 
-    Token *token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_KEYWORD_PERFORM) {
-        report_error("Expected PERFORM keyword");
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_PERFORM, "PERFORM keyword")) return NULL;
 
     // Имя формы
-    token = token_stream_next(ts);
-    if (!token || token->type != TOKEN_IDENTIFIER) {
+    if (token_stream_peek_type(ts) != TOKEN_IDENTIFIER) {
         report_error("Expected form name after PERFORM");
         return NULL;
     }
@@ -37,60 +55,32 @@ ASTNode *parse_perform_complex(TokenStream *ts) {
         report_error("Failed to create AST node for PERFORM");
         return NULL;
     }
+    perform_node->atom = token_stream_atom_at(ts, token_stream_advance(ts));
 
-    perform_node->form_name = strdup(token->text);
-    if (!perform_node->form_name) {
-        report_error("Memory allocation failed for form_name");
-        ast_node_free(perform_node);
-        return NULL;
-    }
-
-    // Обрабатываем параметры (USING, CHANGING, TABLES и др.)
-    while (1) {
-        token = token_stream_peek(ts);
-        if (!token) break;
-
-        if (token->type == TOKEN_KEYWORD_USING) {
-            token_stream_next(ts); // съесть USING
-            ASTNodeList *using_params = parse_parameter_list(ts);
-            if (!using_params) {
-                report_error("Failed to parse USING parameters");
-                ast_node_free(perform_node);
-                return NULL;
-            }
-            perform_node->using_params = using_params;
-        } else if (token->type == TOKEN_KEYWORD_CHANGING) {
-            token_stream_next(ts); // съесть CHANGING
-            ASTNodeList *changing_params = parse_parameter_list(ts);
-            if (!changing_params) {
-                report_error("Failed to parse CHANGING parameters");
-                ast_node_free(perform_node);
-                return NULL;
-            }
-            perform_node->changing_params = changing_params;
-        } else if (token->type == TOKEN_KEYWORD_TABLES) {
-            token_stream_next(ts); // съесть TABLES
-            ASTNodeList *tables_params = parse_parameter_list(ts);
-            if (!tables_params) {
-                report_error("Failed to parse TABLES parameters");
-                ast_node_free(perform_node);
-                return NULL;
-            }
-            perform_node->tables_params = tables_params;
-        } else if (token->type == TOKEN_KEYWORD_ON) {
-            // ON EXCEPTIONS
-            token_stream_next(ts); // съесть ON
-            token = token_stream_next(ts);
-            if (!token || token->type != TOKEN_KEYWORD_EXCEPTIONS) {
-                report_error("Expected EXCEPTIONS after ON");
-                ast_node_free(perform_node);
-                return NULL;
-            }
-            perform_node->on_exceptions = 1;
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF; ) {
+        bool parsed;
+        if (parser_accept(ts, TOKEN_KEYWORD_USING)) {
+            parsed = parse_perform_operands(ts, perform_node, "USING");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_CHANGING)) {
+            parsed = parse_perform_operands(ts, perform_node, "CHANGING");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_TABLES)) {
+            parsed = parse_perform_operands(ts, perform_node, "TABLES");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_IN)) {
+            parsed = parser_accept_word(ts, "PROGRAM") && parser_parse_clause(ts, perform_node, "IN PROGRAM");
+            if (!parsed) report_error("Expected program name after IN PROGRAM");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_IF) || parser_accept(ts, TOKEN_KEYWORD_ON)) {
+            // IF FOUND, ON COMMIT, ON ROLLBACK на разбор дерева не влияют
+            parsed = parser_accept_word(ts, "FOUND") || parser_accept(ts, TOKEN_KEYWORD_COMMIT) ||
+                     parser_accept_word(ts, "ROLLBACK");
+            if (!parsed) report_error("Expected FOUND, COMMIT or ROLLBACK in PERFORM");
         } else {
-            break;
+            report_error("Unexpected token in PERFORM statement");
+            parsed = false;
         }
+        if (!parsed) return perform_node;
     }
-
+    parser_end_statement(ts);
     return perform_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_PERFORM, TOKEN_UNKNOWN, 0, parse_perform_complex)
@@ -13,8 +13,8 @@
  */
 void report_perform_error(const char *message, const Token *token) {
     if (token) {
-        fprintf(stderr, "Perform parse error at line %d, column %d: %s (token: '%s')\n",
-            token->line, token->column, message, token->text ? token->text : "<no text>");
+        fprintf(stderr, "Perform parse error at line %d, column %d: %s (token: '%.*s')\n",
+            token->line, token->column, message, token->text ? (int)token->length : 9, token->text ? token->text : "<no text>");
     } else {
         fprintf(stderr, "Perform parse error: %s\n", message);
     }
@@ -38,7 +38,7 @@ ASTNode *parse_perform_nested(TokenStream *ts) {
         report_error("Failed to create AST node for PERFORM");
         return NULL;
     }
-    perform_node->perform_form_name = strdup(token->text);
+    perform_node->perform_form_name = token_strdup(token);
     if (!perform_node->perform_form_name) {
         report_error("Memory allocation failed for form name");
         ast_node_free(perform_node);
@@ -129,7 +129,7 @@ int parse_perform_param_list(TokenStream *ts, ASTNodeList *param_list) {
                 report_error("Failed to create AST variable node for param");
                 return 0;
             }
-            param_node->var_name = strdup(token->text);
+            param_node->var_name = token_strdup(token);
             if (!param_node->var_name) {
                 report_error("Memory allocation failed for param var_name");
                 ast_node_free(param_node);
@@ -38,7 +38,7 @@ ASTNode *parse_perform_simple(TokenStream *ts) {
         return NULL;
     }
 
-    perform_node->perform_form_name = strdup(token->text);
+    perform_node->perform_form_name = token_strdup(token);
     if (!perform_node->perform_form_name) {
         report_error("Memory allocation failed for form name");
         ast_node_free(perform_node);
@@ -32,18 +32,19 @@ ASTNode *parse_select_into_table(TokenStream *ts) {
         return NULL;
     }
 
-    Token *tok = NULL;
-    while ((tok = token_stream_peek(ts)) != NULL) {
-        if (tok->type == TOKEN_INTO) {
+    // Просмотр вперёд читает только массив типов потока; токен целиком не собирается
+    TokenType type;
+    while ((type = token_stream_peek_type(ts)) != TOKEN_EOF) {
+        if (type == TOKEN_INTO) {
             break;
         }
 
-        tok = token_stream_next(ts);
-        if (tok->type == TOKEN_COMMA) {
+        int index = token_stream_advance(ts);
+        if (type == TOKEN_COMMA) {
             continue;
         }
 
-        if (tok->type != TOKEN_IDENTIFIER) {
+        if (type != TOKEN_IDENTIFIER) {
             report_error("Expected field identifier in SELECT statement");
             ast_node_free(select_node);
             ast_node_free(fields_node);
@@ -58,18 +59,12 @@ ASTNode *parse_select_into_table(TokenStream *ts) {
             return NULL;
         }
 
-        field_node->string_value = strdup(tok->text);
-        if (!field_node->string_value) {
-            report_error("Failed to allocate memory for field name");
-            ast_node_free(select_node);
-            ast_node_free(fields_node);
-            return NULL;
-        }
+        field_node->atom = token_stream_atom_at(ts, index);
 
         ast_node_add_child(fields_node, field_node);
     }
 
-    if (!tok || tok->type != TOKEN_INTO) {
+    if (type != TOKEN_INTO) {
         report_error("Expected INTO keyword in SELECT statement");
         ast_node_free(select_node);
         ast_node_free(fields_node);
@@ -78,8 +73,7 @@ ASTNode *parse_select_into_table(TokenStream *ts) {
     token_stream_next(ts); // consume INTO
 
     // Ожидается TABLE после INTO
-    tok = token_stream_next(ts);
-    if (!tok || tok->type != TOKEN_TABLE) {
+    if (token_stream_type_at(ts, token_stream_advance(ts)) != TOKEN_TABLE) {
         report_error("Expected TABLE keyword after INTO");
         ast_node_free(select_node);
         ast_node_free(fields_node);
@@ -102,18 +96,10 @@ ASTNode *parse_select_into_table(TokenStream *ts) {
         ast_node_free(fields_node);
         return NULL;
     }
-    into_table_node->string_value = strdup(table_var_tok->text);
-    if (!into_table_node->string_value) {
-        report_error("Failed to allocate memory for internal table variable name");
-        ast_node_free(select_node);
-        ast_node_free(fields_node);
-        ast_node_free(into_table_node);
-        return NULL;
-    }
+    into_table_node->atom = token_atom(table_var_tok);
 
     // Ожидается ключевое слово FROM
-    tok = token_stream_next(ts);
-    if (!tok || tok->type != TOKEN_FROM) {
+    if (token_stream_type_at(ts, token_stream_advance(ts)) != TOKEN_FROM) {
         report_error("Expected FROM keyword in SELECT statement");
         ast_node_free(select_node);
         ast_node_free(fields_node);
@@ -139,15 +125,7 @@ ASTNode *parse_select_into_table(TokenStream *ts) {
         ast_node_free(into_table_node);
         return NULL;
     }
-    db_table_node->string_value = strdup(db_table_tok->text);
-    if (!db_table_node->string_value) {
-        report_error("Failed to allocate memory for table name");
-        ast_node_free(select_node);
-        ast_node_free(fields_node);
-        ast_node_free(into_table_node);
-        ast_node_free(db_table_node);
-        return NULL;
-    }
+    db_table_node->atom = token_atom(db_table_tok);
 
     ast_node_add_child(select_node, fields_node);
     ast_node_add_child(select_node, into_table_node);
@@ -195,12 +173,7 @@ ASTNode *parse_select_into_table(TokenStream *ts) {
         return NULL;
     }
 
-    into_table_node->string_value = strdup(table_var_tok->text);
-    if (!into_table_node->string_value) {
-        report_error("Failed to allocate memory for INTO TABLE variable name");
-        ast_node_free(into_table_node);
-        return NULL;
-    }
+    into_table_node->atom = token_atom(table_var_tok);
 
     return into_table_node;
 }
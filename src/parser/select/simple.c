@@ -2,125 +2,163 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
+#include "../../include/parser_select.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-/**
- * parse_simple_select - Парсит простой оператор SELECT в ABAP.
- *
- * Ожидается, что ключевое слово SELECT уже было прочитано.
- * Возвращает AST узел SELECT или NULL при ошибке.
- */
-
-ASTNode *parse_simple_select(TokenStream *ts) {
-    if (!ts) {
-        report_error("TokenStream is NULL in parse_simple_select");
+// Поле списка SELECT: имя (tab~field) или агрегат COUNT( * ), MAX( f ), ...
+static ASTNode *parse_select_field(TokenStream *ts, bool *aggregate) {
+    atom_t name = parse_name(ts);
+    if (name == ATOM_NONE) {
+        report_error("Expected field name in SELECT list");
         return NULL;
     }
-
-    ASTNode *select_node = ast_node_create(AST_SELECT);
-    if (!select_node) {
-        report_error("Failed to allocate AST node for SELECT");
+    bool call = parser_accept(ts, TOKEN_PUNCTUATION_LPAREN);
+    ASTNode *field = ast_node_create(call ? AST_FUNCTION_CALL : AST_IDENTIFIER);
+    if (!field) {
+        report_error("Failed to allocate AST node for SELECT field");
         return NULL;
     }
-
-    // Парсим список полей до ключевого слова FROM
-    ASTNode *fields_node = ast_node_create(AST_FIELD_LIST);
-    if (!fields_node) {
-        report_error("Failed to allocate AST node for field list");
-        ast_node_free(select_node);
-        return NULL;
-    }
-
-    Token *tok = NULL;
-    while ((tok = token_stream_peek(ts)) != NULL && tok->type != TOKEN_FROM) {
-        tok = token_stream_next(ts);
-
-        if (tok->type == TOKEN_COMMA) {
-            continue; // пропускаем запятые
+    field->atom = name;
+    if (call) {
+        *aggregate = true;
+        parser_accept_word(ts, "DISTINCT");
+        // COUNT( * ) аргумента не даёт
+        if (!parser_accept(ts, TOKEN_OPERATOR_MULTIPLY)) {
+            ASTNode *argument = ast_node_create(AST_IDENTIFIER);
+            if (!argument) {
+                report_error("Failed to allocate AST node for SELECT field");
+                ast_node_free(field);
+                return NULL;
+            }
+            ast_node_add_child(field, argument);
+            if ((argument->atom = parse_name(ts)) == ATOM_NONE) {
+                report_error("Expected field name in aggregate");
+                ast_node_free(field);
+                return NULL;
+            }
         }
-
-        if (tok->type != TOKEN_IDENTIFIER) {
-            report_error("Expected field identifier in SELECT statement");
-            ast_node_free(select_node);
-            ast_node_free(fields_node);
+        if (!parser_expect(ts, TOKEN_PUNCTUATION_RPAREN, "')' after aggregate")) {
+            ast_node_free(field);
             return NULL;
         }
+    } else {
+        *aggregate = false;
+    }
+    if (parser_accept_word(ts, "AS") && parse_name(ts) == ATOM_NONE) {
+        report_error("Expected alias after AS");
+        ast_node_free(field);
+        return NULL;
+    }
+    return field;
+}
 
-        ASTNode *field_node = ast_node_create(AST_FIELD);
-        if (!field_node) {
-            report_error("Failed to allocate AST node for field");
-            ast_node_free(select_node);
-            ast_node_free(fields_node);
-            return NULL;
+// Список полей до FROM: * или имена и агрегаты через пробел или запятую.
+// aggregate_only — все поля агрегаты: результат — одна строка без ENDSELECT
+static bool parse_select_fields(TokenStream *ts, ASTNode *select_node, bool *aggregate_only) {
+    if (parser_accept(ts, TOKEN_OPERATOR_MULTIPLY)) {
+        *aggregate_only = false;
+        return parser_add_clause(select_node, "FIELDS *") != NULL;
+    }
+    ASTNode *fields = parser_add_clause(select_node, "FIELDS");
+    if (!fields) return false;
+    *aggregate_only = true;
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_KEYWORD_FROM; ) {
+        if (type == TOKEN_PUNCTUATION_COMMA) {
+            token_stream_advance(ts);
+            continue;
         }
-
-        field_node->string_value = strdup(tok->text);
-        if (!field_node->string_value) {
-            report_error("Failed to allocate memory for field name");
-            ast_node_free(select_node);
-            ast_node_free(fields_node);
-            return NULL;
+        if (type == TOKEN_EOF || type == TOKEN_PUNCTUATION_DOT) {
+            report_error("Expected FROM keyword in SELECT statement");
+            return false;
         }
-
-        ast_node_add_child(fields_node, field_node);
+        bool aggregate;
+        ASTNode *field = parse_select_field(ts, &aggregate);
+        if (!field) return false;
+        ast_node_add_child(fields, field);
+        *aggregate_only = *aggregate_only && aggregate;
     }
-
-    if (!tok || tok->type != TOKEN_FROM) {
-        report_error("Expected FROM keyword in SELECT statement");
-        ast_node_free(select_node);
-        ast_node_free(fields_node);
-        return NULL;
+    if (fields->child_count == 0) {
+        report_error("Expected field list in SELECT statement");
+        return false;
     }
-    token_stream_next(ts); // consume FROM
+    return true;
+}
 
-    // Парсим имя таблицы после FROM
-    Token *table_tok = token_stream_next(ts);
-    if (!table_tok || table_tok->type != TOKEN_IDENTIFIER) {
-        report_error("Expected table name after FROM");
-        ast_node_free(select_node);
-        ast_node_free(fields_node);
-        return NULL;
-    }
+// Слова дополнений SELECT, которые лексер оставляет идентификаторами
+static bool select_clause_word(const TokenStream *ts) {
+    return parser_peek_word(ts, "ORDER") || parser_peek_word(ts, "GROUP") || parser_peek_word(ts, "UP") ||
+           parser_peek_word(ts, "APPENDING") || parser_peek_word(ts, "FOR");
+}
 
-    ASTNode *table_node = ast_node_create(AST_TABLE);
-    if (!table_node) {
-        report_error("Failed to allocate AST node for table");
-        ast_node_free(select_node);
-        ast_node_free(fields_node);
-        return NULL;
+// Имена ORDER BY / GROUP BY; ASCENDING и DESCENDING на дерево не влияют
+static bool parse_select_names(TokenStream *ts, ASTNode *select_node, const char *keywords) {
+    if (parser_accept_word(ts, "PRIMARY")) {
+        return parser_expect(ts, TOKEN_KEYWORD_KEY, "KEY after PRIMARY") &&
+               parser_add_clause(select_node, "ORDER BY PRIMARY KEY") != NULL;
+    }
+    ASTNode *clause = parser_add_clause(select_node, keywords);
+    if (!clause) return false;
+    for (;;) {
+        parser_accept(ts, TOKEN_PUNCTUATION_COMMA);
+        if (token_stream_peek_type(ts) != TOKEN_IDENTIFIER || select_clause_word(ts)) break;
+        if (parser_accept_word(ts, "ASCENDING") || parser_accept_word(ts, "DESCENDING")) continue;
+        ASTNode *name = ast_node_create(AST_IDENTIFIER);
+        if (!name) {
+            report_error("Failed to allocate AST node for %s", keywords);
+            return false;
+        }
+        name->atom = parse_name(ts);
+        ast_node_add_child(clause, name);
     }
-
-    table_node->string_value = strdup(table_tok->text);
-    if (!table_node->string_value) {
-        report_error("Failed to allocate memory for table name");
-        ast_node_free(select_node);
-        ast_node_free(fields_node);
-        return NULL;
+    if (clause->child_count == 0) {
+        report_error("Expected field name after %s", keywords);
+        return false;
     }
-
-    ast_node_add_child(select_node, fields_node);
-    ast_node_add_child(select_node, table_node);
-
-    // Опционально, можно расширить поддержку WHERE, INTO и т.п.
-
-    return select_node;
+    return true;
 }
 
-
-////////////////////////////////
-
-#include "../../include/parser.h"
-#include "../../include/token.h"
-#include "../../include/ast.h"
-#include "../../include/error.h"
-#include <stdlib.h>
-#include <string.h>
+// Цель INTO / APPENDING: [CORRESPONDING FIELDS OF] [TABLE] цель.
+// table — результат пишется в таблицу целиком, ENDSELECT не нужен
+static bool parse_select_target(TokenStream *ts, ASTNode *select_node, bool appending, bool *table) {
+    char keywords[64];
+    size_t length = 0;
+    length += (size_t)snprintf(keywords, sizeof(keywords), "%s", appending ? "APPENDING" : "INTO");
+    if (parser_accept_word(ts, "CORRESPONDING")) {
+        if (!parser_accept_word(ts, "FIELDS") || !parser_expect(ts, TOKEN_KEYWORD_OF, "FIELDS OF")) {
+            report_error("Expected FIELDS OF after CORRESPONDING");
+            return false;
+        }
+        length += (size_t)snprintf(keywords + length, sizeof(keywords) - length, " CORRESPONDING FIELDS OF");
+    }
+    *table = parser_accept(ts, TOKEN_KEYWORD_TABLE);
+    if (*table) snprintf(keywords + length, sizeof(keywords) - length, " TABLE");
+    if (appending && !*table) {
+        report_error("Expected TABLE after APPENDING");
+        return false;
+    }
+    return parser_parse_clause(ts, select_node, keywords);
+}
 
 /**
- * parse_select_simple - Парсит простой SELECT-запрос без JOIN.
+ * parse_select_simple - Парсит оператор SELECT, в том числе с JOIN.
  *
  * Ожидается, что ключевое слово SELECT уже прочитано.
+ *
+ * SELECT [SINGLE] * | поля FROM таблица [AS псевдоним] [соединения]
+ *        [INTO | APPENDING ...] [UP TO n ROWS] [FOR ALL ENTRIES IN itab]
+ *        [WHERE условие] [GROUP BY ...] [ORDER BY ...].
+ *   ... тело ...
+ * ENDSELECT.
+ *
+ * atom узла AST_SELECT — таблица FROM; список полей, SINGLE, INTO, WHERE и прочие
+ * дополнения — узлы AST_STATEMENT_CLAUSE, соединения — AST_JOIN (parse_select_join()).
+ * Тело до ENDSELECT разбирается, если результат читается построчно: без SINGLE,
+ * без INTO TABLE / APPENDING TABLE и не только агрегаты без GROUP BY.
+ *
  * Возвращает AST узел SELECT или NULL при ошибке.
  */
 ASTNode *parse_select_simple(TokenStream *ts) {
@@ -135,84 +173,68 @@ ASTNode *parse_select_simple(TokenStream *ts) {
         return NULL;
     }
 
-    // Парсим список полей до ключевого слова FROM
-    ASTNode *fields_node = ast_node_create(AST_FIELD_LIST);
-    if (!fields_node) {
-        report_error("Failed to allocate AST node for field list");
-        ast_node_free(select_node);
-        return NULL;
-    }
-
-    Token *tok = NULL;
-    while ((tok = token_stream_peek(ts)) != NULL && tok->type != TOKEN_FROM) {
-        tok = token_stream_next(ts);
+    bool single = parser_accept_word(ts, "SINGLE");
+    if (single && !parser_add_clause(select_node, "SINGLE")) return select_node;
+    parser_accept_word(ts, "DISTINCT");
 
-        if (tok->type == TOKEN_COMMA) {
-            continue;
-        }
+    bool aggregate_only;
+    if (!parse_select_fields(ts, select_node, &aggregate_only)) return select_node;
 
-        if (tok->type != TOKEN_IDENTIFIER) {
-            report_error("Expected identifier in SELECT fields");
-            ast_node_free(select_node);
-            ast_node_free(fields_node);
-            return NULL;
-        }
-
-        ASTNode *field_node = ast_node_create(AST_FIELD);
-        if (!field_node) {
-            report_error("Failed to allocate AST node for field");
-            ast_node_free(select_node);
-            ast_node_free(fields_node);
-            return NULL;
-        }
-
-        field_node->string_value = strdup(tok->text);
-        if (!field_node->string_value) {
-            report_error("Failed to allocate memory for field name");
-            ast_node_free(select_node);
-            ast_node_free(fields_node);
-            ast_node_free(field_node);
-            return NULL;
-        }
-
-        ast_node_add_child(fields_node, field_node);
-    }
-
-    if (!tok || tok->type != TOKEN_FROM) {
-        report_error("Expected FROM keyword in SELECT statement");
-        ast_node_free(select_node);
-        ast_node_free(fields_node);
-        return NULL;
-    }
-    token_stream_next(ts); // consume FROM
-
-    // Парсим имя таблицы после FROM
-    Token *table_tok = token_stream_next(ts);
-    if (!table_tok || table_tok->type != TOKEN_IDENTIFIER) {
+    token_stream_advance(ts); // FROM
+    if ((select_node->atom = parse_name(ts)) == ATOM_NONE) {
         report_error("Expected table name after FROM");
-        ast_node_free(select_node);
-        ast_node_free(fields_node);
-        return NULL;
-    }
-
-    ASTNode *table_node = ast_node_create(AST_TABLE);
-    if (!table_node) {
-        report_error("Failed to allocate AST node for table");
-        ast_node_free(select_node);
-        ast_node_free(fields_node);
-        return NULL;
-    }
-    table_node->string_value = strdup(table_tok->text);
-    if (!table_node->string_value) {
-        report_error("Failed to allocate memory for table name");
-        ast_node_free(select_node);
-        ast_node_free(fields_node);
-        ast_node_free(table_node);
-        return NULL;
+        return select_node;
+    }
+    if (parser_accept_word(ts, "AS") && parse_name(ts) == ATOM_NONE) {
+        report_error("Expected alias after AS");
+        return select_node;
+    }
+
+    bool into_table = false, grouped = false;
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF; ) {
+        bool parsed;
+        if (type == TOKEN_KEYWORD_JOIN || parser_peek_word(ts, "INNER") || parser_peek_word(ts, "LEFT")) {
+            parsed = parse_select_join(ts, select_node);
+        } else if (parser_accept(ts, TOKEN_KEYWORD_INTO)) {
+            parsed = parse_select_target(ts, select_node, false, &into_table);
+        } else if (parser_accept_word(ts, "APPENDING")) {
+            parsed = parse_select_target(ts, select_node, true, &into_table);
+        } else if (parser_accept_word(ts, "UP")) {
+            parsed = parser_expect(ts, TOKEN_KEYWORD_TO, "TO after UP") &&
+                     parser_parse_clause(ts, select_node, "UP TO");
+            if (parsed && !parser_accept_word(ts, "ROWS")) {
+                report_error("Expected ROWS after UP TO n");
+                parsed = false;
+            }
+        } else if (parser_accept_word(ts, "FOR")) {
+            parsed = parser_accept_word(ts, "ALL") && parser_accept_word(ts, "ENTRIES") &&
+                     parser_accept(ts, TOKEN_KEYWORD_IN);
+            if (!parsed) report_error("Expected ALL ENTRIES IN after FOR");
+            parsed = parsed && parser_parse_clause(ts, select_node, "FOR ALL ENTRIES IN");
+        } else if (parser_accept(ts, TOKEN_KEYWORD_WHERE)) {
+            parsed = parser_parse_clause(ts, select_node, "WHERE");
+        } else if (parser_accept_word(ts, "GROUP")) {
+            grouped = true;
+            parsed = parser_expect(ts, TOKEN_KEYWORD_BY, "BY after GROUP") &&
+                     parse_select_names(ts, select_node, "GROUP BY");
+        } else if (parser_accept_word(ts, "ORDER")) {
+            parsed = parser_expect(ts, TOKEN_KEYWORD_BY, "BY after ORDER") &&
+                     parse_select_names(ts, select_node, "ORDER BY");
+        } else {
+            report_error("Unexpected token in SELECT statement");
+            parsed = false;
+        }
+        if (!parsed) return select_node;
     }
+    if (!parser_end_statement(ts)) return select_node;
 
-    ast_node_add_child(select_node, fields_node);
-    ast_node_add_child(select_node, table_node);
+    if (single || into_table || (aggregate_only && !grouped)) return select_node;
 
+    static const TokenType ends[] = { TOKEN_KEYWORD_ENDSELECT };
+    if (!parser_parse_block(ts, select_node, ends, 1, "ENDSELECT")) return select_node;
+    token_stream_advance(ts); // ENDSELECT
+    parser_end_statement(ts);
     return select_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_SELECT, TOKEN_UNKNOWN, 1, parse_select_simple)
@@ -26,10 +26,10 @@ ASTNode *parse_select_where(TokenStream *ts) {
     // Парсим выражение условия (упрощённо: до конца SELECT или конца блока)
     // Можно расширить до полноценного рекурсивного парсера выражений
 
-    Token *tok = NULL;
-    while ((tok = token_stream_peek(ts)) != NULL &&
-           tok->type != TOKEN_ENDSELECT && tok->type != TOKEN_SEMICOLON) {
-        tok = token_stream_next(ts);
+    TokenType type;
+    while ((type = token_stream_peek_type(ts)) != TOKEN_EOF &&
+           type != TOKEN_ENDSELECT && type != TOKEN_SEMICOLON) {
+        Token tok = token_stream_token_at(ts, token_stream_advance(ts));
 
         // Создаём узлы для каждого токена или более сложное дерево условий
         // Для упрощения добавим каждый токен как дочерний узел с текстом
@@ -40,7 +40,7 @@ ASTNode *parse_select_where(TokenStream *ts) {
             ast_node_free(where_node);
             return NULL;
         }
-        expr_node->string_value = strdup(tok->text);
+        expr_node->string_value = ast_token_strdup(&tok);
         if (!expr_node->string_value) {
             report_error("Failed to allocate memory for token text");
             ast_node_free(where_node);
@@ -49,7 +49,7 @@ ASTNode *parse_select_where(TokenStream *ts) {
         ast_node_add_child(where_node, expr_node);
     }
 
-    if (!tok) {
+    if (type == TOKEN_EOF) {
         report_error("Unexpected end of tokens while parsing WHERE condition");
         ast_node_free(where_node);
         return NULL;
@@ -87,12 +87,12 @@ ASTNode *parse_select_where(TokenStream *ts) {
     }
 
     // Парсим условие до ключевого слова ENDSELECT, SEMICOLON или других
-    Token *tok = NULL;
+    TokenType type;
 
-    while ((tok = token_stream_peek(ts)) != NULL &&
-           tok->type != TOKEN_ENDSELECT &&
-           tok->type != TOKEN_SEMICOLON) {
-        tok = token_stream_next(ts);
+    while ((type = token_stream_peek_type(ts)) != TOKEN_EOF &&
+           type != TOKEN_ENDSELECT &&
+           type != TOKEN_SEMICOLON) {
+        Token tok = token_stream_token_at(ts, token_stream_advance(ts));
 
         ASTNode *expr_node = ast_node_create(AST_EXPRESSION_TOKEN);
         if (!expr_node) {
@@ -101,7 +101,7 @@ ASTNode *parse_select_where(TokenStream *ts) {
             return NULL;
         }
 
-        expr_node->string_value = strdup(tok->text);
+        expr_node->string_value = ast_token_strdup(&tok);
         if (!expr_node->string_value) {
             report_error("Failed to allocate memory for token text in WHERE");
             ast_node_free(where_node);
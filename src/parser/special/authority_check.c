@@ -2,12 +2,36 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
+#include <string.h>
+
+// Параметр проверки: слово в string_value, значение (если есть) — потомок
+static bool parse_authority_param(TokenStream *ts, ASTNode *node, const char *word, bool has_value) {
+    ASTNode *param_node = ast_node_create(AST_AUTH_CHECK_PARAM);
+    if (param_node) param_node->string_value = ast_strndup(word, strlen(word));
+    if (!param_node || !param_node->string_value) {
+        report_error("Failed to create AST node for AUTHORITY-CHECK parameter");
+        ast_node_free(param_node);
+        return false;
+    }
+    ast_node_add_child(node, param_node);
+    if (!has_value) return true;
+
+    ASTNode *value_node = parse_expression_prec(ts, PARSER_PREC_CONCAT);
+    if (!value_node) return false;
+    ast_node_add_child(param_node, value_node);
+    return true;
+}
 
 /**
  * parse_special_authority_check - Парсит оператор AUTHORITY-CHECK.
  *
- * AUTHORITY-CHECK используется для проверки прав пользователя на объекты системы.
- * Синтаксис может включать несколько параметров, например, OBJECT, ID, FIELD и т.д.
+ * AUTHORITY-CHECK OBJECT <obj> [FOR USER <user>]
+ *                 ID <id> FIELD <value> | ID <id> DUMMY ... .
+ *
+ * Параметры — узлы AST_AUTH_CHECK_PARAM в порядке записи: string_value — слово
+ * (OBJECT, FOR USER, ID, FIELD, DUMMY), потомок — значение (у DUMMY его нет).
  *
  * Возвращает AST узел AUTHORITY_CHECK с параметрами проверки.
  */
@@ -17,46 +41,39 @@ ASTNode *parse_special_authority_check(TokenStream *ts) {
         return NULL;
     }
 
-    Token *auth_tok = token_stream_next(ts);
-    if (!auth_tok || auth_tok->type != TOKEN_AUTHORITY_CHECK) {
-        report_error("Expected AUTHORITY-CHECK token");
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_AUTHORITY_CHECK, "AUTHORITY-CHECK")) return NULL;
 
-    ASTNode *node = ast_node_create(AST_SPECIAL_AUTHORITY_CHECK);
+    ASTNode *node = ast_node_create(AST_AUTHORITY_CHECK);
     if (!node) {
         report_error("Failed to create AST node for AUTHORITY-CHECK");
         return NULL;
     }
 
-    // Парсим параметры AUTHORITY-CHECK, например: OBJECT <obj>, ID <id>, FIELD <field>
-    while (1) {
-        Token *param_tok = token_stream_peek(ts);
-        if (!param_tok) break;
-
-        if (param_tok->type == TOKEN_OBJECT || param_tok->type == TOKEN_ID || param_tok->type == TOKEN_FIELD) {
-            token_stream_next(ts); // consume param
-
-            Token *value_tok = token_stream_next(ts);
-            if (!value_tok || (value_tok->type != TOKEN_IDENTIFIER && value_tok->type != TOKEN_LITERAL)) {
-                report_error("Expected identifier or literal after AUTHORITY-CHECK parameter");
-                ast_node_free(node);
-                return NULL;
-            }
-
-            ASTNode *param_node = ast_node_create(AST_SPECIAL_AUTH_PARAM);
-            param_node->string_value = strdup(param_tok->text);
-
-            ASTNode *value_node = ast_node_create(AST_IDENTIFIER);
-            value_node->string_value = strdup(value_tok->text);
+    if (!parser_accept_word(ts, "OBJECT")) {
+        report_error("Expected OBJECT after AUTHORITY-CHECK");
+        return node;
+    }
+    if (!parse_authority_param(ts, node, "OBJECT", true)) return node;
 
-            ast_node_add_child(param_node, value_node);
-            ast_node_add_child(node, param_node);
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF; ) {
+        bool parsed;
+        if (parser_accept_word(ts, "FOR")) {
+            parsed = parser_accept_word(ts, "USER") && parse_authority_param(ts, node, "FOR USER", true);
+            if (!parsed) report_error("Expected USER after FOR");
+        } else if (parser_accept_word(ts, "ID")) {
+            parsed = parse_authority_param(ts, node, "ID", true);
+        } else if (parser_accept_word(ts, "FIELD")) {
+            parsed = parse_authority_param(ts, node, "FIELD", true);
+        } else if (parser_accept_word(ts, "DUMMY")) {
+            parsed = parse_authority_param(ts, node, "DUMMY", false);
         } else {
-            // Не параметр — заканчиваем парсинг
-            break;
+            report_error("Expected ID, FIELD or DUMMY in AUTHORITY-CHECK");
+            parsed = false;
         }
+        if (!parsed) return node;
     }
-
+    parser_end_statement(ts);
     return node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_AUTHORITY_CHECK, TOKEN_UNKNOWN, 0, parse_special_authority_check)
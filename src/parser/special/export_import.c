@@ -2,164 +2,79 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
-
-/**
- * parse_special_export_import - Парсит операторы EXPORT и IMPORT.
- *
- * Операторы EXPORT и IMPORT позволяют сохранять и загружать данные
- * в память или файлы для передачи между программами.
- * Синтаксис:
- *   EXPORT <data> TO MEMORY ID <id>.
- *   IMPORT <data> FROM MEMORY ID <id>.
- *
- * Возвращает AST узел EXPORT или IMPORT с параметрами.
- */
-ASTNode *parse_special_export_import(TokenStream *ts) {
-    if (!ts) {
-        report_error("TokenStream is NULL in parse_special_export_import");
-        return NULL;
-    }
-
-    Token *tok = token_stream_peek(ts);
-    if (!tok) {
-        report_error("Unexpected end of tokens in export_import");
-        return NULL;
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
+
+// Среда хранения кластера данных и прочие дополнения EXPORT / IMPORT
+static const parser_clause_t export_import_clauses[] = {
+    { "TO MEMORY ID", PARSER_CLAUSE_OPERAND },
+    { "FROM MEMORY ID", PARSER_CLAUSE_OPERAND },
+    { "TO DATA BUFFER", PARSER_CLAUSE_OPERAND },
+    { "FROM DATA BUFFER", PARSER_CLAUSE_OPERAND },
+    { "TO INTERNAL TABLE", PARSER_CLAUSE_OPERAND },
+    { "FROM INTERNAL TABLE", PARSER_CLAUSE_OPERAND },
+    { "TO DATABASE", PARSER_CLAUSE_OPERAND },
+    { "FROM DATABASE", PARSER_CLAUSE_OPERAND },
+    { "TO SHARED BUFFER", PARSER_CLAUSE_OPERAND },
+    { "FROM SHARED BUFFER", PARSER_CLAUSE_OPERAND },
+    { "TO SHARED MEMORY", PARSER_CLAUSE_OPERAND },
+    { "FROM SHARED MEMORY", PARSER_CLAUSE_OPERAND },
+    { "ID", PARSER_CLAUSE_OPERAND },
+    { "CLIENT", PARSER_CLAUSE_OPERAND },
+    { "COMPRESSION", PARSER_CLAUSE_OPERAND },
+    { "ACCEPTING PADDING", PARSER_CLAUSE_FLAG },
+    { "ACCEPTING TRUNCATION", PARSER_CLAUSE_FLAG },
+    { "IGNORING CONVERSION ERRORS", PARSER_CLAUSE_FLAG },
+};
+
+// Параметр кластера "p FROM dobj" (EXPORT) или "p TO dobj" (IMPORT): привязка, как p = dobj
+static bool parse_export_import_param(TokenStream *ts, ASTNode *node, TokenType direction) {
+    int count = sizeof(export_import_clauses) / sizeof(export_import_clauses[0]);
+    if (token_stream_peek_type(ts) != TOKEN_IDENTIFIER ||
+        token_stream_peek_type_at(ts, 1) != direction) {
+        ASTNode *operand = parse_expression_prec(ts, PARSER_PREC_CONCAT);
+        if (!operand) return false;
+        ast_node_add_child(node, operand);
+        return true;
     }
-
-    ASTNode *node = NULL;
-
-    if (tok->type == TOKEN_EXPORT) {
-        token_stream_next(ts); // consume EXPORT
-        node = ast_node_create(AST_SPECIAL_EXPORT);
-        if (!node) {
-            report_error("Failed to create AST node for EXPORT");
-            return NULL;
-        }
-
-        // Пропустим парсинг сложных выражений для data — для простоты сделаем идентификатор
-        Token *data_tok = token_stream_next(ts);
-        if (!data_tok || data_tok->type != TOKEN_IDENTIFIER) {
-            report_error("Expected identifier after EXPORT");
-            ast_node_free(node);
-            return NULL;
-        }
-
-        ASTNode *data_node = ast_node_create(AST_IDENTIFIER);
-        data_node->string_value = strdup(data_tok->text);
-        ast_node_add_child(node, data_node);
-
-        // Ожидаем TO MEMORY ID <id>
-        Token *to_tok = token_stream_next(ts);
-        if (!to_tok || to_tok->type != TOKEN_TO) {
-            report_error("Expected TO after EXPORT <data>");
-            ast_node_free(node);
-            return NULL;
-        }
-
-        Token *memory_tok = token_stream_next(ts);
-        if (!memory_tok || memory_tok->type != TOKEN_MEMORY) {
-            report_error("Expected MEMORY after TO");
-            ast_node_free(node);
-            return NULL;
-        }
-
-        Token *id_tok = token_stream_next(ts);
-        if (!id_tok || id_tok->type != TOKEN_ID) {
-            report_error("Expected ID after MEMORY");
-            ast_node_free(node);
-            return NULL;
-        }
-
-        Token *memid_tok = token_stream_next(ts);
-        if (!memid_tok || memid_tok->type != TOKEN_IDENTIFIER) {
-            report_error("Expected identifier after ID");
-            ast_node_free(node);
-            return NULL;
-        }
-
-        ASTNode *memid_node = ast_node_create(AST_IDENTIFIER);
-        memid_node->string_value = strdup(memid_tok->text);
-        ast_node_add_child(node, memid_node);
-
-    } else if (tok->type == TOKEN_IMPORT) {
-        token_stream_next(ts); // consume IMPORT
-        node = ast_node_create(AST_SPECIAL_IMPORT);
-        if (!node) {
-            report_error("Failed to create AST node for IMPORT");
-            return NULL;
-        }
-
-        // Аналогично, парсим идентификатор данных
-        Token *data_tok = token_stream_next(ts);
-        if (!data_tok || data_tok->type != TOKEN_IDENTIFIER) {
-            report_error("Expected identifier after IMPORT");
-            ast_node_free(node);
-            return NULL;
-        }
-
-        ASTNode *data_node = ast_node_create(AST_IDENTIFIER);
-        data_node->string_value = strdup(data_tok->text);
-        ast_node_add_child(node, data_node);
-
-        // Ожидаем FROM MEMORY ID <id>
-        Token *from_tok = token_stream_next(ts);
-        if (!from_tok || from_tok->type != TOKEN_FROM) {
-            report_error("Expected FROM after IMPORT <data>");
-            ast_node_free(node);
-            return NULL;
-        }
-
-        Token *memory_tok = token_stream_next(ts);
-        if (!memory_tok || memory_tok->type != TOKEN_MEMORY) {
-            report_error("Expected MEMORY after FROM");
-            ast_node_free(node);
-            return NULL;
-        }
-
-        Token *id_tok = token_stream_next(ts);
-        if (!id_tok || id_tok->type != TOKEN_ID) {
-            report_error("Expected ID after MEMORY");
-            ast_node_free(node);
-            return NULL;
+    int name = token_stream_advance(ts);
+    if (parser_peek_clause(ts, export_import_clauses, count)) {
+        // "p TO MEMORY ID ..." — это уже среда хранения, p — параметр без пары
+        ASTNode *operand = ast_node_create(AST_IDENTIFIER);
+        if (!operand) {
+            report_error("Failed to create AST node for EXPORT/IMPORT parameter");
+            return false;
         }
-
-        Token *memid_tok = token_stream_next(ts);
-        if (!memid_tok || memid_tok->type != TOKEN_IDENTIFIER) {
-            report_error("Expected identifier after ID");
-            ast_node_free(node);
-            return NULL;
-        }
-
-        ASTNode *memid_node = ast_node_create(AST_IDENTIFIER);
-        memid_node->string_value = strdup(memid_tok->text);
-        ast_node_add_child(node, memid_node);
-
-    } else {
-        report_error("Expected EXPORT or IMPORT token");
-        return NULL;
+        operand->atom = token_stream_atom_at(ts, name);
+        ast_node_add_child(node, operand);
+        return true;
     }
-
-    return node;
+    token_stream_advance(ts); // FROM / TO
+    ASTNode *binding = ast_node_create(AST_PARAMETER_BINDING);
+    if (!binding) {
+        report_error("Failed to create AST node for EXPORT/IMPORT parameter");
+        return false;
+    }
+    binding->atom = token_stream_atom_at(ts, name);
+    ast_node_add_child(node, binding);
+    ASTNode *value = parse_expression_prec(ts, PARSER_PREC_CONCAT);
+    if (!value) return false;
+    ast_node_add_child(binding, value);
+    return true;
 }
 
-
-///////////////////////
-
-
-#include "../../include/parser.h"
-#include "../../include/token.h"
-#include "../../include/ast.h"
-#include "../../include/error.h"
-
 /**
  * parse_special_export_import - Парсит операторы EXPORT и IMPORT.
  *
- * EXPORT <data> TO MEMORY <memid>.
- * IMPORT <data> FROM MEMORY <memid>.
- *
- * Поддерживает передачу данных по имени памяти.
+ * Операторы EXPORT и IMPORT позволяют сохранять и загружать данные
+ * в память или файлы для передачи между программами.
+ * Синтаксис:
+ *   EXPORT p1 = dobj1 p2 FROM dobj2 dobj3 ... TO MEMORY ID <id>.
+ *   IMPORT p1 = dobj1 p2 TO dobj2 dobj3 ... FROM MEMORY ID <id>.
+ * (а также DATABASE, SHARED BUFFER, DATA BUFFER, INTERNAL TABLE).
  *
- * Возвращает AST узел EXPORT или IMPORT с соответствующими параметрами.
+ * Возвращает узел AST_KEYWORD_STATEMENT "EXPORT" или "IMPORT": параметры кластера —
+ * операнды и узлы AST_PARAMETER_BINDING, среда хранения — дополнение.
  */
 ASTNode *parse_special_export_import(TokenStream *ts) {
     if (!ts) {
@@ -167,64 +82,37 @@ ASTNode *parse_special_export_import(TokenStream *ts) {
         return NULL;
     }
 
-    Token *cmd_tok = token_stream_next(ts);
-    if (!cmd_tok || (cmd_tok->type != TOKEN_EXPORT && cmd_tok->type != TOKEN_IMPORT)) {
+    TokenType command = token_stream_peek_type(ts);
+    if (command != TOKEN_KEYWORD_EXPORT && command != TOKEN_KEYWORD_IMPORT) {
         report_error("Expected EXPORT or IMPORT token");
         return NULL;
     }
+    token_stream_advance(ts);
 
-    ASTNode *node = ast_node_create((cmd_tok->type == TOKEN_EXPORT) ? AST_SPECIAL_EXPORT : AST_SPECIAL_IMPORT);
-    if (!node) {
+    ASTNode *node = ast_node_create(AST_KEYWORD_STATEMENT);
+    if (node) node->string_value = ast_strndup(command == TOKEN_KEYWORD_EXPORT ? "EXPORT" : "IMPORT", 6);
+    if (!node || !node->string_value) {
         report_error("Failed to create AST node for EXPORT/IMPORT");
-        return NULL;
-    }
-
-    // Парсим данные после EXPORT/IMPORT — идентификатор или список идентификаторов
-    Token *data_tok = token_stream_next(ts);
-    if (!data_tok || data_tok->type != TOKEN_IDENTIFIER) {
-        report_error("Expected identifier after EXPORT/IMPORT");
-        ast_node_free(node);
-        return NULL;
-    }
-
-    ASTNode *data_node = ast_node_create(AST_IDENTIFIER);
-    data_node->string_value = strdup(data_tok->text);
-    ast_node_add_child(node, data_node);
-
-    // Парсим ключевое слово TO или FROM
-    Token *dir_tok = token_stream_next(ts);
-    if (!dir_tok) {
-        report_error("Expected TO or FROM after EXPORT/IMPORT data");
-        ast_node_free(node);
-        return NULL;
-    }
-
-    if ((cmd_tok->type == TOKEN_EXPORT && dir_tok->type != TOKEN_TO) ||
-        (cmd_tok->type == TOKEN_IMPORT && dir_tok->type != TOKEN_FROM)) {
-        report_error("Expected TO after EXPORT or FROM after IMPORT");
         ast_node_free(node);
         return NULL;
     }
 
-    // Парсим MEMORY
-    Token *mem_tok = token_stream_next(ts);
-    if (!mem_tok || mem_tok->type != TOKEN_MEMORY) {
-        report_error("Expected MEMORY keyword");
-        ast_node_free(node);
-        return NULL;
+    // Параметры кластера до среды хранения
+    int count = sizeof(export_import_clauses) / sizeof(export_import_clauses[0]);
+    TokenType direction = command == TOKEN_KEYWORD_EXPORT ? TOKEN_KEYWORD_FROM : TOKEN_KEYWORD_TO;
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF &&
+                         !parser_peek_clause(ts, export_import_clauses, count); ) {
+        bool binding = type == TOKEN_IDENTIFIER && token_stream_peek_type_at(ts, 1) == TOKEN_OPERATOR_EQ;
+        bool parsed = binding ? parse_bindings(ts, node) : parse_export_import_param(ts, node, direction);
+        if (!parsed) return node;
     }
-
-    // Парсим идентификатор памяти
-    Token *memid_tok = token_stream_next(ts);
-    if (!memid_tok || memid_tok->type != TOKEN_IDENTIFIER) {
-        report_error("Expected memory ID after MEMORY");
-        ast_node_free(node);
-        return NULL;
+    if (node->child_count == 0) {
+        report_error("Expected data cluster parameters after %s", node->string_value);
+        return node;
     }
-
-    ASTNode *memid_node = ast_node_create(AST_IDENTIFIER);
-    memid_node->string_value = strdup(memid_tok->text);
-    ast_node_add_child(node, memid_node);
-
+    if (parser_parse_clauses(ts, node, export_import_clauses, count)) parser_end_statement(ts);
     return node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_EXPORT, TOKEN_UNKNOWN, 0, parse_special_export_import)
+PARSER_STATEMENT(TOKEN_KEYWORD_IMPORT, TOKEN_UNKNOWN, 0, parse_special_export_import)
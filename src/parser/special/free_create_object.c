@@ -2,14 +2,41 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+
+// Дополнения CREATE OBJECT
+static const parser_clause_t create_object_clauses[] = {
+    { "TYPE", PARSER_CLAUSE_OPERAND },
+    { "EXPORTING", PARSER_CLAUSE_BINDINGS },
+    { "EXCEPTIONS", PARSER_CLAUSE_BINDINGS },
+};
+
+// Дополнения CREATE DATA
+static const parser_clause_t create_data_clauses[] = {
+    { "TYPE STANDARD TABLE OF", PARSER_CLAUSE_OPERAND },
+    { "TYPE SORTED TABLE OF", PARSER_CLAUSE_OPERAND },
+    { "TYPE HASHED TABLE OF", PARSER_CLAUSE_OPERAND },
+    { "TYPE TABLE OF", PARSER_CLAUSE_OPERAND },
+    { "TYPE REF TO", PARSER_CLAUSE_OPERAND },
+    { "TYPE LINE OF", PARSER_CLAUSE_OPERAND },
+    { "TYPE", PARSER_CLAUSE_OPERAND },
+    { "LIKE TABLE OF", PARSER_CLAUSE_OPERAND },
+    { "LIKE LINE OF", PARSER_CLAUSE_OPERAND },
+    { "LIKE", PARSER_CLAUSE_OPERAND },
+    { "LENGTH", PARSER_CLAUSE_OPERAND },
+    { "DECIMALS", PARSER_CLAUSE_OPERAND },
+};
 
 /**
- * parse_special_free_create_object - Парсит операторы FREE и CREATE OBJECT.
+ * parse_special_free_create_object - Парсит операторы CREATE OBJECT и CREATE DATA.
  *
- * FREE <variable> - освобождение памяти переменной.
- * CREATE OBJECT <object> [EXPORTING ...] - создание экземпляра объекта.
+ * CREATE OBJECT <oref> [TYPE <class>] [EXPORTING p = a ...] [EXCEPTIONS e = n ...].
+ * CREATE DATA <dref> TYPE | LIKE [REF TO | TABLE OF | LINE OF] <type>.
  *
- * Возвращает AST узел FREE или CREATE_OBJECT с соответствующими дочерними узлами.
+ * FREE лексер оставляет идентификатором, поэтому сюда он не попадает.
+ *
+ * Возвращает узел AST_KEYWORD_STATEMENT "CREATE OBJECT" или "CREATE DATA" (atom —
+ * ссылка, дополнения — потомки).
  */
 ASTNode *parse_special_free_create_object(TokenStream *ts) {
     if (!ts) {
@@ -17,66 +44,18 @@ ASTNode *parse_special_free_create_object(TokenStream *ts) {
         return NULL;
     }
 
-    Token *tok = token_stream_peek(ts);
-    if (!tok) {
-        report_error("Unexpected end of tokens in free_create_object");
-        return NULL;
-    }
-
-    ASTNode *node = NULL;
-
-    if (tok->type == TOKEN_FREE) {
-        token_stream_next(ts); // consume FREE
-        node = ast_node_create(AST_SPECIAL_FREE);
-        if (!node) {
-            report_error("Failed to create AST node for FREE");
-            return NULL;
-        }
-
-        Token *var_tok = token_stream_next(ts);
-        if (!var_tok || var_tok->type != TOKEN_IDENTIFIER) {
-            report_error("Expected identifier after FREE");
-            ast_node_free(node);
-            return NULL;
-        }
-
-        ASTNode *var_node = ast_node_create(AST_IDENTIFIER);
-        var_node->string_value = strdup(var_tok->text);
-        ast_node_add_child(node, var_node);
-
-    } else if (tok->type == TOKEN_CREATE) {
-        token_stream_next(ts); // consume CREATE
-
-        Token *object_tok = token_stream_next(ts);
-        if (!object_tok || object_tok->type != TOKEN_OBJECT) {
-            report_error("Expected OBJECT after CREATE");
-            return NULL;
-        }
+    if (!parser_expect(ts, TOKEN_KEYWORD_CREATE, "CREATE")) return NULL;
 
-        node = ast_node_create(AST_SPECIAL_CREATE_OBJECT);
-        if (!node) {
-            report_error("Failed to create AST node for CREATE OBJECT");
-            return NULL;
-        }
-
-        Token *obj_name_tok = token_stream_next(ts);
-        if (!obj_name_tok || obj_name_tok->type != TOKEN_IDENTIFIER) {
-            report_error("Expected identifier after CREATE OBJECT");
-            ast_node_free(node);
-            return NULL;
-        }
-
-        ASTNode *obj_name_node = ast_node_create(AST_IDENTIFIER);
-        obj_name_node->string_value = strdup(obj_name_tok->text);
-        ast_node_add_child(node, obj_name_node);
-
-        // Можно добавить парсинг опциональных параметров EXPORTING ...
-        // Для упрощения пока пропустим.
-
-    } else {
-        report_error("Expected FREE or CREATE token");
-        return NULL;
+    if (parser_accept_word(ts, "OBJECT")) {
+        return parser_parse_keyword_statement(ts, "CREATE OBJECT", create_object_clauses,
+                                              sizeof(create_object_clauses) / sizeof(create_object_clauses[0]));
     }
-
-    return node;
+    if (parser_accept(ts, TOKEN_KEYWORD_DATA)) {
+        return parser_parse_keyword_statement(ts, "CREATE DATA", create_data_clauses,
+                                              sizeof(create_data_clauses) / sizeof(create_data_clauses[0]));
+    }
+    report_error("Expected OBJECT or DATA after CREATE");
+    return NULL;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_CREATE, TOKEN_UNKNOWN, 0, parse_special_free_create_object)
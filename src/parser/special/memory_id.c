@@ -41,6 +41,6 @@ ASTNode *parse_special_memory_id(TokenStream *ts) {
         return NULL;
     }
 
-    memory_id_node->string_value = strdup(memid_tok->text);
+    memory_id_node->atom = token_atom(memid_tok);
     return memory_id_node;
 }
@@ -2,14 +2,30 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+
+// Дополнения MESSAGE
+static const parser_clause_t message_clauses[] = {
+    { "ID", PARSER_CLAUSE_OPERAND },
+    { "TYPE", PARSER_CLAUSE_OPERAND },
+    { "NUMBER", PARSER_CLAUSE_OPERAND },
+    { "WITH", PARSER_CLAUSE_LIST },
+    { "DISPLAY LIKE", PARSER_CLAUSE_OPERAND },
+    { "INTO", PARSER_CLAUSE_OPERAND },
+    { "RAISING", PARSER_CLAUSE_OPERAND },
+};
 
 /**
  * parse_special_message - Парсит оператор MESSAGE.
  *
- * MESSAGE <msg> TYPE <type> [NUMBER <num>] [WITH <args>] [DISPLAY LIKE <like>]
+ * MESSAGE <tnnn(id)> | <text> | <oref> | ID <id> TYPE <type> NUMBER <num>
+ *         [TYPE <type>] [WITH <args>] [DISPLAY LIKE <like>] [INTO <text>] [RAISING <exc>].
  * Используется для вывода системных сообщений разного типа.
  *
- * Возвращает AST узел MESSAGE с параметрами сообщения.
+ * Короткая форма e001(zmsg) разбирается как функциональный вызов: atom — тип и номер,
+ * аргумент — класс сообщений.
+ *
+ * Возвращает узел AST_KEYWORD_STATEMENT "MESSAGE" с параметрами сообщения.
  */
 ASTNode *parse_special_message(TokenStream *ts) {
     if (!ts) {
@@ -17,100 +33,9 @@ ASTNode *parse_special_message(TokenStream *ts) {
         return NULL;
     }
 
-    Token *msg_tok = token_stream_next(ts);
-    if (!msg_tok || msg_tok->type != TOKEN_MESSAGE) {
-        report_error("Expected MESSAGE token");
-        return NULL;
-    }
-
-    ASTNode *node = ast_node_create(AST_SPECIAL_MESSAGE);
-    if (!node) {
-        report_error("Failed to create AST node for MESSAGE");
-        return NULL;
-    }
-
-    // Ожидаем сообщение - либо литерал, либо идентификатор
-    Token *msg_id_tok = token_stream_next(ts);
-    if (!msg_id_tok || (msg_id_tok->type != TOKEN_LITERAL && msg_id_tok->type != TOKEN_IDENTIFIER)) {
-        report_error("Expected message literal or identifier");
-        ast_node_free(node);
-        return NULL;
-    }
-
-    ASTNode *msg_id_node = ast_node_create(AST_LITERAL);
-    msg_id_node->string_value = strdup(msg_id_tok->text);
-    ast_node_add_child(node, msg_id_node);
-
-    // Парсим опциональные параметры: TYPE, NUMBER, WITH, DISPLAY LIKE
-    while (1) {
-        Token *next_tok = token_stream_peek(ts);
-        if (!next_tok) break;
-
-        if (next_tok->type == TOKEN_TYPE) {
-            token_stream_next(ts); // consume TYPE
-            Token *type_tok = token_stream_next(ts);
-            if (!type_tok || type_tok->type != TOKEN_IDENTIFIER) {
-                report_error("Expected type identifier after TYPE");
-                ast_node_free(node);
-                return NULL;
-            }
-            ASTNode *type_node = ast_node_create(AST_IDENTIFIER);
-            type_node->string_value = strdup(type_tok->text);
-            ast_node_add_child(node, type_node);
-
-        } else if (next_tok->type == TOKEN_NUMBER) {
-            token_stream_next(ts); // consume NUMBER
-            Token *num_tok = token_stream_next(ts);
-            if (!num_tok || num_tok->type != TOKEN_LITERAL) {
-                report_error("Expected literal after NUMBER");
-                ast_node_free(node);
-                return NULL;
-            }
-            ASTNode *num_node = ast_node_create(AST_LITERAL);
-            num_node->string_value = strdup(num_tok->text);
-            ast_node_add_child(node, num_node);
-
-        } else if (next_tok->type == TOKEN_WITH) {
-            token_stream_next(ts); // consume WITH
-            // WITH может иметь несколько аргументов, парсим их пока идентификаторы/литералы
-            ASTNode *with_node = ast_node_create(AST_SPECIAL_MESSAGE_WITH);
-
-            while (1) {
-                Token *arg_tok = token_stream_peek(ts);
-                if (!arg_tok || (arg_tok->type != TOKEN_IDENTIFIER && arg_tok->type != TOKEN_LITERAL)) {
-                    break;
-                }
-                token_stream_next(ts); // consume arg
-                ASTNode *arg_node = ast_node_create(AST_LITERAL);
-                arg_node->string_value = strdup(arg_tok->text);
-                ast_node_add_child(with_node, arg_node);
-            }
-
-            ast_node_add_child(node, with_node);
-
-        } else if (next_tok->type == TOKEN_DISPLAY) {
-            token_stream_next(ts); // consume DISPLAY
-            Token *like_tok = token_stream_next(ts);
-            if (!like_tok || like_tok->type != TOKEN_LIKE) {
-                report_error("Expected LIKE after DISPLAY");
-                ast_node_free(node);
-                return NULL;
-            }
-            Token *style_tok = token_stream_next(ts);
-            if (!style_tok || style_tok->type != TOKEN_IDENTIFIER) {
-                report_error("Expected identifier after LIKE");
-                ast_node_free(node);
-                return NULL;
-            }
-            ASTNode *display_node = ast_node_create(AST_SPECIAL_MESSAGE_DISPLAY);
-            display_node->string_value = strdup(style_tok->text);
-            ast_node_add_child(node, display_node);
-
-        } else {
-            // Нет больше опций
-            break;
-        }
-    }
-
-    return node;
+    if (!parser_expect(ts, TOKEN_KEYWORD_MESSAGE, "MESSAGE")) return NULL;
+    return parser_parse_keyword_statement(ts, "MESSAGE", message_clauses,
+                                          sizeof(message_clauses) / sizeof(message_clauses[0]));
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_MESSAGE, TOKEN_UNKNOWN, 0, parse_special_message)
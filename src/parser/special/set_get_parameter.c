@@ -2,14 +2,36 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
+
+// Дополнения SET PARAMETER
+static const parser_clause_t set_parameter_clauses[] = {
+    { "ID", PARSER_CLAUSE_OPERAND },
+    { "FIELD", PARSER_CLAUSE_OPERAND },
+};
+
+// Дополнения прочих форм SET (PF-STATUS, TITLEBAR, HANDLER, ...)
+static const parser_clause_t set_clauses[] = {
+    { "OF PROGRAM", PARSER_CLAUSE_OPERAND },
+    { "EXCLUDING", PARSER_CLAUSE_LIST },
+    { "WITH", PARSER_CLAUSE_LIST },
+    { "FOR ALL INSTANCES", PARSER_CLAUSE_FLAG },
+    { "FOR", PARSER_CLAUSE_OPERAND },
+    { "ACTIVATION", PARSER_CLAUSE_OPERAND },
+    { "IMMEDIATELY", PARSER_CLAUSE_FLAG },
+};
 
 /**
- * parse_special_set_get_parameter - Парсит операторы SET PARAMETER и GET PARAMETER.
+ * parse_special_set_get_parameter - Парсит оператор SET.
  *
  * SET PARAMETER ID <id> FIELD <field> - установка параметра.
- * GET PARAMETER ID <id> FIELD <field> - получение параметра.
+ * SET <форма> <операнды> [дополнения] - SET PF-STATUS, SET TITLEBAR, SET SCREEN,
+ * SET HANDLER и т.п.: atom — форма, операнды и дополнения — потомки.
+ *
+ * GET лексер оставляет идентификатором, поэтому GET PARAMETER сюда не попадает.
  *
- * Возвращает AST узел SET_PARAMETER или GET_PARAMETER с соответствующими дочерними узлами.
+ * Возвращает узел AST_KEYWORD_STATEMENT "SET PARAMETER" или "SET".
  */
 ASTNode *parse_special_set_get_parameter(TokenStream *ts) {
     if (!ts) {
@@ -17,84 +39,34 @@ ASTNode *parse_special_set_get_parameter(TokenStream *ts) {
         return NULL;
     }
 
-    Token *tok = token_stream_peek(ts);
-    if (!tok) {
-        report_error("Unexpected end of tokens in set_get_parameter");
-        return NULL;
-    }
-
-    ASTNode *node = NULL;
-
-    if (tok->type == TOKEN_SET) {
-        token_stream_next(ts); // consume SET
-        Token *param_tok = token_stream_next(ts);
-        if (!param_tok || param_tok->type != TOKEN_PARAMETER) {
-            report_error("Expected PARAMETER after SET");
-            return NULL;
-        }
-
-        node = ast_node_create(AST_SPECIAL_SET_PARAMETER);
-        if (!node) {
-            report_error("Failed to create AST node for SET PARAMETER");
-            return NULL;
-        }
-
-    } else if (tok->type == TOKEN_GET) {
-        token_stream_next(ts); // consume GET
-        Token *param_tok = token_stream_next(ts);
-        if (!param_tok || param_tok->type != TOKEN_PARAMETER) {
-            report_error("Expected PARAMETER after GET");
-            return NULL;
-        }
-
-        node = ast_node_create(AST_SPECIAL_GET_PARAMETER);
-        if (!node) {
-            report_error("Failed to create AST node for GET PARAMETER");
-            return NULL;
-        }
-
-    } else {
-        report_error("Expected SET or GET token");
-        return NULL;
-    }
+    if (!parser_expect(ts, TOKEN_KEYWORD_SET, "SET")) return NULL;
 
-    // Далее ожидаем ID <id>
-    Token *id_tok = token_stream_next(ts);
-    if (!id_tok || id_tok->type != TOKEN_ID) {
-        report_error("Expected ID after SET/GET PARAMETER");
-        ast_node_free(node);
-        return NULL;
+    if (parser_accept_word(ts, "PARAMETER")) {
+        return parser_parse_keyword_statement(ts, "SET PARAMETER", set_parameter_clauses,
+                                              sizeof(set_parameter_clauses) / sizeof(set_parameter_clauses[0]));
     }
 
-    Token *param_id_tok = token_stream_next(ts);
-    if (!param_id_tok || param_id_tok->type != TOKEN_IDENTIFIER) {
-        report_error("Expected identifier after ID");
+    ASTNode *node = ast_node_create(AST_KEYWORD_STATEMENT);
+    if (node) node->string_value = ast_strndup("SET", 3);
+    if (!node || !node->string_value) {
+        report_error("Failed to create AST node for SET");
         ast_node_free(node);
         return NULL;
     }
-
-    ASTNode *id_node = ast_node_create(AST_IDENTIFIER);
-    id_node->string_value = strdup(param_id_tok->text);
-    ast_node_add_child(node, id_node);
-
-    // Далее ожидаем FIELD <field>
-    Token *field_tok = token_stream_next(ts);
-    if (!field_tok || field_tok->type != TOKEN_FIELD) {
-        report_error("Expected FIELD token");
-        ast_node_free(node);
-        return NULL;
+    if ((node->atom = parse_name(ts)) == ATOM_NONE) {
+        report_error("Expected PARAMETER, PF-STATUS, TITLEBAR or other form after SET");
+        return node;
     }
 
-    Token *field_name_tok = token_stream_next(ts);
-    if (!field_name_tok || field_name_tok->type != TOKEN_IDENTIFIER) {
-        report_error("Expected identifier after FIELD");
-        ast_node_free(node);
-        return NULL;
+    int count = sizeof(set_clauses) / sizeof(set_clauses[0]);
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF &&
+                         !parser_peek_clause(ts, set_clauses, count); ) {
+        ASTNode *operand = parse_expression_prec(ts, PARSER_PREC_CONCAT);
+        if (!operand) return node;
+        ast_node_add_child(node, operand);
     }
-
-    ASTNode *field_node = ast_node_create(AST_IDENTIFIER);
-    field_node->string_value = strdup(field_name_tok->text);
-    ast_node_add_child(node, field_node);
-
+    if (parser_parse_clauses(ts, node, set_clauses, count)) parser_end_statement(ts);
     return node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_SET, TOKEN_UNKNOWN, 0, parse_special_set_get_parameter)
@@ -2,73 +2,39 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 #include <stdlib.h>
 #include <string.h>
 
+// Дополнения DELETE
+static const parser_clause_t delete_clauses[] = {
+    { "ADJACENT DUPLICATES FROM", PARSER_CLAUSE_OPERAND },
+    { "TABLE", PARSER_CLAUSE_OPERAND },
+    { "WITH TABLE KEY", PARSER_CLAUSE_BINDINGS },
+    { "FROM", PARSER_CLAUSE_OPERAND },
+    { "TO", PARSER_CLAUSE_OPERAND },
+    { "INDEX", PARSER_CLAUSE_OPERAND },
+    { "WHERE", PARSER_CLAUSE_OPERAND },
+    { "COMPARING", PARSER_CLAUSE_LIST },
+};
+
 /**
  * parse_table_ops_delete - Парсит инструкцию DELETE для удаления записей из внутренней таблицы.
  *
+ * DELETE itab [INDEX idx | FROM n TO m | WHERE cond].
+ * DELETE TABLE itab FROM wa | WITH TABLE KEY k = v ... .
+ * DELETE ADJACENT DUPLICATES FROM itab [COMPARING f1 f2 ...].
+ * DELETE dbtab FROM wa | FROM TABLE itab.
+ *
  * Ожидается, что ключевое слово DELETE уже прочитано.
- * Возвращает AST узел DELETE или NULL при ошибке.
+ * Возвращает узел AST_KEYWORD_STATEMENT "DELETE" (главный операнд и дополнения) или NULL при ошибке.
  */
 ASTNode *parse_table_ops_delete(TokenStream *ts) {
     if (!ts) {
         report_error("TokenStream is NULL in parse_table_ops_delete");
         return NULL;
     }
-
-    ASTNode *delete_node = ast_node_create(AST_DELETE);
-    if (!delete_node) {
-        report_error("Failed to allocate AST node for DELETE");
-        return NULL;
-    }
-
-    // Ожидается имя таблицы
-    Token *table_tok = token_stream_next(ts);
-    if (!table_tok || table_tok->type != TOKEN_IDENTIFIER) {
-        report_error("Expected table name after DELETE");
-        ast_node_free(delete_node);
-        return NULL;
-    }
-
-    delete_node->string_value = strdup(table_tok->text);
-    if (!delete_node->string_value) {
-        report_error("Failed to allocate memory for table name in DELETE");
-        ast_node_free(delete_node);
-        return NULL;
-    }
-
-    // Опционально: WHERE <условие> или INDEX <число>
-    Token *next_tok = token_stream_peek(ts);
-    if (next_tok && (next_tok->type == TOKEN_WHERE || next_tok->type == TOKEN_INDEX)) {
-        token_stream_next(ts); // consume WHERE/INDEX
-
-        Token *cond_tok = token_stream_next(ts);
-        if (!cond_tok) {
-            report_error("Expected condition or index after WHERE/INDEX");
-            ast_node_free(delete_node);
-            return NULL;
-        }
-
-        ASTNode *cond_node = ast_node_create(
-            next_tok->type == TOKEN_WHERE ? AST_WHERE_CONDITION : AST_INDEX
-        );
-        if (!cond_node) {
-            report_error("Failed to allocate AST node for DELETE condition/index");
-            ast_node_free(delete_node);
-            return NULL;
-        }
-
-        cond_node->string_value = strdup(cond_tok->text);
-        if (!cond_node->string_value) {
-            report_error("Failed to allocate memory for DELETE condition/index value");
-            ast_node_free(delete_node);
-            ast_node_free(cond_node);
-            return NULL;
-        }
-
-        ast_node_add_child(delete_node, cond_node);
-    }
-
-    return delete_node;
+    return parser_parse_keyword_statement(ts, "DELETE", delete_clauses, sizeof(delete_clauses) / sizeof(delete_clauses[0]));
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_DELETE, TOKEN_UNKNOWN, 1, parse_table_ops_delete)
@@ -2,78 +2,41 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 #include <stdlib.h>
 #include <string.h>
 
+// Дополнения INSERT
+static const parser_clause_t insert_clauses[] = {
+    { "INITIAL LINE", PARSER_CLAUSE_FLAG },
+    { "LINES OF", PARSER_CLAUSE_OPERAND },
+    { "INTO TABLE", PARSER_CLAUSE_OPERAND },
+    { "INTO", PARSER_CLAUSE_OPERAND },
+    { "INDEX", PARSER_CLAUSE_OPERAND },
+    { "FROM TABLE", PARSER_CLAUSE_OPERAND },
+    { "FROM", PARSER_CLAUSE_OPERAND },
+    { "TO", PARSER_CLAUSE_OPERAND },
+    { "ASSIGNING", PARSER_CLAUSE_OPERAND },
+    { "REFERENCE INTO", PARSER_CLAUSE_OPERAND },
+    { "ACCEPTING DUPLICATE KEYS", PARSER_CLAUSE_FLAG },
+};
+
 /**
  * parse_table_ops_insert - Парсит конструкцию INSERT для вставки записи во внутреннюю таблицу.
  *
+ * INSERT wa | INITIAL LINE | LINES OF jtab [FROM n] [TO n] INTO [TABLE] itab [INDEX idx]
+ *        [ASSIGNING <fs> | REFERENCE INTO dref].
+ * INSERT dbtab FROM wa | FROM TABLE itab [ACCEPTING DUPLICATE KEYS].
+ *
  * Ожидается, что ключевое слово INSERT уже прочитано.
- * Возвращает AST узел INSERT или NULL при ошибке.
+ * Возвращает узел AST_KEYWORD_STATEMENT "INSERT" (главный операнд и дополнения) или NULL при ошибке.
  */
 ASTNode *parse_table_ops_insert(TokenStream *ts) {
     if (!ts) {
         report_error("TokenStream is NULL in parse_table_ops_insert");
         return NULL;
     }
-
-    ASTNode *insert_node = ast_node_create(AST_INSERT);
-    if (!insert_node) {
-        report_error("Failed to allocate AST node for INSERT");
-        return NULL;
-    }
-
-    // Ожидаем запись или переменную, которую нужно вставить
-    Token *record_tok = token_stream_next(ts);
-    if (!record_tok) {
-        report_error("Expected record identifier after INSERT");
-        ast_node_free(insert_node);
-        return NULL;
-    }
-
-    if (record_tok->type != TOKEN_IDENTIFIER) {
-        report_error("Expected identifier after INSERT");
-        ast_node_free(insert_node);
-        return NULL;
-    }
-
-    insert_node->string_value = strdup(record_tok->text);
-    if (!insert_node->string_value) {
-        report_error("Failed to allocate memory for INSERT record identifier");
-        ast_node_free(insert_node);
-        return NULL;
-    }
-
-    // Опционально: ожидаем ключевые слова TO, INDEX, или POSITION, указывающие место вставки
-    Token *next_tok = token_stream_peek(ts);
-    if (next_tok && (next_tok->type == TOKEN_TO || next_tok->type == TOKEN_INDEX || next_tok->type == TOKEN_POSITION)) {
-        token_stream_next(ts);  // consume TO/INDEX/POSITION
-
-        // Ожидаем либо имя таблицы, либо индекс
-        Token *pos_tok = token_stream_next(ts);
-        if (!pos_tok) {
-            report_error("Expected position or table identifier after TO/INDEX/POSITION in INSERT");
-            ast_node_free(insert_node);
-            return NULL;
-        }
-
-        ASTNode *pos_node = ast_node_create(AST_INSERT_POSITION);
-        if (!pos_node) {
-            report_error("Failed to allocate AST node for INSERT position");
-            ast_node_free(insert_node);
-            return NULL;
-        }
-
-        pos_node->string_value = strdup(pos_tok->text);
-        if (!pos_node->string_value) {
-            report_error("Failed to allocate memory for INSERT position");
-            ast_node_free(insert_node);
-            ast_node_free(pos_node);
-            return NULL;
-        }
-
-        ast_node_add_child(insert_node, pos_node);
-    }
-
-    return insert_node;
+    return parser_parse_keyword_statement(ts, "INSERT", insert_clauses, sizeof(insert_clauses) / sizeof(insert_clauses[0]));
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_INSERT, TOKEN_UNKNOWN, 1, parse_table_ops_insert)
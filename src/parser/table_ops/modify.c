@@ -2,71 +2,38 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 #include <stdlib.h>
 #include <string.h>
 
+// Дополнения MODIFY
+static const parser_clause_t modify_clauses[] = {
+    { "TABLE", PARSER_CLAUSE_OPERAND },
+    { "FROM TABLE", PARSER_CLAUSE_OPERAND },
+    { "FROM", PARSER_CLAUSE_OPERAND },
+    { "INDEX", PARSER_CLAUSE_OPERAND },
+    { "TRANSPORTING", PARSER_CLAUSE_LIST },
+    { "WHERE", PARSER_CLAUSE_OPERAND },
+    { "ASSIGNING", PARSER_CLAUSE_OPERAND },
+    { "REFERENCE INTO", PARSER_CLAUSE_OPERAND },
+};
+
 /**
  * parse_table_ops_modify - Парсит инструкцию MODIFY для изменения записи во внутренней таблице.
  *
+ * MODIFY itab FROM wa [INDEX idx] [TRANSPORTING f1 f2 ...] [WHERE cond].
+ * MODIFY TABLE itab FROM wa [TRANSPORTING ...] [ASSIGNING <fs> | REFERENCE INTO dref].
+ * MODIFY dbtab FROM wa | FROM TABLE itab.
+ *
  * Ожидается, что ключевое слово MODIFY уже прочитано.
- * Возвращает AST узел MODIFY или NULL при ошибке.
+ * Возвращает узел AST_KEYWORD_STATEMENT "MODIFY" (главный операнд и дополнения) или NULL при ошибке.
  */
 ASTNode *parse_table_ops_modify(TokenStream *ts) {
     if (!ts) {
         report_error("TokenStream is NULL in parse_table_ops_modify");
         return NULL;
     }
-
-    ASTNode *modify_node = ast_node_create(AST_MODIFY);
-    if (!modify_node) {
-        report_error("Failed to allocate AST node for MODIFY");
-        return NULL;
-    }
-
-    // Ожидается имя таблицы
-    Token *table_tok = token_stream_next(ts);
-    if (!table_tok || table_tok->type != TOKEN_IDENTIFIER) {
-        report_error("Expected table name after MODIFY");
-        ast_node_free(modify_node);
-        return NULL;
-    }
-
-    modify_node->string_value = strdup(table_tok->text);
-    if (!modify_node->string_value) {
-        report_error("Failed to allocate memory for MODIFY table name");
-        ast_node_free(modify_node);
-        return NULL;
-    }
-
-    // Опционально: FROM <источник>
-    Token *next_tok = token_stream_peek(ts);
-    if (next_tok && next_tok->type == TOKEN_FROM) {
-        token_stream_next(ts); // consume FROM
-
-        Token *source_tok = token_stream_next(ts);
-        if (!source_tok || source_tok->type != TOKEN_IDENTIFIER) {
-            report_error("Expected source identifier after FROM in MODIFY");
-            ast_node_free(modify_node);
-            return NULL;
-        }
-
-        ASTNode *from_node = ast_node_create(AST_FROM);
-        if (!from_node) {
-            report_error("Failed to allocate AST node for FROM in MODIFY");
-            ast_node_free(modify_node);
-            return NULL;
-        }
-
-        from_node->string_value = strdup(source_tok->text);
-        if (!from_node->string_value) {
-            report_error("Failed to allocate memory for FROM source");
-            ast_node_free(modify_node);
-            ast_node_free(from_node);
-            return NULL;
-        }
-
-        ast_node_add_child(modify_node, from_node);
-    }
-
-    return modify_node;
+    return parser_parse_keyword_statement(ts, "MODIFY", modify_clauses, sizeof(modify_clauses) / sizeof(modify_clauses[0]));
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_MODIFY, TOKEN_UNKNOWN, 1, parse_table_ops_modify)
@@ -2,121 +2,41 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
 #include <stdlib.h>
 #include <string.h>
 
+// Дополнения READ TABLE
+static const parser_clause_t read_clauses[] = {
+    { "INDEX", PARSER_CLAUSE_OPERAND },
+    { "WITH TABLE KEY", PARSER_CLAUSE_BINDINGS },
+    { "WITH KEY", PARSER_CLAUSE_BINDINGS },
+    { "FROM", PARSER_CLAUSE_OPERAND },
+    { "INTO", PARSER_CLAUSE_OPERAND },
+    { "ASSIGNING", PARSER_CLAUSE_OPERAND },
+    { "REFERENCE INTO", PARSER_CLAUSE_OPERAND },
+    { "TRANSPORTING NO FIELDS", PARSER_CLAUSE_FLAG },
+    { "TRANSPORTING", PARSER_CLAUSE_LIST },
+    { "BINARY SEARCH", PARSER_CLAUSE_FLAG },
+    { "COMPARING", PARSER_CLAUSE_LIST },
+};
+
 /**
  * parse_table_ops_read - Парсит инструкцию READ TABLE для чтения строки из внутренней таблицы.
  *
+ * READ TABLE itab INDEX idx | WITH [TABLE] KEY k = v ... | FROM wa
+ *      INTO wa | ASSIGNING <fs> | REFERENCE INTO dref | TRANSPORTING NO FIELDS
+ *      [BINARY SEARCH] [COMPARING f1 f2 ...] [TRANSPORTING f1 f2 ...].
+ *
  * Ожидается, что ключевые слова READ TABLE уже были прочитаны.
- * Возвращает AST узел READ или NULL при ошибке.
+ * Возвращает узел AST_KEYWORD_STATEMENT "READ TABLE" (главный операнд и дополнения) или NULL при ошибке.
  */
 ASTNode *parse_table_ops_read(TokenStream *ts) {
     if (!ts) {
         report_error("TokenStream is NULL in parse_table_ops_read");
         return NULL;
     }
-
-    ASTNode *read_node = ast_node_create(AST_READ);
-    if (!read_node) {
-        report_error("Failed to allocate AST node for READ");
-        return NULL;
-    }
-
-    // Ожидается имя таблицы
-    Token *table_tok = token_stream_next(ts);
-    if (!table_tok || table_tok->type != TOKEN_IDENTIFIER) {
-        report_error("Expected table name after READ TABLE");
-        ast_node_free(read_node);
-        return NULL;
-    }
-
-    read_node->string_value = strdup(table_tok->text);
-    if (!read_node->string_value) {
-        report_error("Failed to allocate memory for table name in READ");
-        ast_node_free(read_node);
-        return NULL;
-    }
-
-    // Опционально: WITH KEY <условие>
-    Token *next_tok = token_stream_peek(ts);
-    if (next_tok && next_tok->type == TOKEN_WITH) {
-        token_stream_next(ts); // consume WITH
-
-        Token *key_tok = token_stream_next(ts);
-        if (!key_tok || key_tok->type != TOKEN_KEY) {
-            report_error("Expected KEY after WITH in READ TABLE");
-            ast_node_free(read_node);
-            return NULL;
-        }
-
-        ASTNode *key_node = ast_node_create(AST_KEY);
-        if (!key_node) {
-            report_error("Failed to allocate AST node for READ KEY");
-            ast_node_free(read_node);
-            return NULL;
-        }
-
-        // Читаем выражение ключа до конца строки или до слова INTO
-        Token *expr_tok;
-        while ((expr_tok = token_stream_peek(ts)) &&
-               expr_tok->type != TOKEN_INTO &&
-               expr_tok->type != TOKEN_SEMICOLON &&
-               expr_tok->type != TOKEN_END) {
-            expr_tok = token_stream_next(ts);
-
-            ASTNode *expr_node = ast_node_create(AST_EXPRESSION_TOKEN);
-            if (!expr_node) {
-                report_error("Failed to allocate AST node for expression token in READ KEY");
-                ast_node_free(read_node);
-                ast_node_free(key_node);
-                return NULL;
-            }
-
-            expr_node->string_value = strdup(expr_tok->text);
-            if (!expr_node->string_value) {
-                report_error("Failed to allocate memory for expression token");
-                ast_node_free(read_node);
-                ast_node_free(key_node);
-                ast_node_free(expr_node);
-                return NULL;
-            }
-
-            ast_node_add_child(key_node, expr_node);
-        }
-
-        ast_node_add_child(read_node, key_node);
-    }
-
-    // Опционально: INTO <переменная>
-    next_tok = token_stream_peek(ts);
-    if (next_tok && next_tok->type == TOKEN_INTO) {
-        token_stream_next(ts); // consume INTO
-
-        Token *var_tok = token_stream_next(ts);
-        if (!var_tok || var_tok->type != TOKEN_IDENTIFIER) {
-            report_error("Expected identifier after INTO in READ TABLE");
-            ast_node_free(read_node);
-            return NULL;
-        }
-
-        ASTNode *into_node = ast_node_create(AST_INTO);
-        if (!into_node) {
-            report_error("Failed to allocate AST node for INTO in READ");
-            ast_node_free(read_node);
-            return NULL;
-        }
-
-        into_node->string_value = strdup(var_tok->text);
-        if (!into_node->string_value) {
-            report_error("Failed to allocate memory for INTO variable");
-            ast_node_free(read_node);
-            ast_node_free(into_node);
-            return NULL;
-        }
-
-        ast_node_add_child(read_node, into_node);
-    }
-
-    return read_node;
+    return parser_parse_keyword_statement(ts, "READ TABLE", read_clauses, sizeof(read_clauses) / sizeof(read_clauses[0]));
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_READ, TOKEN_KEYWORD_TABLE, 2, parse_table_ops_read)
@@ -2,14 +2,21 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
  * parse_table_ops_sort - Парсит инструкцию SORT для сортировки внутренней таблицы.
  *
+ * SORT itab [STABLE] [ASCENDING | DESCENDING] [AS TEXT]
+ *      [BY c1 [ASCENDING | DESCENDING] [AS TEXT] c2 ...].
+ *
  * Ожидается, что ключевое слово SORT уже прочитано.
- * Возвращает AST узел SORT или NULL при ошибке.
+ * Возвращает узел AST_KEYWORD_STATEMENT "SORT": atom и первый потомок — таблица,
+ * направление и STABLE — дополнения без операндов, поля — дополнение "BY"
+ * (направление отдельных полей в дерево не попадает).
  */
 ASTNode *parse_table_ops_sort(TokenStream *ts) {
     if (!ts) {
@@ -17,66 +24,67 @@ ASTNode *parse_table_ops_sort(TokenStream *ts) {
         return NULL;
     }
 
-    ASTNode *sort_node = ast_node_create(AST_SORT);
-    if (!sort_node) {
+    ASTNode *sort_node = ast_node_create(AST_KEYWORD_STATEMENT);
+    ASTNode *table = ast_node_create(AST_IDENTIFIER);
+    if (sort_node) sort_node->string_value = ast_strndup("SORT", 4);
+    if (!sort_node || !table || !sort_node->string_value) {
         report_error("Failed to allocate AST node for SORT");
+        ast_node_free(sort_node);
+        ast_node_free(table);
         return NULL;
     }
+    ast_node_add_child(sort_node, table);
 
     // Ожидается имя таблицы
-    Token *table_tok = token_stream_next(ts);
-    if (!table_tok || table_tok->type != TOKEN_IDENTIFIER) {
+    if ((sort_node->atom = table->atom = parse_name(ts)) == ATOM_NONE) {
         report_error("Expected table name after SORT");
-        ast_node_free(sort_node);
-        return NULL;
+        return sort_node;
     }
 
-    sort_node->string_value = strdup(table_tok->text);
-    if (!sort_node->string_value) {
-        report_error("Failed to allocate memory for table name in SORT");
-        ast_node_free(sort_node);
-        return NULL;
-    }
-
-    // Опционально: BY <field1> <field2> ...
-    Token *next_tok = token_stream_peek(ts);
-    if (next_tok && next_tok->type == TOKEN_BY) {
-        token_stream_next(ts); // consume BY
-
-        ASTNode *by_node = ast_node_create(AST_SORT_BY);
-        if (!by_node) {
-            report_error("Failed to allocate AST node for SORT BY");
-            ast_node_free(sort_node);
-            return NULL;
-        }
-
-        Token *field_tok;
-        while ((field_tok = token_stream_peek(ts)) &&
-               field_tok->type == TOKEN_IDENTIFIER) {
-            field_tok = token_stream_next(ts);
-
-            ASTNode *field_node = ast_node_create(AST_IDENTIFIER);
-            if (!field_node) {
-                report_error("Failed to allocate AST node for sort field");
-                ast_node_free(sort_node);
-                ast_node_free(by_node);
-                return NULL;
+    for (TokenType type; (type = token_stream_peek_type(ts)) != TOKEN_PUNCTUATION_DOT && type != TOKEN_EOF; ) {
+        const char *flag = NULL;
+        if (parser_accept_word(ts, "STABLE")) {
+            flag = "STABLE";
+        } else if (parser_accept_word(ts, "ASCENDING")) {
+            flag = "ASCENDING";
+        } else if (parser_accept_word(ts, "DESCENDING")) {
+            flag = "DESCENDING";
+        } else if (parser_accept_word(ts, "AS")) {
+            if (!parser_accept_word(ts, "TEXT")) {
+                report_error("Expected TEXT after AS");
+                return sort_node;
             }
-
-            field_node->string_value = strdup(field_tok->text);
-            if (!field_node->string_value) {
-                report_error("Failed to allocate memory for sort field name");
-                ast_node_free(sort_node);
-                ast_node_free(by_node);
-                ast_node_free(field_node);
-                return NULL;
+            flag = "AS TEXT";
+        } else if (parser_accept(ts, TOKEN_KEYWORD_BY)) {
+            ASTNode *by = parser_add_clause(sort_node, "BY");
+            if (!by) return sort_node;
+            while (token_stream_peek_type(ts) == TOKEN_IDENTIFIER || token_stream_peek_type(ts) == TOKEN_OPERATOR_LT) {
+                if (parser_accept_word(ts, "ASCENDING") || parser_accept_word(ts, "DESCENDING")) continue;
+                if (parser_accept_word(ts, "AS")) {
+                    parser_accept_word(ts, "TEXT");
+                    continue;
+                }
+                ASTNode *field = ast_node_create(AST_IDENTIFIER);
+                if (!field) {
+                    report_error("Failed to allocate AST node for sort field");
+                    return sort_node;
+                }
+                field->atom = parse_name(ts);
+                ast_node_add_child(by, field);
             }
-
-            ast_node_add_child(by_node, field_node);
+            if (by->child_count == 0) {
+                report_error("Expected field name after SORT ... BY");
+                return sort_node;
+            }
+            continue;
+        } else {
+            report_error("Unexpected token in SORT statement");
+            return sort_node;
         }
-
-        ast_node_add_child(sort_node, by_node);
+        if (!parser_add_clause(sort_node, flag)) return sort_node;
     }
-
+    parser_end_statement(ts);
     return sort_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_SORT, TOKEN_UNKNOWN, 1, parse_table_ops_sort)
@@ -31,12 +31,7 @@ ASTNode *parse_catch_block(TokenStream *ts) {
         return NULL;
     }
 
-    catch_node->string_value = strdup(ex_token->text);
-    if (!catch_node->string_value) {
-        report_error("Failed to allocate memory for exception identifier");
-        ast_node_free(catch_node);
-        return NULL;
-    }
+    catch_node->atom = token_atom(ex_token);
 
     // Парсим тело CATCH до следующего CATCH или ENDTRY
     while (1) {
@@ -2,135 +2,86 @@
 #include "../../include/token.h"
 #include "../../include/ast.h"
 #include "../../include/error.h"
+#include "../../include/parser_dispatch.h"
+#include "../../include/parser_expression.h"
 #include <stdlib.h>
 
+// Слова, которыми кончаются тело TRY и ветви CATCH и CLEANUP
+static const TokenType try_block_ends[] = {
+    TOKEN_KEYWORD_CATCH, TOKEN_KEYWORD_CLEANUP, TOKEN_KEYWORD_ENDTRY
+};
+
+// Заголовок CATCH после самого слова: [BEFORE UNWIND] cx_a cx_b ... [INTO oref].
+static bool parse_catch_header(TokenStream *ts, ASTNode *catch_node) {
+    if (parser_accept_word(ts, "BEFORE") && !parser_accept_word(ts, "UNWIND")) {
+        report_error("Expected UNWIND after CATCH BEFORE");
+        return false;
+    }
+    while (token_stream_peek_type(ts) == TOKEN_IDENTIFIER) {
+        ASTNode *exception = ast_node_create(AST_IDENTIFIER);
+        if (!exception) {
+            report_error("Failed to allocate AST node for exception class");
+            return false;
+        }
+        exception->atom = parse_name(ts);
+        ast_node_add_child(catch_node, exception);
+    }
+    if (catch_node->child_count == 0) {
+        report_error("Expected exception class after CATCH");
+        return false;
+    }
+    if (parser_accept(ts, TOKEN_KEYWORD_INTO) && !parser_parse_clause(ts, catch_node, "INTO")) return false;
+    return parser_end_statement(ts);
+}
+
 /**
- * parse_simple_try - Парсит простой блок TRY...CATCH...ENDTRY.
+ * parse_simple_try - Парсит блок TRY...CATCH...CLEANUP...ENDTRY.
  *
- * Обрабатывает TRY-блок, содержащий операторы,
- * и CATCH-блоки с обработчиками исключений.
+ * Потомки узла AST_TRY — операторы тела, затем ветви AST_CATCH (классы исключений
+ * узлами AST_IDENTIFIER, дополнение INTO, операторы) и не более одной AST_CLEANUP
+ * (дополнение INTO не разбирается: у CLEANUP его нет).
  *
  * Возвращает AST узел TRY или NULL при ошибке.
  */
-
 ASTNode *parse_simple_try(TokenStream *ts) {
     if (!ts) {
         report_error("TokenStream is NULL in parse_simple_try");
         return NULL;
     }
 
-    // Ожидается ключевое слово TRY уже прочитано
+    // Ключевое слово TRY поглощено диспетчером
     ASTNode *try_node = ast_node_create(AST_TRY);
     if (!try_node) {
         report_error("Failed to allocate AST node for TRY");
         return NULL;
     }
-
-    // Парсим тело TRY до CATCH или ENDTRY
-    while (1) {
-        Token *next_token = token_stream_peek(ts);
-        if (!next_token) {
-            report_error("Unexpected end of tokens inside TRY block");
-            ast_node_free(try_node);
-            return NULL;
+    if (!parser_end_statement(ts)) return try_node;
+
+    ASTNode *branch = try_node;
+    for (;;) {
+        if (!parser_parse_block(ts, branch, try_block_ends, 3, "ENDTRY")) return try_node;
+        TokenType type = token_stream_peek_type(ts);
+        if (type == TOKEN_KEYWORD_ENDTRY) break;
+        if (branch->type == AST_CLEANUP) {
+            report_error("Expected ENDTRY after CLEANUP");
+            return try_node;
         }
+        token_stream_advance(ts); // CATCH / CLEANUP
 
-        if (next_token->type == TOKEN_CATCH || next_token->type == TOKEN_ENDTRY) {
-            break;
+        branch = ast_node_create(type == TOKEN_KEYWORD_CATCH ? AST_CATCH : AST_CLEANUP);
+        if (!branch) {
+            report_error("Failed to allocate AST node for TRY branch");
+            return try_node;
         }
-
-        ASTNode *stmt = parse_statement(ts);
-        if (!stmt) {
-            report_error("Failed to parse statement inside TRY block");
-            ast_node_free(try_node);
-            return NULL;
-        }
-
-        ast_node_add_child(try_node, stmt);
-    }
-
-    // Парсим CATCH-блоки, если есть
-    while (1) {
-        Token *next_token = token_stream_peek(ts);
-        if (!next_token) {
-            report_error("Unexpected end of tokens inside TRY");
-            ast_node_free(try_node);
-            return NULL;
-        }
-
-        if (next_token->type == TOKEN_CATCH) {
-            token_stream_next(ts); // consume CATCH
-
-            // Ожидается идентификатор исключения
-            Token *ex_token = token_stream_next(ts);
-            if (!ex_token || ex_token->type != TOKEN_IDENTIFIER) {
-                report_error("Expected exception identifier after CATCH");
-                ast_node_free(try_node);
-                return NULL;
-            }
-
-            ASTNode *catch_node = ast_node_create(AST_CATCH);
-            if (!catch_node) {
-                report_error("Failed to allocate AST node for CATCH");
-                ast_node_free(try_node);
-                return NULL;
-            }
-
-            catch_node->string_value = strdup(ex_token->text);
-            if (!catch_node->string_value) {
-                report_error("Failed to allocate memory for exception identifier");
-                ast_node_free(catch_node);
-                ast_node_free(try_node);
-                return NULL;
-            }
-
-            // Парсим тело CATCH до следующего CATCH или ENDTRY
-            while (1) {
-                Token *peek = token_stream_peek(ts);
-                if (!peek) {
-                    report_error("Unexpected end of tokens inside CATCH block");
-                    ast_node_free(catch_node);
-                    ast_node_free(try_node);
-                    return NULL;
-                }
-
-                if (peek->type == TOKEN_CATCH || peek->type == TOKEN_ENDTRY) {
-                    break;
-                }
-
-                ASTNode *stmt = parse_statement(ts);
-                if (!stmt) {
-                    report_error("Failed to parse statement inside CATCH block");
-                    ast_node_free(catch_node);
-                    ast_node_free(try_node);
-                    return NULL;
-                }
-
-                ast_node_add_child(catch_node, stmt);
-            }
-
-            ast_node_add_child(try_node, catch_node);
-        }
-        else {
-            break; // нет больше CATCH-блоков
-        }
-    }
-
-    // Ожидается ENDTRY
-    Token *endtry = token_stream_next(ts);
-    if (!endtry || endtry->type != TOKEN_ENDTRY) {
-        report_error("Expected ENDTRY after TRY/CATCH blocks");
-        ast_node_free(try_node);
-        return NULL;
-    }
-
-    // Точка после ENDTRY
-    Token *dot = token_stream_next(ts);
-    if (!dot || dot->type != TOKEN_DOT) {
-        report_error("Expected '.' after ENDTRY");
-        ast_node_free(try_node);
-        return NULL;
+        ast_node_add_child(try_node, branch);
+        bool header = type == TOKEN_KEYWORD_CATCH ? parse_catch_header(ts, branch)
+                                                  : parser_end_statement(ts);
+        if (!header) return try_node;
     }
 
+    token_stream_advance(ts); // ENDTRY
+    parser_end_statement(ts);
     return try_node;
 }
+
+PARSER_STATEMENT(TOKEN_KEYWORD_TRY, TOKEN_UNKNOWN, 1, parse_simple_try)
@@ -0,0 +1,763 @@
+#include "class_summary.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @file class_summary.c
+ * @brief Запись сводок сигнатур классов и интерфейсов и загрузка через mmap.
+ *
+ * Секции файла идут за заголовком в порядке: раскладки, компоненты структур,
+ * компоненты класса, параметры методов, пул значений, таблица имён. Каждая
+ * начинается с границы 8 байт. Раскладки ссылаются друг на друга индексами,
+ * поэтому общий тип (структура, на которую ссылаются атрибут и параметр) хранится
+ * один раз; компоненты одной структуры лежат подряд.
+ */
+
+#define CLASS_SUMMARY_MAGIC      "ABAPSIG"      // 7 символов и завершающий ноль — 8 байт
+#define CLASS_SUMMARY_VERSION    1u
+#define CLASS_SUMMARY_BYTE_ORDER 0x01020304u    // Файл с другим порядком байт читается как промах
+#define CLASS_SUMMARY_ALIGN      8u
+
+#define CLASS_SUMMARY_DEEP       0x01u          // Флаги раскладки
+#define CLASS_SUMMARY_CYCLIC     0x02u
+
+// Заголовок файла; смещения секций — от начала файла
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t kind;              // class_summary_kind_t
+    uint32_t name;              // Индекс имени класса
+    uint64_t source_hash;
+    uint32_t name_count;        // Имена 1..name_count; индекс 0 — ATOM_NONE
+    uint32_t type_count;
+    uint32_t field_count;
+    uint32_t component_count;
+    uint32_t param_count;
+    uint32_t reserved;
+    uint64_t values_length;     // Байт в пуле значений (первый — пустая строка)
+    uint64_t names_length;      // Байт текста имён
+    uint64_t types_offset;      // class_summary_type_t[type_count]
+    uint64_t fields_offset;     // class_summary_field_t[field_count]
+    uint64_t components_offset; // class_summary_component_t[component_count]
+    uint64_t params_offset;     // class_summary_param_t[param_count]
+    uint64_t values_offset;     // char[values_length]
+    uint64_t names_offset;      // uint32_t[name_count + 1] — границы имён, затем текст
+} class_summary_header_t;
+
+// Раскладка в файле (TypeInfo без указателей)
+typedef struct {
+    uint64_t size;
+    uint64_t align;
+    uint32_t name;              // Индекс имени
+    uint8_t kind;               // type_kind_t
+    uint8_t elementary;         // type_elementary_t
+    uint8_t flags;              // CLASS_SUMMARY_DEEP, CLASS_SUMMARY_CYCLIC
+    uint8_t reserved;
+    uint32_t length;
+    uint32_t decimals;
+    uint32_t first_field;       // Компоненты структуры: fields[first_field, + field_count)
+    uint32_t field_count;
+    uint32_t line;              // Индекс типа строки таблицы или типа по ссылке
+    uint32_t reserved2;
+} class_summary_type_t;
+
+// Компонент структуры в файле
+typedef struct {
+    uint64_t offset;
+    uint32_t name;
+    uint32_t type;
+} class_summary_field_t;
+
+bool class_summary_path(char *out, size_t size, const char *dir, atom_t name) {
+    if (name == ATOM_NONE) return false;
+    int written = snprintf(out, size, "%s/", dir);
+    if (written <= 0 || (size_t)written >= size) return false;
+    size_t used = (size_t)written;
+    const char *text = atom_text(name);
+    size_t length = atom_length(name);
+    if (used + length + sizeof(".sig") > size) return false;
+    for (size_t i = 0; i < length; i++) out[used++] = text[i] == '/' ? '#' : text[i];
+    memcpy(out + used, ".sig", sizeof(".sig"));
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Запись
+
+// Таблицы сводки, собираемые перед записью
+typedef struct {
+    uint32_t *local;                    // Атом процесса → индекс имени
+    size_t atom_limit;                  // atom_count() при начале записи
+    atom_t *names;
+    uint32_t name_count;
+    uint32_t name_capacity;
+    uint64_t names_length;
+    const TypeInfo **type_of;           // Раскладка процесса для каждой записи types
+    class_summary_type_t *types;
+    uint32_t type_count;
+    uint32_t type_capacity;
+    class_summary_field_t *fields;
+    uint32_t field_count;
+    uint32_t field_capacity;
+    class_summary_component_t *components;
+    uint32_t component_count;
+    uint32_t component_capacity;
+    class_summary_param_t *params;
+    uint32_t param_count;
+    uint32_t param_capacity;
+    char *values;
+    size_t values_length;
+    size_t values_capacity;
+    bool failed;
+} class_summary_writer_t;
+
+// Место под needed элементов массива; при нехватке памяти выставляет writer->failed
+static bool class_summary_reserve(class_summary_writer_t *writer, void **items, uint32_t *capacity,
+                                  uint64_t needed, size_t item_size) {
+    if (writer->failed) return false;
+    if (needed <= *capacity) return true;
+    uint64_t grown = *capacity ? (uint64_t)*capacity * 2 : 16;
+    while (grown < needed) grown *= 2;
+    void *resized = grown <= UINT32_MAX ? realloc(*items, (size_t)grown * item_size) : NULL;
+    if (!resized) {
+        writer->failed = true;
+        return false;
+    }
+    *items = resized;
+    *capacity = (uint32_t)grown;
+    return true;
+}
+
+static uint32_t class_summary_add_name(class_summary_writer_t *writer, atom_t atom) {
+    if (atom == ATOM_NONE || writer->failed) return 0;
+    if (atom > writer->atom_limit) {
+        writer->failed = true;      // Атом не из этой таблицы
+        return 0;
+    }
+    if (writer->local[atom]) return writer->local[atom];
+    if (!class_summary_reserve(writer, (void **)&writer->names, &writer->name_capacity,
+                               (uint64_t)writer->name_count + 1, sizeof(atom_t))) {
+        return 0;
+    }
+    writer->names[writer->name_count++] = atom;
+    writer->names_length += atom_length(atom);
+    writer->local[atom] = writer->name_count;
+    return writer->name_count;
+}
+
+// Текст в пул значений; смещение 0 занято пустой строкой и означает «нет значения»
+static uint32_t class_summary_add_value(class_summary_writer_t *writer, const char *text) {
+    if (!text || writer->failed) return 0;
+    size_t length = strlen(text) + 1;
+    size_t needed = writer->values_length + length;
+    if (needed > UINT32_MAX) {
+        writer->failed = true;
+        return 0;
+    }
+    if (needed > writer->values_capacity) {
+        size_t capacity = writer->values_capacity * 2;
+        while (capacity < needed) capacity *= 2;
+        char *values = realloc(writer->values, capacity);
+        if (!values) {
+            writer->failed = true;
+            return 0;
+        }
+        writer->values = values;
+        writer->values_capacity = capacity;
+    }
+    uint32_t offset = (uint32_t)writer->values_length;
+    memcpy(writer->values + offset, text, length);
+    writer->values_length = needed;
+    return offset;
+}
+
+// Раскладка и всё, на что она ссылается; повторная встреча даёт тот же индекс
+static uint32_t class_summary_add_type(class_summary_writer_t *writer, const TypeInfo *type) {
+    if (!type || writer->failed) return 0;
+    for (uint32_t i = 0; i < writer->type_count; i++) {
+        if (writer->type_of[i] == type) return i + 1;
+    }
+    uint32_t capacity = writer->type_capacity;     // type_of растёт вместе с types
+    if (!class_summary_reserve(writer, (void **)&writer->types, &writer->type_capacity,
+                               (uint64_t)writer->type_count + 1, sizeof(class_summary_type_t))) {
+        return 0;
+    }
+    if (!class_summary_reserve(writer, (void **)&writer->type_of, &capacity,
+                               (uint64_t)writer->type_count + 1, sizeof(const TypeInfo *))) {
+        return 0;
+    }
+
+    // Индекс занимается до обхода ссылок: ссылка DDIC на саму себя не зацикливает запись
+    uint32_t index = writer->type_count++;
+    writer->type_of[index] = type;
+    uint32_t count = type->components && type->component_count > 0 ? (uint32_t)type->component_count : 0;
+    uint32_t first = writer->field_count;
+    if (!class_summary_reserve(writer, (void **)&writer->fields, &writer->field_capacity,
+                               (uint64_t)first + count, sizeof(class_summary_field_t))) {
+        return 0;
+    }
+    writer->field_count += count;
+    writer->types[index] = (class_summary_type_t){
+        .size = type->size,
+        .align = type->align,
+        .name = class_summary_add_name(writer, type->name),
+        .kind = (uint8_t)type->kind,
+        .elementary = (uint8_t)type->elementary,
+        .flags = (uint8_t)((type->deep ? CLASS_SUMMARY_DEEP : 0) | (type->cyclic ? CLASS_SUMMARY_CYCLIC : 0)),
+        .length = type->length,
+        .decimals = type->decimals,
+        .first_field = first,
+        .field_count = count,
+    };
+
+    // Массивы могут переместиться при добавлении вложенных типов: запись по индексу
+    for (uint32_t k = 0; k < count; k++) {
+        const type_component_t *component = &type->components[k];
+        uint32_t name = class_summary_add_name(writer, component->name);
+        uint32_t field_type = class_summary_add_type(writer, component->type);
+        if (writer->failed) return 0;
+        writer->fields[first + k] = (class_summary_field_t){ component->offset, name, field_type };
+    }
+    uint32_t line = class_summary_add_type(writer, type->line);
+    if (writer->failed) return 0;
+    writer->types[index].line = line;
+    return index + 1;
+}
+
+static bool class_summary_component_kind(ASTNodeType type, class_component_kind_t *kind, symbol_kind_t *symbol) {
+    switch (type) {
+        case AST_DATA_DECL:     *kind = CLASS_COMPONENT_ATTRIBUTE; *symbol = SYMBOL_ATTRIBUTE; return true;
+        case AST_CONSTANT_DECL: *kind = CLASS_COMPONENT_CONSTANT;  *symbol = SYMBOL_CONSTANT;  return true;
+        case AST_TYPES_DECL:    *kind = CLASS_COMPONENT_TYPE;      *symbol = SYMBOL_TYPE;      return true;
+        case AST_METHOD_DECL:   *kind = CLASS_COMPONENT_METHOD;    *symbol = SYMBOL_METHOD;    return true;
+        default:                return false;
+    }
+}
+
+static class_visibility_t class_summary_visibility(const ASTNode *section, class_visibility_t outer) {
+    const char *text = ast_node_name(section);
+    if (!text) return outer;
+    if (strcmp(text, "PROTECTED") == 0) return CLASS_VISIBILITY_PROTECTED;
+    if (strcmp(text, "PRIVATE") == 0) return CLASS_VISIBILITY_PRIVATE;
+    return CLASS_VISIBILITY_PUBLIC;
+}
+
+static method_param_direction_t class_summary_direction(const ASTNode *param) {
+    const char *text = param->string_value;
+    if (!text) return METHOD_PARAM_IMPORTING;
+    if (strcmp(text, "EXPORTING") == 0) return METHOD_PARAM_EXPORTING;
+    if (strcmp(text, "CHANGING") == 0) return METHOD_PARAM_CHANGING;
+    if (strcmp(text, "RETURNING") == 0) return METHOD_PARAM_RETURNING;
+    return METHOD_PARAM_IMPORTING;
+}
+
+// Компоненты объявляются в области класса до разбора: DATA может ссылаться на TYPES класса
+static bool class_summary_declare_members(symbol_table_t *table, const ASTNode *parent) {
+    for (int i = 0; i < parent->child_count; i++) {
+        const ASTNode *child = parent->children[i];
+        if (!child) continue;
+        if (child->type == AST_CLASS_SECTION) {
+            if (!class_summary_declare_members(table, child)) return false;
+            continue;
+        }
+        class_component_kind_t kind;
+        symbol_kind_t symbol;
+        if (child->atom == ATOM_NONE || !class_summary_component_kind(child->type, &kind, &symbol)) continue;
+        if (!symbol_table_declare(table, child->atom, symbol, NULL, child, NULL)) return false;
+    }
+    return true;
+}
+
+static void class_summary_add_params(class_summary_writer_t *writer, semantic_context_t *context,
+                                     const ASTNode *method, class_summary_component_t *record) {
+    record->first_param = writer->param_count;
+    for (int i = 0; i < method->child_count; i++) {
+        const ASTNode *param = method->children[i];
+        if (!param || param->type != AST_METHOD_PARAM || param->atom == ATOM_NONE) continue;
+        uint32_t name = class_summary_add_name(writer, param->atom);
+        uint32_t type = class_summary_add_type(writer, type_resolve_decl(context, param));
+        if (!class_summary_reserve(writer, (void **)&writer->params, &writer->param_capacity,
+                                   (uint64_t)writer->param_count + 1, sizeof(class_summary_param_t))) {
+            return;
+        }
+        writer->params[writer->param_count++] =
+            (class_summary_param_t){ name, (uint32_t)class_summary_direction(param), type };
+        record->param_count++;
+    }
+}
+
+static void class_summary_add_members(class_summary_writer_t *writer, semantic_context_t *context,
+                                      const ASTNode *parent, class_visibility_t visibility) {
+    for (int i = 0; !writer->failed && i < parent->child_count; i++) {
+        const ASTNode *child = parent->children[i];
+        if (!child) continue;
+        if (child->type == AST_CLASS_SECTION) {
+            class_summary_add_members(writer, context, child, class_summary_visibility(child, visibility));
+            continue;
+        }
+        class_component_kind_t kind;
+        symbol_kind_t symbol;
+        if (child->atom == ATOM_NONE || !class_summary_component_kind(child->type, &kind, &symbol)) continue;
+
+        class_summary_component_t record = {
+            .name = class_summary_add_name(writer, child->atom),
+            .kind = (uint8_t)kind,
+            .visibility = (uint8_t)visibility,
+        };
+        if (kind == CLASS_COMPONENT_METHOD) {
+            class_summary_add_params(writer, context, child, &record);
+        } else {
+            record.type = class_summary_add_type(writer, type_resolve_decl(context, child));
+            for (int k = 0; k < child->child_count; k++) {
+                const ASTNode *spec = child->children[k];
+                if (spec && spec->type == AST_VALUE_SPEC) record.value = class_summary_add_value(writer, ast_node_name(spec));
+            }
+        }
+        if (context->failed) writer->failed = true;
+        if (!class_summary_reserve(writer, (void **)&writer->components, &writer->component_capacity,
+                                   (uint64_t)writer->component_count + 1, sizeof(class_summary_component_t))) {
+            return;
+        }
+        writer->components[writer->component_count++] = record;
+    }
+}
+
+static void class_summary_writer_free(class_summary_writer_t *writer) {
+    free(writer->local);
+    free(writer->names);
+    free(writer->type_of);
+    free(writer->types);
+    free(writer->fields);
+    free(writer->components);
+    free(writer->params);
+    free(writer->values);
+}
+
+static uint64_t class_summary_align(uint64_t offset) {
+    return (offset + CLASS_SUMMARY_ALIGN - 1) & ~(uint64_t)(CLASS_SUMMARY_ALIGN - 1);
+}
+
+// Запись секции с дополнением до границы выравнивания
+static bool class_summary_write(FILE *file, const void *data, size_t bytes, uint64_t *offset) {
+    static const char padding[CLASS_SUMMARY_ALIGN] = { 0 };
+    if (bytes && fwrite(data, 1, bytes, file) != bytes) return false;
+    uint64_t end = *offset + bytes;
+    size_t pad = (size_t)(class_summary_align(end) - end);
+    if (pad && fwrite(padding, 1, pad, file) != pad) return false;
+    *offset = end + pad;
+    return true;
+}
+
+static bool class_summary_write_file(const char *path, const class_summary_writer_t *writer,
+                                     const class_summary_header_t *header) {
+    char temp[4096 + 32];
+    snprintf(temp, sizeof(temp), "%s.%ld.tmp", path, (long)getpid());
+    FILE *file = fopen(temp, "wb");
+    if (!file) {
+        fprintf(stderr, "Cannot create class summary file %s: %s\n", temp, strerror(errno));
+        return false;
+    }
+
+    uint64_t offset = 0;
+    bool ok = class_summary_write(file, header, sizeof(*header), &offset) &&
+              class_summary_write(file, writer->types, (size_t)writer->type_count * sizeof(class_summary_type_t), &offset) &&
+              class_summary_write(file, writer->fields, (size_t)writer->field_count * sizeof(class_summary_field_t), &offset) &&
+              class_summary_write(file, writer->components, (size_t)writer->component_count * sizeof(class_summary_component_t), &offset) &&
+              class_summary_write(file, writer->params, (size_t)writer->param_count * sizeof(class_summary_param_t), &offset) &&
+              class_summary_write(file, writer->values, writer->values_length, &offset);
+
+    // Текст имён идёт сразу за границами, без выравнивания
+    uint32_t bound = 0;
+    if (ok) ok = fwrite(&bound, sizeof(bound), 1, file) == 1;
+    for (uint32_t k = 0; ok && k < writer->name_count; k++) {
+        bound += (uint32_t)atom_length(writer->names[k]);
+        ok = fwrite(&bound, sizeof(bound), 1, file) == 1;
+    }
+    for (uint32_t k = 0; ok && k < writer->name_count; k++) {
+        size_t length = atom_length(writer->names[k]);
+        ok = fwrite(atom_text(writer->names[k]), 1, length, file) == length;
+    }
+    if (fclose(file) != 0) ok = false;
+    // Переименование атомарно: читатель не увидит недописанный файл
+    if (ok && rename(temp, path) != 0) {
+        fprintf(stderr, "Cannot write class summary file %s: %s\n", path, strerror(errno));
+        ok = false;
+    }
+    if (!ok) remove(temp);
+    return ok;
+}
+
+/**
+ * @brief Запись сводки: компоненты разбираются в области класса поверх глобальных
+ *        символов программы, раскладки сводятся в таблицу без повторов.
+ */
+bool class_summary_store(const char *dir, const ASTNode *definition, uint64_t source_hash,
+                         semantic_result_t *analysis) {
+    if (!definition || definition->atom == ATOM_NONE ||
+        (definition->type != AST_CLASS_DEF && definition->type != AST_INTERFACE_DEF)) {
+        return false;
+    }
+    char path[4096];
+    if (!class_summary_path(path, sizeof(path), dir, definition->atom)) return false;
+
+    class_summary_writer_t writer = { 0 };
+    writer.atom_limit = atom_count();
+    writer.local = calloc(writer.atom_limit + 1, sizeof(uint32_t));
+    writer.values = malloc(64);
+    writer.values_capacity = 64;
+    writer.failed = !writer.local || !writer.values;
+    if (!writer.failed) writer.values[writer.values_length++] = '\0';
+
+    symbol_table_t table;
+    symbol_table_init(&table, &analysis->globals);
+    diag_list_t diagnostics;
+    diag_list_init(&diagnostics);
+    // procedure != NULL: имена компонентов ищутся в области класса, а не только среди глобальных
+    semantic_context_t context = {
+        .symbols = &table,
+        .diagnostics = &diagnostics,
+        .procedure = definition,
+        .types = &analysis->types,
+    };
+    uint32_t name = class_summary_add_name(&writer, definition->atom);
+    if (!writer.failed) {
+        writer.failed = !symbol_table_push(&table) || !class_summary_declare_members(&table, definition);
+    }
+    if (!writer.failed) class_summary_add_members(&writer, &context, definition, CLASS_VISIBILITY_PUBLIC);
+    symbol_table_free(&table);
+    diag_list_free(&diagnostics);
+
+    bool ok = !writer.failed && writer.names_length < UINT32_MAX;
+    if (ok) {
+        class_summary_header_t header = { 0 };
+        memcpy(header.magic, CLASS_SUMMARY_MAGIC, sizeof(header.magic));
+        header.version = CLASS_SUMMARY_VERSION;
+        header.byte_order = CLASS_SUMMARY_BYTE_ORDER;
+        header.kind = definition->type == AST_INTERFACE_DEF ? CLASS_SUMMARY_INTERFACE : CLASS_SUMMARY_CLASS;
+        header.name = name;
+        header.source_hash = source_hash;
+        header.name_count = writer.name_count;
+        header.type_count = writer.type_count;
+        header.field_count = writer.field_count;
+        header.component_count = writer.component_count;
+        header.param_count = writer.param_count;
+        header.values_length = writer.values_length;
+        header.names_length = writer.names_length;
+
+        // Раскладка секций
+        uint64_t offset = class_summary_align(sizeof(header));
+        header.types_offset = offset;
+        offset = class_summary_align(offset + (uint64_t)writer.type_count * sizeof(class_summary_type_t));
+        header.fields_offset = offset;
+        offset = class_summary_align(offset + (uint64_t)writer.field_count * sizeof(class_summary_field_t));
+        header.components_offset = offset;
+        offset = class_summary_align(offset + (uint64_t)writer.component_count * sizeof(class_summary_component_t));
+        header.params_offset = offset;
+        offset = class_summary_align(offset + (uint64_t)writer.param_count * sizeof(class_summary_param_t));
+        header.values_offset = offset;
+        header.names_offset = class_summary_align(offset + writer.values_length);
+
+        ok = class_summary_write_file(path, &writer, &header);
+    }
+    class_summary_writer_free(&writer);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Загрузка
+
+// Секция [offset, offset + bytes) целиком в файле и выровнена на 8 байт, как её пишет
+// class_summary_align(): записи раскладок содержат uint64_t
+static bool class_summary_section_fits(uint64_t offset, uint64_t bytes, size_t size) {
+    return offset % CLASS_SUMMARY_ALIGN == 0 && offset <= size && bytes <= size - offset;
+}
+
+// Проверка заголовка и границ секций
+static bool class_summary_validate(const class_summary_header_t *header, size_t size) {
+    if (memcmp(header->magic, CLASS_SUMMARY_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != CLASS_SUMMARY_VERSION ||
+        header->byte_order != CLASS_SUMMARY_BYTE_ORDER ||
+        header->kind > CLASS_SUMMARY_INTERFACE ||
+        header->name == 0 || header->name > header->name_count ||
+        header->values_length == 0 ||
+        header->type_count > INT32_MAX || header->component_count > INT32_MAX ||
+        header->param_count > INT32_MAX ||
+        header->name_count >= size / sizeof(uint32_t)) {
+        return false;
+    }
+    // Границы имён, затем текст; сумма не вычисляется, чтобы names_length из файла
+    // не переполнил её
+    uint64_t bounds = ((uint64_t)header->name_count + 1) * sizeof(uint32_t);
+    if (!class_summary_section_fits(header->names_offset, bounds, size) ||
+        header->names_length > size - header->names_offset - bounds) {
+        return false;
+    }
+    return class_summary_section_fits(header->types_offset, (uint64_t)header->type_count * sizeof(class_summary_type_t), size) &&
+           class_summary_section_fits(header->fields_offset, (uint64_t)header->field_count * sizeof(class_summary_field_t), size) &&
+           class_summary_section_fits(header->components_offset, (uint64_t)header->component_count * sizeof(class_summary_component_t), size) &&
+           class_summary_section_fits(header->params_offset, (uint64_t)header->param_count * sizeof(class_summary_param_t), size) &&
+           class_summary_section_fits(header->values_offset, header->values_length, size);
+}
+
+// Ссылки записей не выходят за свои таблицы: индексы превращаются в указатели
+static bool class_summary_validate_records(const class_summary_header_t *header, const char *base) {
+    const class_summary_type_t *types = (const class_summary_type_t *)(base + header->types_offset);
+    const class_summary_field_t *fields = (const class_summary_field_t *)(base + header->fields_offset);
+    const class_summary_component_t *components = (const class_summary_component_t *)(base + header->components_offset);
+    const class_summary_param_t *params = (const class_summary_param_t *)(base + header->params_offset);
+    const char *values = base + header->values_offset;
+    if (values[header->values_length - 1] != '\0') return false;
+
+    for (uint32_t i = 0; i < header->type_count; i++) {
+        const class_summary_type_t *type = &types[i];
+        if (type->name > header->name_count || type->kind > TYPE_KIND_INVALID ||
+            type->elementary > TYPE_XSTRING || type->line > header->type_count ||
+            (uint64_t)type->first_field + type->field_count > header->field_count ||
+            type->field_count > INT32_MAX) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->field_count; i++) {
+        if (fields[i].name > header->name_count || fields[i].type == 0 || fields[i].type > header->type_count) return false;
+    }
+    for (uint32_t i = 0; i < header->component_count; i++) {
+        const class_summary_component_t *component = &components[i];
+        if (component->name == 0 || component->name > header->name_count ||
+            component->kind > CLASS_COMPONENT_METHOD || component->visibility > CLASS_VISIBILITY_PRIVATE ||
+            component->type > header->type_count || component->value >= header->values_length ||
+            (uint64_t)component->first_param + component->param_count > header->param_count) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->param_count; i++) {
+        if (params[i].name == 0 || params[i].name > header->name_count ||
+            params[i].direction > METHOD_PARAM_RETURNING || params[i].type > header->type_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Раскладки процесса: сначала значения всех записей, затем ссылки между ними
+// (class_summary_type() смотрит на вид записи, на которую ссылается)
+static bool class_summary_build_types(class_summary_t *summary, const class_summary_header_t *header,
+                                      const char *base) {
+    const class_summary_type_t *records = (const class_summary_type_t *)(base + header->types_offset);
+    const class_summary_field_t *fields = (const class_summary_field_t *)(base + header->fields_offset);
+    size_t bytes = (size_t)header->type_count * sizeof(TypeInfo) +
+                   (size_t)header->field_count * sizeof(type_component_t);
+    TypeInfo *types = malloc(bytes ? bytes : 1);
+    if (!types) return false;
+    type_component_t *components = (type_component_t *)(types + header->type_count);
+    summary->types = types;
+    summary->type_count = (int)header->type_count;
+
+    for (uint32_t i = 0; i < header->type_count; i++) {
+        const class_summary_type_t *record = &records[i];
+        types[i] = (TypeInfo){
+            .name = summary->atoms[record->name],
+            .kind = (type_kind_t)record->kind,
+            .elementary = (type_elementary_t)record->elementary,
+            .length = record->length,
+            .decimals = record->decimals,
+            .size = (size_t)record->size,
+            .align = (size_t)record->align,
+            .deep = (record->flags & CLASS_SUMMARY_DEEP) != 0,
+            .cyclic = (record->flags & CLASS_SUMMARY_CYCLIC) != 0,
+        };
+    }
+    for (uint32_t i = 0; i < header->type_count; i++) {
+        const class_summary_type_t *record = &records[i];
+        if (record->field_count) {
+            types[i].components = components + record->first_field;
+            types[i].component_count = (int)record->field_count;
+        }
+        types[i].line = class_summary_type(summary, record->line);
+    }
+    for (uint32_t k = 0; k < header->field_count; k++) {
+        components[k] = (type_component_t){
+            summary->atoms[fields[k].name], (size_t)fields[k].offset, class_summary_type(summary, fields[k].type)
+        };
+    }
+    return true;
+}
+
+/**
+ * @brief Загрузка: отображение файла, интернирование имён и построение раскладок.
+ */
+bool class_summary_load(class_summary_t *summary, const char *dir, atom_t name) {
+    memset(summary, 0, sizeof(*summary));
+
+    char path[4096];
+    if (!class_summary_path(path, sizeof(path), dir, name)) return false;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        if (errno != ENOENT) fprintf(stderr, "Cannot open class summary file %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || (size_t)st.st_size < sizeof(class_summary_header_t)) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    const char *base = mapping;
+    const class_summary_header_t *header = mapping;
+    if (!class_summary_validate(header, size) || !class_summary_validate_records(header, base)) {
+        munmap(mapping, size);
+        return false;
+    }
+
+    // Таблица имён: границы, затем текст; индекс 0 остаётся ATOM_NONE
+    uint32_t name_count = header->name_count;
+    const uint32_t *bounds = (const uint32_t *)(base + header->names_offset);
+    const char *text = (const char *)(bounds + name_count + 1);
+    atom_t *atoms = malloc(((size_t)name_count + 1) * sizeof(atom_t));
+    bool ok = atoms != NULL && bounds[0] == 0 && bounds[name_count] == header->names_length;
+    if (ok) atoms[0] = ATOM_NONE;
+    for (uint32_t k = 0; ok && k < name_count; k++) {
+        ok = bounds[k] < bounds[k + 1] && bounds[k + 1] <= header->names_length;
+        if (ok) atoms[k + 1] = atom_intern(text + bounds[k], bounds[k + 1] - bounds[k]);
+    }
+    // Файл другого класса с тем же путём ('#' в имени)
+    ok = ok && atoms[header->name] == name;
+
+    summary->atoms = atoms;
+    if (!ok || !class_summary_build_types(summary, header, base)) {
+        free(atoms);
+        munmap(mapping, size);
+        memset(summary, 0, sizeof(*summary));
+        return false;
+    }
+
+    summary->name = name;
+    summary->kind = (class_summary_kind_t)header->kind;
+    summary->source_hash = header->source_hash;
+    summary->components = (const class_summary_component_t *)(base + header->components_offset);
+    summary->component_count = (int)header->component_count;
+    summary->params = (const class_summary_param_t *)(base + header->params_offset);
+    summary->param_count = (int)header->param_count;
+    summary->values = base + header->values_offset;
+    summary->values_length = (size_t)header->values_length;
+    summary->mapping = mapping;
+    summary->mapping_size = size;
+    return true;
+}
+
+void class_summary_close(class_summary_t *summary) {
+    if (summary->mapping) munmap(summary->mapping, summary->mapping_size);
+    free(summary->atoms);
+    free(summary->types);
+    memset(summary, 0, sizeof(*summary));
+}
+
+const class_summary_component_t *class_summary_find(const class_summary_t *summary, atom_t name) {
+    for (int i = 0; i < summary->component_count; i++) {
+        if (summary->atoms[summary->components[i].name] == name) return &summary->components[i];
+    }
+    return NULL;
+}
+
+atom_t class_summary_name(const class_summary_t *summary, uint32_t index) {
+    return summary->atoms[index];
+}
+
+const TypeInfo *class_summary_type(const class_summary_t *summary, uint32_t index) {
+    if (index == 0 || index > (uint32_t)summary->type_count) return NULL;
+    const TypeInfo *type = &summary->types[index - 1];
+    if (type->kind == TYPE_KIND_INVALID) return type->cyclic ? &type_cyclic : &type_unknown;
+    return type;
+}
+
+const char *class_summary_value(const class_summary_t *summary, const class_summary_component_t *component) {
+    return component->value ? summary->values + component->value : NULL;
+}
+
+atom_t class_summary_member(atom_t owner, const char *separator, atom_t component, bool intern) {
+    if (owner == ATOM_NONE || component == ATOM_NONE) return ATOM_NONE;
+    char text[512];
+    int length = snprintf(text, sizeof(text), "%s%s%s", atom_text(owner), separator, atom_text(component));
+    if (length < 0 || (size_t)length >= sizeof(text)) return ATOM_NONE;
+    return intern ? atom_intern(text, (size_t)length) : atom_find(text, (size_t)length);
+}
+
+static uint64_t class_summary_mix(uint64_t hash, uint64_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    return hash * 0x100000001b3ull;
+}
+
+static uint64_t class_summary_mix_text(uint64_t hash, const char *text) {
+    for (; text && *text; text++) hash = class_summary_mix(hash, (unsigned char)*text);
+    return class_summary_mix(hash, 0);
+}
+
+// Хеш того, что видно потребителю компонента: вид, значение, параметры метода с
+// направлениями и раскладками. Раскладка атрибута, константы или типа хешируется
+// отдельно, как тип символа (semantic_fingerprint())
+static uint64_t class_summary_component_hash(const class_summary_t *summary,
+                                             const class_summary_component_t *component) {
+    uint64_t hash = class_summary_mix(0xcbf29ce484222325ull, component->kind);
+    hash = class_summary_mix_text(hash, class_summary_value(summary, component));
+    hash = class_summary_mix(hash, component->param_count);
+    for (uint32_t i = 0; i < component->param_count; i++) {
+        const class_summary_param_t *param = &summary->params[component->first_param + i];
+        hash = class_summary_mix_text(hash, atom_text(class_summary_name(summary, param->name)));
+        hash = class_summary_mix(hash, param->direction);
+        hash = class_summary_mix(hash, semantic_type_hash(class_summary_type(summary, param->type)));
+    }
+    return hash ? hash : 1;     // 0 в symbol_t.source_hash означает «не из сводки»
+}
+
+static symbol_kind_t class_summary_symbol_kind(class_component_kind_t kind) {
+    switch (kind) {
+        case CLASS_COMPONENT_CONSTANT: return SYMBOL_CONSTANT;
+        case CLASS_COMPONENT_TYPE:     return SYMBOL_TYPE;
+        case CLASS_COMPONENT_METHOD:   return SYMBOL_METHOD;
+        default:                       return SYMBOL_ATTRIBUTE;
+    }
+}
+
+// Компонент под составным именем "владелец<separator>компонент"
+static bool class_summary_declare_member(const class_summary_t *summary, const class_summary_component_t *component,
+                                         const char *separator, uint64_t hash, symbol_table_t *builder) {
+    atom_t name = class_summary_member(summary->name, separator, class_summary_name(summary, component->name), true);
+    if (name == ATOM_NONE) return true;         // Имя длиннее любого имени ABAP — компонента не видно
+    symbol_t *symbol = symbol_table_declare(builder, name, class_summary_symbol_kind(component->kind),
+                                            (TypeInfo *)class_summary_type(summary, component->type), NULL, NULL);
+    if (!symbol) return false;
+    symbol->source_hash = hash;
+    return true;
+}
+
+bool class_summary_declare(const class_summary_t *summary, symbol_table_t *builder) {
+    symbol_kind_t kind = summary->kind == CLASS_SUMMARY_INTERFACE ? SYMBOL_INTERFACE : SYMBOL_CLASS;
+    symbol_t *symbol = symbol_table_declare(builder, summary->name, kind, NULL, NULL, NULL);
+    if (!symbol) return false;
+    symbol->source_hash = summary->source_hash ? summary->source_hash : 1;
+
+    // Снаружи видны только публичные компоненты: class=>comp, у интерфейса ещё intf~comp
+    for (int i = 0; i < summary->component_count; i++) {
+        const class_summary_component_t *component = &summary->components[i];
+        if (component->visibility != CLASS_VISIBILITY_PUBLIC) continue;
+        uint64_t hash = class_summary_component_hash(summary, component);
+        if (!class_summary_declare_member(summary, component, "=>", hash, builder)) return false;
+        if (summary->kind == CLASS_SUMMARY_INTERFACE &&
+            !class_summary_declare_member(summary, component, "~", hash, builder)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,623 @@
+#include "semantic.h"
+#include "ast_visitor.h"
+#include "class_summary.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file semantic_analyzer.c
+ * @brief Семантический анализ: сбор глобальных объявлений и параллельная проверка процедур.
+ *
+ * Фаза сбора идёт по дереву один раз в вызывающем потоке: объявления вне процедур
+ * и имена процедур попадают в таблицу программы, которая затем замораживается, а
+ * дерево делится на участки — процедуры (FORM, METHOD, FUNCTION, MODULE) и отрезки
+ * операторов верхнего уровня между ними. В том же обходе (ast_visit_fused()) второй
+ * визитор хеширует поддеревья участков для сопоставления с прошлым анализом. Фаза проверки раздаёт участки пулу потоков;
+ * у каждого потока своя таблица символов поверх замороженных глобальных, у каждого
+ * участка — свой список сообщений. Списки сливаются в порядке участков, то есть в
+ * порядке исходного текста.
+ *
+ * Каждый участок записывает глобальные имена, которые он искал (semantic_deps.c).
+ * Повторный анализ (semantic_reanalyze()) сопоставляет участки с участками прошлого
+ * анализа по виду и имени процедуры и проверяет заново только те, у которых изменилось
+ * поддерево или отпечаток одной из зависимостей; сообщения остальных копируются.
+ */
+
+// Участок фазы проверки
+typedef struct {
+    ASTNode *procedure;         // Процедура или NULL для кода вне процедур
+    atom_t class_name;          // Класс METHOD (из CLASS ... IMPLEMENTATION) или ATOM_NONE
+    int first;                  // Код вне процедур: операторы program->children[first, end)
+    int end;
+    uint64_t identity;          // См. semantic_unit_summary_t
+    uint64_t body;
+    const semantic_unit_summary_t *previous;    // Участок прошлого анализа, который не изменился
+    semantic_deps_t deps;       // Зависимости участка
+    diag_list_t diagnostics;    // Сообщения участка
+} semantic_unit_t;
+
+// Состояние фазы сбора
+typedef struct {
+    ASTNode *program;
+    symbol_table_t builder;     // Глобальные символы программы до заморозки
+    semantic_unit_t *units;
+    int count;
+    int capacity;
+    int top;                    // Номер следующего оператора верхнего уровня
+    atom_t *duplicates;         // Повторно объявленные глобальные имена
+    int duplicate_count;
+    int duplicate_capacity;
+    bool failed;
+} semantic_collect_t;
+
+// Состояние фазы проверки
+typedef struct {
+    ASTNode *program;
+    semantic_unit_t *units;
+    int *order;                 // Номера участков, которые нужно проверить
+    symbol_table_t *tables;     // Таблица каждого потока пула
+    type_cache_t *types;        // Общий кэш раскладок
+    bool failed;
+} semantic_run_t;
+
+// Встроенные типы ABAP и предопределённые объекты данных
+static const char *const semantic_builtin_types[] = {
+    "C", "N", "D", "T", "X", "I", "INT1", "INT2", "INT8", "P", "F", "STRING", "XSTRING",
+    "DECFLOAT16", "DECFLOAT34", "UTCLONG", "ABAP_BOOL",
+};
+static const char *const semantic_builtin_data[] = { "SY", "SYST" };
+static const char *const semantic_builtin_constants[] = { "SPACE", "ABAP_TRUE", "ABAP_FALSE" };
+
+static bool semantic_is_procedure(ASTNodeType type) {
+    return type == AST_FORM || type == AST_METHOD_IMPLEMENTATION || type == AST_FUNCTION || type == AST_MODULE;
+}
+
+// Вид символа, который вводит узел объявления; false — узел ничего не объявляет
+static bool semantic_declaration_kind(ASTNodeType type, symbol_kind_t *kind) {
+    switch (type) {
+        case AST_DATA_DECL:         *kind = SYMBOL_VARIABLE;     return true;
+        case AST_CONSTANT_DECL:     *kind = SYMBOL_CONSTANT;     return true;
+        case AST_TYPES_DECL:        *kind = SYMBOL_TYPE;         return true;
+        case AST_FIELD_SYMBOL_DECL: *kind = SYMBOL_FIELD_SYMBOL; return true;
+        case AST_PARAMETERS_DECL:
+        case AST_FORM_PARAMETER:    *kind = SYMBOL_PARAMETER;    return true;
+        case AST_FORM:              *kind = SYMBOL_FORM;         return true;
+        case AST_FUNCTION:          *kind = SYMBOL_FUNCTION;     return true;
+        case AST_MODULE:            *kind = SYMBOL_MODULE;       return true;
+        case AST_CLASS_DEF:         *kind = SYMBOL_CLASS;        return true;
+        case AST_INTERFACE_DEF:     *kind = SYMBOL_INTERFACE;    return true;
+        default:                    return false;
+    }
+}
+
+static semantic_unit_t *semantic_add_unit(semantic_collect_t *collect) {
+    if (collect->count == collect->capacity) {
+        int capacity = collect->capacity ? collect->capacity * 2 : 64;
+        semantic_unit_t *units = realloc(collect->units, (size_t)capacity * sizeof(semantic_unit_t));
+        if (!units) {
+            collect->failed = true;
+            return NULL;
+        }
+        collect->units = units;
+        collect->capacity = capacity;
+    }
+    semantic_unit_t *unit = &collect->units[collect->count++];
+    memset(unit, 0, sizeof(*unit));
+    diag_list_init(&unit->diagnostics);
+    return unit;
+}
+
+// Глобальное объявление: первое побеждает, повтор сообщит фаза проверки (и учтёт отпечаток имени)
+static void semantic_collect_declare(semantic_collect_t *collect, const ASTNode *node) {
+    symbol_kind_t kind;
+    if (node->atom == ATOM_NONE || !semantic_declaration_kind(node->type, &kind)) return;
+    bool added = false;
+    if (!symbol_table_declare(&collect->builder, node->atom, kind, NULL, node, &added)) {
+        collect->failed = true;
+        return;
+    }
+    if (added) return;
+    if (collect->duplicate_count == collect->duplicate_capacity) {
+        int capacity = collect->duplicate_capacity ? collect->duplicate_capacity * 2 : 16;
+        atom_t *duplicates = realloc(collect->duplicates, (size_t)capacity * sizeof(atom_t));
+        if (!duplicates) {
+            collect->failed = true;
+            return;
+        }
+        collect->duplicates = duplicates;
+        collect->duplicate_capacity = capacity;
+    }
+    collect->duplicates[collect->duplicate_count++] = node->atom;
+}
+
+static ast_visit_result_t semantic_collect_node(ASTNode *node, ASTNode *parent, void *arg) {
+    semantic_collect_t *collect = arg;
+    if (collect->failed) return AST_VISIT_STOP;
+    if (node == collect->program) return AST_VISIT_CONTINUE;
+
+    if (semantic_is_procedure(node->type)) {
+        semantic_unit_t *unit = semantic_add_unit(collect);
+        if (unit) {
+            unit->procedure = node;
+            if (node->type == AST_METHOD_IMPLEMENTATION && parent && parent->type == AST_CLASS_IMPL) {
+                unit->class_name = parent->atom;
+            }
+        }
+        // Методы разных классов могут называться одинаково: глобально объявляются только
+        // FORM, FUNCTION и MODULE
+        if (node->type != AST_METHOD_IMPLEMENTATION) semantic_collect_declare(collect, node);
+        if (parent == collect->program) collect->top++;
+        return AST_VISIT_SKIP;
+    }
+
+    if (parent == collect->program) {
+        int index = collect->top++;
+        semantic_unit_t *last = collect->count ? &collect->units[collect->count - 1] : NULL;
+        if (last && !last->procedure && last->end == index) {
+            last->end++;
+        } else {
+            semantic_unit_t *unit = semantic_add_unit(collect);
+            if (unit) {
+                unit->first = index;
+                unit->end = index + 1;
+            }
+        }
+    }
+
+    semantic_collect_declare(collect, node);
+    // Компоненты классов, интерфейсов и структур TYPES BEGIN OF — не глобальные символы программы
+    if (node->type == AST_CLASS_DEF || node->type == AST_INTERFACE_DEF || node->type == AST_TYPES_DECL) {
+        return AST_VISIT_SKIP;
+    }
+    return AST_VISIT_CONTINUE;
+}
+
+// Хеши участков в обходе сбора. Визитор идёт после semantic_collect_node(), поэтому
+// участок узла, открывающего процедуру или отрезок, уже создан.
+typedef struct {
+    semantic_collect_t *collect;
+    int procedure;              // Участок открытой процедуры или -1
+    int segment;                // Участок открытого оператора кода вне процедур или -1
+    uint64_t body;              // Хеш открытой процедуры: semantic_tree_hash()
+    uint64_t statement;         // Хеш открытого оператора верхнего уровня
+} semantic_hash_walk_t;
+
+static ast_visit_result_t semantic_hash_node(ASTNode *node, ASTNode *parent, void *arg) {
+    semantic_hash_walk_t *walk = arg;
+    semantic_collect_t *collect = walk->collect;
+    if (collect->failed) return AST_VISIT_STOP;
+    if (node == collect->program) return AST_VISIT_CONTINUE;
+
+    if (semantic_is_procedure(node->type)) {
+        walk->procedure = collect->count - 1;
+        walk->body = SEMANTIC_HASH_SEED;
+    } else if (parent == collect->program) {
+        walk->segment = collect->count - 1;
+        semantic_unit_t *unit = &collect->units[walk->segment];
+        if (unit->end - unit->first == 1) unit->body = SEMANTIC_HASH_SEED;
+    }
+    if (parent == collect->program) walk->statement = SEMANTIC_HASH_SEED;
+    walk->statement = semantic_tree_hash_add(walk->statement, node);
+    if (walk->procedure >= 0) walk->body = semantic_tree_hash_add(walk->body, node);
+    return AST_VISIT_CONTINUE;
+}
+
+static ast_visit_result_t semantic_hash_leave(ASTNode *node, ASTNode *parent, void *arg) {
+    semantic_hash_walk_t *walk = arg;
+    semantic_collect_t *collect = walk->collect;
+    if (walk->procedure >= 0 && collect->units[walk->procedure].procedure == node) {
+        semantic_unit_t *unit = &collect->units[walk->procedure];
+        unit->identity = semantic_procedure_identity(node, unit->class_name);
+        unit->body = walk->body;
+        walk->procedure = -1;
+    }
+    if (walk->segment >= 0 && parent == collect->program) {
+        semantic_unit_t *unit = &collect->units[walk->segment];
+        unit->body = semantic_statements_hash_add(unit->body, walk->statement);
+        unit->identity = unit->body;
+        walk->segment = -1;
+    }
+    return AST_VISIT_CONTINUE;
+}
+
+// Объявление встроенных типов и предопределённых объектов данных
+static bool semantic_declare_builtins(symbol_table_t *table) {
+    static const struct {
+        const char *const *names;
+        size_t count;
+        symbol_kind_t kind;
+    } groups[] = {
+        { semantic_builtin_types, sizeof(semantic_builtin_types) / sizeof(semantic_builtin_types[0]), SYMBOL_TYPE },
+        { semantic_builtin_data, sizeof(semantic_builtin_data) / sizeof(semantic_builtin_data[0]), SYMBOL_VARIABLE },
+        { semantic_builtin_constants, sizeof(semantic_builtin_constants) / sizeof(semantic_builtin_constants[0]), SYMBOL_CONSTANT },
+    };
+    for (size_t g = 0; g < sizeof(groups) / sizeof(groups[0]); g++) {
+        for (size_t i = 0; i < groups[g].count; i++) {
+            atom_t name = atom_intern_cstr(groups[g].names[i]);
+            if (!symbol_table_declare(table, name, groups[g].kind, NULL, NULL, NULL)) return false;
+        }
+    }
+    return true;
+}
+
+// Компонент после разделителя: имя до следующего разделителя или скобки вызова
+static atom_t semantic_component_at(const char *text, size_t start) {
+    size_t end = start;
+    while (text[end] && text[end] != '-' && text[end] != '=' && text[end] != '~' && text[end] != '(') end++;
+    return end > start ? atom_intern(text + start, end - start) : ATOM_NONE;
+}
+
+// Класс или интерфейс, на который ссылается объект данных (DATA ref TYPE REF TO cls:
+// ссылка на тип в объявлении — класс), или ATOM_NONE
+static atom_t semantic_reference_class(const semantic_context_t *context, const symbol_t *symbol) {
+    if (!symbol || !symbol->decl) return ATOM_NONE;
+    for (int i = 0; i < symbol->decl->child_count; i++) {
+        const ASTNode *spec = symbol->decl->children[i];
+        if (!spec || spec->type != AST_TYPE_SPEC || spec->atom == ATOM_NONE) continue;
+        const symbol_t *type = symbol_table_lookup(context->symbols, spec->atom);
+        if (type && (type->kind == SYMBOL_CLASS || type->kind == SYMBOL_INTERFACE)) return spec->atom;
+    }
+    return ATOM_NONE;
+}
+
+const symbol_t *semantic_resolve(const semantic_context_t *context, atom_t name) {
+    const symbol_t *symbol = symbol_table_lookup(context->symbols, name);
+    if (name == ATOM_NONE) return NULL;
+    if (symbol) {
+        if (symbol->scope == 0) semantic_depend(context, name, ATOM_NONE);
+        return symbol;
+    }
+
+    // Составное имя: struct-comp, ref->attr, class=>attr, intf~comp
+    const char *text = atom_text(name);
+    size_t head = 1;
+    while (text[head] && text[head] != '-' && text[head] != '=' && text[head] != '~') head++;
+    if (!text[head]) {
+        semantic_depend(context, name, ATOM_NONE);
+        return NULL;
+    }
+    atom_t first = atom_find(text, head);
+    symbol = first != ATOM_NONE ? symbol_table_lookup(context->symbols, first) : NULL;
+    if (!context->deps) return symbol;
+
+    // ref->meth: вызов через типизированную ссылку (локальную или глобальную) зависит
+    // от объявления метода в классе, на который она ссылается
+    if (text[head] == '-' && text[head + 1] == '>') {
+        atom_t class_name = semantic_reference_class(context, symbol);
+        atom_t method = semantic_component_at(text, head + 2);
+        if (class_name != ATOM_NONE && method != ATOM_NONE) semantic_depend(context, class_name, method);
+    }
+    if (symbol && symbol->scope > 0) return symbol;
+
+    // class=>comp и intf~comp зависят только от объявления компонента
+    atom_t component = ATOM_NONE;
+    size_t start = text[head] == '=' && text[head + 1] == '>' ? head + 2 : text[head] == '~' ? head + 1 : 0;
+    if (start) component = semantic_component_at(text, start);
+    semantic_depend(context, first != ATOM_NONE ? first : atom_intern(text, head), component);
+    if (symbol && symbol->source_hash && component != ATOM_NONE) {
+        // Класс из сводки: компоненты известны полностью (class_summary_declare()), и
+        // class=>comp-field разрешается через символ компонента; нет символа — нет компонента
+        return symbol_table_lookup(context->symbols, class_summary_member(first, "=>", component, false));
+    }
+    return symbol;
+}
+
+// Объявление в проверяемом участке: в процедуре — в её области, вне процедур —
+// сверка с глобальным символом, собранным первой фазой
+static void semantic_check_declaration(semantic_context_t *context, ASTNode *node, bool *failed) {
+    symbol_kind_t kind;
+    if (node->atom == ATOM_NONE || !semantic_declaration_kind(node->type, &kind)) return;
+    type_check_declaration(context, node);
+
+    if (!context->procedure) {
+        semantic_depend(context, node->atom, ATOM_NONE);
+        const symbol_t *global = symbol_table_lookup(context->symbols, node->atom);
+        if (global && global->decl != node) {
+            diag_report(context->diagnostics, DIAG_ERROR, 0, 0, "Duplicate declaration of '%s'", atom_text(node->atom));
+        }
+        return;
+    }
+
+    bool added = false;
+    if (!symbol_table_declare(context->symbols, node->atom, kind, NULL, node, &added)) {
+        *failed = true;
+    } else if (!added) {
+        diag_report(context->diagnostics, DIAG_ERROR, 0, 0, "Duplicate declaration of '%s' in %s",
+                    atom_text(node->atom), ast_node_name(context->procedure));
+    }
+}
+
+// Аргумент визитора фазы проверки
+typedef struct {
+    semantic_context_t *context;
+    bool failed;
+} semantic_check_t;
+
+static ast_visit_result_t semantic_check_node(ASTNode *node, ASTNode *parent, void *arg) {
+    semantic_check_t *check = arg;
+    semantic_context_t *context = check->context;
+    if (node == context->procedure) return AST_VISIT_CONTINUE;
+    if (semantic_is_procedure(node->type)) return AST_VISIT_SKIP;
+    if (node->type == AST_CLASS_DEF || node->type == AST_INTERFACE_DEF) {
+        semantic_check_declaration(context, node, &check->failed);
+        return check->failed ? AST_VISIT_STOP : AST_VISIT_SKIP;
+    }
+
+    switch (node->type) {
+        case AST_ASSIGNMENT:
+            type_check_assignment(context, node);
+            break;
+        case AST_FUNCTION_CALL:
+            // Вызовы не проверяются, но сигнатура вызываемого метода — зависимость участка
+            semantic_resolve(context, node->atom);
+            break;
+        case AST_IDENTIFIER:
+            if (parent && (parent->type == AST_ASSIGNMENT || parent->type == AST_EXPRESSION ||
+                           parent->type == AST_OPERATOR)) {
+                type_check_operand(context, node);
+            }
+            break;
+        case AST_TYPES_DECL:
+            // Компоненты структуры проверяет type_check_declaration()
+            semantic_check_declaration(context, node, &check->failed);
+            return check->failed ? AST_VISIT_STOP : AST_VISIT_SKIP;
+        default:
+            semantic_check_declaration(context, node, &check->failed);
+            break;
+    }
+    return check->failed ? AST_VISIT_STOP : AST_VISIT_CONTINUE;
+}
+
+// Повторное определение FORM/FUNCTION/MODULE: глобальный символ указывает на первое
+static void semantic_check_procedure_name(semantic_context_t *context) {
+    const ASTNode *procedure = context->procedure;
+    if (procedure->type == AST_METHOD_IMPLEMENTATION || procedure->atom == ATOM_NONE) return;
+    semantic_depend(context, procedure->atom, ATOM_NONE);
+    const symbol_t *global = symbol_frozen_lookup(context->symbols->globals, procedure->atom);
+    if (global && global->decl != procedure) {
+        diag_report(context->diagnostics, DIAG_ERROR, 0, 0, "Duplicate definition of '%s'", atom_text(procedure->atom));
+    }
+}
+
+static void semantic_check_unit(void *arg, size_t index, int worker) {
+    semantic_run_t *run = arg;
+    semantic_unit_t *unit = &run->units[run->order[index]];
+    symbol_table_t *table = &run->tables[worker];
+    semantic_context_t context = {
+        .symbols = table,
+        .diagnostics = &unit->diagnostics,
+        .procedure = unit->procedure,
+        .resolve_names = !unit->procedure || unit->procedure->type != AST_METHOD_IMPLEMENTATION,
+        .types = run->types,
+        .deps = &unit->deps,
+    };
+    semantic_check_t check = { &context, false };
+    ast_visitor_t visitor = { .pre_any = semantic_check_node, .arg = &check };
+
+    if (!symbol_table_push(table)) {
+        __atomic_store_n(&run->failed, true, __ATOMIC_RELAXED);
+        return;
+    }
+    bool ok = true;
+    if (unit->procedure) {
+        semantic_check_procedure_name(&context);
+        // Реализация метода зависит от его объявления в CLASS ... DEFINITION
+        if (unit->class_name != ATOM_NONE) semantic_depend(&context, unit->class_name, unit->procedure->atom);
+        ok = ast_visit(unit->procedure, &visitor);
+    } else {
+        for (int i = unit->first; ok && !check.failed && i < unit->end; i++) {
+            ok = ast_visit(run->program->children[i], &visitor);
+        }
+    }
+    symbol_table_pop(table);
+    if (!ok || check.failed || context.failed || unit->deps.failed) __atomic_store_n(&run->failed, true, __ATOMIC_RELAXED);
+}
+
+// Участок прошлого анализа в порядке тождеств
+typedef struct {
+    uint64_t identity;
+    int index;
+} semantic_previous_t;
+
+static int semantic_previous_compare(const void *a, const void *b) {
+    const semantic_previous_t *x = a;
+    const semantic_previous_t *y = b;
+    if (x->identity != y->identity) return x->identity < y->identity ? -1 : 1;
+    return x->index - y->index;
+}
+
+// Участок прошлого анализа можно взять без проверки: поддерево то же, отпечатки
+// всех имён, которые он искал, не изменились
+static bool semantic_unit_unchanged(const semantic_unit_t *unit, const semantic_unit_summary_t *previous,
+                                    semantic_fingerprints_t *prints) {
+    if (previous->body != unit->body) return false;
+    for (int i = 0; i < previous->deps.count; i++) {
+        const semantic_dep_t *dep = &previous->deps.items[i];
+        if (semantic_fingerprint(prints, dep->name, dep->component) != dep->fingerprint) return false;
+    }
+    return true;
+}
+
+// Сопоставление участков с прошлым анализом: одноимённые процедуры и одинаковые отрезки
+// кода вне процедур — по порядку появления
+static bool semantic_match_previous(semantic_unit_t *units, int count, const semantic_result_t *previous,
+                                    semantic_fingerprints_t *prints) {
+    if (previous->unit_count == 0) return true;
+    int total = previous->unit_count;
+    semantic_previous_t *sorted = malloc((size_t)total * sizeof(semantic_previous_t));
+    bool *used = calloc((size_t)total, sizeof(bool));
+    if (!sorted || !used) {
+        free(sorted);
+        free(used);
+        return false;
+    }
+    for (int i = 0; i < total; i++) sorted[i] = (semantic_previous_t){ previous->units[i].identity, i };
+    qsort(sorted, (size_t)total, sizeof(semantic_previous_t), semantic_previous_compare);
+
+    for (int i = 0; i < count; i++) {
+        int low = 0;
+        int high = total;
+        while (low < high) {
+            int middle = (low + high) / 2;
+            if (sorted[middle].identity < units[i].identity) low = middle + 1; else high = middle;
+        }
+        for (; low < total && sorted[low].identity == units[i].identity; low++) {
+            if (used[sorted[low].index]) continue;
+            used[sorted[low].index] = true;
+            const semantic_unit_summary_t *candidate = &previous->units[sorted[low].index];
+            if (semantic_unit_unchanged(&units[i], candidate, prints)) units[i].previous = candidate;
+            break;
+        }
+    }
+    free(sorted);
+    free(used);
+    return true;
+}
+
+// Сообщения и зависимости неизменного участка — копии из прошлого анализа
+static bool semantic_reuse_unit(semantic_unit_t *unit, const semantic_result_t *previous) {
+    const semantic_unit_summary_t *summary = unit->previous;
+    for (int i = 0; i < summary->diag_count; i++) {
+        const diagnostic_t *item = &previous->diagnostics.items[summary->diag_first + i];
+        if (!diag_report(&unit->diagnostics, item->severity, item->line, item->column, "%s", item->message)) return false;
+    }
+    if (summary->deps.count == 0) return true;
+    unit->deps.items = malloc((size_t)summary->deps.count * sizeof(semantic_dep_t));
+    if (!unit->deps.items) return false;
+    memcpy(unit->deps.items, summary->deps.items, (size_t)summary->deps.count * sizeof(semantic_dep_t));
+    unit->deps.count = unit->deps.capacity = summary->deps.count;
+    return true;
+}
+
+// Проверка участков, которые нельзя взять из прошлого анализа
+static bool semantic_check_units(ASTNode *root, semantic_collect_t *collect, thread_pool_t *pool,
+                                 semantic_result_t *result) {
+    int *order = malloc((size_t)(collect->count ? collect->count : 1) * sizeof(int));
+    int threads = pool ? thread_pool_size(pool) : 1;
+    symbol_table_t *tables = malloc((size_t)threads * sizeof(symbol_table_t));
+    if (!order || !tables) {
+        free(order);
+        free(tables);
+        return false;
+    }
+    int count = 0;
+    for (int i = 0; i < collect->count; i++) {
+        if (!collect->units[i].previous) order[count++] = i;
+    }
+    result->rechecked = count;
+
+    for (int i = 0; i < threads; i++) symbol_table_init(&tables[i], &result->globals);
+    semantic_run_t run = { root, collect->units, order, tables, &result->types, false };
+    if (pool && threads > 1) {
+        thread_pool_run(pool, (size_t)count, semantic_check_unit, &run);
+    } else {
+        for (int i = 0; i < count; i++) semantic_check_unit(&run, (size_t)i, 0);
+    }
+    for (int i = 0; i < threads; i++) symbol_table_free(&tables[i]);
+    free(tables);
+    free(order);
+    return !run.failed;
+}
+
+// Сводка участков для следующего анализа и слияние сообщений в исходном порядке
+static bool semantic_finish_units(semantic_collect_t *collect, const semantic_result_t *previous,
+                                  semantic_fingerprints_t *prints, semantic_result_t *result) {
+    result->units = calloc((size_t)(collect->count ? collect->count : 1), sizeof(semantic_unit_summary_t));
+    if (!result->units) return false;
+    result->unit_count = collect->count;
+
+    for (int i = 0; i < collect->count; i++) {
+        semantic_unit_t *unit = &collect->units[i];
+        if (unit->previous) {
+            if (!semantic_reuse_unit(unit, previous)) return false;
+        } else {
+            semantic_deps_finish(&unit->deps);
+            for (int d = 0; d < unit->deps.count; d++) {
+                semantic_dep_t *dep = &unit->deps.items[d];
+                dep->fingerprint = semantic_fingerprint(prints, dep->name, dep->component);
+            }
+        }
+
+        semantic_unit_summary_t *summary = &result->units[i];
+        summary->identity = unit->identity;
+        summary->body = unit->body;
+        summary->reused = unit->previous != NULL;
+        summary->deps = unit->deps;
+        memset(&unit->deps, 0, sizeof(unit->deps));
+        summary->diag_first = result->diagnostics.count;
+        if (!diag_list_append(&result->diagnostics, &unit->diagnostics)) return false;
+        summary->diag_count = result->diagnostics.count - summary->diag_first;
+    }
+    return true;
+}
+
+static bool semantic_run(ASTNode *root, const symbol_frozen_t *ddic, thread_pool_t *pool,
+                         const semantic_result_t *previous, semantic_result_t *result) {
+    memset(result, 0, sizeof(*result));
+    diag_list_init(&result->diagnostics);
+    if (!type_cache_init(&result->types)) return false;
+    if (!root) return true;
+
+    // Встроенные имена — отдельная таблица между DDIC и программой: объявление программы
+    // с тем же именем (DATA c) скрывает встроенное, а не повторяет его
+    symbol_table_t builtins;
+    symbol_table_init(&builtins, ddic);
+    bool ok = semantic_declare_builtins(&builtins) && symbol_table_freeze(&builtins, &result->builtins);
+    symbol_table_free(&builtins);
+    if (!ok) return false;
+
+    semantic_collect_t collect = { .program = root };
+    symbol_table_init(&collect.builder, &result->builtins);
+    semantic_hash_walk_t hash = { &collect, -1, -1, 0, 0 };
+    ast_visitor_t collector = { .pre_any = semantic_collect_node, .arg = &collect };
+    ast_visitor_t hasher = { .pre_any = semantic_hash_node, .post_any = semantic_hash_leave, .arg = &hash };
+    const ast_visitor_t *const visitors[] = { &collector, &hasher };
+    ok = ast_visit_fused(root, visitors, 2) && !collect.failed &&
+         symbol_table_freeze(&collect.builder, &result->globals);
+    symbol_table_free(&collect.builder);
+
+    semantic_fingerprints_t prints;
+    semantic_fingerprints_init(&prints, &result->globals, collect.duplicates, collect.duplicate_count);
+    if (ok && previous) ok = semantic_match_previous(collect.units, collect.count, previous, &prints);
+    ok = ok && semantic_check_units(root, &collect, pool, result);
+    ok = ok && semantic_finish_units(&collect, previous, &prints, result);
+    semantic_fingerprints_free(&prints);
+
+    for (int i = 0; i < collect.count; i++) {
+        semantic_deps_free(&collect.units[i].deps);
+        diag_list_free(&collect.units[i].diagnostics);
+    }
+    free(collect.units);
+    free(collect.duplicates);
+    return ok;
+}
+
+bool semantic_analyze(ASTNode *root, const symbol_frozen_t *ddic, thread_pool_t *pool,
+                      semantic_result_t *result) {
+    return semantic_run(root, ddic, pool, NULL, result);
+}
+
+bool semantic_reanalyze(ASTNode *root, const symbol_frozen_t *ddic, thread_pool_t *pool,
+                        const semantic_result_t *previous, semantic_result_t *result) {
+    return semantic_run(root, ddic, pool, previous, result);
+}
+
+void semantic_result_free(semantic_result_t *result) {
+    symbol_frozen_free(&result->globals);
+    symbol_frozen_free(&result->builtins);
+    type_cache_free(&result->types);
+    diag_list_free(&result->diagnostics);
+    for (int i = 0; i < result->unit_count; i++) semantic_deps_free(&result->units[i].deps);
+    free(result->units);
+    result->units = NULL;
+    result->unit_count = 0;
+}
+
+int semantic_check(ASTNode *root) {
+    semantic_result_t result;
+    bool ok = semantic_analyze(root, NULL, NULL, &result);
+    diag_list_print(&result.diagnostics, stderr, NULL);
+    ok = ok && result.diagnostics.error_count == 0;
+    semantic_result_free(&result);
+    return ok;
+}
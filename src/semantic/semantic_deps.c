@@ -0,0 +1,351 @@
+#include "semantic.h"
+#include "ast_visitor.h"
+#include "class_summary.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file semantic_deps.c
+ * @brief Зависимости участков от глобальных имён и отпечатки этих имён.
+ *
+ * Во время проверки участок записывает каждое глобальное имя, которое он искал, —
+ * в том числе ненайденное: объявление, добавленное позже, меняет результат поиска.
+ * Отпечаток имени — хеш его объявления, вида символа и числа повторных объявлений;
+ * у типов и объектов данных в него входят и отпечатки типов, на которые ссылается
+ * объявление, поэтому правка TYPES в середине цепочки меняет отпечатки всей цепочки.
+ * Зависимость от компонента класса или интерфейса (lcl=>meth, if~meth) хеширует
+ * только объявление этого компонента: правка сигнатуры одного метода не задевает
+ * участки, вызывающие другие. У класса из сводки (class_summary.h) объявления в
+ * дереве нет, и вместо него хешируется source_hash символа: хеш исходника для
+ * самого класса, хеш записи и раскладка для компонента.
+ *
+ * Имена входят в хеши текстом, а не номером атома, а раскладки DDIC — содержимым,
+ * а не адресом: отпечатки не зависят от порядка интернирования и от того, где
+ * процесс разместил раскладку, поэтому их можно сравнивать между запусками.
+ */
+
+#define SEMANTIC_DEPS_INITIAL   16
+#define SEMANTIC_HASH_ABSENT    0x9ae16a3b2f90404full   // Имя не объявлено
+
+static inline uint64_t semantic_hash_mix(uint64_t hash, uint64_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    return hash * 0x100000001b3ull;
+}
+
+static uint64_t semantic_hash_text(uint64_t hash, const char *text) {
+    for (; text && *text; text++) hash = semantic_hash_mix(hash, (unsigned char)*text);
+    return semantic_hash_mix(hash, 0);
+}
+
+// Имя — текстом: номер атома зависит от порядка интернирования в процессе
+static uint64_t semantic_hash_atom(uint64_t hash, atom_t atom) {
+    return atom == ATOM_NONE ? semantic_hash_mix(hash, 0) : semantic_hash_text(semantic_hash_mix(hash, 1), atom_text(atom));
+}
+
+// Кадр обхода раскладки: ссылка на раскладку выше по цепочке (ссылка на себя через
+// REF TO) хешируется расстоянием до неё
+typedef struct semantic_layout_frame {
+    const TypeInfo *type;
+    const struct semantic_layout_frame *outer;
+} semantic_layout_frame_t;
+
+// Хеш содержимого раскладки: вид, размеры, компоненты со смещениями, тип строки
+static uint64_t semantic_layout_hash(uint64_t hash, const TypeInfo *type, const semantic_layout_frame_t *outer) {
+    if (!type) return semantic_hash_mix(hash, SEMANTIC_HASH_ABSENT);
+    uint64_t distance = 1;
+    for (const semantic_layout_frame_t *frame = outer; frame; frame = frame->outer, distance++) {
+        if (frame->type == type) return semantic_hash_mix(semantic_hash_mix(hash, SEMANTIC_HASH_SEED), distance);
+    }
+    semantic_layout_frame_t frame = { type, outer };
+    hash = semantic_hash_atom(hash, type->name);
+    hash = semantic_hash_mix(hash, (uint64_t)type->kind);
+    hash = semantic_hash_mix(hash, (uint64_t)type->elementary);
+    hash = semantic_hash_mix(hash, type->length);
+    hash = semantic_hash_mix(hash, type->decimals);
+    hash = semantic_hash_mix(hash, type->size);
+    hash = semantic_hash_mix(hash, type->align);
+    hash = semantic_hash_mix(hash, (uint64_t)type->deep << 1 | type->cyclic);
+    hash = semantic_hash_mix(hash, (uint64_t)type->component_count);
+    for (int i = 0; i < type->component_count; i++) {
+        hash = semantic_hash_atom(hash, type->components[i].name);
+        hash = semantic_hash_mix(hash, type->components[i].offset);
+        hash = semantic_layout_hash(hash, type->components[i].type, &frame);
+    }
+    return semantic_layout_hash(hash, type->line, &frame);
+}
+
+uint64_t semantic_type_hash(const TypeInfo *type) {
+    return semantic_layout_hash(SEMANTIC_HASH_SEED, type, NULL);
+}
+
+uint64_t semantic_tree_hash_add(uint64_t hash, const ASTNode *node) {
+    hash = semantic_hash_mix(hash, (uint64_t)node->type);
+    hash = semantic_hash_atom(hash, node->atom);
+    hash = semantic_hash_text(hash, node->string_value);
+    return semantic_hash_mix(hash, (uint64_t)node->child_count);
+}
+
+uint64_t semantic_statements_hash_add(uint64_t hash, uint64_t statement) {
+    return semantic_hash_mix(hash, statement);
+}
+
+static ast_visit_result_t semantic_tree_hash_node(ASTNode *node, ASTNode *parent, void *arg) {
+    (void)parent;
+    uint64_t *hash = arg;
+    *hash = semantic_tree_hash_add(*hash, node);
+    return AST_VISIT_CONTINUE;
+}
+
+uint64_t semantic_tree_hash(const ASTNode *node) {
+    uint64_t hash = SEMANTIC_HASH_SEED;
+    if (!node) return hash;
+    // Прямой порядок вместе с числом потомков однозначно задаёт форму дерева
+    ast_visitor_t visitor = { .pre_any = semantic_tree_hash_node, .arg = &hash };
+    ast_visit((ASTNode *)node, &visitor);
+    return hash;
+}
+
+uint64_t semantic_statements_hash(ASTNode *const *statements, int count) {
+    uint64_t hash = SEMANTIC_HASH_SEED;
+    for (int i = 0; i < count; i++) hash = semantic_statements_hash_add(hash, semantic_tree_hash(statements[i]));
+    return hash;
+}
+
+uint64_t semantic_procedure_identity(const ASTNode *procedure, atom_t class_name) {
+    uint64_t hash = semantic_hash_mix(SEMANTIC_HASH_SEED, (uint64_t)procedure->type);
+    hash = semantic_hash_atom(hash, class_name);
+    return semantic_hash_atom(hash, procedure->atom);
+}
+
+// ---------------------------------------------------------------------------
+// Запись зависимостей
+
+static void semantic_deps_push(semantic_deps_t *deps, atom_t name, atom_t component) {
+    if (deps->count > 0) {
+        const semantic_dep_t *last = &deps->items[deps->count - 1];
+        if (last->name == name && last->component == component) return;     // Частый случай: имя подряд
+    }
+    if (deps->count == deps->capacity) {
+        int capacity = deps->capacity ? deps->capacity * 2 : SEMANTIC_DEPS_INITIAL;
+        semantic_dep_t *items = realloc(deps->items, (size_t)capacity * sizeof(semantic_dep_t));
+        if (!items) {
+            deps->failed = true;
+            return;
+        }
+        deps->items = items;
+        deps->capacity = capacity;
+    }
+    deps->items[deps->count++] = (semantic_dep_t){ name, component, 0 };
+}
+
+void semantic_depend(const semantic_context_t *context, atom_t name, atom_t component) {
+    if (context->deps && name != ATOM_NONE) semantic_deps_push(context->deps, name, component);
+}
+
+static int semantic_dep_compare(const void *a, const void *b) {
+    const semantic_dep_t *x = a;
+    const semantic_dep_t *y = b;
+    if (x->name != y->name) return x->name < y->name ? -1 : 1;
+    if (x->component != y->component) return x->component < y->component ? -1 : 1;
+    return 0;
+}
+
+void semantic_deps_finish(semantic_deps_t *deps) {
+    if (deps->count < 2) return;
+    qsort(deps->items, (size_t)deps->count, sizeof(semantic_dep_t), semantic_dep_compare);
+    int count = 1;
+    for (int i = 1; i < deps->count; i++) {
+        if (semantic_dep_compare(&deps->items[i], &deps->items[count - 1]) != 0) deps->items[count++] = deps->items[i];
+    }
+    deps->count = count;
+}
+
+void semantic_deps_free(semantic_deps_t *deps) {
+    free(deps->items);
+    memset(deps, 0, sizeof(*deps));
+}
+
+// ---------------------------------------------------------------------------
+// Отпечатки
+
+static int semantic_atom_compare(const void *a, const void *b) {
+    atom_t x = *(const atom_t *)a;
+    atom_t y = *(const atom_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+void semantic_fingerprints_init(semantic_fingerprints_t *prints, const symbol_frozen_t *globals,
+                                atom_t *duplicates, int duplicate_count) {
+    memset(prints, 0, sizeof(*prints));
+    prints->globals = globals;
+    prints->duplicates = duplicates;
+    prints->duplicate_count = duplicate_count;
+    if (duplicate_count > 1) qsort(duplicates, (size_t)duplicate_count, sizeof(atom_t), semantic_atom_compare);
+}
+
+void semantic_fingerprints_free(semantic_fingerprints_t *prints) {
+    free(prints->entries);
+    prints->entries = NULL;
+    prints->capacity = prints->count = 0;
+}
+
+static semantic_print_entry_t *semantic_print_probe(semantic_print_entry_t *entries, size_t capacity, uint64_t key) {
+    size_t index = (size_t)((key * 0x9e3779b97f4a7c15ull) >> 32) & (capacity - 1);
+    while (entries[index].key && entries[index].key != key) index = (index + 1) & (capacity - 1);
+    return &entries[index];
+}
+
+static void semantic_print_store(semantic_fingerprints_t *prints, uint64_t key, uint64_t fingerprint) {
+    if ((prints->count + 1) * 2 > prints->capacity) {
+        size_t capacity = prints->capacity ? prints->capacity * 2 : 256;
+        semantic_print_entry_t *entries = calloc(capacity, sizeof(semantic_print_entry_t));
+        if (!entries) return;       // Без памяти отпечаток просто не запоминается
+        for (size_t i = 0; i < prints->capacity; i++) {
+            if (prints->entries[i].key) *semantic_print_probe(entries, capacity, prints->entries[i].key) = prints->entries[i];
+        }
+        free(prints->entries);
+        prints->entries = entries;
+        prints->capacity = capacity;
+    }
+    semantic_print_entry_t *entry = semantic_print_probe(prints->entries, prints->capacity, key);
+    if (!entry->key) prints->count++;
+    entry->key = key;
+    entry->fingerprint = fingerprint;
+}
+
+// Сколько раз имя объявлено в программе повторно
+static int semantic_duplicates_of(const semantic_fingerprints_t *prints, atom_t name) {
+    int low = 0;
+    int high = prints->duplicate_count;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (prints->duplicates[middle] < name) low = middle + 1; else high = middle;
+    }
+    int count = 0;
+    while (low + count < prints->duplicate_count && prints->duplicates[low + count] == name) count++;
+    return count;
+}
+
+// Первый узел поддерева (кроме корня и ссылок TYPE/LIKE) с данным атомом — объявление компонента
+typedef struct {
+    const ASTNode *root;
+    atom_t name;
+    const ASTNode *found;
+} semantic_component_find_t;
+
+static ast_visit_result_t semantic_component_node(ASTNode *node, ASTNode *parent, void *arg) {
+    (void)parent;
+    semantic_component_find_t *find = arg;
+    if (node != find->root && node->atom == find->name && node->type != AST_TYPE_SPEC &&
+        node->type != AST_LIKE_SPEC && node->type != AST_LINE_OF_SPEC) {
+        find->found = node;
+        return AST_VISIT_STOP;
+    }
+    return AST_VISIT_CONTINUE;
+}
+
+// Кадр цепочки вычисляемых отпечатков (цикл TYPES a TYPE b, TYPES b TYPE a)
+typedef struct semantic_print_frame {
+    atom_t name;
+    int depth;
+    const struct semantic_print_frame *outer;
+} semantic_print_frame_t;
+
+static uint64_t semantic_fingerprint_in(semantic_fingerprints_t *prints, atom_t name, atom_t component,
+                                        const semantic_print_frame_t *outer, int *lowest);
+
+// Аргумент обхода ссылок на типы в объявлении
+typedef struct {
+    semantic_fingerprints_t *prints;
+    const semantic_print_frame_t *frame;
+    uint64_t hash;
+    int lowest;
+} semantic_type_refs_t;
+
+static ast_visit_result_t semantic_type_ref_node(ASTNode *node, ASTNode *parent, void *arg) {
+    (void)parent;
+    semantic_type_refs_t *refs = arg;
+    if ((node->type != AST_TYPE_SPEC && node->type != AST_LIKE_SPEC && node->type != AST_LINE_OF_SPEC) ||
+        node->atom == ATOM_NONE) {
+        return AST_VISIT_CONTINUE;
+    }
+    // struct-comp: раскладка зависит от всей структуры
+    const char *text = atom_text(node->atom);
+    const char *dash = strchr(text, '-');
+    atom_t name = dash && dash != text ? atom_intern(text, (size_t)(dash - text)) : node->atom;
+    int lowest = refs->frame->depth + 1;
+    refs->hash = semantic_hash_mix(refs->hash, semantic_fingerprint_in(refs->prints, name, ATOM_NONE, refs->frame, &lowest));
+    if (lowest < refs->lowest) refs->lowest = lowest;
+    return AST_VISIT_CONTINUE;
+}
+
+static uint64_t semantic_fingerprint_in(semantic_fingerprints_t *prints, atom_t name, atom_t component,
+                                        const semantic_print_frame_t *outer, int *lowest) {
+    uint64_t key = (uint64_t)name << 32 | component;
+    if (prints->capacity) {
+        const semantic_print_entry_t *entry = semantic_print_probe(prints->entries, prints->capacity, key);
+        if (entry->key == key) return entry->fingerprint;
+    }
+    if (component == ATOM_NONE) {
+        for (const semantic_print_frame_t *frame = outer; frame; frame = frame->outer) {
+            if (frame->name == name) {
+                if (frame->depth < *lowest) *lowest = frame->depth;
+                return SEMANTIC_HASH_SEED;
+            }
+        }
+    }
+
+    const symbol_t *symbol = symbol_frozen_lookup(prints->globals, name);
+    if (!symbol) {
+        semantic_print_store(prints, key, SEMANTIC_HASH_ABSENT);
+        return SEMANTIC_HASH_ABSENT;
+    }
+
+    uint64_t hash = semantic_hash_mix(SEMANTIC_HASH_SEED, (uint64_t)symbol->kind);
+    hash = semantic_hash_mix(hash, (uint64_t)semantic_duplicates_of(prints, name));
+    if (symbol->source_hash && component != ATOM_NONE) {
+        // Класс из сводки: компонент — отдельный символ "класс=>компонент" (class_summary_declare())
+        atom_t member = class_summary_member(name, "=>", component, false);
+        hash = semantic_hash_mix(hash, member != ATOM_NONE ? semantic_fingerprint_in(prints, member, ATOM_NONE, outer, lowest)
+                                                           : SEMANTIC_HASH_ABSENT);
+    } else if (symbol->source_hash) {
+        hash = semantic_hash_mix(hash, symbol->source_hash);    // Хеш исходника или записи компонента
+    }
+    const ASTNode *decl = symbol->decl;
+    if (decl && component != ATOM_NONE) {
+        semantic_component_find_t find = { decl, component, NULL };
+        ast_visitor_t visitor = { .pre_any = semantic_component_node, .arg = &find };
+        ast_visit((ASTNode *)decl, &visitor);
+        decl = find.found;
+        if (!decl) hash = semantic_hash_mix(hash, SEMANTIC_HASH_ABSENT);
+    }
+
+    semantic_print_frame_t frame = { name, outer ? outer->depth + 1 : 0, outer };
+    int depth = frame.depth;
+    if (decl) {
+        // Форма объявления и ссылки на типы в нём — за один обход
+        uint64_t tree = SEMANTIC_HASH_SEED;
+        semantic_type_refs_t refs = { prints, &frame, hash, depth + 1 };
+        ast_visitor_t hasher = { .pre_any = semantic_tree_hash_node, .arg = &tree };
+        ast_visitor_t referrer = { .pre_any = semantic_type_ref_node, .arg = &refs };
+        const ast_visitor_t *const visitors[] = { &hasher, &referrer };
+        ast_visit_fused((ASTNode *)decl, visitors, 2);
+        hash = semantic_hash_mix(refs.hash, tree);
+        if (refs.lowest < *lowest) *lowest = refs.lowest;
+        depth = refs.lowest < depth ? refs.lowest : depth;
+    } else if (symbol->type) {
+        hash = semantic_layout_hash(hash, symbol->type, NULL);      // Раскладка DDIC
+    } else {
+        hash = semantic_hash_atom(hash, name);                      // Встроенное имя
+    }
+
+    // Отпечаток, при вычислении которого встретилось объявление выше по цепочке, неполон:
+    // он запоминается только у того, с кого цикл начался
+    if (depth >= frame.depth) semantic_print_store(prints, key, hash);
+    return hash;
+}
+
+uint64_t semantic_fingerprint(semantic_fingerprints_t *prints, atom_t name, atom_t component) {
+    int lowest = 0;
+    return semantic_fingerprint_in(prints, name, component, NULL, &lowest);
+}
@@ -0,0 +1,220 @@
+#include "symbol_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file symbol_table.c
+ * @brief Таблица символов с областями видимости и замороженная таблица глобальных символов.
+ *
+ * Устройство:
+ *  - хеш с открытой адресацией и линейным пробированием; слот хранит атом имени и
+ *    индекс видимого объявления, поэтому проба не обращается к массиву символов;
+ *  - атомы — последовательные номера, поэтому слот выбирается умножением Фибоначчи
+ *    (старшие биты произведения), а не по младшим битам атома;
+ *  - закрытие области снимает её объявления с конца стека: имя либо снова указывает
+ *    на скрытое объявление, либо удаляется из хеша со сдвигом следующих слотов назад
+ *    (без надгробий, хеш не деградирует от частых входов и выходов из областей).
+ */
+
+#define SYMBOL_INITIAL_BITS     4
+#define SYMBOL_INITIAL_SYMBOLS  64
+#define SYMBOL_INITIAL_SCOPES   16
+
+static inline uint32_t symbol_hash(atom_t name, uint32_t shift) {
+    return (uint32_t)(name * 2654435769u) >> shift;
+}
+
+static inline uint32_t symbol_mask(uint32_t shift) {
+    return (1u << (32 - shift)) - 1;
+}
+
+// Слот имени: либо занятый этим именем, либо первый пустой
+static symbol_slot_t *symbol_probe(symbol_slot_t *slots, uint32_t shift, atom_t name) {
+    uint32_t mask = symbol_mask(shift);
+    uint32_t index = symbol_hash(name, shift);
+    while (slots[index].name != ATOM_NONE && slots[index].name != name) {
+        index = (index + 1) & mask;
+    }
+    return &slots[index];
+}
+
+// Удаление слота со сдвигом назад тех следующих слотов, которые пробой достигаются через него
+static void symbol_slot_remove(symbol_slot_t *slots, uint32_t shift, uint32_t hole) {
+    uint32_t mask = symbol_mask(shift);
+    for (uint32_t index = (hole + 1) & mask; slots[index].name != ATOM_NONE; index = (index + 1) & mask) {
+        uint32_t home = symbol_hash(slots[index].name, shift);
+        if (((index - home) & mask) >= ((index - hole) & mask)) {
+            slots[hole] = slots[index];
+            hole = index;
+        }
+    }
+    slots[hole].name = ATOM_NONE;
+}
+
+// Хеш на 2^(32 - shift) слотов по символам с различными именами
+static symbol_slot_t *symbol_slots_build(const symbol_t *symbols, int count, uint32_t shift) {
+    symbol_slot_t *slots = calloc((size_t)symbol_mask(shift) + 1, sizeof(symbol_slot_t));
+    if (!slots) return NULL;
+    for (int i = 0; i < count; i++) {
+        symbol_slot_t *slot = symbol_probe(slots, shift, symbols[i].name);
+        slot->name = symbols[i].name;
+        slot->symbol = i;
+    }
+    return slots;
+}
+
+// Число бит хеша, при котором count имён занимают не больше половины слотов
+static uint32_t symbol_bits_for(int count) {
+    uint32_t bits = SYMBOL_INITIAL_BITS;
+    while (((size_t)1 << bits) < (size_t)count * 2) bits++;
+    return bits;
+}
+
+void symbol_table_init(symbol_table_t *table, const symbol_frozen_t *globals) {
+    memset(table, 0, sizeof(*table));
+    table->shift = 32 - SYMBOL_INITIAL_BITS;
+    table->globals = globals;
+}
+
+void symbol_table_free(symbol_table_t *table) {
+    free(table->symbols);
+    free(table->slots);
+    free(table->scopes);
+    symbol_table_init(table, NULL);
+}
+
+bool symbol_table_push(symbol_table_t *table) {
+    if (table->depth == table->scope_capacity) {
+        int capacity = table->scope_capacity ? table->scope_capacity * 2 : SYMBOL_INITIAL_SCOPES;
+        int *scopes = realloc(table->scopes, (size_t)capacity * sizeof(int));
+        if (!scopes) return false;
+        table->scopes = scopes;
+        table->scope_capacity = capacity;
+    }
+    table->scopes[table->depth++] = table->count;
+    return true;
+}
+
+void symbol_table_pop(symbol_table_t *table) {
+    if (table->depth == 0) return;
+    int start = table->scopes[--table->depth];
+    for (int i = table->count - 1; i >= start; i--) {
+        const symbol_t *symbol = &table->symbols[i];
+        symbol_slot_t *slot = symbol_probe(table->slots, table->shift, symbol->name);
+        if (symbol->shadowed >= 0) {
+            slot->symbol = symbol->shadowed;
+        } else {
+            symbol_slot_remove(table->slots, table->shift, (uint32_t)(slot - table->slots));
+            table->used--;
+        }
+    }
+    table->count = start;
+}
+
+// Рост хеша вдвое с перестроением по видимым именам
+static bool symbol_table_grow(symbol_table_t *table) {
+    uint32_t shift = table->slots ? table->shift - 1 : table->shift;
+    symbol_slot_t *slots = calloc((size_t)symbol_mask(shift) + 1, sizeof(symbol_slot_t));
+    if (!slots) return false;
+    uint32_t old_size = table->slots ? symbol_mask(table->shift) + 1 : 0;
+    for (uint32_t i = 0; i < old_size; i++) {
+        if (table->slots[i].name == ATOM_NONE) continue;
+        *symbol_probe(slots, shift, table->slots[i].name) = table->slots[i];
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->shift = shift;
+    return true;
+}
+
+symbol_t *symbol_table_declare(symbol_table_t *table, atom_t name, symbol_kind_t kind,
+                               struct TypeInfo *type, const ASTNode *decl, bool *added) {
+    if (added) *added = false;
+    symbol_slot_t *slot = table->slots ? symbol_probe(table->slots, table->shift, name) : NULL;
+    if (slot && slot->name == name && table->symbols[slot->symbol].scope == table->depth) {
+        return &table->symbols[slot->symbol];
+    }
+
+    if (!slot || (slot->name == ATOM_NONE && (size_t)(table->used + 1) * 2 > (size_t)symbol_mask(table->shift) + 1)) {
+        if (!symbol_table_grow(table)) return NULL;
+        slot = symbol_probe(table->slots, table->shift, name);
+    }
+    if (table->count == table->capacity) {
+        int capacity = table->capacity ? table->capacity * 2 : SYMBOL_INITIAL_SYMBOLS;
+        symbol_t *symbols = realloc(table->symbols, (size_t)capacity * sizeof(symbol_t));
+        if (!symbols) return NULL;
+        table->symbols = symbols;
+        table->capacity = capacity;
+    }
+
+    symbol_t *symbol = &table->symbols[table->count];
+    symbol->name = name;
+    symbol->kind = kind;
+    symbol->scope = table->depth;
+    symbol->shadowed = slot->name == name ? slot->symbol : -1;
+    symbol->type = type;
+    symbol->decl = decl;
+    symbol->source_hash = 0;
+    if (slot->name == ATOM_NONE) {
+        slot->name = name;
+        table->used++;
+    }
+    slot->symbol = table->count++;
+    if (added) *added = true;
+    return symbol;
+}
+
+const symbol_t *symbol_table_lookup(const symbol_table_t *table, atom_t name) {
+    if (table->slots) {
+        const symbol_slot_t *slot = symbol_probe(table->slots, table->shift, name);
+        if (slot->name == name) return &table->symbols[slot->symbol];
+    }
+    return symbol_frozen_lookup(table->globals, name);
+}
+
+const symbol_t *symbol_table_lookup_local(const symbol_table_t *table, atom_t name) {
+    if (!table->slots) return NULL;
+    const symbol_slot_t *slot = symbol_probe(table->slots, table->shift, name);
+    if (slot->name != name || table->symbols[slot->symbol].scope != table->depth) return NULL;
+    return &table->symbols[slot->symbol];
+}
+
+bool symbol_table_freeze(const symbol_table_t *table, symbol_frozen_t *frozen) {
+    memset(frozen, 0, sizeof(*frozen));
+    frozen->symbols = malloc((size_t)(table->used ? table->used : 1) * sizeof(symbol_t));
+    if (!frozen->symbols) return false;
+
+    // Видимые объявления — те, на которые указывает слот их имени
+    for (int i = 0; i < table->count; i++) {
+        const symbol_t *symbol = &table->symbols[i];
+        if (symbol_probe(table->slots, table->shift, symbol->name)->symbol != i) continue;
+        symbol_t *copy = &frozen->symbols[frozen->count++];
+        *copy = *symbol;
+        copy->scope = 0;
+        copy->shadowed = -1;
+    }
+
+    frozen->outer = table->globals;
+    frozen->shift = 32 - symbol_bits_for(frozen->count);
+    frozen->slots = symbol_slots_build(frozen->symbols, frozen->count, frozen->shift);
+    if (!frozen->slots) {
+        symbol_frozen_free(frozen);
+        return false;
+    }
+    return true;
+}
+
+const symbol_t *symbol_frozen_lookup(const symbol_frozen_t *frozen, atom_t name) {
+    for (; frozen; frozen = frozen->outer) {
+        if (!frozen->slots) continue;
+        const symbol_slot_t *slot = symbol_probe(frozen->slots, frozen->shift, name);
+        if (slot->name == name) return &frozen->symbols[slot->symbol];
+    }
+    return NULL;
+}
+
+void symbol_frozen_free(symbol_frozen_t *frozen) {
+    free(frozen->symbols);
+    free(frozen->slots);
+    memset(frozen, 0, sizeof(*frozen));
+}
@@ -0,0 +1,94 @@
+#include "semantic.h"
+
+/**
+ * @file type_checker.c
+ * @brief Проверки типов по видам символов: TYPE ссылается на тип, LIKE и операнды —
+ *        на объекты данных, присваивание — на изменяемый объект; раскладка объекта
+ *        данных не зависит от самой себя.
+ *
+ * Функции вызываются из фазы проверки semantic_analyze() в потоках пула; состояние
+ * у них только в контексте участка, глобальные таблицы лишь читаются.
+ */
+
+static bool type_is_data_object(symbol_kind_t kind) {
+    switch (kind) {
+        case SYMBOL_VARIABLE:
+        case SYMBOL_CONSTANT:
+        case SYMBOL_PARAMETER:
+        case SYMBOL_FIELD_SYMBOL:
+        case SYMBOL_ATTRIBUTE:
+        case SYMBOL_TABLE:          // TABLES: рабочая область с именем таблицы
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Имя, на которое можно сослаться в TYPE: типы, таблицы DDIC (их строка), классы и интерфейсы (TYPE REF TO)
+static bool type_is_type(symbol_kind_t kind) {
+    return kind == SYMBOL_TYPE || kind == SYMBOL_TABLE || kind == SYMBOL_CLASS || kind == SYMBOL_INTERFACE;
+}
+
+// Ссылка на имя, которое должно быть объявлено; NULL — сообщение уже записано (или не нужно)
+static const symbol_t *type_resolve(semantic_context_t *context, atom_t name, const char *what) {
+    const symbol_t *symbol = semantic_resolve(context, name);
+    if (!symbol && context->resolve_names) {
+        diag_report(context->diagnostics, DIAG_ERROR, 0, 0, "Unknown %s '%s'", what, atom_text(name));
+    }
+    return symbol;
+}
+
+void type_check_declaration(semantic_context_t *context, const ASTNode *declaration) {
+    for (int i = 0; i < declaration->child_count; i++) {
+        const ASTNode *spec = declaration->children[i];
+        if (!spec || spec->atom == ATOM_NONE) continue;
+        if (spec->type == AST_TYPES_DECL) {
+            type_check_declaration(context, spec);      // Компонент TYPES BEGIN OF
+        } else if (spec->type == AST_TYPE_SPEC) {
+            const symbol_t *symbol = type_resolve(context, spec->atom, "type");
+            if (symbol && !type_is_type(symbol->kind)) {
+                diag_report(context->diagnostics, DIAG_ERROR, 0, 0, "'%s' is not a type", atom_text(spec->atom));
+            }
+        } else if (spec->type == AST_LIKE_SPEC) {
+            const symbol_t *symbol = type_resolve(context, spec->atom, "data object");
+            if (symbol && !type_is_data_object(symbol->kind)) {
+                diag_report(context->diagnostics, DIAG_ERROR, 0, 0, "'%s' is not a data object (LIKE)",
+                            atom_text(spec->atom));
+            }
+        }
+    }
+
+    // Объекту данных нужна раскладка: она и типы, от которых она зависит, вычисляются
+    // здесь; объявления TYPES, на которые никто не ссылается, так и не разбираются
+    if (declaration->type == AST_DATA_DECL || declaration->type == AST_CONSTANT_DECL ||
+        declaration->type == AST_PARAMETERS_DECL) {
+        if (type_resolve_decl(context, declaration)->cyclic) {
+            diag_report(context->diagnostics, DIAG_ERROR, 0, 0, "Type of '%s' has a cyclic definition",
+                        atom_text(declaration->atom));
+        }
+    }
+}
+
+void type_check_assignment(semantic_context_t *context, const ASTNode *assignment) {
+    if (assignment->child_count == 0) return;
+    const ASTNode *target = assignment->children[0];
+    if (!target || target->type != AST_VARIABLE || target->atom == ATOM_NONE) return;
+
+    const symbol_t *symbol = type_resolve(context, target->atom, "name");
+    if (!symbol) return;
+    if (symbol->kind == SYMBOL_CONSTANT) {
+        diag_report(context->diagnostics, DIAG_ERROR, 0, 0, "Cannot assign to constant '%s'", atom_text(target->atom));
+    } else if (symbol->name == target->atom && !type_is_data_object(symbol->kind)) {
+        diag_report(context->diagnostics, DIAG_ERROR, 0, 0, "'%s' is not a data object", atom_text(target->atom));
+    }
+}
+
+void type_check_operand(semantic_context_t *context, const ASTNode *operand) {
+    if (operand->atom == ATOM_NONE) return;
+    const symbol_t *symbol = type_resolve(context, operand->atom, "name");
+    // class=>attr и ref->meth( ) начинаются с имени класса или ссылки: проверяется только
+    // простое имя
+    if (symbol && symbol->name == operand->atom && !type_is_data_object(symbol->kind)) {
+        diag_report(context->diagnostics, DIAG_ERROR, 0, 0, "'%s' is not a data object", atom_text(operand->atom));
+    }
+}
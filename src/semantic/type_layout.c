@@ -0,0 +1,394 @@
+#include "type_layout.h"
+#include "semantic.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file type_layout.c
+ * @brief Раскладка типов по требованию: встроенные типы, структуры, кэш раскладок и
+ *        разрешение объявлений TYPES/DATA с обнаружением циклов.
+ *
+ * Объявление разбирается при первом обращении к нему и запоминается в общем кэше по
+ * адресу узла. Объявления, которые разбираются сейчас, образуют цепочку кадров на стеке
+ * вызывающего потока: повторная встреча объявления в цепочке — цикл (TYPES a TYPE b,
+ * TYPES b TYPE a). Цепочка у каждого потока своя, поэтому два потока, одновременно
+ * разбирающие разные концы одной цепочки зависимостей, не принимают друг друга за цикл.
+ *
+ * Всё, что зависит от объявления из цепочки, само лежит на цикле, поэтому результат
+ * type_cyclic можно запомнить для каждого объявления, через которое он прошёл.
+ */
+
+#define TYPE_CHAR_SIZE          2       // Символ C/N/D/T — UCS-2
+#define TYPE_CACHE_INITIAL      64
+
+const TypeInfo type_unknown = { .kind = TYPE_KIND_INVALID };
+const TypeInfo type_cyclic = { .kind = TYPE_KIND_INVALID, .cyclic = true };
+
+// Встроенные типы; длина и размер — по умолчанию (C — 1 символ, P — 8 байт)
+static const struct {
+    const char *name;
+    TypeInfo type;
+} type_builtins[] = {
+    { "C",          { .elementary = TYPE_C,          .length = 1,  .size = TYPE_CHAR_SIZE,     .align = TYPE_CHAR_SIZE } },
+    { "N",          { .elementary = TYPE_N,          .length = 1,  .size = TYPE_CHAR_SIZE,     .align = TYPE_CHAR_SIZE } },
+    { "D",          { .elementary = TYPE_D,          .length = 8,  .size = 8 * TYPE_CHAR_SIZE, .align = TYPE_CHAR_SIZE } },
+    { "T",          { .elementary = TYPE_T,          .length = 6,  .size = 6 * TYPE_CHAR_SIZE, .align = TYPE_CHAR_SIZE } },
+    { "X",          { .elementary = TYPE_X,          .length = 1,  .size = 1,  .align = 1 } },
+    { "P",          { .elementary = TYPE_P,          .length = 8,  .size = 8,  .align = 1 } },
+    { "I",          { .elementary = TYPE_I,          .length = 4,  .size = 4,  .align = 4 } },
+    { "INT1",       { .elementary = TYPE_INT1,       .length = 1,  .size = 1,  .align = 1 } },
+    { "INT2",       { .elementary = TYPE_INT2,       .length = 2,  .size = 2,  .align = 2 } },
+    { "INT8",       { .elementary = TYPE_INT8,       .length = 8,  .size = 8,  .align = 8 } },
+    { "F",          { .elementary = TYPE_F,          .length = 8,  .size = 8,  .align = 8 } },
+    { "DECFLOAT16", { .elementary = TYPE_DECFLOAT16, .length = 8,  .size = 8,  .align = 8 } },
+    { "DECFLOAT34", { .elementary = TYPE_DECFLOAT34, .length = 16, .size = 16, .align = 8 } },
+    { "UTCLONG",    { .elementary = TYPE_UTCLONG,    .length = 8,  .size = 8,  .align = 8 } },
+    { "STRING",     { .elementary = TYPE_STRING,     .size = sizeof(void *), .align = sizeof(void *), .deep = true } },
+    { "XSTRING",    { .elementary = TYPE_XSTRING,    .size = sizeof(void *), .align = sizeof(void *), .deep = true } },
+    { "ABAP_BOOL",  { .elementary = TYPE_C,          .length = 1,  .size = TYPE_CHAR_SIZE,     .align = TYPE_CHAR_SIZE } },
+};
+
+const TypeInfo *type_builtin(atom_t name) {
+    if (name == ATOM_NONE) return NULL;
+    const char *text = atom_text(name);
+    for (size_t i = 0; i < sizeof(type_builtins) / sizeof(type_builtins[0]); i++) {
+        if (strcmp(type_builtins[i].name, text) == 0) return &type_builtins[i].type;
+    }
+    return NULL;
+}
+
+static size_t type_align_up(size_t offset, size_t align) {
+    return (offset + align - 1) / align * align;
+}
+
+TypeInfo *type_elementary_sized(const TypeInfo *base, unsigned length, unsigned decimals) {
+    TypeInfo *type = malloc(sizeof(TypeInfo));
+    if (!type) return NULL;
+    *type = *base;
+    type->name = ATOM_NONE;
+    // LENGTH меняет размер только у типов с настраиваемой длиной
+    if (length) {
+        switch (base->elementary) {
+            case TYPE_C:
+            case TYPE_N:
+                type->length = length;
+                type->size = (size_t)length * TYPE_CHAR_SIZE;
+                break;
+            case TYPE_X:
+            case TYPE_P:
+                type->length = length;
+                type->size = length;
+                break;
+            default:
+                break;
+        }
+    }
+    if (base->elementary == TYPE_P) type->decimals = decimals;
+    return type;
+}
+
+TypeInfo *type_structure_create(atom_t name, const type_component_t *components, int count) {
+    TypeInfo *type = malloc(sizeof(TypeInfo) + (size_t)count * sizeof(type_component_t));
+    if (!type) return NULL;
+    type_component_t *copy = (type_component_t *)(type + 1);
+    memset(type, 0, sizeof(*type));
+    type->name = name;
+    type->kind = TYPE_KIND_STRUCTURE;
+    type->align = 1;
+    type->components = copy;
+    type->component_count = count;
+
+    size_t offset = 0;
+    for (int i = 0; i < count; i++) {
+        const TypeInfo *component = components[i].type;
+        offset = type_align_up(offset, component->align);
+        copy[i] = components[i];
+        copy[i].offset = offset;
+        offset += component->size;
+        if (component->align > type->align) type->align = component->align;
+        if (component->deep) type->deep = true;
+    }
+    type->size = type_align_up(offset, type->align);
+    return type;
+}
+
+TypeInfo *type_indirect_create(type_kind_t kind, const TypeInfo *line) {
+    TypeInfo *type = calloc(1, sizeof(TypeInfo));
+    if (!type) return NULL;
+    type->kind = kind;
+    type->size = sizeof(void *);
+    type->align = sizeof(void *);
+    type->deep = true;
+    type->line = line;
+    return type;
+}
+
+const type_component_t *type_component_find(const TypeInfo *type, atom_t name) {
+    if (type->kind != TYPE_KIND_STRUCTURE || name == ATOM_NONE) return NULL;
+    for (int i = 0; i < type->component_count; i++) {
+        if (type->components[i].name == name) return &type->components[i];
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Кэш
+
+bool type_cache_init(type_cache_t *cache) {
+    memset(cache, 0, sizeof(*cache));
+    return pthread_mutex_init(&cache->lock, NULL) == 0;
+}
+
+void type_cache_free(type_cache_t *cache) {
+    for (size_t i = 0; i < cache->capacity; i++) free(cache->entries[i].owned);
+    free(cache->entries);
+    pthread_mutex_destroy(&cache->lock);
+    cache->entries = NULL;
+    cache->capacity = cache->count = 0;
+}
+
+// Слот узла: либо занятый им, либо первый пустой (capacity > 0)
+static type_cache_entry_t *type_cache_probe(type_cache_entry_t *entries, size_t capacity, const ASTNode *decl) {
+    uint64_t hash = ((uint64_t)(uintptr_t)decl >> 4) * 11400714819323198485ull;
+    size_t index = (size_t)(hash >> 32) & (capacity - 1);
+    while (entries[index].decl && entries[index].decl != decl) index = (index + 1) & (capacity - 1);
+    return &entries[index];
+}
+
+static bool type_cache_grow(type_cache_t *cache) {
+    size_t capacity = cache->capacity ? cache->capacity * 2 : TYPE_CACHE_INITIAL;
+    type_cache_entry_t *entries = calloc(capacity, sizeof(type_cache_entry_t));
+    if (!entries) return false;
+    for (size_t i = 0; i < cache->capacity; i++) {
+        if (cache->entries[i].decl) *type_cache_probe(entries, capacity, cache->entries[i].decl) = cache->entries[i];
+    }
+    free(cache->entries);
+    cache->entries = entries;
+    cache->capacity = capacity;
+    return true;
+}
+
+const TypeInfo *type_cache_find(type_cache_t *cache, const ASTNode *decl) {
+    pthread_mutex_lock(&cache->lock);
+    const TypeInfo *type = NULL;
+    if (cache->capacity) {
+        const type_cache_entry_t *entry = type_cache_probe(cache->entries, cache->capacity, decl);
+        type = entry->type;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return type;
+}
+
+const TypeInfo *type_cache_insert(type_cache_t *cache, const ASTNode *decl, const TypeInfo *type,
+                                  TypeInfo *owned) {
+    pthread_mutex_lock(&cache->lock);
+    if ((cache->count + 1) * 2 > cache->capacity && !type_cache_grow(cache)) {
+        pthread_mutex_unlock(&cache->lock);
+        free(owned);
+        return NULL;
+    }
+    type_cache_entry_t *entry = type_cache_probe(cache->entries, cache->capacity, decl);
+    if (entry->decl) {
+        free(owned);
+    } else {
+        entry->decl = decl;
+        entry->type = type;
+        entry->owned = owned;
+        cache->count++;
+    }
+    type = entry->type;
+    pthread_mutex_unlock(&cache->lock);
+    return type;
+}
+
+size_t type_cache_count(type_cache_t *cache) {
+    pthread_mutex_lock(&cache->lock);
+    size_t count = cache->count;
+    pthread_mutex_unlock(&cache->lock);
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// Разрешение объявлений
+
+// Объявление, которое разбирается сейчас в этом потоке
+typedef struct type_frame {
+    const ASTNode *decl;
+    const struct type_frame *outer;
+} type_frame_t;
+
+static const TypeInfo *type_resolve_in(semantic_context_t *context, const ASTNode *decl, bool global,
+                                       const type_frame_t *outer);
+
+static bool type_symbol_is_type(symbol_kind_t kind) {
+    return kind == SYMBOL_TYPE || kind == SYMBOL_TABLE;
+}
+
+static bool type_symbol_is_data(symbol_kind_t kind) {
+    return kind == SYMBOL_VARIABLE || kind == SYMBOL_CONSTANT || kind == SYMBOL_PARAMETER ||
+           kind == SYMBOL_ATTRIBUTE || kind == SYMBOL_TABLE;
+}
+
+// Имена в глобальном объявлении ищутся только среди глобальных: локальное имя
+// процедуры, из которой к нему обратились, не должно менять его раскладку
+static const symbol_t *type_lookup(semantic_context_t *context, atom_t name, bool global) {
+    return global ? symbol_frozen_lookup(context->symbols->globals, name)
+                  : symbol_table_lookup(context->symbols, name);
+}
+
+static const TypeInfo *type_of_symbol(semantic_context_t *context, const symbol_t *symbol,
+                                      const type_frame_t *outer) {
+    if (symbol->type) return symbol->type;      // Готовая раскладка (DDIC)
+    if (!symbol->decl) {
+        const TypeInfo *builtin = type_builtin(symbol->name);
+        return builtin ? builtin : &type_unknown;
+    }
+    return type_resolve_in(context, symbol->decl, symbol->scope == 0, outer);
+}
+
+// Тип имени после TYPE (want_type) или LIKE; составное имя struct-comp-... проходит по компонентам
+static const TypeInfo *type_of_name(semantic_context_t *context, atom_t name, bool want_type, bool global,
+                                    const type_frame_t *outer) {
+    if (name == ATOM_NONE) return &type_unknown;
+    const symbol_t *symbol = type_lookup(context, name, global);
+    const char *text = atom_text(name);
+    const char *dash = NULL;
+    if (!symbol) {
+        dash = strchr(text, '-');
+        if (!dash || dash == text) return &type_unknown;
+        symbol = type_lookup(context, atom_find(text, (size_t)(dash - text)), global);
+        if (!symbol) return &type_unknown;
+    }
+    if (want_type ? !type_symbol_is_type(symbol->kind) : !type_symbol_is_data(symbol->kind)) return &type_unknown;
+
+    const TypeInfo *type = type_of_symbol(context, symbol, outer);
+    while (dash && type->kind != TYPE_KIND_INVALID) {
+        const char *start = dash + 1;
+        dash = strchr(start, '-');
+        size_t length = dash ? (size_t)(dash - start) : strlen(start);
+        const type_component_t *component = type_component_find(type, atom_find(start, length));
+        if (!component) return &type_unknown;
+        type = component->type;
+    }
+    return type;
+}
+
+// Число после LENGTH/DECIMALS (TYPES хранит текст, DATA — атом)
+static unsigned type_spec_number(const ASTNode *spec) {
+    const char *text = spec->string_value ? spec->string_value : atom_text(spec->atom);
+    char *end = NULL;
+    unsigned long value = text ? strtoul(text, &end, 10) : 0;
+    return end && end != text && *end == '\0' && value <= UINT32_MAX ? (unsigned)value : 0;
+}
+
+// TYPES BEGIN OF: раскладка по компонентам; цикл в любом компоненте делает циклической структуру
+static const TypeInfo *type_build_structure(semantic_context_t *context, const ASTNode *decl, bool global,
+                                            const type_frame_t *frame, TypeInfo **owned) {
+    type_component_t *components = malloc((size_t)decl->child_count * sizeof(type_component_t));
+    if (!components) return NULL;
+    int count = 0;
+    const TypeInfo *invalid = NULL;
+    for (int i = 0; i < decl->child_count; i++) {
+        const ASTNode *child = decl->children[i];
+        if (!child || child->type != AST_TYPES_DECL) continue;
+        const TypeInfo *type = type_resolve_in(context, child, global, frame);
+        if (type->kind == TYPE_KIND_INVALID) {
+            if (!invalid || type->cyclic) invalid = type;
+            continue;
+        }
+        components[count++] = (type_component_t){ child->atom, 0, type };
+    }
+    if (invalid) {
+        free(components);
+        return invalid;
+    }
+    *owned = type_structure_create(decl->atom, components, count);
+    free(components);
+    return *owned;
+}
+
+// Раскладка объявления по его спецификаторам (TYPE, LIKE, LINE OF, LENGTH, DECIMALS)
+static const TypeInfo *type_build(semantic_context_t *context, const ASTNode *decl, bool global,
+                                  const type_frame_t *frame, TypeInfo **owned) {
+    const TypeInfo *base = NULL;
+    const char *prefix = NULL;
+    unsigned length = 0;
+    unsigned decimals = 0;
+    bool structure = false;
+    for (int i = 0; i < decl->child_count; i++) {
+        const ASTNode *spec = decl->children[i];
+        if (!spec) continue;
+        switch (spec->type) {
+            case AST_TYPE_SPEC:
+                base = type_of_name(context, spec->atom, true, global, frame);
+                prefix = spec->string_value;    // TABLE OF, RANGE OF, REF TO
+                break;
+            case AST_LIKE_SPEC:
+                base = type_of_name(context, spec->atom, false, global, frame);
+                break;
+            case AST_LINE_OF_SPEC: {
+                const TypeInfo *table = type_of_name(context, spec->atom, true, global, frame);
+                base = table->kind == TYPE_KIND_TABLE && table->line ? table->line
+                     : table->kind == TYPE_KIND_INVALID ? table : &type_unknown;
+                break;
+            }
+            case AST_LENGTH_SPEC:
+                length = type_spec_number(spec);
+                break;
+            case AST_DECIMALS_SPEC:
+                decimals = type_spec_number(spec);
+                break;
+            case AST_TYPES_DECL:
+                structure = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (!base && structure) return type_build_structure(context, decl, global, frame, owned);
+    if (prefix && strcmp(prefix, "TABLE") != 0) {
+        // Таблица и ссылка занимают в объекте данных ссылку. Строка RANGE OF — структура
+        // SIGN/OPTION/LOW/HIGH, а не base; REF TO класса или data — ссылка без известного типа
+        bool reference = strcmp(prefix, "REF TO") == 0;
+        if (base->cyclic || (base->kind == TYPE_KIND_INVALID && !reference)) return base;
+        const TypeInfo *line = base->kind == TYPE_KIND_INVALID || strcmp(prefix, "RANGE OF") == 0 ? NULL : base;
+        *owned = type_indirect_create(reference ? TYPE_KIND_REFERENCE : TYPE_KIND_TABLE, line);
+        if (*owned && decl->type == AST_TYPES_DECL) (*owned)->name = decl->atom;
+        return *owned;
+    }
+    if (!base) base = &type_builtins[0].type;      // Без TYPE и LIKE — C длины 1
+    if (base->kind != TYPE_KIND_ELEMENTARY || (!length && !decimals)) return base;
+
+    *owned = type_elementary_sized(base, length, decimals);
+    if (*owned && decl->type == AST_TYPES_DECL) (*owned)->name = decl->atom;
+    return *owned;
+}
+
+static const TypeInfo *type_resolve_in(semantic_context_t *context, const ASTNode *decl, bool global,
+                                       const type_frame_t *outer) {
+    const TypeInfo *type = type_cache_find(context->types, decl);
+    if (type) return type;
+    for (const type_frame_t *frame = outer; frame; frame = frame->outer) {
+        if (frame->decl == decl) return &type_cyclic;
+    }
+
+    type_frame_t frame = { decl, outer };
+    TypeInfo *owned = NULL;
+    type = type_build(context, decl, global, &frame, &owned);
+    if (type) type = type_cache_insert(context->types, decl, type, owned);
+    if (!type) {
+        context->failed = true;
+        return &type_unknown;
+    }
+    return type;
+}
+
+const TypeInfo *type_resolve_decl(semantic_context_t *context, const ASTNode *decl) {
+    return type_resolve_in(context, decl, context->procedure == NULL, NULL);
+}
+
+const TypeInfo *type_resolve_symbol(semantic_context_t *context, const symbol_t *symbol) {
+    return type_of_symbol(context, symbol, NULL);
+}
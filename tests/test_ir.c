@@ -0,0 +1,176 @@
+/**
+ * @file test_ir.c
+ * @brief Разбор настоящего исходника, плоское AST и генерация IR (ir_flat.h).
+ *
+ * Исходник проходит лексер, раскрытие цепочек, parse_program(), ast_flat_build() и
+ * irgen_generate_flat(); листинг IR сравнивается с ожидаемым построчно.
+ */
+
+#include "../include/ast_flat.h"
+#include "../include/ir_flat.h"
+#include "../include/lexer.h"
+#include "../include/parser.h"
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static const char source[] =
+    "DATA: a TYPE i, b TYPE i, s TYPE string, ok TYPE abap_bool.\n"
+    "a = 2 + 3 * 4.\n"
+    "b = - a MOD 5 ** 2.\n"
+    "a += b.\n"
+    "s = 'x' && s.\n"
+    "ok = a BETWEEN 1 AND 20 AND NOT b IS INITIAL.\n"
+    "ok = a NOT IN r OR a <> b.\n";
+
+// Ожидаемый листинг: DATA пропускается, каждое присваивание — вычисление и STORE
+static const char expected[] =
+    "LOAD r0, #2\n"
+    "LOAD r1, #3\n"
+    "LOAD r2, #4\n"
+    "MUL r3, r1, r2\n"
+    "ADD r4, r0, r3\n"
+    "STORE A, r4\n"
+    // Унарный минус связывает сильнее MOD, ** — сильнее унарного минуса
+    "LOAD r5, A\n"
+    "NEG r6, r5\n"
+    "LOAD r7, #5\n"
+    "LOAD r8, #2\n"
+    "POW r9, r7, r8\n"
+    "MOD r10, r6, r9\n"
+    "STORE B, r10\n"
+    // a += b разворачивается парсером в a = a + b
+    "LOAD r11, A\n"
+    "LOAD r12, B\n"
+    "ADD r13, r11, r12\n"
+    "STORE A, r13\n"
+    "LOAD r14, x\n"
+    "LOAD r15, S\n"
+    "CONCAT r16, r14, r15\n"
+    "STORE S, r16\n"
+    // BETWEEN раскладывается на GE, LE и AND
+    "LOAD r17, A\n"
+    "LOAD r18, #1\n"
+    "LOAD r19, #20\n"
+    "GE r20, r17, r18\n"
+    "LE r21, r17, r19\n"
+    "AND r22, r20, r21\n"
+    "LOAD r23, B\n"
+    "IS_INITIAL r24, r23\n"
+    "NOT r25, r24\n"
+    "AND r26, r22, r25\n"
+    "STORE OK, r26\n"
+    "LOAD r27, A\n"
+    "LOAD r28, R\n"
+    "IN r29, r27, r28\n"
+    "NOT r30, r29\n"
+    "LOAD r31, A\n"
+    "LOAD r32, B\n"
+    "NE r33, r31, r32\n"
+    "OR r34, r30, r33\n"
+    "STORE OK, r34\n";
+
+static void append_operand(char *out, size_t size, const ir_operand_t *operand) {
+    size_t used = strlen(out);
+    switch (operand->type) {
+        case IR_OPERAND_REGISTER: snprintf(out + used, size - used, "r%d", operand->value.reg); break;
+        case IR_OPERAND_CONSTANT: snprintf(out + used, size - used, "#%d", operand->value.constant); break;
+        case IR_OPERAND_LABEL:    snprintf(out + used, size - used, "%s", operand->value.label); break;
+        case IR_OPERAND_VARIABLE: snprintf(out + used, size - used, "%s", atom_text(operand->value.var)); break;
+        case IR_OPERAND_STRING:   snprintf(out + used, size - used, "%s", operand->value.string); break;
+    }
+}
+
+// Листинг в формате ir_list_print()
+static void render(const ir_list_t *list, char *out, size_t size) {
+    out[0] = '\0';
+    for (const ir_instruction_t *inst = list->head; inst; inst = inst->next) {
+        strncat(out, ir_op_name(inst->op), size - strlen(out) - 1);
+        const ir_operand_t *operands[3] = { inst->dst, inst->src1, inst->src2 };
+        const char *separator = " ";
+        for (int i = 0; i < 3; i++) {
+            if (!operands[i]) continue;
+            strncat(out, separator, size - strlen(out) - 1);
+            append_operand(out, size, operands[i]);
+            separator = ", ";
+        }
+        strncat(out, "\n", size - strlen(out) - 1);
+    }
+}
+
+static void test_source_to_ir(void) {
+    lexer_t lexer;
+    lexer_init(&lexer, source, sizeof(source) - 1);
+    TokenStream ts;
+    CHECK(token_stream_from_lexer(&ts, &lexer));
+    lexer_free(&lexer);
+    CHECK(token_stream_expand_chains(&ts));
+
+    diag_list_t diagnostics;
+    diag_list_init(&diagnostics);
+    ASTNode *program = parse_program(&ts, &diagnostics);
+    CHECK(program != NULL);
+    CHECK(diagnostics.count == 0);
+
+    ast_flat_t tree;
+    ast_flat_init(&tree);
+    CHECK(ast_flat_build(&tree, program));
+
+    ir_list_t list;
+    ir_list_init(&list);
+    CHECK(irgen_generate_flat(&tree, 0, &list));
+
+    static char listing[4096];
+    render(&list, listing, sizeof(listing));
+    if (strcmp(listing, expected) != 0) {
+        fprintf(stderr, "IR listing differs:\n%s\nexpected:\n%s\n", listing, expected);
+        failures++;
+    }
+
+    ir_list_free(&list);
+    ast_flat_free(&tree);
+    ast_node_free(program);
+    diag_list_free(&diagnostics);
+    token_stream_free(&ts);
+}
+
+// Выражение, которое не переводится (вызов функции), — ошибка, а не молча пропущенный узел
+static void test_unsupported_expression(void) {
+    static const char call_source[] = "a = f( 1 ).\n";
+    lexer_t lexer;
+    lexer_init(&lexer, call_source, sizeof(call_source) - 1);
+    TokenStream ts;
+    CHECK(token_stream_from_lexer(&ts, &lexer));
+    lexer_free(&lexer);
+
+    ASTNode *program = parse_program(&ts, NULL);
+    ast_flat_t tree;
+    ast_flat_init(&tree);
+    CHECK(ast_flat_build(&tree, program));
+
+    ir_list_t list;
+    ir_list_init(&list);
+    CHECK(!irgen_generate_flat(&tree, 0, &list));
+
+    ir_list_free(&list);
+    ast_flat_free(&tree);
+    ast_node_free(program);
+    token_stream_free(&ts);
+}
+
+int main(void) {
+    test_source_to_ir();
+    test_unsupported_expression();
+    atom_table_free();
+    if (failures) {
+        fprintf(stderr, "test_ir: %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("test_ir: OK\n");
+    return 0;
+}
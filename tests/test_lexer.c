@@ -0,0 +1,146 @@
+/**
+ * @file test_lexer.c
+ * @brief Шаблоны строк |...{ }...|: лексика, перелексирование правок и параллельная лексика.
+ *
+ * Каждый поток токенов, полученный правкой (lexer_relex()) или параллельной лексикой
+ * (lexer_parallel_tokenize()), сравнивается с последовательной лексикой того же текста.
+ */
+
+#include "../include/lexer.h"
+#include "../include/lexer_incremental.h"
+#include "../include/lexer_parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static void lex(TokenStream *ts, const char *source, size_t length) {
+    lexer_t lexer;
+    lexer_init(&lexer, source, length);
+    CHECK(token_stream_from_lexer(ts, &lexer));
+    lexer_free(&lexer);
+}
+
+static bool same_tokens(const TokenStream *a, const TokenStream *b) {
+    if (a->token_count != b->token_count) return false;
+    for (int i = 0; i < a->token_count; i++) {
+        if (token_stream_type_at(a, i) != token_stream_type_at(b, i) ||
+            token_stream_offset_at(a, i) != token_stream_offset_at(b, i) ||
+            token_stream_length_at(a, i) != token_stream_length_at(b, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_template_tokens(void) {
+    static const char source[] =
+        "s = |Итого: { sum WIDTH = 10 } \\| \\{ { |{ 'x}' }| }|.\n"
+        "t = |a\n"
+        "{ b \" комментарий }\n"
+        "}|.\n"
+        "u = |открыт { x\n";
+    TokenStream ts;
+    lex(&ts, source, sizeof(source) - 1);
+
+    // s = <шаблон> .  t = <шаблон> .  u = <незакрытый шаблон до конца текста>
+    CHECK(ts.token_count == 11);
+    CHECK(token_stream_type_at(&ts, 2) == TOKEN_LITERAL_TEMPLATE);
+    CHECK(source[token_stream_offset_at(&ts, 2)] == '|');
+    CHECK(token_stream_offset_at(&ts, 3) == token_stream_offset_at(&ts, 2) + token_stream_length_at(&ts, 2));
+    CHECK(token_stream_type_at(&ts, 3) == TOKEN_PUNCTUATION_DOT);
+    CHECK(token_stream_type_at(&ts, 6) == TOKEN_LITERAL_TEMPLATE);
+    CHECK(token_stream_type_at(&ts, 10) == TOKEN_UNKNOWN);
+    CHECK(token_stream_offset_at(&ts, 10) + token_stream_length_at(&ts, 10) == sizeof(source) - 1);
+    token_stream_free(&ts);
+}
+
+// Правка old -> new (замена removed байт с offset) перелексируется и сравнивается с лексикой нового текста
+static void check_relex(const char *old_text, size_t offset, size_t removed, const char *insert) {
+    size_t old_length = strlen(old_text), inserted = strlen(insert);
+    size_t length = old_length - removed + inserted;
+    char *text = malloc(length + 1);
+    memcpy(text, old_text, offset);
+    memcpy(text + offset, insert, inserted);
+    memcpy(text + offset + inserted, old_text + offset + removed, old_length - offset - removed + 1);
+
+    TokenStream stream, expected;
+    lex(&stream, old_text, old_length);
+    lex(&expected, text, length);
+    source_edit_t edit = { offset, removed, inserted };
+    CHECK(lexer_relex(&stream, text, length, &edit, NULL));
+    if (!same_tokens(&stream, &expected)) {
+        fprintf(stderr, "relex differs for edit at %zu (-%zu +\"%s\")\n", offset, removed, insert);
+        failures++;
+    }
+    token_stream_free(&stream);
+    token_stream_free(&expected);
+    free(text);
+}
+
+static void test_relex_templates(void) {
+    static const char source[] =
+        "DATA s TYPE string.\n"
+        "s = |первая { a }\n"
+        "вторая { b } третья|.\n"
+        "s = s && |x|.\n";
+    const char *brace = strchr(source, '{');
+    const char *second = strstr(source, "вторая");
+    const char *closing = strstr(source, "третья|") + strlen("третья");
+
+    // Правка слова внутри встроенного выражения многострочного шаблона
+    check_relex(source, (size_t)(brace + 2 - source), 1, "abc");
+    // Текст шаблона на второй строке
+    check_relex(source, (size_t)(second - source), 0, "и ");
+    // Удалённая закрывающая черта: шаблон поглощает остаток текста
+    check_relex(source, (size_t)(closing - source), 1, "");
+    // Вставленная черта открывает шаблон посреди оператора
+    check_relex(source, (size_t)(strstr(source, "DATA s") + 5 - source), 0, "|");
+    // Закрывающая фигурная скобка удалена: '|' после неё уже не закрывает шаблон
+    check_relex(source, (size_t)(strchr(brace, '}') - source), 1, "");
+}
+
+static void test_parallel_templates(void) {
+    // Многострочные шаблоны со строками, оканчивающимися точкой, — точками разреза фрагментов
+    static const char unit[] =
+        "s = |начало.\n"
+        "середина { a }.\n"
+        "конец|.\n"
+        "n = n + 1.\n";
+    size_t repeat = 2 * LEXER_PARALLEL_MIN_SIZE / (sizeof(unit) - 1) + 1;
+    size_t length = repeat * (sizeof(unit) - 1);
+    char *source = malloc(length + 1);
+    for (size_t i = 0; i < repeat; i++) memcpy(source + i * (sizeof(unit) - 1), unit, sizeof(unit) - 1);
+    source[length] = '\0';
+
+    thread_pool_t *pool = thread_pool_create(4);
+    CHECK(pool != NULL);
+    TokenStream parallel, sequential;
+    CHECK(lexer_parallel_tokenize(&parallel, source, length, pool));
+    lex(&sequential, source, length);
+    CHECK(same_tokens(&parallel, &sequential));
+    CHECK(sequential.token_count == (int)(repeat * 10));
+
+    token_stream_free(&parallel);
+    token_stream_free(&sequential);
+    thread_pool_destroy(pool);
+    free(source);
+}
+
+int main(void) {
+    test_template_tokens();
+    test_relex_templates();
+    test_parallel_templates();
+    atom_table_free();
+    if (failures) {
+        fprintf(stderr, "test_lexer: %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("test_lexer: OK\n");
+    return 0;
+}
@@ -0,0 +1,498 @@
+/**
+ * @file test_parser.c
+ * @brief Разбор: ключевые слова на месте имён, параллельный и инкрементальный разбор.
+ *
+ * Исходник разбирается parse_program() со списком диагностик; проверяются отсутствие
+ * ошибок и атомы имён в AST. Параллельный разбор (parser_parse_parallel()) и документ,
+ * обновлённый правкой (parser_document_update()), сравниваются с полным разбором по хешу
+ * дерева (semantic_tree_hash()) и сообщениям. Обход ast_visit_fused() сравнивается с
+ * раздельными обходами ast_visit() тех же визиторов по записи вызовов.
+ */
+
+#include "../include/ast_cache.h"
+#include "../include/ast_visitor.h"
+#include "../include/lexer.h"
+#include "../include/parser.h"
+#include "../include/parser_incremental.h"
+#include "../include/parser_parallel.h"
+#include "../include/semantic.h"
+#include <glob.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static void lex(const char *source, size_t length, TokenStream *ts) {
+    lexer_t lexer;
+    lexer_init(&lexer, source, length);
+    CHECK(token_stream_from_lexer(ts, &lexer));
+    lexer_free(&lexer);
+}
+
+static ASTNode *parse(const char *source, size_t length, TokenStream *ts, diag_list_t *diagnostics) {
+    lex(source, length, ts);
+    CHECK(token_stream_expand_chains(ts));
+    diag_list_init(diagnostics);
+    ASTNode *root = parse_program(ts, diagnostics);
+    CHECK(root != NULL);
+    return root;
+}
+
+// Текст файла целиком; NULL, если файла нет
+static char *read_file(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *text = malloc((size_t)size + 1);
+    *length = fread(text, 1, (size_t)size, file);
+    text[*length] = '\0';
+    fclose(file);
+    return text;
+}
+
+static bool has_atom(const ASTNode *node, const char *name) {
+    return node && node->atom == atom_intern_cstr(name);
+}
+
+static void test_keyword_names(void) {
+    static const char source[] =
+        "DATA key TYPE i.\n"
+        "TYPES: BEGIN OF s, key TYPE i, value TYPE string, END OF s.\n"
+        "DATA ls TYPE s.\n"
+        "ls-key = 1.\n"
+        "x = value + 1.\n"
+        "y = calc( key = 1 value = table ).\n"
+        "CLASS c DEFINITION.\n"
+        "  PUBLIC SECTION.\n"
+        "    CLASS-METHODS stop IMPORTING data TYPE i VALUE(end) TYPE i RETURNING VALUE(type) TYPE i.\n"
+        "ENDCLASS.\n";
+    TokenStream ts;
+    diag_list_t diagnostics;
+    ASTNode *root = parse(source, sizeof(source) - 1, &ts, &diagnostics);
+    CHECK(diagnostics.count == 0);
+    diag_list_print(&diagnostics, stderr, "keyword names");
+    CHECK(root->child_count == 7);
+
+    if (root->child_count == 7) {
+        CHECK(root->children[0]->type == AST_DATA_DECL && has_atom(root->children[0], "KEY"));
+        const ASTNode *structure = root->children[1];
+        CHECK(has_atom(structure, "s") && structure->child_count == 2);
+        if (structure->child_count == 2) {
+            CHECK(has_atom(structure->children[0], "key"));
+            CHECK(has_atom(structure->children[1], "value"));
+        }
+        // Присваивание: потомки — цель и выражение
+        CHECK(root->children[3]->child_count == 2 && has_atom(root->children[3]->children[0], "ls-key"));
+        const ASTNode *sum = root->children[4]->child_count == 2 ? root->children[4]->children[1] : NULL;
+        CHECK(sum && sum->type == AST_OPERATOR && sum->child_count == 2 && has_atom(sum->children[0], "value"));
+        const ASTNode *call = root->children[5]->child_count == 2 ? root->children[5]->children[1] : NULL;
+        CHECK(call && call->type == AST_FUNCTION_CALL && call->child_count == 2);
+        if (call && call->child_count == 2) {
+            CHECK(call->children[0]->type == AST_PARAMETER_BINDING && has_atom(call->children[0], "key"));
+            CHECK(has_atom(call->children[1], "value") && has_atom(call->children[1]->children[0], "table"));
+        }
+        const ASTNode *section = root->children[6]->child_count ? root->children[6]->children[0] : NULL;
+        const ASTNode *method = section && section->child_count ? section->children[0] : NULL;
+        CHECK(method && method->type == AST_METHOD_DECL && has_atom(method, "stop") && method->child_count == 3);
+        if (method && method->child_count == 3) {
+            CHECK(has_atom(method->children[0], "data"));
+            CHECK(has_atom(method->children[1], "end"));
+            CHECK(has_atom(method->children[2], "type"));
+        }
+    }
+    ast_node_free(root);
+    diag_list_free(&diagnostics);
+    token_stream_free(&ts);
+
+    // Те же случаи в примерах модулей
+    static const char *const fixtures[] = {
+        "src/parser/declarations/data.abap",
+        "src/parser/declarations/types.abap",
+        "src/parser/assignment/simple.abap",
+        "src/parser/class/method_def.abap",
+    };
+    for (size_t i = 0; i < sizeof(fixtures) / sizeof(fixtures[0]); i++) {
+        size_t length;
+        char *text = read_file(fixtures[i], &length);
+        CHECK(text != NULL);
+        if (!text) continue;
+        root = parse(text, length, &ts, &diagnostics);
+        if (diagnostics.count) {
+            diag_list_print(&diagnostics, stderr, fixtures[i]);
+            failures++;
+        }
+        ast_node_free(root);
+        diag_list_free(&diagnostics);
+        token_stream_free(&ts);
+        free(text);
+    }
+}
+
+// Те же сообщения в том же порядке
+static bool same_diagnostics(const diag_list_t *a, const diag_list_t *b) {
+    if (a->count != b->count || a->error_count != b->error_count) return false;
+    for (int i = 0; i < a->count; i++) {
+        if (a->items[i].severity != b->items[i].severity || a->items[i].line != b->items[i].line ||
+            a->items[i].column != b->items[i].column || strcmp(a->items[i].message, b->items[i].message) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Параллельный разбор на пулах разного размера даёт то же дерево и те же сообщения
+static void check_parallel(const char *source, size_t length, const char *what) {
+    TokenStream ts;
+    diag_list_t expected;
+    uint32_t *offsets;
+    lex(source, length, &ts);
+    CHECK(token_stream_expand_chains(&ts));
+    diag_list_init(&expected);
+    ASTNode *root = parse_program_offsets(&ts, &expected, &offsets);
+    CHECK(root != NULL && (offsets || root->child_count == 0));
+    uint64_t hash = semantic_tree_hash(root);
+
+    static const int thread_counts[] = { 1, 2, 3, 8 };
+    for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+        thread_pool_t *pool = thread_pool_create(thread_counts[i]);
+        CHECK(pool != NULL);
+        parser_parallel_result_t result;
+        CHECK(parser_parse_parallel(&ts, pool, &result));
+        if (!result.program || semantic_tree_hash(result.program) != hash ||
+            !same_diagnostics(&result.diagnostics, &expected) ||
+            (root->child_count && (!result.offsets ||
+             memcmp(result.offsets, offsets, (size_t)root->child_count * sizeof(uint32_t)) != 0))) {
+            fprintf(stderr, "%s: parallel parse with %d threads differs\n", what, thread_counts[i]);
+            failures++;
+        }
+        parser_parallel_result_free(&result);
+        thread_pool_destroy(pool);
+    }
+    free(offsets);
+    ast_node_free(root);
+    diag_list_free(&expected);
+    token_stream_free(&ts);
+}
+
+static void test_parallel_parse(void) {
+    glob_t fixtures;
+    CHECK(glob("src/parser/*/*.abap", 0, NULL, &fixtures) == 0);
+
+    // Каждый пример отдельно и все подряд одной программой: в ней много блоков FORM/METHOD
+    size_t total = 0;
+    char *all = NULL;
+    for (size_t i = 0; i < fixtures.gl_pathc; i++) {
+        size_t length;
+        char *text = read_file(fixtures.gl_pathv[i], &length);
+        CHECK(text != NULL);
+        if (!text) continue;
+        check_parallel(text, length, fixtures.gl_pathv[i]);
+        all = realloc(all, total + length + 1);
+        memcpy(all + total, text, length + 1);
+        total += length;
+        free(text);
+    }
+
+    TokenStream ts;
+    diag_list_t diagnostics;
+    ASTNode *root = parse(all, total, &ts, &diagnostics);
+    parser_skeleton_t skeleton = { 0 };
+    CHECK(parser_skeleton_scan(&ts, &skeleton));
+    CHECK(skeleton.blocks > 1);
+    parser_skeleton_free(&skeleton);
+    ast_node_free(root);
+    diag_list_free(&diagnostics);
+    token_stream_free(&ts);
+
+    check_parallel(all, total, "all fixtures");
+    free(all);
+    globfree(&fixtures);
+}
+
+// Правка old -> new (замена removed байт с offset): документ, обновлённый lexer_relex() и
+// parser_document_update(), сравнивается с полным разбором нового текста. first >= 0 —
+// ожидаемый первый изменённый оператор верхнего уровня; in_block — правка внутри блока
+static void check_update(const char *old_text, size_t offset, size_t removed, const char *insert,
+                         int first, bool in_block) {
+    size_t old_length = strlen(old_text), inserted = strlen(insert);
+    size_t length = old_length - removed + inserted;
+    char *text = malloc(length + 1);
+    memcpy(text, old_text, offset);
+    memcpy(text + offset, insert, inserted);
+    memcpy(text + offset + inserted, old_text + offset + removed, old_length - offset - removed + 1);
+
+    TokenStream stream;
+    lex(old_text, old_length, &stream);
+    parser_document_t doc;
+    CHECK(parser_document_parse(&doc, &stream));
+    int old_count = doc.program->child_count;
+    ASTNode **old_children = malloc((size_t)old_count * sizeof(ASTNode *));
+    memcpy(old_children, doc.program->children, (size_t)old_count * sizeof(ASTNode *));
+
+    source_edit_t edit = { offset, removed, inserted };
+    lexer_relex_result_t relex;
+    parser_update_t update;
+    CHECK(lexer_relex(&stream, text, length, &edit, &relex));
+    CHECK(parser_document_update(&doc, &relex, &update));
+
+    // Полный разбор нового текста; цепочки не раскрываются, как и в документе
+    TokenStream expected;
+    diag_list_t diagnostics;
+    lex(text, length, &expected);
+    diag_list_init(&diagnostics);
+    ASTNode *root = parse_program(&expected, &diagnostics);
+
+    const ASTNode *program = doc.program;
+    bool same = semantic_tree_hash(program) == semantic_tree_hash(root) &&
+                same_diagnostics(&doc.diagnostics, &diagnostics);
+    // Вне отрезка [first, first + inserted) остались прежние узлы, внутри — как при полном разборе
+    bool ranges = update.first >= 0 && update.first + update.removed <= old_count &&
+                  program->child_count - update.inserted == old_count - update.removed &&
+                  (first < 0 || update.first == first) &&
+                  (!in_block || (update.removed == 1 && update.inserted == 1));
+    for (int i = 0; ranges && !update.full && i < program->child_count; i++) {
+        if (i < update.first) {
+            ranges = program->children[i] == old_children[i];
+        } else if (i >= update.first + update.inserted) {
+            ranges = program->children[i] == old_children[i - update.inserted + update.removed];
+        } else {
+            ranges = semantic_tree_hash(program->children[i]) == semantic_tree_hash(root->children[i]);
+        }
+    }
+    if (!same || !ranges || update.full) {
+        fprintf(stderr, "document update differs for edit at %zu (-%zu +\"%s\"): first %d -%d +%d%s\n",
+                offset, removed, insert, update.first, update.removed, update.inserted, update.full ? " full" : "");
+        failures++;
+    }
+
+    ast_node_free(root);
+    diag_list_free(&diagnostics);
+    token_stream_free(&expected);
+    free(old_children);
+    parser_document_free(&doc);
+    token_stream_free(&stream);
+    free(text);
+}
+
+static void test_document_update(void) {
+    static const char source[] =
+        "DATA lv_a TYPE i.\n"
+        "DATA lv_b TYPE i.\n"
+        "FORM calc.\n"
+        "  lv_a = lv_a + 1.\n"
+        "  IF lv_a > 10.\n"
+        "    lv_b = 2.\n"
+        "  ENDIF.\n"
+        "ENDFORM.\n"
+        "lv_b = lv_a * 2.\n"
+        "WRITE lv_b.\n";
+    size_t body = (size_t)(strstr(source, "+ 1") - source) + 2;
+    size_t nested = (size_t)(strstr(source, "= 2") - source) + 2;
+    size_t top = (size_t)(strstr(source, "* 2") - source) + 2;
+
+    // Операнд в теле FORM и во вложенном IF: переразбирается блок, а не программа
+    check_update(source, body, 1, "42", 2, true);
+    check_update(source, nested, 1, "lv_a", 2, true);
+    // Оператор верхнего уровня
+    check_update(source, top, 1, "3", 3, false);
+    // Новый оператор между двумя прежними
+    check_update(source, (size_t)(strstr(source, "WRITE") - source), 0, "CLEAR lv_a.\n", -1, false);
+    // Ошибка в объявлении и удалённый ENDIF: сообщения как при полном разборе
+    check_update(source, (size_t)(strstr(source, "TYPE i.\nDATA lv_b") - source) + 5, 1, "", -1, false);
+    check_update(source, (size_t)(strstr(source, "  ENDIF.") - source), 9, "", -1, false);
+}
+
+// Запись вызовов визитора: "+имя" до потомков, "-имя" после; решения по имени узла
+typedef struct {
+    char text[256];
+    const char *skip;           // pre_any: AST_VISIT_SKIP
+    const char *stop;           // pre_any: AST_VISIT_STOP
+    const char *post_stop;      // post_any: AST_VISIT_STOP
+} visit_trace_t;
+
+static void trace_append(visit_trace_t *trace, char sign, const ASTNode *node) {
+    size_t used = strlen(trace->text);
+    snprintf(trace->text + used, sizeof(trace->text) - used, "%s%c%s", used ? " " : "", sign, ast_node_name(node));
+}
+
+static bool trace_is(const char *expected, const ASTNode *node) {
+    return expected && strcmp(expected, ast_node_name(node)) == 0;
+}
+
+static ast_visit_result_t trace_pre(ASTNode *node, ASTNode *parent, void *arg) {
+    (void)parent;
+    visit_trace_t *trace = arg;
+    trace_append(trace, '+', node);
+    if (trace_is(trace->stop, node)) return AST_VISIT_STOP;
+    return trace_is(trace->skip, node) ? AST_VISIT_SKIP : AST_VISIT_CONTINUE;
+}
+
+static ast_visit_result_t trace_post(ASTNode *node, ASTNode *parent, void *arg) {
+    (void)parent;
+    visit_trace_t *trace = arg;
+    trace_append(trace, '-', node);
+    return trace_is(trace->post_stop, node) ? AST_VISIT_STOP : AST_VISIT_CONTINUE;
+}
+
+// Функция по типу узла: вызывается после pre_any, пропускает поддерево IF
+static ast_visit_result_t trace_skip_if(ASTNode *node, ASTNode *parent, void *arg) {
+    (void)node;
+    (void)parent;
+    (void)arg;
+    return AST_VISIT_SKIP;
+}
+
+static ASTNode *visit_node(ASTNode *parent, ASTNodeType type, const char *name) {
+    ASTNode *node = ast_node_create(type);
+    node->atom = atom_intern_cstr(name);
+    if (parent) ast_node_add_child(parent, node);
+    return node;
+}
+
+static void test_visitor(void) {
+    ASTNode *root = visit_node(NULL, AST_PROGRAM, "R");
+    ASTNode *form = visit_node(root, AST_FORM, "A");
+    visit_node(form, AST_ASSIGNMENT, "A1");
+    visit_node(form, AST_ASSIGNMENT, "A2");
+    ASTNode *branch = visit_node(root, AST_IF, "B");
+    ASTNode *inner = visit_node(branch, AST_ASSIGNMENT, "B1");
+    visit_node(inner, AST_IDENTIFIER, "X");
+    visit_node(root, AST_ASSIGNMENT, "C");
+
+    enum { ALL, SKIP_FORM, SKIP_INNER, STOP_INNER, POST_STOP, SKIP_IF, VISITORS };
+    static const char *const expected[VISITORS] = {
+        [ALL]        = "+R +A +A1 -A1 +A2 -A2 -A +B +B1 +X -X -B1 -B +C -C -R",
+        // Пропущенный узел закрывается post, его потомки не видны
+        [SKIP_FORM]  = "+R +A -A +B +B1 +X -X -B1 -B +C -C -R",
+        [SKIP_INNER] = "+R +A +A1 -A1 +A2 -A2 -A +B +B1 -B1 -B +C -C -R",
+        // После остановки не вызываются и post открытых узлов
+        [STOP_INNER] = "+R +A +A1 -A1 +A2 -A2 -A +B +B1",
+        [POST_STOP]  = "+R +A +A1 -A1 +A2 -A2 -A",
+        [SKIP_IF]    = "+R +A +A1 -A1 +A2 -A2 -A +B -B +C -C -R",
+    };
+    visit_trace_t traces[VISITORS] = {
+        [SKIP_FORM] = { .skip = "A" },
+        [SKIP_INNER] = { .skip = "B1" },
+        [STOP_INNER] = { .stop = "B1" },
+        [POST_STOP] = { .post_stop = "A" },
+    };
+    ast_visitor_t visitors[VISITORS];
+    const ast_visitor_t *fused[VISITORS];
+    for (int i = 0; i < VISITORS; i++) {
+        visitors[i] = (ast_visitor_t){ .pre_any = trace_pre, .post_any = trace_post, .arg = &traces[i] };
+        fused[i] = &visitors[i];
+    }
+    visitors[SKIP_IF].pre[AST_IF] = trace_skip_if;
+
+    // Каждый визитор отдельно
+    for (int i = 0; i < VISITORS; i++) {
+        CHECK(ast_visit(root, &visitors[i]));
+        if (strcmp(traces[i].text, expected[i]) != 0) {
+            fprintf(stderr, "visitor %d: \"%s\"\n", i, traces[i].text);
+            failures++;
+        }
+        traces[i].text[0] = '\0';
+    }
+
+    // Все вместе: пропуски и остановки одного визитора не задевают остальные
+    CHECK(ast_visit_fused(root, fused, VISITORS));
+    for (int i = 0; i < VISITORS; i++) {
+        if (strcmp(traces[i].text, expected[i]) != 0) {
+            fprintf(stderr, "fused visitor %d: \"%s\"\n", i, traces[i].text);
+            failures++;
+        }
+        traces[i].text[0] = '\0';
+    }
+
+    // Пропуск на разной глубине у двух визиторов: каждый снова видит узлы после своего пропуска
+    const ast_visitor_t *nested[] = { &visitors[SKIP_INNER], &visitors[SKIP_IF], &visitors[SKIP_FORM] };
+    CHECK(ast_visit_fused(root, nested, 3));
+    CHECK(strcmp(traces[SKIP_INNER].text, expected[SKIP_INNER]) == 0);
+    CHECK(strcmp(traces[SKIP_IF].text, expected[SKIP_IF]) == 0);
+    CHECK(strcmp(traces[SKIP_FORM].text, expected[SKIP_FORM]) == 0);
+
+    ast_node_free(root);
+}
+
+// Смещения операторов верхнего уровня: разбор, плоское дерево и файл кэша
+static void test_statement_positions(void) {
+    static const char source[] =
+        ". .\n"
+        "DATA: a TYPE i,\n"
+        "      b TYPE i.\n"
+        "FORM f.\n"
+        "  a = 1.\n"
+        "ENDFORM.\n"
+        "  b = a.\n";
+    // Операторы раскрытой цепочки начинаются копией её головы и получают её смещение
+    const uint32_t expected[] = {
+        (uint32_t)(strstr(source, "DATA") - source),
+        (uint32_t)(strstr(source, "DATA") - source),
+        (uint32_t)(strstr(source, "FORM") - source),
+        (uint32_t)(strstr(source, "b = a") - source),
+    };
+    TokenStream ts;
+    diag_list_t diagnostics;
+    uint32_t *offsets;
+    lex(source, sizeof(source) - 1, &ts);
+    CHECK(token_stream_expand_chains(&ts));
+    diag_list_init(&diagnostics);
+    ASTNode *root = parse_program_offsets(&ts, &diagnostics, &offsets);
+    CHECK(root && root->child_count == 4 && diagnostics.count == 0 && offsets);
+    if (!root || root->child_count != 4 || !offsets) return;
+    CHECK(memcmp(offsets, expected, sizeof(expected)) == 0);
+
+    ast_flat_t tree;
+    ast_flat_init(&tree);
+    CHECK(ast_flat_build(&tree, root));
+    CHECK(ast_flat_set_child_positions(&tree, 0, offsets));
+
+    char dir[] = "/tmp/test_parser_XXXXXX";
+    CHECK(mkdtemp(dir) != NULL);
+    uint64_t hash = ast_cache_hash(source, sizeof(source) - 1);
+    ast_cache_entry_t entry;
+    CHECK(ast_cache_store(dir, hash, sizeof(source) - 1, &tree));
+    CHECK(ast_cache_load(&entry, dir, hash, sizeof(source) - 1));
+    CHECK(ast_flat_position(&entry.tree, 0) == AST_FLAT_NONE);
+    for (uint32_t i = 0; i < 4; i++) {
+        uint32_t child = ast_flat_child(&entry.tree, 0, i);
+        CHECK(child != AST_FLAT_NONE && ast_flat_position(&entry.tree, child) == expected[i]);
+        // Вложенные операторы позиций не получают
+        if (child != AST_FLAT_NONE && entry.tree.nodes[child].first_child != AST_FLAT_NONE) {
+            CHECK(ast_flat_position(&entry.tree, entry.tree.nodes[child].first_child) == AST_FLAT_NONE);
+        }
+    }
+    ast_cache_close(&entry);
+
+    char path[512];
+    if (ast_cache_path(path, sizeof(path), dir, hash)) unlink(path);
+    rmdir(dir);
+    ast_flat_free(&tree);
+    free(offsets);
+    ast_node_free(root);
+    diag_list_free(&diagnostics);
+    token_stream_free(&ts);
+}
+
+int main(void) {
+    test_visitor();
+    test_statement_positions();
+    test_keyword_names();
+    test_parallel_parse();
+    test_document_update();
+    atom_table_free();
+    if (failures) {
+        fprintf(stderr, "test_parser: %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("test_parser: OK\n");
+    return 0;
+}
@@ -0,0 +1,679 @@
+/**
+ * @file test_semantic.c
+ * @brief Сводки классов (class_summary.h): запись, загрузка и анализ программы по сводке;
+ *        повторный анализ, таблица символов и раскладки типов.
+ *
+ * Класс разбирается и анализируется, его сводка записывается во временный каталог и
+ * загружается обратно. Программа, обращающаяся к zcl=>comp, анализируется с символами
+ * сводки вместо исходника класса; отпечатки (semantic_fingerprint()) меняются вместе
+ * со сводкой, и только у изменившихся компонентов.
+ *
+ * Анализ на пулах потоков сравнивается с анализом без пула по сообщениям и их порядку.
+ *
+ * Таблица символов (symbol_table.h) сверяется с моделью — стеком объявлений, в котором
+ * видимое объявление имени — последнее.
+ *
+ * Раскладки типов (type_layout.h) проверяются по смещениям и размерам вложенных структур
+ * и таблиц, по циклу TYPES и по тому, что неиспользуемый тип не разбирается.
+ */
+
+#include "../include/class_summary.h"
+#include "../include/lexer.h"
+#include "../include/parser.h"
+#include <glob.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static const char class_v1[] =
+    "CLASS zcl_util DEFINITION.\n"
+    "  PUBLIC SECTION.\n"
+    "    CONSTANTS c_max TYPE i VALUE 10.\n"
+    "    CLASS-DATA gv_count TYPE i.\n"
+    "    METHODS run IMPORTING iv_n TYPE i RETURNING VALUE(rv) TYPE i.\n"
+    "  PRIVATE SECTION.\n"
+    "    DATA mv_secret TYPE i.\n"
+    "ENDCLASS.\n";
+
+// Другое значение константы; run не меняется
+static const char class_v2[] =
+    "CLASS zcl_util DEFINITION.\n"
+    "  PUBLIC SECTION.\n"
+    "    CONSTANTS c_max TYPE i VALUE 20.\n"
+    "    CLASS-DATA gv_count TYPE i.\n"
+    "    METHODS run IMPORTING iv_n TYPE i RETURNING VALUE(rv) TYPE i.\n"
+    "  PRIVATE SECTION.\n"
+    "    DATA mv_secret TYPE i.\n"
+    "ENDCLASS.\n";
+
+static ASTNode *parse(const char *source, TokenStream *ts) {
+    lexer_t lexer;
+    lexer_init(&lexer, source, strlen(source));
+    CHECK(token_stream_from_lexer(ts, &lexer));
+    lexer_free(&lexer);
+    CHECK(token_stream_expand_chains(ts));
+    // Ошибки разбора (в примерах модулей они есть нарочно) не печатаются: проверяется анализ
+    diag_list_t diagnostics;
+    diag_list_init(&diagnostics);
+    ASTNode *root = parse_program(ts, &diagnostics);
+    diag_list_free(&diagnostics);
+    CHECK(root != NULL);
+    return root;
+}
+
+// Разбор, анализ и запись сводки первого определения исходника
+static void store(const char *dir, const char *source, uint64_t hash) {
+    TokenStream ts;
+    ASTNode *root = parse(source, &ts);
+    semantic_result_t analysis;
+    CHECK(semantic_analyze(root, NULL, NULL, &analysis));
+    CHECK(analysis.diagnostics.error_count == 0);
+    CHECK(root->child_count > 0 && class_summary_store(dir, root->children[0], hash, &analysis));
+    semantic_result_free(&analysis);
+    ast_node_free(root);
+    token_stream_free(&ts);
+}
+
+// Сводка, загруженная и объявленная в замороженной таблице ddic
+typedef struct {
+    class_summary_t summary;
+    symbol_frozen_t ddic;
+} loaded_t;
+
+static bool load(const char *dir, loaded_t *loaded) {
+    if (!class_summary_load(&loaded->summary, dir, atom_intern_cstr("ZCL_UTIL"))) return false;
+    symbol_table_t builder;
+    symbol_table_init(&builder, NULL);
+    bool ok = class_summary_declare(&loaded->summary, &builder) && symbol_table_freeze(&builder, &loaded->ddic);
+    symbol_table_free(&builder);
+    return ok;
+}
+
+static void unload(loaded_t *loaded) {
+    symbol_frozen_free(&loaded->ddic);
+    class_summary_close(&loaded->summary);
+}
+
+// Число ошибок анализа программы с символами сводки
+static int analyze_errors(const char *source, const symbol_frozen_t *ddic) {
+    TokenStream ts;
+    ASTNode *root = parse(source, &ts);
+    semantic_result_t analysis;
+    CHECK(semantic_analyze(root, ddic, NULL, &analysis));
+    int errors = analysis.diagnostics.error_count;
+    semantic_result_free(&analysis);
+    ast_node_free(root);
+    token_stream_free(&ts);
+    return errors;
+}
+
+static uint64_t fingerprint(const symbol_frozen_t *ddic, const char *name, const char *component) {
+    semantic_fingerprints_t prints;
+    semantic_fingerprints_init(&prints, ddic, NULL, 0);
+    uint64_t hash = semantic_fingerprint(&prints, atom_intern_cstr(name),
+                                         component ? atom_intern_cstr(component) : ATOM_NONE);
+    semantic_fingerprints_free(&prints);
+    return hash;
+}
+
+static void test_round_trip(const char *dir) {
+    store(dir, class_v1, 1);
+    loaded_t loaded;
+    CHECK(load(dir, &loaded));
+    CHECK(loaded.summary.source_hash == 1);
+
+    // Компоненты читаются из сводки
+    const class_summary_component_t *c_max = class_summary_find(&loaded.summary, atom_intern_cstr("C_MAX"));
+    CHECK(c_max && c_max->kind == CLASS_COMPONENT_CONSTANT && c_max->visibility == CLASS_VISIBILITY_PUBLIC);
+    CHECK(c_max && class_summary_value(&loaded.summary, c_max) && strcmp(class_summary_value(&loaded.summary, c_max), "10") == 0);
+    CHECK(c_max && class_summary_type(&loaded.summary, c_max->type) &&
+          class_summary_type(&loaded.summary, c_max->type)->size == 4);
+    const class_summary_component_t *run = class_summary_find(&loaded.summary, atom_intern_cstr("RUN"));
+    CHECK(run && run->kind == CLASS_COMPONENT_METHOD && run->param_count == 2);
+
+    // Публичные компоненты объявлены под составными именами, приватные — нет
+    const symbol_t *symbol = symbol_frozen_lookup(&loaded.ddic, atom_intern_cstr("ZCL_UTIL=>C_MAX"));
+    CHECK(symbol && symbol->kind == SYMBOL_CONSTANT && symbol->type && symbol->source_hash != 0);
+    CHECK(symbol_frozen_lookup(&loaded.ddic, atom_intern_cstr("ZCL_UTIL=>MV_SECRET")) == NULL);
+
+    CHECK(analyze_errors("DATA: n TYPE i, lo TYPE REF TO zcl_util.\n"
+                         "n = zcl_util=>c_max.\n"
+                         "zcl_util=>gv_count = n.\n", &loaded.ddic) == 0);
+    CHECK(analyze_errors("DATA n TYPE i.\nn = zcl_util=>mv_secret.\n", &loaded.ddic) == 1);
+    CHECK(analyze_errors("DATA n TYPE i.\nn = zcl_util=>nope.\n", &loaded.ddic) == 1);
+    CHECK(analyze_errors("zcl_util=>c_max = 1.\n", &loaded.ddic) == 1);
+
+    uint64_t class_v1_print = fingerprint(&loaded.ddic, "ZCL_UTIL", NULL);
+    uint64_t c_max_v1 = fingerprint(&loaded.ddic, "ZCL_UTIL", "C_MAX");
+    uint64_t run_v1 = fingerprint(&loaded.ddic, "ZCL_UTIL", "RUN");
+    unload(&loaded);
+
+    // Новая сводка: меняются отпечатки класса и константы, но не метода
+    store(dir, class_v2, 2);
+    CHECK(load(dir, &loaded));
+    CHECK(fingerprint(&loaded.ddic, "ZCL_UTIL", NULL) != class_v1_print);
+    CHECK(fingerprint(&loaded.ddic, "ZCL_UTIL", "C_MAX") != c_max_v1);
+    CHECK(fingerprint(&loaded.ddic, "ZCL_UTIL", "RUN") == run_v1);
+    unload(&loaded);
+}
+
+static const char methods_v1[] =
+    "CLASS lcl_math DEFINITION.\n"
+    "  PUBLIC SECTION.\n"
+    "    CLASS-METHODS scale IMPORTING iv_n TYPE i RETURNING VALUE(rv) TYPE i.\n"
+    "    CLASS-METHODS twice IMPORTING iv_n TYPE i RETURNING VALUE(rv) TYPE i.\n"
+    "ENDCLASS.\n"
+    "CLASS lcl_math IMPLEMENTATION.\n"
+    "  METHOD scale.\n"
+    "    rv = iv_n * 10.\n"
+    "  ENDMETHOD.\n"
+    "  METHOD twice.\n"
+    "    rv = iv_n * 2.\n"
+    "  ENDMETHOD.\n"
+    "ENDCLASS.\n"
+    "FORM caller.\n"
+    "  DATA lv TYPE i.\n"
+    "  lv = lcl_math=>scale( 1 ).\n"
+    "ENDFORM.\n"
+    "FORM bystander.\n"
+    "  DATA lv TYPE i.\n"
+    "  lv = lcl_math=>twice( 2 ).\n"
+    "ENDFORM.\n";
+
+// Участок с процедурой name (FORM или METHOD) или NULL
+static const semantic_unit_summary_t *find_unit(const semantic_result_t *result, ASTNodeType type,
+                                                const char *class_name, const char *name) {
+    const ASTNode procedure = { .type = type, .atom = atom_intern_cstr(name) };
+    uint64_t identity = semantic_procedure_identity(&procedure, class_name ? atom_intern_cstr(class_name) : ATOM_NONE);
+    for (int i = 0; i < result->unit_count; i++) {
+        if (result->units[i].identity == identity) return &result->units[i];
+    }
+    return NULL;
+}
+
+// Тип параметра CLASS-METHODS меняется: заново проверяются участки, которые искали
+// этот метод, и изменившееся определение класса; остальные берутся из прошлого анализа
+static void test_reanalyze(void) {
+    TokenStream ts_v1, ts_v2;
+    ASTNode *root_v1 = parse(methods_v1, &ts_v1);
+    semantic_result_t first, second, unchanged;
+    CHECK(semantic_analyze(root_v1, NULL, NULL, &first));
+    CHECK(first.diagnostics.count == 0);
+    CHECK(first.rechecked == first.unit_count);
+
+    // Тот же исходник: ничего не проверяется заново
+    CHECK(semantic_reanalyze(root_v1, NULL, NULL, &first, &unchanged));
+    CHECK(unchanged.rechecked == 0 && unchanged.unit_count == first.unit_count);
+    semantic_result_free(&unchanged);
+
+    char *methods_v2 = strdup(methods_v1);
+    memcpy(strstr(methods_v2, "scale IMPORTING iv_n TYPE i") + strlen("scale IMPORTING iv_n TYPE "), "p", 1);
+    ASTNode *root_v2 = parse(methods_v2, &ts_v2);
+    CHECK(semantic_reanalyze(root_v2, NULL, NULL, &first, &second));
+    CHECK(second.unit_count == first.unit_count);
+
+    const semantic_unit_summary_t *caller = find_unit(&second, AST_FORM, NULL, "CALLER");
+    const semantic_unit_summary_t *bystander = find_unit(&second, AST_FORM, NULL, "BYSTANDER");
+    const semantic_unit_summary_t *twice = find_unit(&second, AST_METHOD_IMPLEMENTATION, "LCL_MATH", "TWICE");
+    CHECK(caller && !caller->reused);
+    CHECK(bystander && bystander->reused);
+    CHECK(twice && twice->reused);
+    int reused = 0;
+    for (int i = 0; i < second.unit_count; i++) reused += second.units[i].reused;
+    CHECK(second.rechecked == second.unit_count - reused);
+    CHECK(second.rechecked < first.unit_count);
+
+    semantic_result_free(&second);
+    semantic_result_free(&first);
+    ast_node_free(root_v2);
+    ast_node_free(root_v1);
+    token_stream_free(&ts_v2);
+    token_stream_free(&ts_v1);
+    free(methods_v2);
+}
+
+static bool same_diagnostics(const diag_list_t *a, const diag_list_t *b) {
+    if (a->count != b->count || a->error_count != b->error_count) return false;
+    for (int i = 0; i < a->count; i++) {
+        const diagnostic_t *x = &a->items[i], *y = &b->items[i];
+        if (x->severity != y->severity || x->line != y->line || x->column != y->column ||
+            strcmp(x->message, y->message) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Анализ на пулах из 2, 3 и 8 потоков даёт те же сообщения в том же порядке и те же
+// участки, что анализ без пула
+static void check_pool(ASTNode *root, const char *what, int min_diagnostics) {
+    semantic_result_t expected;
+    CHECK(semantic_analyze(root, NULL, NULL, &expected));
+    CHECK(expected.diagnostics.count >= min_diagnostics);
+
+    static const int thread_counts[] = { 2, 3, 8 };
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        thread_pool_t *pool = thread_pool_create(thread_counts[t]);
+        CHECK(pool != NULL && thread_pool_size(pool) == thread_counts[t]);
+        semantic_result_t result;
+        CHECK(semantic_analyze(root, NULL, pool, &result));
+        bool same = same_diagnostics(&result.diagnostics, &expected.diagnostics) &&
+                    result.unit_count == expected.unit_count && result.rechecked == expected.rechecked &&
+                    result.globals.count == expected.globals.count;
+        for (int i = 0; same && i < result.unit_count; i++) {
+            const semantic_unit_summary_t *x = &result.units[i], *y = &expected.units[i];
+            same = x->identity == y->identity && x->body == y->body && x->diag_first == y->diag_first &&
+                   x->diag_count == y->diag_count && x->deps.count == y->deps.count;
+        }
+        if (!same) {
+            fprintf(stderr, "%s: analysis with %d threads differs\n", what, thread_counts[t]);
+            failures++;
+        }
+        semantic_result_free(&result);
+        thread_pool_destroy(pool);
+    }
+    semantic_result_free(&expected);
+}
+
+static void test_pool_order(void) {
+    // Много участков с сообщениями: повтор локального объявления, необъявленное имя,
+    // присваивание константе; в конце — повтор глобального объявления
+    enum { FORMS = 48 };
+    size_t capacity = FORMS * 256 + 64, length = 0;
+    char *source = malloc(capacity);
+    for (int i = 0; i < FORMS; i++) {
+        length += (size_t)snprintf(source + length, capacity - length,
+            "DATA gv_%d TYPE i.\n"
+            "CONSTANTS gc_%d TYPE i VALUE %d.\n"
+            "FORM f_%d.\n"
+            "  DATA lv TYPE i.\n"
+            "  DATA lv TYPE i.\n"
+            "  lv = missing_%d + gv_%d.\n"
+            "  gc_%d = lv.\n"
+            "ENDFORM.\n", i, i, i, i, i, i, i);
+    }
+    length += (size_t)snprintf(source + length, capacity - length, "DATA gv_0 TYPE i.\n");
+
+    TokenStream ts;
+    ASTNode *root = parse(source, &ts);
+    check_pool(root, "generated", 3 * FORMS + 1);
+    ast_node_free(root);
+    token_stream_free(&ts);
+    free(source);
+
+    // Примеры модулей парсера: по одному и одной программой
+    glob_t fixtures;
+    CHECK(glob("src/parser/*/*.abap", 0, NULL, &fixtures) == 0);
+    size_t total = 0;
+    char *all = NULL;
+    for (size_t i = 0; i < fixtures.gl_pathc; i++) {
+        FILE *file = fopen(fixtures.gl_pathv[i], "rb");
+        CHECK(file != NULL);
+        if (!file) continue;
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        all = realloc(all, total + (size_t)size + 2);
+        CHECK(fread(all + total, 1, (size_t)size, file) == (size_t)size);
+        fclose(file);
+        all[total + (size_t)size] = '\0';
+
+        root = parse(all + total, &ts);
+        check_pool(root, fixtures.gl_pathv[i], 0);
+        ast_node_free(root);
+        token_stream_free(&ts);
+        total += (size_t)size;
+        all[total++] = '\n';
+        all[total] = '\0';
+    }
+    if (all) {
+        root = parse(all, &ts);
+        check_pool(root, "all fixtures", 1);
+        ast_node_free(root);
+        token_stream_free(&ts);
+    }
+    free(all);
+    globfree(&fixtures);
+}
+
+// Вложенные области скрывают имя и при закрытии возвращают скрытое объявление
+static void test_symbol_shadowing(void) {
+    static ASTNode decls[4];
+    atom_t x = atom_intern_cstr("X");
+    atom_t inner_only = atom_intern_cstr("INNER_ONLY");
+    symbol_table_t table;
+    symbol_table_init(&table, NULL);
+
+    bool added = false;
+    CHECK(symbol_table_declare(&table, x, SYMBOL_VARIABLE, NULL, &decls[0], &added) && added);
+    CHECK(symbol_table_push(&table));
+    CHECK(symbol_table_lookup_local(&table, x) == NULL);
+    CHECK(symbol_table_declare(&table, x, SYMBOL_CONSTANT, NULL, &decls[1], &added) && added);
+    CHECK(symbol_table_declare(&table, inner_only, SYMBOL_VARIABLE, NULL, &decls[2], NULL));
+    // Повтор в той же области возвращает существующее объявление
+    const symbol_t *again = symbol_table_declare(&table, x, SYMBOL_PARAMETER, NULL, &decls[3], &added);
+    CHECK(again && !added && again->decl == &decls[1] && again->kind == SYMBOL_CONSTANT);
+
+    CHECK(symbol_table_push(&table));
+    CHECK(symbol_table_declare(&table, x, SYMBOL_PARAMETER, NULL, &decls[3], &added) && added);
+    const symbol_t *symbol = symbol_table_lookup(&table, x);
+    CHECK(symbol && symbol->decl == &decls[3] && symbol->scope == 2);
+
+    symbol_table_pop(&table);
+    symbol = symbol_table_lookup(&table, x);
+    CHECK(symbol && symbol->decl == &decls[1] && symbol->scope == 1);
+    CHECK(symbol_table_lookup(&table, inner_only) != NULL);
+
+    symbol_table_pop(&table);
+    symbol = symbol_table_lookup(&table, x);
+    CHECK(symbol && symbol->decl == &decls[0] && symbol->scope == 0 && symbol->shadowed == -1);
+    CHECK(symbol_table_lookup(&table, inner_only) == NULL);
+    // Внешняя область не закрывается
+    symbol_table_pop(&table);
+    CHECK(symbol_table_lookup(&table, x) == symbol);
+    symbol_table_free(&table);
+}
+
+#define SYMBOL_MODEL_CLUSTERS 8
+#define SYMBOL_MODEL_PER_CLUSTER 16
+#define SYMBOL_MODEL_NAMES (SYMBOL_MODEL_CLUSTERS * SYMBOL_MODEL_PER_CLUSTER)
+#define SYMBOL_MODEL_STEPS 20000
+
+// Модель: стек объявлений; у каждого — скрытое им объявление того же имени
+typedef struct {
+    int name;
+    int depth;
+    int previous;           // Индекс скрытого объявления или -1
+} symbol_model_entry_t;
+
+// Имена, у которых старшие 10 бит хеша слота (как в symbol_table.c) равны одному из
+// prefixes: в таблице до 1024 слотов имена группы претендуют на один слот, и пробы
+// групп 1023 и 0 переходят через конец хеша
+static void symbol_colliding_names(atom_t *names) {
+    static const uint32_t prefixes[SYMBOL_MODEL_CLUSTERS] = { 0, 1, 2, 511, 512, 1021, 1022, 1023 };
+    int filled[SYMBOL_MODEL_CLUSTERS] = { 0 };
+    int done = 0;
+    char text[16];
+    for (int i = 0; done < SYMBOL_MODEL_NAMES && i < 1000000; i++) {
+        snprintf(text, sizeof(text), "N%d", i);
+        atom_t atom = atom_intern_cstr(text);
+        uint32_t prefix = (uint32_t)(atom * 2654435769u) >> 22;
+        for (int c = 0; c < SYMBOL_MODEL_CLUSTERS; c++) {
+            if (prefixes[c] != prefix || filled[c] == SYMBOL_MODEL_PER_CLUSTER) continue;
+            names[c * SYMBOL_MODEL_PER_CLUSTER + filled[c]++] = atom;
+            done++;
+        }
+    }
+    CHECK(done == SYMBOL_MODEL_NAMES);
+}
+
+// Случайные входы, выходы и объявления с проверкой всех имён после каждого шага: удаление
+// со сдвигом назад (symbol_slot_remove()) не должно терять имена, стоящие за удалённым
+static void test_symbol_backshift(void) {
+    static ASTNode decls[SYMBOL_MODEL_STEPS];
+    static symbol_model_entry_t model[SYMBOL_MODEL_STEPS];
+    atom_t names[SYMBOL_MODEL_NAMES];
+    int visible[SYMBOL_MODEL_NAMES];        // Видимое объявление имени в model или -1
+    symbol_colliding_names(names);
+    for (int i = 0; i < SYMBOL_MODEL_NAMES; i++) visible[i] = -1;
+
+    symbol_table_t table;
+    symbol_table_init(&table, NULL);
+    int count = 0, depth = 0, mismatches = 0, scope_changes = 0, removals = 0;
+    uint32_t seed = 12345;
+    for (int step = 0; step < SYMBOL_MODEL_STEPS && mismatches == 0; step++) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t roll = (seed >> 16) % 100;
+        if (roll < 12 && depth < 24) {
+            CHECK(symbol_table_push(&table));
+            depth++;
+            scope_changes++;
+        } else if (roll < 26 && depth > 0) {
+            symbol_table_pop(&table);
+            for (; count > 0 && model[count - 1].depth == depth; count--) {
+                visible[model[count - 1].name] = model[count - 1].previous;
+                if (model[count - 1].previous < 0) removals++;
+            }
+            depth--;
+            scope_changes++;
+        } else {
+            int name = (int)((seed >> 8) % SYMBOL_MODEL_NAMES);
+            bool declared = visible[name] >= 0 && model[visible[name]].depth == depth;
+            bool added = false;
+            CHECK(symbol_table_declare(&table, names[name], SYMBOL_VARIABLE, NULL, &decls[step], &added));
+            CHECK(added == !declared);
+            if (!declared) {
+                model[count] = (symbol_model_entry_t){ name, depth, visible[name] };
+                visible[name] = count++;
+            }
+        }
+
+        int used = 0;
+        for (int n = 0; n < SYMBOL_MODEL_NAMES; n++) {
+            const symbol_t *symbol = symbol_table_lookup(&table, names[n]);
+            if (visible[n] >= 0) used++;
+            if ((visible[n] < 0) != (symbol == NULL) || (symbol && symbol->scope != model[visible[n]].depth)) {
+                mismatches++;
+            }
+        }
+        // Хеш держит только видимые имена: выход из области не оставляет занятых слотов
+        if (table.used != used || table.count != count) mismatches++;
+    }
+    CHECK(mismatches == 0);
+    CHECK(scope_changes > 1000 && removals > 200);
+    symbol_table_free(&table);
+}
+
+// Заморозка: видимые объявления; поиск идёт по цепочке outer (программа -> встроенные -> DDIC)
+static void test_symbol_frozen_chain(void) {
+    static ASTNode decls[8];
+    atom_t a = atom_intern_cstr("A"), b = atom_intern_cstr("B"), c = atom_intern_cstr("C");
+    atom_t d = atom_intern_cstr("D"), e = atom_intern_cstr("E"), missing = atom_intern_cstr("MISSING");
+
+    symbol_table_t builder;
+    symbol_frozen_t ddic, builtins, program;
+    symbol_table_init(&builder, NULL);
+    CHECK(symbol_table_declare(&builder, a, SYMBOL_TYPE, NULL, &decls[0], NULL));
+    CHECK(symbol_table_declare(&builder, b, SYMBOL_TYPE, NULL, &decls[1], NULL));
+    CHECK(symbol_table_freeze(&builder, &ddic));
+    symbol_table_free(&builder);
+
+    symbol_table_init(&builder, &ddic);
+    CHECK(symbol_table_declare(&builder, b, SYMBOL_CONSTANT, NULL, &decls[2], NULL));    // Скрывает B из DDIC
+    CHECK(symbol_table_declare(&builder, c, SYMBOL_CONSTANT, NULL, &decls[3], NULL));
+    CHECK(symbol_table_freeze(&builder, &builtins));
+    symbol_table_free(&builder);
+
+    symbol_table_init(&builder, &builtins);
+    CHECK(symbol_table_declare(&builder, d, SYMBOL_VARIABLE, NULL, &decls[4], NULL));
+    CHECK(symbol_table_push(&builder));
+    CHECK(symbol_table_declare(&builder, e, SYMBOL_VARIABLE, NULL, &decls[5], NULL));
+    symbol_table_pop(&builder);     // E закрыт до заморозки
+    CHECK(symbol_table_push(&builder));
+    CHECK(symbol_table_declare(&builder, d, SYMBOL_CONSTANT, NULL, &decls[6], NULL));
+    CHECK(symbol_table_freeze(&builder, &program));     // Видимое D — из открытой области
+    symbol_table_free(&builder);
+
+    CHECK(ddic.outer == NULL && builtins.outer == &ddic && program.outer == &builtins);
+    CHECK(program.count == 1);
+    const symbol_t *symbol = symbol_frozen_lookup(&program, a);
+    CHECK(symbol && symbol->decl == &decls[0]);
+    symbol = symbol_frozen_lookup(&program, b);
+    CHECK(symbol && symbol->decl == &decls[2]);
+    symbol = symbol_frozen_lookup(&ddic, b);
+    CHECK(symbol && symbol->decl == &decls[1]);
+    symbol = symbol_frozen_lookup(&program, c);
+    CHECK(symbol && symbol->decl == &decls[3]);
+    symbol = symbol_frozen_lookup(&program, d);
+    CHECK(symbol && symbol->decl == &decls[6]);
+    CHECK(symbol_frozen_lookup(&program, e) == NULL);
+    CHECK(symbol_frozen_lookup(&program, missing) == NULL);
+    CHECK(symbol_frozen_lookup(&builtins, d) == NULL);
+
+    // Таблица с областями поверх цепочки: локальное имя скрывает глобальное до выхода из области
+    symbol_table_t table;
+    symbol_table_init(&table, &program);
+    symbol = symbol_table_lookup(&table, a);
+    CHECK(symbol && symbol->decl == &decls[0]);
+    CHECK(symbol_table_lookup_local(&table, a) == NULL);
+    CHECK(symbol_table_push(&table));
+    CHECK(symbol_table_declare(&table, a, SYMBOL_VARIABLE, NULL, &decls[7], NULL));
+    symbol = symbol_table_lookup(&table, a);
+    CHECK(symbol && symbol->decl == &decls[7]);
+    symbol_table_pop(&table);
+    symbol = symbol_table_lookup(&table, a);
+    CHECK(symbol && symbol->decl == &decls[0]);
+    symbol_table_free(&table);
+
+    symbol_frozen_free(&program);
+    symbol_frozen_free(&builtins);
+    symbol_frozen_free(&ddic);
+}
+
+// Раскладки: вложенные структуры, таблицы программы и DDIC, цикл TYPES и разбор только
+// используемых типов
+static const char layout_source[] =
+    "TYPES: BEGIN OF ts_inner,\n"
+    "         a TYPE c LENGTH 3,\n"
+    "         b TYPE i,\n"
+    "       END OF ts_inner.\n"
+    "TYPES tt_inner TYPE STANDARD TABLE OF ts_inner WITH DEFAULT KEY.\n"
+    "TYPES: BEGIN OF ts_outer,\n"
+    "         flag  TYPE x,\n"
+    "         inner TYPE ts_inner,\n"
+    "         text  TYPE string,\n"
+    "         rows  TYPE tt_inner,\n"
+    "         row   TYPE LINE OF tt_rows,\n"
+    "       END OF ts_outer.\n"
+    "TYPES ts_unused TYPE ts_inner.\n"
+    "TYPES ta TYPE tb.\n"
+    "TYPES tb TYPE ta.\n"
+    "DATA gs_outer TYPE ts_outer.\n"
+    "DATA gv_b LIKE gs_outer-inner-b.\n"
+    "DATA gr_outer TYPE REF TO ts_outer.\n"
+    "DATA gv_cycle TYPE ta.\n";
+
+static const ASTNode *global_decl(const semantic_result_t *analysis, const char *name) {
+    const symbol_t *symbol = symbol_frozen_lookup(&analysis->globals, atom_intern_cstr(name));
+    CHECK(symbol && symbol->decl);
+    return symbol ? symbol->decl : NULL;
+}
+
+static void check_component(const TypeInfo *type, const char *name, size_t offset, const TypeInfo *component) {
+    const type_component_t *found = type_component_find(type, atom_intern_cstr(name));
+    CHECK(found && found->offset == offset && found->type == component);
+}
+
+static void test_type_layout(void) {
+    // DDIC: таблица tt_rows со строкой ts_ddic_row (id TYPE int8)
+    atom_t tt_rows = atom_intern_cstr("TT_ROWS");
+    type_component_t id = { atom_intern_cstr("ID"), 0, type_builtin(atom_intern_cstr("INT8")) };
+    TypeInfo *ddic_row = type_structure_create(atom_intern_cstr("TS_DDIC_ROW"), &id, 1);
+    TypeInfo *ddic_table = type_indirect_create(TYPE_KIND_TABLE, ddic_row);
+    CHECK(ddic_row && ddic_table);
+    ddic_table->name = tt_rows;
+    symbol_table_t builder;
+    symbol_frozen_t ddic;
+    symbol_table_init(&builder, NULL);
+    CHECK(symbol_table_declare(&builder, tt_rows, SYMBOL_TYPE, ddic_table, NULL, NULL));
+    CHECK(symbol_table_freeze(&builder, &ddic));
+    symbol_table_free(&builder);
+
+    TokenStream ts;
+    ASTNode *root = parse(layout_source, &ts);
+    semantic_result_t analysis;
+    CHECK(semantic_analyze(root, &ddic, NULL, &analysis));
+    // Цикл найден через объект данных; сам по себе цикл TYPES не разбирается
+    CHECK(analysis.diagnostics.error_count == 1);
+    CHECK(analysis.diagnostics.count == 1 &&
+          strcmp(analysis.diagnostics.items[0].message, "Type of 'GV_CYCLE' has a cyclic definition") == 0);
+    CHECK(type_cache_find(&analysis.types, global_decl(&analysis, "TA")) == &type_cyclic);
+    CHECK(type_cache_find(&analysis.types, global_decl(&analysis, "TB")) == &type_cyclic);
+
+    const TypeInfo *i = type_builtin(atom_intern_cstr("I"));
+    const TypeInfo *string = type_builtin(atom_intern_cstr("STRING"));
+    const TypeInfo *inner = type_cache_find(&analysis.types, global_decl(&analysis, "TS_INNER"));
+    CHECK(inner && inner->kind == TYPE_KIND_STRUCTURE && inner->component_count == 2);
+    if (inner) {
+        // C LENGTH 3 — 6 байт, I выравнивается на 4
+        const type_component_t *a = type_component_find(inner, atom_intern_cstr("A"));
+        CHECK(a && a->offset == 0 && a->type->elementary == TYPE_C && a->type->length == 3 && a->type->size == 6);
+        check_component(inner, "B", 8, i);
+        CHECK(inner->size == 12 && inner->align == 4 && !inner->deep);
+    }
+
+    const TypeInfo *table = type_cache_find(&analysis.types, global_decl(&analysis, "TT_INNER"));
+    CHECK(table && table->kind == TYPE_KIND_TABLE && table->line == inner);
+    CHECK(table && table->size == sizeof(void *) && table->align == sizeof(void *) && table->deep);
+
+    const TypeInfo *outer = type_cache_find(&analysis.types, global_decl(&analysis, "TS_OUTER"));
+    CHECK(outer && outer->kind == TYPE_KIND_STRUCTURE && outer->component_count == 5);
+    if (outer && inner && table) {
+        size_t rows = 16 + sizeof(void *);                  // После string
+        size_t row = rows + sizeof(void *);                 // ts_ddic_row выравнивается на 8
+        check_component(outer, "FLAG", 0, type_builtin(atom_intern_cstr("X")));
+        check_component(outer, "INNER", 4, inner);
+        check_component(outer, "TEXT", 16, string);
+        check_component(outer, "ROWS", rows, table);
+        check_component(outer, "ROW", row, ddic_row);
+        CHECK(outer->size == row + 8 && outer->align == 8 && outer->deep);
+    }
+    CHECK(type_cache_find(&analysis.types, global_decl(&analysis, "GS_OUTER")) == outer);
+    CHECK(type_cache_find(&analysis.types, global_decl(&analysis, "GV_B")) == i);
+    const TypeInfo *reference = type_cache_find(&analysis.types, global_decl(&analysis, "GR_OUTER"));
+    CHECK(reference && reference->kind == TYPE_KIND_REFERENCE && reference->line == outer && reference->deep);
+
+    // ts_unused не нужен ни одному объекту данных: раскладка вычисляется только по запросу,
+    // один раз
+    const ASTNode *unused = global_decl(&analysis, "TS_UNUSED");
+    CHECK(type_cache_find(&analysis.types, unused) == NULL);
+    size_t count = type_cache_count(&analysis.types);
+    symbol_table_t table_symbols;
+    symbol_table_init(&table_symbols, &analysis.globals);
+    semantic_context_t context = { .symbols = &table_symbols, .types = &analysis.types };
+    const TypeInfo *resolved = type_resolve_decl(&context, unused);
+    CHECK(resolved == inner && type_cache_count(&analysis.types) == count + 1);
+    CHECK(type_resolve_decl(&context, unused) == resolved && type_cache_count(&analysis.types) == count + 1);
+    CHECK(!context.failed);
+    symbol_table_free(&table_symbols);
+
+    semantic_result_free(&analysis);
+    ast_node_free(root);
+    token_stream_free(&ts);
+    symbol_frozen_free(&ddic);
+    free(ddic_table);
+    free(ddic_row);
+}
+
+int main(void) {
+    char dir[] = "/tmp/test_semantic_XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    test_round_trip(dir);
+    test_reanalyze();
+    test_pool_order();
+    test_symbol_shadowing();
+    test_symbol_backshift();
+    test_symbol_frozen_chain();
+    test_type_layout();
+
+    char path[4096];
+    if (class_summary_path(path, sizeof(path), dir, atom_intern_cstr("ZCL_UTIL"))) unlink(path);
+    rmdir(dir);
+    atom_table_free();
+    if (failures) {
+        fprintf(stderr, "test_semantic: %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("test_semantic: OK\n");
+    return 0;
+}
@@ -0,0 +1,181 @@
+// tools/bench/bench_lexer.c
+// Бенчмарк пропускной способности лексера на многомегабайтных исходниках.
+// Входные файлы ABAP склеиваются и повторяются до заданного объёма, после чего
+// текст лексируется каждой доступной реализацией ядер сканирования
+// (scalar, sse2, avx2) и выводятся MB/s и токены/с. С --threads дополнительно
+// замеряется параллельная лексика (lexer_parallel.h) лучшей реализацией ядер.
+//
+// Использование:
+//   bench_lexer [--mb <размер>] [--runs <n>] [--threads <n>] <файл.abap>...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lexer.h"
+#include "lexer_parallel.h"
+#include "lexer_scan.h"
+#include "source_buffer.h"
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Склеивает файлы и повторяет их содержимое, пока объём не достигнет target байт
+static char *bench_build_corpus(int count, char **paths, size_t target, size_t *out_length) {
+    size_t seed_length = 0;
+    char *seed = NULL;
+
+    for (int i = 0; i < count; i++) {
+        source_buffer_t buffer;
+        if (!source_buffer_open(&buffer, paths[i])) {
+            free(seed);
+            return NULL;
+        }
+        char *grown = realloc(seed, seed_length + buffer.length + 1);
+        if (!grown) {
+            fprintf(stderr, "Out of memory while building corpus\n");
+            source_buffer_close(&buffer);
+            free(seed);
+            return NULL;
+        }
+        seed = grown;
+        memcpy(seed + seed_length, buffer.data, buffer.length);
+        seed_length += buffer.length;
+        seed[seed_length++] = '\n';
+        source_buffer_close(&buffer);
+    }
+
+    if (seed_length == 0) {
+        fprintf(stderr, "Empty corpus\n");
+        free(seed);
+        return NULL;
+    }
+
+    size_t length = target > seed_length ? target : seed_length;
+    char *corpus = malloc(length);
+    if (!corpus) {
+        fprintf(stderr, "Out of memory while building corpus\n");
+        free(seed);
+        return NULL;
+    }
+    for (size_t pos = 0; pos < length; pos += seed_length) {
+        size_t chunk = length - pos < seed_length ? length - pos : seed_length;
+        memcpy(corpus + pos, seed, chunk);
+    }
+    free(seed);
+    *out_length = length;
+    return corpus;
+}
+
+// Лексирует весь текст и возвращает количество токенов
+static size_t bench_lex(const char *text, size_t length) {
+    lexer_t lexer;
+    size_t tokens = 0;
+    lexer_init(&lexer, text, length);
+    for (;;) {
+        token_t token = lexer_next_token(&lexer);
+        if (token.type == TOKEN_EOF) break;
+        tokens++;
+    }
+    lexer_free(&lexer);
+    return tokens;
+}
+
+// Параллельная лексика в поток токенов; возвращает количество токенов
+static size_t bench_lex_parallel(const char *text, size_t length, thread_pool_t *pool) {
+    TokenStream stream;
+    if (!lexer_parallel_tokenize(&stream, text, length, pool)) return 0;
+    size_t tokens = (size_t)stream.token_count;
+    token_stream_free(&stream);
+    return tokens;
+}
+
+static void bench_report(const char *name, size_t length, size_t tokens, double best) {
+    printf("%s\t%zu\t%zu\t%.6f\t%.1f\t%.0f\n",
+           name, length, tokens, best,
+           (double)length / (1024.0 * 1024.0) / best, (double)tokens / best);
+}
+
+int main(int argc, char **argv) {
+    size_t megabytes = 64;
+    int runs = 5;
+    int threads = 1;
+    int first_file = 1;
+
+    while (first_file < argc && argv[first_file][0] == '-') {
+        if (strcmp(argv[first_file], "--mb") == 0 && first_file + 1 < argc) {
+            megabytes = (size_t)strtoul(argv[first_file + 1], NULL, 10);
+            first_file += 2;
+        } else if (strcmp(argv[first_file], "--runs") == 0 && first_file + 1 < argc) {
+            runs = atoi(argv[first_file + 1]);
+            first_file += 2;
+        } else if (strcmp(argv[first_file], "--threads") == 0 && first_file + 1 < argc) {
+            threads = atoi(argv[first_file + 1]);
+            first_file += 2;
+        } else {
+            break;
+        }
+    }
+    if (first_file >= argc || runs <= 0) {
+        fprintf(stderr, "Usage: %s [--mb <size>] [--runs <n>] [--threads <n>] <file.abap>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t length = 0;
+    char *corpus = bench_build_corpus(argc - first_file, argv + first_file, megabytes << 20, &length);
+    if (!corpus) return EXIT_FAILURE;
+
+    static const lexer_scan_impl_t impls[] = { LEXER_SCAN_SCALAR, LEXER_SCAN_SSE2, LEXER_SCAN_AVX2 };
+    lexer_scan_impl_t done[3];
+    int done_count = 0;
+
+    printf("impl\tbytes\ttokens\tbest_s\tMB_per_s\ttokens_per_s\n");
+    for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+        lexer_scan_impl_t impl = lexer_scan_select(impls[i]);
+        // Реализация, не поддерживаемая процессором, заменяется доступной — не повторяем замер
+        int seen = 0;
+        for (int k = 0; k < done_count; k++) seen |= done[k] == impl;
+        if (seen) continue;
+        done[done_count++] = impl;
+
+        double best = 0.0;
+        size_t tokens = 0;
+        for (int r = 0; r < runs; r++) {
+            double start = bench_now();
+            tokens = bench_lex(corpus, length);
+            double elapsed = bench_now() - start;
+            if (r == 0 || elapsed < best) best = elapsed;
+        }
+        bench_report(lexer_scan_impl_name(impl), length, tokens, best);
+    }
+
+    // Параллельная лексика: 0 — по числу процессоров
+    if (threads != 1) {
+        lexer_scan_impl_t impl = lexer_scan_select(LEXER_SCAN_AUTO);
+        thread_pool_t *pool = thread_pool_create(threads);
+        if (!pool) {
+            free(corpus);
+            return EXIT_FAILURE;
+        }
+
+        double best = 0.0;
+        size_t tokens = 0;
+        for (int r = 0; r < runs; r++) {
+            double start = bench_now();
+            tokens = bench_lex_parallel(corpus, length, pool);
+            double elapsed = bench_now() - start;
+            if (r == 0 || elapsed < best) best = elapsed;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "%s/%dt", lexer_scan_impl_name(impl), thread_pool_size(pool));
+        bench_report(name, length, tokens, best);
+        thread_pool_destroy(pool);
+    }
+
+    free(corpus);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,425 @@
+// tools/bench/bench_parser.c
+// Бенчмарк фронтенда (лексика, раскрытие цепочек, разбор) на корпусе фикстур парсера.
+// Корпус "fixtures" — каждый файл src/parser/*/*.abap по отдельности, как их разбирает
+// компилятор. Корпус "synthetic" — фикстуры, размноженные генератором до заданного
+// числа строк (по умолчанию 1M): в каждой копии к идентификаторам добавляется суффикс
+// номера копии, чтобы таблица атомов и символов росла так же, как на реальном коде,
+// а не обслуживала одни и те же имена.
+//
+// Для каждой фазы выводятся токены/с, операторы/с, выделения памяти на оператор и
+// пиковый RSS. Вывод — таблица с разделителями-табуляциями с постоянным набором
+// колонок (см. README.md), чтобы CI мог сравнивать прогоны между коммитами.
+//
+// Использование:
+//   bench_parser [--lines <n>] [--runs <n>] [--per-file] <файл.abap>...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "lexer.h"
+#include "parser.h"
+#include "source_buffer.h"
+#include "token_stream.h"
+
+/*
+ * Подсчёт выделений памяти. В glibc malloc можно заменить в самой программе:
+ * вызовы из библиотеки и из модулей компилятора попадают сюда, а настоящий
+ * распределитель доступен как __libc_*. На других libc счётчики остаются нулевыми.
+ */
+#if defined(__GLIBC__)
+#define BENCH_COUNT_ALLOCS 1
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static unsigned long bench_alloc_count;
+
+void *malloc(size_t size) {
+    __atomic_add_fetch(&bench_alloc_count, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    __atomic_add_fetch(&bench_alloc_count, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    __atomic_add_fetch(&bench_alloc_count, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+
+static unsigned long bench_allocs(void) {
+    return __atomic_load_n(&bench_alloc_count, __ATOMIC_RELAXED);
+}
+#else
+#define BENCH_COUNT_ALLOCS 0
+
+static unsigned long bench_allocs(void) {
+    return 0;
+}
+#endif
+
+// Исходный текст одного элемента корпуса
+typedef struct {
+    const char *name;
+    char *text;
+    size_t length;
+    size_t lines;
+} bench_text_t;
+
+// Результат одного прогона фазы над одним текстом
+typedef struct {
+    double seconds;         // Время измеряемой части (подготовка не входит)
+    unsigned long allocs;   // Выделения памяти в измеряемой части
+    size_t tokens;
+    size_t statements;
+} bench_sample_t;
+
+typedef bool (*bench_phase_fn)(const bench_text_t *text, bench_sample_t *sample);
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Сброс пикового RSS процесса до текущего (Linux, /proc/self/clear_refs).
+// Если сбросить нельзя, пик считается с начала процесса.
+static void bench_reset_peak_rss(void) {
+    FILE *file = fopen("/proc/self/clear_refs", "w");
+    if (!file) return;
+    fputs("5", file);
+    fclose(file);
+}
+
+// Пиковый RSS в килобайтах с последнего сброса
+static long bench_peak_rss_kb(void) {
+    FILE *file = fopen("/proc/self/status", "r");
+    if (file) {
+        char line[256];
+        long peak = -1;
+        while (fgets(line, sizeof(line), file)) {
+            if (strncmp(line, "VmHWM:", 6) == 0) {
+                peak = strtol(line + 6, NULL, 10);
+                break;
+            }
+        }
+        fclose(file);
+        if (peak >= 0) return peak;
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static size_t bench_count_lines(const char *text, size_t length) {
+    size_t lines = 0;
+    for (size_t i = 0; i < length; i++) {
+        lines += text[i] == '\n';
+    }
+    return length > 0 && text[length - 1] != '\n' ? lines + 1 : lines;
+}
+
+// Операторы потока: точки, включая запятые цепочек (после token_stream_expand_chains())
+static size_t bench_count_statements(const TokenStream *stream) {
+    int count = stream->chains ? stream->chains->virtual_count : stream->token_count;
+    size_t statements = 0;
+    for (int i = 0; i < count; i++) {
+        statements += token_stream_type_at(stream, i) == TOKEN_PUNCTUATION_DOT;
+    }
+    return statements;
+}
+
+static bool bench_lex_stream(TokenStream *stream, const bench_text_t *text) {
+    lexer_t lexer;
+    lexer_init(&lexer, text->text, text->length);
+    bool ok = token_stream_from_lexer(stream, &lexer);
+    lexer_free(&lexer);
+    return ok;
+}
+
+// Фаза "lex": текст -> TokenStream
+static bool bench_phase_lex(const bench_text_t *text, bench_sample_t *sample) {
+    TokenStream stream;
+    unsigned long allocs = bench_allocs();
+    double start = bench_now();
+    bool ok = bench_lex_stream(&stream, text);
+    sample->seconds = bench_now() - start;
+    sample->allocs = bench_allocs() - allocs;
+    if (!ok) return false;
+    sample->tokens = (size_t)stream.token_count;
+    ok = token_stream_expand_chains(&stream);
+    sample->statements = bench_count_statements(&stream);
+    token_stream_free(&stream);
+    return ok;
+}
+
+// Фаза "chains": раскрытие цепочечных операторов в уже построенном потоке
+static bool bench_phase_chains(const bench_text_t *text, bench_sample_t *sample) {
+    TokenStream stream;
+    if (!bench_lex_stream(&stream, text)) return false;
+    unsigned long allocs = bench_allocs();
+    double start = bench_now();
+    bool ok = token_stream_expand_chains(&stream);
+    sample->seconds = bench_now() - start;
+    sample->allocs = bench_allocs() - allocs;
+    if (ok) {
+        sample->tokens = (size_t)(stream.chains ? stream.chains->virtual_count : stream.token_count);
+        sample->statements = bench_count_statements(&stream);
+    }
+    token_stream_free(&stream);
+    return ok;
+}
+
+// Фаза "parse": лексика и разбор программы в AST, включая освобождение дерева
+static bool bench_phase_parse(const bench_text_t *text, bench_sample_t *sample) {
+    TokenStream stream;
+    if (!bench_lex_stream(&stream, text)) return false;
+    if (!token_stream_expand_chains(&stream)) {
+        token_stream_free(&stream);
+        return false;
+    }
+    sample->tokens = (size_t)stream.token_count;
+    sample->statements = bench_count_statements(&stream);
+    token_stream_free(&stream);
+
+    // Сообщения собираются в список, а не печатаются: вывод не должен входить в замер
+    unsigned long allocs = bench_allocs();
+    double start = bench_now();
+    diag_list_t diagnostics;
+    diag_list_init(&diagnostics);
+    bool ok = bench_lex_stream(&stream, text);
+    ASTNode *program = NULL;
+    if (ok && token_stream_expand_chains(&stream)) program = parse_program(&stream, &diagnostics);
+    ast_node_free(program);
+    diag_list_free(&diagnostics);
+    if (ok) token_stream_free(&stream);
+    sample->seconds = bench_now() - start;
+    sample->allocs = bench_allocs() - allocs;
+    return program != NULL;
+}
+
+static void bench_report(const char *corpus, const char *phase, size_t bytes, size_t lines,
+                         size_t tokens, size_t statements, double best,
+                         unsigned long allocs, long peak_rss_kb) {
+    double per_stmt = statements ? (double)allocs / (double)statements : 0.0;
+    printf("%s\t%s\t%zu\t%zu\t%zu\t%zu\t%.6f\t%.0f\t%.0f\t%lu\t%.2f\t%ld\n",
+           corpus, phase, bytes, lines, tokens, statements, best,
+           best > 0.0 ? (double)tokens / best : 0.0,
+           best > 0.0 ? (double)statements / best : 0.0,
+           allocs, per_stmt, peak_rss_kb);
+}
+
+// Прогон фазы над набором текстов: лучшее из runs суммарное время, выделения первого
+// прогона (последующие могут переиспользовать уже созданные атомы), пиковый RSS
+static bool bench_run_phase(const char *corpus, const char *phase, bench_phase_fn fn,
+                            const bench_text_t *texts, size_t count, int runs) {
+    size_t bytes = 0, lines = 0, tokens = 0, statements = 0;
+    unsigned long allocs = 0;
+    double best = 0.0;
+
+    bench_reset_peak_rss();
+    for (int r = 0; r < runs; r++) {
+        unsigned long run_allocs = 0;
+        double total = 0.0;
+        tokens = statements = 0;
+        for (size_t i = 0; i < count; i++) {
+            bench_sample_t sample = { 0.0, 0, 0, 0 };
+            if (!fn(&texts[i], &sample)) {
+                fprintf(stderr, "Phase %s failed on %s\n", phase, texts[i].name);
+                return false;
+            }
+            total += sample.seconds;
+            run_allocs += sample.allocs;
+            tokens += sample.tokens;
+            statements += sample.statements;
+        }
+        if (r == 0) allocs = run_allocs;
+        if (r == 0 || total < best) best = total;
+    }
+    long peak = bench_peak_rss_kb();
+
+    for (size_t i = 0; i < count; i++) {
+        bytes += texts[i].length;
+        lines += texts[i].lines;
+    }
+    bench_report(corpus, phase, bytes, lines, tokens, statements, best, allocs, peak);
+    return true;
+}
+
+// Генератор синтетического корпуса: seed повторяется, пока не наберётся target строк;
+// к каждому идентификатору копии k > 0 добавляется суффикс "_<k в base36>"
+static char *bench_synthesize(const bench_text_t *seed, size_t target, size_t *out_length) {
+    TokenStream stream;
+    if (!bench_lex_stream(&stream, seed)) return NULL;
+
+    size_t copies = seed->lines ? (target + seed->lines - 1) / seed->lines : 1;
+    if (copies == 0) copies = 1;
+    size_t identifiers = 0, suffix_max = 1;
+    for (int i = 0; i < stream.token_count; i++) {
+        identifiers += token_stream_type_at(&stream, i) == TOKEN_IDENTIFIER;
+    }
+    for (size_t v = copies; v > 0; v /= 36) suffix_max++;
+    size_t capacity = (seed->length + identifiers * suffix_max) * copies + 1;
+    char *out = malloc(capacity);
+    if (!out) {
+        fprintf(stderr, "Out of memory while generating synthetic corpus\n");
+        token_stream_free(&stream);
+        return NULL;
+    }
+
+    size_t length = 0;
+    for (size_t k = 0; k < copies; k++) {
+        char suffix[16];
+        size_t suffix_length = 0;
+        if (k > 0) {
+            char digits[16];
+            size_t n = 0;
+            for (size_t v = k; v > 0; v /= 36) digits[n++] = "0123456789abcdefghijklmnopqrstuvwxyz"[v % 36];
+            suffix[suffix_length++] = '_';
+            while (n > 0) suffix[suffix_length++] = digits[--n];
+        }
+
+        size_t last = 0;
+        for (int i = 0; i < stream.token_count && suffix_length > 0; i++) {
+            if (token_stream_type_at(&stream, i) != TOKEN_IDENTIFIER) continue;
+            size_t end = token_stream_offset_at(&stream, i) + (size_t)token_stream_length_at(&stream, i);
+            memcpy(out + length, seed->text + last, end - last);
+            length += end - last;
+            memcpy(out + length, suffix, suffix_length);
+            length += suffix_length;
+            last = end;
+        }
+        size_t rest = seed->length - last;
+        memcpy(out + length, seed->text + last, rest);
+        length += rest;
+    }
+
+    token_stream_free(&stream);
+    *out_length = length;
+    return out;
+}
+
+// Загрузка файла в память (буфер владеет копией: генератор и фазы работают с ним после закрытия)
+static bool bench_load(bench_text_t *text, const char *path) {
+    source_buffer_t buffer;
+    if (!source_buffer_open(&buffer, path)) return false;
+    text->name = path;
+    text->length = buffer.length;
+    text->text = malloc(buffer.length + 1);
+    if (!text->text) {
+        fprintf(stderr, "Out of memory while loading %s\n", path);
+        source_buffer_close(&buffer);
+        return false;
+    }
+    memcpy(text->text, buffer.data, buffer.length);
+    text->text[buffer.length] = '\n';
+    text->lines = bench_count_lines(text->text, text->length);
+    source_buffer_close(&buffer);
+    return true;
+}
+
+static void bench_free_texts(bench_text_t *texts, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(texts[i].text);
+    }
+    free(texts);
+}
+
+int main(int argc, char **argv) {
+    size_t target_lines = 1000000;
+    int runs = 3;
+    bool per_file = false;
+    int first_file = 1;
+
+    while (first_file < argc && argv[first_file][0] == '-') {
+        if (strcmp(argv[first_file], "--lines") == 0 && first_file + 1 < argc) {
+            target_lines = (size_t)strtoul(argv[first_file + 1], NULL, 10);
+            first_file += 2;
+        } else if (strcmp(argv[first_file], "--runs") == 0 && first_file + 1 < argc) {
+            runs = atoi(argv[first_file + 1]);
+            first_file += 2;
+        } else if (strcmp(argv[first_file], "--per-file") == 0) {
+            per_file = true;
+            first_file++;
+        } else {
+            break;
+        }
+    }
+    if (first_file >= argc || runs <= 0) {
+        fprintf(stderr, "Usage: %s [--lines <n>] [--runs <n>] [--per-file] <file.abap>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t count = (size_t)(argc - first_file);
+    bench_text_t *texts = calloc(count, sizeof(bench_text_t));
+    if (!texts) return EXIT_FAILURE;
+    size_t seed_length = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!bench_load(&texts[i], argv[first_file + i])) {
+            bench_free_texts(texts, i);
+            return EXIT_FAILURE;
+        }
+        seed_length += texts[i].length + 1;
+    }
+
+    // Затравка генератора — все фикстуры подряд, каждая с переводом строки в конце
+    bench_text_t seed = { "seed", malloc(seed_length ? seed_length : 1), 0, 0 };
+    if (!seed.text) {
+        bench_free_texts(texts, count);
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < count; i++) {
+        memcpy(seed.text + seed.length, texts[i].text, texts[i].length + 1);
+        seed.length += texts[i].length + 1;
+    }
+    seed.lines = bench_count_lines(seed.text, seed.length);
+
+    bench_text_t synthetic = { "synthetic", NULL, 0, 0 };
+    synthetic.text = bench_synthesize(&seed, target_lines, &synthetic.length);
+    free(seed.text);
+    if (!synthetic.text) {
+        bench_free_texts(texts, count);
+        return EXIT_FAILURE;
+    }
+    synthetic.lines = bench_count_lines(synthetic.text, synthetic.length);
+
+    static const struct {
+        const char *name;
+        bench_phase_fn fn;
+    } phases[] = {
+        { "lex",    bench_phase_lex },
+        { "chains", bench_phase_chains },
+        { "parse",  bench_phase_parse },
+    };
+    size_t phase_count = sizeof(phases) / sizeof(phases[0]);
+
+    printf("corpus\tphase\tbytes\tlines\ttokens\tstatements\tbest_s\ttokens_per_s\tstatements_per_s\t"
+           "allocs\tallocs_per_stmt\tpeak_rss_kb\n");
+    if (!BENCH_COUNT_ALLOCS) fprintf(stderr, "Allocation counting is not supported on this libc\n");
+
+    bool ok = true;
+    for (size_t p = 0; ok && p < phase_count; p++) {
+        ok = bench_run_phase("fixtures", phases[p].name, phases[p].fn, texts, count, runs);
+        for (size_t i = 0; ok && per_file && i < count; i++) {
+            ok = bench_run_phase(texts[i].name, phases[p].name, phases[p].fn, &texts[i], 1, runs);
+        }
+    }
+    for (size_t p = 0; ok && p < phase_count; p++) {
+        ok = bench_run_phase("synthetic", phases[p].name, phases[p].fn, &synthetic, 1, runs);
+    }
+
+    free(synthetic.text);
+    bench_free_texts(texts, count);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
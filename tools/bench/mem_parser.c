@@ -0,0 +1,316 @@
+// tools/bench/mem_parser.c
+// Проверка памяти фронтенда на фикстурах парсера. Каждая фикстура src/parser/*/*.abap
+// лексируется и разбирается в AST так же, как в фазе "parse" bench_parser, а
+// перехваченный распределитель считает выделения, выделенные байты и пик живой памяти.
+// Результаты сверяются с бюджетом из файла (mem_budget.tsv): превышение по любой
+// фикстуре или фикстура без бюджета — код возврата 1, поэтому проверку можно
+// запускать в CI как тест.
+//
+// Таблица атомов сбрасывается перед каждой фикстурой: цифры не зависят от порядка
+// файлов и соответствуют отдельному запуску компилятора на одном файле.
+//
+// Использование:
+//   mem_parser --budget <файл.tsv> <файл.abap>...   проверка
+//   mem_parser --write <файл.tsv> <файл.abap>...    запись бюджета по текущим цифрам
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atom.h"
+#include "lexer.h"
+#include "parser.h"
+#include "source_buffer.h"
+#include "token_stream.h"
+
+/*
+ * Перехват распределителя. Как и в bench_parser, glibc позволяет заменить malloc в
+ * самой программе; настоящий распределитель доступен как __libc_*. Размер блока при
+ * освобождении берётся из malloc_usable_size(), поэтому живая память и пик считаются
+ * в байтах, которые распределитель действительно отдал (с округлением), а не в
+ * запрошенных. На других libc проверка невозможна и программа завершается с ошибкой.
+ */
+#if defined(__GLIBC__)
+#include <malloc.h>
+
+#define MEM_COUNT_ALLOCS 1
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+static unsigned long mem_alloc_count;
+static unsigned long mem_alloc_bytes;
+static long mem_live_bytes;
+static long mem_peak_bytes;
+
+static void *mem_track(void *ptr) {
+    if (!ptr) return NULL;
+    long size = (long)malloc_usable_size(ptr);
+    __atomic_add_fetch(&mem_alloc_count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&mem_alloc_bytes, (unsigned long)size, __ATOMIC_RELAXED);
+    long live = __atomic_add_fetch(&mem_live_bytes, size, __ATOMIC_RELAXED);
+    long peak = __atomic_load_n(&mem_peak_bytes, __ATOMIC_RELAXED);
+    while (live > peak &&
+           !__atomic_compare_exchange_n(&mem_peak_bytes, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    return ptr;
+}
+
+static void mem_untrack(void *ptr) {
+    if (ptr) __atomic_sub_fetch(&mem_live_bytes, (long)malloc_usable_size(ptr), __ATOMIC_RELAXED);
+}
+
+void *malloc(size_t size) {
+    return mem_track(__libc_malloc(size));
+}
+
+void *calloc(size_t count, size_t size) {
+    return mem_track(__libc_calloc(count, size));
+}
+
+void *realloc(void *ptr, size_t size) {
+    // Неудачный realloc оставляет старый блок живым: снимаем его с учёта только после
+    // успеха или realloc(ptr, 0), который в glibc освобождает блок
+    size_t old = ptr ? malloc_usable_size(ptr) : 0;
+    void *result = __libc_realloc(ptr, size);
+    if (result || size == 0) __atomic_sub_fetch(&mem_live_bytes, (long)old, __ATOMIC_RELAXED);
+    return mem_track(result);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    return mem_track(__libc_memalign(alignment, size));
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) {
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) return 22; // EINVAL
+    void *ptr = mem_track(__libc_memalign(alignment, size));
+    if (!ptr) return 12; // ENOMEM
+    *out = ptr;
+    return 0;
+}
+
+void free(void *ptr) {
+    mem_untrack(ptr);
+    __libc_free(ptr);
+}
+#else
+#define MEM_COUNT_ALLOCS 0
+
+static unsigned long mem_alloc_count;
+static unsigned long mem_alloc_bytes;
+static long mem_live_bytes;
+static long mem_peak_bytes;
+#endif
+
+// Цифры одной фикстуры
+typedef struct {
+    const char *name;
+    size_t bytes;           // Размер текста
+    unsigned long allocs;   // Вызовы malloc/calloc/realloc за лексику и разбор
+    unsigned long alloc_bytes; // Выделено байт за то же время (сумма блоков)
+    long peak_bytes;        // Пик живой памяти над уровнем до разбора
+    long leaked_bytes;      // Живая память после освобождения дерева, парсера и атомов
+} mem_sample_t;
+
+// Бюджет одной фикстуры из файла
+typedef struct {
+    char *name;
+    unsigned long allocs;
+    long peak_bytes;
+} mem_budget_t;
+
+// Запас при записи бюджета: на 10% и ещё на постоянную величину выше текущих цифр,
+// чтобы мелкие правки не требовали обновления файла, а заметный рост — требовал
+#define MEM_BUDGET_ALLOCS(n) ((n) + (n) / 10 + 16)
+#define MEM_BUDGET_PEAK(n) ((n) + (n) / 10 + 4096)
+
+static void mem_reset(void) {
+    long live = __atomic_load_n(&mem_live_bytes, __ATOMIC_RELAXED);
+    __atomic_store_n(&mem_alloc_count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&mem_alloc_bytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&mem_peak_bytes, live, __ATOMIC_RELAXED);
+}
+
+// Загрузка файла в собственную копию (вне измерения)
+static char *mem_load(const char *path, size_t *length) {
+    source_buffer_t buffer;
+    if (!source_buffer_open(&buffer, path)) return NULL;
+    char *text = malloc(buffer.length + 1);
+    if (text) {
+        memcpy(text, buffer.data, buffer.length);
+        text[buffer.length] = '\n';
+        *length = buffer.length;
+    } else {
+        fprintf(stderr, "Out of memory while loading %s\n", path);
+    }
+    source_buffer_close(&buffer);
+    return text;
+}
+
+// Лексика и разбор одной фикстуры с освобождением всего, что создал фронтенд
+static bool mem_measure(const char *path, mem_sample_t *sample) {
+    size_t length = 0;
+    char *text = mem_load(path, &length);
+    if (!text) return false;
+
+    atom_table_free();
+    long base = __atomic_load_n(&mem_live_bytes, __ATOMIC_RELAXED);
+    mem_reset();
+
+    lexer_t lexer;
+    lexer_init(&lexer, text, length);
+    TokenStream stream;
+    bool lexed = token_stream_from_lexer(&stream, &lexer);
+    lexer_free(&lexer);
+    diag_list_t diagnostics;
+    diag_list_init(&diagnostics);
+    ASTNode *program = NULL;
+    if (lexed && token_stream_expand_chains(&stream)) program = parse_program(&stream, &diagnostics);
+    ast_node_free(program);
+    diag_list_free(&diagnostics);
+    if (lexed) token_stream_free(&stream);
+    atom_table_free();
+
+    sample->name = path;
+    sample->bytes = length;
+    sample->allocs = __atomic_load_n(&mem_alloc_count, __ATOMIC_RELAXED);
+    sample->alloc_bytes = __atomic_load_n(&mem_alloc_bytes, __ATOMIC_RELAXED);
+    sample->peak_bytes = __atomic_load_n(&mem_peak_bytes, __ATOMIC_RELAXED) - base;
+    sample->leaked_bytes = __atomic_load_n(&mem_live_bytes, __ATOMIC_RELAXED) - base;
+    free(text);
+    return program != NULL;
+}
+
+// Чтение бюджета: строки "<фикстура>\t<allocs>\t<peak_bytes>", '#' — комментарий
+static mem_budget_t *mem_read_budget(const char *path, size_t *count) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "Cannot open budget %s\n", path);
+        return NULL;
+    }
+    mem_budget_t *budget = NULL;
+    size_t capacity = 0;
+    *count = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+        char *tab = strchr(line, '\t');
+        if (!tab) continue;
+        *tab = '\0';
+        char *rest = tab + 1;
+        unsigned long allocs = strtoul(rest, &rest, 10);
+        long peak = strtol(rest, NULL, 10);
+        if (*count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            mem_budget_t *grown = realloc(budget, capacity * sizeof(mem_budget_t));
+            if (!grown) break;
+            budget = grown;
+        }
+        char *name = malloc(strlen(line) + 1);
+        if (!name) break;
+        strcpy(name, line);
+        budget[*count] = (mem_budget_t){ name, allocs, peak };
+        (*count)++;
+    }
+    fclose(file);
+    if (!budget) budget = calloc(1, sizeof(mem_budget_t));
+    return budget;
+}
+
+static void mem_free_budget(mem_budget_t *budget, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(budget[i].name);
+    }
+    free(budget);
+}
+
+static const mem_budget_t *mem_find_budget(const mem_budget_t *budget, size_t count, const char *name) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(budget[i].name, name) == 0) return &budget[i];
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    const char *budget_path = NULL;
+    bool write = false;
+    int first_file = 1;
+
+    if (argc > 2 && (strcmp(argv[1], "--budget") == 0 || strcmp(argv[1], "--write") == 0)) {
+        write = strcmp(argv[1], "--write") == 0;
+        budget_path = argv[2];
+        first_file = 3;
+    }
+    if (!budget_path || first_file >= argc) {
+        fprintf(stderr, "Usage: %s (--budget | --write) <budget.tsv> <file.abap>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!MEM_COUNT_ALLOCS) {
+        fprintf(stderr, "Allocation tracking is not supported on this libc\n");
+        return EXIT_FAILURE;
+    }
+
+    size_t count = (size_t)(argc - first_file);
+    mem_sample_t *samples = calloc(count, sizeof(mem_sample_t));
+    if (!samples) return EXIT_FAILURE;
+    for (size_t i = 0; i < count; i++) {
+        if (!mem_measure(argv[first_file + i], &samples[i])) {
+            fprintf(stderr, "Parse failed on %s\n", argv[first_file + i]);
+            free(samples);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (write) {
+        FILE *file = fopen(budget_path, "w");
+        if (!file) {
+            fprintf(stderr, "Cannot write budget %s\n", budget_path);
+            free(samples);
+            return EXIT_FAILURE;
+        }
+        fprintf(file, "# fixture\tallocs\tpeak_bytes (mem_parser --write)\n"
+                      "# Пути — относительно корня репозитория, как в src/parser/*/*.abap.\n"
+                      "# Файл создаётся и обновляется командой mem_parser --write; заметный рост цифр\n"
+                      "# должен сопровождаться обновлением бюджета в том же коммите.\n");
+        for (size_t i = 0; i < count; i++) {
+            fprintf(file, "%s\t%lu\t%ld\n", samples[i].name,
+                    MEM_BUDGET_ALLOCS(samples[i].allocs), MEM_BUDGET_PEAK(samples[i].peak_bytes));
+        }
+        fclose(file);
+        free(samples);
+        return EXIT_SUCCESS;
+    }
+
+    size_t budget_count = 0;
+    mem_budget_t *budget = mem_read_budget(budget_path, &budget_count);
+    if (!budget) {
+        free(samples);
+        return EXIT_FAILURE;
+    }
+
+    printf("fixture\tbytes\tallocs\talloc_bytes\tpeak_bytes\tleaked_bytes\tbudget_allocs\tbudget_peak_bytes\tstatus\n");
+    size_t failed = 0;
+    for (size_t i = 0; i < count; i++) {
+        const mem_sample_t *s = &samples[i];
+        const mem_budget_t *b = mem_find_budget(budget, budget_count, s->name);
+        const char *status = "ok";
+        if (!b) {
+            status = "no-budget";
+        } else if (s->allocs > b->allocs) {
+            status = "over-allocs";
+        } else if (s->peak_bytes > b->peak_bytes) {
+            status = "over-peak";
+        }
+        failed += strcmp(status, "ok") != 0;
+        printf("%s\t%zu\t%lu\t%lu\t%ld\t%ld\t%lu\t%ld\t%s\n", s->name, s->bytes, s->allocs, s->alloc_bytes,
+               s->peak_bytes, s->leaked_bytes, b ? b->allocs : 0, b ? b->peak_bytes : 0L, status);
+    }
+    if (failed) fprintf(stderr, "%zu of %zu fixtures exceed the memory budget\n", failed, count);
+
+    mem_free_budget(budget, budget_count);
+    free(samples);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}